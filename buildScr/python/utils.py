@@ -71,6 +71,15 @@ def get_numpy_include() -> str:
         raise ConfigError("numpy include package not found in: {0}".format(inc_numpy))
 
 
+def get_numpy_random_lib() -> str:
+    import numpy
+    lib_numpy_random = os.path.join(numpy.__path__[0], 'random', 'lib')
+    if os.path.exists(lib_numpy_random):
+        return lib_numpy_random
+    else:
+        raise ConfigError("npyrandom library not found in: {0}".format(lib_numpy_random))
+
+
 def get_java_includes() -> list:
     java_home = os.getenv('JAVA_HOME')
     java_include = os.path.join(java_home, 'include')
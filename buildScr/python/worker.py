@@ -0,0 +1,179 @@
+"""
+Helper process of org.jetbrains.numkt.WorkerPool.
+
+Executes numpy calls received over a Unix socket. A frame is a 4-byte big-endian length
+followed by UTF-8 JSON. Arrays are passed by handle: {"$shm": name} refers to a POSIX
+shared memory segment holding .npy content, the same layout as sharedArray in Kotlin.
+"""
+import io
+import itertools
+import json
+import mmap
+import os
+import socket
+import struct
+import sys
+
+import numpy as np
+
+try:
+    from _posixshmem import shm_open, shm_unlink
+except ImportError:
+    def shm_open(name, flags, mode=0o600):
+        return os.open('/dev/shm' + name, flags, mode)
+
+
+    def shm_unlink(name):
+        os.unlink('/dev/shm' + name)
+
+_counter = itertools.count()
+# segments created by this worker, unlinked when freed
+_owned = {}
+# segments created elsewhere and attached on first use
+_attached = {}
+
+
+def _create(shape, dtype):
+    name = '/ktnumpy_%d_%d' % (os.getpid(), next(_counter))
+    header = io.BytesIO()
+    np.lib.format.write_array_header_1_0(header, {
+        'descr': np.lib.format.dtype_to_descr(dtype),
+        'fortran_order': False,
+        'shape': tuple(shape),
+    })
+    header = header.getvalue()
+    size = len(header) + int(np.prod(shape, dtype=np.int64)) * dtype.itemsize
+
+    fd = shm_open(name, os.O_RDWR | os.O_CREAT | os.O_EXCL, 0o600)
+    try:
+        os.ftruncate(fd, size)
+        buf = mmap.mmap(fd, size)
+    finally:
+        os.close(fd)
+    buf[:len(header)] = header
+
+    array = np.ndarray(shape, dtype, buffer=buf, offset=len(header))
+    _owned[name] = array
+    return name, array
+
+
+def _attach(name):
+    array = _owned.get(name)
+    if array is None:
+        array = _attached.get(name)
+    if array is None:
+        fd = shm_open(name, os.O_RDWR, 0)
+        try:
+            buf = mmap.mmap(fd, os.fstat(fd).st_size)
+        finally:
+            os.close(fd)
+        # the header of version 1.0 is shorter than 64 KiB
+        header = io.BytesIO(buf[:(1 << 16) + 16])
+        version = np.lib.format.read_magic(header)
+        if version == (1, 0):
+            shape, fortran_order, dtype = np.lib.format.read_array_header_1_0(header)
+        else:
+            shape, fortran_order, dtype = np.lib.format.read_array_header_2_0(header)
+        array = np.ndarray(shape, dtype, buffer=buf, offset=header.tell(), order='F' if fortran_order else 'C')
+        _attached[name] = array
+    return array
+
+
+def _free(name):
+    if _owned.pop(name, None) is not None:
+        shm_unlink(name)
+    _attached.pop(name, None)
+
+
+def _decode(value):
+    if isinstance(value, list):
+        return [_decode(v) for v in value]
+    if isinstance(value, dict):
+        if '$shm' in value:
+            return _attach(value['$shm'])
+        if '$dtype' in value:
+            return np.dtype(value['$dtype'])
+        return {k: _decode(v) for k, v in value.items()}
+    return value
+
+
+def _encode(value):
+    if isinstance(value, np.ndarray):
+        if value.dtype.hasobject:
+            raise TypeError('Arrays of objects cannot be returned from a worker.')
+        name, array = _create(value.shape, value.dtype)
+        np.copyto(array, value)
+        return {'$shm': name, 'shape': list(value.shape), 'dtype': value.dtype.str}
+    if isinstance(value, np.generic):
+        value = value.item()
+    if isinstance(value, complex):
+        raise TypeError('Complex values cannot be returned from a worker.')
+    if isinstance(value, (list, tuple)):
+        return [_encode(v) for v in value]
+    if isinstance(value, dict):
+        return {str(k): _encode(v) for k, v in value.items()}
+    return value
+
+
+def _call(names, args, kwargs):
+    func = np
+    for name in names:
+        func = getattr(func, name)
+    return func(*_decode(args), **_decode(kwargs))
+
+
+def _handle(request):
+    op = request['op']
+    if op == 'call':
+        return _encode(_call(request['func'], request.get('args', []), request.get('kwargs', {})))
+    if op == 'free':
+        _free(request['name'])
+        return None
+    if op == 'ping':
+        return os.getpid()
+    raise ValueError('Unknown operation: %s' % op)
+
+
+def _read_exactly(conn, n):
+    data = bytearray()
+    while len(data) < n:
+        chunk = conn.recv(n - len(data))
+        if not chunk:
+            return None
+        data += chunk
+    return bytes(data)
+
+
+def serve(path):
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(path)
+    server.listen(1)
+    print('ready', flush=True)
+    # nothing reads stdout after the handshake
+    os.dup2(2, 1)
+    conn, _ = server.accept()
+    server.close()
+    os.unlink(path)
+
+    try:
+        while True:
+            header = _read_exactly(conn, 4)
+            if header is None:
+                break
+            request = json.loads(_read_exactly(conn, struct.unpack('>I', header)[0]).decode('utf-8'))
+            if request['op'] == 'exit':
+                break
+            try:
+                response = {'ok': _handle(request)}
+            except Exception as e:
+                response = {'error': '%s: %s' % (type(e).__name__, e)}
+            payload = json.dumps(response).encode('utf-8')
+            conn.sendall(struct.pack('>I', len(payload)) + payload)
+    finally:
+        conn.close()
+        for name in list(_owned):
+            _free(name)
+
+
+if __name__ == '__main__':
+    serve(sys.argv[1])
@@ -8,7 +8,8 @@ from setuptools import setup, Extension, find_packages
 
 from buildScr.python.build_lib import build_ktlib
 from buildScr.python.clean import dclean
-from buildScr.python.utils import get_pylib, get_python_lib_link, get_java_includes, get_numpy_include
+from buildScr.python.utils import get_pylib, get_python_lib_link, get_java_includes, get_numpy_include, \
+    get_numpy_random_lib, is_windows, is_linux
 
 CLASSIFIERS = """\
 Development Status :: 3 - Alpha
@@ -40,6 +41,19 @@ def get_src() -> list:
     return sources
 
 
+def get_libraries() -> list:
+    # npyrandom provides the distributions of numpy.random.Generator
+    libraries = [get_pylib(), 'npyrandom']
+    if not is_windows():
+        libraries.append('pthread')
+    if is_linux():
+        # shm_open for glibc before 2.17
+        libraries.append('rt')
+        # dlopen of the BLAS numpy is linked with, for glibc before 2.34
+        libraries.append('dl')
+    return libraries
+
+
 def get_version() -> str:
     with open('gradle.properties') as f:
         for line in f:
@@ -57,12 +71,13 @@ if __name__ == '__main__':
           packages=find_packages(),
           classifiers=[_f for _f in CLASSIFIERS.split('\n') if _f],
           platforms=["Windows", "Linux", "Mac OS-X"],
-          install_requires=["numpy>=1.17"],
+          install_requires=["numpy>=1.19"],
           ext_modules=[
               Extension(
                   name='ktnumpy',
                   sources=get_src(),
-                  libraries=[get_pylib()],
+                  libraries=get_libraries(),
+                  library_dirs=[get_numpy_random_lib()],
                   extra_link_args=get_python_lib_link(),
                   include_dirs=get_java_includes() + ['src/main/ktnumpy/jni/include', get_numpy_include()]
               )
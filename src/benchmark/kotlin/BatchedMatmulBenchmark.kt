@@ -0,0 +1,31 @@
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.linalg.Blas
+import org.jetbrains.numkt.linalg.matmul
+import org.jetbrains.numkt.random.Random
+
+/**
+ * Native products of stacks of small matrices against numpy, which calls BLAS for every matrix.
+ * Run with `gradle benchmark -PbenchmarkClass=BatchedMatmulBenchmarkKt`, `KTNUMPY_NUM_THREADS` sets the number of threads.
+ */
+fun main() {
+    println("threads: ${Parallel.threads}, BLAS: ${Blas.api} ${Blas.library}")
+    for ((batch, size) in listOf(1000 to 8, 100000 to 4, 10000 to 16, 2000 to 32, 500 to 64)) {
+        val a = Random.randomSample(batch, size, size)
+        val b = Random.randomSample(batch, size, size)
+        val numpy = time(Int.MAX_VALUE) { matmul(a, b) }
+        val native = time(0) { matmul(a, b) }
+        println(String.format("%6d x %2d x %-2d numpy %8.2f ms  native %8.2f ms  x%.1f", batch, size, size, numpy, native, numpy / native))
+    }
+}
+
+private fun time(threshold: Int, block: () -> Unit): Double {
+    Parallel.matmulBatchThreshold = threshold
+    repeat(3) { block() }
+    var best = Double.MAX_VALUE
+    repeat(10) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e6)
+    }
+    return best
+}
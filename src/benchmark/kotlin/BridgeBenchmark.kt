@@ -0,0 +1,38 @@
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.array
+import org.jetbrains.numkt.math.plus
+import org.jetbrains.numkt.math.sum
+import org.jetbrains.numkt.statistics.amax
+
+/**
+ * Latency of small calls into numpy, dominated by the crossing of the bridge.
+ * Times are the best of ten thousand runs in microseconds.
+ * Run with `gradle benchmark -PbenchmarkClass=BridgeBenchmarkKt` for JNI and again with `-Pbridge=ffm`
+ * for the foreign function backend on Java 22.
+ */
+fun main() {
+    println("bridge: ${System.getProperty("numkt.bridge") ?: "jni"}")
+    // every call goes to numpy
+    Parallel.smallArrayThreshold = 0
+    val x = array(arrayOf(1.0, 2.0, 3.0, 4.0))
+    val y = array(arrayOf(4.0, 3.0, 2.0, 1.0))
+    val functions = listOf<Pair<String, () -> Any>>(
+        "sum(x)" to { sum(x) },
+        "amax(x)" to { amax(x) },
+        "x + y" to { x + y }
+    )
+    for ((name, function) in functions) {
+        println(String.format("%-10s %10.3f", name, time(function)))
+    }
+}
+
+private fun time(block: () -> Unit): Double {
+    repeat(1000) { block() }
+    var best = Double.MAX_VALUE
+    repeat(10000) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e3)
+    }
+    return best
+}
@@ -0,0 +1,39 @@
+import org.jetbrains.numkt.array
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Conversion of boxed kotlin collections into numpy arrays, in milliseconds for a million elements.
+ * Run it on this revision and on the one before the method id registry to compare the per-element cost.
+ * Run with `gradle benchmark -PbenchmarkClass=ConversionBenchmarkKt`.
+ */
+fun main() {
+    val n = 1_000_000
+    val doubles = List(n) { it * 0.5 }
+    val longs = List(n) { it.toLong() }
+    val rows = List(n / 1000) { i -> List(1000) { j -> (i * 1000 + j).toDouble() } }
+    val mixed = List<Any>(n) { if (it % 2 == 0) it.toDouble() else it }
+
+    val cases = listOf<Pair<String, () -> KtNDArray<*>>>(
+        "List<Double>" to { array<Double>(doubles) },
+        "Array<Double>" to { array(doubles.toTypedArray()) },
+        "List<Long>" to { array<Long>(longs) },
+        "List<List<Double>>" to { array<Double>(rows) },
+        "List<Int | Double>" to { array<Double>(mixed) }
+    )
+
+    println(String.format("%-20s %10s", "collection", "ms"))
+    for ((name, case) in cases) {
+        println(String.format("%-20s %10.1f", name, time(case)))
+    }
+}
+
+private fun time(block: () -> KtNDArray<*>): Double {
+    repeat(3) { block() }
+    var best = Double.MAX_VALUE
+    repeat(10) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e6)
+    }
+    return best
+}
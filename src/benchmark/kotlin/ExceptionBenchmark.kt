@@ -0,0 +1,35 @@
+import org.jetbrains.numkt.NumKtException
+import org.jetbrains.numkt.callLong
+import org.jetbrains.numkt.empty
+
+/**
+ * Throughput of python errors caught as [NumKtException], in exceptions per second,
+ * when the exception is only caught and when its message and stack trace are read.
+ * Run with `gradle benchmark -PbenchmarkClass=ExceptionBenchmarkKt`.
+ */
+fun main() {
+    val n = 100_000
+
+    println(String.format("%-20s %12.0f", "caught", throughput(n) { it.hashCode() }))
+    println(String.format("%-20s %12.0f", "message", throughput(n) { it.message!!.length }))
+    println(String.format("%-20s %12.0f", "message and stack", throughput(n) { it.message!!.length + it.stackTrace.size }))
+}
+
+private fun throughput(n: Int, block: (NumKtException) -> Int): Double {
+    val x = empty<Double>(0)
+    var sink = 0
+    var best = 0.0
+    repeat(5) {
+        val start = System.nanoTime()
+        for (i in 0 until n) {
+            try {
+                callLong(arrayOf("argmax"), arrayOf(x))
+            } catch (e: NumKtException) {
+                sink += block(e)
+            }
+        }
+        best = maxOf(best, n * 1e9 / (System.nanoTime() - start))
+    }
+    if (sink == 42) println()
+    return best
+}
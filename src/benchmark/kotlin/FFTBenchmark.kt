@@ -0,0 +1,34 @@
+import org.jetbrains.numkt.callFunc
+import org.jetbrains.numkt.core.ComplexDouble
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.empty
+import org.jetbrains.numkt.fft.FFT
+import org.jetbrains.numkt.random.Random
+
+/**
+ * Batched 1024-point real transforms, native with cached plans against numpy.fft, by the number of rows.
+ * Times are the best of a hundred runs in milliseconds.
+ * Run with `gradle benchmark -PbenchmarkClass=FFTBenchmarkKt`.
+ */
+fun main() {
+    println(String.format("%8s %10s %10s %10s", "rows", "numpy", "native", "out"))
+    for (rows in listOf(1, 16, 256, 4096)) {
+        val x = Random.randomSample(rows, 1024)
+        val out = empty<ComplexDouble>(rows, 513)
+        val numpy = time { callFunc<ComplexDouble>(nameMethod = arrayOf("fft", "rfft"), args = arrayOf(x)) }
+        val native = time { FFT.rfft(x) }
+        val preallocated = time { FFT.rfft(x, out = out) }
+        println(String.format("%8d %10.3f %10.3f %10.3f", rows, numpy, native, preallocated))
+    }
+}
+
+private fun time(block: () -> KtNDArray<ComplexDouble>): Double {
+    repeat(10) { block() }
+    var best = Double.MAX_VALUE
+    repeat(100) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e6)
+    }
+    return best
+}
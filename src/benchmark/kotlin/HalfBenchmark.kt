@@ -0,0 +1,34 @@
+import org.jetbrains.numkt.core.Half
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.core.asType
+import org.jetbrains.numkt.halfArray
+import org.jetbrains.numkt.toFloatArray
+
+/**
+ * Widening of `numpy.float16` arrays into [FloatArray] and narrowing back, in milliseconds by array size,
+ * for the vectorized conversions and for a cast by numpy followed by a copy of its float32 buffer.
+ * Run with `gradle benchmark -PbenchmarkClass=HalfBenchmarkKt`.
+ */
+fun main() {
+    println(String.format("%12s %10s %10s %10s", "elements", "widen", "numpy", "narrow"))
+    for (power in 10..24 step 2) {
+        val n = 1 shl power
+        val values = FloatArray(n) { it.toFloat() / n }
+        val halves: KtNDArray<Half> = halfArray(values)
+        val widen = time { halves.toFloatArray() }
+        val numpy = time { FloatArray(n).also { halves.asType<Half, Float>().data!!.asFloatBuffer().get(it) } }
+        val narrow = time { halfArray(values) }
+        println(String.format("%12d %10.3f %10.3f %10.3f", n, widen, numpy, narrow))
+    }
+}
+
+private fun time(block: () -> Any): Double {
+    repeat(5) { block() }
+    var best = Double.MAX_VALUE
+    repeat(20) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e6)
+    }
+    return best
+}
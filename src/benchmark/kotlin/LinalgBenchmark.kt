@@ -0,0 +1,43 @@
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.linalg.Blas
+import org.jetbrains.numkt.linalg.Linalg
+import org.jetbrains.numkt.linalg.LinalgWorkspace
+import org.jetbrains.numkt.random.Random
+
+/**
+ * Repeated solves of systems of one shape with numpy.linalg against a [LinalgWorkspace],
+ * which keeps the LAPACK workspace and the result between the calls, and solves of stacks of systems.
+ * Run with `gradle benchmark -PbenchmarkClass=LinalgBenchmarkKt`, `KTNUMPY_NUM_THREADS` sets the number of threads.
+ */
+fun main() {
+    println("threads: ${Parallel.threads}, BLAS: ${Blas.api} ${Blas.library}")
+    for ((size, rhs) in listOf(256 to 1, 256 to 16, 32 to 1, 4 to 1)) {
+        val a = Random.randomSample(size, size)
+        val b = if (rhs == 1) Random.randomSample(size) else Random.randomSample(size, rhs)
+        LinalgWorkspace(size).use { ws ->
+            val numpy = time { Linalg.solve(a, b) }
+            val workspace = time { ws.solve(a, b) }
+            println(String.format("%3d x %-3d rhs %2d numpy %8.3f ms  workspace %8.3f ms  x%.1f", size, size, rhs, numpy, workspace, numpy / workspace))
+        }
+    }
+    for ((batch, size) in listOf(10000 to 4, 2000 to 16, 200 to 64)) {
+        val a = Random.randomSample(batch, size, size)
+        val b = Random.randomSample(batch, size, 1)
+        LinalgWorkspace(size).use { ws ->
+            val numpy = time { Linalg.solve(a, b) }
+            val workspace = time { ws.solve(a, b) }
+            println(String.format("%5d x %2d x %-2d numpy %8.3f ms  workspace %8.3f ms  x%.1f", batch, size, size, numpy, workspace, numpy / workspace))
+        }
+    }
+}
+
+private fun time(block: () -> Unit): Double {
+    repeat(3) { block() }
+    var best = Double.MAX_VALUE
+    repeat(20) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e6)
+    }
+    return best
+}
@@ -0,0 +1,38 @@
+import org.jetbrains.numkt.arange
+import org.jetbrains.numkt.core.KtNDIter
+
+/**
+ * Per-call overhead of the trivial natives, in nanoseconds per call.
+ * `KtNDArray.shape` is a regular JNI call through the interpreter and serves as the baseline.
+ * The critical entry points are used by HotSpot up to Java 17 with `-XX:+CriticalJNINatives`, compare
+ * `gradle benchmark -PbenchmarkClass=NativeCallBenchmarkKt` with and without `-PjvmArgs=-XX:+CriticalJNINatives`,
+ * and against the previous revision for the regular JNI calls.
+ */
+fun main() {
+    val a = arange(1_000_000L)
+    val calls = 1_000_000
+
+    println(String.format("%-16s %8.1f", "array.shape", time(calls) { a.shape }))
+    println(String.format("%-16s %8.1f", "array.ndim", time(calls) { a.ndim }))
+
+    KtNDIter(a).use { iter ->
+        println(String.format("%-16s %8.1f", "iter.ndim", time(calls) { iter.ndim }))
+        println(String.format("%-16s %8.1f", "iter.iterSize", time(calls) { iter.iterSize }))
+        println(String.format("%-16s %8.1f", "iter.iterIndex", time(calls) { iter.iterIndex }))
+        println(String.format("%-16s %8.1f", "iter.finished", time(calls) { iter.finished }))
+        iter.reset()
+        println(String.format("%-16s %8.1f", "iter.iterNext", time(calls - 1) { iter.iterNext() }))
+    }
+}
+
+private fun time(calls: Int, block: () -> Any): Double {
+    var sink = 0
+    var best = Double.MAX_VALUE
+    repeat(5) {
+        val start = System.nanoTime()
+        for (i in 0 until calls) sink += block().hashCode()
+        best = minOf(best, (System.nanoTime() - start).toDouble() / calls)
+    }
+    if (sink == 42) println()
+    return best
+}
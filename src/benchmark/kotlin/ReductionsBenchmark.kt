@@ -0,0 +1,46 @@
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.argMax
+import org.jetbrains.numkt.countNonZero
+import org.jetbrains.numkt.math.sum
+import org.jetbrains.numkt.random.Random
+import org.jetbrains.numkt.statistics.amax
+import org.jetbrains.numkt.statistics.mean
+import org.jetbrains.numkt.statistics.`var`
+
+/**
+ * Native parallel reductions against numpy, which is used when the threshold is out of reach.
+ * Run with `gradle benchmark`, `KTNUMPY_NUM_THREADS` sets the number of threads.
+ */
+fun main() {
+    val x = Random.randomSample(1 shl 25)
+    val m = Random.randomSample(1 shl 12, 1 shl 13)
+    val cases = listOf<Pair<String, () -> Any>>(
+        "sum" to { sum(x) },
+        "mean" to { mean(x) },
+        "var" to { `var`(x) },
+        "amax" to { amax(x) },
+        "argMax" to { argMax(x) },
+        "countNonZero" to { countNonZero(x) },
+        "sum axis 0" to { sum(m, 0) },
+        "sum axis 1" to { sum(m, 1) }
+    )
+
+    println("threads: ${Parallel.threads}, elements: ${x.size}")
+    for ((name, case) in cases) {
+        val numpy = time(Int.MAX_VALUE) { case() }
+        val native = time(0) { case() }
+        println(String.format("%-14s numpy %8.2f ms  native %8.2f ms  x%.1f", name, numpy, native, numpy / native))
+    }
+}
+
+private fun time(threshold: Int, block: () -> Unit): Double {
+    Parallel.reductionThreshold = threshold
+    repeat(3) { block() }
+    var best = Double.MAX_VALUE
+    repeat(10) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e6)
+    }
+    return best
+}
@@ -0,0 +1,47 @@
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.linalg.vdot
+import org.jetbrains.numkt.math.plus
+import org.jetbrains.numkt.math.sum
+import org.jetbrains.numkt.math.times
+import org.jetbrains.numkt.random.Random
+import org.jetbrains.numkt.statistics.amax
+
+/**
+ * Small-array tier of the JVM against numpy by array size, to find the crossover for [Parallel.smallArrayThreshold].
+ * Times are the best of a thousand runs in microseconds.
+ * Run with `gradle benchmark -PbenchmarkClass=SmallArraysBenchmarkKt`.
+ */
+fun main() {
+    val functions = listOf<Pair<String, (KtNDArray<Double>, KtNDArray<Double>) -> Any>>(
+        "sum" to { x, _ -> sum(x) },
+        "amax" to { x, _ -> amax(x) },
+        "vdot" to { x, y -> vdot(x, y) },
+        "x + y" to { x, y -> x + y },
+        "x * 2.0" to { x, _ -> x * 2.0 }
+    )
+
+    for ((name, function) in functions) {
+        println(name)
+        println(String.format("%12s %10s %10s", "elements", "numpy", "jvm"))
+        for (power in 2..14 step 2) {
+            val x = Random.randomSample(1 shl power)
+            val y = Random.randomSample(1 shl power)
+            val numpy = time(0) { function(x, y) }
+            val jvm = time(Int.MAX_VALUE) { function(x, y) }
+            println(String.format("%12d %10.3f %10.3f", x.size, numpy, jvm))
+        }
+    }
+}
+
+private fun time(threshold: Int, block: () -> Unit): Double {
+    Parallel.smallArrayThreshold = threshold
+    repeat(100) { block() }
+    var best = Double.MAX_VALUE
+    repeat(1000) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e3)
+    }
+    return best
+}
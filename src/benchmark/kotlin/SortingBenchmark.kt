@@ -0,0 +1,44 @@
+import org.jetbrains.numkt.KindSort
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.argPartition
+import org.jetbrains.numkt.argSort
+import org.jetbrains.numkt.random.Random
+import org.jetbrains.numkt.sort
+import org.jetbrains.numkt.topK
+
+/**
+ * Native parallel sorting against numpy, which is used when the threshold is out of reach.
+ * Run with `gradle benchmark -PbenchmarkClass=SortingBenchmarkKt`, `KTNUMPY_NUM_THREADS` sets the number of threads.
+ */
+fun main() {
+    val x = Random.randomSample(1 shl 24)
+    val m = Random.randomSample(1 shl 10, 1 shl 12)
+    val cases = listOf<Pair<String, () -> Any>>(
+        "sort" to { sort(x) },
+        "argSort" to { argSort(x, kind = KindSort.STABLE) },
+        "sort rows" to { sort(m) },
+        "sort axis 0" to { sort(m, 0) }
+    )
+
+    println("threads: ${Parallel.threads}, elements: ${x.size}")
+    for ((name, case) in cases) {
+        val numpy = time(Int.MAX_VALUE) { case() }
+        val native = time(0) { case() }
+        println(String.format("%-14s numpy %8.2f ms  native %8.2f ms  x%.1f", name, numpy, native, numpy / native))
+    }
+    val partition = time(0) { argPartition(x, 100) }
+    val top = time(0) { topK(x, 100) }
+    println(String.format("%-14s argPartition %8.2f ms  topK %8.2f ms", "top 100", partition, top))
+}
+
+private fun time(threshold: Int, block: () -> Unit): Double {
+    Parallel.sortThreshold = threshold
+    repeat(3) { block() }
+    var best = Double.MAX_VALUE
+    repeat(10) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e6)
+    }
+    return best
+}
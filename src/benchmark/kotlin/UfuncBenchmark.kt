@@ -0,0 +1,50 @@
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.math.exp
+import org.jetbrains.numkt.math.log
+import org.jetbrains.numkt.math.sin
+import org.jetbrains.numkt.math.tanh
+import org.jetbrains.numkt.random.Random
+
+/**
+ * Native parallel ufuncs against numpy by array size and number of threads.
+ * Times are the best of ten runs in milliseconds.
+ * Run with `gradle benchmark -PbenchmarkClass=UfuncBenchmarkKt`.
+ */
+fun main() {
+    val processors = Runtime.getRuntime().availableProcessors()
+    val threads = generateSequence(1) { it * 2 }.takeWhile { it < processors }.toList() + processors
+    val functions = listOf<Pair<String, (KtNDArray<Double>) -> Any>>(
+        "exp" to { x -> exp(x) },
+        "log" to { x -> log(x) },
+        "sin" to { x -> sin(x) },
+        "tanh" to { x -> tanh(x) }
+    )
+
+    for ((name, function) in functions) {
+        println(name)
+        println(String.format("%12s %10s", "elements", "numpy") + threads.joinToString("") { String.format("%10s", "$it thr") })
+        for (power in 12..24 step 2) {
+            val x = Random.randomSample(1 shl power)
+            val numpy = time(Int.MAX_VALUE) { function(x) }
+            val native = threads.map { n ->
+                Parallel.threads = n
+                time(0) { function(x) }
+            }
+            Parallel.threads = 0
+            println(String.format("%12d %10.3f", x.size, numpy) + native.joinToString("") { String.format("%10.3f", it) })
+        }
+    }
+}
+
+private fun time(threshold: Int, block: () -> Unit): Double {
+    Parallel.ufuncThreshold = threshold
+    repeat(3) { block() }
+    var best = Double.MAX_VALUE
+    repeat(10) {
+        val start = System.nanoTime()
+        block()
+        best = minOf(best, (System.nanoTime() - start) / 1e6)
+    }
+    return best
+}
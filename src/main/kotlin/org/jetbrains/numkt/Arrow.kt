@@ -0,0 +1,64 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Import an array from the [Arrow C Data Interface](https://arrow.apache.org/docs/format/CDataInterface.html).
+ *
+ * Primitive arrays and nested fixed-size lists of primitives are imported without copying,
+ * nested lists become dimensions of the result. The array structure is moved,
+ * its release callback is called when the result and all its views are garbage collected.
+ * The schema structure is released immediately. Booleans are unpacked from bits into a new array.
+ * If there are nulls, the result is a `numpy.ma.MaskedArray`.
+ *
+ * @param arrayAddress address of `struct ArrowArray`.
+ * @param schemaAddress address of `struct ArrowSchema`.
+ * @return [KtNDArray] over the Arrow buffers.
+ * @see toArrow
+ */
+fun <T : Any> fromArrow(arrayAddress: Long, schemaAddress: Long): KtNDArray<T> {
+    @Suppress("UNCHECKED_CAST")
+    return Arrow.importArrow(arrayAddress, schemaAddress) as KtNDArray<T>
+}
+
+/**
+ * Export the array to the [Arrow C Data Interface](https://arrow.apache.org/docs/format/CDataInterface.html).
+ *
+ * A C-contiguous array is exported without copying, each dimension after the first becomes a level of fixed-size lists.
+ * The array is kept alive until the consumer calls the release callback.
+ * The mask of a `numpy.ma.MaskedArray` becomes the validity bitmap.
+ *
+ * @param arrayAddress address of `struct ArrowArray` to fill.
+ * @param schemaAddress address of `struct ArrowSchema` to fill.
+ * @see fromArrow
+ */
+fun <T : Any> KtNDArray<T>.toArrow(arrayAddress: Long, schemaAddress: Long): Unit =
+    Arrow.exportArrow(this, arrayAddress, schemaAddress)
+
+internal object Arrow {
+    init {
+        Interpreter.interpreter
+    }
+
+    @JvmStatic
+    external fun importArrow(arrayAddress: Long, schemaAddress: Long): KtNDArray<*>
+
+    @JvmStatic
+    external fun exportArrow(arr: KtNDArray<*>, arrayAddress: Long, schemaAddress: Long)
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.apache.arrow.c.ArrowArray
+import org.apache.arrow.c.ArrowSchema
+import org.apache.arrow.c.Data
+import org.apache.arrow.memory.BufferAllocator
+import org.apache.arrow.vector.FieldVector
+import org.jetbrains.numkt.core.KtNDArray
+
+// Arrow Java is a compile-only dependency, these functions need `arrow-c-data` on the classpath.
+
+/**
+ * Create an array over the buffers of Arrow Java [vector] without copying.
+ * The vector can be closed afterwards, the buffers stay alive while the array is used.
+ *
+ * @param vector primitive vector or nested [FixedSizeListVector][org.apache.arrow.vector.complex.FixedSizeListVector].
+ * @param allocator allocator for the C Data Interface structures.
+ * @see fromArrow
+ */
+fun <T : Any> KtNDArray.Companion.fromArrowVector(vector: FieldVector, allocator: BufferAllocator): KtNDArray<T> =
+    ArrowArray.allocateNew(allocator).use { array ->
+        ArrowSchema.allocateNew(allocator).use { schema ->
+            Data.exportVector(allocator, vector, null, array, schema)
+            fromArrow(array.memoryAddress(), schema.memoryAddress())
+        }
+    }
+
+/**
+ * Create Arrow Java vector over the data of the array without copying.
+ * The array memory is released when the vector is closed.
+ *
+ * @param allocator allocator of the vector.
+ * @see toArrow
+ */
+fun <T : Any> KtNDArray<T>.toArrowArray(allocator: BufferAllocator): FieldVector =
+    ArrowArray.allocateNew(allocator).use { array ->
+        ArrowSchema.allocateNew(allocator).use { schema ->
+            toArrow(array.memoryAddress(), schema.memoryAddress())
+            Data.importVector(allocator, array, schema, null)
+        }
+    }
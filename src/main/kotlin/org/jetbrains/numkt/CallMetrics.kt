@@ -0,0 +1,126 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import java.lang.management.ManagementFactory
+import javax.management.JMException
+import javax.management.ObjectName
+
+/**
+ * Metrics of a numpy function, times in nanoseconds.
+ * @property function path of the function in numpy, as `linalg.norm`.
+ * @property calls number of calls, failed ones included.
+ * @property errors number of calls which raised.
+ * @property totalNanos time of all the calls.
+ * @property p50Nanos median latency of a call, within 1/16.
+ * @property p99Nanos 99th percentile of the latency of a call, within 1/16.
+ * @property convertNanos time of the conversion of the arguments to Python.
+ * @property executeNanos time of numpy.
+ * @property wrapNanos time of the conversion of the results for the JVM.
+ * @property bytesAllocated bytes of the arrays made from the arguments and of the resulting arrays which own their data.
+ */
+data class CallStats(
+    val function: String,
+    val calls: Long,
+    val errors: Long,
+    val totalNanos: Long,
+    val p50Nanos: Long,
+    val p99Nanos: Long,
+    val convertNanos: Long,
+    val executeNanos: Long,
+    val wrapNanos: Long,
+    val bytesAllocated: Long
+)
+
+/**
+ * Management interface of [CallMetrics], registered as `org.jetbrains.numkt:type=CallMetrics`.
+ */
+interface CallMetricsMXBean {
+    var enabled: Boolean
+
+    val calls: List<CallStats>
+
+    fun reset()
+}
+
+/**
+ * Metrics of the calls into numpy by function, off by default. Each thread counts into counters of its own
+ * without locks, a disabled call costs a test of a flag. The calls through the foreign backend,
+ * see [ForeignBridge], are counted as well, their results are wrapped on the JVM outside of the metrics.
+ * Enabling the metrics registers them with the platform MBean server.
+ */
+object CallMetrics : CallMetricsMXBean {
+    init {
+        Interpreter.interpreter
+    }
+
+    private const val FIELDS = 9
+
+    private var registered = false
+
+    override var enabled: Boolean
+        get() = isEnabled()
+        set(value) {
+            if (value) register()
+            setEnabled(value)
+        }
+
+    /**
+     * Metrics of the functions called at least once since the last [reset], the slowest in total first.
+     */
+    override val calls: List<CallStats>
+        get() {
+            val names = functions()
+            val values = counters()
+            return (0 until minOf(names.size, values.size / FIELDS)).map { f ->
+                val v = values.copyOfRange(f * FIELDS, (f + 1) * FIELDS)
+                CallStats(names[f], v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8])
+            }.filter { it.calls > 0 }.sortedByDescending { it.totalNanos }
+        }
+
+    /**
+     * Zeroes the counters of all functions.
+     */
+    override fun reset(): Unit = clear()
+
+    @Synchronized
+    private fun register() {
+        if (registered) return
+        registered = true
+        // the metrics stay readable from the JVM without JMX
+        try {
+            ManagementFactory.getPlatformMBeanServer().registerMBean(this, ObjectName("org.jetbrains.numkt:type=CallMetrics"))
+        } catch (ignore: JMException) {
+        } catch (ignore: SecurityException) {
+        }
+    }
+
+    @JvmStatic
+    private external fun isEnabled(): Boolean
+
+    @JvmStatic
+    private external fun setEnabled(enabled: Boolean)
+
+    @JvmStatic
+    private external fun functions(): Array<String>
+
+    @JvmStatic
+    private external fun counters(): LongArray
+
+    @JvmStatic
+    private external fun clear()
+}
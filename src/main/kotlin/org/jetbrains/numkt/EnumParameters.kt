@@ -56,4 +56,15 @@ enum class Order {
     A,
     /** default. */
     K
-}
\ No newline at end of file
+}
+/**
+ * Specifies how a file is memory-mapped.
+ */
+enum class MmapMode(val str: String) {
+    /** the array is read-only. */
+    READ("r"),
+    /** writes to the array go to the file. */
+    READ_WRITE("r+"),
+    /** copy-on-write, changes of the array are not saved to the file. */
+    COPY_ON_WRITE("c")
+}
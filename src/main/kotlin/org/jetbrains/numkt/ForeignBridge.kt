@@ -0,0 +1,265 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.core.None
+import java.lang.invoke.MethodHandle
+import java.lang.invoke.MethodHandles
+import java.lang.reflect.Array as JArray
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.Optional
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * Backend of the calls into numpy on the Foreign Function & Memory API of JDK 22, selected at startup with
+ * the system property `numkt.bridge=ffm`. The JNI bridge stays the default and handles everything else.
+ *
+ * The functions are resolved once into handles of the plain C ABI of the library (`ktnp_lookup`, `ktnp_call`),
+ * and the arguments are written to native memory of the calling thread. Calls of positional numbers, booleans,
+ * [None] and arrays go through the foreign backend, other calls, errors and results other than arrays
+ * and numbers through JNI. The data of the resulting arrays are segments of a shared arena, closed with
+ * the interpreter, so that a buffer outliving Python throws instead of reading freed memory.
+ *
+ * The API is reached by reflection and method handles, the library is built for Java 8.
+ */
+internal class ForeignBridge private constructor() {
+    companion object {
+        // tags of the values and results in the order of the native KtnpValue
+        private const val NONE = 0
+        private const val BOOLEAN = 1
+        private const val LONG = 2
+        private const val DOUBLE = 3
+        private const val ARRAY = 4
+
+        // statuses of ktnp_call
+        private const val ERROR = -1
+        private const val OBJECT = 1
+
+        // layout of the memory of a thread: arguments, result and the name of a function
+        private const val MAX_ARGS = 16
+        private const val VALUE_SIZE = 16
+        private const val RESULT = MAX_ARGS * VALUE_SIZE
+        private const val NAME = RESULT + 64
+        private const val SCRATCH_SIZE = 1024
+
+        private const val PACKAGE = "java.lang.foreign."
+
+        /**
+         * The foreign backend when it is selected and available, otherwise *null* and the calls go through JNI.
+         */
+        @Volatile
+        var instance: ForeignBridge? = null
+            private set
+
+        /**
+         * Selects the backend after the native library is loaded.
+         */
+        fun select() {
+            if (System.getProperty("numkt.bridge") != "ffm") return
+            instance = create() ?: run {
+                System.err.println("Warning: the foreign function backend needs Java 22 or newer, JNI is used.")
+                null
+            }
+        }
+
+        fun close() {
+            val bridge = instance ?: return
+            instance = null
+            bridge.close()
+        }
+
+        /**
+         * Returns a new backend, or *null* when the Foreign Function & Memory API is not available.
+         */
+        fun create(): ForeignBridge? = try {
+            ForeignBridge()
+        } catch (e: ReflectiveOperationException) {
+            null
+        } catch (e: NoSuchElementException) {
+            null
+        }
+
+        @JvmStatic
+        private external fun raisePending()
+
+        @JvmStatic
+        private external fun wrap(pointer: Long): KtNDArray<*>
+    }
+
+    private class Scratch(val address: Long, val buffer: ByteBuffer) {
+        var handle = 0L
+        var n = 0
+    }
+
+    // restricted methods are caller sensitive and need a full privilege lookup
+    private val lookup = MethodHandles.lookup()
+    private val segmentClass = Class.forName(PACKAGE + "MemorySegment")
+    private val arenaClass = Class.forName(PACKAGE + "Arena")
+
+    private val arena: Any = arenaClass.getMethod("ofShared").invoke(null)
+    private val arenaClose: MethodHandle = lookup.unreflect(arenaClass.getMethod("close"))
+    private val allocate: MethodHandle =
+        lookup.unreflect(arenaClass.getMethod("allocate", Long::class.java, Long::class.java))
+    private val ofAddress: MethodHandle = lookup.unreflect(segmentClass.getMethod("ofAddress", Long::class.java))
+    private val reinterpret: MethodHandle = lookup.unreflect(
+        segmentClass.getMethod("reinterpret", Long::class.java, arenaClass, java.util.function.Consumer::class.java)
+    )
+    private val address: MethodHandle = lookup.unreflect(segmentClass.getMethod("address"))
+    private val asByteBuffer: MethodHandle = lookup.unreflect(segmentClass.getMethod("asByteBuffer"))
+
+    private val ktnpLookup: MethodHandle
+    private val ktnpCall: MethodHandle
+
+    init {
+        val linkerClass = Class.forName(PACKAGE + "Linker")
+        val layoutClass = Class.forName(PACKAGE + "MemoryLayout")
+        val descriptorClass = Class.forName(PACKAGE + "FunctionDescriptor")
+        val optionClass = Class.forName(PACKAGE + "Linker\$Option")
+        val valueLayoutClass = Class.forName(PACKAGE + "ValueLayout")
+        val javaLong = valueLayoutClass.getField("JAVA_LONG").get(null)
+        val javaInt = valueLayoutClass.getField("JAVA_INT").get(null)
+
+        val linker = linkerClass.getMethod("nativeLinker").invoke(null)
+        // the library is loaded by the class loader of the library, see LibraryLoader
+        val lookupClass = Class.forName(PACKAGE + "SymbolLookup")
+        val symbols = lookupClass.getMethod("loaderLookup").invoke(null)
+        val find = lookupClass.getMethod("find", String::class.java)
+        val layouts = JArray.newInstance(layoutClass, 0).javaClass
+        val options = JArray.newInstance(optionClass, 0)
+        val downcallHandle = linkerClass.getMethod("downcallHandle", segmentClass, descriptorClass, options.javaClass)
+
+        // addresses are passed as 64-bit integers
+        fun downcall(name: String, result: Any, vararg args: Any): MethodHandle {
+            val symbol = (find.invoke(symbols, name) as Optional<*>).get()
+            val arguments = JArray.newInstance(layoutClass, args.size)
+            args.forEachIndexed { i, layout -> JArray.set(arguments, i, layout) }
+            val descriptor = descriptorClass.getMethod("of", layoutClass, layouts).invoke(null, result, arguments)
+            return downcallHandle.invoke(linker, symbol, descriptor, options) as MethodHandle
+        }
+
+        ktnpLookup = downcall("ktnp_lookup", javaLong, javaLong)
+        ktnpCall = downcall("ktnp_call", javaInt, javaLong, javaLong, javaInt, javaInt, javaLong)
+    }
+
+    private val handles = ConcurrentHashMap<String, Long>()
+
+    private fun close() {
+        arenaClose.invoke(arena)
+    }
+
+    private val scratch = object : ThreadLocal<Scratch>() {
+        override fun initialValue(): Scratch {
+            val segment = allocate.invoke(arena, SCRATCH_SIZE.toLong(), 16L)
+            val buffer = (asByteBuffer.invoke(segment) as ByteBuffer).order(ByteOrder.nativeOrder())
+            return Scratch(address.invoke(segment) as Long, buffer)
+        }
+    }
+
+    /**
+     * Resolves the function and writes the arguments for the next call of this thread.
+     * Returns *false* when the call has to go through JNI.
+     */
+    fun prepare(nameMethod: Array<String>, args: Array<out Any>?): Boolean {
+        val scratch = scratch.get()
+        val n = args?.size ?: 0
+        if (n > MAX_ARGS) return false
+        for (i in 0 until n) {
+            if (!encode(scratch.buffer, i * VALUE_SIZE, args!![i])) return false
+        }
+        val name = if (nameMethod.size == 1) nameMethod[0] else nameMethod.joinToString(".")
+        scratch.handle = handles[name] ?: resolve(scratch, name).also { if (it == 0L) return false }
+        scratch.n = n
+        return true
+    }
+
+    fun callDouble(): Double {
+        val scratch = call(DOUBLE) ?: return 0.0
+        return scratch.buffer.getDouble(RESULT)
+    }
+
+    fun callLong(): Long {
+        val scratch = call(LONG) ?: return 0L
+        return scratch.buffer.getLong(RESULT)
+    }
+
+    fun callBoolean(): Boolean {
+        val scratch = call(BOOLEAN) ?: return false
+        return scratch.buffer.getInt(RESULT) != 0
+    }
+
+    @Suppress("UNCHECKED_CAST")
+    fun <T : Any> callArray(): KtNDArray<T> {
+        val scratch = scratch.get()
+        val status = ktnpCall.invoke(scratch.handle, scratch.address, scratch.n, ARRAY, scratch.address + RESULT) as Int
+        val buffer = scratch.buffer
+        return when (status) {
+            ERROR -> {
+                raisePending()
+                throw NumKtException("Call failed.")
+            }
+            OBJECT -> wrap(buffer.getLong(RESULT)) as KtNDArray<T>
+            else -> {
+                val nbytes = buffer.getLong(RESULT + 16)
+                val segment = reinterpret.invoke(ofAddress.invoke(buffer.getLong(RESULT + 8)), nbytes, arena, null)
+                val data = (asByteBuffer.invoke(segment) as ByteBuffer).let {
+                    if (buffer.getLong(RESULT + 32) != 0L) it else it.asReadOnlyBuffer()
+                }
+                KtNDArray(buffer.getLong(RESULT), data, null, buffer.getLong(RESULT + 24))
+            }
+        }
+    }
+
+    // Calls the prepared function, returns null when an exception of the call is pending.
+    private fun call(want: Int): Scratch? {
+        val scratch = scratch.get()
+        val status = ktnpCall.invoke(scratch.handle, scratch.address, scratch.n, want, scratch.address + RESULT) as Int
+        if (status == ERROR) {
+            raisePending()
+            return null
+        }
+        return scratch
+    }
+
+    private fun resolve(scratch: Scratch, name: String): Long {
+        val bytes = name.toByteArray(Charsets.UTF_8)
+        if (NAME + bytes.size >= SCRATCH_SIZE) return 0L
+        for (i in bytes.indices) scratch.buffer.put(NAME + i, bytes[i])
+        scratch.buffer.put(NAME + bytes.size, 0)
+        val handle = ktnpLookup.invoke(scratch.address + NAME) as Long
+        if (handle == 0L) {
+            raisePending()
+            return 0L
+        }
+        // handles keep their functions alive for the lifetime of the interpreter
+        return handles.putIfAbsent(name, handle) ?: handle
+    }
+
+    private fun encode(buffer: ByteBuffer, offset: Int, arg: Any): Boolean {
+        val value = if (arg is KtNDArray<*> && arg.isScalar()) arg.scalar!! else arg
+        when (value) {
+            is None -> buffer.putInt(offset, NONE)
+            is Boolean -> buffer.putInt(offset, BOOLEAN).putLong(offset + 8, if (value) 1L else 0L)
+            is Long, is Int, is Short, is Byte -> buffer.putInt(offset, LONG).putLong(offset + 8, (value as Number).toLong())
+            is Double, is Float -> buffer.putInt(offset, DOUBLE).putDouble(offset + 8, (value as Number).toDouble())
+            is KtNDArray<*> -> buffer.putInt(offset, ARRAY).putLong(offset + 8, value.address)
+            else -> return false
+        }
+        return true
+    }
+}
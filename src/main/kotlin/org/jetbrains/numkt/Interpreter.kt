@@ -40,6 +40,11 @@ internal class Interpreter private constructor() {
                 }
                 return field
             }
+
+        /**
+         * Metrics of the calls into numpy by function, see [CallMetrics].
+         */
+        fun metrics(): List<CallStats> = CallMetrics.calls
     }
 
     private var error: Throwable? = null
@@ -52,11 +57,15 @@ internal class Interpreter private constructor() {
         if (error != null) {
             throw Error(error)
         }
+
+        ForeignBridge.select()
+        Jfr.install()
     }
 
     private external fun initializePython(pythonHome: String, ldLib: String)
 
     fun close() {
+        ForeignBridge.close()
         closePython()
     }
 
@@ -76,6 +85,26 @@ internal class Interpreter private constructor() {
         jClass: Class<out T>
     ): T
 
+    @Throws(NumKtException::class)
+    internal external fun callDouble(
+        nameMethod: Array<String>,
+        args: Array<out Any>? = null,
+        kwargs: Map<String, Any?>? = null
+    ): Double
+
+    @Throws(NumKtException::class)
+    internal external fun callLong(
+        nameMethod: Array<String>,
+        args: Array<out Any>? = null,
+        kwargs: Map<String, Any?>? = null
+    ): Long
+
+    @Throws(NumKtException::class)
+    internal external fun callBoolean(
+        nameMethod: Array<String>,
+        args: Array<out Any>? = null,
+        kwargs: Map<String, Any?>? = null
+    ): Boolean
 
     internal external fun <T : Any> getField(field: String, pointer: Long, jClass: Class<in T>): T
 
@@ -93,7 +122,7 @@ internal class Interpreter private constructor() {
 
     internal external fun iterDealloc(ptrIter: Long)
 
-    internal external fun freeArray(pointer: Long, data: Buffer): Int
+    internal external fun freeArray(pointer: Long, data: Buffer?): Int
 
     private external fun closePython()
 }
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Flight recorder events of the library, see [JfrEvents]: `NumpyCall`, `GilWait`, `NativeArrayAlloc`,
+ * `NativeArrayFree` and `NumpyException`. The calls are recorded by the wrappers of the interpreter, [callFunc]
+ * and alike, which turn the records of the native code of their thread into events after each call.
+ * Records are made only while a recording with the events enabled is running, otherwise a call reads a flag.
+ * The events need `jdk.jfr`, on runtimes without it they stay off. `-Dnumkt.jfr=false` turns them off as well.
+ */
+internal object Jfr {
+    // kinds of the native records, see events.h
+    const val CALL = 1
+    const val GIL_WAIT = 2
+    const val ARRAY_ALLOC = 3
+    const val ARRAY_FREE = 4
+
+    // longs of the native buffer of a thread
+    private const val BUFFER_SIZE = 1024
+
+    @Volatile
+    @JvmField
+    var recording = false
+
+    private val buffers = ThreadLocal.withInitial { LongArray(BUFFER_SIZE) }
+
+    fun install() {
+        if (System.getProperty("numkt.jfr") == "false") return
+        try {
+            Class.forName("jdk.jfr.FlightRecorder")
+        } catch (ignore: ClassNotFoundException) {
+            return
+        }
+        JfrEvents.install()
+    }
+
+    fun update(recording: Boolean) {
+        this.recording = recording
+        setRecording(recording)
+    }
+
+    /**
+     * Runs a call of the function of numpy at the path [nameMethod], as a `NumpyCall` event while recording.
+     */
+    inline fun <R> call(nameMethod: Array<String>, args: Array<out Any>?, block: () -> R): R {
+        if (!recording) return block()
+        val event = begin(nameMethod, args)
+        try {
+            return block()
+        } catch (e: NumKtException) {
+            exception(nameMethod, e)
+            throw e
+        } finally {
+            end(event)
+        }
+    }
+
+    fun begin(nameMethod: Array<String>, args: Array<out Any>?): Any =
+        JfrEvents.begin(nameMethod.joinToString("."), describe(args))
+
+    fun end(event: Any) {
+        val records = buffers.get()
+        JfrEvents.end(event, records, drain(records))
+    }
+
+    // the type only, reading the message would render the python traceback of every recorded exception
+    fun exception(nameMethod: Array<String>, e: NumKtException): Unit =
+        JfrEvents.exception(nameMethod.joinToString("."), e.pythonType ?: e.javaClass.name)
+
+    /**
+     * Turns the records of the thread outside of the calls, as freed arrays, into events.
+     */
+    fun flush() {
+        if (!recording) return
+        val records = buffers.get()
+        JfrEvents.commit(records, drain(records))
+    }
+
+    /** Shapes and types of the arguments, as `Double[3, 4], Int`. */
+    private fun describe(args: Array<out Any>?): String =
+        args?.joinToString {
+            if (it is KtNDArray<*> && it.isNotScalar()) "${it.dtype.simpleName}${it.shape.contentToString()}"
+            else it.javaClass.simpleName
+        } ?: ""
+
+    @JvmStatic
+    private external fun setRecording(recording: Boolean)
+
+    @JvmStatic
+    private external fun drain(records: LongArray): Int
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import jdk.jfr.Category
+import jdk.jfr.DataAmount
+import jdk.jfr.Description
+import jdk.jfr.Event
+import jdk.jfr.EventType
+import jdk.jfr.FlightRecorder
+import jdk.jfr.FlightRecorderListener
+import jdk.jfr.Label
+import jdk.jfr.Name
+import jdk.jfr.Recording
+import jdk.jfr.RecordingState
+import jdk.jfr.Timespan
+
+/*
+ * Event types of the library, loaded only on runtimes with jdk.jfr, see Jfr.
+ * Native durations are fields of the events, the events themselves are timed on the JVM.
+ */
+
+@Name("org.jetbrains.numkt.NumpyCall")
+@Label("Numpy Call")
+@Category("Kotlin NumPy")
+@Description("Call of a numpy function through the bridge")
+internal class NumpyCallEvent : Event() {
+    @Label("Function")
+    @JvmField
+    var function: String? = null
+
+    @Label("Arguments")
+    @Description("Types and shapes of the arguments")
+    @JvmField
+    var arguments: String? = null
+
+    @Label("Conversion")
+    @Timespan(Timespan.NANOSECONDS)
+    @JvmField
+    var conversion: Long = 0
+
+    @Label("Execution")
+    @Timespan(Timespan.NANOSECONDS)
+    @JvmField
+    var execution: Long = 0
+
+    @Label("Wrapping")
+    @Timespan(Timespan.NANOSECONDS)
+    @JvmField
+    var wrapping: Long = 0
+
+    @Label("Allocated")
+    @DataAmount
+    @JvmField
+    var allocated: Long = 0
+}
+
+@Name("org.jetbrains.numkt.GilWait")
+@Label("GIL Wait")
+@Category("Kotlin NumPy")
+@Description("Wait of a thread for the Python interpreter lock")
+internal class GilWaitEvent : Event() {
+    @Label("Wait Time")
+    @Timespan(Timespan.NANOSECONDS)
+    @JvmField
+    var waitTime: Long = 0
+}
+
+@Name("org.jetbrains.numkt.NativeArrayAlloc")
+@Label("Native Array Allocation")
+@Category("Kotlin NumPy")
+@Description("Array allocated by numpy and handed to the JVM")
+internal class NativeArrayAllocEvent : Event() {
+    @Label("Size")
+    @DataAmount
+    @JvmField
+    var bytes: Long = 0
+
+    @Label("Shape")
+    @JvmField
+    var shape: String? = null
+}
+
+@Name("org.jetbrains.numkt.NativeArrayFree")
+@Label("Native Array Free")
+@Category("Kotlin NumPy")
+@Description("Array of numpy freed with its last KtNDArray")
+internal class NativeArrayFreeEvent : Event() {
+    @Label("Size")
+    @DataAmount
+    @JvmField
+    var bytes: Long = 0
+
+    @Label("Shape")
+    @JvmField
+    var shape: String? = null
+}
+
+@Name("org.jetbrains.numkt.NumpyException")
+@Label("Numpy Exception")
+@Category("Kotlin NumPy")
+@Description("Python exception raised by a numpy call")
+internal class NumpyExceptionEvent : Event() {
+    @Label("Function")
+    @JvmField
+    var function: String? = null
+
+    @Label("Exception Type")
+    @JvmField
+    var type: String? = null
+}
+
+internal object JfrEvents {
+    private val types = listOf(
+        NumpyCallEvent::class.java, GilWaitEvent::class.java, NativeArrayAllocEvent::class.java,
+        NativeArrayFreeEvent::class.java, NumpyExceptionEvent::class.java
+    )
+
+    fun install() {
+        types.forEach { FlightRecorder.register(it) }
+        FlightRecorder.addListener(object : FlightRecorderListener {
+            override fun recordingStateChanged(recording: Recording) = update()
+        })
+        update()
+    }
+
+    // records are made while a recording is running with any of the events enabled
+    private fun update() {
+        val running = FlightRecorder.isInitialized() &&
+                FlightRecorder.getFlightRecorder().recordings.any { it.state == RecordingState.RUNNING }
+        Jfr.update(running && types.any { EventType.getEventType(it).isEnabled })
+    }
+
+    fun begin(function: String, arguments: String): Any {
+        val event = NumpyCallEvent()
+        event.function = function
+        event.arguments = arguments
+        event.begin()
+        return event
+    }
+
+    fun end(event: Any, records: LongArray, length: Int) {
+        event as NumpyCallEvent
+        event.end()
+        // the last call of the records is the one of the event
+        var i = 0
+        while (i < length) {
+            if (records[i].toInt() == Jfr.CALL) {
+                event.conversion = records[i + 1]
+                event.execution = records[i + 2]
+                event.wrapping = records[i + 3]
+                event.allocated = records[i + 4]
+            }
+            i = next(records, i)
+        }
+        if (event.shouldCommit()) event.commit()
+        commit(records, length)
+    }
+
+    fun exception(function: String, type: String) {
+        val event = NumpyExceptionEvent()
+        if (!event.isEnabled) return
+        event.function = function
+        event.type = type
+        event.commit()
+    }
+
+    fun commit(records: LongArray, length: Int) {
+        var i = 0
+        while (i < length) {
+            when (records[i].toInt()) {
+                Jfr.GIL_WAIT -> {
+                    val event = GilWaitEvent()
+                    event.waitTime = records[i + 1]
+                    event.commit()
+                }
+                Jfr.ARRAY_ALLOC -> {
+                    val event = NativeArrayAllocEvent()
+                    event.bytes = records[i + 1]
+                    event.shape = shape(records, i)
+                    event.commit()
+                }
+                Jfr.ARRAY_FREE -> {
+                    val event = NativeArrayFreeEvent()
+                    event.bytes = records[i + 1]
+                    event.shape = shape(records, i)
+                    event.commit()
+                }
+            }
+            i = next(records, i)
+        }
+    }
+
+    private fun shape(records: LongArray, i: Int): String =
+        (0 until records[i + 2].toInt()).joinToString(prefix = "[", postfix = "]") { records[i + 3 + it].toString() }
+
+    private fun next(records: LongArray, i: Int): Int = when (records[i].toInt()) {
+        Jfr.CALL -> i + 5
+        Jfr.GIL_WAIT -> i + 2
+        else -> i + 3 + records[i + 2].toInt()
+    }
+}
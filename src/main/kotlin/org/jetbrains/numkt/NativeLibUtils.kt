@@ -157,6 +157,18 @@ object LibraryLoader {
         }
     }
 
+    /**
+     * Returns the python script shipped with the library, e.g. the worker of [WorkerPool].
+     */
+    @Synchronized
+    internal fun pythonScript(name: String): File {
+        val script = File(tmpDir, "$name.py")
+        if (!script.exists()) {
+            extractFileFromJar("/META-INF/pythonScript/$name.py", "$name.py")
+        }
+        return script
+    }
+
     private fun execCommand(vararg commands: String): String {
         val errStr: String
         val inStr: String
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Load an array from a `.npy` file.
+ *
+ * With [mmapMode] the file is memory-mapped without reading it, [KtNDArray.data] is a direct buffer over the mapping,
+ * or null when the data is larger than a buffer can hold.
+ * The mapping is released when the array and all its views are garbage collected.
+ *
+ * @param file filename.
+ * @param mmapMode if not null, memory-map the file using the given mode.
+ * Only arrays of native byte order and without objects can be mapped.
+ * @return [KtNDArray] stored in the file.
+ * @see save
+ */
+fun <T : Any> load(file: String, mmapMode: MmapMode? = null): KtNDArray<T> =
+    if (mmapMode == null) {
+        callFunc(nameMethod = arrayOf("load"), args = arrayOf(file))
+    } else {
+        @Suppress("UNCHECKED_CAST")
+        NpyIO.mmapNpy(file, mmapMode.str) as KtNDArray<T>
+    }
+
+/**
+ * Load arrays from a `.npz` file.
+ *
+ * Members stored without compression (see [savez]) are memory-mapped with [mmapMode],
+ * compressed members are always read into memory.
+ *
+ * @param file filename.
+ * @param mmapMode if not null, memory-map the members using the given mode.
+ * [MmapMode.READ_WRITE] is not supported, because writes would invalidate the archive checksums.
+ * @return [Map] of arrays by their names.
+ * @see savez
+ */
+fun loadNpz(file: String, mmapMode: MmapMode? = null): Map<String, KtNDArray<Any>> {
+    val members = NpyIO.mmapNpz(file, mmapMode?.str)
+    val result = LinkedHashMap<String, KtNDArray<Any>>(members.size / 2)
+    for (i in members.indices step 2) {
+        @Suppress("UNCHECKED_CAST")
+        result[members[i] as String] = members[i + 1] as KtNDArray<Any>
+    }
+    return result
+}
+
+/**
+ * Save an array to a binary file in `.npy` format.
+ *
+ * @param file filename, the `.npy` extension is appended if it does not have one.
+ * @param arr array to save.
+ * @see load
+ */
+fun <T : Any> save(file: String, arr: KtNDArray<T>): Unit =
+    callFunc(nameMethod = arrayOf("save"), args = arrayOf(file, arr), kClass = Unit::class)
+
+/**
+ * Save several arrays into a single file in uncompressed `.npz` format.
+ * Such files can be memory-mapped by [loadNpz].
+ *
+ * @param file filename, the `.npz` extension is appended if it does not have one.
+ * @param arrays arrays by their names in the archive.
+ * @see loadNpz
+ */
+fun savez(file: String, arrays: Map<String, KtNDArray<*>>): Unit =
+    NpyIO.savez(file, arrays.keys.toTypedArray(), arrays.values.toTypedArray(), false)
+
+/**
+ * Save arrays with the names `arr_0`, `arr_1`, etc.
+ */
+fun savez(file: String, vararg arrays: KtNDArray<*>): Unit =
+    savez(file, arrays.withIndex().associate { "arr_${it.index}" to it.value })
+
+/**
+ * Save several arrays into a single file in compressed `.npz` format.
+ *
+ * @see savez
+ */
+fun savezCompressed(file: String, arrays: Map<String, KtNDArray<*>>): Unit =
+    NpyIO.savez(file, arrays.keys.toTypedArray(), arrays.values.toTypedArray(), true)
+
+internal object NpyIO {
+    init {
+        Interpreter.interpreter
+    }
+
+    @JvmStatic
+    external fun mmapNpy(file: String, mode: String): KtNDArray<*>
+
+    @JvmStatic
+    external fun mmapNpz(file: String, mode: String?): Array<Any>
+
+    @JvmStatic
+    external fun savez(file: String, names: Array<String>, arrays: Array<KtNDArray<*>>, compressed: Boolean)
+
+    @JvmStatic
+    external fun shmCreate(name: String, shape: IntArray, dtype: Class<*>): KtNDArray<*>
+
+    @JvmStatic
+    external fun shmAttach(name: String, mode: String): KtNDArray<*>
+
+    @JvmStatic
+    external fun shmUnlink(name: String)
+}
@@ -16,8 +16,103 @@
 
 package org.jetbrains.numkt
 
+import java.io.PrintStream
+import java.io.PrintWriter
+import java.lang.ref.PhantomReference
+import java.lang.ref.ReferenceQueue
+import java.util.concurrent.ConcurrentHashMap
+
 class NumKtException : Exception {
     constructor() : super()
 
     constructor(message: String) : super(message)
-}
\ No newline at end of file
+
+    /**
+     * Exception of a python error, [error] is the handle of the tuple (type, value, traceback).
+     * The message and the python frames of the stack trace are rendered on first use,
+     * so code catching the exception for control flow does not pay for them.
+     */
+    private constructor(error: Long) : super() {
+        releaseCollected()
+        this.error = error
+        this.reference = ErrorReference(this, error).also { pending.add(it) }
+    }
+
+    private var error: Long = 0L
+
+    private var reference: ErrorReference? = null
+
+    private var rendered: String? = null
+
+    private var type: String? = null
+
+    // Name of the python exception type, read without rendering the message, null for errors of the JVM side.
+    internal val pythonType: String?
+        @Synchronized get() {
+            if (type == null && error != 0L) type = errorType(error)
+            return type
+        }
+
+    override val message: String?
+        get() {
+            resolve()
+            return rendered ?: super.message
+        }
+
+    override fun getStackTrace(): Array<StackTraceElement> {
+        resolve()
+        return super.getStackTrace()
+    }
+
+    override fun printStackTrace(s: PrintStream) {
+        resolve()
+        super.printStackTrace(s)
+    }
+
+    override fun printStackTrace(s: PrintWriter) {
+        resolve()
+        super.printStackTrace(s)
+    }
+
+    @Synchronized
+    private fun resolve() {
+        if (error == 0L) return
+        if (type == null) type = errorType(error)
+        rendered = renderMessage(error)
+        // python frames on top of the java frames, the innermost first
+        setStackTrace(pythonStack(error) + super.getStackTrace())
+        if (pending.remove(reference)) release(error)
+        error = 0L
+        reference = null
+    }
+
+    // Releases the python errors of exceptions collected without being rendered.
+    private class ErrorReference(exception: NumKtException, val error: Long) :
+        PhantomReference<NumKtException>(exception, queue)
+
+    companion object {
+        private val queue = ReferenceQueue<NumKtException>()
+
+        private val pending = ConcurrentHashMap.newKeySet<ErrorReference>()
+
+        // Called for each new exception and after each freed array, so that the queue is drained without new errors.
+        internal fun releaseCollected() {
+            while (true) {
+                val reference = queue.poll() as ErrorReference? ?: return
+                if (pending.remove(reference)) release(reference.error)
+            }
+        }
+
+        @JvmStatic
+        private external fun renderMessage(error: Long): String?
+
+        @JvmStatic
+        private external fun errorType(error: Long): String?
+
+        @JvmStatic
+        private external fun pythonStack(error: Long): Array<StackTraceElement>
+
+        @JvmStatic
+        private external fun release(error: Long)
+    }
+}
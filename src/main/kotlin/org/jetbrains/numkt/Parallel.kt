@@ -0,0 +1,113 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+/**
+ * Native thread pool shared by the parallel kernels of the library.
+ */
+object Parallel {
+    init {
+        Interpreter.interpreter
+    }
+
+    /**
+     * Number of threads of the pool, the calling thread included.
+     * Setting 0 restores the default: `KTNUMPY_NUM_THREADS` or the number of processors.
+     */
+    var threads: Int
+        get() = getThreads()
+        set(value) {
+            require(value >= 0) { "Number of threads must be non-negative, got $value" }
+            setThreads(value)
+        }
+
+    /**
+     * Arrays of at least this many elements are reduced natively on the pool by
+     * [sum][org.jetbrains.numkt.math.sum], [mean][org.jetbrains.numkt.statistics.mean],
+     * [var][org.jetbrains.numkt.statistics.var], [amax][org.jetbrains.numkt.statistics.amax],
+     * [amin][org.jetbrains.numkt.statistics.amin], [argMax], [argMin] and [countNonZero].
+     * Smaller arrays, and types the native reductions do not handle, are reduced by numpy.
+     * The native path is opt-in: the default [Int.MAX_VALUE] leaves all arrays to numpy.
+     * Its results can differ from numpy in the last bits: float32 values are summed in doubles and rounded once,
+     * where numpy sums them in float32.
+     */
+    @Volatile
+    var reductionThreshold: Int = Int.MAX_VALUE
+
+    /**
+     * Arrays of at least this many elements are sorted natively on the pool by [sort] and [argSort],
+     * whatever the requested kind: values sorted by any algorithm are the same and the native indices are stable.
+     * Smaller arrays, and types the native sort does not handle, are sorted by numpy.
+     * [Int.MAX_VALUE] turns the native sort off. [topK] is always native.
+     */
+    @Volatile
+    var sortThreshold: Int = 1 shl 20
+
+    /**
+     * Arrays of at least this many elements are processed natively on the pool by the elementwise functions of
+     * [exponents and logarithms][org.jetbrains.numkt.math.exp], [trigonometric][org.jetbrains.numkt.math.sin] and
+     * [hyperbolic][org.jetbrains.numkt.math.tanh] functions, with the inner loops of numpy.
+     * The native path is opt-in: the default [Int.MAX_VALUE] leaves all arrays to numpy.
+     * Contiguous floating arrays of the same type and shape are handled, other arrays are processed by numpy.
+     * Floating point warnings of numpy, such as division by zero in `log`, are not raised by the native path.
+     */
+    @Volatile
+    var ufuncThreshold: Int = Int.MAX_VALUE
+
+    /**
+     * Stacks of at least this many matrices of at most 64 rows and columns are multiplied natively by
+     * [matmul][org.jetbrains.numkt.linalg.matmul], one matrix per task on the pool, instead of a BLAS call per matrix.
+     * [Int.MAX_VALUE] turns the native products off.
+     */
+    @Volatile
+    var matmulBatchThreshold: Int = 64
+
+    /**
+     * Contiguous arrays of at most this many elements are processed on the JVM, without a call into Python, by
+     * [sum][org.jetbrains.numkt.math.sum], [mean][org.jetbrains.numkt.statistics.mean],
+     * [var][org.jetbrains.numkt.statistics.var], [amax][org.jetbrains.numkt.statistics.amax],
+     * [amin][org.jetbrains.numkt.statistics.amin], [argMax], [argMin], [countNonZero],
+     * [vdot][org.jetbrains.numkt.linalg.vdot] and the operators `+`, `-`, `*` and `/` of arrays of the same type
+     * and shape, or of an array of doubles and a number.
+     * Arrays of doubles, floats, longs and ints are handled, other arrays are processed by numpy.
+     * The results are the same as numpy's, sums included, except for the sign of a zero extreme and
+     * the last bits of a floating [vdot][org.jetbrains.numkt.linalg.vdot]. 0 turns the small-array tier off.
+     */
+    @Volatile
+    var smallArrayThreshold: Int = 1 shl 10
+
+    /**
+     * Whether the workers of the pool are bound to processors of their own. Binding keeps the caches of the workers
+     * warm on machines with many cores, but competes with other processes pinned to the same processors.
+     * Changing it restarts the workers. Only supported on Linux.
+     */
+    var affinity: Boolean
+        get() = getAffinity()
+        set(value) = setAffinity(value)
+
+    @JvmStatic
+    private external fun getThreads(): Int
+
+    @JvmStatic
+    private external fun setThreads(threads: Int)
+
+    @JvmStatic
+    private external fun getAffinity(): Boolean
+
+    @JvmStatic
+    private external fun setAffinity(pin: Boolean)
+}
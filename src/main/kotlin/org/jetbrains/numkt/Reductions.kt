@@ -0,0 +1,65 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+import kotlin.reflect.KClass
+
+/**
+ * Native parallel reductions of large arrays, see [Parallel.reductionThreshold].
+ * Small arrays are reduced on the JVM by [SmallArrays].
+ * The functions return *null* when the array is left to numpy.
+ *
+ * Floating sums are pairwise and accumulated in doubles, integer sums wrap around in the type of the array.
+ */
+@PublishedApi
+internal object Reductions {
+    init {
+        Interpreter.interpreter
+    }
+
+    // operations in the order of the native ReduceOp
+    const val SUM = 0
+    const val MEAN = 1
+    const val MAX = 2
+    const val MIN = 3
+    const val ARGMAX = 4
+    const val ARGMIN = 5
+    const val COUNT = 6
+    const val VAR = 7
+
+    fun <R : Any> all(a: KtNDArray<*>, op: Int, kClass: KClass<R>, ddof: Int = 0): R? {
+        SmallArrays.reduce(a, op, kClass, ddof)?.let { return it }
+        if (!accepts(a)) return null
+        @Suppress("UNCHECKED_CAST")
+        return reduceAll(a, op, ddof, kClass.javaObjectType) as R?
+    }
+
+    fun <R : Any> axis(a: KtNDArray<*>, op: Int, axis: Int, ddof: Int = 0): KtNDArray<R>? {
+        if (!accepts(a)) return null
+        @Suppress("UNCHECKED_CAST")
+        return reduceAxis(a, op, axis, ddof) as KtNDArray<R>?
+    }
+
+    private fun accepts(a: KtNDArray<*>): Boolean = a.isNotScalar() && a.size >= Parallel.reductionThreshold
+
+    @JvmStatic
+    private external fun reduceAll(a: KtNDArray<*>, op: Int, ddof: Int, jClass: Class<*>): Any?
+
+    @JvmStatic
+    private external fun reduceAxis(a: KtNDArray<*>, op: Int, axis: Int, ddof: Int): KtNDArray<*>?
+}
@@ -51,7 +51,7 @@ enum class Side(val str: String) {
  * @see partition
  */
 fun <T : Any> sort(a: KtNDArray<T>, axis: Int = -1, kind: KindSort? = null): KtNDArray<T> =
-    callFunc(nameMethod = arrayOf("sort"), args = arrayOf(a, axis, kind?.str ?: None.none))
+    Sorting.sort(a, axis) ?: callFunc(nameMethod = arrayOf("sort"), args = arrayOf(a, axis, kind?.str ?: None.none))
 
 /**
  * Perform an indirect stable sort using a sequence of keys.
@@ -78,7 +78,7 @@ fun <T : Any> lexSort(keys: Array<KtNDArray<T>>, axis: Int = -1): KtNDArray<Long
  * @see argPartition
  */
 fun <T : Any> argSort(a: KtNDArray<T>, axis: Int = -1, kind: KindSort? = null): KtNDArray<Long> =
-    callFunc(nameMethod = arrayOf("argsort"), args = arrayOf(a, axis, kind?.str ?: None.none))
+    Sorting.argSort(a, axis) ?: callFunc(nameMethod = arrayOf("argsort"), args = arrayOf(a, axis, kind?.str ?: None.none))
 
 /**
  * Return of an array sorted along the first axis.
@@ -127,6 +127,33 @@ fun <T : Any> argPartition(
 ): KtNDArray<Long> =
     callFunc(nameMethod = arrayOf("argpartition"), args = arrayOf(a, kth, axis, kind))
 
+/**
+ * Returns the [k] largest or smallest elements along the given axis and their indices,
+ * without sorting the whole array.
+ *
+ * The elements are in order, largest first when [largest] is true, and equal elements are ordered by index.
+ * NaN is greater than any other value.
+ *
+ * @param a input array.
+ * @param k number of elements to take, from 0 to the length of [axis].
+ * @param axis along which to select. The default is the last axis (-1).
+ * @param largest whether to take the largest elements or the smallest.
+ * @return [Pair] of the values and the indices, of the shape of [a] with [k] along [axis].
+ * @see argPartition
+ * @see argSort
+ */
+fun <T : Number> topK(
+    a: KtNDArray<T>,
+    k: Int,
+    axis: Int = -1,
+    largest: Boolean = true
+): Pair<KtNDArray<T>, KtNDArray<Long>> {
+    require(axis in -a.ndim until a.ndim) { "axis $axis is out of bounds for array of dimension ${a.ndim}" }
+    val length = a.shape[if (axis < 0) axis + a.ndim else axis]
+    require(k in 0..length) { "k must be in 0..$length, got $k" }
+    return Sorting.topK(a, k, axis, largest)
+}
+
 /**
  * Returns the index of the maximum value along the flattened array.
  *
@@ -135,7 +162,8 @@ fun <T : Any> argPartition(
  * @see argMin
  */
 fun <T : Number> argMax(a: KtNDArray<T>): Long =
-    callFunc(nameMethod = arrayOf("argmax"), args = arrayOf(a), kClass = Long::class)
+    Reductions.all(a, Reductions.ARGMAX, Long::class)
+        ?: callLong(nameMethod = arrayOf("argmax"), args = arrayOf(a))
 
 /**
  * Returns the indices of the maximum values along an axis.
@@ -146,7 +174,8 @@ fun <T : Number> argMax(a: KtNDArray<T>): Long =
  * @see argMin
  */
 fun <T : Number> argMax(a: KtNDArray<T>, axis: Int): KtNDArray<Long> =
-    callFunc(nameMethod = arrayOf("argmax"), args = arrayOf(a, axis))
+    Reductions.axis(a, Reductions.ARGMAX, axis)
+        ?: callFunc(nameMethod = arrayOf("argmax"), args = arrayOf(a, axis))
 
 /**
  * Return the indices of the maximum values in the specified axis ignoring [Double.NaN].
@@ -157,7 +186,7 @@ fun <T : Number> argMax(a: KtNDArray<T>, axis: Int): KtNDArray<Long> =
  * @see nanArgMin
  */
 fun <T : Number> nanArgMax(a: KtNDArray<T>): Long =
-    callFunc(nameMethod = arrayOf("nanargmax"), args = arrayOf(a), kClass = Long::class)
+    callLong(nameMethod = arrayOf("nanargmax"), args = arrayOf(a))
 
 /**
  * @param axis along which to operate.
@@ -174,7 +203,8 @@ fun <T : Number> nanArgMax(a: KtNDArray<T>, axis: Int): KtNDArray<Long> =
  * @see argMax
  */
 fun <T : Number> argMin(a: KtNDArray<T>): Long =
-    callFunc(nameMethod = arrayOf("argmin"), args = arrayOf(a), kClass = Long::class)
+    Reductions.all(a, Reductions.ARGMIN, Long::class)
+        ?: callLong(nameMethod = arrayOf("argmin"), args = arrayOf(a))
 
 /**
  * Returns the indices of the minimum values along an axis.
@@ -185,7 +215,8 @@ fun <T : Number> argMin(a: KtNDArray<T>): Long =
  * @see argMax
  */
 fun <T : Number> argMin(a: KtNDArray<T>, axis: Int): KtNDArray<Long> =
-    callFunc(nameMethod = arrayOf("argmin"), args = arrayOf(a, axis))
+    Reductions.axis(a, Reductions.ARGMIN, axis)
+        ?: callFunc(nameMethod = arrayOf("argmin"), args = arrayOf(a, axis))
 
 /**
  * Return the indices of the minimum values in the specified axis ignoring [Double.NaN].
@@ -196,7 +227,7 @@ fun <T : Number> argMin(a: KtNDArray<T>, axis: Int): KtNDArray<Long> =
  * @see argMin
  */
 fun <T : Number> nanArgMin(a: KtNDArray<T>): Long =
-    callFunc(nameMethod = arrayOf("nanargmin"), args = arrayOf(a), kClass = Long::class)
+    callLong(nameMethod = arrayOf("nanargmin"), args = arrayOf(a))
 
 /**
  * @param axis along which to operate.
@@ -239,7 +270,7 @@ fun <T : Number> flatNoneZero(a: KtNDArray<T>): KtNDArray<Long> =
  * @see sort
  */
 fun <T : Number> searchSorted(a: KtNDArray<T>, v: T, side: Side = Side.LEFT): Long =
-    callFunc(nameMethod = arrayOf("searchsorted"), args = arrayOf(a, v, side.str), kClass = Long::class)
+    callLong(nameMethod = arrayOf("searchsorted"), args = arrayOf(a, v, side.str))
 
 /**
  * @param v [KtNDArray] of values to insert into [a].
@@ -255,7 +286,8 @@ fun <T : Number> searchSorted(a: KtNDArray<T>, v: KtNDArray<T>, side: Side = Sid
  * @see nonZero
  */
 fun <T : Any> countNonZero(a: KtNDArray<T>): Long =
-    callFunc(nameMethod = arrayOf("count_nonzero"), args = arrayOf(a), kClass = Long::class)
+    Reductions.all(a, Reductions.COUNT, Long::class)
+        ?: callLong(nameMethod = arrayOf("count_nonzero"), args = arrayOf(a))
 
 /**
  * Counts the number of non-zero values in the array [a] along a given axis.
@@ -265,4 +297,5 @@ fun <T : Any> countNonZero(a: KtNDArray<T>): Long =
  * @see nonZero
  */
 fun <T : Any> countNonZero(a: KtNDArray<T>, axis: Int): KtNDArray<Long> =
-    callFunc(nameMethod = arrayOf("count_nonzero"), args = arrayOf(a, axis))
\ No newline at end of file
+    Reductions.axis(a, Reductions.COUNT, axis)
+        ?: callFunc(nameMethod = arrayOf("count_nonzero"), args = arrayOf(a, axis))
\ No newline at end of file
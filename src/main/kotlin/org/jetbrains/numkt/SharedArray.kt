@@ -0,0 +1,64 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Create a zero-filled array in POSIX shared memory.
+ *
+ * Other processes of the host attach the same memory by [name] with [attachSharedArray],
+ * so the data is stored once however many interpreters use it.
+ * The segment outlives the process until [unlinkSharedArray] is called.
+ *
+ * @param name name of the segment, a leading `/` is added if missing.
+ * @param shape shape of the array.
+ * @return writeable [KtNDArray] over the segment, [KtNDArray.data] is a direct buffer over the same memory.
+ * @throws NumKtException if a segment with this name already exists.
+ */
+inline fun <reified T : Any> sharedArray(name: String, vararg shape: Int): KtNDArray<T> =
+    sharedArray(name, shape, T::class.javaObjectType)
+
+/**
+ * Create a zero-filled array of [dtype] elements in POSIX shared memory.
+ *
+ * @see sharedArray
+ */
+fun <T : Any> sharedArray(name: String, shape: IntArray, dtype: Class<T>): KtNDArray<T> {
+    @Suppress("UNCHECKED_CAST")
+    return NpyIO.shmCreate(shmName(name), shape, dtype) as KtNDArray<T>
+}
+
+/**
+ * Attach an array created by [sharedArray], possibly in another process.
+ * The memory is unmapped when the array and all its views are garbage collected.
+ *
+ * @param name name of the segment.
+ * @param mmapMode [MmapMode.READ] maps the segment read-only, [MmapMode.READ_WRITE] shares writes between processes,
+ * with [MmapMode.COPY_ON_WRITE] writes stay private to the array.
+ */
+fun <T : Any> attachSharedArray(name: String, mmapMode: MmapMode = MmapMode.READ): KtNDArray<T> {
+    @Suppress("UNCHECKED_CAST")
+    return NpyIO.shmAttach(shmName(name), mmapMode.str) as KtNDArray<T>
+}
+
+/**
+ * Remove the name of the shared array, the memory is freed once all the arrays attached to it are collected.
+ */
+fun unlinkSharedArray(name: String): Unit = NpyIO.shmUnlink(shmName(name))
+
+private fun shmName(name: String): String = if (name.startsWith("/")) name else "/$name"
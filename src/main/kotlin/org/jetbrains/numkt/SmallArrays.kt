@@ -0,0 +1,445 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+import java.nio.Buffer
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import kotlin.reflect.KClass
+
+/**
+ * Small-array tier, see [Parallel.smallArrayThreshold]. The kernels run on the JVM over the direct buffers
+ * of contiguous arrays, without crossing into Python. The functions return *null* when the arrays are left to numpy.
+ *
+ * Floating sums are pairwise with the blocks of numpy, so sums, means and variances are the same as numpy's
+ * to the bit. Extremes may differ from numpy in the sign of a zero, floating [vdot] and [dot] in the last bits
+ * of BLAS, [exp] in the last bit of numpy's vectorized loops.
+ */
+@PublishedApi
+internal object SmallArrays {
+    init {
+        Interpreter.interpreter
+    }
+
+    // elementwise operations
+    const val ADD = 0
+    const val SUBTRACT = 1
+    const val MULTIPLY = 2
+    const val DIVIDE = 3
+
+    // kinds of the elements in the order of the native SmallKind
+    private const val DOUBLE = 0
+    private const val FLOAT = 1
+    private const val LONG = 2
+    private const val INT = 3
+
+    // block of the unrolled loop of numpy's pairwise summation
+    private const val PAIRWISE_BLOCK = 128
+
+    fun <R : Any> reduce(a: KtNDArray<*>, op: Int, kClass: KClass<R>, ddof: Int): R? {
+        val n = count(a)
+        if (n <= 0) return null
+        val result: Any? = when (a.layout[0]) {
+            DOUBLE -> reduceDoubles(readDoubles(a, n), op, ddof)
+            FLOAT -> reduceFloats(readFloats(a, n), op, ddof)
+            else -> reduceLongs(readLongs(a, n), op, ddof)
+        }
+        @Suppress("UNCHECKED_CAST")
+        return convert(result, kClass) as R?
+    }
+
+    fun <T : Any> binary(op: Int, left: Any, right: Any): KtNDArray<T>? {
+        val array = (if (left is KtNDArray<*>) left else right) as? KtNDArray<*> ?: return null
+        val n = count(array)
+        if (n <= 0) return null
+        val kind = array.layout[0]
+        if (left is KtNDArray<*> && right is KtNDArray<*>) {
+            if (count(left) != n || count(right) != n || !left.layout.contentEquals(right.layout)) return null
+        } else if (kind != DOUBLE || (left !is Number && right !is Number)) {
+            return null
+        }
+        if (op == DIVIDE && (kind == LONG || kind == INT)) return null
+
+        val out = newLike(array)
+        when (kind) {
+            DOUBLE -> {
+                val x = operand(left, n)
+                val y = operand(right, n)
+                when (op) {
+                    ADD -> for (i in 0 until n) x[i] += y[i]
+                    SUBTRACT -> for (i in 0 until n) x[i] -= y[i]
+                    MULTIPLY -> for (i in 0 until n) x[i] *= y[i]
+                    else -> for (i in 0 until n) x[i] /= y[i]
+                }
+                view(out).asDoubleBuffer().put(x)
+            }
+            FLOAT -> {
+                val x = readFloats(left as KtNDArray<*>, n)
+                val y = readFloats(right as KtNDArray<*>, n)
+                when (op) {
+                    ADD -> for (i in 0 until n) x[i] += y[i]
+                    SUBTRACT -> for (i in 0 until n) x[i] -= y[i]
+                    MULTIPLY -> for (i in 0 until n) x[i] *= y[i]
+                    else -> for (i in 0 until n) x[i] /= y[i]
+                }
+                view(out).asFloatBuffer().put(x)
+            }
+            LONG -> {
+                val x = readLongs(left as KtNDArray<*>, n)
+                val y = readLongs(right as KtNDArray<*>, n)
+                when (op) {
+                    ADD -> for (i in 0 until n) x[i] += y[i]
+                    SUBTRACT -> for (i in 0 until n) x[i] -= y[i]
+                    else -> for (i in 0 until n) x[i] *= y[i]
+                }
+                view(out).asLongBuffer().put(x)
+            }
+            else -> {
+                val x = readInts(left as KtNDArray<*>, n)
+                val y = readInts(right as KtNDArray<*>, n)
+                when (op) {
+                    ADD -> for (i in 0 until n) x[i] += y[i]
+                    SUBTRACT -> for (i in 0 until n) x[i] -= y[i]
+                    else -> for (i in 0 until n) x[i] *= y[i]
+                }
+                view(out).asIntBuffer().put(x)
+            }
+        }
+        @Suppress("UNCHECKED_CAST")
+        return out as KtNDArray<T>
+    }
+
+    fun <R : Any> vdot(a: KtNDArray<*>, b: KtNDArray<*>, kClass: KClass<R>): R? {
+        val n = count(a)
+        if (n <= 0 || count(b) != n || a.layout[0] != b.layout[0]) return null
+        val result: Any = when (a.layout[0]) {
+            DOUBLE -> {
+                val x = readDoubles(a, n)
+                val y = readDoubles(b, n)
+                var s = 0.0
+                for (i in 0 until n) s += x[i] * y[i]
+                s
+            }
+            FLOAT -> {
+                val x = readFloats(a, n)
+                val y = readFloats(b, n)
+                var s = 0.0
+                for (i in 0 until n) s += x[i].toDouble() * y[i]
+                s.toFloat()
+            }
+            else -> {
+                // products are summed in 64 bits and truncated to the type by numpy
+                val x = readLongs(a, n)
+                val y = readLongs(b, n)
+                var s = 0L
+                for (i in 0 until n) s += x[i] * y[i]
+                if (a.layout[0] == INT) s.toInt() else s
+            }
+        }
+        @Suppress("UNCHECKED_CAST")
+        return convert(result, kClass) as R?
+    }
+
+    fun <T : Any> exp(x: KtNDArray<*>): KtNDArray<T>? {
+        val n = count(x)
+        if (n <= 0) return null
+        val out = when (x.layout[0]) {
+            DOUBLE -> {
+                val y = readDoubles(x, n)
+                for (i in 0 until n) y[i] = kotlin.math.exp(y[i])
+                newLike(x).also { view(it).asDoubleBuffer().put(y) }
+            }
+            FLOAT -> {
+                val y = readFloats(x, n)
+                for (i in 0 until n) y[i] = kotlin.math.exp(y[i].toDouble()).toFloat()
+                newLike(x).also { view(it).asFloatBuffer().put(y) }
+            }
+            // the exponential of integers is a new array of doubles
+            else -> return null
+        }
+        @Suppress("UNCHECKED_CAST")
+        return out as KtNDArray<T>
+    }
+
+    /**
+     * Product of matrices and vectors, (m, k) x (k, p), (m, k) x (k) or (k) x (k, p).
+     * The product of two vectors is a scalar and is left to numpy, see [vdot].
+     */
+    fun <T : Any> dot(a: KtNDArray<*>, b: KtNDArray<*>): KtNDArray<T>? {
+        val na = count(a)
+        val nb = count(b)
+        if (na <= 0 || nb <= 0) return null
+        val la = a.layout
+        val lb = b.layout
+        if (la[0] != lb[0] || la.size > 3 || lb.size > 3 || la.size + lb.size < 5 || la[la.size - 1] != lb[1]) {
+            return null
+        }
+        val m = if (la.size == 3) la[1] else 1
+        val k = lb[1]
+        val p = if (lb.size == 3) lb[2] else 1
+        if (m.toLong() * p > Parallel.smallArrayThreshold) return null
+
+        val shape = when {
+            la.size == 2 -> intArrayOf(p)
+            lb.size == 2 -> intArrayOf(m)
+            else -> intArrayOf(m, p)
+        }
+        val out = newShaped(a, shape)
+        // rows of b are added in order, so the inner loop runs over contiguous elements
+        when (la[0]) {
+            DOUBLE, FLOAT -> {
+                val x = readDoubles(a, na)
+                val y = readDoubles(b, nb)
+                val z = DoubleArray(m * p)
+                for (i in 0 until m) for (l in 0 until k) {
+                    val xil = x[i * k + l]
+                    for (j in 0 until p) z[i * p + j] += xil * y[l * p + j]
+                }
+                if (la[0] == DOUBLE) {
+                    view(out).asDoubleBuffer().put(z)
+                } else {
+                    view(out).asFloatBuffer().put(FloatArray(z.size) { z[it].toFloat() })
+                }
+            }
+            else -> {
+                // products are summed in 64 bits and truncated to the type by numpy
+                val x = readLongs(a, na)
+                val y = readLongs(b, nb)
+                val z = LongArray(m * p)
+                for (i in 0 until m) for (l in 0 until k) {
+                    val xil = x[i * k + l]
+                    for (j in 0 until p) z[i * p + j] += xil * y[l * p + j]
+                }
+                if (la[0] == LONG) {
+                    view(out).asLongBuffer().put(z)
+                } else {
+                    view(out).asIntBuffer().put(IntArray(z.size) { z[it].toInt() })
+                }
+            }
+        }
+        @Suppress("UNCHECKED_CAST")
+        return out as KtNDArray<T>
+    }
+
+    // Number of elements of [a] when it is processed on the JVM, otherwise -1.
+    private fun count(a: KtNDArray<*>): Int {
+        val threshold = Parallel.smallArrayThreshold
+        if (threshold == 0 || a.isScalar()) return -1
+        val layout = a.layout
+        val data = a.data ?: return -1
+        val itemsize = when (layout[0]) {
+            DOUBLE, LONG -> 8
+            FLOAT, INT -> 4
+            else -> return -1
+        }
+        var n = 1L
+        for (i in 1 until layout.size) n *= layout[i]
+        return if (n <= threshold && a.offset + n * itemsize <= data.capacity()) n.toInt() else -1
+    }
+
+    private fun view(a: KtNDArray<*>): ByteBuffer {
+        val buffer = a.data!!.duplicate().order(ByteOrder.nativeOrder())
+        (buffer as Buffer).position(a.offset)
+        return buffer
+    }
+
+    private fun readDoubles(a: KtNDArray<*>, n: Int): DoubleArray = when (a.layout[0]) {
+        DOUBLE -> DoubleArray(n).also { view(a).asDoubleBuffer().get(it) }
+        FLOAT -> readFloats(a, n).let { x -> DoubleArray(n) { x[it].toDouble() } }
+        else -> readLongs(a, n).let { x -> DoubleArray(n) { x[it].toDouble() } }
+    }
+
+    // Doubles of an array or a scalar repeated, as numpy broadcasts it.
+    private fun operand(x: Any, n: Int): DoubleArray =
+        if (x is KtNDArray<*>) readDoubles(x, n) else DoubleArray(n).apply { fill((x as Number).toDouble()) }
+
+    private fun readFloats(a: KtNDArray<*>, n: Int): FloatArray =
+        FloatArray(n).also { view(a).asFloatBuffer().get(it) }
+
+    private fun readLongs(a: KtNDArray<*>, n: Int): LongArray = when (a.layout[0]) {
+        LONG -> LongArray(n).also { view(a).asLongBuffer().get(it) }
+        else -> readInts(a, n).let { x -> LongArray(n) { x[it].toLong() } }
+    }
+
+    private fun readInts(a: KtNDArray<*>, n: Int): IntArray =
+        IntArray(n).also { view(a).asIntBuffer().get(it) }
+
+    private fun reduceDoubles(x: DoubleArray, op: Int, ddof: Int): Any? {
+        val n = x.size
+        return when (op) {
+            Reductions.SUM -> sum(x, 0, n)
+            Reductions.MEAN -> sum(x, 0, n) / n
+            Reductions.VAR -> {
+                if (n - ddof <= 0) return null
+                val mean = sum(x, 0, n) / n
+                for (i in 0 until n) x[i] = (x[i] - mean) * (x[i] - mean)
+                sum(x, 0, n) / (n - ddof)
+            }
+            Reductions.MAX -> {
+                var m = x[0]
+                for (i in 1 until n) {
+                    if (m.isNaN()) break
+                    if (x[i] >= m || x[i].isNaN()) m = x[i]
+                }
+                m
+            }
+            Reductions.MIN -> {
+                var m = x[0]
+                for (i in 1 until n) {
+                    if (m.isNaN()) break
+                    if (x[i] <= m || x[i].isNaN()) m = x[i]
+                }
+                m
+            }
+            Reductions.ARGMAX -> {
+                var k = 0
+                for (i in 0 until n) {
+                    if (x[i].isNaN()) return i.toLong()
+                    if (x[i] > x[k]) k = i
+                }
+                k.toLong()
+            }
+            Reductions.ARGMIN -> {
+                var k = 0
+                for (i in 0 until n) {
+                    if (x[i].isNaN()) return i.toLong()
+                    if (x[i] < x[k]) k = i
+                }
+                k.toLong()
+            }
+            Reductions.COUNT -> x.count { it != 0.0 }.toLong()
+            else -> null
+        }
+    }
+
+    private fun reduceFloats(x: FloatArray, op: Int, ddof: Int): Any? {
+        val n = x.size
+        return when (op) {
+            Reductions.SUM -> sum(x, 0, n)
+            Reductions.MEAN -> (sum(x, 0, n).toDouble() / n).toFloat().toDouble()
+            Reductions.VAR -> {
+                if (n - ddof <= 0) return null
+                // the mean is divided in the type of the array, as the variance of numpy does
+                val mean = sum(x, 0, n) / n.toFloat()
+                for (i in 0 until n) x[i] = (x[i] - mean) * (x[i] - mean)
+                (sum(x, 0, n).toDouble() / (n - ddof)).toFloat().toDouble()
+            }
+            // the other reductions are exact in doubles
+            else -> reduceDoubles(DoubleArray(n) { x[it].toDouble() }, op, ddof)?.let {
+                if (op == Reductions.MAX || op == Reductions.MIN) (it as Double).toFloat() else it
+            }
+        }
+    }
+
+    private fun reduceLongs(x: LongArray, op: Int, ddof: Int): Any? {
+        val n = x.size
+        return when (op) {
+            Reductions.SUM -> x.sum()
+            Reductions.MAX -> x[argMax(x)]
+            Reductions.MIN -> x[argMin(x)]
+            Reductions.ARGMAX -> argMax(x).toLong()
+            Reductions.ARGMIN -> argMin(x).toLong()
+            Reductions.COUNT -> x.count { it != 0L }.toLong()
+            // means and variances of integers are in doubles
+            else -> reduceDoubles(DoubleArray(n) { x[it].toDouble() }, op, ddof)
+        }
+    }
+
+    private fun argMax(x: LongArray): Int {
+        var k = 0
+        for (i in 1 until x.size) if (x[i] > x[k]) k = i
+        return k
+    }
+
+    private fun argMin(x: LongArray): Int {
+        var k = 0
+        for (i in 1 until x.size) if (x[i] < x[k]) k = i
+        return k
+    }
+
+    // Pairwise summation of numpy, added to zero as the reduction of numpy does.
+    private fun sum(x: DoubleArray, from: Int, n: Int): Double = 0.0 + pairwise(x, from, n)
+
+    private fun sum(x: FloatArray, from: Int, n: Int): Float = 0.0f + pairwise(x, from, n)
+
+    private fun pairwise(x: DoubleArray, from: Int, n: Int): Double {
+        if (n < 8) {
+            var s = -0.0
+            for (i in from until from + n) s += x[i]
+            return s
+        }
+        if (n <= PAIRWISE_BLOCK) {
+            val r = DoubleArray(8) { x[from + it] }
+            var i = 8
+            while (i < n - n % 8) {
+                for (j in 0 until 8) r[j] += x[from + i + j]
+                i += 8
+            }
+            var s = ((r[0] + r[1]) + (r[2] + r[3])) + ((r[4] + r[5]) + (r[6] + r[7]))
+            while (i < n) s += x[from + i++]
+            return s
+        }
+        val half = n / 2 - n / 2 % 8
+        return pairwise(x, from, half) + pairwise(x, from + half, n - half)
+    }
+
+    private fun pairwise(x: FloatArray, from: Int, n: Int): Float {
+        if (n < 8) {
+            var s = -0.0f
+            for (i in from until from + n) s += x[i]
+            return s
+        }
+        if (n <= PAIRWISE_BLOCK) {
+            val r = FloatArray(8) { x[from + it] }
+            var i = 8
+            while (i < n - n % 8) {
+                for (j in 0 until 8) r[j] += x[from + i + j]
+                i += 8
+            }
+            var s = ((r[0] + r[1]) + (r[2] + r[3])) + ((r[4] + r[5]) + (r[6] + r[7]))
+            while (i < n) s += x[from + i++]
+            return s
+        }
+        val half = n / 2 - n / 2 % 8
+        return pairwise(x, from, half) + pairwise(x, from + half, n - half)
+    }
+
+    private fun convert(value: Any?, kClass: KClass<*>): Any? = when (value) {
+        null -> null
+        is Long -> when (kClass) {
+            Long::class -> value
+            Int::class -> value.toInt()
+            Double::class -> value.toDouble()
+            else -> null
+        }
+        is Int -> if (kClass == Int::class) value else null
+        is Float -> if (kClass == Float::class) value else null
+        is Double -> when (kClass) {
+            Double::class -> value
+            Float::class -> value.toFloat()
+            else -> null
+        }
+        else -> null
+    }
+
+    @JvmStatic
+    private external fun newLike(a: KtNDArray<*>): KtNDArray<*>
+
+    @JvmStatic
+    private external fun newShaped(a: KtNDArray<*>, shape: IntArray): KtNDArray<*>
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Native parallel sorting of large arrays, see [Parallel.sortThreshold].
+ * [sort] and [argSort] return *null* when the array is left to numpy.
+ *
+ * Indices are sorted stably, NaN values go last.
+ */
+internal object Sorting {
+    init {
+        Interpreter.interpreter
+    }
+
+    fun <T : Any> sort(a: KtNDArray<T>, axis: Int): KtNDArray<T>? {
+        if (!accepts(a)) return null
+        @Suppress("UNCHECKED_CAST")
+        return sortAxis(a, axis) as KtNDArray<T>?
+    }
+
+    fun argSort(a: KtNDArray<*>, axis: Int): KtNDArray<Long>? {
+        if (!accepts(a)) return null
+        @Suppress("UNCHECKED_CAST")
+        return argSortAxis(a, axis) as KtNDArray<Long>?
+    }
+
+    fun <T : Any> topK(a: KtNDArray<T>, k: Int, axis: Int, largest: Boolean): Pair<KtNDArray<T>, KtNDArray<Long>> {
+        @Suppress("UNCHECKED_CAST")
+        return selectTopK(a, k, axis, largest) as Pair<KtNDArray<T>, KtNDArray<Long>>
+    }
+
+    private fun accepts(a: KtNDArray<*>): Boolean = a.isNotScalar() && a.size >= Parallel.sortThreshold
+
+    @JvmStatic
+    private external fun sortAxis(a: KtNDArray<*>, axis: Int): KtNDArray<*>?
+
+    @JvmStatic
+    private external fun argSortAxis(a: KtNDArray<*>, axis: Int): KtNDArray<*>?
+
+    @JvmStatic
+    private external fun selectTopK(a: KtNDArray<*>, k: Int, axis: Int, largest: Boolean): Pair<*, *>
+}
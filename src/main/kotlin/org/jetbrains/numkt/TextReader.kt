@@ -0,0 +1,161 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Streaming reader of numeric text files (CSV and the like).
+ *
+ * Rows are parsed natively straight into preallocated arrays, so a file of any size
+ * can be processed chunk by chunk without building Kotlin strings or Python lists.
+ * Supported types are [Double], [Float], [Long], [Int], [Short] and [Byte].
+ *
+ * @param file filename.
+ * @param dtype type of the elements.
+ * @param delimiter the character used to separate values, by default any whitespace.
+ * @param comments the character used to indicate the start of a comment, null if there are no comments.
+ * @param skiprows skip the first [skiprows] lines, including comments.
+ * @param usecols which columns to read, with 0 being the first. Negative indexes count from the end,
+ * a column may be named once.
+ * @param parallel if *true*, lines of a chunk are parsed on several threads.
+ */
+class TextReader<T : Number>(
+    file: String,
+    private val dtype: Class<T>,
+    delimiter: Char? = null,
+    comments: Char? = '#',
+    skiprows: Int = 0,
+    usecols: IntArray? = null,
+    var parallel: Boolean = true
+) : AutoCloseable {
+
+    init {
+        Interpreter.interpreter
+    }
+
+    private var pointer: Long = readerOpen(file, delimiter ?: '\u0000', comments ?: '\u0000', skiprows, usecols)
+
+    /**
+     * Number of columns in each row.
+     */
+    val columns: Int = readerColumns(pointer)
+
+    /**
+     * Fill [out] with the next rows of the file.
+     *
+     * @param out C-contiguous writeable array of the shape `(rows, columns)`, or `(rows)` if there is one column.
+     * @return the number of rows read, 0 at the end of file.
+     */
+    fun read(out: KtNDArray<T>): Int {
+        check(pointer != 0L) { "TextReader is closed" }
+        return readerRead(pointer, out, if (parallel) 0 else 1)
+    }
+
+    /**
+     * Sequence of chunks of at most [chunkRows] rows.
+     * The last chunk is a view of the first rows of the chunk buffer.
+     *
+     * @param chunkRows number of rows in a chunk.
+     * @param reuse if *true*, the same array is filled for each chunk,
+     * so a chunk is valid only until the next one is requested.
+     */
+    fun chunks(chunkRows: Int = DEFAULT_CHUNK_ROWS, reuse: Boolean = false): Sequence<KtNDArray<T>> {
+        require(chunkRows > 0) { "chunkRows must be positive" }
+        var buffer: KtNDArray<T>? = null
+        return generateSequence {
+            val out = buffer ?: allocate(chunkRows)
+            if (reuse) buffer = out
+            val rows = read(out)
+            when (rows) {
+                0 -> null
+                chunkRows -> out
+                else -> out[0 until rows]
+            }
+        }
+    }
+
+    private fun allocate(rows: Int): KtNDArray<T> =
+        callFunc(
+            nameMethod = arrayOf("empty"),
+            args = arrayOf(if (columns == 1) intArrayOf(rows) else intArrayOf(rows, columns), dtype)
+        )
+
+    override fun close() {
+        if (pointer != 0L) {
+            readerClose(pointer)
+            pointer = 0L
+        }
+    }
+
+    protected fun finalize() {
+        close()
+    }
+
+    private external fun readerOpen(file: String, delimiter: Char, comment: Char, skiprows: Int, usecols: IntArray?): Long
+
+    private external fun readerColumns(ptr: Long): Int
+
+    private external fun readerRead(ptr: Long, out: KtNDArray<T>, threads: Int): Int
+
+    private external fun readerClose(ptr: Long)
+
+    companion object {
+        const val DEFAULT_CHUNK_ROWS = 65536
+    }
+}
+
+/**
+ * Read a text file in chunks of at most [chunkRows] rows.
+ * The file is closed once the sequence is exhausted.
+ *
+ * @see TextReader
+ */
+inline fun <reified T : Number> readTextChunks(
+    fname: String,
+    chunkRows: Int = TextReader.DEFAULT_CHUNK_ROWS,
+    delimiter: Char? = null,
+    comments: Char? = '#',
+    skiprows: Int = 0,
+    usecols: IntArray? = null,
+    reuse: Boolean = false
+): Sequence<KtNDArray<T>> = sequence {
+    TextReader(fname, T::class.javaObjectType, delimiter, comments, skiprows, usecols).use {
+        yieldAll(it.chunks(chunkRows, reuse))
+    }
+}
+
+/**
+ * Load data from a text file, each row must have the same number of values.
+ *
+ * @see TextReader
+ */
+inline fun <reified T : Number> loadText(
+    fname: String,
+    delimiter: Char? = null,
+    comments: Char? = '#',
+    skiprows: Int = 0,
+    usecols: IntArray? = null
+): KtNDArray<T> {
+    val chunks = readTextChunks<T>(fname, delimiter = delimiter, comments = comments, skiprows = skiprows, usecols = usecols)
+        .toList()
+    return when (chunks.size) {
+        0 -> empty(0)
+        1 -> chunks[0]
+        else -> concatenate(*chunks.toTypedArray())
+    }
+}
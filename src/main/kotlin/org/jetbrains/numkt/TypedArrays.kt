@@ -0,0 +1,154 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.ComplexDouble
+import org.jetbrains.numkt.core.ComplexFloat
+import org.jetbrains.numkt.core.Half
+import org.jetbrains.numkt.core.KtNDArray
+import java.nio.Buffer
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/*
+ * Bulk copies between the arrays of the compact dtypes and primitive JVM arrays, without boxing the elements.
+ * Arrays that are not C-contiguous are copied by numpy first. Unsigned elements keep their bits in the
+ * signed arrays behind kotlin's unsigned arrays, complex elements are interleaved real and imaginary parts.
+ */
+
+/**
+ * Create a `numpy.uint8` array.
+ */
+@ExperimentalUnsignedTypes
+fun array(arr: UByteArray): KtNDArray<UByte> =
+    empty<UByte>(arr.size).also { view(it).put(arr.asByteArray()) }
+
+/**
+ * Create a `numpy.uint16` array.
+ */
+@ExperimentalUnsignedTypes
+fun array(arr: UShortArray): KtNDArray<UShort> =
+    empty<UShort>(arr.size).also { view(it).asShortBuffer().put(arr.asShortArray()) }
+
+/**
+ * Create a `numpy.uint32` array.
+ */
+@ExperimentalUnsignedTypes
+fun array(arr: UIntArray): KtNDArray<UInt> =
+    empty<UInt>(arr.size).also { view(it).asIntBuffer().put(arr.asIntArray()) }
+
+/**
+ * Create a `numpy.uint64` array.
+ */
+@ExperimentalUnsignedTypes
+fun array(arr: ULongArray): KtNDArray<ULong> =
+    empty<ULong>(arr.size).also { view(it).asLongBuffer().put(arr.asLongArray()) }
+
+/**
+ * Create a `numpy.float16` array, rounding the [values] to nearest even.
+ */
+fun halfArray(values: FloatArray): KtNDArray<Half> =
+    empty<Half>(values.size).also { HalfFloats.narrow(values, it.buffer, it.offset, values.size) }
+
+/**
+ * Create a `numpy.complex64` array from [interleaved] real and imaginary parts.
+ */
+fun complexArray(interleaved: FloatArray): KtNDArray<ComplexFloat> {
+    require(interleaved.size % 2 == 0) { "Interleaved complex parts must be of even size." }
+    return empty<ComplexFloat>(interleaved.size / 2).also { view(it).asFloatBuffer().put(interleaved) }
+}
+
+/**
+ * Create a `numpy.complex128` array from [interleaved] real and imaginary parts.
+ */
+fun complexArray(interleaved: DoubleArray): KtNDArray<ComplexDouble> {
+    require(interleaved.size % 2 == 0) { "Interleaved complex parts must be of even size." }
+    return empty<ComplexDouble>(interleaved.size / 2).also { view(it).asDoubleBuffer().put(interleaved) }
+}
+
+/**
+ * Elements in the C order.
+ */
+@ExperimentalUnsignedTypes
+fun KtNDArray<UByte>.toUByteArray(): UByteArray =
+    contiguous(this).let { a -> ByteArray(a.size).also { view(a).get(it) }.asUByteArray() }
+
+@ExperimentalUnsignedTypes
+fun KtNDArray<UShort>.toUShortArray(): UShortArray =
+    contiguous(this).let { a -> ShortArray(a.size).also { view(a).asShortBuffer().get(it) }.asUShortArray() }
+
+@ExperimentalUnsignedTypes
+fun KtNDArray<UInt>.toUIntArray(): UIntArray =
+    contiguous(this).let { a -> IntArray(a.size).also { view(a).asIntBuffer().get(it) }.asUIntArray() }
+
+@ExperimentalUnsignedTypes
+fun KtNDArray<ULong>.toULongArray(): ULongArray =
+    contiguous(this).let { a -> LongArray(a.size).also { view(a).asLongBuffer().get(it) }.asULongArray() }
+
+/**
+ * Elements in the C order widened to [Float], which is exact.
+ */
+fun KtNDArray<Half>.toFloatArray(): FloatArray =
+    contiguous(this).let { a -> FloatArray(a.size).also { HalfFloats.widen(a.buffer, a.offset, it, it.size) } }
+
+/**
+ * Interleaved real and imaginary parts of the elements in the C order.
+ */
+@JvmName("complexToFloatArray")
+fun KtNDArray<ComplexFloat>.toFloatArray(): FloatArray =
+    contiguous(this).let { a -> FloatArray(2 * a.size).also { view(a).asFloatBuffer().get(it) } }
+
+@JvmName("complexToDoubleArray")
+fun KtNDArray<ComplexDouble>.toDoubleArray(): DoubleArray =
+    contiguous(this).let { a -> DoubleArray(2 * a.size).also { view(a).asDoubleBuffer().get(it) } }
+
+private fun <T : Any> contiguous(a: KtNDArray<T>): KtNDArray<T> {
+    if (a.isScalar()) throw NumKtException("KtNDArray is scalar.")
+    val shape = a.shape
+    val strides = a.strides
+    var expected = a.itemsize
+    for (i in shape.indices.reversed()) {
+        if (shape[i] != 1 && strides[i] != expected) {
+            return callFunc(nameMethod = arrayOf("ascontiguousarray"), args = arrayOf(a))
+        }
+        expected *= shape[i]
+    }
+    return a
+}
+
+// Buffer of the array from its first element, in the native byte order.
+private fun view(a: KtNDArray<*>): ByteBuffer {
+    val buffer = a.buffer.duplicate().order(ByteOrder.nativeOrder())
+    (buffer as Buffer).position(a.offset)
+    return buffer
+}
+
+/**
+ * Conversions between `numpy.float16` data and [Float] arrays,
+ * vectorized with F16C on x86-64 and NEON on AArch64.
+ */
+internal object HalfFloats {
+    init {
+        Interpreter.interpreter
+    }
+
+    @JvmStatic
+    external fun widen(src: ByteBuffer, offset: Int, dst: FloatArray, n: Int)
+
+    @JvmStatic
+    external fun narrow(src: FloatArray, dst: ByteBuffer, offset: Int, n: Int)
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Native parallel elementwise ufuncs of large arrays, see [Parallel.ufuncThreshold].
+ * Each chunk of the arrays is processed by numpy's own inner loop, so the results are the same as numpy's.
+ */
+internal object Ufuncs {
+    init {
+        Interpreter.interpreter
+    }
+
+    /**
+     * Calls the ufunc [name] of numpy on [x] into [out], or a new array when [out] is *null*.
+     * [float64] requests a result of type double, as the `dtype` argument of numpy.
+     */
+    fun <R : Any> call(name: String, x: Array<out KtNDArray<*>>, out: KtNDArray<R>?, float64: Boolean): KtNDArray<R> {
+        if (x.all { it.isNotScalar() && it.size >= Parallel.ufuncThreshold } && out?.isNotScalar() != false) {
+            @Suppress("UNCHECKED_CAST")
+            val result = callUfunc(name, x, out, float64) as KtNDArray<R>?
+            if (result != null) return result
+        }
+        return callFunc(
+            nameMethod = arrayOf(name), args = x, out = out,
+            dtype = if (float64) Double::class else null
+        )
+    }
+
+    @JvmStatic
+    private external fun callUfunc(
+        name: String,
+        args: Array<out KtNDArray<*>>,
+        out: KtNDArray<*>?,
+        float64: Boolean
+    ): KtNDArray<*>?
+}
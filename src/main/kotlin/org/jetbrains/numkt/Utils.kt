@@ -55,11 +55,14 @@ fun <T : Any> callFunc(
     subok: Boolean? = null,
     shape: IntArray? = null,
     ndmin: Int? = null
-): KtNDArray<T> =
-    interpreter!!.callFunc(
-        nameMethod = nameMethod, args = args,
-        kwargs = argsToKwargs(out, where, axes, axis, keepdims, casting, order, dtype, subok, shape, ndmin)
-    )
+): KtNDArray<T> {
+    val kwargs = argsToKwargs(out, where, axes, axis, keepdims, casting, order, dtype, subok, shape, ndmin)
+    return Jfr.call(nameMethod, args) {
+        val bridge = ForeignBridge.instance
+        if (kwargs == null && bridge != null && bridge.prepare(nameMethod, args)) bridge.callArray()
+        else interpreter!!.callFunc(nameMethod = nameMethod, args = args, kwargs = kwargs)
+    }
+}
 
 /**
  * Wrapper over a call to a numpy method that returns an object of a given type.
@@ -95,11 +98,76 @@ fun <T : Any> callFunc(
     subok: Boolean? = null,
     kClass: KClass<out T>
 ): T =
-    interpreter!!.callFunc(
-        nameMethod = nameMethod, args = args,
-        kwargs = argsToKwargs(out, where, axes, axis, keepdims, casting, order, dtype, subok),
-        jClass = kClass.javaObjectType
-    )
+    Jfr.call(nameMethod, args) {
+        interpreter!!.callFunc(
+            nameMethod = nameMethod, args = args,
+            kwargs = argsToKwargs(out, where, axes, axis, keepdims, casting, order, dtype, subok),
+            jClass = kClass.javaObjectType
+        )
+    }
+
+/**
+ * Wrapper over a call to a numpy method that returns a number, read natively as a double without boxing.
+ *
+ * @param nameMethod hierarchical array of PyObject names from the numpy submodule to the method.
+ * @param args of *args
+ * @return result of the method converted to [Double].
+ */
+fun callDouble(nameMethod: Array<String>, args: Array<out Any>? = null): Double {
+    return Jfr.call(nameMethod, args) {
+        val bridge = ForeignBridge.instance
+        if (bridge != null && bridge.prepare(nameMethod, args)) bridge.callDouble()
+        else interpreter!!.callDouble(nameMethod = nameMethod, args = args)
+    }
+}
+
+/**
+ * Wrapper over a call to a numpy method that returns an integer, read natively as a long without boxing.
+ *
+ * @param nameMethod hierarchical array of PyObject names from the numpy submodule to the method.
+ * @param args of *args
+ * @return result of the method converted to [Long].
+ */
+fun callLong(nameMethod: Array<String>, args: Array<out Any>? = null): Long {
+    return Jfr.call(nameMethod, args) {
+        val bridge = ForeignBridge.instance
+        if (bridge != null && bridge.prepare(nameMethod, args)) bridge.callLong()
+        else interpreter!!.callLong(nameMethod = nameMethod, args = args)
+    }
+}
+
+/**
+ * Wrapper over a call to a numpy method that returns a truth value, read natively without boxing.
+ *
+ * @param nameMethod hierarchical array of PyObject names from the numpy submodule to the method.
+ * @param args of *args
+ * @return truth value of the result of the method.
+ */
+fun callBoolean(nameMethod: Array<String>, args: Array<out Any>? = null): Boolean {
+    return Jfr.call(nameMethod, args) {
+        val bridge = ForeignBridge.instance
+        if (bridge != null && bridge.prepare(nameMethod, args)) bridge.callBoolean()
+        else interpreter!!.callBoolean(nameMethod = nameMethod, args = args)
+    }
+}
+
+/**
+ * [callDouble] or [callLong] by the type [T] of the result, for methods returning a scalar of the type of an array.
+ *
+ * @param nameMethod hierarchical array of PyObject names from the numpy submodule to the method.
+ * @param args of *args
+ * @return result of the method converted to [T].
+ */
+inline fun <reified T : Number> callNumber(nameMethod: Array<String>, args: Array<out Any>? = null): T =
+    when (T::class) {
+        Double::class -> callDouble(nameMethod, args)
+        Float::class -> callDouble(nameMethod, args).toFloat()
+        Long::class -> callLong(nameMethod, args)
+        Int::class -> callLong(nameMethod, args).toInt()
+        Short::class -> callLong(nameMethod, args).toShort()
+        Byte::class -> callLong(nameMethod, args).toByte()
+        else -> callFunc(nameMethod, args, kClass = T::class)
+    } as T
 
 private fun <T : Any> argsToKwargs(
     out: KtNDArray<T>? = null,
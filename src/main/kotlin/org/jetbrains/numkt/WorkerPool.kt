@@ -0,0 +1,500 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt
+
+import org.jetbrains.numkt.core.KtNDArray
+import java.io.File
+import java.lang.management.ManagementFactory
+import java.nio.file.Files
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicBoolean
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * Pool of helper Python processes, each with its own interpreter and numpy,
+ * to run numpy calls beyond the single GIL of the embedded interpreter.
+ *
+ * Calls are sent over Unix sockets, arrays are passed by [SharedHandle] to POSIX shared memory
+ * (see [sharedArray]), so neither arguments nor results are copied through the protocol.
+ * A call is routed to the worker where most of its array arguments are already attached, otherwise
+ * to the least busy one. [call] can be used from any thread, it does not touch the embedded interpreter
+ * unless [KtNDArray] arguments have to be copied into shared memory: like [put], such calls use the interpreter
+ * and must not run at the same time as other numpy calls of the program, calls from other threads
+ * should pass [SharedHandle] instead. A worker whose connection fails is stopped and not used again.
+ *
+ * @param size number of worker processes.
+ * @param python python executable, by default the one of the embedded interpreter.
+ */
+class WorkerPool(
+    val size: Int = Runtime.getRuntime().availableProcessors(),
+    python: String? = null
+) : AutoCloseable {
+
+    private val dir: File = Files.createTempDirectory("ktnumpy").toFile()
+    private val workers = ArrayList<Worker>(size)
+    private val next = AtomicInteger()
+
+    init {
+        require(size > 0) { "size must be positive" }
+        Interpreter.interpreter
+        val executable = python ?: LibraryLoader.pythonConf!!.python
+        val script = LibraryLoader.pythonScript("worker")
+        try {
+            for (i in 0 until size) {
+                workers.add(Worker(i, executable, script, File(dir, "w$i.sock")))
+            }
+        } catch (e: Exception) {
+            close()
+            throw e
+        }
+    }
+
+    /**
+     * Call numpy function [nameMethod] in a worker.
+     *
+     * Arguments may be numbers, strings, booleans, null, primitive arrays, lists, maps,
+     * element classes as dtypes, [SharedHandle] and [KtNDArray], the latter are copied into temporary shared memory.
+     *
+     * @return result of the function: array results are returned as [SharedHandle] owned by the worker,
+     * numbers as [Long] or [Double], sequences as [List].
+     * @throws NumKtException if the call fails in the worker.
+     */
+    fun call(
+        nameMethod: Array<String>,
+        args: Array<out Any?> = emptyArray(),
+        kwargs: Map<String, Any?> = emptyMap()
+    ): Any? {
+        val handles = ArrayList<SharedHandle>()
+        val temporary = ArrayList<SharedHandle>()
+        try {
+            val request = StringBuilder("{\"op\":\"call\",\"func\":")
+            encode(nameMethod, request, handles, temporary)
+            request.append(",\"args\":")
+            encode(args, request, handles, temporary)
+            request.append(",\"kwargs\":")
+            encode(kwargs, request, handles, temporary)
+            request.append('}')
+
+            val worker = route(handles)
+            val result = worker.request(request.toString())
+            handles.forEach { it.residents.add(worker.index) }
+            return decode(result, worker.index)
+        } finally {
+            temporary.forEach { it.close() }
+        }
+    }
+
+    /**
+     * Call numpy function returning an array.
+     *
+     * @see call
+     */
+    fun callArray(
+        nameMethod: Array<String>,
+        args: Array<out Any?> = emptyArray(),
+        kwargs: Map<String, Any?> = emptyMap()
+    ): SharedHandle =
+        call(nameMethod, args, kwargs) as? SharedHandle ?: throw NumKtException("Result of the call is not an array.")
+
+    /**
+     * Copy [array] into shared memory, so that it can be passed to workers by handle.
+     * Uses the embedded interpreter, the copies of the pool are made one at a time,
+     * but they must not overlap numpy calls made elsewhere in the program.
+     */
+    fun put(array: KtNDArray<*>): SharedHandle = synchronized(interpreterLock) {
+        val name = shmPrefix + counter.getAndIncrement()
+        val shape = array.shape
+        @Suppress("UNCHECKED_CAST")
+        val shared = sharedArray(name, shape, array.dtype as Class<Any>)
+        callFunc(nameMethod = arrayOf("copyto"), args = arrayOf(shared, array), kClass = Unit::class)
+        SharedHandle(name, shape, this, JVM_OWNER)
+    }
+
+    internal fun free(handle: SharedHandle) {
+        for (index in handle.residents) {
+            if (index != handle.owner && workers[index].alive) {
+                workers[index].request("{\"op\":\"free\",\"name\":${quote(handle.name)}}")
+            }
+        }
+        // the segments of a stopped worker are unlinked by name
+        if (handle.owner == JVM_OWNER || !workers[handle.owner].alive) {
+            unlinkSharedArray(handle.name)
+        } else {
+            workers[handle.owner].request("{\"op\":\"free\",\"name\":${quote(handle.name)}}")
+        }
+    }
+
+    /**
+     * Stop the workers, arrays created by them are unlinked.
+     */
+    override fun close() {
+        workers.forEach { it.close() }
+        workers.clear()
+        dir.delete()
+    }
+
+    private fun route(handles: List<SharedHandle>): Worker {
+        if (handles.isNotEmpty()) {
+            val resident = IntArray(size)
+            handles.forEach { handle -> handle.residents.forEach { resident[it]++ } }
+            val best = resident.indices.filter { workers[it].alive }.maxByOrNull { resident[it] }
+            if (best != null && resident[best] > 0) {
+                return workers[best]
+            }
+        }
+        val start = next.getAndIncrement()
+        return (0 until size).map { workers[Math.floorMod(start + it, size)] }.filter { it.alive }
+            .minByOrNull { it.pending.get() } ?: throw NumKtException("No worker of the pool is running.")
+    }
+
+    private fun encode(
+        value: Any?,
+        out: StringBuilder,
+        handles: MutableList<SharedHandle>,
+        temporary: MutableList<SharedHandle>
+    ) {
+        when (value) {
+            null -> out.append("null")
+            is SharedHandle -> {
+                handles.add(value)
+                out.append("{\"\$shm\":").append(quote(value.name)).append('}')
+            }
+            is KtNDArray<*> -> put(value).also { temporary.add(it) }.let { encode(it, out, handles, temporary) }
+            is String -> out.append(quote(value))
+            is Char -> out.append(quote(value.toString()))
+            is Boolean, is Int, is Long, is Short, is Byte -> out.append(value)
+            is Double -> out.append(encodeDouble(value))
+            is Float -> out.append(encodeDouble(value.toDouble()))
+            is Class<*> -> out.append("{\"\$dtype\":").append(quote(dtypeName(value))).append('}')
+            is IntArray -> value.joinTo(out, ",", "[", "]")
+            is LongArray -> value.joinTo(out, ",", "[", "]")
+            is ShortArray -> value.joinTo(out, ",", "[", "]")
+            is ByteArray -> value.joinTo(out, ",", "[", "]")
+            is BooleanArray -> value.joinTo(out, ",", "[", "]")
+            is DoubleArray -> value.joinTo(out, ",", "[", "]") { encodeDouble(it) }
+            is FloatArray -> value.joinTo(out, ",", "[", "]") { encodeDouble(it.toDouble()) }
+            is Array<*> -> encodeList(value.asIterable(), out, handles, temporary)
+            is Iterable<*> -> encodeList(value, out, handles, temporary)
+            is Map<*, *> -> {
+                out.append('{')
+                value.entries.forEachIndexed { i, (k, v) ->
+                    if (i > 0) out.append(',')
+                    out.append(quote(k.toString())).append(':')
+                    encode(v, out, handles, temporary)
+                }
+                out.append('}')
+            }
+            else -> throw NumKtException("Unsupported argument type for a worker: ${value::class.java.name}.")
+        }
+    }
+
+    private fun encodeList(
+        value: Iterable<*>,
+        out: StringBuilder,
+        handles: MutableList<SharedHandle>,
+        temporary: MutableList<SharedHandle>
+    ) {
+        out.append('[')
+        value.forEachIndexed { i, v ->
+            if (i > 0) out.append(',')
+            encode(v, out, handles, temporary)
+        }
+        out.append(']')
+    }
+
+    private fun decode(response: String, worker: Int): Any? {
+        val message = JsonReader(response).read() as Map<*, *>
+        message["error"]?.let { throw NumKtException(it as String) }
+        return toHandles(message["ok"], worker)
+    }
+
+    private fun toHandles(value: Any?, worker: Int): Any? = when (value) {
+        is Map<*, *> -> if (value.containsKey("\$shm")) {
+            val shape = (value["shape"] as List<*>).map { (it as Long).toInt() }.toIntArray()
+            SharedHandle(value["\$shm"] as String, shape, this, worker)
+        } else {
+            value.mapValues { toHandles(it.value, worker) }
+        }
+        is List<*> -> value.map { toHandles(it, worker) }
+        else -> value
+    }
+
+    private class Worker(val index: Int, python: String, script: File, socket: File) {
+        val pending = AtomicInteger()
+        private val process: Process = ProcessBuilder(python, script.absolutePath, socket.absolutePath)
+            .redirectError(ProcessBuilder.Redirect.INHERIT)
+            .start()
+        @Volatile
+        private var fd: Int = -1
+        private var failed = false
+
+        val alive: Boolean
+            get() = fd >= 0
+
+        init {
+            val ready = process.inputStream.bufferedReader().readLine()
+            if (ready != "ready") {
+                process.destroy()
+                throw NumKtException("Worker process failed to start.")
+            }
+            fd = try {
+                WorkerSocket.connect(socket.absolutePath)
+            } catch (e: Throwable) {
+                process.destroyForcibly()
+                throw e
+            }
+        }
+
+        fun request(message: String): String {
+            pending.incrementAndGet()
+            try {
+                synchronized(this) {
+                    if (fd < 0) {
+                        throw NumKtException(if (failed) "Worker $index has failed." else "WorkerPool is closed.")
+                    }
+                    try {
+                        WorkerSocket.send(fd, message.toByteArray(Charsets.UTF_8))
+                        return String(WorkerSocket.receive(fd), Charsets.UTF_8)
+                    } catch (e: Throwable) {
+                        // a frame may be half sent or read, the connection cannot be used again
+                        failed = true
+                        WorkerSocket.close(fd)
+                        fd = -1
+                        process.destroyForcibly()
+                        throw e
+                    }
+                }
+            } finally {
+                pending.decrementAndGet()
+            }
+        }
+
+        fun close() {
+            synchronized(this) {
+                if (fd >= 0) {
+                    try {
+                        WorkerSocket.send(fd, "{\"op\":\"exit\"}".toByteArray(Charsets.UTF_8))
+                    } catch (ignore: NumKtException) {
+                    }
+                    WorkerSocket.close(fd)
+                    fd = -1
+                }
+            }
+            if (!process.waitFor(5, TimeUnit.SECONDS)) {
+                process.destroy()
+            }
+        }
+    }
+
+    private companion object {
+        const val JVM_OWNER = -1
+        // the copies into shared memory of all pools
+        val interpreterLock = Any()
+        val counter = AtomicInteger()
+        val shmPrefix = "/ktnumpy_j${ManagementFactory.getRuntimeMXBean().name.substringBefore('@')}_"
+
+        fun quote(s: String): String = buildString {
+            append('"')
+            for (c in s) {
+                when {
+                    c == '"' -> append("\\\"")
+                    c == '\\' -> append("\\\\")
+                    c < ' ' -> append("\\u%04x".format(c.toInt()))
+                    else -> append(c)
+                }
+            }
+            append('"')
+        }
+
+        fun encodeDouble(d: Double): String = when {
+            d.isNaN() -> "NaN"
+            d == Double.POSITIVE_INFINITY -> "Infinity"
+            d == Double.NEGATIVE_INFINITY -> "-Infinity"
+            else -> d.toString()
+        }
+
+        fun dtypeName(jClass: Class<*>): String = when (jClass) {
+            java.lang.Double::class.java, Double::class.java -> "float64"
+            java.lang.Float::class.java, Float::class.java -> "float32"
+            java.lang.Long::class.java, Long::class.java -> "int64"
+            java.lang.Integer::class.java, Int::class.java -> "int32"
+            java.lang.Short::class.java, Short::class.java -> "int16"
+            java.lang.Byte::class.java, Byte::class.java -> "int8"
+            java.lang.Boolean::class.java, Boolean::class.java -> "bool"
+            else -> throw NumKtException("Unsupported dtype for a worker: ${jClass.name}.")
+        }
+    }
+}
+
+/**
+ * Handle of an array in POSIX shared memory, passed to and returned from [WorkerPool] calls.
+ *
+ * @property name name of the shared memory segment.
+ * @property shape shape of the array.
+ */
+class SharedHandle internal constructor(
+    val name: String,
+    val shape: IntArray,
+    private val pool: WorkerPool,
+    internal val owner: Int
+) : AutoCloseable {
+
+    // workers that have the segment attached
+    internal val residents: MutableSet<Int> = ConcurrentHashMap.newKeySet<Int>().apply { if (owner >= 0) add(owner) }
+
+    private val closed = AtomicBoolean()
+
+    /**
+     * Attach the array to the embedded interpreter without copying.
+     *
+     * @see attachSharedArray
+     */
+    fun <T : Any> fetch(mmapMode: MmapMode = MmapMode.READ): KtNDArray<T> = attachSharedArray(name, mmapMode)
+
+    /**
+     * Free the segment in the workers, arrays already fetched stay valid.
+     */
+    override fun close() {
+        if (closed.compareAndSet(false, true)) {
+            pool.free(this)
+        }
+    }
+
+    override fun toString(): String = "SharedHandle($name, shape=${shape.contentToString()})"
+}
+
+internal object WorkerSocket {
+    init {
+        Interpreter.interpreter
+    }
+
+    @JvmStatic
+    external fun connect(path: String): Int
+
+    @JvmStatic
+    external fun send(fd: Int, message: ByteArray)
+
+    @JvmStatic
+    external fun receive(fd: Int): ByteArray
+
+    @JvmStatic
+    external fun close(fd: Int)
+}
+
+/**
+ * Minimal reader of the JSON produced by the worker, including `NaN` and `Infinity`.
+ */
+private class JsonReader(private val s: String) {
+    private var i = 0
+
+    fun read(): Any? {
+        skipSpaces()
+        return when (s[i]) {
+            '{' -> readObject()
+            '[' -> readArray()
+            '"' -> readString()
+            't' -> literal("true", true)
+            'f' -> literal("false", false)
+            'n' -> literal("null", null)
+            'N' -> literal("NaN", Double.NaN)
+            'I' -> literal("Infinity", Double.POSITIVE_INFINITY)
+            else -> if (s.startsWith("-Infinity", i)) literal("-Infinity", Double.NEGATIVE_INFINITY) else readNumber()
+        }
+    }
+
+    private fun readObject(): Map<String, Any?> {
+        val result = LinkedHashMap<String, Any?>()
+        ++i
+        skipSpaces()
+        if (s[i] == '}') {
+            ++i
+            return result
+        }
+        while (true) {
+            skipSpaces()
+            val key = readString()
+            skipSpaces()
+            expect(':')
+            result[key] = read()
+            skipSpaces()
+            if (s[i++] == '}') return result
+        }
+    }
+
+    private fun readArray(): List<Any?> {
+        val result = ArrayList<Any?>()
+        ++i
+        skipSpaces()
+        if (s[i] == ']') {
+            ++i
+            return result
+        }
+        while (true) {
+            result.add(read())
+            skipSpaces()
+            if (s[i++] == ']') return result
+        }
+    }
+
+    private fun readString(): String {
+        expect('"')
+        val sb = StringBuilder()
+        while (s[i] != '"') {
+            val c = s[i++]
+            if (c != '\\') {
+                sb.append(c)
+                continue
+            }
+            when (val e = s[i++]) {
+                'b' -> sb.append('\b')
+                'f' -> sb.append('\u000c')
+                'n' -> sb.append('\n')
+                'r' -> sb.append('\r')
+                't' -> sb.append('\t')
+                'u' -> {
+                    sb.append(s.substring(i, i + 4).toInt(16).toChar())
+                    i += 4
+                }
+                else -> sb.append(e)
+            }
+        }
+        ++i
+        return sb.toString()
+    }
+
+    private fun readNumber(): Number {
+        val start = i
+        while (i < s.length && s[i] in "+-0123456789.eE") ++i
+        val token = s.substring(start, i)
+        return if (token.any { it == '.' || it == 'e' || it == 'E' }) token.toDouble() else token.toLong()
+    }
+
+    private fun literal(token: String, value: Any?): Any? {
+        if (!s.startsWith(token, i)) throw NumKtException("Malformed message from worker.")
+        i += token.length
+        return value
+    }
+
+    private fun expect(c: Char) {
+        if (s[i++] != c) throw NumKtException("Malformed message from worker.")
+    }
+
+    private fun skipSpaces() {
+        while (i < s.length && s[i].isWhitespace()) ++i
+    }
+}
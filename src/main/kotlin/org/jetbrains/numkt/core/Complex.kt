@@ -0,0 +1,37 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.core
+
+/**
+ * Element of `numpy.complex64` arrays.
+ *
+ * @property re real part.
+ * @property im imaginary part.
+ */
+data class ComplexFloat(val re: Float, val im: Float) {
+    override fun toString(): String = "($re${if (im < 0 || 1 / im < 0) "" else "+"}${im}j)"
+}
+
+/**
+ * Element of `numpy.complex128` arrays.
+ *
+ * @property re real part.
+ * @property im imaginary part.
+ */
+data class ComplexDouble(val re: Double, val im: Double) {
+    override fun toString(): String = "($re${if (im < 0 || 1 / im < 0) "" else "+"}${im}j)"
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.core
+
+/**
+ * Element of `numpy.float16` arrays, an IEEE 754 half-precision number stored in [bits].
+ * The arithmetic is left to numpy or to [Float] after [toFloat], conversions from [Float] round to nearest even.
+ *
+ * @property bits binary16 representation of the number.
+ */
+class Half(val bits: Short) : Number(), Comparable<Half> {
+
+    override fun toFloat(): Float = halfToFloat(bits)
+
+    override fun toDouble(): Double = toFloat().toDouble()
+
+    override fun toLong(): Long = toFloat().toLong()
+
+    override fun toInt(): Int = toFloat().toInt()
+
+    override fun toShort(): Short = toInt().toShort()
+
+    override fun toByte(): Byte = toInt().toByte()
+
+    override fun toChar(): Char = toInt().toChar()
+
+    override fun compareTo(other: Half): Int = toFloat().compareTo(other.toFloat())
+
+    override fun equals(other: Any?): Boolean = other is Half && other.bits == bits
+
+    override fun hashCode(): Int = bits.toInt()
+
+    override fun toString(): String = toFloat().toString()
+
+    companion object {
+        val MAX_VALUE = Half(0x7bff)
+        val MIN_VALUE = Half(0x0001)
+        val POSITIVE_INFINITY = Half(0x7c00)
+        val NEGATIVE_INFINITY = Half(0xfc00.toShort())
+        val NaN = Half(0x7e00)
+
+        internal fun halfToFloat(half: Short): Float {
+            val h = half.toInt() and 0xffff
+            val sign = (h and 0x8000) shl 16
+            var exponent = (h shr 10) and 0x1f
+            var mantissa = h and 0x3ff
+            val bits = when {
+                exponent == 0 && mantissa == 0 -> sign
+                exponent == 0 -> {
+                    // subnormal, normalized for the wider exponent
+                    exponent = 113
+                    while ((mantissa and 0x400) == 0) {
+                        mantissa = mantissa shl 1
+                        exponent--
+                    }
+                    sign or (exponent shl 23) or ((mantissa and 0x3ff) shl 13)
+                }
+                exponent == 0x1f -> sign or 0x7f800000 or (mantissa shl 13)
+                else -> sign or ((exponent + 112) shl 23) or (mantissa shl 13)
+            }
+            return java.lang.Float.intBitsToFloat(bits)
+        }
+
+        internal fun floatToHalf(value: Float): Short {
+            var x = java.lang.Float.floatToRawIntBits(value)
+            val sign = (x ushr 16) and 0x8000
+            x = x and 0x7fffffff
+            if (x > 0x7f800000) {
+                // NaN keeps the top of its payload and stays a NaN
+                val h = 0x7c00 or ((x and 0x7fffff) ushr 13)
+                return (sign or (if (h == 0x7c00) h + 1 else h)).toShort()
+            }
+            if (x >= 0x47800000) return (sign or 0x7c00).toShort()
+            if (x < 0x33000000) return sign.toShort()
+
+            val h: Int
+            val rest: Int
+            val halfway: Int
+            if (x < 0x38800000) {
+                val shift = 126 - (x ushr 23)
+                val significand = (x and 0x7fffff) or 0x800000
+                h = significand ushr shift
+                rest = significand and ((1 shl shift) - 1)
+                halfway = 1 shl (shift - 1)
+            } else {
+                h = (x - 0x38000000) ushr 13
+                rest = x and 0x1fff
+                halfway = 0x1000
+            }
+            // ties to even, a carry out of the mantissa rounds up to the next exponent or to infinity
+            val rounded = if (rest > halfway || (rest == halfway && (h and 1) == 1)) h + 1 else h
+            return (sign or rounded).toShort()
+        }
+    }
+}
+
+/**
+ * Nearest [Half] to this number.
+ */
+fun Float.toHalf(): Half = Half(Half.floatToHalf(this))
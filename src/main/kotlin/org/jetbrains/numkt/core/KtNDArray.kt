@@ -17,6 +17,7 @@
 package org.jetbrains.numkt.core
 
 import org.jetbrains.numkt.Interpreter
+import org.jetbrains.numkt.Jfr
 import org.jetbrains.numkt.NumKtException
 import org.jetbrains.numkt.callFunc
 import org.jetbrains.numkt.logic.arrayEqual
@@ -33,7 +34,8 @@ annotation class ExperimentalNumkt
  * above the memory allocated by numpy for the array.
  *
  * @property base Base object. Currently a stub.
- * @property data [ByteBuffer] of array's data.
+ * @property data [ByteBuffer] of array's data, null for scalars and for arrays of more than 2^31 - 1 bytes,
+ * whose elements are accessed by index, e.g. `a[i.toLong()]`.
  * @property dtype Type of array's elements.
  * @property itemsize Length of one array element in bytes.
  * @property ndim Number of array dimensions.
@@ -43,7 +45,7 @@ annotation class ExperimentalNumkt
  * @property strides [IntArray] of bytes to step in each dimension when traversing an array.
  * @property t The transposed array
  */
-class KtNDArray<T : Any> private constructor(
+class KtNDArray<T : Any> internal constructor(
     private val pointer: Long,
     dataBuffer: ByteBuffer?,
     scalar: T?,
@@ -54,22 +56,28 @@ class KtNDArray<T : Any> private constructor(
 
     val data: ByteBuffer? = dataBuffer?.order(ByteOrder.nativeOrder())
 
+    // data of the arrays which are read on the JVM.
+    internal val buffer: ByteBuffer
+        get() = data ?: throw NumKtException(
+            if (isScalar()) "KtNDArray is scalar." else "KtNDArray of more than 2^31 - 1 bytes has no buffer."
+        )
+
     // IntArray of array dimensions.
     val shape: IntArray
         get() = interp.getField("shape", getPointer(), IntArray::class.java)
 
     // Number of array dimensions.
     val ndim: Int
-        get() = interp.getField("ndim", getPointer(), Int::class.javaObjectType)
+        get() = ndimGetCritical(getPointer())
 
     // Length of one array element in bytes.
     val itemsize: Int by lazy {
-        interp.getField("itemsize", getPointer(), Int::class.javaObjectType)
+        itemsizeGetCritical(getPointer())
     }
 
     // Number of elements in the array.
     val size: Int by lazy {
-        interp.getField("size", getPointer(), Int::class.javaObjectType)
+        sizeGetCritical(getPointer()).toInt()
     }
 
     // strides - array int of bytes to step in each dimension when traversing an array.
@@ -86,6 +94,15 @@ class KtNDArray<T : Any> private constructor(
         this.transpose()
     }
 
+    // Kind of the elements for the small-array tier followed by the shape, see SmallArrays.
+    internal val layout: IntArray by lazy {
+        interp.getField("layout", getPointer(), IntArray::class.java)
+    }
+
+    // Offset in bytes of the first element in data, which is the buffer of the base array for views.
+    internal val offset: Int
+        get() = p.toInt()
+
     // base object, if memory is from some other object (e.g view)
     var base: KtNDArray<*>? = null
         private set
@@ -93,6 +110,10 @@ class KtNDArray<T : Any> private constructor(
     var scalar: T? = scalar
         private set
 
+    // Address of the numpy array, for the foreign function backend, see ForeignBridge.
+    internal val address: Long
+        get() = getPointer()
+
     private fun getPointer(): Long = if (isNotScalar()) pointer else throw NumKtException("KtNDArray is scalar.")
 
     fun isScalar(): Boolean = !isNotScalar()
@@ -151,7 +172,7 @@ class KtNDArray<T : Any> private constructor(
      */
     fun flatIter(): Iterator<T> {
         return FlatIterator(
-            this.data ?: throw NumKtException("KtNDArray is scalar."),
+            this.buffer,
             this.ndim,
             this.strides,
             this.itemsize,
@@ -227,8 +248,24 @@ class KtNDArray<T : Any> private constructor(
      * If the counter is zero, python will free up memory.
      */
     protected fun finalize() {
-        if (isNotScalar())
-            interp.freeArray(pointer, data!!)
+        if (isNotScalar()) {
+            interp.freeArray(pointer, data)
+            NumKtException.releaseCollected()
+            Jfr.flush()
+        }
+    }
+
+    // Receiver of factory extensions, e.g. KtNDArray.fromArrowVector.
+    companion object {
+        // java critical, metadata read from the numpy array without the interpreter
+        @JvmStatic
+        private external fun ndimGetCritical(ptr: Long): Int
+
+        @JvmStatic
+        private external fun itemsizeGetCritical(ptr: Long): Int
+
+        @JvmStatic
+        private external fun sizeGetCritical(ptr: Long): Long
     }
 }
 
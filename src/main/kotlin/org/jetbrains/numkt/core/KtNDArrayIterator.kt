@@ -121,6 +121,50 @@ internal class FlatIterator<T : Any>(
                     }
                     data.asIntBuffer()[p].toChar()
                 }
+                UByte::class.javaObjectType -> {
+                    for (i in 0 until ndim) {
+                        p += (strides[i] / itemsize) * index[i]
+                    }
+                    data[p].toUByte()
+                }
+                UShort::class.javaObjectType -> {
+                    for (i in 0 until ndim) {
+                        p += (strides[i] / itemsize) * index[i]
+                    }
+                    data.asShortBuffer()[p].toUShort()
+                }
+                UInt::class.javaObjectType -> {
+                    for (i in 0 until ndim) {
+                        p += (strides[i] / itemsize) * index[i]
+                    }
+                    data.asIntBuffer()[p].toUInt()
+                }
+                ULong::class.javaObjectType -> {
+                    for (i in 0 until ndim) {
+                        p += (strides[i] / itemsize) * index[i]
+                    }
+                    data.asLongBuffer()[p].toULong()
+                }
+                Half::class.java -> {
+                    for (i in 0 until ndim) {
+                        p += (strides[i] / itemsize) * index[i]
+                    }
+                    Half(data.asShortBuffer()[p])
+                }
+                ComplexFloat::class.java -> {
+                    for (i in 0 until ndim) {
+                        p += (strides[i] / itemsize) * index[i]
+                    }
+                    val parts = data.asFloatBuffer()
+                    ComplexFloat(parts[2 * p], parts[2 * p + 1])
+                }
+                ComplexDouble::class.java -> {
+                    for (i in 0 until ndim) {
+                        p += (strides[i] / itemsize) * index[i]
+                    }
+                    val parts = data.asDoubleBuffer()
+                    ComplexDouble(parts[2 * p], parts[2 * p + 1])
+                }
                 else -> throw NumKtException("Error to iterating: unknown type")
             }
         for (i in ndim - 1 downTo 0) {
@@ -65,15 +65,19 @@ class KtNDIter<T : Any> constructor(
         private set
 
     var index: Int
-        get() = indexGet(pointer)
+        get() = indexGetCritical(pointer).also {
+            if (it < 0) {
+                throw NumKtException(if (finished) "Iterator is past the end" else "Iterator does not have an index")
+            }
+        }
         set(value) = indexSet(pointer, value)
 
     var iterIndex: Int
-        get() = iterIndexGet(pointer)
+        get() = iterIndexGetCritical(pointer).also { if (it < 0) throw NumKtException("Iterator is past the end") }
         set(value) = iterIndexSet(pointer, value)
 
     val iterSize: Int
-        get() = iterSizeGet(pointer)
+        get() = iterSizeGetCritical(pointer).also { if (it < 0) throw NumKtException("Iterator is invalid") }
 
     var multiIndex: IntArray
         get() = multiIndexGet(pointer)
@@ -84,7 +88,7 @@ class KtNDIter<T : Any> constructor(
         set(value) = iterRangeSet(pointer, value)
 
     val ndim: Int
-        get() = ndimGet(pointer)
+        get() = ndimGetCritical(pointer).also { if (it < 0) throw NumKtException("Iterator is invalid") }
 
     val shape: IntArray
         get() = shapeGet(pointer)
@@ -94,27 +98,36 @@ class KtNDIter<T : Any> constructor(
 
     val operand: KtNDArray<T> = op
     
-    // java critical
+    // java critical, the natives cannot throw and return -1 for an invalid or finished iterator
     companion object {
         @JvmStatic
         private external fun finishedGetCritical(ptr: Long): Boolean
 
         @JvmStatic
         private external fun iterDebugPrintCritical(ptr: Long): Boolean
+
+        @JvmStatic
+        private external fun iterNextCritical(ptr: Long): Boolean
+
+        @JvmStatic
+        private external fun indexGetCritical(ptr: Long): Int
+
+        @JvmStatic
+        private external fun iterIndexGetCritical(ptr: Long): Int
+
+        @JvmStatic
+        private external fun iterSizeGetCritical(ptr: Long): Int
+
+        @JvmStatic
+        private external fun ndimGetCritical(ptr: Long): Int
     }
 
     private external fun iterNew(op: KtNDArray<T>, flags: Array<String>, casting: String): Long
 
-    private external fun indexGet(ptr: Long): Int
-
     private external fun indexSet(ptr: Long, value: Int)
 
-    private external fun iterIndexGet(ptr: Long): Int
-
     private external fun iterIndexSet(ptr: Long, value: Int)
 
-    private external fun iterSizeGet(ptr: Long): Int
-
     private external fun multiIndexGet(ptr: Long): IntArray
 
     private external fun multiIndexSet(ptr: Long, value: IntArray)
@@ -123,8 +136,6 @@ class KtNDIter<T : Any> constructor(
 
     private external fun iterRangeSet(ptr: Long, value: Pair<Int, Int>)
 
-    private external fun ndimGet(ptr: Long): Int
-
     private external fun shapeGet(ptr: Long): IntArray
 
     private external fun valueGet(ptr: Long): T
@@ -141,8 +152,7 @@ class KtNDIter<T : Any> constructor(
 
     fun debugPrint(): Boolean = iterDebugPrintCritical(pointer)
 
-    fun iterNext() = iterNextC(pointer)
-    private external fun iterNextC(ptr: Long): Boolean
+    fun iterNext() = iterNextCritical(pointer)
 
     fun removeAxis(axis: Int): Boolean = iterRemoveAxis(pointer, axis)
     private external fun iterRemoveAxis(ptr: Long, axis: Int): Boolean
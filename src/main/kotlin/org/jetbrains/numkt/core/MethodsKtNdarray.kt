@@ -26,7 +26,7 @@ private const val NDARRAY_STR = "ndarray"
  * @return [Boolean] value.
  */
 fun <T : Any> KtNDArray<T>.all(): Boolean =
-    callFunc(nameMethod = arrayOf(NDARRAY_STR, "all"), args = arrayOf(this), kClass = Boolean::class)
+    callBoolean(nameMethod = arrayOf(NDARRAY_STR, "all"), args = arrayOf(this))
 
 /**
  * @param axis: [Int] or [IntArray]- axis along which a logical AND reduction is performed.
@@ -53,7 +53,7 @@ inline fun <T : Any> KtNDArray<T>.all(predicate: (T) -> Boolean): Boolean {
  * @return [Boolean] value.
  */
 fun <T : Any> KtNDArray<T>.any(): Boolean =
-    callFunc(nameMethod = arrayOf(NDARRAY_STR, "any"), args = arrayOf(this), kClass = Boolean::class)
+    callBoolean(nameMethod = arrayOf(NDARRAY_STR, "any"), args = arrayOf(this))
 
 /**
  * @param axis: default none, [Int] or [IntArray] - Axis along which a logical OR reduction is performed.
@@ -77,7 +77,7 @@ inline fun <T : Any> KtNDArray<T>.any(predicate: (T) -> Boolean): Boolean {
  * @return [Long] value.
  */
 fun <T : Number> KtNDArray<T>.argMax(): Long =
-    callFunc(nameMethod = arrayOf(NDARRAY_STR, "argmax"), args = arrayOf(this), kClass = Long::class)
+    callLong(nameMethod = arrayOf(NDARRAY_STR, "argmax"), args = arrayOf(this))
 
 /**
  * @param axis index is into the specified axis. By default, the index is into the flattened array.
@@ -94,7 +94,7 @@ fun <T : Number> KtNDArray<T>.argMax(axis: Int): KtNDArray<Long> =
  * @return [Long] value.
  */
 fun <T : Number> KtNDArray<T>.argMin(): Long =
-    callFunc(nameMethod = arrayOf(NDARRAY_STR, "argmin"), args = arrayOf(this), kClass = Long::class)
+    callLong(nameMethod = arrayOf(NDARRAY_STR, "argmin"), args = arrayOf(this))
 
 /**
  * @param axis By default, axis is none, the index is nto the flattened array,
@@ -546,10 +546,10 @@ fun <T : Number> KtNDArray<T>.round(decimals: Int = 0): KtNDArray<T> =
  * Find indices where elements of v should be inserted in a to maintain order.
  */
 fun <T : Any> KtNDArray<T>.searchSorted(v: Int, side: String = "left"): Long =
-    callFunc(nameMethod = arrayOf(NDARRAY_STR, "searchsorted"), args = arrayOf(this, v, side), kClass = Long::class)
+    callLong(nameMethod = arrayOf(NDARRAY_STR, "searchsorted"), args = arrayOf(this, v, side))
 
 fun <T : Any> KtNDArray<T>.searchSorted(v: Long, side: String = "left"): Long =
-    callFunc(nameMethod = arrayOf(NDARRAY_STR, "searchsorted"), args = arrayOf(this, v, side), kClass = Long::class)
+    callLong(nameMethod = arrayOf(NDARRAY_STR, "searchsorted"), args = arrayOf(this, v, side))
 
 fun <T : Any> KtNDArray<T>.searchSorted(v: KtNDArray<Long>, side: String = "left"): KtNDArray<Long> =
     callFunc(nameMethod = arrayOf(NDARRAY_STR, "searchsorted"), args = arrayOf(this, v, side))
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.fft
+
+import org.jetbrains.numkt.callFunc
+import org.jetbrains.numkt.copyto
+import org.jetbrains.numkt.core.ComplexDouble
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.core.None
+
+private const val FFT_STR = "fft"
+
+/**
+ * Normalization of the transforms.
+ */
+enum class Norm(val str: String) {
+    /** no scaling of the forward transforms, 1/n of the inverse ones. */
+    BACKWARD("backward"),
+    /** 1/sqrt(n) both ways. */
+    ORTHO("ortho"),
+    /** 1/n of the forward transforms, no scaling of the inverse ones. */
+    FORWARD("forward")
+}
+
+/**
+ * Discrete Fourier transforms of numpy.fft.
+ * One-dimensional transforms of power-of-two lengths are computed natively in double precision,
+ * batched over the other axes of the array, with the setup of each length cached, see [cachedPlans].
+ * The other lengths and the multidimensional transforms are left to numpy.
+ * With [out] the result is written to the given array, which is returned.
+ */
+class FFT {
+    companion object {
+        /**
+         * Compute the one-dimensional discrete Fourier Transform.
+         * @param a input array, can be complex.
+         * @param n length of the transformed axis of the output, the input is cropped or padded with zeros.
+         * By default the length of the input along [axis].
+         * @param axis axis over which to compute the FFT.
+         * @param norm normalization mode.
+         * @param out complex array of the shape of the result to write it to.
+         * @return The truncated or zero-padded input, transformed along [axis].
+         */
+        fun fft(
+            a: KtNDArray<*>, n: Int? = null, axis: Int = -1, norm: Norm = Norm.BACKWARD,
+            out: KtNDArray<ComplexDouble>? = null
+        ): KtNDArray<ComplexDouble> = transform(a, n ?: length(a, axis), axis, NativeFft.COMPLEX, norm, out, "fft")
+
+        /**
+         * Compute the one-dimensional inverse discrete Fourier Transform.
+         * @param a input array, can be complex.
+         * @param n length of the transformed axis of the output.
+         * @param axis axis over which to compute the inverse FFT.
+         * @param norm normalization mode.
+         * @param out complex array of the shape of the result to write it to.
+         * @return The truncated or zero-padded input, transformed along [axis].
+         */
+        fun ifft(
+            a: KtNDArray<*>, n: Int? = null, axis: Int = -1, norm: Norm = Norm.BACKWARD,
+            out: KtNDArray<ComplexDouble>? = null
+        ): KtNDArray<ComplexDouble> =
+            transform(a, n ?: length(a, axis), axis, NativeFft.COMPLEX_INVERSE, norm, out, "ifft")
+
+        /**
+         * Compute the one-dimensional discrete Fourier Transform for real input.
+         * @param a input array.
+         * @param n number of points along transformation axis in the input to use.
+         * @param axis axis over which to compute the FFT.
+         * @param norm normalization mode.
+         * @param out complex array of the shape of the result to write it to.
+         * @return The transformed input, the length of [axis] is n/2+1.
+         */
+        fun <T : Number> rfft(
+            a: KtNDArray<T>, n: Int? = null, axis: Int = -1, norm: Norm = Norm.BACKWARD,
+            out: KtNDArray<ComplexDouble>? = null
+        ): KtNDArray<ComplexDouble> = transform(a, n ?: length(a, axis), axis, NativeFft.REAL, norm, out, "rfft")
+
+        /**
+         * Compute the inverse of [rfft].
+         * @param a the input array.
+         * @param n length of the transformed axis of the output, by default 2(m-1) where m is the length of the input.
+         * @param axis axis over which to compute the inverse FFT.
+         * @param norm normalization mode.
+         * @param out double array of the shape of the result to write it to.
+         * @return The truncated or zero-padded input, transformed along [axis].
+         */
+        fun irfft(
+            a: KtNDArray<*>, n: Int? = null, axis: Int = -1, norm: Norm = Norm.BACKWARD,
+            out: KtNDArray<Double>? = null
+        ): KtNDArray<Double> =
+            transform(a, n ?: 2 * (length(a, axis) - 1), axis, NativeFft.REAL_INVERSE, norm, out, "irfft")
+
+        /**
+         * Compute the 2-dimensional discrete Fourier Transform.
+         * @param a input array, can be complex.
+         * @param s shape (length of each transformed axis) of the output.
+         * @param axes axes over which to compute the FFT.
+         * @param norm normalization mode.
+         * @param out complex array of the shape of the result to write it to.
+         * @return The truncated or zero-padded input, transformed along [axes].
+         */
+        fun fft2(
+            a: KtNDArray<*>, s: IntArray? = null, axes: IntArray = intArrayOf(-2, -1), norm: Norm = Norm.BACKWARD,
+            out: KtNDArray<ComplexDouble>? = null
+        ): KtNDArray<ComplexDouble> = numpy("fft2", a, s ?: None.none, axes, norm, out)
+
+        /**
+         * Compute the N-dimensional discrete Fourier Transform for real input.
+         * @param a input array.
+         * @param s shape (length along each transformed axis) to use from the input.
+         * @param axes axes over which to compute the FFT, by default the last len(s) axes, or all.
+         * @param norm normalization mode.
+         * @param out complex array of the shape of the result to write it to.
+         * @return The truncated or zero-padded input, transformed along [axes].
+         */
+        fun <T : Number> rfftn(
+            a: KtNDArray<T>, s: IntArray? = null, axes: IntArray? = null, norm: Norm = Norm.BACKWARD,
+            out: KtNDArray<ComplexDouble>? = null
+        ): KtNDArray<ComplexDouble> = numpy("rfftn", a, s ?: None.none, axes ?: None.none, norm, out)
+
+        /**
+         * Number of the cached plans of the native transforms.
+         */
+        val cachedPlans: Int
+            get() = NativeFft.cachedPlans()
+
+        /**
+         * Frees the cached plans of the native transforms.
+         */
+        fun clearPlans(): Unit = NativeFft.clearPlans()
+
+        private fun length(a: KtNDArray<*>, axis: Int): Int = a.shape.let { it[if (axis < 0) axis + it.size else axis] }
+
+        private fun <R : Any> transform(
+            a: KtNDArray<*>, n: Int, axis: Int, kind: Int, norm: Norm, out: KtNDArray<R>?, name: String
+        ): KtNDArray<R> = NativeFft.transform(a, n, axis, kind, norm, out) ?: numpy(name, a, n, axis, norm, out)
+
+        private fun <R : Any> numpy(name: String, a: KtNDArray<*>, n: Any, axis: Any, norm: Norm, out: KtNDArray<R>?): KtNDArray<R> {
+            // norm=None of numpy before 1.20 is "backward"
+            val result = callFunc<R>(
+                nameMethod = arrayOf(FFT_STR, name),
+                args = arrayOf(a, n, axis, if (norm == Norm.BACKWARD) None.none else norm.str)
+            )
+            if (out == null) return result
+            copyto(out, result)
+            return out
+        }
+    }
+}
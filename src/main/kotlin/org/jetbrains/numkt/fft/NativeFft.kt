@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.fft
+
+import org.jetbrains.numkt.Interpreter
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Native transforms of power-of-two lengths along an axis, with plans cached by length, real or complex input
+ * and direction. [transform] returns *null* when the transform is left to numpy: for other lengths,
+ * types which can not be cast to double safely and scalars.
+ */
+internal object NativeFft {
+    init {
+        Interpreter.interpreter
+    }
+
+    const val COMPLEX = 0
+    const val COMPLEX_INVERSE = 1
+    const val REAL = 2
+    const val REAL_INVERSE = 3
+
+    fun <R : Any> transform(a: KtNDArray<*>, n: Int, axis: Int, kind: Int, norm: Norm, out: KtNDArray<R>?): KtNDArray<R>? {
+        if (!a.isNotScalar() || (out != null && !out.isNotScalar())) return null
+        @Suppress("UNCHECKED_CAST")
+        return transform(a, n, axis, kind, norm.ordinal, out) as KtNDArray<R>?
+    }
+
+    @JvmStatic
+    private external fun transform(
+        a: KtNDArray<*>, n: Int, axis: Int, kind: Int, norm: Int, out: KtNDArray<*>?
+    ): KtNDArray<*>?
+
+    @JvmStatic
+    external fun cachedPlans(): Int
+
+    @JvmStatic
+    external fun clearPlans()
+}
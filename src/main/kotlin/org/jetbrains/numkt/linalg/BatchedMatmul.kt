@@ -0,0 +1,41 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.linalg
+
+import org.jetbrains.numkt.Interpreter
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Native products of stacks of small matrices, in parallel over the stack, see [Parallel.matmulBatchThreshold].
+ * [matmul] returns *null* when the product is left to numpy: for matrices larger than 64 rows or columns,
+ * types other than double and float, and with a single thread in the pool.
+ */
+internal object BatchedMatmul {
+    init {
+        Interpreter.interpreter
+    }
+
+    fun <T : Number> matmul(x1: KtNDArray<T>, x2: KtNDArray<T>): KtNDArray<T>? {
+        if (!x1.isNotScalar() || !x2.isNotScalar() || x1.ndim + x2.ndim < 5) return null
+        @Suppress("UNCHECKED_CAST")
+        return matmul(x1, x2, Parallel.matmulBatchThreshold) as KtNDArray<T>?
+    }
+
+    @JvmStatic
+    private external fun matmul(x1: KtNDArray<*>, x2: KtNDArray<*>, minBatch: Int): KtNDArray<*>?
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.linalg
+
+import org.jetbrains.numkt.Interpreter
+
+/**
+ * Threads of the BLAS library numpy is linked with, which runs [dot], [matmul], [inner], [outer] and [kron].
+ * OpenBLAS, MKL and BLIS are recognized, as in `threadpoolctl`.
+ *
+ * The number of threads is global to the process. When several JVM threads call BLAS at once,
+ * each of them starting the BLAS threads of its own oversubscribes the cores; one BLAS thread then does better.
+ */
+object Blas {
+    init {
+        Interpreter.interpreter
+    }
+
+    /**
+     * The BLAS library: `openblas`, `mkl` or `blis`, *null* if none with thread control is loaded.
+     */
+    val api: String?
+        get() = blasApi()
+
+    /**
+     * Path of the BLAS library, *null* if none with thread control is loaded.
+     */
+    val library: String?
+        get() = blasLibrary()
+
+    /**
+     * Number of threads of the BLAS library.
+     * @throws org.jetbrains.numkt.NumKtException if no BLAS with thread control is loaded.
+     */
+    var threads: Int
+        get() = getThreads()
+        set(value) {
+            require(value > 0) { "Number of threads must be positive, got $value" }
+            setThreads(value)
+        }
+
+    /**
+     * Runs [block] with the given number of BLAS [threads] and restores the previous number.
+     */
+    inline fun <R> withThreads(threads: Int, block: () -> R): R {
+        val old = this.threads
+        this.threads = threads
+        try {
+            return block()
+        } finally {
+            this.threads = old
+        }
+    }
+
+    @JvmStatic
+    private external fun blasApi(): String?
+
+    @JvmStatic
+    private external fun blasLibrary(): String?
+
+    @JvmStatic
+    private external fun getThreads(): Int
+
+    @JvmStatic
+    private external fun setThreads(threads: Int)
+}
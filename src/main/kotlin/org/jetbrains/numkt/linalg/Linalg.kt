@@ -18,6 +18,8 @@ package org.jetbrains.numkt.linalg
 
 import org.jetbrains.numkt.Casting
 import org.jetbrains.numkt.Order
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.SmallArrays
 import org.jetbrains.numkt.callFunc
 import org.jetbrains.numkt.core.KtNDArray
 import org.jetbrains.numkt.core.None
@@ -112,6 +114,20 @@ class Linalg {
                 kClass = Pair::class
             ) as Pair<KtNDArray<Double>, KtNDArray<Double>>
 
+        /**
+         * Return the eigenvalues and eigenvectors of a real symmetric matrix.
+         *
+         * @param a (..., M, M) real symmetric matrices.
+         * @param uplo whether the calculation is done with the lower ("L") or upper ("U") triangular part of [a].
+         * @return w: (..., M) eigenvalues in ascending order; v: (..., M, M) normalized eigenvectors in columns.
+         */
+        fun <T : Number> eigh(a: KtNDArray<T>, uplo: String = "L"): Pair<KtNDArray<Double>, KtNDArray<Double>> =
+            callFunc(
+                nameMethod = arrayOf(LINALG_STR, "eigh"),
+                args = arrayOf(a, uplo),
+                kClass = Pair::class
+            ) as Pair<KtNDArray<Double>, KtNDArray<Double>>
+
         /**
          * Compute the eigenvalues of a general matrix.
          * @param a real-valued matrix whose eigenvalues will be computed.
@@ -237,13 +253,14 @@ class Linalg {
  * Dot product of two arrays.
  */
 fun <T : Number> dot(a: KtNDArray<T>, b: KtNDArray<T>): KtNDArray<T> =
-    callFunc(nameMethod = arrayOf("dot"), args = arrayOf(a, b))
+    SmallArrays.dot(a, b) ?: callFunc(nameMethod = arrayOf("dot"), args = arrayOf(a, b))
 
 /**
  * 	Return the dot product of two vectors.
  */
 inline fun <reified T : Number> vdot(a: KtNDArray<T>, b: KtNDArray<T>): T =
-    callFunc(nameMethod = arrayOf("vdot"), args = arrayOf(a, b), kClass = T::class)
+    SmallArrays.vdot(a, b, T::class)
+        ?: callFunc(nameMethod = arrayOf("vdot"), args = arrayOf(a, b), kClass = T::class)
 
 /**
  * 	Inner product of two arrays.
@@ -259,9 +276,10 @@ fun <T : Number> outer(a: KtNDArray<T>, b: KtNDArray<T>): KtNDArray<T> =
 
 /**
  * Matrix product of two arrays.
+ * Stacks of small matrices are multiplied in parallel over the stack, see [Parallel.matmulBatchThreshold].
  */
 fun <T : Number> matmul(x1: KtNDArray<T>, x2: KtNDArray<T>): KtNDArray<T> =
-    callFunc(arrayOf("matmul"), args = arrayOf(x1, x2))
+    BatchedMatmul.matmul(x1, x2) ?: callFunc(arrayOf("matmul"), args = arrayOf(x1, x2))
 
 /**
  * Evaluates the Einstein summation convention on the operands.
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.linalg
+
+import org.jetbrains.numkt.Interpreter
+import org.jetbrains.numkt.copyto
+import org.jetbrains.numkt.core.KtNDArray
+
+/**
+ * Solver of linear systems of matrices of the order [n], for repeated solves of systems of one shape.
+ *
+ * LAPACK of the BLAS numpy is linked with is called directly: the factors, pivots and work arrays are
+ * allocated once by the workspace, and a result is written to [out] when it is given, otherwise to an array
+ * kept by the workspace for the results of the method. That array is returned again and overwritten
+ * by the next call of the method with the same shape of the result, copy the result to keep it.
+ *
+ * [solve] and [inv] also take stacks of matrices of the shape `(batch, n, n)`,
+ * which are solved in parallel over the stack on [org.jetbrains.numkt.Parallel.threads] threads.
+ * Without LAPACK, as with BLIS, the methods call numpy.linalg.
+ *
+ * A workspace is not meant to be shared between threads, the calls are applied one at a time.
+ * The native memory is kept until the workspace is [closed][close].
+ */
+class LinalgWorkspace(val n: Int) : AutoCloseable {
+
+    init {
+        require(n > 0) { "Order of matrices must be positive, got $n" }
+    }
+
+    private var pointer: Long = if (native) workspaceNew(n) else 0L
+
+    /**
+     * Solve a x = b.
+     * @param a (n, n) or (batch, n, n) coefficient matrices.
+     * @param b (n), (n, k), or (batch, n), (batch, n, k) for a stack.
+     * @param out array of doubles of the shape of [b] for the solution, can be [b] itself.
+     * @return solution to the system a x = b of the shape of [b].
+     */
+    fun <T : Number, E : Number> solve(
+        a: KtNDArray<T>,
+        b: KtNDArray<E>,
+        out: KtNDArray<Double>? = null
+    ): KtNDArray<Double> = synchronized(this) {
+        if (native) {
+            @Suppress("UNCHECKED_CAST")
+            workspaceSolve(ptr(), a, b, out) as KtNDArray<Double>
+        } else {
+            fallback(out, Linalg.solve(a, b))
+        }
+    }
+
+    /**
+     * Inverse of a matrix.
+     * @param a (n, n) or (batch, n, n) matrices to be inverted.
+     * @param out array of doubles of the shape of [a] for the inverse, can be [a] itself.
+     */
+    fun <T : Number> inv(a: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> = synchronized(this) {
+        if (native) {
+            @Suppress("UNCHECKED_CAST")
+            workspaceInv(ptr(), a, out) as KtNDArray<Double>
+        } else {
+            fallback(out, Linalg.inv(a))
+        }
+    }
+
+    /**
+     * Determinant of the (n, n) matrix [a].
+     */
+    fun <T : Number> det(a: KtNDArray<T>): Double = synchronized(this) {
+        if (native) workspaceDet(ptr(), a) else Linalg.det(a)
+    }
+
+    /**
+     * Cholesky decomposition of the (n, n) symmetric positive-definite matrix [a], only its lower triangle is used.
+     * @param out array of doubles of the shape of [a] for the factor, can be [a] itself.
+     * @return lower-triangular L, such that a = L L^T.
+     */
+    fun <T : Number> cholesky(a: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> = synchronized(this) {
+        if (native) {
+            @Suppress("UNCHECKED_CAST")
+            workspaceCholesky(ptr(), a, out) as KtNDArray<Double>
+        } else {
+            fallback(out, Linalg.cholesky(a))
+        }
+    }
+
+    /**
+     * Eigenvalues and eigenvectors of the (n, n) real symmetric matrix [a], only its lower triangle is used.
+     * @return w: (n) eigenvalues in ascending order; v: (n, n) normalized eigenvectors in columns.
+     */
+    @Suppress("UNCHECKED_CAST")
+    fun <T : Number> eigh(a: KtNDArray<T>): Pair<KtNDArray<Double>, KtNDArray<Double>> = synchronized(this) {
+        if (native) workspaceEigh(ptr(), a) as Pair<KtNDArray<Double>, KtNDArray<Double>> else Linalg.eigh(a)
+    }
+
+    private fun fallback(out: KtNDArray<Double>?, result: KtNDArray<Double>): KtNDArray<Double> {
+        if (out == null) return result
+        copyto(out, result)
+        return out
+    }
+
+    private fun ptr(): Long {
+        check(pointer != 0L) { "Workspace is closed" }
+        return pointer
+    }
+
+    override fun close() = synchronized(this) {
+        if (pointer != 0L) {
+            workspaceDealloc(pointer)
+            pointer = 0L
+        }
+    }
+
+    protected fun finalize() {
+        close()
+    }
+
+    private external fun workspaceSolve(ptr: Long, a: KtNDArray<*>, b: KtNDArray<*>, out: KtNDArray<*>?): KtNDArray<*>
+
+    private external fun workspaceInv(ptr: Long, a: KtNDArray<*>, out: KtNDArray<*>?): KtNDArray<*>
+
+    private external fun workspaceDet(ptr: Long, a: KtNDArray<*>): Double
+
+    private external fun workspaceCholesky(ptr: Long, a: KtNDArray<*>, out: KtNDArray<*>?): KtNDArray<*>
+
+    private external fun workspaceEigh(ptr: Long, a: KtNDArray<*>): Pair<*, *>
+
+    private external fun workspaceDealloc(ptr: Long)
+
+    companion object {
+        init {
+            Interpreter.interpreter
+        }
+
+        private val native: Boolean = lapackLoaded()
+
+        @JvmStatic
+        private external fun lapackLoaded(): Boolean
+
+        @JvmStatic
+        private external fun workspaceNew(n: Int): Long
+    }
+}
@@ -16,6 +16,7 @@
 
 package org.jetbrains.numkt.logic
 
+import org.jetbrains.numkt.callBoolean
 import org.jetbrains.numkt.callFunc
 import org.jetbrains.numkt.core.KtNDArray
 
@@ -23,7 +24,7 @@ import org.jetbrains.numkt.core.KtNDArray
  * Test whether all array elements along a given axis evaluate to *true*.
  */
 fun <T : Any> all(a: KtNDArray<T>): Boolean =
-    callFunc(arrayOf("all"), args = arrayOf(a), kClass = Boolean::class)
+    callBoolean(arrayOf("all"), args = arrayOf(a))
 
 /**
  *
@@ -35,7 +36,7 @@ fun <T : Any> all(a: KtNDArray<T>, axis: Int): KtNDArray<Boolean> =
  * Test whether any array element along a given axis evaluates to *true*.
  */
 fun <T : Any> any(a: KtNDArray<T>): Boolean =
-    callFunc(nameMethod = arrayOf("any"), args = arrayOf(a), kClass = Boolean::class)
+    callBoolean(nameMethod = arrayOf("any"), args = arrayOf(a))
 
 /**
  *
@@ -108,7 +109,7 @@ fun <T : Any, E : Any> allClose(
     atol: Double = 1e-08,
     equalNan: Boolean = false
 ): Boolean =
-    callFunc(nameMethod = arrayOf("allclose"), args = arrayOf(a, b, rtol, atol, equalNan), kClass = Boolean::class)
+    callBoolean(nameMethod = arrayOf("allclose"), args = arrayOf(a, b, rtol, atol, equalNan))
 
 /**
  * Returns a boolean array where two arrays are element-wise equal within a tolerance.
@@ -126,14 +127,14 @@ fun <T : Any, E : Any> isClose(
  * 	*true* if two arrays have the same shape and elements, *false* otherwise.
  */
 fun <T : Any, E : Any> arrayEqual(a1: KtNDArray<T>, a2: KtNDArray<E>): Boolean =
-    callFunc(nameMethod = arrayOf("array_equal"), args = arrayOf(a1, a2), kClass = Boolean::class)
+    callBoolean(nameMethod = arrayOf("array_equal"), args = arrayOf(a1, a2))
 
 
 /**
  * 	Returns *true* if input arrays are shape consistent and all elements equal.
  */
 fun <T : Any, E : Any> arrayEquiv(a1: KtNDArray<T>, a2: KtNDArray<E>): Boolean =
-    callFunc(nameMethod = arrayOf("array_equiv"), args = arrayOf(a1, a2), kClass = Boolean::class)
+    callBoolean(nameMethod = arrayOf("array_equiv"), args = arrayOf(a1, a2))
 
 /**
  * 	Return the truth value of (x1 > x2) element-wise.
@@ -16,6 +16,7 @@
 
 package org.jetbrains.numkt.math
 
+import org.jetbrains.numkt.SmallArrays
 import org.jetbrains.numkt.callFunc
 import org.jetbrains.numkt.core.KtNDArray
 import org.jetbrains.numkt.linalg.dot
@@ -29,7 +30,8 @@ private fun <T: KtNDArray<*>, S: Number> plusAssignScalar(array: T, scalar: S) {
 }
 
 private fun <T: Any, L: Any, R: Any> add(left: L, right: R): KtNDArray<T> =
-    callFunc(nameMethod = arrayOf("add"), args = arrayOf(left, right))
+    SmallArrays.binary(SmallArrays.ADD, left, right)
+        ?: callFunc(nameMethod = arrayOf("add"), args = arrayOf(left, right))
 
 // Byte
 /**
@@ -227,7 +229,8 @@ private fun <T: KtNDArray<*>, S: Number> minusAssignScalar(array: T, scalar: S)
 }
 
 private fun <T: Any, L: Any, R: Any> subtract(left: L, right: R): KtNDArray<T> =
-    callFunc(nameMethod = arrayOf("subtract"), args = arrayOf(left, right))
+    SmallArrays.binary(SmallArrays.SUBTRACT, left, right)
+        ?: callFunc(nameMethod = arrayOf("subtract"), args = arrayOf(left, right))
 
 
 // Byte
@@ -426,7 +429,8 @@ private fun <T: KtNDArray<*>, S: Number> timesAssignScalar(array: T, scalar: S)
 }
 
 private fun <T: Any, L: Any, R: Any> multiply(left: L, right: R): KtNDArray<T> =
-    callFunc(nameMethod = arrayOf("multiply"), args = arrayOf(left, right))
+    SmallArrays.binary(SmallArrays.MULTIPLY, left, right)
+        ?: callFunc(nameMethod = arrayOf("multiply"), args = arrayOf(left, right))
 
 
 // Byte
@@ -625,7 +629,8 @@ private fun <T: KtNDArray<*>, S: Number> divAssignScalar(array: T, scalar: S) {
 }
 
 private fun <T: Any, L: Any, R: Any> divide(left: L, right: R): KtNDArray<T> =
-    callFunc(nameMethod = arrayOf("divide"), args = arrayOf(left, right))
+    SmallArrays.binary(SmallArrays.DIVIDE, left, right)
+        ?: callFunc(nameMethod = arrayOf("divide"), args = arrayOf(left, right))
 
 /**
  * Divide. Returns [KtNDArray].
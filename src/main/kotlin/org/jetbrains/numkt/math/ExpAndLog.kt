@@ -16,53 +16,67 @@
 
 package org.jetbrains.numkt.math
 
-import org.jetbrains.numkt.callFunc
+import org.jetbrains.numkt.SmallArrays
+import org.jetbrains.numkt.Ufuncs
 import org.jetbrains.numkt.core.KtNDArray
 
 
 /**
  * Calculate the exponential of all elements in the input array.
  */
-fun <T : Number> exp(x: KtNDArray<T>): KtNDArray<Double> = callFunc(nameMethod = arrayOf("exp"), args = arrayOf(x))
+fun <T : Number> exp(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    (if (out == null) SmallArrays.exp(x) else null) ?: Ufuncs.call("exp", arrayOf(x), out, float64 = false)
 
 /**
  * Calculate exp(x) - 1 for all elements in the array.
  */
-fun <T : Number> expm1(x: KtNDArray<T>): KtNDArray<Double> = callFunc(nameMethod = arrayOf("expm1"), args = arrayOf(x))
+fun <T : Number> expm1(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("expm1", arrayOf(x), out, float64 = false)
 
 /**
  * 	Calculate 2**p for all p in the input array.
  */
-fun <T : Number> exp2(x: KtNDArray<T>): KtNDArray<Double> = callFunc(nameMethod = arrayOf("exp2"), args = arrayOf(x))
+fun <T : Number> exp2(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("exp2", arrayOf(x), out, float64 = false)
 
 /**
  * Natural logarithm, element-wise.
  */
-fun <T : Number> log(x: KtNDArray<T>): KtNDArray<Double> = callFunc(nameMethod = arrayOf("log"), args = arrayOf(x))
+fun <T : Number> log(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("log", arrayOf(x), out, float64 = false)
 
 /**
  * Return the base 10 logarithm of the input array, element-wise.
  */
-fun <T : Number> log10(x: KtNDArray<T>): KtNDArray<Double> = callFunc(nameMethod = arrayOf("log10"), args = arrayOf(x))
+fun <T : Number> log10(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("log10", arrayOf(x), out, float64 = false)
 
 /**
  * Base-2 logarithm of x.
  */
-fun <T : Number> log2(x: KtNDArray<T>): KtNDArray<Double> = callFunc(nameMethod = arrayOf("log2"), args = arrayOf(x))
+fun <T : Number> log2(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("log2", arrayOf(x), out, float64 = false)
 
 /**
  * Return the natural logarithm of one plus the input array, element-wise.
  */
-fun <T : Number> log1p(x: KtNDArray<T>): KtNDArray<Double> = callFunc(nameMethod = arrayOf("log1p"), args = arrayOf(x))
+fun <T : Number> log1p(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("log1p", arrayOf(x), out, float64 = false)
 
 /**
  * Logarithm of the sum of exponentiations of the inputs.
  */
-fun <T : Number, E : Number> logaddexp(x1: KtNDArray<T>, x2: KtNDArray<E>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("logaddexp"), args = arrayOf(x1, x2))
+fun <T : Number, E : Number> logaddexp(
+    x1: KtNDArray<T>,
+    x2: KtNDArray<E>,
+    out: KtNDArray<Double>? = null
+): KtNDArray<Double> = Ufuncs.call("logaddexp", arrayOf(x1, x2), out, float64 = false)
 
 /**
  * Logarithm of the sum of exponentiations of the inputs in base-2.
  */
-fun <T : Number, E : Number> logaddexp2(x1: KtNDArray<T>, x2: KtNDArray<E>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("logaddexp2"), args = arrayOf(x1, x2))
\ No newline at end of file
+fun <T : Number, E : Number> logaddexp2(
+    x1: KtNDArray<T>,
+    x2: KtNDArray<E>,
+    out: KtNDArray<Double>? = null
+): KtNDArray<Double> = Ufuncs.call("logaddexp2", arrayOf(x1, x2), out, float64 = false)
\ No newline at end of file
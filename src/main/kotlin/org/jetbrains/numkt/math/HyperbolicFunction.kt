@@ -16,41 +16,41 @@
 
 package org.jetbrains.numkt.math
 
-import org.jetbrains.numkt.callFunc
+import org.jetbrains.numkt.Ufuncs
 import org.jetbrains.numkt.core.KtNDArray
 
 /**
  * Hyperbolic sine, element-wise.
  */
-fun <T : Number> sinh(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("sinh"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> sinh(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("sinh", arrayOf(x), out, float64 = true)
 
 /**
  * Hyperbolic cosine, element-wise.
  */
-fun <T : Number> cosh(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("cosh"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> cosh(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("cosh", arrayOf(x), out, float64 = true)
 
 /**
  * Compute hyperbolic tangent element-wise.
  */
-fun <T : Number> tanh(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("tanh"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> tanh(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("tanh", arrayOf(x), out, float64 = true)
 
 /**
  * Inverse hyperbolic sine element-wise.
  */
-fun <T : Number> arcsinh(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("arcsinh"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> arcsinh(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("arcsinh", arrayOf(x), out, float64 = true)
 
 /**
  * Inverse hyperbolic cosine, element-wise.
  */
-fun <T : Number> arccosh(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("arccosh"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> arccosh(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("arccosh", arrayOf(x), out, float64 = true)
 
 /**
  * Inverse hyperbolic tangent element-wise.
  */
-fun <T : Number> arctanh(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("arctanh"), args = arrayOf(x), dtype = Double::class)
\ No newline at end of file
+fun <T : Number> arctanh(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("arctanh", arrayOf(x), out, float64 = true)
\ No newline at end of file
@@ -16,8 +16,11 @@
 
 package org.jetbrains.numkt.math
 
+import org.jetbrains.numkt.Reductions
 import org.jetbrains.numkt.append
+import org.jetbrains.numkt.callDouble
 import org.jetbrains.numkt.callFunc
+import org.jetbrains.numkt.callNumber
 import org.jetbrains.numkt.core.KtNDArray
 import org.jetbrains.numkt.core.None
 import org.jetbrains.numkt.emptyLike
@@ -26,7 +29,7 @@ import org.jetbrains.numkt.emptyLike
  * Return the product of array elements over a given axis.
  */
 inline fun <reified T : Number> prod(a: KtNDArray<T>): T =
-    callFunc(nameMethod = arrayOf("prod"), args = arrayOf(a, None.none, a.dtype), kClass = T::class)
+    callNumber(nameMethod = arrayOf("prod"), args = arrayOf(a, None.none, a.dtype))
 
 fun <T : Number> prod(a: KtNDArray<T>, axis: Int): KtNDArray<T> =
     callFunc(nameMethod = arrayOf("prod"), args = arrayOf(a, axis, a.dtype))
@@ -35,16 +38,18 @@ fun <T : Number> prod(a: KtNDArray<T>, axis: Int): KtNDArray<T> =
  * Sum of array elements over a given axis.
  */
 inline fun <reified T : Number> sum(a: KtNDArray<T>): T =
-    callFunc(nameMethod = arrayOf("sum"), args = arrayOf(a, None.none, a.dtype), kClass = T::class)
+    Reductions.all(a, Reductions.SUM, T::class)
+        ?: callNumber(nameMethod = arrayOf("sum"), args = arrayOf(a, None.none, a.dtype))
 
 fun <T : Number> sum(a: KtNDArray<T>, axis: Int): KtNDArray<T> =
-    callFunc(nameMethod = arrayOf("sum"), args = arrayOf(a, axis, a.dtype))
+    Reductions.axis(a, Reductions.SUM, axis)
+        ?: callFunc(nameMethod = arrayOf("sum"), args = arrayOf(a, axis, a.dtype))
 
 /**
  * Return the product of array elements over a given axis treating Not a Numbers (NaNs) as ones.
  */
 inline fun <reified T : Number> nanprod(a: KtNDArray<T>): T =
-    callFunc(nameMethod = arrayOf("nanprod"), args = arrayOf(a, a.dtype), kClass = T::class)
+    callNumber(nameMethod = arrayOf("nanprod"), args = arrayOf(a, None.none, a.dtype))
 
 fun <T : Number> nanprod(a: KtNDArray<T>, axis: Int): KtNDArray<T> =
     callFunc(nameMethod = arrayOf("nanprod"), args = arrayOf(a, axis, a.dtype))
@@ -53,7 +58,7 @@ fun <T : Number> nanprod(a: KtNDArray<T>, axis: Int): KtNDArray<T> =
  * 	Return the sum of array elements over a given axis treating Not a Numbers (NaNs) as zero.
  */
 inline fun <reified T : Number> nansum(a: KtNDArray<T>): T =
-    callFunc(nameMethod = arrayOf("nanprod"), args = arrayOf(a, a.dtype), kClass = T::class)
+    callNumber(nameMethod = arrayOf("nansum"), args = arrayOf(a, None.none, a.dtype))
 
 fun <T : Number> nansum(a: KtNDArray<T>, axis: Int): KtNDArray<T> =
     callFunc(nameMethod = arrayOf("nansum"), args = arrayOf(a, axis, a.dtype))
@@ -137,7 +142,7 @@ fun <T : Number> trapz(
     x: KtNDArray<out Number>? = null,
     dx: Double = 1.0
 ): Double =
-    callFunc(nameMethod = arrayOf("trapz"), args = arrayOf(y, x ?: None.none, dx), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("trapz"), args = arrayOf(y, x ?: None.none, dx))
 
 fun <T : Number> trapz(
     y: KtNDArray<T>,
@@ -16,6 +16,7 @@
 
 package org.jetbrains.numkt.math
 
+import org.jetbrains.numkt.Ufuncs
 import org.jetbrains.numkt.callFunc
 import org.jetbrains.numkt.core.KtNDArray
 import kotlin.math.PI
@@ -23,62 +24,68 @@ import kotlin.math.PI
 /**
  * Trigonometric sine, element-wise.
  */
-fun <T : Number> sin(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("sin"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> sin(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("sin", arrayOf(x), out, float64 = true)
 
 /**
  * Cosine element-wise.
  */
-fun <T : Number> cos(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("cos"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> cos(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("cos", arrayOf(x), out, float64 = true)
 
 /**
  * 	Compute tangent element-wise.
  */
-fun <T : Number> tan(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("tan"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> tan(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("tan", arrayOf(x), out, float64 = true)
 
 /**
  * Inverse sine, element-wise.
  */
-fun <T : Number> arcsin(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("arcsin"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> arcsin(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("arcsin", arrayOf(x), out, float64 = true)
 
 /**
  * Trigonometric inverse cosine, element-wise.
  */
-fun <T : Number> arccos(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("arccos"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> arccos(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("arccos", arrayOf(x), out, float64 = true)
 
 /**
  * Trigonometric inverse tangent, element-wise.
  */
-fun <T : Number> arctan(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("arctan"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> arctan(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("arctan", arrayOf(x), out, float64 = true)
 
 /**
  * Given the “legs” of a right triangle, return its hypotenuse.
  */
-fun <T : Number, E : Number> hypot(x1: KtNDArray<T>, x2: KtNDArray<E>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("hypot"), args = arrayOf(x1, x2), dtype = Double::class)
+fun <T : Number, E : Number> hypot(
+    x1: KtNDArray<T>,
+    x2: KtNDArray<E>,
+    out: KtNDArray<Double>? = null
+): KtNDArray<Double> = Ufuncs.call("hypot", arrayOf(x1, x2), out, float64 = true)
 
 /**
  * Element-wise arc tangent of x1/x2 choosing the quadrant correctly.
  */
-fun <T : Number, E : Number> arctan2(x1: KtNDArray<T>, x2: KtNDArray<E>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("arctan2"), args = arrayOf(x1, x2), dtype = Double::class)
+fun <T : Number, E : Number> arctan2(
+    x1: KtNDArray<T>,
+    x2: KtNDArray<E>,
+    out: KtNDArray<Double>? = null
+): KtNDArray<Double> = Ufuncs.call("arctan2", arrayOf(x1, x2), out, float64 = true)
 
 /**
  * Convert angles from radians to degrees.
  */
-fun <T : Number> degrees(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("degrees"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> degrees(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("degrees", arrayOf(x), out, float64 = true)
 
 /**
  * Convert angles from degrees to radians.
  */
-fun <T : Number> radians(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("radians"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> radians(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("radians", arrayOf(x), out, float64 = true)
 
 /**
  * Unwrap by changing deltas between values to 2*pi complement.
@@ -89,11 +96,11 @@ fun <T : Number> unwrap(p: KtNDArray<T>, discont: Double = PI, axis: Int = -1):
 /**
  * Convert angles from degrees to radians.
  */
-fun <T : Number> deg2rad(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("deg2rad"), args = arrayOf(x), dtype = Double::class)
+fun <T : Number> deg2rad(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("deg2rad", arrayOf(x), out, float64 = true)
 
 /**
  * Convert angles from radians to degrees.
  */
-fun <T : Number> rad2deg(x: KtNDArray<T>): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("rad2deg"), args = arrayOf(x), dtype = Double::class)
\ No newline at end of file
+fun <T : Number> rad2deg(x: KtNDArray<T>, out: KtNDArray<Double>? = null): KtNDArray<Double> =
+    Ufuncs.call("rad2deg", arrayOf(x), out, float64 = true)
\ No newline at end of file
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.neighbors
+
+import org.jetbrains.numkt.Interpreter
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.empty
+
+/**
+ * Distance between samples.
+ */
+enum class Metric(val str: String) {
+    /** L2 distance. */
+    EUCLIDEAN("euclidean"),
+    /** squared L2 distance, ranks neighbours as [EUCLIDEAN] without the square roots. */
+    SQEUCLIDEAN("sqeuclidean"),
+    /** L1 distance. */
+    MANHATTAN("manhattan"),
+    /** one minus the cosine of the angle between samples. */
+    COSINE("cosine")
+}
+
+/**
+ * Distances between the rows of [x] and the rows of [y].
+ *
+ * L2 and cosine distances are computed with one matrix product through BLAS, L1 natively,
+ * and the rows are finished on several threads.
+ *
+ * @param x array of the shape `(n, features)`.
+ * @param y array of the shape `(m, features)`.
+ * @return array of the shape `(n, m)`.
+ */
+fun <T : Number> pairwiseDistances(
+    x: KtNDArray<T>,
+    y: KtNDArray<T> = x,
+    metric: Metric = Metric.EUCLIDEAN
+): KtNDArray<Double> = Neighbors.pairwiseDistances(x, y, metric.str)
+
+/**
+ * The [k] nearest rows of [x] for each row of [queries].
+ *
+ * Distances are computed in tiles of a fixed size and merged into a bounded heap per query,
+ * so the memory used does not depend on the number of points and queries.
+ * Neighbours at the same distance are ordered by index.
+ *
+ * @param x points, array of the shape `(n, features)`.
+ * @param queries array of the shape `(q, features)`.
+ * @return indices into [x] of the shape `(q, k)` and the distances of the neighbours, nearest first.
+ */
+fun <T : Number> knn(
+    x: KtNDArray<T>,
+    queries: KtNDArray<T>,
+    k: Int,
+    metric: Metric = Metric.EUCLIDEAN
+): Pair<KtNDArray<Long>, KtNDArray<Double>> {
+    require(queries.ndim == 2) { "Expected queries of the shape (samples, features)" }
+    val indices = empty<Long>(queries.shape[0], k)
+    val distances = empty<Double>(queries.shape[0], k)
+    Neighbors.knn(x, queries, metric.str, indices, distances)
+    return Pair(indices, distances)
+}
+
+internal object Neighbors {
+    init {
+        Interpreter.interpreter
+    }
+
+    @JvmStatic
+    external fun pairwiseDistances(x: KtNDArray<*>, y: KtNDArray<*>, metric: String): KtNDArray<Double>
+
+    @JvmStatic
+    external fun knn(
+        x: KtNDArray<*>, queries: KtNDArray<*>, metric: String,
+        indices: KtNDArray<Long>, distances: KtNDArray<Double>
+    )
+
+    @JvmStatic
+    external fun treeBuild(points: KtNDArray<*>, kind: Int, leafSize: Int): Long
+
+    @JvmStatic
+    external fun treeSave(ptr: Long, file: String)
+
+    @JvmStatic
+    external fun treeOpen(file: String, mmap: Boolean): Long
+
+    @JvmStatic
+    external fun treeKind(ptr: Long): Int
+
+    @JvmStatic
+    external fun treeQuery(ptr: Long, queries: KtNDArray<*>, indices: KtNDArray<Long>, distances: KtNDArray<Double>)
+
+    @JvmStatic
+    external fun treeQueryRadius(ptr: Long, queries: KtNDArray<*>, r: Double): Array<Any>
+
+    @JvmStatic
+    external fun treeDealloc(ptr: Long)
+}
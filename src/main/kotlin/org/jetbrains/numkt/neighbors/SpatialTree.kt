@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.neighbors
+
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.empty
+
+/**
+ * Spatial index over points for nearest-neighbour and radius queries with Euclidean distance.
+ *
+ * The tree is built natively on several threads. Points that are already a C-contiguous [Double] array
+ * are used in place, so the array must not be modified while the tree is in use.
+ * A tree can be [saved][save] and [opened][SpatialTree.open] over a memory-mapped file.
+ *
+ * @see KDTree
+ * @see BallTree
+ */
+abstract class SpatialTree internal constructor(private var pointer: Long) : AutoCloseable {
+
+    /**
+     * The [k] nearest points for each row of [points].
+     *
+     * @param points array of the shape `(q, features)`.
+     * @return indices of the shape `(q, k)` and the distances of the neighbours, nearest first.
+     */
+    fun query(points: KtNDArray<out Number>, k: Int = 1): Pair<KtNDArray<Long>, KtNDArray<Double>> {
+        require(points.ndim == 2) { "Expected points of the shape (samples, features)" }
+        val indices = empty<Long>(points.shape[0], k)
+        val distances = empty<Double>(points.shape[0], k)
+        Neighbors.treeQuery(ptr(), points, indices, distances)
+        return Pair(indices, distances)
+    }
+
+    /**
+     * All points within the distance [r] of each row of [points], nearest first.
+     *
+     * @param points array of the shape `(q, features)`.
+     */
+    fun queryRadius(points: KtNDArray<out Number>, r: Double): RadiusNeighbors {
+        val (offsets, indices, distances) = Neighbors.treeQueryRadius(ptr(), points, r)
+        @Suppress("UNCHECKED_CAST")
+        return RadiusNeighbors(
+            offsets as KtNDArray<Long>, indices as KtNDArray<Long>, distances as KtNDArray<Double>
+        )
+    }
+
+    /**
+     * Save the tree with its points to a file, which can be memory-mapped by [SpatialTree.open].
+     * The file uses the native byte order.
+     */
+    fun save(file: String): Unit = Neighbors.treeSave(ptr(), file)
+
+    private fun ptr(): Long {
+        check(pointer != 0L) { "SpatialTree is closed" }
+        return pointer
+    }
+
+    override fun close() = synchronized(this) {
+        if (pointer != 0L) {
+            Neighbors.treeDealloc(pointer)
+            pointer = 0L
+        }
+    }
+
+    protected fun finalize() {
+        close()
+    }
+
+    companion object {
+        internal const val KD = 0
+        internal const val BALL = 1
+
+        /**
+         * Open a tree saved by [save].
+         *
+         * @param mmap if *true*, the file is memory-mapped instead of read, so opening takes no time
+         * and the pages are shared between processes.
+         * @return [KDTree] or [BallTree], as it was saved.
+         */
+        @JvmStatic
+        fun open(file: String, mmap: Boolean = true): SpatialTree {
+            val pointer = Neighbors.treeOpen(file, mmap)
+            return when (Neighbors.treeKind(pointer)) {
+                KD -> KDTree(pointer)
+                else -> BallTree(pointer)
+            }
+        }
+    }
+}
+
+/**
+ * KD-tree: nodes are axis-aligned boxes, suited to points of a few dimensions.
+ *
+ * @param points array of the shape `(n, features)`.
+ * @param leafSize number of points at which to stop splitting, leaves have from [leafSize] to 2 * [leafSize] points.
+ */
+class KDTree internal constructor(pointer: Long) : SpatialTree(pointer) {
+    constructor(points: KtNDArray<out Number>, leafSize: Int = 40) : this(Neighbors.treeBuild(points, KD, leafSize))
+}
+
+/**
+ * Ball tree: nodes are balls around the centroids of their points,
+ * it prunes better than [KDTree] when there are more dimensions.
+ *
+ * @param points array of the shape `(n, features)`.
+ * @param leafSize number of points at which to stop splitting, leaves have from [leafSize] to 2 * [leafSize] points.
+ */
+class BallTree internal constructor(pointer: Long) : SpatialTree(pointer) {
+    constructor(points: KtNDArray<out Number>, leafSize: Int = 40) : this(Neighbors.treeBuild(points, BALL, leafSize))
+}
+
+/**
+ * Result of [SpatialTree.queryRadius]: the neighbours of the query `i` are
+ * `indices[offsets[i] until offsets[i + 1]]`, and so are their distances.
+ */
+class RadiusNeighbors internal constructor(
+    val offsets: KtNDArray<Long>,
+    val indices: KtNDArray<Long>,
+    val distances: KtNDArray<Double>
+) {
+    /**
+     * Number of queries.
+     */
+    val size: Int
+        get() = offsets.size - 1
+
+    /**
+     * Indices and distances of the neighbours of the query [i].
+     */
+    operator fun get(i: Int): Pair<KtNDArray<Long>, KtNDArray<Double>> {
+        val range = offsets[i].scalar!!.toInt() until offsets[i + 1].scalar!!.toInt()
+        return Pair(indices[range], distances[range])
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.random
+
+/**
+ * Continuous distribution for the bulk fills of [KtGenerator] and [Random.fill].
+ */
+class Distribution private constructor(internal val kind: Int, internal val a: Double, internal val b: Double) {
+
+    companion object {
+        /**
+         * Uniform distribution over [[low], [high]), as `Generator.uniform`.
+         */
+        @JvmStatic
+        fun uniform(low: Double = 0.0, high: Double = 1.0): Distribution = Distribution(0, low, high - low)
+
+        /**
+         * Normal distribution with mean [loc] and standard deviation [scale], as `Generator.normal`.
+         */
+        @JvmStatic
+        fun normal(loc: Double = 0.0, scale: Double = 1.0): Distribution = Distribution(1, loc, scale)
+
+        /**
+         * Exponential distribution with the given [scale], as `Generator.exponential`.
+         */
+        @JvmStatic
+        fun exponential(scale: Double = 1.0): Distribution = Distribution(2, 0.0, scale)
+    }
+}
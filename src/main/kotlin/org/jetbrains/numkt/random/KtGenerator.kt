@@ -0,0 +1,253 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.random
+
+import org.jetbrains.numkt.Interpreter
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.empty
+import java.nio.Buffer
+import java.nio.ByteOrder
+import java.nio.DoubleBuffer
+import java.nio.FloatBuffer
+import java.nio.LongBuffer
+
+/**
+ * Bit generators of numpy.random.
+ */
+enum class BitGenerator(val str: String) {
+    PCG64("PCG64"),
+    PCG64DXSM("PCG64DXSM"),
+    PHILOX("Philox"),
+    SFC64("SFC64"),
+    MT19937("MT19937")
+}
+
+/**
+ * Mapping of numpy.random.Generator.
+ *
+ * Fill methods write into preallocated arrays natively, without calling the interpreter,
+ * and produce exactly the streams of the corresponding Generator methods.
+ * A generator is not meant to be shared between threads: use [spawn] or [threadLocal]
+ * to get independent streams for parallel work.
+ *
+ * The `fill` methods write into JVM arrays and direct buffers. With `parallel` set, a large fill is split
+ * into blocks of a fixed size, each drawn from a stream jumped from this one, and the blocks are filled
+ * on the native thread pool. The result depends only on the seed and the size, not on the number of threads.
+ * Bit generators that cannot jump, such as SFC64, always fill serially.
+ */
+class KtGenerator private constructor(private var pointer: Long) : AutoCloseable {
+
+    /**
+     * @param seed seed of the bit generator, fresh entropy from the OS if null.
+     * @param bitGenerator the bit generator.
+     */
+    constructor(seed: Long? = null, bitGenerator: BitGenerator = BitGenerator.PCG64) :
+            this(generatorNew(bitGenerator.str, seed))
+
+    /**
+     * Create [n] generators with statistically independent streams, as `SeedSequence.spawn`.
+     */
+    fun spawn(n: Int): List<KtGenerator> {
+        require(n >= 0) { "n must be non-negative" }
+        return generatorSpawn(ptr(), n).map { KtGenerator(it) }
+    }
+
+    /**
+     * Generator whose state is advanced as if 2^128 * [jumps] numbers had been generated.
+     */
+    fun jumped(jumps: Int = 1): KtGenerator = KtGenerator(generatorJumped(ptr(), jumps))
+
+    /**
+     * Fill [out] with floats from the uniform distribution over [0, 1).
+     * Supported types are [Double] and [Float].
+     */
+    fun random(out: KtNDArray<out Number>): Unit = synchronized(this) { fillRandom(ptr(), out) }
+
+    /**
+     * Fill [out] with samples from the standard normal distribution.
+     * Supported types are [Double] and [Float].
+     */
+    fun standardNormal(out: KtNDArray<out Number>): Unit = synchronized(this) { fillStandardNormal(ptr(), out) }
+
+    /**
+     * Fill [out] with samples from the standard exponential distribution.
+     * Supported types are [Double] and [Float].
+     */
+    fun standardExponential(out: KtNDArray<out Number>): Unit =
+        synchronized(this) { fillStandardExponential(ptr(), out) }
+
+    /**
+     * Fill [out] with integers from [low] (inclusive) to [high] (exclusive).
+     * Supported types are [Long], [Int], [Short] and [Byte].
+     */
+    fun integers(out: KtNDArray<out Number>, low: Long, high: Long): Unit =
+        synchronized(this) { fillIntegers(ptr(), out, low, high) }
+
+    /**
+     * Return floats of the given shape from the uniform distribution over [0, 1).
+     */
+    inline fun <reified T : Number> random(vararg shape: Int): KtNDArray<T> =
+        empty<T>(*shape).also { random(it) }
+
+    /**
+     * Return samples of the given shape from the standard normal distribution.
+     */
+    inline fun <reified T : Number> standardNormal(vararg shape: Int): KtNDArray<T> =
+        empty<T>(*shape).also { standardNormal(it) }
+
+    /**
+     * Return samples of the given shape from the standard exponential distribution.
+     */
+    inline fun <reified T : Number> standardExponential(vararg shape: Int): KtNDArray<T> =
+        empty<T>(*shape).also { standardExponential(it) }
+
+    /**
+     * Return integers of the given shape from [low] (inclusive) to [high] (exclusive).
+     */
+    inline fun <reified T : Number> integers(low: Long, high: Long, vararg shape: Int): KtNDArray<T> =
+        empty<T>(*shape).also { integers(it, low, high) }
+
+    /**
+     * Fill [out] with samples from the [distribution].
+     */
+    fun fill(out: DoubleArray, distribution: Distribution = Distribution.uniform(), parallel: Boolean = true): Unit =
+        fillArray(out, Double::class.javaObjectType, distribution, 0, 0, parallel)
+
+    /**
+     * Fill [out] with samples from the [distribution].
+     */
+    fun fill(out: FloatArray, distribution: Distribution = Distribution.uniform(), parallel: Boolean = true): Unit =
+        fillArray(out, Float::class.javaObjectType, distribution, 0, 0, parallel)
+
+    /**
+     * Fill [out] with integers from [low] (inclusive) to [high] (exclusive).
+     */
+    fun fill(out: LongArray, low: Long, high: Long, parallel: Boolean = true): Unit =
+        fillArray(out, Long::class.javaObjectType, Distribution.uniform(), low, high, parallel)
+
+    /**
+     * Fill the remaining elements of the direct [buffer] with samples from the [distribution]
+     * and move its position to the limit.
+     * A direct [java.nio.ByteBuffer] can be filled through its `asDoubleBuffer()` view in the native byte order.
+     */
+    fun fill(buffer: DoubleBuffer, distribution: Distribution = Distribution.uniform(), parallel: Boolean = true): Unit =
+        fillBuffer(buffer, Double::class.javaObjectType, 8, distribution, 0, 0, parallel)
+
+    /**
+     * Fill the remaining elements of the direct [buffer] with samples from the [distribution]
+     * and move its position to the limit.
+     */
+    fun fill(buffer: FloatBuffer, distribution: Distribution = Distribution.uniform(), parallel: Boolean = true): Unit =
+        fillBuffer(buffer, Float::class.javaObjectType, 4, distribution, 0, 0, parallel)
+
+    /**
+     * Fill the remaining elements of the direct [buffer] with integers from [low] (inclusive) to [high] (exclusive)
+     * and move its position to the limit.
+     */
+    fun fill(buffer: LongBuffer, low: Long, high: Long, parallel: Boolean = true): Unit =
+        fillBuffer(buffer, Long::class.javaObjectType, 8, Distribution.uniform(), low, high, parallel)
+
+    private fun fillArray(
+        out: Any, dtype: Class<*>, distribution: Distribution, low: Long, high: Long, parallel: Boolean
+    ) = synchronized(this) {
+        fillPrimitiveArray(ptr(), out, dtype, distribution.kind, distribution.a, distribution.b, low, high, parallel)
+    }
+
+    private fun fillBuffer(
+        buffer: Buffer, dtype: Class<*>, itemsize: Int,
+        distribution: Distribution, low: Long, high: Long, parallel: Boolean
+    ) {
+        require(buffer.isDirect) { "Buffer must be direct" }
+        require(!buffer.isReadOnly) { "Buffer is read-only" }
+        val order = when (buffer) {
+            is DoubleBuffer -> buffer.order()
+            is FloatBuffer -> buffer.order()
+            is LongBuffer -> buffer.order()
+            else -> ByteOrder.nativeOrder()
+        }
+        require(order == ByteOrder.nativeOrder()) { "Buffer must be in the native byte order" }
+        synchronized(this) {
+            fillDirectBuffer(
+                ptr(), buffer, buffer.position().toLong() * itemsize, buffer.remaining().toLong(), dtype,
+                distribution.kind, distribution.a, distribution.b, low, high, parallel
+            )
+        }
+        buffer.position(buffer.limit())
+    }
+
+    private fun ptr(): Long {
+        check(pointer != 0L) { "KtGenerator is closed" }
+        return pointer
+    }
+
+    override fun close() = synchronized(this) {
+        if (pointer != 0L) {
+            generatorDealloc(pointer)
+            pointer = 0L
+        }
+    }
+
+    protected fun finalize() {
+        close()
+    }
+
+    private external fun generatorSpawn(ptr: Long, n: Int): LongArray
+
+    private external fun generatorJumped(ptr: Long, jumps: Int): Long
+
+    private external fun fillRandom(ptr: Long, out: KtNDArray<out Number>)
+
+    private external fun fillStandardNormal(ptr: Long, out: KtNDArray<out Number>)
+
+    private external fun fillStandardExponential(ptr: Long, out: KtNDArray<out Number>)
+
+    private external fun fillIntegers(ptr: Long, out: KtNDArray<out Number>, low: Long, high: Long)
+
+    private external fun fillPrimitiveArray(
+        ptr: Long, array: Any, dtype: Class<*>, distribution: Int,
+        a: Double, b: Double, low: Long, high: Long, parallel: Boolean
+    )
+
+    private external fun fillDirectBuffer(
+        ptr: Long, buffer: Buffer, offset: Long, count: Long, dtype: Class<*>, distribution: Int,
+        a: Double, b: Double, low: Long, high: Long, parallel: Boolean
+    )
+
+    private external fun generatorDealloc(ptr: Long)
+
+    companion object {
+        init {
+            Interpreter.interpreter
+        }
+
+        private val root: KtGenerator by lazy { KtGenerator() }
+
+        private val local: ThreadLocal<KtGenerator> = ThreadLocal.withInitial {
+            synchronized(root) { root.spawn(1).single() }
+        }
+
+        /**
+         * Generator of the current thread. The generators of different threads are spawned from
+         * one root generator, so their streams are independent.
+         */
+        @JvmStatic
+        fun threadLocal(): KtGenerator = local.get()
+
+        @JvmStatic
+        private external fun generatorNew(bitGenerator: String, seed: Long?): Long
+    }
+}
@@ -19,6 +19,11 @@ package org.jetbrains.numkt.random
 import org.jetbrains.numkt.callFunc
 import org.jetbrains.numkt.core.KtNDArray
 import org.jetbrains.numkt.core.None
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.DoubleBuffer
+import java.nio.FloatBuffer
+import java.nio.LongBuffer
 
 class Random {
     companion object {
@@ -1006,5 +1011,59 @@ class Random {
         fun zipf(a: DoubleArray, vararg size: Int): KtNDArray<Long> =
             callFunc(nameMethod = arrayOf("random", "zipf"), args = arrayOf(a, size))
 
+        /**
+         * Fill [out] with samples from the [distribution], by default with the generator of the current thread.
+         * The values are generated natively without creating arrays, see [KtGenerator.fill].
+         */
+        fun fill(
+            out: DoubleArray,
+            distribution: Distribution = Distribution.uniform(),
+            generator: KtGenerator = KtGenerator.threadLocal()
+        ): Unit = generator.fill(out, distribution)
+
+        fun fill(
+            out: FloatArray,
+            distribution: Distribution = Distribution.uniform(),
+            generator: KtGenerator = KtGenerator.threadLocal()
+        ): Unit = generator.fill(out, distribution)
+
+        /**
+         * Fill [out] with integers from [low] (inclusive) to [high] (exclusive).
+         */
+        fun fill(out: LongArray, low: Long, high: Long, generator: KtGenerator = KtGenerator.threadLocal()): Unit =
+            generator.fill(out, low, high)
+
+        /**
+         * Fill the remaining elements of the direct [buffer] and move its position to the limit.
+         */
+        fun fill(
+            buffer: DoubleBuffer,
+            distribution: Distribution = Distribution.uniform(),
+            generator: KtGenerator = KtGenerator.threadLocal()
+        ): Unit = generator.fill(buffer, distribution)
+
+        fun fill(
+            buffer: FloatBuffer,
+            distribution: Distribution = Distribution.uniform(),
+            generator: KtGenerator = KtGenerator.threadLocal()
+        ): Unit = generator.fill(buffer, distribution)
+
+        fun fill(buffer: LongBuffer, low: Long, high: Long, generator: KtGenerator = KtGenerator.threadLocal()): Unit =
+            generator.fill(buffer, low, high)
+
+        /**
+         * Fill the remaining bytes of the direct [buffer] with doubles in the native byte order
+         * and move its position past them, whatever the byte order of the [buffer] is.
+         */
+        fun fill(
+            buffer: ByteBuffer,
+            distribution: Distribution = Distribution.uniform(),
+            generator: KtGenerator = KtGenerator.threadLocal()
+        ) {
+            val doubles = buffer.duplicate().order(ByteOrder.nativeOrder()).asDoubleBuffer()
+            generator.fill(doubles, distribution)
+            buffer.position(buffer.position() + doubles.capacity() * 8)
+        }
+
     }
 }
\ No newline at end of file
@@ -0,0 +1,265 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.jetbrains.numkt.statistics
+
+import org.jetbrains.numkt.Interpreter
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.linspace
+import org.jetbrains.numkt.math.sqrt
+
+/**
+ * Statistics of data that arrives in chunks, without keeping the chunks.
+ *
+ * [update] folds a chunk into the state natively on several threads, [merge] folds in the state
+ * of another accumulator of the same parameters, so the chunks can be split between threads or processes
+ * and the partial accumulators merged at the end. NaN values are skipped.
+ * The state is kept in native memory until the accumulator is [closed][close].
+ *
+ * An accumulator can be updated from several threads, the updates are applied one at a time.
+ */
+abstract class StreamingAccumulator<A : StreamingAccumulator<A, R>, R> internal constructor(private var pointer: Long) :
+    AutoCloseable {
+
+    /**
+     * Fold the values of [chunk] into the statistics.
+     */
+    fun update(chunk: KtNDArray<out Number>): Unit = synchronized(this) {
+        Accumulators.accumulatorUpdate(ptr(), chunk)
+    }
+
+    /**
+     * Fold the statistics of [other] into these, as if its chunks were given to [update].
+     * [other] keeps its statistics, though [StreamingQuantiles] compresses its clusters.
+     */
+    fun merge(other: A) {
+        require(other !== this) { "An accumulator cannot be merged into itself" }
+        // both are locked in the same order whichever is merged into the other
+        val thisHash = System.identityHashCode(this)
+        val otherHash = System.identityHashCode(other)
+        when {
+            thisHash < otherHash -> synchronized(this) { synchronized(other) { mergeLocked(other) } }
+            thisHash > otherHash -> synchronized(other) { synchronized(this) { mergeLocked(other) } }
+            else -> synchronized(tieLock) { synchronized(this) { synchronized(other) { mergeLocked(other) } } }
+        }
+    }
+
+    private fun mergeLocked(other: A) {
+        Accumulators.accumulatorMerge(ptr(), other.ptr())
+    }
+
+    /**
+     * Statistics of the values given so far.
+     */
+    fun result(): R = synchronized(this) { compute(ptr()) }
+
+    internal abstract fun compute(pointer: Long): R
+
+    internal fun ptr(): Long {
+        check(pointer != 0L) { "Accumulator is closed" }
+        return pointer
+    }
+
+    override fun close() = synchronized(this) {
+        if (pointer != 0L) {
+            Accumulators.accumulatorDealloc(pointer)
+            pointer = 0L
+        }
+    }
+
+    protected fun finalize() {
+        close()
+    }
+
+    private companion object {
+        // taken first by the merges of accumulators with the same identity hash
+        val tieLock = Any()
+    }
+}
+
+/**
+ * Count, mean, variance, minimum and maximum of every column, accumulated by [StreamingMoments].
+ */
+class Moments internal constructor(
+    val count: KtNDArray<Long>,
+    val mean: KtNDArray<Double>,
+    val variance: KtNDArray<Double>,
+    val min: KtNDArray<Double>,
+    val max: KtNDArray<Double>
+) {
+    /** standard deviation of every column. */
+    val std: KtNDArray<Double>
+        get() = sqrt(variance)
+}
+
+/**
+ * Mean, variance, minimum and maximum of every column.
+ * Blocks of a chunk are summarized in two passes and combined by the formulas of Chan et al.,
+ * so the results are as accurate as [mean] and [`var`] over all the values.
+ *
+ * @param columns number of columns, chunks are arrays of the shape `(rows, columns)`
+ * or one-dimensional arrays when there is one column.
+ * @param ddof delta degrees of freedom of the variance.
+ */
+class StreamingMoments(val columns: Int = 1, val ddof: Int = 0) :
+    StreamingAccumulator<StreamingMoments, Moments>(Accumulators.momentsNew(columns)) {
+
+    @Suppress("UNCHECKED_CAST")
+    override fun compute(pointer: Long): Moments = Moments(
+        Accumulators.momentsResult(pointer, COUNT, ddof) as KtNDArray<Long>,
+        Accumulators.momentsResult(pointer, MEAN, ddof) as KtNDArray<Double>,
+        Accumulators.momentsResult(pointer, VARIANCE, ddof) as KtNDArray<Double>,
+        Accumulators.momentsResult(pointer, MIN, ddof) as KtNDArray<Double>,
+        Accumulators.momentsResult(pointer, MAX, ddof) as KtNDArray<Double>
+    )
+
+    private companion object {
+        const val COUNT = 0
+        const val MEAN = 1
+        const val VARIANCE = 2
+        const val MIN = 3
+        const val MAX = 4
+    }
+}
+
+/**
+ * Covariance matrix of the columns, as [cov] of the transposed rows.
+ * Rows with NaN values are skipped.
+ *
+ * @param columns number of columns, chunks are arrays of the shape `(rows, columns)`.
+ * @param ddof delta degrees of freedom, 1 gives the unbiased estimate.
+ */
+class StreamingCovariance(val columns: Int, val ddof: Int = 1) :
+    StreamingAccumulator<StreamingCovariance, KtNDArray<Double>>(Accumulators.covarianceNew(columns)) {
+
+    /** number of rows without NaN values. */
+    val count: Long
+        get() = synchronized(this) { Accumulators.accumulatorCount(ptr()) }
+
+    /**
+     * Mean of every column.
+     */
+    @Suppress("UNCHECKED_CAST")
+    fun mean(): KtNDArray<Double> = synchronized(this) {
+        Accumulators.covarianceResult(ptr(), MEAN, ddof) as KtNDArray<Double>
+    }
+
+    @Suppress("UNCHECKED_CAST")
+    override fun compute(pointer: Long): KtNDArray<Double> =
+        Accumulators.covarianceResult(pointer, COVARIANCE, ddof) as KtNDArray<Double>
+
+    private companion object {
+        const val MEAN = 0
+        const val COVARIANCE = 1
+    }
+}
+
+/**
+ * Histogram of [bins] equal bins over the range from [low] to [high], binned as by numpy.histogram.
+ * Chunks may be of any shape, [result] gives the counts of the bins and the edges of the bins.
+ */
+class StreamingHistogram(val bins: Int, val low: Double, val high: Double) :
+    StreamingAccumulator<StreamingHistogram, Pair<KtNDArray<Long>, KtNDArray<Double>>>(
+        Accumulators.histogramNew(bins, low, high)
+    ) {
+
+    /** number of values below [low]. */
+    val underflow: Long
+        get() = synchronized(this) { Accumulators.histogramOutside(ptr(), false) }
+
+    /** number of values above [high]. */
+    val overflow: Long
+        get() = synchronized(this) { Accumulators.histogramOutside(ptr(), true) }
+
+    @Suppress("UNCHECKED_CAST")
+    override fun compute(pointer: Long): Pair<KtNDArray<Long>, KtNDArray<Double>> = Pair(
+        Accumulators.histogramCounts(pointer) as KtNDArray<Long>,
+        linspace<Double>(low, high, bins + 1)
+    )
+}
+
+/**
+ * Approximate quantiles by a merging t-digest: values are kept in clusters which are small near
+ * the extremes and larger near the median, so the tails are the most accurate
+ * and the memory is about [compression] clusters whatever the number of values.
+ * Chunks may be of any shape.
+ *
+ * @param probabilities quantiles given by [result].
+ * @param compression accuracy of the sketch, at least 10, the number of clusters grows with it.
+ */
+class StreamingQuantiles(
+    val probabilities: DoubleArray = doubleArrayOf(0.25, 0.5, 0.75),
+    val compression: Double = 200.0
+) : StreamingAccumulator<StreamingQuantiles, DoubleArray>(Accumulators.quantilesNew(compression)) {
+
+    /** number of values. */
+    val count: Long
+        get() = synchronized(this) { Accumulators.accumulatorCount(ptr()) }
+
+    /**
+     * Approximate quantile [q] from 0 to 1, NaN when there are no values.
+     */
+    fun quantile(q: Double): Double = synchronized(this) {
+        Accumulators.quantilesResult(ptr(), doubleArrayOf(q))[0]
+    }
+
+    override fun compute(pointer: Long): DoubleArray = Accumulators.quantilesResult(pointer, probabilities)
+}
+
+internal object Accumulators {
+    init {
+        Interpreter.interpreter
+    }
+
+    @JvmStatic
+    external fun momentsNew(columns: Int): Long
+
+    @JvmStatic
+    external fun covarianceNew(columns: Int): Long
+
+    @JvmStatic
+    external fun histogramNew(bins: Int, low: Double, high: Double): Long
+
+    @JvmStatic
+    external fun quantilesNew(compression: Double): Long
+
+    @JvmStatic
+    external fun accumulatorUpdate(pointer: Long, chunk: KtNDArray<*>)
+
+    @JvmStatic
+    external fun accumulatorMerge(pointer: Long, other: Long)
+
+    @JvmStatic
+    external fun accumulatorCount(pointer: Long): Long
+
+    @JvmStatic
+    external fun momentsResult(pointer: Long, field: Int, ddof: Int): KtNDArray<*>
+
+    @JvmStatic
+    external fun covarianceResult(pointer: Long, field: Int, ddof: Int): KtNDArray<*>
+
+    @JvmStatic
+    external fun histogramCounts(pointer: Long): KtNDArray<*>
+
+    @JvmStatic
+    external fun histogramOutside(pointer: Long, above: Boolean): Long
+
+    @JvmStatic
+    external fun quantilesResult(pointer: Long, q: DoubleArray): DoubleArray
+
+    @JvmStatic
+    external fun accumulatorDealloc(pointer: Long)
+}
@@ -16,6 +16,8 @@
 
 package org.jetbrains.numkt.statistics
 
+import org.jetbrains.numkt.Reductions
+import org.jetbrains.numkt.callDouble
 import org.jetbrains.numkt.callFunc
 import org.jetbrains.numkt.core.KtNDArray
 
@@ -23,7 +25,7 @@ import org.jetbrains.numkt.core.KtNDArray
  * Compute the median along the specified axis.
  */
 fun <T : Number> median(a: KtNDArray<T>): Double =
-    callFunc(nameMethod = arrayOf("median"), args = arrayOf(a), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("median"), args = arrayOf(a))
 
 /**
  *
@@ -35,7 +37,7 @@ fun <T : Number> median(a: KtNDArray<T>, axis: Int): KtNDArray<Double> =
  * Compute the weighted average along the specified axis.
  */
 fun <T : Number> average(a: KtNDArray<T>): Double =
-    callFunc(nameMethod = arrayOf("average"), args = arrayOf(a), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("average"), args = arrayOf(a))
 
 /**
  *
@@ -47,19 +49,21 @@ fun <T : Number> average(a: KtNDArray<T>, axis: Int): KtNDArray<Double> =
  * Compute the arithmetic mean along the specified axis.
  */
 fun <T : Number> mean(a: KtNDArray<T>): Double =
-    callFunc(nameMethod = arrayOf("mean"), args = arrayOf(a), kClass = Double::class)
+    Reductions.all(a, Reductions.MEAN, Double::class)
+        ?: callDouble(nameMethod = arrayOf("mean"), args = arrayOf(a))
 
 /**
  *
  */
 fun <T : Number> mean(a: KtNDArray<T>, axis: Int): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("mean"), args = arrayOf(a, axis))
+    Reductions.axis(a, Reductions.MEAN, axis)
+        ?: callFunc(nameMethod = arrayOf("mean"), args = arrayOf(a, axis))
 
 /**
  * Compute the standard deviation along the specified axis.
  */
 fun <T : Number> std(a: KtNDArray<T>, ddof: Int = 0): Double =
-    callFunc(nameMethod = arrayOf("std"), args = arrayOf(a, ddof), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("std"), args = arrayOf(a, ddof))
 
 /**
  *
@@ -71,19 +75,21 @@ fun <T : Number> std(a: KtNDArray<T>, axis: Int, ddof: Int = 0): KtNDArray<Doubl
  * Compute the variance along the specified axis.
  */
 fun <T : Number> `var`(a: KtNDArray<T>, ddof: Int = 0): Double =
-    callFunc(nameMethod = arrayOf("var"), args = arrayOf(a, ddof), kClass = Double::class)
+    Reductions.all(a, Reductions.VAR, Double::class, ddof)
+        ?: callDouble(nameMethod = arrayOf("var"), args = arrayOf(a, ddof))
 
 /**
  *
  */
 fun <T : Number> `var`(a: KtNDArray<T>, axis: Int, ddof: Int = 0): KtNDArray<Double> =
-    callFunc(nameMethod = arrayOf("var"), args = arrayOf(a, axis, ddof))
+    Reductions.axis(a, Reductions.VAR, axis, ddof)
+        ?: callFunc(nameMethod = arrayOf("var"), args = arrayOf(a, axis, ddof))
 
 /**
  * Compute the median along the specified axis, while ignoring NaNs.
  */
 fun <T : Number> nanMedian(a: KtNDArray<T>): Double =
-    callFunc(nameMethod = arrayOf("nanmedian"), args = arrayOf(a), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("nanmedian"), args = arrayOf(a))
 
 /**
  *
@@ -95,7 +101,7 @@ fun <T : Number> nanMedian(a: KtNDArray<T>, axis: Int): KtNDArray<Double> =
  * Compute the arithmetic mean along the specified axis, ignoring NaNs.
  */
 fun <T : Number> nanMean(a: KtNDArray<T>): Double =
-    callFunc(nameMethod = arrayOf("nanmean"), args = arrayOf(a), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("nanmean"), args = arrayOf(a))
 
 /**
  *
@@ -107,7 +113,7 @@ fun <T : Number> nanMean(a: KtNDArray<T>, axis: Int): KtNDArray<Double> =
  * Compute the standard deviation along the specified axis, while ignoring NaNs.
  */
 fun <T : Number> nanStd(a: KtNDArray<T>, ddof: Int = 0): Double =
-    callFunc(nameMethod = arrayOf("nanstd"), args = arrayOf(a, ddof), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("nanstd"), args = arrayOf(a, ddof))
 
 /**
  *
@@ -119,7 +125,7 @@ fun <T : Number> nanStd(a: KtNDArray<T>, axis: Int, ddof: Int = 0): KtNDArray<Do
  * Compute the variance along the specified axis, while ignoring NaNs.
  */
 fun <T : Number> nanVar(a: KtNDArray<T>, ddof: Int = 0): Double =
-    callFunc(nameMethod = arrayOf("nanvar"), args = arrayOf(a, ddof), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("nanvar"), args = arrayOf(a, ddof))
 
 /**
  *
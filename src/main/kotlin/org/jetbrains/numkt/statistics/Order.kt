@@ -16,32 +16,39 @@
 
 package org.jetbrains.numkt.statistics
 
+import org.jetbrains.numkt.Reductions
+import org.jetbrains.numkt.callDouble
 import org.jetbrains.numkt.callFunc
+import org.jetbrains.numkt.callNumber
 import org.jetbrains.numkt.core.KtNDArray
 
 /**
  * Return the minimum of an array or minimum along an axis.
  */
 inline fun <reified T : Number> amin(a: KtNDArray<T>): T =
-    callFunc(nameMethod = arrayOf("amin"), args = arrayOf(a), kClass = T::class)
+    Reductions.all(a, Reductions.MIN, T::class)
+        ?: callNumber(nameMethod = arrayOf("amin"), args = arrayOf(a))
 
 fun <T : Number> amin(a: KtNDArray<T>, axis: Int): KtNDArray<T> =
-    callFunc(nameMethod = arrayOf("amin"), args = arrayOf(a, axis))
+    Reductions.axis(a, Reductions.MIN, axis)
+        ?: callFunc(nameMethod = arrayOf("amin"), args = arrayOf(a, axis))
 
 /**
  * 	Return the maximum of an array or maximum along an axis.
  */
 inline fun <reified T : Number> amax(a: KtNDArray<T>): T =
-    callFunc(nameMethod = arrayOf("amax"), args = arrayOf(a), kClass = T::class)
+    Reductions.all(a, Reductions.MAX, T::class)
+        ?: callNumber(nameMethod = arrayOf("amax"), args = arrayOf(a))
 
 fun <T : Number> amax(a: KtNDArray<T>, axis: Int): KtNDArray<T> =
-    callFunc(nameMethod = arrayOf("amax"), args = arrayOf(a, axis))
+    Reductions.axis(a, Reductions.MAX, axis)
+        ?: callFunc(nameMethod = arrayOf("amax"), args = arrayOf(a, axis))
 
 /**
  * Return minimum of an array or minimum along an axis, ignoring any NaNs.
  */
 fun <T : Number> nanmin(a: KtNDArray<T>): Double =
-    callFunc(nameMethod = arrayOf("nanmin"), args = arrayOf(a), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("nanmin"), args = arrayOf(a))
 
 fun <T : Number> nanmin(a: KtNDArray<T>, axis: Int): KtNDArray<Double> =
     callFunc(nameMethod = arrayOf("nanmin"), args = arrayOf(a, axis))
@@ -50,7 +57,7 @@ fun <T : Number> nanmin(a: KtNDArray<T>, axis: Int): KtNDArray<Double> =
  * Return the maximum of an array or maximum along an axis, ignoring any NaNs.
  */
 fun <T : Number> nanmax(a: KtNDArray<T>): Double =
-    callFunc(nameMethod = arrayOf("nanmax"), args = arrayOf(a), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("nanmax"), args = arrayOf(a))
 
 fun <T : Number> nanmax(a: KtNDArray<T>, axis: Int): KtNDArray<Double> =
     callFunc(nameMethod = arrayOf("nanmax"), args = arrayOf(a, axis))
@@ -65,7 +72,7 @@ fun <T : Number> ptp(a: KtNDArray<T>, axis: Int): KtNDArray<T> =
  * Compute the q-th percentile of the data along the specified axis.
  */
 fun <T : Number> percentile(a: KtNDArray<T>, q: Double): Double =
-    callFunc(nameMethod = arrayOf("percentile"), args = arrayOf(a, q), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("percentile"), args = arrayOf(a, q))
 
 fun <T : Number> percentile(a: KtNDArray<T>, q: Double, axis: Int): KtNDArray<Double> =
     callFunc(nameMethod = arrayOf("percentile"), args = arrayOf(a, q, axis))
@@ -75,7 +82,7 @@ fun <T : Number> percentile(a: KtNDArray<T>, q: Double, axis: Int): KtNDArray<Do
  *
  */
 fun <T : Number> nanPercentile(a: KtNDArray<T>, q: Double): Double =
-    callFunc(nameMethod = arrayOf("nanpercentile"), args = arrayOf(a, q), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("nanpercentile"), args = arrayOf(a, q))
 
 /**
  * Compute the qth percentile of the data along the specified axis, while ignoring nan values.
@@ -87,7 +94,7 @@ fun <T : Number> nanPercentile(a: KtNDArray<T>, q: Double, axis: Int): KtNDArray
  * Compute the q-th quantile of the data along the specified axis.
  */
 fun <T : Number> quantile(a: KtNDArray<T>, q: Double): Double =
-    callFunc(nameMethod = arrayOf("quantile"), args = arrayOf(a, q), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("quantile"), args = arrayOf(a, q))
 
 fun <T : Number> quantile(a: KtNDArray<T>, q: Double, axis: Int): KtNDArray<Double> =
     callFunc(nameMethod = arrayOf("nanpercentile"), args = arrayOf(a, q, axis))
@@ -97,7 +104,7 @@ fun <T : Number> quantile(a: KtNDArray<T>, q: Double, axis: Int): KtNDArray<Doub
  * Compute the qth quantile of the data along the specified axis, while ignoring nan values.
  */
 fun <T : Number> nanQuantile(a: KtNDArray<T>, q: Double): Double =
-    callFunc(nameMethod = arrayOf("nanquantile"), args = arrayOf(a, q), kClass = Double::class)
+    callDouble(nameMethod = arrayOf("nanquantile"), args = arrayOf(a, q))
 
 fun <T : Number> nanQuantile(a: KtNDArray<T>, q: Double, axis: Int): KtNDArray<Double> =
     callFunc(nameMethod = arrayOf("nanpercentile"), args = arrayOf(a, q, axis))
\ No newline at end of file
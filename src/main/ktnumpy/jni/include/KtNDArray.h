@@ -20,5 +20,54 @@
 jobject new_ktndarray (JNIEnv *, PyArrayObject *, jobject);
 PyArrayObject *numkt_core_KtNDArray_getPointer (JNIEnv *, jobject);
 jobject numkt_core_KtNDArray_getScalar (JNIEnv *, jobject);
+int register_ktndarray_natives (JNIEnv *);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    ndimGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDArray_ndimGetCritical
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    ndimGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDArray_ndimGetCritical
+    (jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    itemsizeGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDArray_itemsizeGetCritical
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    itemsizeGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDArray_itemsizeGetCritical
+    (jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    sizeGetCritical
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_core_KtNDArray_sizeGetCritical
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    sizeGetCritical
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDArray_sizeGetCritical
+    (jlong);
 
 #endif //_KTNDARRAY_H_
@@ -15,14 +15,6 @@ extern "C" {
 JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterNew
     (JNIEnv *, jobject, jobject, jobjectArray, jstring);
 
-/*
- * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    indexGet
- * Signature: (J)I
- */
-JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_indexGet
-    (JNIEnv *, jobject, jlong);
-
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
  * Method:    indexSet
@@ -31,14 +23,6 @@ JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_indexGet
 JNIEXPORT void JNICALL Java_org_jetbrains_numkt_core_KtNDIter_indexSet
     (JNIEnv *, jobject, jlong, jint);
 
-/*
- * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    iterIndexGet
- * Signature: (J)I
- */
-JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterIndexGet
-    (JNIEnv *, jobject, jlong);
-
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
  * Method:    iterIndexSet
@@ -47,14 +31,6 @@ JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterIndexGet
 JNIEXPORT void JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterIndexSet
     (JNIEnv *, jobject, jlong, jint);
 
-/*
- * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    iterSizeGet
- * Signature: (J)I
- */
-JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterSizeGet
-    (JNIEnv *, jobject, jlong);
-
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
  * Method:    multiIndexGet
@@ -87,14 +63,6 @@ JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterRangeGet
 JNIEXPORT void JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterRangeSet
     (JNIEnv *, jobject, jlong, jobject);
 
-/*
- * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    ndimGet
- * Signature: (J)I
- */
-JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_ndimGet
-    (JNIEnv *, jobject, jlong);
-
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
  * Method:    shapeGet
@@ -151,14 +119,6 @@ JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterDebugPrint
 JNIEXPORT jboolean JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_iterDebugPrintCritical
     (jlong);
 
-/*
- * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    iterNextC
- * Signature: (J)Z
- */
-JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterNextC
-    (JNIEnv *, jobject, jlong);
-
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
  * Method:    iterRemoveAxis
@@ -199,7 +159,90 @@ JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_core_KtNDIter_finishedGetCri
 JNIEXPORT jboolean JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_finishedGetCritical
     (jlong);
 
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterNextCritical
+ * Signature: (J)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterNextCritical
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterNextCritical
+ * Signature: (J)Z
+ */
+JNIEXPORT jboolean JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_iterNextCritical
+    (jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    indexGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_indexGetCritical
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    indexGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_indexGetCritical
+    (jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterIndexGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterIndexGetCritical
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterIndexGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_iterIndexGetCritical
+    (jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterSizeGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterSizeGetCritical
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterSizeGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_iterSizeGetCritical
+    (jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    ndimGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_ndimGetCritical
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    ndimGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_ndimGetCritical
+    (jlong);
+
+int register_ktnditer_natives (JNIEnv *);
+
 #ifdef __cplusplus
 }
 #endif
+
 #endif // _KTNDITER_H_
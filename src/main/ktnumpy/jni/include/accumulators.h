@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACCUMULATORS_H_
+#define _ACCUMULATORS_H_
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    momentsNew
+ * Signature: (I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_momentsNew
+    (JNIEnv *, jclass, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    covarianceNew
+ * Signature: (I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_covarianceNew
+    (JNIEnv *, jclass, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    histogramNew
+ * Signature: (IDD)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_histogramNew
+    (JNIEnv *, jclass, jint, jdouble, jdouble);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    quantilesNew
+ * Signature: (D)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_quantilesNew
+    (JNIEnv *, jclass, jdouble);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    accumulatorUpdate
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_accumulatorUpdate
+    (JNIEnv *, jclass, jlong, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    accumulatorMerge
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_accumulatorMerge
+    (JNIEnv *, jclass, jlong, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    accumulatorCount
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_accumulatorCount
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    momentsResult
+ * Signature: (JII)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_momentsResult
+    (JNIEnv *, jclass, jlong, jint, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    covarianceResult
+ * Signature: (JII)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_covarianceResult
+    (JNIEnv *, jclass, jlong, jint, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    histogramCounts
+ * Signature: (J)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_histogramCounts
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    histogramOutside
+ * Signature: (JZ)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_histogramOutside
+    (JNIEnv *, jclass, jlong, jboolean);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    quantilesResult
+ * Signature: (J[D)[D
+ */
+JNIEXPORT jdoubleArray JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_quantilesResult
+    (JNIEnv *, jclass, jlong, jdoubleArray);
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    accumulatorDealloc
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_accumulatorDealloc
+    (JNIEnv *, jclass, jlong);
+
+#endif //_ACCUMULATORS_H_
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ARROW_H_
+#define _ARROW_H_
+
+#include <stdint.h>
+
+// Arrow C Data Interface, https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+  // Array type description
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+
+  // Release callback
+  void (*release) (struct ArrowSchema *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+
+struct ArrowArray
+{
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+
+  // Release callback
+  void (*release) (struct ArrowArray *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+
+#endif //ARROW_C_DATA_INTERFACE
+
+/*
+ * Class:     org_jetbrains_numkt_Arrow
+ * Method:    importArrow
+ * Signature: (JJ)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Arrow_importArrow
+    (JNIEnv *, jclass, jlong, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_Arrow
+ * Method:    exportArrow
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;JJ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Arrow_exportArrow
+    (JNIEnv *, jclass, jobject, jlong, jlong);
+
+#endif //_ARROW_H_
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BLAS_H_
+#define _BLAS_H_
+
+/* Returns the LAPACK routine of the loaded BLAS by the name like dgesv, or NULL. */
+void *blas_lapack_function (const char *, int *);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_Blas
+ * Method:    blasApi
+ * Signature: ()Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jetbrains_numkt_linalg_Blas_blasApi
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_Blas
+ * Method:    blasLibrary
+ * Signature: ()Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jetbrains_numkt_linalg_Blas_blasLibrary
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_Blas
+ * Method:    getThreads
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_linalg_Blas_getThreads
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_Blas
+ * Method:    setThreads
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_linalg_Blas_setThreads
+    (JNIEnv *, jclass, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_BatchedMatmul
+ * Method:    matmul
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;I)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_BatchedMatmul_matmul
+    (JNIEnv *, jclass, jobject, jobject, jint);
+
+#endif //_BLAS_H_
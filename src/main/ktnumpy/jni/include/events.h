@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _EVENTS_H_
+#define _EVENTS_H_
+
+#include <stdint.h>
+
+/*
+ * Records of the calls, waits for the GIL and arrays handed to the JVM, while a flight recording is running.
+ * They are kept in a buffer of the thread which made them, and turned into JFR events by Jfr.drain
+ * on that thread after its calls. Times are durations in nanoseconds, JFR events can not be backdated.
+ */
+
+/* Kinds of the records, in the order of Jfr. */
+enum
+{
+  EVENT_CALL = 1,
+  EVENT_GIL_WAIT = 2,
+  EVENT_ARRAY_ALLOC = 3,
+  EVENT_ARRAY_FREE = 4
+};
+
+extern int call_events_enabled;
+
+void events_push_call (uint64_t, uint64_t, uint64_t, uint64_t);
+void events_push_gil_wait (uint64_t);
+void events_push_array (int, PyArrayObject *);
+
+/* PyEval_AcquireThread of the main thread state, timed while recording. */
+void acquire_main_thread (void);
+
+uint64_t gil_wait_begin (void);
+void gil_wait_end (uint64_t);
+
+/* Py_END_ALLOW_THREADS, with the wait for the GIL timed while recording. */
+#define KTNUMPY_END_ALLOW_THREADS                    \
+    {                                                \
+      uint64_t _wait = gil_wait_begin ();            \
+      PyEval_RestoreThread (_save);                  \
+      gil_wait_end (_wait);                          \
+    }                                                \
+  }
+
+/*
+ * Class:     org_jetbrains_numkt_Jfr
+ * Method:    setRecording
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Jfr_setRecording
+    (JNIEnv *, jclass, jboolean);
+
+/*
+ * Class:     org_jetbrains_numkt_Jfr
+ * Method:    drain
+ * Signature: ([J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_Jfr_drain
+    (JNIEnv *, jclass, jlongArray);
+
+#endif //_EVENTS_H_
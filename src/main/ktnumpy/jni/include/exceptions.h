@@ -17,6 +17,44 @@
 #ifndef _EXCEPTIONS_H_
 #define _EXCEPTIONS_H_
 
-int python_exception (JNIEnv *);
+int throw_python_exception (JNIEnv *);
+
+/* Converts a pending python error to NumKtException, the check of the common no error case is inlined. */
+static inline int python_exception (JNIEnv *env)
+{
+  return PyErr_Occurred () == NULL ? 0 : throw_python_exception (env);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NumKtException
+ * Method:    renderMessage
+ * Signature: (J)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jetbrains_numkt_NumKtException_renderMessage
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_NumKtException
+ * Method:    errorType
+ * Signature: (J)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jetbrains_numkt_NumKtException_errorType
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_NumKtException
+ * Method:    pythonStack
+ * Signature: (J)[Ljava/lang/StackTraceElement;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jetbrains_numkt_NumKtException_pythonStack
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_NumKtException
+ * Method:    release
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_NumKtException_release
+    (JNIEnv *, jclass, jlong);
 
 #endif //_EXCEPTIONS_H_
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _FFT_H_
+#define _FFT_H_
+
+/* Transforms of NativeFft, in its order. */
+typedef enum
+{
+  FFT_COMPLEX = 0,
+  FFT_COMPLEX_INVERSE = 1,
+  FFT_REAL = 2,
+  FFT_REAL_INVERSE = 3
+} FftKind;
+
+/* Normalizations of numpy.fft, in the order of Norm. */
+typedef enum
+{
+  FFT_NORM_BACKWARD = 0,
+  FFT_NORM_ORTHO = 1,
+  FFT_NORM_FORWARD = 2
+} FftNorm;
+
+/*
+ * Class:     org_jetbrains_numkt_fft_NativeFft
+ * Method:    transform
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;IIIILorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_fft_NativeFft_transform
+    (JNIEnv *, jclass, jobject, jint, jint, jint, jint, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_fft_NativeFft
+ * Method:    cachedPlans
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_fft_NativeFft_cachedPlans
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_fft_NativeFft
+ * Method:    clearPlans
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_fft_NativeFft_clearPlans
+    (JNIEnv *, jclass);
+
+#endif //_FFT_H_
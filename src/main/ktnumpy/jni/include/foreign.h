@@ -0,0 +1,90 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _FOREIGN_H_
+#define _FOREIGN_H_
+
+#include <stdint.h>
+
+/*
+ * Plain C ABI of the library for the foreign function backend of the JVM, without JNIEnv and Java objects.
+ * Handles and arrays are addresses of Python objects passed as 64-bit integers.
+ */
+
+/* Tags of KtnpValue, in the order of ForeignBridge. */
+enum
+{
+  KTNP_NONE = 0,
+  KTNP_BOOLEAN = 1,
+  KTNP_LONG = 2,
+  KTNP_DOUBLE = 3,
+  KTNP_ARRAY = 4
+};
+
+/* Results of ktnp_call. */
+enum
+{
+  KTNP_ERROR = -1,
+  KTNP_OK = 0,
+  /*
+   * a result other than an ndarray, or an array of more than 2^31 - 1 bytes, was asked as an array,
+   * it is returned as a Python object and wrapped through JNI
+   */
+  KTNP_OBJECT = 1
+};
+
+/* Argument of a call: 16 bytes, the tag followed by the value at offset 8. */
+typedef struct
+{
+  int32_t tag;
+  int32_t unused;
+  union
+  {
+    int64_t l;
+    double d;
+  } value;
+} KtnpValue;
+
+/* Array result of a call, with the memory of its base for views as KtNDArray maps it. */
+typedef struct
+{
+  int64_t array;
+  int64_t data;
+  int64_t nbytes;
+  int64_t offset;
+  int64_t writeable;
+} KtnpArray;
+
+JNIEXPORT int64_t ktnp_lookup (const char *);
+JNIEXPORT int32_t ktnp_call (int64_t, const KtnpValue *, int32_t, int32_t, void *);
+
+/*
+ * Class:     org_jetbrains_numkt_ForeignBridge
+ * Method:    raisePending
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_ForeignBridge_raisePending
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_ForeignBridge
+ * Method:    wrap
+ * Signature: (J)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_ForeignBridge_wrap
+    (JNIEnv *, jclass, jlong);
+
+#endif //_FOREIGN_H_
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _GENERATOR_H_
+#define _GENERATOR_H_
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    generatorNew
+ * Signature: (Ljava/lang/String;Ljava/lang/Long;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_random_KtGenerator_generatorNew
+    (JNIEnv *, jclass, jstring, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    generatorSpawn
+ * Signature: (JI)[J
+ */
+JNIEXPORT jlongArray JNICALL Java_org_jetbrains_numkt_random_KtGenerator_generatorSpawn
+    (JNIEnv *, jobject, jlong, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    generatorJumped
+ * Signature: (JI)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_random_KtGenerator_generatorJumped
+    (JNIEnv *, jobject, jlong, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillRandom
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillRandom
+    (JNIEnv *, jobject, jlong, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillStandardNormal
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillStandardNormal
+    (JNIEnv *, jobject, jlong, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillStandardExponential
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillStandardExponential
+    (JNIEnv *, jobject, jlong, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillIntegers
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;JJ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillIntegers
+    (JNIEnv *, jobject, jlong, jobject, jlong, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillPrimitiveArray
+ * Signature: (JLjava/lang/Object;Ljava/lang/Class;IDDJJZ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillPrimitiveArray
+    (JNIEnv *, jobject, jlong, jobject, jclass, jint, jdouble, jdouble, jlong, jlong, jboolean);
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillDirectBuffer
+ * Signature: (JLjava/nio/Buffer;JJLjava/lang/Class;IDDJJZ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillDirectBuffer
+    (JNIEnv *, jobject, jlong, jobject, jlong, jlong, jclass, jint, jdouble, jdouble, jlong, jlong, jboolean);
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    generatorDealloc
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_generatorDealloc
+    (JNIEnv *, jobject, jlong);
+
+#endif //_GENERATOR_H_
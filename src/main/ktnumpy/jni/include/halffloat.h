@@ -0,0 +1,44 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _HALFFLOAT_H_
+#define _HALFFLOAT_H_
+
+/* IEEE 754 binary16 conversions, rounding to nearest even like numpy's float16 casts. */
+float half_to_float (npy_half);
+npy_half float_to_half (float);
+
+/* Bulk conversions of the float16 arrays, vectorized with F16C on x86-64 and NEON on AArch64. */
+void halves_to_floats (const npy_half *, float *, npy_intp);
+void floats_to_halves (const float *, npy_half *, npy_intp);
+
+/*
+ * Class:     org_jetbrains_numkt_HalfFloats
+ * Method:    widen
+ * Signature: (Ljava/nio/ByteBuffer;I[FI)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_HalfFloats_widen
+    (JNIEnv *, jclass, jobject, jint, jfloatArray, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_HalfFloats
+ * Method:    narrow
+ * Signature: ([FLjava/nio/ByteBuffer;II)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_HalfFloats_narrow
+    (JNIEnv *, jclass, jfloatArray, jobject, jint, jint);
+
+#endif //_HALFFLOAT_H_
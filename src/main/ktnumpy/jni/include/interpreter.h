@@ -10,6 +10,9 @@ extern "C" {
 
 extern PyThreadState *mainThreadState;
 
+/* Runs function with the interpreter held, on its thread or on any other, e.g. of the finalizer. */
+void run_with_interpreter (void (*function) (void *), void *arg);
+
 /*
  * Class:     org_jetbrains_numkt_Interpreter
  * Method:    initializePython
@@ -36,6 +39,30 @@ JNIEXPORT jobject JNICALL
 Java_org_jetbrains_numkt_Interpreter_callFunc_00024kotlin_1numpy___3Ljava_lang_String_2_3Ljava_lang_Object_2Ljava_util_Map_2Ljava_lang_Class_2
     (JNIEnv *, jobject, jobjectArray, jobjectArray, jobject, jclass);
 
+/*
+ * Class:     org_jetbrains_numkt_Interpreter
+ * Method:    callDouble_00024kotlin_numpy
+ * Signature: ([Ljava/lang/String;[Ljava/lang/Object;Ljava/util/Map;)D
+ */
+JNIEXPORT jdouble JNICALL Java_org_jetbrains_numkt_Interpreter_callDouble_00024kotlin_1numpy
+    (JNIEnv *, jobject, jobjectArray, jobjectArray, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_Interpreter
+ * Method:    callLong_00024kotlin_numpy
+ * Signature: ([Ljava/lang/String;[Ljava/lang/Object;Ljava/util/Map;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_Interpreter_callLong_00024kotlin_1numpy
+    (JNIEnv *, jobject, jobjectArray, jobjectArray, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_Interpreter
+ * Method:    callBoolean_00024kotlin_numpy
+ * Signature: ([Ljava/lang/String;[Ljava/lang/Object;Ljava/util/Map;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_Interpreter_callBoolean_00024kotlin_1numpy
+    (JNIEnv *, jobject, jobjectArray, jobjectArray, jobject);
+
 /*
  * Class:     org_jetbrains_numkt_Interpreter
  * Method:    getField_00024kotlin_numpy
@@ -18,5 +18,6 @@
 #define _NUMKTEXCEPTION_H_
 
 jobject numkt_NumKtException_init_string(JNIEnv *, jstring);
+jobject numkt_NumKtException_init_error(JNIEnv *, jlong);
 
 #endif //_NUMKTEXCEPTION_H_
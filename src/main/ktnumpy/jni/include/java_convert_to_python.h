@@ -19,6 +19,23 @@
 #ifndef _JAVA_CONVERT_TO_PYTHON_H_
 #define _JAVA_CONVERT_TO_PYTHON_H_
 
+#define CONVERTER_CACHE_SIZE 4
+
+typedef PyObject *(*jobject_converter) (JNIEnv *, jobject, jclass);
+
+typedef struct
+{
+  jclass class;
+  jobject_converter convert;
+} converter_entry;
+
+/* Converters of the classes most recently seen by one conversion, most recent first. */
+typedef struct
+{
+  int size;
+  converter_entry entries[CONVERTER_CACHE_SIZE];
+} converter_cache;
+
 PyObject *intArray_to_tuple (JNIEnv *, jintArray);
 PyObject *objArray_to_PyArray (JNIEnv *, jobjectArray, PyObject *);
 PyObject *jobject_to_pyobject(JNIEnv *, jobject);
@@ -17,6 +17,8 @@
 #ifndef _KTNUMPY_H_
 #define _KTNUMPY_H_
 
+extern PyObject *npModule;
+
 int ktnumpy_init (JNIEnv *);
 
 int NpyArray_Check (PyObject *);
@@ -49,9 +51,19 @@ jlong get_iterator (JNIEnv *, PyObject *);
 jobject iter_next (JNIEnv *, PyObject *);
 void iter_dealloc (PyObject *);
 
+double pyobject_as_double (PyObject *);
+long long pyobject_as_long (PyObject *);
+int pyobject_as_boolean (PyObject *);
+
 jobject
 invoke_call_function (JNIEnv *, jobjectArray, jobjectArray, jobject);
 jobject
 invoke_call_function_with_class (JNIEnv *, jobjectArray, jobjectArray, jobject, jclass);
+jdouble
+invoke_call_function_double (JNIEnv *, jobjectArray, jobjectArray, jobject);
+jlong
+invoke_call_function_long (JNIEnv *, jobjectArray, jobjectArray, jobject);
+jboolean
+invoke_call_function_boolean (JNIEnv *, jobjectArray, jobjectArray, jobject);
 
 #endif //_KTNUMPY_H_
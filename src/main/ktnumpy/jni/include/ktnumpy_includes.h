@@ -19,6 +19,12 @@
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #include "numpy/arrayobject.h"
 
+// numpy 2 hides the fields of descriptors behind accessors, which numpy 1 lacks
+#if NPY_ABI_VERSION < 0x02000000
+#define PyDataType_ELSIZE(descr) ((descr)->elsize)
+#define PyDataType_GetArrFuncs(descr) ((descr)->f)
+#endif
+
 #include "interpreter.h"
 #include "java_convert_to_python.h"
 #include "python_convert_to_java.h"
@@ -48,5 +54,33 @@
 #include "java_classes/NumKtException.h"
 #include "java_classes/Throwable.h"
 #include "java_classes/Pair.h"
+#include "java_classes/ByteBuffer.h"
+#include "java_classes/UByte.h"
+#include "java_classes/UShort.h"
+#include "java_classes/UInt.h"
+#include "java_classes/ULong.h"
+#include "java_classes/Half.h"
+#include "java_classes/ComplexFloat.h"
+#include "java_classes/ComplexDouble.h"
 #include "KtNDArray.h"
-#include "KtNDIter.h"
\ No newline at end of file
+#include "KtNDIter.h"
+#include "npyio.h"
+#include "threadpool.h"
+#include "textreader.h"
+#include "arrow.h"
+#include "worker.h"
+#include "generator.h"
+#include "neighbors.h"
+#include "spatialtree.h"
+#include "accumulators.h"
+#include "reductions.h"
+#include "sorting.h"
+#include "ufuncs.h"
+#include "blas.h"
+#include "lapack.h"
+#include "smallarrays.h"
+#include "foreign.h"
+#include "halffloat.h"
+#include "fft.h"
+#include "events.h"
+#include "metrics.h"
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LAPACK_H_
+#define _LAPACK_H_
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    lapackLoaded
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_lapackLoaded
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceNew
+ * Signature: (I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceNew
+    (JNIEnv *, jclass, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceSolve
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceSolve
+    (JNIEnv *, jobject, jlong, jobject, jobject, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceInv
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceInv
+    (JNIEnv *, jobject, jlong, jobject, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceDet
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)D
+ */
+JNIEXPORT jdouble JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceDet
+    (JNIEnv *, jobject, jlong, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceCholesky
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceCholesky
+    (JNIEnv *, jobject, jlong, jobject, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceEigh
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)Lkotlin/Pair;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceEigh
+    (JNIEnv *, jobject, jlong, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceDealloc
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceDealloc
+    (JNIEnv *, jobject, jlong);
+
+#endif //_LAPACK_H_
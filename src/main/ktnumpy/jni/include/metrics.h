@@ -0,0 +1,147 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+#include <stdint.h>
+
+/*
+ * Metrics of the calls into numpy by function: calls, latencies and their split into the conversion of
+ * the arguments, the execution and the wrapping of the result, and the bytes of the arrays they allocate.
+ * A call is timed only when the metrics or the flight recording are enabled at its start, otherwise each
+ * mark is a single test. Timed calls are also recorded for the NumpyCall events, see events.h.
+ */
+
+/* Values of a function in CallMetrics.counters, in the order of CallStats. */
+enum
+{
+  CALL_METRICS_CALLS = 0,
+  CALL_METRICS_ERRORS,
+  CALL_METRICS_TOTAL,
+  CALL_METRICS_P50,
+  CALL_METRICS_P99,
+  CALL_METRICS_CONVERT,
+  CALL_METRICS_EXECUTE,
+  CALL_METRICS_WRAP,
+  CALL_METRICS_BYTES,
+  CALL_METRICS_FIELDS
+};
+
+/* A call in progress, start is 0 for calls which are not timed. */
+typedef struct
+{
+  int function;
+  uint64_t start;
+  uint64_t converted;
+  uint64_t executed;
+  uint64_t bytes;
+} CallTiming;
+
+extern int call_metrics_enabled;
+
+uint64_t call_metrics_now (void);
+
+int call_metrics_register (PyObject *, const char *);
+
+void call_metrics_record_converted (JNIEnv *, CallTiming *, jobjectArray, PyObject *, PyObject *);
+void call_metrics_record (CallTiming *, int);
+
+static inline void call_metrics_begin (CallTiming *timing)
+{
+  timing->function = -1;
+  timing->bytes = 0;
+  timing->converted = 0;
+  timing->executed = 0;
+  timing->start = call_metrics_enabled || call_events_enabled ? call_metrics_now () : 0;
+}
+
+/*
+ * The function is resolved and its arguments are converted. Names are the path of the function in numpy
+ * to register it under, NULL for the functions registered by ktnp_lookup.
+ */
+static inline void call_metrics_converted (JNIEnv *env, CallTiming *timing, jobjectArray names,
+                                           PyObject *function, PyObject *args)
+{
+  if (timing->start != 0)
+    {
+      call_metrics_record_converted (env, timing, names, function, args);
+    }
+}
+
+/* The function returned result, NULL on an error. */
+static inline void call_metrics_executed (CallTiming *timing, PyObject *result)
+{
+  if (timing->start != 0)
+    {
+      timing->executed = call_metrics_now ();
+      if (result != NULL && PyArray_Check (result) && PyArray_CHKFLAGS ((PyArrayObject *) result, NPY_ARRAY_OWNDATA))
+        {
+          timing->bytes += PyArray_NBYTES ((PyArrayObject *) result);
+        }
+    }
+}
+
+/* The result is wrapped for Java, or the call failed. */
+static inline void call_metrics_end (CallTiming *timing, int ok)
+{
+  if (timing->start != 0)
+    {
+      call_metrics_record (timing, ok);
+    }
+}
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    isEnabled
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_CallMetrics_isEnabled
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    setEnabled
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_CallMetrics_setEnabled
+    (JNIEnv *, jclass, jboolean);
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    functions
+ * Signature: ()[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jetbrains_numkt_CallMetrics_functions
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    counters
+ * Signature: ()[J
+ */
+JNIEXPORT jlongArray JNICALL Java_org_jetbrains_numkt_CallMetrics_counters
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    clear
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_CallMetrics_clear
+    (JNIEnv *, jclass);
+
+#endif //_METRICS_H_
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _NEIGHBORS_H_
+#define _NEIGHBORS_H_
+
+/*
+ * Max-heaps of the k nearest candidates, ordered by distance and then by index.
+ * Offer returns the new size of the heap, sort leaves the candidates nearest first.
+ */
+npy_intp neighbors_heap_offer (double *, npy_int64 *, npy_intp, npy_intp, double, npy_int64);
+void neighbors_heap_make (double *, npy_int64 *, npy_intp);
+void neighbors_heap_sort (double *, npy_int64 *, npy_intp);
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    pairwiseDistances
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Ljava/lang/String;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_pairwiseDistances
+    (JNIEnv *, jclass, jobject, jobject, jstring);
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    knn
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Ljava/lang/String;Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_knn
+    (JNIEnv *, jclass, jobject, jobject, jstring, jobject, jobject);
+
+#endif //_NEIGHBORS_H_
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _NPYIO_H_
+#define _NPYIO_H_
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    mmapNpy
+ * Signature: (Ljava/lang/String;Ljava/lang/String;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_NpyIO_mmapNpy
+    (JNIEnv *, jclass, jstring, jstring);
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    mmapNpz
+ * Signature: (Ljava/lang/String;Ljava/lang/String;)[Ljava/lang/Object;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jetbrains_numkt_NpyIO_mmapNpz
+    (JNIEnv *, jclass, jstring, jstring);
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    savez
+ * Signature: (Ljava/lang/String;[Ljava/lang/String;[Lorg/jetbrains/numkt/core/KtNDArray;Z)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_NpyIO_savez
+    (JNIEnv *, jclass, jstring, jobjectArray, jobjectArray, jboolean);
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    shmCreate
+ * Signature: (Ljava/lang/String;[ILjava/lang/Class;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_NpyIO_shmCreate
+    (JNIEnv *, jclass, jstring, jintArray, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    shmAttach
+ * Signature: (Ljava/lang/String;Ljava/lang/String;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_NpyIO_shmAttach
+    (JNIEnv *, jclass, jstring, jstring);
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    shmUnlink
+ * Signature: (Ljava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_NpyIO_shmUnlink
+    (JNIEnv *, jclass, jstring);
+
+#endif //_NPYIO_H_
@@ -42,6 +42,10 @@
 #define FILE_SEP               '/'
 #endif // WIN
 
+#if defined(__unix__) || defined(__APPLE__)
+#define KTNUMPY_POSIX
+#endif
+
 /* Default number local references - 16 (PushLocalFrame)*/
 #define JLOCAL_REFS 16
 
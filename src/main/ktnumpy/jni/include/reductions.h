@@ -0,0 +1,36 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _REDUCTIONS_H_
+#define _REDUCTIONS_H_
+
+/*
+ * Class:     org_jetbrains_numkt_Reductions
+ * Method:    reduceAll
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;IILjava/lang/Class;)Ljava/lang/Object;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Reductions_reduceAll
+    (JNIEnv *, jclass, jobject, jint, jint, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_Reductions
+ * Method:    reduceAxis
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;III)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Reductions_reduceAxis
+    (JNIEnv *, jclass, jobject, jint, jint, jint);
+
+#endif //_REDUCTIONS_H_
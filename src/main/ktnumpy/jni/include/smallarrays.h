@@ -0,0 +1,48 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _SMALLARRAYS_H_
+#define _SMALLARRAYS_H_
+
+/* Element types of the small-array kernels of the JVM, in the order of SmallArrays. */
+typedef enum
+{
+  SMALL_NONE = -1,
+  SMALL_DOUBLE = 0,
+  SMALL_FLOAT = 1,
+  SMALL_LONG = 2,
+  SMALL_INT = 3
+} SmallKind;
+
+jintArray get_layout (JNIEnv *, PyArrayObject *);
+
+/*
+ * Class:     org_jetbrains_numkt_SmallArrays
+ * Method:    newLike
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_SmallArrays_newLike
+    (JNIEnv *, jclass, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_SmallArrays
+ * Method:    newShaped
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;[I)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_SmallArrays_newShaped
+    (JNIEnv *, jclass, jobject, jintArray);
+
+#endif //_SMALLARRAYS_H_
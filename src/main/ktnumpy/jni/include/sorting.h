@@ -0,0 +1,44 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _SORTING_H_
+#define _SORTING_H_
+
+/*
+ * Class:     org_jetbrains_numkt_Sorting
+ * Method:    sortAxis
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;I)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Sorting_sortAxis
+    (JNIEnv *, jclass, jobject, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_Sorting
+ * Method:    argSortAxis
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;I)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Sorting_argSortAxis
+    (JNIEnv *, jclass, jobject, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_Sorting
+ * Method:    selectTopK
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;IIZ)Lkotlin/Pair;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Sorting_selectTopK
+    (JNIEnv *, jclass, jobject, jint, jint, jboolean);
+
+#endif //_SORTING_H_
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _SPATIALTREE_H_
+#define _SPATIALTREE_H_
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeBuild
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;II)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeBuild
+    (JNIEnv *, jclass, jobject, jint, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeSave
+ * Signature: (JLjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeSave
+    (JNIEnv *, jclass, jlong, jstring);
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeOpen
+ * Signature: (Ljava/lang/String;Z)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeOpen
+    (JNIEnv *, jclass, jstring, jboolean);
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeKind
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeKind
+    (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeQuery
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeQuery
+    (JNIEnv *, jclass, jlong, jobject, jobject, jobject);
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeQueryRadius
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;D)[Ljava/lang/Object;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeQueryRadius
+    (JNIEnv *, jclass, jlong, jobject, jdouble);
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeDealloc
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeDealloc
+    (JNIEnv *, jclass, jlong);
+
+#endif //_SPATIALTREE_H_
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TEXTREADER_H_
+#define _TEXTREADER_H_
+
+/*
+ * Class:     org_jetbrains_numkt_TextReader
+ * Method:    readerOpen
+ * Signature: (Ljava/lang/String;CCI[I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_TextReader_readerOpen
+    (JNIEnv *, jobject, jstring, jchar, jchar, jint, jintArray);
+
+/*
+ * Class:     org_jetbrains_numkt_TextReader
+ * Method:    readerColumns
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_TextReader_readerColumns
+    (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     org_jetbrains_numkt_TextReader
+ * Method:    readerRead
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;I)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_TextReader_readerRead
+    (JNIEnv *, jobject, jlong, jobject, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_TextReader
+ * Method:    readerClose
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_TextReader_readerClose
+    (JNIEnv *, jobject, jlong);
+
+#endif //_TEXTREADER_H_
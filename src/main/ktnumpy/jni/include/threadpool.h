@@ -0,0 +1,65 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platforms.h"
+
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+/* Processes [begin, end) of the range given to thread_pool_parallel_for. */
+typedef void (*thread_pool_task) (void *, Py_ssize_t, Py_ssize_t);
+
+int thread_pool_get_threads (void);
+void thread_pool_set_threads (int);
+
+int thread_pool_get_affinity (void);
+void thread_pool_set_affinity (int);
+
+void thread_pool_parallel_for (Py_ssize_t, Py_ssize_t, thread_pool_task, void *);
+
+/*
+ * Class:     org_jetbrains_numkt_Parallel
+ * Method:    getThreads
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_Parallel_getThreads
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_Parallel
+ * Method:    setThreads
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Parallel_setThreads
+    (JNIEnv *, jclass, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_Parallel
+ * Method:    getAffinity
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_Parallel_getAffinity
+    (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jetbrains_numkt_Parallel
+ * Method:    setAffinity
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Parallel_setAffinity
+    (JNIEnv *, jclass, jboolean);
+
+#endif //_THREAD_POOL_H_
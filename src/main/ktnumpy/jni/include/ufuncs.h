@@ -0,0 +1,28 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _UFUNCS_H_
+#define _UFUNCS_H_
+
+/*
+ * Class:     org_jetbrains_numkt_Ufuncs
+ * Method:    callUfunc
+ * Signature: (Ljava/lang/String;[Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Z)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Ufuncs_callUfunc
+    (JNIEnv *, jclass, jstring, jobjectArray, jobject, jboolean);
+
+#endif //_UFUNCS_H_
@@ -22,6 +22,13 @@
 #define JNI_METHOD(var, env, type, name, sig)\
   ((var) || ((var) = (*(env))-> GetMethodID(env, type, name, sig)))
 
+/* numpy C-API table is static in each translation unit, import it once before the first use */
+#define NPY_IMPORT_ONCE(ret)\
+  if (PyArray_API == NULL)\
+    {\
+      import_array1 (ret);\
+    }
+
 #define JAVA_CLASS_TABLE(F)                                   \
   F(OBJECT_TYPE, "java/lang/Object")                          \
   F(CLASS_TYPE, "java/lang/Class")                            \
@@ -46,21 +53,98 @@
   F(NONE_TYPE, "org/jetbrains/numkt/core/None")                             \
   F(NUMKTEXCEPTION_TYPE, "org/jetbrains/numkt/NumKtException")              \
   F(THROWABLE_TYPE, "java/lang/Throwable")                    \
+  F(ILLEGAL_ARGUMENT_TYPE, "java/lang/IllegalArgumentException") \
   F(STACK_TRACE_ELEMENT_TYPE, "java/lang/StackTraceElement")  \
   F(PAIR_TYPE, "kotlin/Pair")                                 \
+  F(BYTEBUFFER_TYPE, "java/nio/ByteBuffer")                   \
+  F(UBYTE_TYPE, "kotlin/UByte")                               \
+  F(USHORT_TYPE, "kotlin/UShort")                             \
+  F(UINT_TYPE, "kotlin/UInt")                                 \
+  F(ULONG_TYPE, "kotlin/ULong")                               \
+  F(HALF_TYPE, "org/jetbrains/numkt/core/Half")               \
+  F(COMPLEX_FLOAT_TYPE, "org/jetbrains/numkt/core/ComplexFloat")            \
+  F(COMPLEX_DOUBLE_TYPE, "org/jetbrains/numkt/core/ComplexDouble")          \
 
 #define DEFINE_JAVA_CLASS_GLOBAL(var, name) extern jclass var;
 JAVA_CLASS_TABLE(DEFINE_JAVA_CLASS_GLOBAL)
 
-#define PYTHON_DTYPE(F)     \
-  F(NP_INT8, "int8")        \
-  F(NP_INT16, "int16")      \
-  F(NP_INT32, "int32")      \
-  F(NP_INT64, "int64")      \
-  F(NP_FLOAT32, "float32")  \
-  F(NP_FLOAT64, "float64")  \
-  F(NP_BOOL, "bool")        \
-  F(NP_UNICODE, "unicode")  \
+/* Method IDs of the java and kotlin types, resolved once at startup with the classes, see cache_java_methods. */
+#define JAVA_METHOD_TABLE(F)                                                                        \
+  F(ARRAYLIST_INIT_ID, ARRAYLIST_TYPE, "<init>", "(I)V")                                            \
+  F(BOOLEAN_INIT_ID, BOOLEAN_TYPE, "<init>", "(Z)V")                                                \
+  F(BOOLEAN_BOOLEAN_VALUE_ID, BOOLEAN_TYPE, "booleanValue", "()Z")                                  \
+  F(BYTE_INIT_ID, BYTE_TYPE, "<init>", "(B)V")                                                      \
+  F(BYTEBUFFER_AS_READ_ONLY_BUFFER_ID, BYTEBUFFER_TYPE, "asReadOnlyBuffer", "()Ljava/nio/ByteBuffer;") \
+  F(CHAR_INIT_ID, CHAR_TYPE, "<init>", "(C)V")                                                      \
+  F(CHAR_CHAR_VALUE_ID, CHAR_TYPE, "charValue", "()C")                                              \
+  F(CLASS_GET_COMPONENT_TYPE_ID, CLASS_TYPE, "getComponentType", "()Ljava/lang/Class;")             \
+  F(CLASS_IS_ARRAY_ID, CLASS_TYPE, "isArray", "()Z")                                                \
+  F(COLLECTION_SIZE_ID, COLLECTION_TYPE, "size", "()I")                                             \
+  F(DOUBLE_INIT_ID, DOUBLE_TYPE, "<init>", "(D)V")                                                  \
+  F(FLOAT_INIT_ID, FLOAT_TYPE, "<init>", "(F)V")                                                    \
+  F(INT_INIT_ID, INT_TYPE, "<init>", "(I)V")                                                        \
+  F(LIST_GET_ID, LIST_TYPE, "get", "(I)Ljava/lang/Object;")                                         \
+  F(LIST_ADD_ID, LIST_TYPE, "add", "(Ljava/lang/Object;)Z")                                         \
+  F(LONG_INIT_ID, LONG_TYPE, "<init>", "(J)V")                                                      \
+  F(MAP_CONTAINS_KEY_ID, MAP_TYPE, "containsKey", "(Ljava/lang/Object;)Z")                          \
+  F(MAP_GET_ID, MAP_TYPE, "get", "(Ljava/lang/Object;)Ljava/lang/Object;")                          \
+  F(NUMKTEXCEPTION_INIT_STRING_ID, NUMKTEXCEPTION_TYPE, "<init>", "(Ljava/lang/String;)V")          \
+  F(NUMKTEXCEPTION_INIT_ERROR_ID, NUMKTEXCEPTION_TYPE, "<init>", "(J)V")                            \
+  F(NUMBER_BYTE_VALUE_ID, NUMBER_TYPE, "byteValue", "()B")                                          \
+  F(NUMBER_SHORT_VALUE_ID, NUMBER_TYPE, "shortValue", "()S")                                        \
+  F(NUMBER_INT_VALUE_ID, NUMBER_TYPE, "intValue", "()I")                                            \
+  F(NUMBER_LONG_VALUE_ID, NUMBER_TYPE, "longValue", "()J")                                          \
+  F(NUMBER_FLOAT_VALUE_ID, NUMBER_TYPE, "floatValue", "()F")                                        \
+  F(NUMBER_DOUBLE_VALUE_ID, NUMBER_TYPE, "doubleValue", "()D")                                      \
+  F(PAIR_INIT_ID, PAIR_TYPE, "<init>", "(Ljava/lang/Object;Ljava/lang/Object;)V")                   \
+  F(PAIR_GET_FIRST_ID, PAIR_TYPE, "getFirst", "()Ljava/lang/Object;")                               \
+  F(PAIR_GET_SECOND_ID, PAIR_TYPE, "getSecond", "()Ljava/lang/Object;")                             \
+  F(SHORT_INIT_ID, SHORT_TYPE, "<init>", "(S)V")                                                    \
+  F(SLICE_GET_START_ID, SLICE_TYPE, "getStart", "()Ljava/lang/Integer;")                            \
+  F(SLICE_GET_STOP_ID, SLICE_TYPE, "getStop", "()Ljava/lang/Integer;")                              \
+  F(SLICE_GET_STEP_ID, SLICE_TYPE, "getStep", "()Ljava/lang/Integer;")                              \
+  F(STACK_TRACE_ELEMENT_INIT_ID, STACK_TRACE_ELEMENT_TYPE, "<init>", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;I)V") \
+  F(THROWABLE_GET_STACK_TRACE_ID, THROWABLE_TYPE, "getStackTrace", "()[Ljava/lang/StackTraceElement;") \
+  F(THROWABLE_SET_STACK_TRACE_ID, THROWABLE_TYPE, "setStackTrace", "([Ljava/lang/StackTraceElement;)V") \
+  F(KTNDARRAY_INIT_ID, KTNDARRAY_TYPE, "<init>", "(JLjava/nio/ByteBuffer;Ljava/lang/Object;J)V")    \
+  F(KTNDARRAY_GET_POINTER_ID, KTNDARRAY_TYPE, "getPointer", "()J")                                  \
+  F(KTNDARRAY_GET_SCALAR_ID, KTNDARRAY_TYPE, "getScalar", "()Ljava/lang/Object;")                   \
+  F(UBYTE_INIT_ID, UBYTE_TYPE, "<init>", "(B)V")                                                    \
+  F(UBYTE_UNBOX_ID, UBYTE_TYPE, "unbox-impl", "()B")                                                \
+  F(USHORT_INIT_ID, USHORT_TYPE, "<init>", "(S)V")                                                  \
+  F(USHORT_UNBOX_ID, USHORT_TYPE, "unbox-impl", "()S")                                              \
+  F(UINT_INIT_ID, UINT_TYPE, "<init>", "(I)V")                                                      \
+  F(UINT_UNBOX_ID, UINT_TYPE, "unbox-impl", "()I")                                                  \
+  F(ULONG_INIT_ID, ULONG_TYPE, "<init>", "(J)V")                                                    \
+  F(ULONG_UNBOX_ID, ULONG_TYPE, "unbox-impl", "()J")                                                \
+  F(HALF_INIT_ID, HALF_TYPE, "<init>", "(S)V")                                                      \
+  F(HALF_GET_BITS_ID, HALF_TYPE, "getBits", "()S")                                                  \
+  F(COMPLEX_FLOAT_INIT_ID, COMPLEX_FLOAT_TYPE, "<init>", "(FF)V")                                   \
+  F(COMPLEX_FLOAT_GET_RE_ID, COMPLEX_FLOAT_TYPE, "getRe", "()F")                                    \
+  F(COMPLEX_FLOAT_GET_IM_ID, COMPLEX_FLOAT_TYPE, "getIm", "()F")                                    \
+  F(COMPLEX_DOUBLE_INIT_ID, COMPLEX_DOUBLE_TYPE, "<init>", "(DD)V")                                 \
+  F(COMPLEX_DOUBLE_GET_RE_ID, COMPLEX_DOUBLE_TYPE, "getRe", "()D")                                  \
+  F(COMPLEX_DOUBLE_GET_IM_ID, COMPLEX_DOUBLE_TYPE, "getIm", "()D")                                  \
+
+#define DEFINE_JAVA_METHOD_GLOBAL(var, type, name, sig) extern jmethodID var;
+JAVA_METHOD_TABLE(DEFINE_JAVA_METHOD_GLOBAL)
+
+#define PYTHON_DTYPE(F)          \
+  F(NP_INT8, "int8")             \
+  F(NP_INT16, "int16")           \
+  F(NP_INT32, "int32")           \
+  F(NP_INT64, "int64")           \
+  F(NP_FLOAT32, "float32")       \
+  F(NP_FLOAT64, "float64")       \
+  F(NP_BOOL, "bool")             \
+  F(NP_UNICODE, "unicode")       \
+  F(NP_FLOAT16, "float16")       \
+  F(NP_UINT8, "uint8")           \
+  F(NP_UINT16, "uint16")         \
+  F(NP_UINT32, "uint32")         \
+  F(NP_UINT64, "uint64")         \
+  F(NP_COMPLEX64, "complex64")   \
+  F(NP_COMPLEX128, "complex128") \
 
 #define DEFINE_PYTHON_DTYPE(var, name) extern PyObject *(var);
 PYTHON_DTYPE (DEFINE_PYTHON_DTYPE)
@@ -87,7 +171,9 @@ const char *jstring_to_char (JNIEnv *, jstring);
 void release_utf_char (JNIEnv *, jstring, const char *);
 PyObject *jclass_to_dtype (JNIEnv *, jclass jcl);
 int cache_java_class (JNIEnv *);
+int cache_java_methods (JNIEnv *);
 int cache_primitive_jarrays (JNIEnv *);
 int cache_python_dtype (PyObject *);
+int register_natives (JNIEnv *, jclass, const JNINativeMethod *, jint);
 
 #endif //_UTIL_H_
\ No newline at end of file
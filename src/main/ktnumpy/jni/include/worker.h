@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _WORKER_H_
+#define _WORKER_H_
+
+/*
+ * Class:     org_jetbrains_numkt_WorkerSocket
+ * Method:    connect
+ * Signature: (Ljava/lang/String;)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_WorkerSocket_connect
+    (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jetbrains_numkt_WorkerSocket
+ * Method:    send
+ * Signature: (I[B)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_WorkerSocket_send
+    (JNIEnv *, jclass, jint, jbyteArray);
+
+/*
+ * Class:     org_jetbrains_numkt_WorkerSocket
+ * Method:    receive
+ * Signature: (I)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_org_jetbrains_numkt_WorkerSocket_receive
+    (JNIEnv *, jclass, jint);
+
+/*
+ * Class:     org_jetbrains_numkt_WorkerSocket
+ * Method:    close
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_WorkerSocket_close
+    (JNIEnv *, jclass, jint);
+
+#endif //_WORKER_H_
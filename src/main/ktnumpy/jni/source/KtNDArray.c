@@ -16,41 +16,45 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newKtNDArrayID = 0;
-static jmethodID getPointerID = 0;
-static jmethodID getScalarID = 0;
-
 jobject new_ktndarray (JNIEnv *env, PyArrayObject *nparray, jobject scalar)
 {
   jobject jbytebuffer = NULL;
   jobject ktndarray = NULL;
   jlong p = 0;
 
-  if (!JNI_METHOD(newKtNDArrayID, env, KTNDARRAY_TYPE, "<init>", "(JLjava/nio/ByteBuffer;Ljava/lang/Object;J)V"))
+  if (!JNI_METHOD(KTNDARRAY_INIT_ID, env, KTNDARRAY_TYPE, "<init>", "(JLjava/nio/ByteBuffer;Ljava/lang/Object;J)V"))
     {
       return NULL;
     }
 
   if (nparray)
     {
-      if (NpyView_Check (nparray))
+      PyArrayObject *owner = NpyView_Check (nparray) ? (PyArrayObject *) PyArray_BASE (nparray) : nparray;
+
+      jbytebuffer = get_bytebuffer (env, owner);
+      if (owner != nparray)
         {
-          jbytebuffer = get_bytebuffer (env, (PyArrayObject *) PyArray_BASE (nparray));
           p = get_point (nparray);
         }
-      else
+
+      // the reference is stolen even when the array cannot be wrapped
+      if (jbytebuffer == NULL && (*env)->ExceptionCheck (env))
         {
-          jbytebuffer = get_bytebuffer (env, nparray);
+          Py_DECREF (nparray);
+          return NULL;
         }
-
-      if (jbytebuffer == NULL)
+      if (jbytebuffer == NULL && PyArray_NBYTES (owner) <= INT32_MAX)
         {
           printf ("Error jbytebuffer");
           exit (-1);
         }
+      if (call_events_enabled && PyArray_CHKFLAGS (nparray, NPY_ARRAY_OWNDATA))
+        {
+          events_push_array (EVENT_ARRAY_ALLOC, nparray);
+        }
     }
 
-  ktndarray = (*env)->NewObject (env, KTNDARRAY_TYPE, newKtNDArrayID, (jlong) nparray, jbytebuffer, scalar, p);
+  ktndarray = (*env)->NewObject (env, KTNDARRAY_TYPE, KTNDARRAY_INIT_ID, (jlong) nparray, jbytebuffer, scalar, p);
   if (ktndarray == NULL)
     {
       printf ("Error to create new KtNDArray!\n");
@@ -62,18 +66,107 @@ jobject new_ktndarray (JNIEnv *env, PyArrayObject *nparray, jobject scalar)
 
 PyArrayObject *numkt_core_KtNDArray_getPointer (JNIEnv *env, jobject ktndarray)
 {
-  if (!JNI_METHOD(getPointerID, env, KTNDARRAY_TYPE, "getPointer", "()J"))
+  if (!JNI_METHOD(KTNDARRAY_GET_POINTER_ID, env, KTNDARRAY_TYPE, "getPointer", "()J"))
     {
       return NULL;
     }
-  return (PyArrayObject *) (*env)->CallLongMethod (env, ktndarray, getPointerID);
+  return (PyArrayObject *) (*env)->CallLongMethod (env, ktndarray, KTNDARRAY_GET_POINTER_ID);
 }
 
 jobject numkt_core_KtNDArray_getScalar (JNIEnv *env, jobject ktndarray)
 {
-  if (!JNI_METHOD (getScalarID, env, KTNDARRAY_TYPE, "getScalar", "()Ljava/lang/Object;"))
+  if (!JNI_METHOD (KTNDARRAY_GET_SCALAR_ID, env, KTNDARRAY_TYPE, "getScalar", "()Ljava/lang/Object;"))
     {
       return NULL;
     }
-  return (*env)->CallObjectMethod (env, ktndarray, getScalarID);
-}
\ No newline at end of file
+  return (*env)->CallObjectMethod (env, ktndarray, KTNDARRAY_GET_SCALAR_ID);
+}
+
+/* PyArray_SIZE goes through the C-API table, the dimensions are read directly */
+static jlong array_size (PyArrayObject *arr)
+{
+  jlong size = 1;
+  for (int i = 0; i < PyArray_NDIM (arr); ++i)
+    {
+      size *= PyArray_DIM (arr, i);
+    }
+  return size;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    ndimGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDArray_ndimGetCritical
+    (JNIEnv *env, jclass jclazz, jlong ptr)
+{
+  return PyArray_NDIM ((PyArrayObject *) ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    ndimGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDArray_ndimGetCritical
+    (jlong ptr)
+{
+  return PyArray_NDIM ((PyArrayObject *) ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    itemsizeGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDArray_itemsizeGetCritical
+    (JNIEnv *env, jclass jclazz, jlong ptr)
+{
+  return (jint) PyArray_ITEMSIZE ((PyArrayObject *) ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    itemsizeGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDArray_itemsizeGetCritical
+    (jlong ptr)
+{
+  return (jint) PyArray_ITEMSIZE ((PyArrayObject *) ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    sizeGetCritical
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_core_KtNDArray_sizeGetCritical
+    (JNIEnv *env, jclass jclazz, jlong ptr)
+{
+  return array_size ((PyArrayObject *) ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDArray
+ * Method:    sizeGetCritical
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDArray_sizeGetCritical
+    (jlong ptr)
+{
+  return array_size ((PyArrayObject *) ptr);
+}
+
+static JNINativeMethod ktndarray_natives[] = {
+    {"ndimGetCritical", "(J)I", (void *) Java_org_jetbrains_numkt_core_KtNDArray_ndimGetCritical},
+    {"itemsizeGetCritical", "(J)I", (void *) Java_org_jetbrains_numkt_core_KtNDArray_itemsizeGetCritical},
+    {"sizeGetCritical", "(J)J", (void *) Java_org_jetbrains_numkt_core_KtNDArray_sizeGetCritical},
+};
+
+int register_ktndarray_natives (JNIEnv *env)
+{
+  return register_natives (env, KTNDARRAY_TYPE, ktndarray_natives,
+                           sizeof (ktndarray_natives) / sizeof (ktndarray_natives[0]));
+}
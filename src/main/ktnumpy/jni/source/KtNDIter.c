@@ -196,7 +196,7 @@ JNIEXPORT void JNICALL Java_org_jetbrains_numkt_core_KtNDIter_dealloc
     (JNIEnv *env, jobject jobj, jlong ptr)
 {
   KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
-  PyEval_AcquireThread (mainThreadState);
+  acquire_main_thread ();
   if (this->iter)
     {
       NpyIter_Deallocate (this->iter);
@@ -245,26 +245,6 @@ JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterReset
   return 1;
 }
 
-/*
- * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    iterNextC
- * Signature: (J)Z
- */
-JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterNextC
-    (JNIEnv *env, jobject jobj, jlong ptr)
-{
-  KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
-  if (this->iter != NULL && this->iternext != NULL && !this->finished && this->iternext (this->iter))
-    {
-      return 1;
-    }
-  else
-    {
-      this->finished = 1;
-      return 0;
-    }
-}
-
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
  * Method:    iterRemoveAxis
@@ -569,34 +549,6 @@ JNIEXPORT void JNICALL Java_org_jetbrains_numkt_core_KtNDIter_multiIndexSet
     }
 }
 
-/*
- * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    indexGet
- * Signature: (J)I
- */
-JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_indexGet
-    (JNIEnv *env, jobject jobj, jlong ptr)
-{
-  KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
-
-  if (this->iter == NULL || this->finished)
-    {
-      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Iterator is past the end");
-      return -1;
-    }
-
-  if (NpyIter_HasIndex (this->iter))
-    {
-      npy_intp ind = *NpyIter_GetIndexPtr (this->iter);
-      return ind;
-    }
-  else
-    {
-      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Iterator does not have an index");
-      return -1;
-    }
-}
-
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
  * Method:    indexSet
@@ -631,24 +583,6 @@ JNIEXPORT void JNICALL Java_org_jetbrains_numkt_core_KtNDIter_indexSet
     }
 }
 
-/*
- * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    iterIndexGet
- * Signature: (J)I
- */
-JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterIndexGet
-    (JNIEnv *env, jobject jobj, jlong ptr)
-{
-  KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
-  if (this->iter == NULL || this->finished)
-    {
-      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Iterator is past the end");
-      return -1;
-    }
-
-  return NpyIter_GetIterIndex (this->iter);
-}
-
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
  * Method:    iterIndexSet
@@ -742,42 +676,178 @@ JNIEXPORT void JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterRangeSet
 
 }
 
+static jboolean iter_step (jlong ptr)
+{
+  KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
+  if (this->iter != NULL && this->iternext != NULL && !this->finished && this->iternext (this->iter))
+    {
+      return 1;
+    }
+  else
+    {
+      this->finished = 1;
+      return 0;
+    }
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterNextCritical
+ * Signature: (J)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterNextCritical
+    (JNIEnv *env, jclass jobj_clazz, jlong ptr)
+{
+  return iter_step (ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterNextCritical
+ * Signature: (J)Z
+ */
+JNIEXPORT jboolean JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_iterNextCritical
+    (jlong ptr)
+{
+  return iter_step (ptr);
+}
+
+/* -1 if the iterator is past the end or has no index, the caller throws */
+static jint index_get (jlong ptr)
+{
+  KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
+  if (this->iter == NULL || this->finished || !NpyIter_HasIndex (this->iter))
+    {
+      return -1;
+    }
+
+  return *NpyIter_GetIndexPtr (this->iter);
+}
+
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    ndimGet
+ * Method:    indexGetCritical
  * Signature: (J)I
  */
-JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_ndimGet
-    (JNIEnv *env, jobject jobj, jlong ptr)
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_indexGetCritical
+    (JNIEnv *env, jclass jobj_clazz, jlong ptr)
+{
+  return index_get (ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    indexGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_indexGetCritical
+    (jlong ptr)
+{
+  return index_get (ptr);
+}
+
+/* -1 if the iterator is past the end */
+static jint iter_index_get (jlong ptr)
 {
   KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
-  if (this->iter == NULL)
+  if (this->iter == NULL || this->finished)
     {
-      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Iterator is invalid");
-      return 0;
+      return -1;
     }
 
-  return NpyIter_GetNDim (this->iter);
+  return NpyIter_GetIterIndex (this->iter);
 }
 
 /*
  * Class:     org_jetbrains_numkt_core_KtNDIter
- * Method:    iterSizeGet
+ * Method:    iterIndexGetCritical
  * Signature: (J)I
  */
-JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterSizeGet
-    (JNIEnv *env, jobject jobj, jlong ptr)
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterIndexGetCritical
+    (JNIEnv *env, jclass jobj_clazz, jlong ptr)
+{
+  return iter_index_get (ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterIndexGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_iterIndexGetCritical
+    (jlong ptr)
+{
+  return iter_index_get (ptr);
+}
+
+/* -1 if the iterator is invalid */
+static jint iter_size_get (jlong ptr)
 {
   KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
   if (this->iter == NULL)
     {
-      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Iterator is invalid");
-      return 0;
+      return -1;
     }
 
   return NpyIter_GetIterSize (this->iter);
 }
 
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterSizeGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_iterSizeGetCritical
+    (JNIEnv *env, jclass jobj_clazz, jlong ptr)
+{
+  return iter_size_get (ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    iterSizeGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_iterSizeGetCritical
+    (jlong ptr)
+{
+  return iter_size_get (ptr);
+}
+
+/* -1 if the iterator is invalid */
+static jint ndim_get (jlong ptr)
+{
+  KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
+  if (this->iter == NULL)
+    {
+      return -1;
+    }
+
+  return NpyIter_GetNDim (this->iter);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    ndimGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_core_KtNDIter_ndimGetCritical
+    (JNIEnv *env, jclass jobj_clazz, jlong ptr)
+{
+  return ndim_get (ptr);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_core_KtNDIter
+ * Method:    ndimGetCritical
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL JavaCritical_org_jetbrains_numkt_core_KtNDIter_ndimGetCritical
+    (jlong ptr)
+{
+  return ndim_get (ptr);
+}
+
 static int finished (long ptr)
 {
   KtNpyArrayIterObject *this = (KtNpyArrayIterObject *) ptr;
@@ -922,3 +992,36 @@ jobject ktnditer_seq_item (JNIEnv *env, KtNpyArrayIterObject *this, size_t i)
   Py_INCREF (dtype);
   return ret;
 }
+
+/* Natives of KtNDIter bound at startup instead of by symbol name. JavaCritical_ entries are still found by name. */
+static JNINativeMethod ktnditer_natives[] = {
+    {"iterNew", "(Lorg/jetbrains/numkt/core/KtNDArray;[Ljava/lang/String;Ljava/lang/String;)J",
+     (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterNew},
+    {"indexSet", "(JI)V", (void *) Java_org_jetbrains_numkt_core_KtNDIter_indexSet},
+    {"iterIndexSet", "(JI)V", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterIndexSet},
+    {"multiIndexGet", "(J)[I", (void *) Java_org_jetbrains_numkt_core_KtNDIter_multiIndexGet},
+    {"multiIndexSet", "(J[I)V", (void *) Java_org_jetbrains_numkt_core_KtNDIter_multiIndexSet},
+    {"iterRangeGet", "(J)Lkotlin/Pair;", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterRangeGet},
+    {"iterRangeSet", "(JLkotlin/Pair;)V", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterRangeSet},
+    {"shapeGet", "(J)[I", (void *) Java_org_jetbrains_numkt_core_KtNDIter_shapeGet},
+    {"valueGet", "(J)Ljava/lang/Object;", (void *) Java_org_jetbrains_numkt_core_KtNDIter_valueGet},
+    {"dealloc", "(J)V", (void *) Java_org_jetbrains_numkt_core_KtNDIter_dealloc},
+    {"nextC", "(J)Ljava/lang/Object;", (void *) Java_org_jetbrains_numkt_core_KtNDIter_nextC},
+    {"iterClose", "(J)V", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterClose},
+    {"iterRemoveAxis", "(JI)Z", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterRemoveAxis},
+    {"iterRemoveMultiIndex", "(J)Z", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterRemoveMultiIndex},
+    {"iterReset", "(J)Z", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterReset},
+    {"finishedGetCritical", "(J)Z", (void *) Java_org_jetbrains_numkt_core_KtNDIter_finishedGetCritical},
+    {"iterDebugPrintCritical", "(J)Z", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterDebugPrintCritical},
+    {"iterNextCritical", "(J)Z", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterNextCritical},
+    {"indexGetCritical", "(J)I", (void *) Java_org_jetbrains_numkt_core_KtNDIter_indexGetCritical},
+    {"iterIndexGetCritical", "(J)I", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterIndexGetCritical},
+    {"iterSizeGetCritical", "(J)I", (void *) Java_org_jetbrains_numkt_core_KtNDIter_iterSizeGetCritical},
+    {"ndimGetCritical", "(J)I", (void *) Java_org_jetbrains_numkt_core_KtNDIter_ndimGetCritical},
+};
+
+int register_ktnditer_natives (JNIEnv *env)
+{
+  return register_natives (env, KTNDITER_TYPE, ktnditer_natives,
+                           sizeof (ktnditer_natives) / sizeof (ktnditer_natives[0]));
+}
@@ -0,0 +1,1018 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/*
+ * Accumulators keep their state in native memory and fold a chunk block by block: every block is
+ * summarized on its own (two-pass moments, a local histogram or t-digest) and the summaries are merged
+ * into the state in order. Blocks have a fixed size and are summarized on the thread pool without the GIL,
+ * so the results do not depend on the number of threads. NaN values are skipped.
+ */
+
+/* Values summarized by one block. */
+#define ACC_BLOCK_VALUES (1 << 16)
+
+/* Bounds of the blocks summarized at once and of the memory of their summaries. */
+#define ACC_BLOCKS_PER_ROUND 64
+#define ACC_ROUND_BYTES (64 << 20)
+
+typedef enum
+{
+  ACC_MOMENTS, ACC_COVARIANCE, ACC_HISTOGRAM, ACC_QUANTILES
+} AccumulatorKind;
+
+typedef struct
+{
+  double mean;
+  double weight;
+} Centroid;
+
+typedef struct
+{
+  AccumulatorKind kind;
+  /* columns of the chunks for moments and covariance, 1 for the others */
+  npy_intp columns;
+  /* values per column for moments, complete rows for covariance, values for quantiles */
+  npy_int64 *count;
+  double *mean;
+  /* sums of squared deviations per column, or the upper triangle of comoments for covariance */
+  double *m2;
+  double *min;
+  double *max;
+  /* deviations of a row for covariance */
+  double *delta;
+
+  /* bins of the histogram followed by the values below and above the range */
+  npy_intp bins;
+  double low;
+  double high;
+  npy_int64 *counts;
+
+  /* merging t-digest: sorted centroids, unsorted buffer and room to merge both */
+  double compression;
+  Centroid *centroids;
+  npy_intp size;
+  Centroid *buffer;
+  npy_intp buffered;
+  npy_intp buffer_capacity;
+  Centroid *scratch;
+  double total;
+} Accumulator;
+
+typedef struct
+{
+  Accumulator **partials;
+  const double *data;
+  npy_intp rows;
+  npy_intp block_rows;
+  npy_intp first;
+} AccumulatorTask;
+
+static void accumulator_free (Accumulator *acc)
+{
+  if (acc == NULL)
+    {
+      return;
+    }
+  free (acc->count);
+  free (acc->mean);
+  free (acc->m2);
+  free (acc->min);
+  free (acc->max);
+  free (acc->delta);
+  free (acc->counts);
+  free (acc->centroids);
+  free (acc->buffer);
+  free (acc->scratch);
+  free (acc);
+}
+
+static npy_intp tdigest_capacity (double compression)
+{
+  // with the k1 scale a pair of neighbouring centroids spans more than one unit of k out of compression / 2
+  return (npy_intp) ceil (compression) + 8;
+}
+
+static void accumulator_reset (Accumulator *acc)
+{
+  npy_intp c = acc->columns;
+
+  switch (acc->kind)
+    {
+      case ACC_MOMENTS:
+        memset (acc->count, 0, c * sizeof (npy_int64));
+        memset (acc->mean, 0, c * sizeof (double));
+        memset (acc->m2, 0, c * sizeof (double));
+        for (npy_intp j = 0; j < c; ++j)
+          {
+            acc->min[j] = HUGE_VAL;
+            acc->max[j] = -HUGE_VAL;
+          }
+        break;
+      case ACC_COVARIANCE:
+        acc->count[0] = 0;
+        memset (acc->mean, 0, c * sizeof (double));
+        memset (acc->m2, 0, c * c * sizeof (double));
+        break;
+      case ACC_HISTOGRAM:
+        memset (acc->counts, 0, (acc->bins + 2) * sizeof (npy_int64));
+        break;
+      case ACC_QUANTILES:
+        acc->count[0] = 0;
+        acc->min[0] = HUGE_VAL;
+        acc->max[0] = -HUGE_VAL;
+        acc->size = 0;
+        acc->buffered = 0;
+        acc->total = 0;
+        break;
+    }
+}
+
+static Accumulator *accumulator_new (AccumulatorKind kind, npy_intp columns, npy_intp bins, double low, double high,
+                                     double compression)
+{
+  Accumulator *acc = (Accumulator *) calloc (1, sizeof (Accumulator));
+  int failed = acc == NULL;
+
+  if (!failed)
+    {
+      acc->kind = kind;
+      acc->columns = columns;
+      acc->bins = bins;
+      acc->low = low;
+      acc->high = high;
+      acc->compression = compression;
+      switch (kind)
+        {
+          case ACC_MOMENTS:
+            acc->count = (npy_int64 *) malloc (columns * sizeof (npy_int64));
+            acc->mean = (double *) malloc (columns * sizeof (double));
+            acc->m2 = (double *) malloc (columns * sizeof (double));
+            acc->min = (double *) malloc (columns * sizeof (double));
+            acc->max = (double *) malloc (columns * sizeof (double));
+            failed = !acc->count || !acc->mean || !acc->m2 || !acc->min || !acc->max;
+            break;
+          case ACC_COVARIANCE:
+            acc->count = (npy_int64 *) malloc (sizeof (npy_int64));
+            acc->mean = (double *) malloc (columns * sizeof (double));
+            acc->m2 = (double *) malloc (columns * columns * sizeof (double));
+            acc->delta = (double *) malloc (columns * sizeof (double));
+            failed = !acc->count || !acc->mean || !acc->m2 || !acc->delta;
+            break;
+          case ACC_HISTOGRAM:
+            acc->counts = (npy_int64 *) malloc ((bins + 2) * sizeof (npy_int64));
+            failed = !acc->counts;
+            break;
+          case ACC_QUANTILES:
+            {
+              npy_intp capacity = tdigest_capacity (compression);
+              acc->buffer_capacity = 4 * capacity;
+              acc->count = (npy_int64 *) malloc (sizeof (npy_int64));
+              acc->min = (double *) malloc (sizeof (double));
+              acc->max = (double *) malloc (sizeof (double));
+              acc->centroids = (Centroid *) malloc (capacity * sizeof (Centroid));
+              acc->buffer = (Centroid *) malloc (acc->buffer_capacity * sizeof (Centroid));
+              acc->scratch = (Centroid *) malloc ((capacity + acc->buffer_capacity) * sizeof (Centroid));
+              failed = !acc->count || !acc->min || !acc->max || !acc->centroids || !acc->buffer || !acc->scratch;
+              break;
+            }
+        }
+    }
+  if (failed)
+    {
+      accumulator_free (acc);
+      return NULL;
+    }
+
+  accumulator_reset (acc);
+  return acc;
+}
+
+static Accumulator *accumulator_like (const Accumulator *acc)
+{
+  return accumulator_new (acc->kind, acc->columns, acc->bins, acc->low, acc->high, acc->compression);
+}
+
+/* Bytes of the state, which bound the summaries of a round. */
+static npy_intp accumulator_bytes (const Accumulator *acc)
+{
+  switch (acc->kind)
+    {
+      case ACC_MOMENTS:
+        return 5 * acc->columns * sizeof (double);
+      case ACC_COVARIANCE:
+        return (acc->columns + 2) * acc->columns * sizeof (double);
+      case ACC_HISTOGRAM:
+        return (acc->bins + 2) * sizeof (npy_int64);
+      default:
+        return 3 * (tdigest_capacity (acc->compression) + acc->buffer_capacity) * sizeof (Centroid);
+    }
+}
+
+static int centroid_compare (const void *a, const void *b)
+{
+  double x = ((const Centroid *) a)->mean;
+  double y = ((const Centroid *) b)->mean;
+
+  return (x > y) - (x < y);
+}
+
+/* The greatest quantile that a centroid starting at q may reach, by the k1 scale function. */
+static double tdigest_limit (double compression, double q)
+{
+  double k = compression / (2 * M_PI) * asin (2 * q - 1) + 1;
+
+  if (k >= compression / 4)
+    {
+      return 1;
+    }
+  return (sin (2 * M_PI * k / compression) + 1) / 2;
+}
+
+static void tdigest_compress (Accumulator *acc)
+{
+  Centroid *all = acc->scratch;
+  npy_intp n = 0;
+  npy_intp i = 0;
+  npy_intp j = 0;
+
+  if (acc->buffered == 0)
+    {
+      return;
+    }
+
+  qsort (acc->buffer, acc->buffered, sizeof (Centroid), centroid_compare);
+  while (i < acc->size || j < acc->buffered)
+    {
+      if (j == acc->buffered || (i < acc->size && acc->centroids[i].mean <= acc->buffer[j].mean))
+        {
+          all[n++] = acc->centroids[i++];
+        }
+      else
+        {
+          all[n++] = acc->buffer[j++];
+        }
+    }
+
+  Centroid current = all[0];
+  double before = 0;
+  double limit = tdigest_limit (acc->compression, 0) * acc->total;
+
+  acc->size = 0;
+  for (i = 1; i < n; ++i)
+    {
+      if (before + current.weight + all[i].weight <= limit)
+        {
+          current.weight += all[i].weight;
+          current.mean += (all[i].mean - current.mean) * all[i].weight / current.weight;
+        }
+      else
+        {
+          acc->centroids[acc->size++] = current;
+          before += current.weight;
+          limit = tdigest_limit (acc->compression, before / acc->total) * acc->total;
+          current = all[i];
+        }
+    }
+  acc->centroids[acc->size++] = current;
+  acc->buffered = 0;
+}
+
+static void tdigest_add (Accumulator *acc, double mean, double weight)
+{
+  if (acc->buffered == acc->buffer_capacity)
+    {
+      tdigest_compress (acc);
+    }
+  acc->buffer[acc->buffered].mean = mean;
+  acc->buffer[acc->buffered].weight = weight;
+  acc->buffered++;
+  acc->total += weight;
+}
+
+static double tdigest_quantile (Accumulator *acc, double q)
+{
+  tdigest_compress (acc);
+
+  if (acc->size == 0 || q != q)
+    {
+      return Py_NAN;
+    }
+  if (q <= 0)
+    {
+      return acc->min[0];
+    }
+  if (q >= 1)
+    {
+      return acc->max[0];
+    }
+
+  // every centroid stands at the middle of its weight, the extremes at the ends
+  const Centroid *c = acc->centroids;
+  double index = q * acc->total;
+  double first = c[0].weight / 2;
+  double last = acc->total - c[acc->size - 1].weight / 2;
+
+  if (index <= first)
+    {
+      return acc->min[0] + (c[0].mean - acc->min[0]) * index / first;
+    }
+  if (index >= last)
+    {
+      const Centroid *l = c + acc->size - 1;
+      return l->mean + (acc->max[0] - l->mean) * (index - last) / (l->weight / 2);
+    }
+
+  double center = first;
+  for (npy_intp i = 0; i + 1 < acc->size; ++i)
+    {
+      double next = center + (c[i].weight + c[i + 1].weight) / 2;
+      if (index < next)
+        {
+          return c[i].mean + (c[i + 1].mean - c[i].mean) * (index - center) / (next - center);
+        }
+      center = next;
+    }
+  return c[acc->size - 1].mean;
+}
+
+static void moments_block (Accumulator *acc, const double *data, npy_intp rows)
+{
+  npy_intp c = acc->columns;
+
+  for (npy_intp r = 0; r < rows; ++r)
+    {
+      const double *row = data + r * c;
+      for (npy_intp j = 0; j < c; ++j)
+        {
+          double v = row[j];
+          if (v == v)
+            {
+              acc->count[j]++;
+              acc->mean[j] += v;
+              acc->min[j] = v < acc->min[j] ? v : acc->min[j];
+              acc->max[j] = v > acc->max[j] ? v : acc->max[j];
+            }
+        }
+    }
+  for (npy_intp j = 0; j < c; ++j)
+    {
+      acc->mean[j] = acc->count[j] > 0 ? acc->mean[j] / acc->count[j] : 0;
+    }
+  for (npy_intp r = 0; r < rows; ++r)
+    {
+      const double *row = data + r * c;
+      for (npy_intp j = 0; j < c; ++j)
+        {
+          double d = row[j] - acc->mean[j];
+          if (d == d)
+            {
+              acc->m2[j] += d * d;
+            }
+        }
+    }
+}
+
+static int covariance_row_complete (const double *row, npy_intp c)
+{
+  for (npy_intp j = 0; j < c; ++j)
+    {
+      if (row[j] != row[j])
+        {
+          return 0;
+        }
+    }
+  return 1;
+}
+
+static void covariance_block (Accumulator *acc, const double *data, npy_intp rows)
+{
+  npy_intp c = acc->columns;
+
+  for (npy_intp r = 0; r < rows; ++r)
+    {
+      const double *row = data + r * c;
+      if (covariance_row_complete (row, c))
+        {
+          acc->count[0]++;
+          for (npy_intp j = 0; j < c; ++j)
+            {
+              acc->mean[j] += row[j];
+            }
+        }
+    }
+  if (acc->count[0] == 0)
+    {
+      return;
+    }
+  for (npy_intp j = 0; j < c; ++j)
+    {
+      acc->mean[j] /= acc->count[0];
+    }
+  for (npy_intp r = 0; r < rows; ++r)
+    {
+      const double *row = data + r * c;
+      if (!covariance_row_complete (row, c))
+        {
+          continue;
+        }
+      for (npy_intp j = 0; j < c; ++j)
+        {
+          acc->delta[j] = row[j] - acc->mean[j];
+        }
+      for (npy_intp i = 0; i < c; ++i)
+        {
+          double di = acc->delta[i];
+          double *m2 = acc->m2 + i * c;
+          for (npy_intp j = i; j < c; ++j)
+            {
+              m2[j] += di * acc->delta[j];
+            }
+        }
+    }
+}
+
+static double histogram_edge (const Accumulator *acc, npy_intp i)
+{
+  return i == acc->bins ? acc->high : acc->low + i * ((acc->high - acc->low) / acc->bins);
+}
+
+static void histogram_block (Accumulator *acc, const double *data, npy_intp n)
+{
+  double scale = acc->bins / (acc->high - acc->low);
+
+  for (npy_intp i = 0; i < n; ++i)
+    {
+      double v = data[i];
+      if (v != v)
+        {
+          continue;
+        }
+      if (v < acc->low)
+        {
+          acc->counts[acc->bins]++;
+        }
+      else if (v > acc->high)
+        {
+          acc->counts[acc->bins + 1]++;
+        }
+      else
+        {
+          // the same rounding corrections as numpy.histogram
+          npy_intp b = (npy_intp) ((v - acc->low) * scale);
+          if (b >= acc->bins)
+            {
+              b = acc->bins - 1;
+            }
+          if (v < histogram_edge (acc, b))
+            {
+              b--;
+            }
+          else if (b != acc->bins - 1 && v >= histogram_edge (acc, b + 1))
+            {
+              b++;
+            }
+          acc->counts[b]++;
+        }
+    }
+}
+
+static void quantiles_block (Accumulator *acc, const double *data, npy_intp n)
+{
+  for (npy_intp i = 0; i < n; ++i)
+    {
+      double v = data[i];
+      if (v == v)
+        {
+          acc->count[0]++;
+          acc->min[0] = v < acc->min[0] ? v : acc->min[0];
+          acc->max[0] = v > acc->max[0] ? v : acc->max[0];
+          tdigest_add (acc, v, 1);
+        }
+    }
+  tdigest_compress (acc);
+}
+
+/* Summarize rows of a chunk into a reset accumulator. */
+static void accumulator_block (Accumulator *acc, const double *data, npy_intp rows)
+{
+  accumulator_reset (acc);
+  switch (acc->kind)
+    {
+      case ACC_MOMENTS:
+        moments_block (acc, data, rows);
+        break;
+      case ACC_COVARIANCE:
+        covariance_block (acc, data, rows);
+        break;
+      case ACC_HISTOGRAM:
+        histogram_block (acc, data, rows);
+        break;
+      case ACC_QUANTILES:
+        quantiles_block (acc, data, rows);
+        break;
+    }
+}
+
+/* Fold the state of other into acc, the moments of the union follow Chan et al. */
+static void accumulator_merge (Accumulator *acc, Accumulator *other)
+{
+  npy_intp c = acc->columns;
+
+  switch (acc->kind)
+    {
+      case ACC_MOMENTS:
+        for (npy_intp j = 0; j < c; ++j)
+          {
+            npy_int64 na = acc->count[j];
+            npy_int64 nb = other->count[j];
+            if (nb == 0)
+              {
+                continue;
+              }
+            double n = (double) (na + nb);
+            double delta = other->mean[j] - acc->mean[j];
+            acc->mean[j] += delta * nb / n;
+            acc->m2[j] += other->m2[j] + delta * delta * ((double) na * nb / n);
+            acc->count[j] = na + nb;
+            acc->min[j] = other->min[j] < acc->min[j] ? other->min[j] : acc->min[j];
+            acc->max[j] = other->max[j] > acc->max[j] ? other->max[j] : acc->max[j];
+          }
+        break;
+      case ACC_COVARIANCE:
+        {
+          npy_int64 na = acc->count[0];
+          npy_int64 nb = other->count[0];
+          if (nb == 0)
+            {
+              break;
+            }
+          double n = (double) (na + nb);
+          double f = (double) na * nb / n;
+          for (npy_intp j = 0; j < c; ++j)
+            {
+              acc->delta[j] = other->mean[j] - acc->mean[j];
+            }
+          for (npy_intp i = 0; i < c; ++i)
+            {
+              for (npy_intp j = i; j < c; ++j)
+                {
+                  acc->m2[i * c + j] += other->m2[i * c + j] + acc->delta[i] * acc->delta[j] * f;
+                }
+              acc->mean[i] += acc->delta[i] * nb / n;
+            }
+          acc->count[0] = na + nb;
+          break;
+        }
+      case ACC_HISTOGRAM:
+        for (npy_intp i = 0; i < acc->bins + 2; ++i)
+          {
+            acc->counts[i] += other->counts[i];
+          }
+        break;
+      case ACC_QUANTILES:
+        tdigest_compress (other);
+        for (npy_intp i = 0; i < other->size; ++i)
+          {
+            tdigest_add (acc, other->centroids[i].mean, other->centroids[i].weight);
+          }
+        acc->count[0] += other->count[0];
+        acc->min[0] = other->min[0] < acc->min[0] ? other->min[0] : acc->min[0];
+        acc->max[0] = other->max[0] > acc->max[0] ? other->max[0] : acc->max[0];
+        break;
+    }
+}
+
+static void accumulator_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  AccumulatorTask *task = (AccumulatorTask *) ctx;
+
+  for (Py_ssize_t i = begin; i < end; ++i)
+    {
+      Accumulator *partial = task->partials[i];
+      npy_intp row = (task->first + i) * task->block_rows;
+      npy_intp rows = task->rows - row < task->block_rows ? task->rows - row : task->block_rows;
+      accumulator_block (partial, task->data + row * partial->columns, rows);
+    }
+}
+
+/* Fold C-contiguous rows into the accumulator, no Python state is touched so any thread may call it. */
+static int accumulator_update (Accumulator *acc, const double *data, npy_intp rows)
+{
+  AccumulatorTask task;
+  npy_intp blocks;
+  npy_intp round;
+  npy_intp i;
+
+  if (rows == 0)
+    {
+      return 0;
+    }
+
+  task.data = data;
+  task.rows = rows;
+  task.block_rows = ACC_BLOCK_VALUES / acc->columns > 0 ? ACC_BLOCK_VALUES / acc->columns : 1;
+  blocks = (rows + task.block_rows - 1) / task.block_rows;
+  round = ACC_ROUND_BYTES / accumulator_bytes (acc);
+  round = round < 1 ? 1 : round > ACC_BLOCKS_PER_ROUND ? ACC_BLOCKS_PER_ROUND : round;
+  round = round < blocks ? round : blocks;
+
+  task.partials = (Accumulator **) calloc (round, sizeof (Accumulator *));
+  for (i = 0; task.partials != NULL && i < round; ++i)
+    {
+      task.partials[i] = accumulator_like (acc);
+      if (task.partials[i] == NULL)
+        {
+          break;
+        }
+    }
+  if (task.partials == NULL || i < round)
+    {
+      for (npy_intp j = 0; task.partials != NULL && j < i; ++j)
+        {
+          accumulator_free (task.partials[j]);
+        }
+      free (task.partials);
+      return -1;
+    }
+
+  for (task.first = 0; task.first < blocks; task.first += round)
+    {
+      npy_intp count = blocks - task.first < round ? blocks - task.first : round;
+      thread_pool_parallel_for (count, 1, accumulator_task, &task);
+      for (i = 0; i < count; ++i)
+        {
+          accumulator_merge (acc, task.partials[i]);
+        }
+    }
+
+  for (i = 0; i < round; ++i)
+    {
+      accumulator_free (task.partials[i]);
+    }
+  free (task.partials);
+  return 0;
+}
+
+static jlong accumulator_create (JNIEnv *env, AccumulatorKind kind, npy_intp columns, npy_intp bins, double low,
+                                 double high, double compression)
+{
+  Accumulator *acc = NULL;
+  const char *error = NULL;
+
+  if (columns < 1)
+    {
+      error = "Expected columns > 0.";
+    }
+  else if (kind == ACC_HISTOGRAM && (bins < 1 || !(low < high) || !isfinite (high - low)))
+    {
+      error = "Expected bins > 0 and a finite range with low < high.";
+    }
+  else if (kind == ACC_QUANTILES && !(compression >= 10 && compression <= 1e6))
+    {
+      error = "Expected compression from 10 to 1e6.";
+    }
+  if (error != NULL)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, error);
+      return 0;
+    }
+
+  acc = accumulator_new (kind, columns, bins, low, high, compression);
+  if (acc == NULL)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Not enough memory for the accumulator.");
+    }
+  return (jlong) acc;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    momentsNew
+ * Signature: (I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_momentsNew
+    (JNIEnv *env, jclass jcl, jint columns)
+{
+  return accumulator_create (env, ACC_MOMENTS, columns, 0, 0, 0, 0);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    covarianceNew
+ * Signature: (I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_covarianceNew
+    (JNIEnv *env, jclass jcl, jint columns)
+{
+  return accumulator_create (env, ACC_COVARIANCE, columns, 0, 0, 0, 0);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    histogramNew
+ * Signature: (IDD)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_histogramNew
+    (JNIEnv *env, jclass jcl, jint bins, jdouble low, jdouble high)
+{
+  return accumulator_create (env, ACC_HISTOGRAM, 1, bins, low, high, 0);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    quantilesNew
+ * Signature: (D)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_quantilesNew
+    (JNIEnv *env, jclass jcl, jdouble compression)
+{
+  return accumulator_create (env, ACC_QUANTILES, 1, 0, 0, 0, compression);
+}
+
+typedef struct
+{
+  JNIEnv *env;
+  Accumulator *acc;
+  PyArrayObject *chunk;
+  PyArrayObject *values;
+} AccumulatorChunk;
+
+static void accumulator_chunk_values (void *ptr)
+{
+  AccumulatorChunk *chunk = (AccumulatorChunk *) ptr;
+  npy_intp c = chunk->acc->columns;
+
+  // moments and covariance take rows of the columns, the others take values of any shape
+  if ((chunk->acc->kind == ACC_MOMENTS || chunk->acc->kind == ACC_COVARIANCE)
+      && !(PyArray_NDIM (chunk->chunk) == 2 && PyArray_DIM (chunk->chunk, 1) == c)
+      && !(PyArray_NDIM (chunk->chunk) == 1 && c == 1))
+    {
+      PyErr_Format (PyExc_ValueError, "Expected a chunk of the shape (rows, %zd).", (Py_ssize_t) c);
+    }
+  else
+    {
+      chunk->values = (PyArrayObject *) PyArray_FROMANY ((PyObject *) chunk->chunk, NPY_FLOAT64, 0, 0,
+                                                         NPY_ARRAY_CARRAY_RO);
+    }
+  python_exception (chunk->env);
+}
+
+static void accumulator_chunk_release (void *ptr)
+{
+  AccumulatorChunk *chunk = (AccumulatorChunk *) ptr;
+
+  Py_DECREF (chunk->values);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    accumulatorUpdate
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_accumulatorUpdate
+    (JNIEnv *env, jclass jcl, jlong ptr, jobject jchunk)
+{
+  NPY_IMPORT_ONCE ()
+
+  AccumulatorChunk chunk = {env, (Accumulator *) ptr, numkt_core_KtNDArray_getPointer (env, jchunk), NULL};
+
+  run_with_interpreter (accumulator_chunk_values, &chunk);
+  if (chunk.values == NULL)
+    {
+      return;
+    }
+
+  // the interpreter is not held here, update is called from any thread
+  if (accumulator_update (chunk.acc, (const double *) PyArray_DATA (chunk.values),
+                          PyArray_SIZE (chunk.values) / chunk.acc->columns) < 0)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Not enough memory for the accumulator.");
+    }
+
+  run_with_interpreter (accumulator_chunk_release, &chunk);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    accumulatorMerge
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_accumulatorMerge
+    (JNIEnv *env, jclass jcl, jlong ptr, jlong other_ptr)
+{
+  Accumulator *acc = (Accumulator *) ptr;
+  Accumulator *other = (Accumulator *) other_ptr;
+
+  if (acc->kind != other->kind || acc->columns != other->columns || acc->bins != other->bins
+      || acc->low != other->low || acc->high != other->high || acc->compression != other->compression)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Accumulators with different parameters cannot be merged.");
+      return;
+    }
+  accumulator_merge (acc, other);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    accumulatorCount
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_accumulatorCount
+    (JNIEnv *env, jclass jcl, jlong ptr)
+{
+  Accumulator *acc = (Accumulator *) ptr;
+  jlong count = 0;
+
+  if (acc->kind == ACC_HISTOGRAM)
+    {
+      for (npy_intp i = 0; i < acc->bins + 2; ++i)
+        {
+          count += acc->counts[i];
+        }
+      return count;
+    }
+  return acc->count[0];
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    momentsResult
+ * Signature: (JII)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_momentsResult
+    (JNIEnv *env, jclass jcl, jlong ptr, jint field, jint ddof)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  Accumulator *acc = (Accumulator *) ptr;
+  PyArrayObject *out = (PyArrayObject *) PyArray_SimpleNew (1, &acc->columns, field == 0 ? NPY_INT64 : NPY_FLOAT64);
+
+  if (out == NULL)
+    {
+      python_exception (env);
+      return NULL;
+    }
+
+  double *res = (double *) PyArray_DATA (out);
+  for (npy_intp j = 0; j < acc->columns; ++j)
+    {
+      npy_int64 n = acc->count[j];
+      switch (field)
+        {
+          case 0:
+            ((npy_int64 *) res)[j] = n;
+            break;
+          case 1:
+            res[j] = n > 0 ? acc->mean[j] : Py_NAN;
+            break;
+          case 2:
+            res[j] = n > ddof ? acc->m2[j] / (n - ddof) : Py_NAN;
+            break;
+          case 3:
+            res[j] = n > 0 ? acc->min[j] : Py_NAN;
+            break;
+          default:
+            res[j] = n > 0 ? acc->max[j] : Py_NAN;
+            break;
+        }
+    }
+
+  return new_ktndarray (env, out, NULL);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    covarianceResult
+ * Signature: (JII)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_covarianceResult
+    (JNIEnv *env, jclass jcl, jlong ptr, jint field, jint ddof)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  Accumulator *acc = (Accumulator *) ptr;
+  npy_intp c = acc->columns;
+  npy_intp dims[2] = {c, c};
+  npy_int64 n = acc->count[0];
+  PyArrayObject *out = (PyArrayObject *) PyArray_SimpleNew (field == 0 ? 1 : 2, dims, NPY_FLOAT64);
+
+  if (out == NULL)
+    {
+      python_exception (env);
+      return NULL;
+    }
+
+  double *res = (double *) PyArray_DATA (out);
+  if (field == 0)
+    {
+      for (npy_intp j = 0; j < c; ++j)
+        {
+          res[j] = n > 0 ? acc->mean[j] : Py_NAN;
+        }
+    }
+  else
+    {
+      for (npy_intp i = 0; i < c; ++i)
+        {
+          for (npy_intp j = i; j < c; ++j)
+            {
+              res[i * c + j] = res[j * c + i] = n > ddof ? acc->m2[i * c + j] / (n - ddof) : Py_NAN;
+            }
+        }
+    }
+
+  return new_ktndarray (env, out, NULL);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    histogramCounts
+ * Signature: (J)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_histogramCounts
+    (JNIEnv *env, jclass jcl, jlong ptr)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  Accumulator *acc = (Accumulator *) ptr;
+  PyArrayObject *out = (PyArrayObject *) PyArray_SimpleNew (1, &acc->bins, NPY_INT64);
+
+  if (out == NULL)
+    {
+      python_exception (env);
+      return NULL;
+    }
+  memcpy (PyArray_DATA (out), acc->counts, acc->bins * sizeof (npy_int64));
+
+  return new_ktndarray (env, out, NULL);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    histogramOutside
+ * Signature: (JZ)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_histogramOutside
+    (JNIEnv *env, jclass jcl, jlong ptr, jboolean above)
+{
+  Accumulator *acc = (Accumulator *) ptr;
+
+  return acc->counts[acc->bins + (above ? 1 : 0)];
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    quantilesResult
+ * Signature: (J[D)[D
+ */
+JNIEXPORT jdoubleArray JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_quantilesResult
+    (JNIEnv *env, jclass jcl, jlong ptr, jdoubleArray jq)
+{
+  Accumulator *acc = (Accumulator *) ptr;
+  jsize n = (*env)->GetArrayLength (env, jq);
+  jdoubleArray result = (*env)->NewDoubleArray (env, n);
+  jdouble *q;
+  jdouble *res;
+
+  if (result == NULL)
+    {
+      return NULL;
+    }
+  q = (*env)->GetDoubleArrayElements (env, jq, NULL);
+  res = (*env)->GetDoubleArrayElements (env, result, NULL);
+  for (jsize i = 0; i < n; ++i)
+    {
+      res[i] = tdigest_quantile (acc, q[i]);
+    }
+  (*env)->ReleaseDoubleArrayElements (env, result, res, 0);
+  (*env)->ReleaseDoubleArrayElements (env, jq, q, JNI_ABORT);
+
+  return result;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_statistics_Accumulators
+ * Method:    accumulatorDealloc
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_statistics_Accumulators_accumulatorDealloc
+    (JNIEnv *env, jclass jcl, jlong ptr)
+{
+  // the state holds no Python objects, so the finalizer may free it without the GIL
+  accumulator_free ((Accumulator *) ptr);
+}
@@ -0,0 +1,621 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#define ARROW_CAPSULE_NAME "ktnumpy.arrow"
+#define ARROW_FORMAT_SIZE 32
+
+typedef struct
+{
+  char format[ARROW_FORMAT_SIZE];
+  struct ArrowSchema *children[1];
+  struct ArrowSchema child;
+} ExportedSchema;
+
+typedef struct
+{
+  PyObject *owner;
+  const void *buffers[2];
+  struct ArrowArray *children[1];
+  struct ArrowArray child;
+  void *validity;
+  void *packed;
+} ExportedArray;
+
+typedef struct
+{
+  const void *values;
+  void *validity;
+  void *packed;
+  int64_t null_count;
+} ExportedLeaf;
+
+/*
+ * Release callbacks can be called from any thread,
+ * e.g. by a Java cleaner, the reference is dropped the same way as in freeArray.
+ */
+static void
+arrow_release (void *obj)
+{
+  Py_DECREF ((PyObject *) obj);
+}
+
+static void
+arrow_decref (PyObject *obj)
+{
+  run_with_interpreter (arrow_release, obj);
+}
+
+static char
+arrow_format_from_descr (PyArray_Descr *descr)
+{
+  switch (descr->kind)
+    {
+      case 'b': return 'b';
+      case 'i':
+        switch (PyDataType_ELSIZE (descr))
+          {
+            case 1: return 'c';
+            case 2: return 's';
+            case 4: return 'i';
+            case 8: return 'l';
+          }
+        break;
+      case 'u':
+        switch (PyDataType_ELSIZE (descr))
+          {
+            case 1: return 'C';
+            case 2: return 'S';
+            case 4: return 'I';
+            case 8: return 'L';
+          }
+        break;
+      case 'f':
+        switch (PyDataType_ELSIZE (descr))
+          {
+            case 2: return 'e';
+            case 4: return 'f';
+            case 8: return 'g';
+          }
+        break;
+    }
+  return 0;
+}
+
+static int
+arrow_type_from_format (const char *format)
+{
+  if (format[0] == 0 || format[1] != 0)
+    {
+      return NPY_NOTYPE;
+    }
+  switch (format[0])
+    {
+      case 'b': return NPY_BOOL;
+      case 'c': return NPY_INT8;
+      case 'C': return NPY_UINT8;
+      case 's': return NPY_INT16;
+      case 'S': return NPY_UINT16;
+      case 'i': return NPY_INT32;
+      case 'I': return NPY_UINT32;
+      case 'l': return NPY_INT64;
+      case 'L': return NPY_UINT64;
+      case 'e': return NPY_FLOAT16;
+      case 'f': return NPY_FLOAT32;
+      case 'g': return NPY_FLOAT64;
+      default: return NPY_NOTYPE;
+    }
+}
+
+static inline int
+arrow_bit (const void *bitmap, int64_t i)
+{
+  return (((const uint8_t *) bitmap)[i >> 3] >> (i & 7)) & 1;
+}
+
+static void
+arrow_release_schema (struct ArrowSchema *schema)
+{
+  ExportedSchema *private = (ExportedSchema *) schema->private_data;
+
+  if (private->child.release != NULL)
+    {
+      private->child.release (&private->child);
+    }
+  free (private);
+  schema->release = NULL;
+}
+
+static void
+arrow_release_array (struct ArrowArray *array)
+{
+  ExportedArray *private = (ExportedArray *) array->private_data;
+
+  if (private->child.release != NULL)
+    {
+      private->child.release (&private->child);
+    }
+  free (private->validity);
+  free (private->packed);
+  arrow_decref (private->owner);
+  free (private);
+  array->release = NULL;
+}
+
+/*
+ * C-contiguous array of n dimensions is exported as nested fixed-size lists,
+ * the innermost level holds all the values.
+ */
+static int
+arrow_export_schema (struct ArrowSchema *schema, const npy_intp *shape, int ndim, char format, const char *name)
+{
+  ExportedSchema *private = (ExportedSchema *) calloc (1, sizeof (ExportedSchema));
+
+  if (private == NULL)
+    {
+      PyErr_NoMemory ();
+      return -1;
+    }
+
+  if (ndim > 1)
+    {
+      snprintf (private->format, ARROW_FORMAT_SIZE, "+w:%" NPY_INTP_FMT, shape[1]);
+      if (arrow_export_schema (&private->child, shape + 1, ndim - 1, format, "item") < 0)
+        {
+          free (private);
+          return -1;
+        }
+      private->children[0] = &private->child;
+      schema->n_children = 1;
+      schema->children = private->children;
+    }
+  else
+    {
+      private->format[0] = format;
+      schema->n_children = 0;
+      schema->children = NULL;
+    }
+
+  schema->format = private->format;
+  schema->name = name;
+  schema->metadata = NULL;
+  schema->flags = ARROW_FLAG_NULLABLE;
+  schema->dictionary = NULL;
+  schema->release = arrow_release_schema;
+  schema->private_data = private;
+
+  return 0;
+}
+
+static int
+arrow_export_array (struct ArrowArray *array, PyObject *owner, const npy_intp *shape, int ndim, int64_t length,
+                    ExportedLeaf *leaf)
+{
+  ExportedArray *private = (ExportedArray *) calloc (1, sizeof (ExportedArray));
+
+  if (private == NULL)
+    {
+      PyErr_NoMemory ();
+      return -1;
+    }
+
+  if (ndim > 1)
+    {
+      if (arrow_export_array (&private->child, owner, shape + 1, ndim - 1, length * shape[1], leaf) < 0)
+        {
+          free (private);
+          return -1;
+        }
+      private->children[0] = &private->child;
+      array->null_count = 0;
+      array->n_buffers = 1;
+      array->n_children = 1;
+      array->children = private->children;
+    }
+  else
+    {
+      // the leaf takes ownership of the allocated buffers
+      private->buffers[0] = private->validity = leaf->validity;
+      private->buffers[1] = leaf->values;
+      private->packed = leaf->packed;
+      leaf->validity = leaf->packed = NULL;
+      array->null_count = leaf->null_count;
+      array->n_buffers = 2;
+      array->n_children = 0;
+      array->children = NULL;
+    }
+
+  Py_INCREF (owner);
+  private->owner = owner;
+
+  array->length = length;
+  array->offset = 0;
+  array->buffers = private->buffers;
+  array->dictionary = NULL;
+  array->release = arrow_release_array;
+  array->private_data = private;
+
+  return 0;
+}
+
+/*
+ * Pack values of a C-contiguous boolean array into a bitmap, inverted for a mask.
+ */
+static void *
+arrow_pack_bits (PyArrayObject *arr, int invert, int64_t *unset)
+{
+  npy_intp n = PyArray_SIZE (arr);
+  const npy_bool *src = (const npy_bool *) PyArray_DATA (arr);
+  uint8_t *bitmap = (uint8_t *) calloc ((size_t) (n + 7) / 8 + 1, 1);
+  int64_t count = 0;
+
+  if (bitmap == NULL)
+    {
+      PyErr_NoMemory ();
+      return NULL;
+    }
+
+  for (npy_intp i = 0; i < n; ++i)
+    {
+      if ((src[i] != 0) != invert)
+        {
+          bitmap[i >> 3] |= (uint8_t) (1u << (i & 7));
+        }
+      else
+        {
+          ++count;
+        }
+    }
+  *unset = count;
+
+  return bitmap;
+}
+
+static int
+arrow_is_masked (PyObject *obj)
+{
+  PyObject *ma = PyImport_ImportModule ("numpy.ma");
+  PyObject *masked_type = NULL;
+  int res = -1;
+
+  if (ma != NULL)
+    {
+      masked_type = PyObject_GetAttrString (ma, "MaskedArray");
+      if (masked_type != NULL)
+        {
+          res = PyObject_IsInstance (obj, masked_type);
+        }
+    }
+  Py_XDECREF (masked_type);
+  Py_XDECREF (ma);
+
+  return res;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Arrow
+ * Method:    exportArrow
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;JJ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Arrow_exportArrow
+    (JNIEnv *env, jclass jcl, jobject jarray, jlong array_address, jlong schema_address)
+{
+  NPY_IMPORT_ONCE ()
+
+  PyArrayObject *arr = numkt_core_KtNDArray_getPointer (env, jarray);
+  struct ArrowArray *out_array = (struct ArrowArray *) array_address;
+  struct ArrowSchema *out_schema = (struct ArrowSchema *) schema_address;
+  PyArrayObject *contiguous = NULL;
+  PyArrayObject *mask = NULL;
+  ExportedLeaf leaf = {NULL, NULL, NULL, 0};
+  char format;
+  int masked;
+
+  if (PyArray_NDIM (arr) == 0)
+    {
+      PyErr_SetString (PyExc_ValueError, "Cannot export a 0-d array to Arrow.");
+      goto OUT;
+    }
+  format = arrow_format_from_descr (PyArray_DESCR (arr));
+  if (format == 0)
+    {
+      PyErr_SetString (PyExc_TypeError, "Unsupported type of array for Arrow export.");
+      goto OUT;
+    }
+
+  // only non-contiguous or byte-swapped arrays are copied
+  contiguous = (PyArrayObject *) PyArray_FromAny ((PyObject *) arr, PyArray_DescrFromType (PyArray_TYPE (arr)), 0, 0,
+                                                  NPY_ARRAY_CARRAY_RO | NPY_ARRAY_ENSUREARRAY, NULL);
+  if (contiguous == NULL)
+    {
+      goto OUT;
+    }
+  leaf.values = PyArray_DATA (contiguous);
+
+  if (format == 'b')
+    {
+      int64_t unused;
+      leaf.packed = arrow_pack_bits (contiguous, 0, &unused);
+      if (leaf.packed == NULL)
+        {
+          goto OUT;
+        }
+      leaf.values = leaf.packed;
+    }
+
+  masked = arrow_is_masked ((PyObject *) arr);
+  if (masked < 0)
+    {
+      goto OUT;
+    }
+  if (masked)
+    {
+      PyObject *ma = PyImport_ImportModule ("numpy.ma");
+      PyObject *full_mask = ma != NULL ? PyObject_CallMethod (ma, "getmaskarray", "O", arr) : NULL;
+      Py_XDECREF (ma);
+      if (full_mask == NULL)
+        {
+          goto OUT;
+        }
+      mask = (PyArrayObject *) PyArray_FROM_OTF (full_mask, NPY_BOOL, NPY_ARRAY_IN_ARRAY);
+      Py_DECREF (full_mask);
+      if (mask == NULL)
+        {
+          goto OUT;
+        }
+      leaf.validity = arrow_pack_bits (mask, 1, &leaf.null_count);
+      if (leaf.validity == NULL)
+        {
+          goto OUT;
+        }
+      if (leaf.null_count == 0)
+        {
+          free (leaf.validity);
+          leaf.validity = NULL;
+        }
+    }
+
+  if (arrow_export_schema (out_schema, PyArray_DIMS (contiguous), PyArray_NDIM (contiguous), format, "") < 0)
+    {
+      goto OUT;
+    }
+  if (arrow_export_array (out_array, (PyObject *) contiguous, PyArray_DIMS (contiguous), PyArray_NDIM (contiguous),
+                          PyArray_DIM (contiguous, 0), &leaf) < 0)
+    {
+      out_schema->release (out_schema);
+    }
+
+  OUT:
+  free (leaf.validity);
+  free (leaf.packed);
+  Py_XDECREF (mask);
+  Py_XDECREF (contiguous);
+  python_exception (env);
+}
+
+static void
+arrow_capsule_destructor (PyObject *capsule)
+{
+  struct ArrowArray *array = (struct ArrowArray *) PyCapsule_GetPointer (capsule, ARROW_CAPSULE_NAME);
+
+  if (array->release != NULL)
+    {
+      array->release (array);
+    }
+  free (array);
+}
+
+/*
+ * Fill the mask of elements that are null on any level of nested lists.
+ */
+static int
+arrow_fill_mask (PyArrayObject **mask, struct ArrowArray **levels, const int64_t *starts, const npy_intp *shape,
+                 int ndim)
+{
+  int64_t count = 1;
+
+  for (int k = 0; k < ndim; ++k)
+    {
+      struct ArrowArray *level = levels[k];
+      int64_t inner = 1;
+
+      count *= shape[k];
+      for (int d = k + 1; d < ndim; ++d)
+        {
+          inner *= shape[d];
+        }
+      if (level->buffers[0] == NULL || level->null_count == 0)
+        {
+          continue;
+        }
+
+      for (int64_t j = 0; j < count; ++j)
+        {
+          if (arrow_bit (level->buffers[0], starts[k] + j))
+            {
+              continue;
+            }
+          if (*mask == NULL)
+            {
+              *mask = (PyArrayObject *) PyArray_ZEROS (ndim, (npy_intp *) shape, NPY_BOOL, 0);
+              if (*mask == NULL)
+                {
+                  return -1;
+                }
+            }
+          memset ((npy_bool *) PyArray_DATA (*mask) + j * inner, 1, (size_t) inner);
+        }
+    }
+
+  return 0;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Arrow
+ * Method:    importArrow
+ * Signature: (JJ)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Arrow_importArrow
+    (JNIEnv *env, jclass jcl, jlong array_address, jlong schema_address)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  struct ArrowArray *in_array = (struct ArrowArray *) array_address;
+  struct ArrowSchema *schema = (struct ArrowSchema *) schema_address;
+  struct ArrowArray *array = NULL;
+  struct ArrowArray *levels[NPY_MAXDIMS];
+  int64_t starts[NPY_MAXDIMS];
+  npy_intp shape[NPY_MAXDIMS];
+  PyObject *capsule = NULL;
+  PyArrayObject *values = NULL;
+  PyArrayObject *mask = NULL;
+  PyObject *result = NULL;
+  jobject jresult = NULL;
+  struct ArrowSchema *level_schema;
+  struct ArrowArray *level;
+  int type_num;
+  int ndim = 0;
+
+  if (in_array->release == NULL || schema->release == NULL)
+    {
+      PyErr_SetString (PyExc_ValueError, "Arrow structure is already released.");
+      goto OUT;
+    }
+
+  // move the array, it is released with the last view of the imported data
+  array = (struct ArrowArray *) malloc (sizeof (struct ArrowArray));
+  if (array == NULL)
+    {
+      PyErr_NoMemory ();
+      goto OUT;
+    }
+  *array = *in_array;
+  in_array->release = NULL;
+  capsule = PyCapsule_New (array, ARROW_CAPSULE_NAME, arrow_capsule_destructor);
+  if (capsule == NULL)
+    {
+      array->release (array);
+      free (array);
+      goto OUT;
+    }
+
+  level_schema = schema;
+  level = array;
+  shape[0] = (npy_intp) array->length;
+  starts[0] = array->offset;
+  while (strncmp (level_schema->format, "+w:", 3) == 0)
+    {
+      npy_intp size = (npy_intp) strtoll (level_schema->format + 3, NULL, 10);
+      if (level_schema->n_children != 1 || level->n_children != 1 || size <= 0)
+        {
+          PyErr_SetString (PyExc_ValueError, "Malformed Arrow fixed-size list.");
+          goto OUT;
+        }
+      if (ndim + 2 > NPY_MAXDIMS)
+        {
+          PyErr_SetString (PyExc_ValueError, "Too many levels of nested Arrow lists.");
+          goto OUT;
+        }
+      levels[ndim] = level;
+      level_schema = level_schema->children[0];
+      level = level->children[0];
+      starts[ndim + 1] = level->offset + starts[ndim] * size;
+      shape[++ndim] = size;
+    }
+  levels[ndim++] = level;
+
+  type_num = arrow_type_from_format (level_schema->format);
+  if (type_num == NPY_NOTYPE || level_schema->dictionary != NULL || level->n_buffers != 2)
+    {
+      PyErr_Format (PyExc_TypeError, "Unsupported Arrow format '%s'.", level_schema->format);
+      goto OUT;
+    }
+
+  if (type_num == NPY_BOOL)
+    {
+      // booleans are bit-packed in Arrow and have to be unpacked
+      values = (PyArrayObject *) PyArray_SimpleNew (ndim, shape, NPY_BOOL);
+      if (values != NULL)
+        {
+          npy_bool *dst = (npy_bool *) PyArray_DATA (values);
+          for (npy_intp i = 0, n = PyArray_SIZE (values); i < n; ++i)
+            {
+              dst[i] = (npy_bool) arrow_bit (level->buffers[1], starts[ndim - 1] + i);
+            }
+        }
+    }
+  else
+    {
+      PyArray_Descr *descr = PyArray_DescrFromType (type_num);
+      char *data = (char *) level->buffers[1];
+      if (data != NULL)
+        {
+          data += starts[ndim - 1] * PyDataType_ELSIZE (descr);
+        }
+      // Arrow data is immutable
+      values = (PyArrayObject *) PyArray_NewFromDescr (&PyArray_Type, descr, ndim, shape, NULL, data,
+                                                       NPY_ARRAY_C_CONTIGUOUS, NULL);
+      if (values != NULL && data != NULL)
+        {
+          Py_INCREF (capsule);
+          if (PyArray_SetBaseObject (values, capsule) < 0)
+            {
+              Py_CLEAR (values);
+            }
+        }
+    }
+  if (values == NULL)
+    {
+      goto OUT;
+    }
+
+  if (arrow_fill_mask (&mask, levels, starts, shape, ndim) < 0)
+    {
+      goto OUT;
+    }
+  if (mask != NULL)
+    {
+      PyObject *ma = PyImport_ImportModule ("numpy.ma");
+      if (ma != NULL)
+        {
+          result = PyObject_CallMethod (ma, "MaskedArray", "OO", values, mask);
+          Py_DECREF (ma);
+        }
+    }
+  else
+    {
+      result = (PyObject *) values;
+      Py_INCREF (result);
+    }
+
+  if (result != NULL)
+    {
+      jresult = new_ktndarray (env, (PyArrayObject *) result, NULL);
+    }
+
+  OUT:
+  if (schema->release != NULL)
+    {
+      schema->release (schema);
+    }
+  Py_XDECREF (mask);
+  Py_XDECREF (values);
+  Py_XDECREF (capsule);
+  python_exception (env);
+
+  return jresult;
+}
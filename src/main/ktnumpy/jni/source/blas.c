@@ -0,0 +1,420 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#ifdef KTNUMPY_POSIX
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+#ifdef __linux__
+#include <link.h>
+#endif
+
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
+
+/*
+ * Thread control of the BLAS numpy is linked with, in the way of threadpoolctl: the libraries loaded
+ * into the process are searched for a known BLAS and its functions for the number of threads are
+ * looked up by name. OpenBLAS under the names of the numpy and scipy builds, MKL and BLIS are known.
+ * OpenBLAS and MKL also carry LAPACK, its routines are found by blas_lapack_function.
+ */
+
+typedef int (*blas_get_threads) (void);
+typedef void (*blas_set_threads) (int);
+
+typedef struct
+{
+  const char *api;
+  /* part of the file name of the library */
+  const char *file;
+  const char *get;
+  const char *set;
+  /* name of the LAPACK routines of the library, by the name like dgesv, NULL without LAPACK */
+  const char *lapack;
+  /* 1 if the integers of LAPACK are 64-bit */
+  int ilp64;
+} BlasSymbols;
+
+static const BlasSymbols blas_symbols[] = {
+    {"openblas", "openblas", "openblas_get_num_threads", "openblas_set_num_threads", "%s_", 0},
+    {"openblas", "openblas", "openblas_get_num_threads64_", "openblas_set_num_threads64_", "%s_64_", 1},
+    {"openblas", "openblas", "scipy_openblas_get_num_threads", "scipy_openblas_set_num_threads", "scipy_%s_", 0},
+    {"openblas", "openblas", "scipy_openblas_get_num_threads64_", "scipy_openblas_set_num_threads64_", "scipy_%s_64_",
+     1},
+    {"mkl", "mkl_rt", "MKL_Get_Max_Threads", "MKL_Set_Num_Threads", "%s_", 0},
+    {"blis", "blis", "bli_thread_get_num_threads", "bli_thread_set_num_threads", NULL, 0},
+};
+
+#define BLAS_SYMBOLS (sizeof (blas_symbols) / sizeof (BlasSymbols))
+
+static struct
+{
+  const char *api;
+  char *library;
+  blas_get_threads get;
+  blas_set_threads set;
+  const BlasSymbols *symbols;
+  void *handle;
+} blas;
+
+#ifdef KTNUMPY_POSIX
+
+static pthread_once_t blas_once = PTHREAD_ONCE_INIT;
+
+/* Takes the functions of the library at path when it is a known BLAS, returns 1 if it is. */
+static int blas_try (const char *path)
+{
+  const char *name = strrchr (path, '/') != NULL ? strrchr (path, '/') + 1 : path;
+
+  for (size_t i = 0; i < BLAS_SYMBOLS; ++i)
+    {
+      void *handle;
+      if (strstr (name, blas_symbols[i].file) == NULL)
+        {
+          continue;
+        }
+      // the library is already loaded, this only takes a reference to it
+      handle = dlopen (path, RTLD_LAZY | RTLD_NOLOAD);
+      if (handle == NULL)
+        {
+          continue;
+        }
+      blas.get = (blas_get_threads) dlsym (handle, blas_symbols[i].get);
+      blas.set = (blas_set_threads) dlsym (handle, blas_symbols[i].set);
+      if (blas.get != NULL && blas.set != NULL)
+        {
+          blas.api = blas_symbols[i].api;
+          blas.library = strdup (path);
+          blas.symbols = &blas_symbols[i];
+          blas.handle = handle;
+          return 1;
+        }
+      blas.get = NULL;
+      blas.set = NULL;
+      dlclose (handle);
+    }
+  return 0;
+}
+
+#ifdef __linux__
+static int blas_visit (struct dl_phdr_info *info, size_t size, void *data)
+{
+  return info->dlpi_name != NULL && info->dlpi_name[0] != '\0' && blas_try (info->dlpi_name);
+}
+#endif
+
+static void blas_find (void)
+{
+#if defined(__linux__)
+  dl_iterate_phdr (blas_visit, NULL);
+#elif defined(__APPLE__)
+  for (uint32_t i = 0; i < _dyld_image_count () && !blas_try (_dyld_get_image_name (i)); ++i)
+    {
+    }
+#endif
+}
+
+static int blas_found (void)
+{
+  pthread_once (&blas_once, blas_find);
+  return blas.api != NULL;
+}
+
+void *blas_lapack_function (const char *name, int *ilp64)
+{
+  char symbol[64];
+
+  if (!blas_found () || blas.symbols->lapack == NULL)
+    {
+      return NULL;
+    }
+  snprintf (symbol, sizeof (symbol), blas.symbols->lapack, name);
+  *ilp64 = blas.symbols->ilp64;
+  return dlsym (blas.handle, symbol);
+}
+
+#else
+
+static int blas_found (void)
+{
+  return 0;
+}
+
+void *blas_lapack_function (const char *name, int *ilp64)
+{
+  return NULL;
+}
+
+#endif // KTNUMPY_POSIX
+
+static int blas_check (JNIEnv *env)
+{
+  if (!blas_found ())
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "No BLAS with thread control is loaded by numpy.");
+      return 0;
+    }
+  return 1;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_Blas
+ * Method:    blasApi
+ * Signature: ()Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jetbrains_numkt_linalg_Blas_blasApi
+    (JNIEnv *env, jclass jcl)
+{
+  return blas_found () ? (*env)->NewStringUTF (env, blas.api) : NULL;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_Blas
+ * Method:    blasLibrary
+ * Signature: ()Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jetbrains_numkt_linalg_Blas_blasLibrary
+    (JNIEnv *env, jclass jcl)
+{
+  return blas_found () ? (*env)->NewStringUTF (env, blas.library) : NULL;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_Blas
+ * Method:    getThreads
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_linalg_Blas_getThreads
+    (JNIEnv *env, jclass jcl)
+{
+  return blas_check (env) ? blas.get () : 0;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_Blas
+ * Method:    setThreads
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_linalg_Blas_setThreads
+    (JNIEnv *env, jclass jcl, jint threads)
+{
+  if (blas_check (env))
+    {
+      blas.set (threads);
+    }
+}
+
+/*
+ * Matrix products of stacks of small matrices, in parallel over the stack: one BLAS call per
+ * matrix costs more than the product itself, and BLAS threads do not help inside a tiny product.
+ */
+
+/* Largest number of rows or columns of the matrices multiplied here, larger ones go to BLAS. */
+#define BATCHED_MAX_DIM 64
+
+/* Multiply-adds done by one task at least. */
+#define BATCHED_GRAIN (1 << 15)
+
+/* The kernels are also compiled for AVX2 with FMA and chosen when the library is loaded. */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define BATCHED_CLONES __attribute__ ((target_clones ("arch=haswell", "default")))
+#else
+#define BATCHED_CLONES
+#endif
+
+typedef struct
+{
+  int type;
+  npy_intp m, n, k;
+  /* broadcast shape of the stack and the strides of the operands along it, zero where repeated */
+  int ndim;
+  npy_intp dims[NPY_MAXDIMS];
+  npy_intp a_strides[NPY_MAXDIMS];
+  npy_intp b_strides[NPY_MAXDIMS];
+  /* strides in elements of the rows and columns */
+  npy_intp a_row, a_col, b_row, b_col;
+  const char *a;
+  const char *b;
+  char *c;
+} BatchedMatmul;
+
+#define DEFINE_BATCHED_MATMUL(NAME, T)                                         \
+BATCHED_CLONES                                                                 \
+static void NAME (const BatchedMatmul *mm, const T *a, const T *b, T *restrict c) \
+{                                                                              \
+  const npy_intp m = mm->m, n = mm->n, k = mm->k;                              \
+  const npy_intp a_row = mm->a_row, a_col = mm->a_col, b_row = mm->b_row, b_col = mm->b_col; \
+  /* a row of the product is accumulated in place of the output */             \
+  T acc[BATCHED_MAX_DIM];                                                      \
+                                                                               \
+  for (npy_intp i = 0; i < m; ++i, c += n)                                     \
+    {                                                                          \
+      for (npy_intp j = 0; j < n; ++j)                                         \
+        {                                                                      \
+          acc[j] = 0;                                                          \
+        }                                                                      \
+      for (npy_intp p = 0; p < k; ++p)                                         \
+        {                                                                      \
+          const T x = a[i * a_row + p * a_col];                                \
+          const T *row = b + p * b_row;                                        \
+          if (b_col == 1)                                                      \
+            {                                                                  \
+              for (npy_intp j = 0; j < n; ++j)                                 \
+                {                                                              \
+                  acc[j] += x * row[j];                                        \
+                }                                                              \
+            }                                                                  \
+          else                                                                 \
+            {                                                                  \
+              for (npy_intp j = 0; j < n; ++j)                                 \
+                {                                                              \
+                  acc[j] += x * row[j * b_col];                                \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+      for (npy_intp j = 0; j < n; ++j)                                         \
+        {                                                                      \
+          c[j] = acc[j];                                                       \
+        }                                                                      \
+    }                                                                          \
+}
+
+DEFINE_BATCHED_MATMUL (batched_matmul_float64, npy_float64)
+DEFINE_BATCHED_MATMUL (batched_matmul_float32, npy_float32)
+
+static void batched_matmul_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  const BatchedMatmul *mm = (const BatchedMatmul *) ctx;
+  npy_intp itemsize = mm->type == NPY_FLOAT64 ? sizeof (npy_float64) : sizeof (npy_float32);
+
+  for (Py_ssize_t t = begin; t < end; ++t)
+    {
+      const char *a = mm->a, *b = mm->b;
+      char *c = mm->c + t * mm->m * mm->n * itemsize;
+      npy_intp r = t;
+      for (int d = mm->ndim - 1; d >= 0; --d)
+        {
+          a += (r % mm->dims[d]) * mm->a_strides[d];
+          b += (r % mm->dims[d]) * mm->b_strides[d];
+          r /= mm->dims[d];
+        }
+      if (mm->type == NPY_FLOAT64)
+        {
+          batched_matmul_float64 (mm, (const npy_float64 *) a, (const npy_float64 *) b, (npy_float64 *) c);
+        }
+      else
+        {
+          batched_matmul_float32 (mm, (const npy_float32 *) a, (const npy_float32 *) b, (npy_float32 *) c);
+        }
+    }
+}
+
+/* Strides in elements of the last two axes, 0 if they are not a multiple of the item size. */
+static int batched_strides (PyArrayObject *x, npy_intp *row, npy_intp *col)
+{
+  int nd = PyArray_NDIM (x);
+  npy_intp itemsize = PyArray_ITEMSIZE (x);
+
+  if (PyArray_STRIDE (x, nd - 2) % itemsize != 0 || PyArray_STRIDE (x, nd - 1) % itemsize != 0)
+    {
+      return 0;
+    }
+  *row = PyArray_STRIDE (x, nd - 2) / itemsize;
+  *col = PyArray_STRIDE (x, nd - 1) / itemsize;
+  return 1;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_BatchedMatmul
+ * Method:    matmul
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;I)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_BatchedMatmul_matmul
+    (JNIEnv *env, jclass jcl, jobject ja, jobject jb, jint min_batch)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  PyArrayObject *a = numkt_core_KtNDArray_getPointer (env, ja);
+  PyArrayObject *b = numkt_core_KtNDArray_getPointer (env, jb);
+  PyArrayObject *c;
+  int nda = PyArray_NDIM (a), ndb = PyArray_NDIM (b);
+  npy_intp dims[NPY_MAXDIMS];
+  npy_intp batch = 1;
+  BatchedMatmul mm;
+
+  // null for the products which numpy does itself
+  if (nda < 2 || ndb < 2 || (nda == 2 && ndb == 2) || PyArray_TYPE (a) != PyArray_TYPE (b)
+      || (PyArray_TYPE (a) != NPY_FLOAT64 && PyArray_TYPE (a) != NPY_FLOAT32)
+      || !PyArray_ISNOTSWAPPED (a) || !PyArray_ISNOTSWAPPED (b) || !PyArray_ISALIGNED (a) || !PyArray_ISALIGNED (b))
+    {
+      return NULL;
+    }
+  mm.type = PyArray_TYPE (a);
+  mm.m = PyArray_DIM (a, nda - 2);
+  mm.k = PyArray_DIM (a, nda - 1);
+  mm.n = PyArray_DIM (b, ndb - 1);
+  if (PyArray_DIM (b, ndb - 2) != mm.k || mm.m > BATCHED_MAX_DIM || mm.n > BATCHED_MAX_DIM || mm.k > BATCHED_MAX_DIM
+      || !batched_strides (a, &mm.a_row, &mm.a_col) || !batched_strides (b, &mm.b_row, &mm.b_col))
+    {
+      return NULL;
+    }
+
+  mm.ndim = (nda > ndb ? nda : ndb) - 2;
+  for (int d = 0; d < mm.ndim; ++d)
+    {
+      int da = d - (mm.ndim - (nda - 2)), db = d - (mm.ndim - (ndb - 2));
+      npy_intp na = da >= 0 ? PyArray_DIM (a, da) : 1, nb = db >= 0 ? PyArray_DIM (b, db) : 1;
+      if (na != nb && na != 1 && nb != 1)
+        {
+          return NULL;
+        }
+      mm.dims[d] = na == 1 ? nb : na;
+      mm.a_strides[d] = na > 1 ? PyArray_STRIDE (a, da) : 0;
+      mm.b_strides[d] = nb > 1 ? PyArray_STRIDE (b, db) : 0;
+      dims[d] = mm.dims[d];
+      batch *= mm.dims[d];
+    }
+  // one thread is no faster than a BLAS call per matrix
+  if (batch < min_batch || thread_pool_get_threads () < 2)
+    {
+      return NULL;
+    }
+  dims[mm.ndim] = mm.m;
+  dims[mm.ndim + 1] = mm.n;
+
+  c = (PyArrayObject *) PyArray_ZEROS (mm.ndim + 2, dims, mm.type, 0);
+  if (c == NULL)
+    {
+      python_exception (env);
+      return NULL;
+    }
+  mm.a = PyArray_BYTES (a);
+  mm.b = PyArray_BYTES (b);
+  mm.c = PyArray_BYTES (c);
+
+  if (mm.m * mm.n * mm.k > 0)
+    {
+      Py_BEGIN_ALLOW_THREADS
+      thread_pool_parallel_for (batch, 1 + BATCHED_GRAIN / (mm.m * mm.n * mm.k), batched_matmul_task, &mm);
+      KTNUMPY_END_ALLOW_THREADS
+    }
+
+  return new_ktndarray (env, c, NULL);
+}
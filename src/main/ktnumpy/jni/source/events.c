@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/* Longs of the buffer of a thread, records which do not fit are dropped until it is drained. */
+#define EVENT_BUFFER_SIZE 1024
+
+#ifdef KTNUMPY_POSIX
+#define EVENT_THREAD_LOCAL __thread
+#else
+#define EVENT_THREAD_LOCAL
+#endif
+
+int call_events_enabled = 0;
+
+static EVENT_THREAD_LOCAL jlong event_buffer[EVENT_BUFFER_SIZE];
+static EVENT_THREAD_LOCAL int event_length = 0;
+
+void events_push_call (uint64_t convert, uint64_t execute, uint64_t wrap, uint64_t bytes)
+{
+  if (event_length + 5 <= EVENT_BUFFER_SIZE)
+    {
+      jlong *record = event_buffer + event_length;
+      record[0] = EVENT_CALL;
+      record[1] = (jlong) convert;
+      record[2] = (jlong) execute;
+      record[3] = (jlong) wrap;
+      record[4] = (jlong) bytes;
+      event_length += 5;
+    }
+}
+
+void events_push_gil_wait (uint64_t wait)
+{
+  if (event_length + 2 <= EVENT_BUFFER_SIZE)
+    {
+      event_buffer[event_length] = EVENT_GIL_WAIT;
+      event_buffer[event_length + 1] = (jlong) wait;
+      event_length += 2;
+    }
+}
+
+void events_push_array (int kind, PyArrayObject *nparray)
+{
+  int ndim = PyArray_NDIM (nparray);
+
+  if (event_length + 3 + ndim <= EVENT_BUFFER_SIZE)
+    {
+      jlong *record = event_buffer + event_length;
+      record[0] = kind;
+      record[1] = (jlong) PyArray_NBYTES (nparray);
+      record[2] = ndim;
+      for (int i = 0; i < ndim; ++i)
+        {
+          record[3 + i] = (jlong) PyArray_DIM (nparray, i);
+        }
+      event_length += 3 + ndim;
+    }
+}
+
+uint64_t gil_wait_begin (void)
+{
+  return call_events_enabled ? call_metrics_now () : 0;
+}
+
+void gil_wait_end (uint64_t start)
+{
+  if (start != 0)
+    {
+      events_push_gil_wait (call_metrics_now () - start);
+    }
+}
+
+void acquire_main_thread (void)
+{
+  uint64_t wait = gil_wait_begin ();
+  PyEval_AcquireThread (mainThreadState);
+  gil_wait_end (wait);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Jfr
+ * Method:    setRecording
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Jfr_setRecording
+    (JNIEnv *env, jclass jcl, jboolean recording)
+{
+  call_events_enabled = recording == JNI_TRUE;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Jfr
+ * Method:    drain
+ * Signature: ([J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_Jfr_drain
+    (JNIEnv *env, jclass jcl, jlongArray records)
+{
+  jint length = event_length;
+  jsize capacity = (*env)->GetArrayLength (env, records);
+
+  if (length > capacity)
+    {
+      length = capacity;
+    }
+  (*env)->SetLongArrayRegion (env, records, 0, length, event_buffer);
+  event_length = 0;
+  return length;
+}
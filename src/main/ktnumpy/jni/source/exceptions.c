@@ -18,261 +18,313 @@
 
 static PyObject *module_tracebake = NULL, *extract_tb = NULL;
 
-int python_exception (JNIEnv *env)
+/*
+ * The natives of NumKtException can be called from any thread, e.g. by a logger or the finalizer,
+ * the interpreter is entered the same way as in the release callbacks of arrow.c.
+ */
+static int
+acquire_interpreter (void)
+{
+  if (PyGILState_Check ())
+    {
+      return 0;
+    }
+  acquire_main_thread ();
+  return 1;
+}
+
+static void
+release_interpreter (int acquired)
+{
+  if (acquired)
+    {
+      PyEval_ReleaseThread (mainThreadState);
+    }
+}
+
+/*
+ * Only the handle of the error, a tuple (type, value, traceback), is passed to NumKtException.
+ * The message and the python stack are rendered on first use.
+ */
+int throw_python_exception (JNIEnv *env)
 {
   PyObject *ptype = NULL;
   PyObject *pvalue = NULL;
   PyObject *ptraceback = NULL;
-  PyObject *pstack = NULL;
-  PyObject *message = NULL;
+  PyObject *error = NULL;
 
-  jstring jmessage = NULL;
   jobject jexception = NULL;
 
-  const char *cmes = NULL;
-
-  if (!PyErr_Occurred ())
+  if (PyErr_ExceptionMatches (PyExc_SystemExit))
     {
+      PyErr_PrintEx (1);
       return 0;
     }
 
-  if (PyErr_ExceptionMatches (PyExc_SystemExit))
+  PyErr_Fetch (&ptype, &pvalue, &ptraceback);
+
+  if (ptype == NULL)
     {
-      PyErr_PrintEx (1);
+      Py_XDECREF (pvalue);
+      Py_XDECREF (ptraceback);
       return 0;
     }
 
+  if (pvalue == NULL)
+    {
+      Py_INCREF (Py_None);
+      pvalue = Py_None;
+    }
+  if (ptraceback == NULL)
+    {
+      Py_INCREF (Py_None);
+      ptraceback = Py_None;
+    }
 
-  // trace
-  PyErr_Fetch (&ptype, &pvalue, &ptraceback);
+  error = PyTuple_New (3);
+  if (error == NULL)
+    {
+      Py_DECREF (ptype);
+      Py_DECREF (pvalue);
+      Py_DECREF (ptraceback);
+      PyErr_Clear ();
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Error to fetch the python exception.");
+      return 1;
+    }
+  PyTuple_SET_ITEM (error, 0, ptype);
+  PyTuple_SET_ITEM (error, 1, pvalue);
+  PyTuple_SET_ITEM (error, 2, ptraceback);
 
-  if (ptype == NULL && pvalue == NULL && ptraceback == NULL)
+  jexception = numkt_NumKtException_init_error (env, (jlong) error);
+  if ((*env)->ExceptionCheck (env) || !jexception)
     {
-      return 0;
+      Py_DECREF (error);
+      return 1;
     }
 
-  if (ptype != NULL)
+  (*env)->Throw (env, jexception);
+  (*env)->DeleteLocalRef (env, jexception);
+
+  return 1;
+}
+
+/* "type: value" with the first argument of the exception as the value */
+static PyObject *error_message (PyObject *error)
+{
+  PyObject *ptype = PyTuple_GET_ITEM (error, 0);
+  PyObject *pvalue = PyTuple_GET_ITEM (error, 1);
+  PyObject *message = NULL;
+  PyObject *val = NULL;
+
+  message = PyObject_Str (ptype);
+  if (message == NULL || pvalue == Py_None)
     {
-      message = PyObject_Str (ptype);
+      return message;
+    }
 
-      if (pvalue != NULL)
+  Py_INCREF (pvalue);
+  if (PyObject_TypeCheck (pvalue, (PyTypeObject *) PyExc_BaseException))
+    {
+      PyObject *args = PyObject_GetAttrString (pvalue, "args");
+      if (args != NULL && PyTuple_Check (args) && PyTuple_Size (args) > 0)
         {
-          PyObject *val = NULL;
-          if (PyObject_TypeCheck (pvalue, (PyTypeObject *) PyExc_BaseException))
-            {
-              PyObject *args = PyObject_GetAttrString (pvalue, "args");
-              if (args != NULL && PyTuple_Check(args) && PyTuple_Size (args) > 0)
-                {
-                  PyObject *mes = PyTuple_GetItem (args, 0);
-                  Py_INCREF(mes);
-                  Py_DECREF(pvalue);
-                  Py_DECREF(args);
-                  pvalue = mes;
-                }
-            }
+          Py_DECREF (pvalue);
+          pvalue = PyTuple_GetItem (args, 0);
+          Py_INCREF (pvalue);
+        }
+      Py_XDECREF (args);
+    }
 
-          val = PyObject_Str (pvalue);
-          if (val != NULL)
-            {
-              PyObject *tmp;
-              tmp = PyUnicode_FromFormat ("%U: %U", message, val);
-              Py_DECREF (val);
-              Py_XDECREF (message);
-              message = tmp;
-            }
+  val = PyObject_Str (pvalue);
+  Py_DECREF (pvalue);
+  if (val != NULL)
+    {
+      PyObject *tmp;
+      tmp = PyUnicode_FromFormat ("%U: %U", message, val);
+      Py_DECREF (val);
+      if (tmp != NULL)
+        {
+          Py_DECREF (message);
+          message = tmp;
+        }
+    }
 
-          // create NumKtException
-          cmes = PyString_AsString (message);
-          jmessage = (*env)->NewStringUTF (env, cmes);
-          jexception = numkt_NumKtException_init_string (env, jmessage);
-          (*env)->DeleteLocalRef (env, jmessage);
-          if ((*env)->ExceptionCheck (env) || !jexception)
-            {
-              PyErr_Format (PyExc_RuntimeError, "throw Exception failed.");
-              return 1;
-            }
+  return message;
+}
 
-          // traceback
-          if (ptraceback != NULL)
+/* file, function and line of a python frame, NULL for frames without a source line */
+static jobject stack_trace_element (JNIEnv *env, PyObject *st_entry)
+{
+  PyObject *file_name = NULL, *line_num = NULL, *func_name = NULL, *pline = NULL;
+  const char *py_file_name = NULL;
+  const char *py_func_name = NULL;
+  char *py_file_no_ext, *last_dot, *last_backslash;
+  jstring file_no_ext, file_no_dir, func_str;
+  jobject element = NULL;
+
+  file_name = PySequence_GetItem (st_entry, 0);
+  line_num = PySequence_GetItem (st_entry, 1);
+  func_name = PySequence_GetItem (st_entry, 2);
+  pline = PySequence_GetItem (st_entry, 3);
+
+  if (file_name != NULL && line_num != NULL && func_name != NULL && pline != NULL && pline != Py_None)
+    {
+      py_file_name = PyString_AsString (file_name);
+      py_func_name = PyString_AsString (func_name);
+    }
+
+  if (py_file_name != NULL && py_func_name != NULL)
+    {
+      py_file_no_ext = malloc (sizeof (char) * (strlen (py_file_name) + 1));
+      strcpy (py_file_no_ext, py_file_name);
+      last_dot = strrchr (py_file_no_ext, '.');
+      if (last_dot != NULL)
+        {
+          *last_dot = '\0';
+        }
+
+      // dir path
+      last_backslash = strrchr (py_file_name, FILE_SEP);
+
+      file_no_dir = (*env)->NewStringUTF (env, last_backslash != NULL ? last_backslash + 1 : py_file_name);
+      file_no_ext = (*env)->NewStringUTF (env, py_file_no_ext);
+      func_str = (*env)->NewStringUTF (env, py_func_name);
+
+      element = java_lang_StackTraceElement_init (env, file_no_ext, func_str, file_no_dir,
+                                                  (jint) PyInt_AsLong (line_num));
+
+      free (py_file_no_ext);
+      (*env)->DeleteLocalRef (env, file_no_dir);
+      (*env)->DeleteLocalRef (env, file_no_ext);
+      (*env)->DeleteLocalRef (env, func_str);
+    }
+
+  Py_XDECREF (file_name);
+  Py_XDECREF (line_num);
+  Py_XDECREF (func_name);
+  Py_XDECREF (pline);
+  return element;
+}
+
+static jobjectArray python_stack (JNIEnv *env, PyObject *error)
+{
+  PyObject *ptraceback = PyTuple_GET_ITEM (error, 2);
+  PyObject *pstack = NULL;
+  jobjectArray stack_array = NULL;
+  jobject *elements = NULL;
+  Py_ssize_t stack_size = 0;
+  jsize count = 0;
+
+  if (ptraceback != Py_None)
+    {
+      if (module_tracebake == NULL)
+        {
+          module_tracebake = PyImport_ImportModule ("traceback");
+        }
+      if (extract_tb == NULL)
+        {
+          extract_tb = PyString_FromString ("extract_tb");
+        }
+      if (module_tracebake != NULL && extract_tb != NULL)
+        {
+          pstack = PyObject_CallMethodObjArgs (module_tracebake, extract_tb, ptraceback, NULL);
+        }
+    }
+
+  if (pstack != NULL)
+    {
+      stack_size = PyList_Size (pstack);
+      elements = malloc (sizeof (jobject) * (stack_size + 1));
+      // innermost frame first, as in a java stack
+      for (Py_ssize_t i = stack_size - 1; i > -1; --i)
+        {
+          jobject element = stack_trace_element (env, PyList_GetItem (pstack, i));
+          if (element != NULL)
             {
-              if (module_tracebake == NULL)
-                {
-                  module_tracebake = PyImport_ImportModule ("traceback");
-                  if (module_tracebake == NULL)
-                    {
-                      printf ("Error importing module traceback\n");
-                    }
-                }
-              if (extract_tb == NULL)
-                {
-                  extract_tb = PyString_FromString ("extract_tb");
-                  if (extract_tb == NULL)
-                    {
-                      printf ("Error create python str 'extract_tb'\n");
-                    }
-                }
-
-              pstack = PyObject_CallMethodObjArgs (module_tracebake, extract_tb, ptraceback, NULL);
-              if (PyErr_Occurred ())
-                {
-                  PyErr_Print ();
-                }
-
-              if (pstack != NULL)
-                {
-                  jsize stack_size;
-                  jobjectArray stack_array = NULL, java_stack = NULL, reverse_java_stack;
-                  size_t count, java_stack_length, index;
-
-                  //stackTraceElem
-                  //constructor
-
-                  stack_size = PyList_Size (pstack);
-                  stack_array = (*env)->NewObjectArray (env, stack_size, STACK_TRACE_ELEMENT_TYPE, NULL);
-                  if ((*env)->ExceptionCheck (env) || stack_array == NULL)
-                    {
-                      PyErr_Format (PyExc_RuntimeError, "Error to create StackTraceElement[].\n");
-                      Py_DECREF (pstack);
-                      return 1;
-                    }
-
-                  count = 0;
-                  for (int i = 0; i < stack_size; ++i)
-                    {
-                      PyObject *st_entry, *pline;
-                      const char *py_file_name = NULL;
-                      const char *py_func_name = NULL;
-                      int py_line_num;
-
-                      st_entry = PyList_GetItem (pstack, i);
-
-                      py_file_name = PyString_AsString (PySequence_GetItem (st_entry, 0));
-                      py_line_num = PyInt_AsLong (PySequence_GetItem (st_entry, 1));
-                      py_func_name = PyString_AsString(PySequence_GetItem (st_entry, 2));
-                      pline = PySequence_GetItem (st_entry, 3);
-
-                      if (pline != Py_None)
-                        {
-                          char *py_file_no_ext, *last_dot, *py_file_no_dir, *last_backslash;
-                          int name_length;
-                          jobject element;
-                          jstring file_no_ext, file_no_dir, func_str;
-
-                          name_length = (int) strlen (py_file_name);
-                          py_file_no_ext = malloc (sizeof (char) * (name_length + 1));
-                          strcpy (py_file_no_ext, py_file_name);
-                          last_dot = strrchr (py_file_no_ext, '.');
-                          if (last_dot != NULL)
-                            {
-                              *last_dot = '\0';
-                            }
-
-                          // dir path
-                          py_file_no_dir = malloc (sizeof (char) * (name_length + 1));
-                          last_backslash = strrchr (py_file_name, FILE_SEP);
-                          if (last_backslash != NULL)
-                            {
-                              strcpy (py_file_no_dir, last_backslash + 1);
-                            }
-                          else
-                            {
-                              strcpy(py_file_no_dir, py_file_name);
-                            }
-
-                          file_no_dir = (*env)->NewStringUTF (env, py_file_no_dir);
-                          file_no_ext = (*env)->NewStringUTF (env, py_file_no_ext);
-                          func_str = (*env)->NewStringUTF (env, py_func_name);
-
-                          element = java_lang_StackTraceElement_init (env, file_no_ext, func_str, file_no_dir, py_line_num);
-                          if ((*env)->ExceptionCheck (env) || !element)
-                            {
-                              PyErr_Format (PyExc_RuntimeError, "Error to create StackTraceElement for python %s:%i.",
-                                            py_file_name, py_line_num);
-                              free (py_file_no_dir);
-                              free (py_file_no_ext);
-                              Py_DECREF(pstack);
-                              return 1;
-                            }
-
-                          (*env)->SetObjectArrayElement (env, stack_array, i, element);
-
-                          count++;
-                          free (py_file_no_dir);
-                          free (py_file_no_ext);
-                          (*env)->DeleteLocalRef (env, file_no_dir);
-                          (*env)->DeleteLocalRef (env, file_no_ext);
-                          (*env)->DeleteLocalRef (env, func_str);
-                          (*env)->DeleteLocalRef (env, element);
-                        }
-                    }
-                  Py_DECREF (pstack);
-
-                  java_stack = java_lang_Throwable_getStackTrace (env, jexception);
-                  if ((*env)->ExceptionCheck (env) || !java_stack)
-                    {
-                      PyErr_Format (PyExc_RuntimeError, "Get stack trace fail.\n");
-                      return 1;
-                    }
-                  java_stack_length = (*env)->GetArrayLength (env, java_stack);
-
-                  reverse_java_stack = (*env)->NewObjectArray (env, (count
-                                                                     + java_stack_length), STACK_TRACE_ELEMENT_TYPE, NULL);
-                  if ((*env)->ExceptionCheck (env) || !reverse_java_stack)
-                    {
-                      PyErr_Format (PyExc_RuntimeError, "Error to create reverse StackTraceElement[].\n");
-                      return 1;
-                    }
-
-                  index = 0;
-                  for (int i = stack_size - 1; i > -1; --i)
-                    {
-                      jobject element = (*env)->GetObjectArrayElement (env, stack_array, i);
-                      if (element != NULL)
-                        {
-                          (*env)->SetObjectArrayElement (env, reverse_java_stack, index, element);
-                          (*env)->DeleteLocalRef (env, element);
-                          index++;
-                        }
-                    }
-                  for (size_t i = 0; i < java_stack_length; ++i)
-                    {
-                      jobject element = (*env)->GetObjectArrayElement (env, java_stack, i);
-                      (*env)->SetObjectArrayElement (env, reverse_java_stack, index, element);
-                      (*env)->DeleteLocalRef (env, element);
-                      index++;
-                    }
-                  (*env)->DeleteLocalRef (env, stack_array);
-                  (*env)->DeleteLocalRef (env, java_stack);
-
-                  java_lang_Throwable_setStackTrace (env, jexception, reverse_java_stack);
-                  if ((*env)->ExceptionCheck (env))
-                    {
-                      fprintf (stderr, "Error while processing NumKtException.\n");
-                      PyErr_Restore (ptype, pvalue, ptraceback);
-                      PyErr_Print ();
-                      return 1;
-                    }
-                  (*env)->DeleteLocalRef (env, reverse_java_stack);
-                }
+              elements[count++] = element;
             }
         }
+      Py_DECREF (pstack);
     }
+  PyErr_Clear ();
 
-  Py_XDECREF (ptype);
-  Py_XDECREF (pvalue);
-  Py_XDECREF (ptraceback);
-
-  if (jexception != NULL)
+  stack_array = (*env)->NewObjectArray (env, count, STACK_TRACE_ELEMENT_TYPE, NULL);
+  for (jsize i = 0; i < count; ++i)
     {
-      Py_XDECREF (message);
-      (*env)->Throw (env, jexception);
+      if (stack_array != NULL)
+        {
+          (*env)->SetObjectArrayElement (env, stack_array, i, elements[i]);
+        }
+      (*env)->DeleteLocalRef (env, elements[i]);
     }
-  else if (message)
+  free (elements);
+
+  return stack_array;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NumKtException
+ * Method:    renderMessage
+ * Signature: (J)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jetbrains_numkt_NumKtException_renderMessage
+    (JNIEnv *env, jclass jclazz, jlong error)
+{
+  int acquired = acquire_interpreter ();
+  PyObject *message = error_message ((PyObject *) error);
+  jstring result = NULL;
+
+  if (message != NULL)
     {
-      cmes = PyString_AsString(message);
-      Py_XDECREF(message);
-      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, cmes);
+      result = (*env)->NewStringUTF (env, PyString_AsString (message));
+      Py_DECREF (message);
     }
+  PyErr_Clear ();
+  release_interpreter (acquired);
 
-  return 1;
-}
\ No newline at end of file
+  return result;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NumKtException
+ * Method:    errorType
+ * Signature: (J)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jetbrains_numkt_NumKtException_errorType
+    (JNIEnv *env, jclass jclazz, jlong error)
+{
+  int acquired = acquire_interpreter ();
+  // the name of the type only, neither the value nor the traceback is formatted
+  jstring result = (*env)->NewStringUTF (env, ((PyTypeObject *) PyTuple_GET_ITEM ((PyObject *) error, 0))->tp_name);
+  release_interpreter (acquired);
+
+  return result;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NumKtException
+ * Method:    pythonStack
+ * Signature: (J)[Ljava/lang/StackTraceElement;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jetbrains_numkt_NumKtException_pythonStack
+    (JNIEnv *env, jclass jclazz, jlong error)
+{
+  int acquired = acquire_interpreter ();
+  jobjectArray result = python_stack (env, (PyObject *) error);
+  release_interpreter (acquired);
+
+  return result;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NumKtException
+ * Method:    release
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_NumKtException_release
+    (JNIEnv *env, jclass jclazz, jlong error)
+{
+  int acquired = acquire_interpreter ();
+  Py_DECREF ((PyObject *) error);
+  release_interpreter (acquired);
+}
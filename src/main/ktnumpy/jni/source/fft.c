@@ -0,0 +1,527 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/*
+ * Transforms of power-of-two lengths along one axis, batched over the other axes. A plan holds the
+ * bit-reversal permutation and the twiddle factors of every stage of an iterative radix-2 transform,
+ * plans are cached by length, real or complex input and direction, so the transforms of a size seen
+ * before only run the butterflies. A real transform of length n is the complex transform of length
+ * n / 2 of the even and odd samples packed as complex numbers, split afterwards. Other lengths and
+ * types are left to numpy. The cache is only touched with the GIL held, plans in use are not dropped.
+ */
+
+/* Plans kept, the least recently used are dropped first. */
+#define FFT_CACHE_SIZE 16
+
+/* Elements of a batch from which the rows are transformed in parallel. */
+#define FFT_PARALLEL_GRAIN (1 << 16)
+
+typedef struct FftPlan
+{
+  npy_intp n;
+  int real;
+  int forward;
+  // length of the complex transform, n / 2 for the real ones
+  npy_intp m;
+  npy_intp *bitrev;
+  // exp (-+i pi k / s) for the stage of the butterflies of half size s from 2 (s - 1), interleaved
+  double *twiddle;
+  // exp (-+2 i pi k / n) for k < m splitting the real transforms, interleaved
+  double *split;
+  int users;
+  struct FftPlan *next;
+} FftPlan;
+
+typedef struct
+{
+  const FftPlan *plan;
+  FftKind kind;
+  const char *in;
+  npy_intp in_length;
+  npy_intp in_stride;
+  char *out;
+  npy_intp out_doubles;
+  npy_intp out_stride;
+  double factor;
+} FftRows;
+
+static FftPlan *fft_plans = NULL;
+
+static void fft_plan_free (FftPlan *plan)
+{
+  free (plan->bitrev);
+  free (plan->twiddle);
+  free (plan->split);
+  free (plan);
+}
+
+static FftPlan *fft_plan_new (npy_intp n, int real, int forward)
+{
+  FftPlan *plan = calloc (1, sizeof (FftPlan));
+  double sign = forward ? -1.0 : 1.0;
+  int bits = 0;
+
+  if (plan == NULL)
+    {
+      return NULL;
+    }
+  plan->n = n;
+  plan->real = real;
+  plan->forward = forward;
+  plan->m = real ? n / 2 : n;
+  plan->bitrev = malloc (plan->m * sizeof (npy_intp));
+  plan->twiddle = malloc (2 * plan->m * sizeof (double));
+  plan->split = real ? malloc (2 * plan->m * sizeof (double)) : NULL;
+  if (plan->bitrev == NULL || plan->twiddle == NULL || (real && plan->split == NULL))
+    {
+      fft_plan_free (plan);
+      return NULL;
+    }
+
+  while (((npy_intp) 1 << bits) < plan->m)
+    {
+      ++bits;
+    }
+  for (npy_intp i = 0; i < plan->m; ++i)
+    {
+      npy_intp r = 0;
+      for (int b = 0; b < bits; ++b)
+        {
+          r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+      plan->bitrev[i] = r;
+    }
+  for (npy_intp s = 1; s < plan->m; s <<= 1)
+    {
+      for (npy_intp k = 0; k < s; ++k)
+        {
+          double angle = sign * M_PI * (double) k / (double) s;
+          plan->twiddle[2 * (s - 1 + k)] = cos (angle);
+          plan->twiddle[2 * (s - 1 + k) + 1] = sin (angle);
+        }
+    }
+  for (npy_intp k = 0; real && k < plan->m; ++k)
+    {
+      double angle = sign * 2.0 * M_PI * (double) k / (double) n;
+      plan->split[2 * k] = cos (angle);
+      plan->split[2 * k + 1] = sin (angle);
+    }
+  return plan;
+}
+
+/* Drops the unused plans after the first keep. */
+static void fft_plans_trim (int keep)
+{
+  FftPlan **link = &fft_plans;
+  int count = 0;
+
+  while (*link != NULL)
+    {
+      FftPlan *plan = *link;
+      if (count >= keep && plan->users == 0)
+        {
+          *link = plan->next;
+          fft_plan_free (plan);
+        }
+      else
+        {
+          ++count;
+          link = &plan->next;
+        }
+    }
+}
+
+static FftPlan *fft_plan_acquire (npy_intp n, int real, int forward)
+{
+  FftPlan **link = &fft_plans;
+  FftPlan *plan;
+
+  for (plan = fft_plans; plan != NULL; link = &plan->next, plan = plan->next)
+    {
+      if (plan->n == n && plan->real == real && plan->forward == forward)
+        {
+          *link = plan->next;
+          break;
+        }
+    }
+  if (plan == NULL)
+    {
+      plan = fft_plan_new (n, real, forward);
+      if (plan == NULL)
+        {
+          PyErr_NoMemory ();
+          return NULL;
+        }
+    }
+  plan->next = fft_plans;
+  fft_plans = plan;
+  plan->users++;
+  fft_plans_trim (FFT_CACHE_SIZE);
+  return plan;
+}
+
+static void fft_butterflies (const FftPlan *plan, double *x)
+{
+  npy_intp m = plan->m;
+
+  // the first stage has no twiddles
+  for (npy_intp j = 0; m > 1 && j < m; j += 2)
+    {
+      double *a = x + 2 * j;
+      double br = a[2], bi = a[3];
+      a[2] = a[0] - br;
+      a[3] = a[1] - bi;
+      a[0] += br;
+      a[1] += bi;
+    }
+  for (npy_intp s = 2; s < m; s <<= 1)
+    {
+      const double *w = plan->twiddle + 2 * (s - 1);
+      for (npy_intp j = 0; j < m; j += 2 * s)
+        {
+          double *a = x + 2 * j;
+          double *b = x + 2 * (j + s);
+          for (npy_intp k = 0; k < s; ++k)
+            {
+              double br = b[2 * k] * w[2 * k] - b[2 * k + 1] * w[2 * k + 1];
+              double bi = b[2 * k] * w[2 * k + 1] + b[2 * k + 1] * w[2 * k];
+              b[2 * k] = a[2 * k] - br;
+              b[2 * k + 1] = a[2 * k + 1] - bi;
+              a[2 * k] += br;
+              a[2 * k + 1] += bi;
+            }
+        }
+    }
+}
+
+/* Complex rows, the input is cut or padded with zeros to the length of the plan. */
+static void fft_complex_row (const FftPlan *plan, const double *in, npy_intp length, double *out)
+{
+  for (npy_intp k = 0; k < plan->m; ++k)
+    {
+      npy_intp r = plan->bitrev[k];
+      out[2 * r] = k < length ? in[2 * k] : 0.0;
+      out[2 * r + 1] = k < length ? in[2 * k + 1] : 0.0;
+    }
+  fft_butterflies (plan, out);
+}
+
+/* Real rows of n samples into n / 2 + 1 bins: X[k] = E[k] + W^k O[k] of the even and odd samples. */
+static void fft_real_row (const FftPlan *plan, const double *in, npy_intp length, double *out)
+{
+  npy_intp m = plan->m;
+  double z0r, z0i;
+
+  for (npy_intp k = 0; k < m; ++k)
+    {
+      npy_intp r = plan->bitrev[k];
+      out[2 * r] = 2 * k < length ? in[2 * k] : 0.0;
+      out[2 * r + 1] = 2 * k + 1 < length ? in[2 * k + 1] : 0.0;
+    }
+  fft_butterflies (plan, out);
+
+  z0r = out[0];
+  z0i = out[1];
+  out[0] = z0r + z0i;
+  out[1] = 0.0;
+  out[2 * m] = z0r - z0i;
+  out[2 * m + 1] = 0.0;
+  for (npy_intp k = 1; k <= m / 2; ++k)
+    {
+      npy_intp j = m - k;
+      const double *w = plan->split + 2 * k;
+      double ar = out[2 * k], ai = out[2 * k + 1];
+      double br = out[2 * j], bi = out[2 * j + 1];
+      // E = (Z[k] + conj Z[j]) / 2, O = -i (Z[k] - conj Z[j]) / 2
+      double er = 0.5 * (ar + br), ei = 0.5 * (ai - bi);
+      double or = 0.5 * (ai + bi), oi = -0.5 * (ar - br);
+      double tr = w[0] * or - w[1] * oi, ti = w[0] * oi + w[1] * or;
+      out[2 * k] = er + tr;
+      out[2 * k + 1] = ei + ti;
+      // X[m - k] = conj (E - W^k O)
+      out[2 * j] = er - tr;
+      out[2 * j + 1] = ti - ei;
+    }
+}
+
+/*
+ * n / 2 + 1 bins into n real samples, twice the inverse of the packed transform, the inverse of
+ * fft_real_row. The imaginary parts of the first and the last bin are ignored, as in numpy.
+ */
+static void fft_real_inverse_row (const FftPlan *plan, const double *in, npy_intp length, double *out)
+{
+  npy_intp m = plan->m;
+  double x0 = length > 0 ? in[0] : 0.0;
+  double xm = length > m ? in[2 * m] : 0.0;
+
+  out[2 * plan->bitrev[0]] = 0.5 * (x0 + xm);
+  out[2 * plan->bitrev[0] + 1] = 0.5 * (x0 - xm);
+  for (npy_intp k = 1; k < m; ++k)
+    {
+      npy_intp j = m - k;
+      npy_intp r = plan->bitrev[k];
+      const double *w = plan->split + 2 * k;
+      double ar = k < length ? in[2 * k] : 0.0, ai = k < length ? in[2 * k + 1] : 0.0;
+      double br = j < length ? in[2 * j] : 0.0, bi = j < length ? in[2 * j + 1] : 0.0;
+      // E = (X[k] + conj X[j]) / 2, O = (X[k] - conj X[j]) / 2 W^k, Z = E + i O
+      double er = 0.5 * (ar + br), ei = 0.5 * (ai - bi);
+      double dr = 0.5 * (ar - br), di = 0.5 * (ai + bi);
+      double or = dr * w[0] - di * w[1], oi = dr * w[1] + di * w[0];
+      out[2 * r] = er - oi;
+      out[2 * r + 1] = ei + or;
+    }
+  fft_butterflies (plan, out);
+}
+
+static void fft_rows_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  const FftRows *rows = ctx;
+
+  for (Py_ssize_t r = begin; r < end; ++r)
+    {
+      const double *in = (const double *) (rows->in + r * rows->in_stride);
+      double *out = (double *) (rows->out + r * rows->out_stride);
+      switch (rows->kind)
+        {
+          case FFT_REAL: fft_real_row (rows->plan, in, rows->in_length, out);
+          break;
+          case FFT_REAL_INVERSE: fft_real_inverse_row (rows->plan, in, rows->in_length, out);
+          break;
+          default: fft_complex_row (rows->plan, in, rows->in_length, out);
+        }
+      if (rows->factor != 1.0)
+        {
+          for (npy_intp i = 0; i < rows->out_doubles; ++i)
+            {
+              out[i] *= rows->factor;
+            }
+        }
+    }
+}
+
+static double fft_factor (npy_intp n, int inverse, FftNorm norm)
+{
+  if (norm == FFT_NORM_ORTHO)
+    {
+      return 1.0 / sqrt ((double) n);
+    }
+  // backward scales the inverse transforms, forward the forward ones
+  return (norm == FFT_NORM_BACKWARD) == inverse ? 1.0 / (double) n : 1.0;
+}
+
+static int fft_is_power_of_two (npy_intp n)
+{
+  return n > 0 && (n & (n - 1)) == 0;
+}
+
+/*
+ * Transform of a along axis into a new array or into out, returned in result. Returns 1 when the
+ * transform is left to numpy, -1 with a python error.
+ */
+static int fft_transform (PyArrayObject *a, npy_intp n, int axis, FftKind kind, FftNorm norm,
+                          PyArrayObject *out, PyArrayObject **result)
+{
+  int ndim = PyArray_NDIM (a);
+  int last = ndim - 1;
+  int real = kind == FFT_REAL || kind == FFT_REAL_INVERSE;
+  int inverse = kind == FFT_COMPLEX_INVERSE || kind == FFT_REAL_INVERSE;
+  int in_type = kind == FFT_REAL ? NPY_DOUBLE : NPY_CDOUBLE;
+  int out_type = kind == FFT_REAL_INVERSE ? NPY_DOUBLE : NPY_CDOUBLE;
+  PyArrayObject *moved = NULL, *src = NULL, *dst = NULL, *target = NULL;
+  PyArray_Descr *in_descr;
+  npy_intp dims[NPY_MAXDIMS];
+  FftPlan *plan = NULL;
+  FftRows rows;
+  int res = -1;
+
+  if (axis < 0)
+    {
+      axis += ndim;
+    }
+  if (ndim == 0 || axis < 0 || axis >= ndim || !fft_is_power_of_two (n) || (real && n < 2))
+    {
+      return 1;
+    }
+  in_descr = PyArray_DescrFromType (in_type);
+  if (!PyArray_CanCastTypeTo (PyArray_DESCR (a), in_descr, NPY_SAFE_CASTING))
+    {
+      Py_DECREF (in_descr);
+      return 1;
+    }
+
+  moved = (PyArrayObject *) PyArray_SwapAxes (a, axis, last);
+  if (moved == NULL)
+    {
+      Py_DECREF (in_descr);
+      return -1;
+    }
+  src = (PyArrayObject *) PyArray_FromAny ((PyObject *) moved, in_descr, 0, 0, NPY_ARRAY_CARRAY_RO, NULL);
+  if (src == NULL)
+    {
+      goto finally;
+    }
+
+  memcpy (dims, PyArray_DIMS (src), ndim * sizeof (npy_intp));
+  dims[last] = kind == FFT_REAL ? n / 2 + 1 : n;
+
+  if (out != NULL)
+    {
+      target = (PyArrayObject *) PyArray_SwapAxes (out, axis, last);
+      if (target == NULL)
+        {
+          goto finally;
+        }
+      if (PyArray_TYPE (out) != out_type || !PyArray_ISWRITEABLE (out)
+          || !PyArray_CompareLists (PyArray_DIMS (target), dims, ndim) || PyArray_NDIM (out) != ndim)
+        {
+          PyErr_Format (PyExc_ValueError, "out must be a writeable array of %s with the shape of the transform",
+                        out_type == NPY_DOUBLE ? "float64" : "complex128");
+          goto finally;
+        }
+      if (PyArray_IS_C_CONTIGUOUS (target) && PyArray_ISALIGNED (target))
+        {
+          Py_INCREF (target);
+          dst = target;
+        }
+    }
+  if (dst == NULL)
+    {
+      dst = (PyArrayObject *) PyArray_SimpleNew (ndim, dims, out_type);
+      if (dst == NULL)
+        {
+          goto finally;
+        }
+    }
+
+  rows.kind = kind;
+  rows.in = PyArray_BYTES (src);
+  rows.in_length = PyArray_DIM (src, last);
+  rows.in_stride = rows.in_length * PyArray_ITEMSIZE (src);
+  rows.out = PyArray_BYTES (dst);
+  rows.out_doubles = kind == FFT_REAL_INVERSE ? n : 2 * dims[last];
+  rows.out_stride = rows.out_doubles * sizeof (double);
+  rows.factor = fft_factor (n, inverse, norm) * (kind == FFT_REAL_INVERSE ? 2.0 : 1.0);
+
+  npy_intp count = PyArray_MultiplyList (dims, last);
+  if (count > 0)
+    {
+      plan = fft_plan_acquire (n, real, !inverse);
+      if (plan == NULL)
+        {
+          goto finally;
+        }
+      rows.plan = plan;
+      if (count > 1 && count * n >= FFT_PARALLEL_GRAIN)
+        {
+          Py_BEGIN_ALLOW_THREADS
+          thread_pool_parallel_for (count, FFT_PARALLEL_GRAIN / n + 1, fft_rows_task, &rows);
+          KTNUMPY_END_ALLOW_THREADS
+        }
+      else
+        {
+          fft_rows_task (&rows, 0, count);
+        }
+      plan->users--;
+    }
+
+  if (target != NULL && dst != target && PyArray_CopyInto (target, dst) < 0)
+    {
+      goto finally;
+    }
+  if (out != NULL)
+    {
+      Py_INCREF (out);
+      *result = out;
+    }
+  else
+    {
+      *result = (PyArrayObject *) PyArray_SwapAxes (dst, axis, last);
+      if (*result == NULL)
+        {
+          goto finally;
+        }
+    }
+  res = 0;
+
+  finally:
+  Py_DECREF (moved);
+  Py_XDECREF (src);
+  Py_XDECREF (dst);
+  Py_XDECREF (target);
+  return res;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_fft_NativeFft
+ * Method:    transform
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;IIIILorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_fft_NativeFft_transform
+    (JNIEnv *env, jclass jcl, jobject ja, jint n, jint axis, jint kind, jint norm, jobject jout)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  PyArrayObject *a = numkt_core_KtNDArray_getPointer (env, ja);
+  PyArrayObject *out = jout != NULL ? numkt_core_KtNDArray_getPointer (env, jout) : NULL;
+  PyArrayObject *result = NULL;
+  jobject jresult = NULL;
+
+  // null for the transforms which numpy does itself, out is returned as it is
+  if (fft_transform (a, n, axis, (FftKind) kind, (FftNorm) norm, out, &result) == 0)
+    {
+      if (out != NULL)
+        {
+          Py_DECREF (result);
+          jresult = jout;
+        }
+      else
+        {
+          jresult = new_ktndarray (env, result, NULL);
+        }
+    }
+  python_exception (env);
+
+  return jresult;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_fft_NativeFft
+ * Method:    cachedPlans
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_fft_NativeFft_cachedPlans
+    (JNIEnv *env, jclass jcl)
+{
+  jint count = 0;
+  for (FftPlan *plan = fft_plans; plan != NULL; plan = plan->next)
+    {
+      ++count;
+    }
+  return count;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_fft_NativeFft
+ * Method:    clearPlans
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_fft_NativeFft_clearPlans
+    (JNIEnv *env, jclass jcl)
+{
+  fft_plans_trim (0);
+}
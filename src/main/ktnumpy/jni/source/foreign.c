@@ -0,0 +1,211 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/*
+ * Entry points of the foreign function backend. The JVM resolves a numpy function once into a handle and
+ * then calls it with the arguments in native memory: a call crosses without local references, upcalls to
+ * unbox the arguments or a lookup of the function by name. The rest goes through JNI, errors included:
+ * a failed call leaves the Python error set for raisePending, which throws it as NumKtException.
+ */
+
+/* Returns a new reference to the attribute of numpy at the dotted path, or 0 with the Python error set. */
+int64_t ktnp_lookup (const char *path)
+{
+  NPY_IMPORT_ONCE (0)
+
+  PyObject *object = npModule;
+  const char *name = path;
+
+  Py_INCREF (object);
+  while (object != NULL && name != NULL)
+    {
+      const char *dot = strchr (name, '.');
+      PyObject *attribute = dot != NULL ? PyUnicode_FromStringAndSize (name, dot - name) : PyUnicode_FromString (name);
+      PyObject *next = attribute != NULL ? PyObject_GetAttr (object, attribute) : NULL;
+
+      Py_XDECREF (attribute);
+      Py_DECREF (object);
+      object = next;
+      name = dot != NULL ? dot + 1 : NULL;
+    }
+  if (object != NULL)
+    {
+      call_metrics_register (object, path);
+    }
+
+  return (int64_t) (intptr_t) object;
+}
+
+static PyObject *ktnp_value_to_pyobject (const KtnpValue *value)
+{
+  PyObject *object = NULL;
+
+  switch (value->tag)
+    {
+      case KTNP_NONE:
+        Py_RETURN_NONE;
+      case KTNP_BOOLEAN:
+        return PyBool_FromLong ((long) value->value.l);
+      case KTNP_LONG:
+        return PyLong_FromLongLong (value->value.l);
+      case KTNP_DOUBLE:
+        return PyFloat_FromDouble (value->value.d);
+      case KTNP_ARRAY:
+        object = (PyObject *) (intptr_t) value->value.l;
+        Py_INCREF (object);
+        return object;
+      default:
+        PyErr_Format (PyExc_TypeError, "Unknown tag %d of an argument.", value->tag);
+        return NULL;
+    }
+}
+
+/* Fills the array result, stealing the reference to the result. The memory is mapped as new_ktndarray maps it. */
+static int32_t ktnp_array_result (PyObject *py_res, KtnpArray *array)
+{
+  PyArrayObject *nparray = (PyArrayObject *) py_res;
+  PyArrayObject *memory = nparray;
+
+  array->array = (int64_t) (intptr_t) py_res;
+  if (!NpyArray_Check (py_res))
+    {
+      return KTNP_OBJECT;
+    }
+
+  // views are mapped over the memory of their base, as new_ktndarray does
+  if (NpyView_Check (nparray))
+    {
+      memory = (PyArrayObject *) PyArray_BASE (nparray);
+      array->offset = get_point (nparray);
+    }
+  else
+    {
+      array->offset = 0;
+    }
+  // larger than a ByteBuffer, JNI wraps it without one
+  if (PyArray_NBYTES (memory) > INT32_MAX)
+    {
+      return KTNP_OBJECT;
+    }
+  array->data = (int64_t) (intptr_t) PyArray_BYTES (memory);
+  array->nbytes = PyArray_NBYTES (memory);
+  array->writeable = PyArray_ISWRITEABLE (memory) ? 1 : 0;
+
+  if (call_events_enabled && PyArray_CHKFLAGS (nparray, NPY_ARRAY_OWNDATA))
+    {
+      events_push_array (EVENT_ARRAY_ALLOC, nparray);
+    }
+
+  return KTNP_OK;
+}
+
+/*
+ * Calls the function of the handle with n arguments. The result is written to out as the tag want asks:
+ * an int32_t truth value for KTNP_BOOLEAN, an int64_t for KTNP_LONG, a double for KTNP_DOUBLE
+ * and a KtnpArray for KTNP_ARRAY.
+ */
+int32_t ktnp_call (int64_t handle, const KtnpValue *args, int32_t n, int32_t want, void *out)
+{
+  PyObject *py_args = PyTuple_New (n);
+  PyObject *py_res = NULL;
+  int32_t status = KTNP_OK;
+  CallTiming timing;
+
+  if (py_args == NULL)
+    {
+      return KTNP_ERROR;
+    }
+  call_metrics_begin (&timing);
+  for (int32_t i = 0; i < n; ++i)
+    {
+      PyObject *arg = ktnp_value_to_pyobject (&args[i]);
+      if (arg == NULL)
+        {
+          Py_DECREF (py_args);
+          return KTNP_ERROR;
+        }
+      PyTuple_SET_ITEM (py_args, i, arg);
+    }
+
+  call_metrics_converted (NULL, &timing, NULL, (PyObject *) (intptr_t) handle, py_args);
+  py_res = PyObject_Call ((PyObject *) (intptr_t) handle, py_args, NULL);
+  call_metrics_executed (&timing, py_res);
+  Py_DECREF (py_args);
+  if (py_res == NULL)
+    {
+      call_metrics_end (&timing, 0);
+      return KTNP_ERROR;
+    }
+
+  switch (want)
+    {
+      case KTNP_BOOLEAN:
+        *(int32_t *) out = pyobject_as_boolean (py_res) > 0;
+        break;
+      case KTNP_LONG:
+        *(int64_t *) out = pyobject_as_long (py_res);
+        break;
+      case KTNP_DOUBLE:
+        *(double *) out = pyobject_as_double (py_res);
+        break;
+      default:
+        status = ktnp_array_result (py_res, (KtnpArray *) out);
+        call_metrics_end (&timing, 1);
+        return status;
+    }
+
+  Py_DECREF (py_res);
+  if (PyErr_Occurred ())
+    {
+      status = KTNP_ERROR;
+    }
+  call_metrics_end (&timing, status != KTNP_ERROR);
+  return status;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_ForeignBridge
+ * Method:    raisePending
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_ForeignBridge_raisePending
+    (JNIEnv *env, jclass jcl)
+{
+  python_exception (env);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_ForeignBridge
+ * Method:    wrap
+ * Signature: (J)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_ForeignBridge_wrap
+    (JNIEnv *env, jclass jcl, jlong pointer)
+{
+  PyObject *object = (PyObject *) pointer;
+  jobject result = NULL;
+
+  // the same conversion as invoke_call_function
+  if (NpyArray_Check (object))
+    {
+      return new_ktndarray (env, (PyArrayObject *) object, NULL);
+    }
+  result = new_ktndarray (env, NULL, pyobject_to_jobject (env, object, OBJECT_TYPE));
+  Py_DECREF (object);
+  return result;
+}
@@ -0,0 +1,824 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+#include "numpy/random/bitgen.h"
+#include "numpy/random/distributions.h"
+
+/*
+ * numpy.random.Generator with the C state of its bit generator.
+ * The fill functions use only the C state and numpy's distributions library,
+ * so they neither call the interpreter nor need the GIL.
+ */
+typedef struct
+{
+  PyObject *generator;
+  bitgen_t *bitgen;
+} KtGeneratorObject;
+
+static jlong generator_wrap (PyObject *generator)
+{
+  KtGeneratorObject *this = NULL;
+  PyObject *bit_generator = NULL;
+  PyObject *capsule = NULL;
+  bitgen_t *bitgen = NULL;
+
+  bit_generator = PyObject_GetAttrString (generator, "bit_generator");
+  if (bit_generator != NULL)
+    {
+      capsule = PyObject_GetAttrString (bit_generator, "capsule");
+    }
+  if (capsule != NULL)
+    {
+      bitgen = (bitgen_t *) PyCapsule_GetPointer (capsule, "BitGenerator");
+    }
+  if (bitgen != NULL)
+    {
+      this = (KtGeneratorObject *) malloc (sizeof (KtGeneratorObject));
+      if (this == NULL)
+        {
+          PyErr_NoMemory ();
+        }
+      else
+        {
+          // the generator keeps the bit generator and its state alive
+          Py_INCREF (generator);
+          this->generator = generator;
+          this->bitgen = bitgen;
+        }
+    }
+
+  Py_XDECREF (capsule);
+  Py_XDECREF (bit_generator);
+  return (jlong) this;
+}
+
+/* Generator over a new bit generator of the same type as of the given one. */
+static PyObject *generator_from_bit_generator (PyObject *bit_generator_type, PyObject *arg)
+{
+  PyObject *np_random = NULL;
+  PyObject *bit_generator = NULL;
+  PyObject *generator = NULL;
+
+  np_random = PyImport_ImportModule ("numpy.random");
+  if (np_random != NULL)
+    {
+      bit_generator = arg == NULL ? NULL : PyObject_CallFunctionObjArgs (bit_generator_type, arg, NULL);
+    }
+  if (bit_generator != NULL)
+    {
+      generator = PyObject_CallMethod (np_random, "Generator", "O", bit_generator);
+    }
+
+  Py_XDECREF (bit_generator);
+  Py_XDECREF (np_random);
+  return generator;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    generatorNew
+ * Signature: (Ljava/lang/String;Ljava/lang/Long;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_random_KtGenerator_generatorNew
+    (JNIEnv *env, jclass jcl, jstring jbit_generator, jobject jseed)
+{
+  const char *name = jstring_to_char (env, jbit_generator);
+  PyObject *np_random = NULL;
+  PyObject *bit_generator_type = NULL;
+  PyObject *seed = NULL;
+  PyObject *generator = NULL;
+  jlong result = 0;
+
+  np_random = PyImport_ImportModule ("numpy.random");
+  if (np_random != NULL)
+    {
+      bit_generator_type = PyObject_GetAttrString (np_random, name);
+    }
+  if (bit_generator_type != NULL)
+    {
+      if (jseed != NULL)
+        {
+          seed = jobject_to_pyobject (env, jseed);
+        }
+      else
+        {
+          // fresh entropy from the OS
+          Py_INCREF (Py_None);
+          seed = Py_None;
+        }
+      generator = generator_from_bit_generator (bit_generator_type, seed);
+    }
+  if (generator != NULL)
+    {
+      result = generator_wrap (generator);
+    }
+
+  Py_XDECREF (generator);
+  Py_XDECREF (seed);
+  Py_XDECREF (bit_generator_type);
+  Py_XDECREF (np_random);
+  python_exception (env);
+  release_utf_char (env, jbit_generator, name);
+
+  return result;
+}
+
+static jlongArray generator_spawn (JNIEnv *env, KtGeneratorObject *this, jint n)
+{
+  PyObject *bit_generator = NULL;
+  PyObject *seed_seq = NULL;
+  PyObject *children = NULL;
+  jlong *pointers = NULL;
+  jlongArray result = NULL;
+  jint count = 0;
+
+  pointers = (jlong *) calloc (n > 0 ? (size_t) n : 1, sizeof (jlong));
+  if (pointers == NULL)
+    {
+      PyErr_NoMemory ();
+      goto OUT;
+    }
+
+  bit_generator = PyObject_GetAttrString (this->generator, "bit_generator");
+  if (bit_generator == NULL)
+    {
+      goto OUT;
+    }
+  // public since numpy 1.25
+  seed_seq = PyObject_GetAttrString (bit_generator, "seed_seq");
+  if (seed_seq == NULL)
+    {
+      PyErr_Clear ();
+      seed_seq = PyObject_GetAttrString (bit_generator, "_seed_seq");
+    }
+  if (seed_seq == NULL)
+    {
+      goto OUT;
+    }
+
+  children = PyObject_CallMethod (seed_seq, "spawn", "i", (int) n);
+  if (children == NULL)
+    {
+      goto OUT;
+    }
+
+  for (; count < n; ++count)
+    {
+      PyObject *generator = generator_from_bit_generator ((PyObject *) Py_TYPE (bit_generator),
+                                                          PyList_GetItem (children, count));
+      if (generator == NULL)
+        {
+          break;
+        }
+      pointers[count] = generator_wrap (generator);
+      Py_DECREF (generator);
+      if (pointers[count] == 0)
+        {
+          break;
+        }
+    }
+
+  if (count == n)
+    {
+      result = (*env)->NewLongArray (env, n);
+      if (result != NULL)
+        {
+          (*env)->SetLongArrayRegion (env, result, 0, n, pointers);
+        }
+    }
+  else
+    {
+      for (jint i = 0; i < count; ++i)
+        {
+          Py_DECREF (((KtGeneratorObject *) pointers[i])->generator);
+          free ((KtGeneratorObject *) pointers[i]);
+        }
+    }
+
+  OUT:
+  free (pointers);
+  Py_XDECREF (children);
+  Py_XDECREF (seed_seq);
+  Py_XDECREF (bit_generator);
+  python_exception (env);
+
+  return result;
+}
+
+typedef struct
+{
+  JNIEnv *env;
+  KtGeneratorObject *this;
+  jint n;
+  jlongArray result;
+} GeneratorSpawn;
+
+static void generator_spawn_run (void *ptr)
+{
+  GeneratorSpawn *spawn = (GeneratorSpawn *) ptr;
+
+  spawn->result = generator_spawn (spawn->env, spawn->this, spawn->n);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    generatorSpawn
+ * Signature: (JI)[J
+ */
+JNIEXPORT jlongArray JNICALL Java_org_jetbrains_numkt_random_KtGenerator_generatorSpawn
+    (JNIEnv *env, jobject jobj, jlong ptr, jint n)
+{
+  GeneratorSpawn spawn = {env, (KtGeneratorObject *) ptr, n, NULL};
+
+  // threadLocal spawns on the thread which first asks for its generator
+  run_with_interpreter (generator_spawn_run, &spawn);
+  return spawn.result;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    generatorJumped
+ * Signature: (JI)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_random_KtGenerator_generatorJumped
+    (JNIEnv *env, jobject jobj, jlong ptr, jint jumps)
+{
+  KtGeneratorObject *this = (KtGeneratorObject *) ptr;
+  PyObject *np_random = NULL;
+  PyObject *bit_generator = NULL;
+  PyObject *jumped = NULL;
+  PyObject *generator = NULL;
+  jlong result = 0;
+
+  np_random = PyImport_ImportModule ("numpy.random");
+  if (np_random != NULL)
+    {
+      bit_generator = PyObject_GetAttrString (this->generator, "bit_generator");
+    }
+  if (bit_generator != NULL)
+    {
+      jumped = PyObject_CallMethod (bit_generator, "jumped", "i", (int) jumps);
+    }
+  if (jumped != NULL)
+    {
+      generator = PyObject_CallMethod (np_random, "Generator", "O", jumped);
+    }
+  if (generator != NULL)
+    {
+      result = generator_wrap (generator);
+    }
+
+  Py_XDECREF (generator);
+  Py_XDECREF (jumped);
+  Py_XDECREF (bit_generator);
+  Py_XDECREF (np_random);
+  python_exception (env);
+
+  return result;
+}
+
+/* Writeable single-segment output, does not call the interpreter. */
+static PyArrayObject *generator_out (JNIEnv *env, jobject jout)
+{
+  PyArrayObject *out = numkt_core_KtNDArray_getPointer (env, jout);
+
+  if (out == NULL)
+    {
+      return NULL;
+    }
+  if (!PyArray_ISONESEGMENT (out) || !PyArray_ISWRITEABLE (out) || !PyArray_ISALIGNED (out)
+      || !PyArray_ISNOTSWAPPED (out))
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Output array must be contiguous, aligned and writeable.");
+      return NULL;
+    }
+  return out;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillRandom
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillRandom
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject jout)
+{
+  KtGeneratorObject *this = (KtGeneratorObject *) ptr;
+  PyArrayObject *out = generator_out (env, jout);
+
+  if (out == NULL)
+    {
+      return;
+    }
+  switch (PyArray_TYPE (out))
+    {
+      case NPY_FLOAT64:
+        random_standard_uniform_fill (this->bitgen, PyArray_SIZE (out), (double *) PyArray_DATA (out));
+      break;
+      case NPY_FLOAT32:
+        random_standard_uniform_fill_f (this->bitgen, PyArray_SIZE (out), (float *) PyArray_DATA (out));
+      break;
+      default:
+        (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Output array must be of type float64 or float32.");
+    }
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillStandardNormal
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillStandardNormal
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject jout)
+{
+  KtGeneratorObject *this = (KtGeneratorObject *) ptr;
+  PyArrayObject *out = generator_out (env, jout);
+
+  if (out == NULL)
+    {
+      return;
+    }
+  switch (PyArray_TYPE (out))
+    {
+      case NPY_FLOAT64:
+        random_standard_normal_fill (this->bitgen, PyArray_SIZE (out), (double *) PyArray_DATA (out));
+      break;
+      case NPY_FLOAT32:
+        random_standard_normal_fill_f (this->bitgen, PyArray_SIZE (out), (float *) PyArray_DATA (out));
+      break;
+      default:
+        (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Output array must be of type float64 or float32.");
+    }
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillStandardExponential
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillStandardExponential
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject jout)
+{
+  KtGeneratorObject *this = (KtGeneratorObject *) ptr;
+  PyArrayObject *out = generator_out (env, jout);
+
+  if (out == NULL)
+    {
+      return;
+    }
+  switch (PyArray_TYPE (out))
+    {
+      case NPY_FLOAT64:
+        random_standard_exponential_fill (this->bitgen, PyArray_SIZE (out), (double *) PyArray_DATA (out));
+      break;
+      case NPY_FLOAT32:
+        random_standard_exponential_fill_f (this->bitgen, PyArray_SIZE (out), (float *) PyArray_DATA (out));
+      break;
+      default:
+        (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Output array must be of type float64 or float32.");
+    }
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillIntegers
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;JJ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillIntegers
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject jout, jlong low, jlong high)
+{
+  KtGeneratorObject *this = (KtGeneratorObject *) ptr;
+  PyArrayObject *out = generator_out (env, jout);
+  jlong min, max;
+  npy_intp n;
+  void *data;
+
+  if (out == NULL)
+    {
+      return;
+    }
+  switch (PyArray_TYPE (out))
+    {
+      case NPY_INT64: min = NPY_MIN_INT64; max = NPY_MAX_INT64;
+      break;
+      case NPY_INT32: min = NPY_MIN_INT32; max = NPY_MAX_INT32;
+      break;
+      case NPY_INT16: min = NPY_MIN_INT16; max = NPY_MAX_INT16;
+      break;
+      case NPY_INT8: min = NPY_MIN_INT8; max = NPY_MAX_INT8;
+      break;
+      default:
+        (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Output array must be of a signed integer type.");
+      return;
+    }
+  if (low >= high || low < min || high - 1 > max)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Range [low, high) is empty or out of bounds of the output type.");
+      return;
+    }
+
+  // the same calls as Generator.integers(low, high) makes, so the streams match
+  n = PyArray_SIZE (out);
+  data = PyArray_DATA (out);
+  switch (PyArray_TYPE (out))
+    {
+      case NPY_INT64:
+        random_bounded_uint64_fill (this->bitgen, (uint64_t) low, (uint64_t) (high - 1) - (uint64_t) low, n, false,
+                                    (uint64_t *) data);
+      break;
+      case NPY_INT32:
+        random_bounded_uint32_fill (this->bitgen, (uint32_t) low, (uint32_t) ((uint64_t) (high - 1) - (uint64_t) low),
+                                    n, false, (uint32_t *) data);
+      break;
+      case NPY_INT16:
+        random_bounded_uint16_fill (this->bitgen, (uint16_t) low, (uint16_t) ((uint64_t) (high - 1) - (uint64_t) low),
+                                    n, false, (uint16_t *) data);
+      break;
+      case NPY_INT8:
+        random_bounded_uint8_fill (this->bitgen, (uint8_t) low, (uint8_t) ((uint64_t) (high - 1) - (uint64_t) low),
+                                   n, false, (uint8_t *) data);
+      break;
+    }
+}
+
+/* Kinds of org.jetbrains.numkt.random.Distribution, integer targets are always uniform integers. */
+enum
+{
+  FILL_UNIFORM, FILL_NORMAL, FILL_EXPONENTIAL
+};
+
+/* Elements filled by one sub-stream of a parallel fill, fixed so that the result does not depend on threads. */
+#define FILL_BLOCK (1 << 18)
+
+typedef struct
+{
+  bitgen_t **bitgens;
+  char *out;
+  npy_intp n;
+  int type_num;
+  int distribution;
+  double a;
+  double b;
+  uint64_t low;
+  uint64_t rng;
+} GeneratorFillTask;
+
+static void fill_block (GeneratorFillTask *task, bitgen_t *bitgen, npy_intp begin, npy_intp end)
+{
+  npy_intp n = end - begin;
+  npy_intp i;
+
+  switch (task->type_num)
+    {
+      case NPY_FLOAT64:
+        {
+          double *out = (double *) task->out + begin;
+          switch (task->distribution)
+            {
+              case FILL_UNIFORM:
+                random_standard_uniform_fill (bitgen, n, out);
+              break;
+              case FILL_NORMAL:
+                random_standard_normal_fill (bitgen, n, out);
+              break;
+              default:
+                random_standard_exponential_fill (bitgen, n, out);
+            }
+          // the same transforms as of Generator.uniform, normal and exponential
+          if (task->distribution == FILL_EXPONENTIAL)
+            {
+              for (i = 0; i < n; ++i) out[i] = task->b * out[i];
+            }
+          else
+            {
+              for (i = 0; i < n; ++i) out[i] = task->a + task->b * out[i];
+            }
+        }
+      break;
+      case NPY_FLOAT32:
+        {
+          float *out = (float *) task->out + begin;
+          switch (task->distribution)
+            {
+              case FILL_UNIFORM:
+                random_standard_uniform_fill_f (bitgen, n, out);
+              break;
+              case FILL_NORMAL:
+                random_standard_normal_fill_f (bitgen, n, out);
+              break;
+              default:
+                random_standard_exponential_fill_f (bitgen, n, out);
+            }
+          if (task->distribution == FILL_EXPONENTIAL)
+            {
+              for (i = 0; i < n; ++i) out[i] = (float) (task->b * out[i]);
+            }
+          else
+            {
+              for (i = 0; i < n; ++i) out[i] = (float) (task->a + task->b * out[i]);
+            }
+        }
+      break;
+      case NPY_INT64:
+        random_bounded_uint64_fill (bitgen, task->low, task->rng, n, false, (uint64_t *) task->out + begin);
+      break;
+    }
+}
+
+static void fill_blocks_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  GeneratorFillTask *task = (GeneratorFillTask *) ctx;
+
+  for (Py_ssize_t block = begin; block < end; ++block)
+    {
+      npy_intp first = block * FILL_BLOCK;
+      fill_block (task, task->bitgens[block], first, first + FILL_BLOCK < task->n ? first + FILL_BLOCK : task->n);
+    }
+}
+
+/*
+ * Bit generators of the blocks of a parallel fill: the generator itself and the streams jumped 1, 2, ... times
+ * from it. Afterwards the generator continues from the stream after the last block.
+ * Returns the number of blocks, 1 if the fill is serial, or -1 with a Python error set.
+ */
+static npy_intp fill_streams (KtGeneratorObject *this, npy_intp n, int parallel, PyObject **streams,
+                              bitgen_t ***bitgens)
+{
+  npy_intp blocks = (n + FILL_BLOCK - 1) / FILL_BLOCK;
+  PyObject *bit_generator = NULL;
+  PyObject *stream = NULL;
+  npy_intp i;
+
+  *streams = NULL;
+  *bitgens = NULL;
+  // the blocks do not depend on the threads, the pool runs them in turn when it has one
+  if (!parallel || blocks < 2)
+    {
+      return 1;
+    }
+
+  bit_generator = PyObject_GetAttrString (this->generator, "bit_generator");
+  if (bit_generator == NULL)
+    {
+      return -1;
+    }
+  // not every bit generator can jump, SFC64 for one
+  if (!PyObject_HasAttrString (bit_generator, "jumped"))
+    {
+      Py_DECREF (bit_generator);
+      return 1;
+    }
+
+  *streams = PyList_New (blocks + 1);
+  *bitgens = (bitgen_t **) malloc (blocks * sizeof (bitgen_t *));
+  if (*streams == NULL || *bitgens == NULL)
+    {
+      goto ERROR;
+    }
+
+  Py_INCREF (bit_generator);
+  PyList_SET_ITEM (*streams, 0, bit_generator);
+  (*bitgens)[0] = this->bitgen;
+  for (i = 1; i <= blocks; ++i)
+    {
+      PyObject *capsule = NULL;
+
+      stream = PyObject_CallMethod (PyList_GET_ITEM (*streams, i - 1), "jumped", NULL);
+      if (stream == NULL)
+        {
+          goto ERROR;
+        }
+      PyList_SET_ITEM (*streams, i, stream);
+      if (i == blocks)
+        {
+          break;
+        }
+      capsule = PyObject_GetAttrString (stream, "capsule");
+      if (capsule == NULL)
+        {
+          goto ERROR;
+        }
+      (*bitgens)[i] = (bitgen_t *) PyCapsule_GetPointer (capsule, "BitGenerator");
+      Py_DECREF (capsule);
+      if ((*bitgens)[i] == NULL)
+        {
+          goto ERROR;
+        }
+    }
+
+  Py_DECREF (bit_generator);
+  return blocks;
+
+  ERROR:
+  if (!PyErr_Occurred ())
+    {
+      PyErr_NoMemory ();
+    }
+  Py_DECREF (bit_generator);
+  Py_CLEAR (*streams);
+  free (*bitgens);
+  *bitgens = NULL;
+  return -1;
+}
+
+/* Moves the generator past the streams used by a parallel fill. */
+static void fill_streams_finish (KtGeneratorObject *this, npy_intp blocks, PyObject *streams)
+{
+  PyObject *bit_generator = PyList_GET_ITEM (streams, 0);
+  PyObject *state = PyObject_GetAttrString (PyList_GET_ITEM (streams, blocks), "state");
+
+  if (state != NULL)
+    {
+      PyObject_SetAttrString (bit_generator, "state", state);
+      Py_DECREF (state);
+    }
+}
+
+/* Checks the target and the parameters, returns the numpy type of the elements or -1 with an exception thrown. */
+static int fill_prepare (JNIEnv *env, jclass dtype, jint distribution, jdouble b, jlong low, jlong high,
+                         GeneratorFillTask *task)
+{
+  PyObject *type = jclass_to_dtype (env, dtype);
+
+  if (type == NULL)
+    {
+      return -1;
+    }
+  task->type_num = type == NP_FLOAT64 ? NPY_FLOAT64 : type == NP_FLOAT32 ? NPY_FLOAT32
+                                                                         : type == NP_INT64 ? NPY_INT64 : -1;
+  if (task->type_num < 0)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Target must be of type double, float or long.");
+      return -1;
+    }
+  if (task->type_num == NPY_INT64 && low >= high)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Range [low, high) is empty.");
+      return -1;
+    }
+  if (task->type_num != NPY_INT64 && (distribution < FILL_UNIFORM || distribution > FILL_EXPONENTIAL || b < 0))
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Unknown distribution or negative scale.");
+      return -1;
+    }
+  task->distribution = distribution;
+  task->low = (uint64_t) low;
+  task->rng = (uint64_t) (high - 1) - (uint64_t) low;
+  return task->type_num;
+}
+
+/*
+ * A fill can be called on any thread: the streams are set up and finished with the interpreter held,
+ * the values are generated in between with no Python state, as the target may be a critical JVM array.
+ */
+typedef struct
+{
+  JNIEnv *env;
+  KtGeneratorObject *this;
+  GeneratorFillTask *task;
+  int parallel;
+  int filled;
+  npy_intp blocks;
+  PyObject *streams;
+} GeneratorFill;
+
+static void fill_begin (void *ptr)
+{
+  GeneratorFill *fill = (GeneratorFill *) ptr;
+
+  fill->blocks = fill_streams (fill->this, fill->task->n, fill->parallel, &fill->streams, &fill->task->bitgens);
+  if (fill->blocks < 0)
+    {
+      python_exception (fill->env);
+    }
+}
+
+static void fill_end (void *ptr)
+{
+  GeneratorFill *fill = (GeneratorFill *) ptr;
+
+  if (fill->filled && fill->blocks > 1)
+    {
+      fill_streams_finish (fill->this, fill->blocks, fill->streams);
+    }
+  Py_XDECREF (fill->streams);
+  python_exception (fill->env);
+}
+
+static void fill_run (GeneratorFill *fill)
+{
+  if (fill->blocks == 1)
+    {
+      fill_block (fill->task, fill->this->bitgen, 0, fill->task->n);
+    }
+  else
+    {
+      thread_pool_parallel_for (fill->blocks, 1, fill_blocks_task, fill->task);
+    }
+  fill->filled = 1;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillPrimitiveArray
+ * Signature: (JLjava/lang/Object;Ljava/lang/Class;IDDJJZ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillPrimitiveArray
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject array, jclass dtype, jint distribution, jdouble a, jdouble b,
+     jlong low, jlong high, jboolean parallel)
+{
+  GeneratorFillTask task = {NULL, NULL, 0, 0, 0, a, b, 0, 0};
+  GeneratorFill fill = {env, (KtGeneratorObject *) ptr, &task, parallel == JNI_TRUE, 0, 0, NULL};
+
+  if (fill_prepare (env, dtype, distribution, b, low, high, &task) < 0)
+    {
+      return;
+    }
+  task.n = (*env)->GetArrayLength (env, (jarray) array);
+  run_with_interpreter (fill_begin, &fill);
+  if (fill.blocks < 0)
+    {
+      return;
+    }
+
+  // no JNI calls and no waiting for the interpreter until the array is released
+  task.out = (char *) (*env)->GetPrimitiveArrayCritical (env, (jarray) array, NULL);
+  if (task.out != NULL)
+    {
+      fill_run (&fill);
+      (*env)->ReleasePrimitiveArrayCritical (env, (jarray) array, task.out, 0);
+    }
+
+  run_with_interpreter (fill_end, &fill);
+  free (task.bitgens);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    fillDirectBuffer
+ * Signature: (JLjava/nio/Buffer;JJLjava/lang/Class;IDDJJZ)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_fillDirectBuffer
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject buffer, jlong offset, jlong count, jclass dtype,
+     jint distribution, jdouble a, jdouble b, jlong low, jlong high, jboolean parallel)
+{
+  GeneratorFillTask task = {NULL, NULL, 0, 0, 0, a, b, 0, 0};
+  GeneratorFill fill = {env, (KtGeneratorObject *) ptr, &task, parallel == JNI_TRUE, 0, 0, NULL};
+  char *address = NULL;
+
+  if (fill_prepare (env, dtype, distribution, b, low, high, &task) < 0)
+    {
+      return;
+    }
+  address = (char *) (*env)->GetDirectBufferAddress (env, buffer);
+  if (address == NULL)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Buffer must be direct.");
+      return;
+    }
+  task.out = address + offset;
+  task.n = (npy_intp) count;
+  run_with_interpreter (fill_begin, &fill);
+  if (fill.blocks < 0)
+    {
+      return;
+    }
+
+  fill_run (&fill);
+  run_with_interpreter (fill_end, &fill);
+  free (task.bitgens);
+}
+
+static void generator_release (void *generator)
+{
+  Py_DECREF ((PyObject *) generator);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_random_KtGenerator
+ * Method:    generatorDealloc
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_random_KtGenerator_generatorDealloc
+    (JNIEnv *env, jobject jobj, jlong ptr)
+{
+  KtGeneratorObject *this = (KtGeneratorObject *) ptr;
+
+  // called by close on the thread of the interpreter or by the finalizer
+  run_with_interpreter (generator_release, this->generator);
+  free (this);
+}
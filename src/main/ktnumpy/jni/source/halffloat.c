@@ -0,0 +1,258 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HALF_F16C 1
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define HALF_NEON 1
+#include <arm_neon.h>
+#endif
+
+/*
+ * float16 storage of the arrays: the scalar conversions of the java and python values,
+ * and the bulk widening and narrowing of whole arrays to and from float32 for the JVM.
+ */
+
+float half_to_float (npy_half h)
+{
+  npy_uint32 sign = ((npy_uint32) h & 0x8000u) << 16;
+  npy_uint32 exponent = (h >> 10) & 0x1fu;
+  npy_uint32 mantissa = h & 0x3ffu;
+  npy_uint32 bits;
+  float f;
+
+  if (exponent == 0)
+    {
+      if (mantissa == 0)
+        {
+          bits = sign;
+        }
+      else
+        {
+          // subnormal, normalized for the wider exponent
+          exponent = 113;
+          while (!(mantissa & 0x400u))
+            {
+              mantissa <<= 1;
+              exponent--;
+            }
+          bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+        }
+    }
+  else if (exponent == 0x1f)
+    {
+      bits = sign | 0x7f800000u | (mantissa << 13);
+    }
+  else
+    {
+      bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+  memcpy (&f, &bits, sizeof (f));
+  return f;
+}
+
+npy_half float_to_half (float f)
+{
+  npy_uint32 x;
+  npy_uint32 sign;
+  npy_uint32 h;
+  npy_uint32 rest;
+  npy_uint32 halfway;
+
+  memcpy (&x, &f, sizeof (x));
+  sign = (x >> 16) & 0x8000u;
+  x &= 0x7fffffffu;
+
+  if (x > 0x7f800000u)
+    {
+      // NaN keeps the top of its payload and stays a NaN
+      h = 0x7c00u | ((x & 0x7fffffu) >> 13);
+      return (npy_half) (sign | (h == 0x7c00u ? h + 1 : h));
+    }
+  if (x >= 0x47800000u)
+    {
+      return (npy_half) (sign | 0x7c00u);
+    }
+  if (x < 0x38800000u)
+    {
+      // subnormal or zero in float16
+      npy_uint32 shift;
+      if (x < 0x33000000u)
+        {
+          return (npy_half) sign;
+        }
+      shift = 126 - (x >> 23);
+      x = (x & 0x7fffffu) | 0x800000u;
+      h = x >> shift;
+      rest = x & ((1u << shift) - 1);
+      halfway = 1u << (shift - 1);
+    }
+  else
+    {
+      h = (x - 0x38000000u) >> 13;
+      rest = x & 0x1fffu;
+      halfway = 0x1000u;
+    }
+
+  // ties to even, a carry out of the mantissa rounds up to the next exponent or to infinity
+  if (rest > halfway || (rest == halfway && (h & 1)))
+    {
+      h++;
+    }
+  return (npy_half) (sign | h);
+}
+
+#ifdef HALF_F16C
+static int has_f16c (void)
+{
+  static int supported = -1;
+  if (supported < 0)
+    {
+      unsigned int eax, ebx, ecx, edx;
+      int f16c = 0;
+      // F16C is VEX encoded, so the OS must save the AVX state as well
+      if (__get_cpuid (1, &eax, &ebx, &ecx, &edx) && (ecx & bit_F16C) && (ecx & bit_AVX) && (ecx & bit_OSXSAVE))
+        {
+          unsigned int xcr0_lo, xcr0_hi;
+          __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+          f16c = (xcr0_lo & 0x6) == 0x6;
+        }
+      supported = f16c;
+    }
+  return supported;
+}
+
+__attribute__ ((target ("avx,f16c")))
+static npy_intp halves_to_floats_f16c (const npy_half *src, float *dst, npy_intp n)
+{
+  npy_intp i = 0;
+  for (; i + 8 <= n; i += 8)
+    {
+      __m128i h = _mm_loadu_si128 ((const __m128i *) (src + i));
+      _mm256_storeu_ps (dst + i, _mm256_cvtph_ps (h));
+    }
+  return i;
+}
+
+__attribute__ ((target ("avx,f16c")))
+static npy_intp floats_to_halves_f16c (const float *src, npy_half *dst, npy_intp n)
+{
+  npy_intp i = 0;
+  for (; i + 8 <= n; i += 8)
+    {
+      __m256 f = _mm256_loadu_ps (src + i);
+      _mm_storeu_si128 ((__m128i *) (dst + i), _mm256_cvtps_ph (f, _MM_FROUND_TO_NEAREST_INT));
+    }
+  return i;
+}
+#endif
+
+void halves_to_floats (const npy_half *src, float *dst, npy_intp n)
+{
+  npy_intp i = 0;
+#if defined(HALF_F16C)
+  if (has_f16c ())
+    {
+      i = halves_to_floats_f16c (src, dst, n);
+    }
+#elif defined(HALF_NEON)
+  for (; i + 4 <= n; i += 4)
+    {
+      vst1q_f32 (dst + i, vcvt_f32_f16 (vreinterpret_f16_u16 (vld1_u16 (src + i))));
+    }
+#endif
+  for (; i < n; ++i)
+    {
+      dst[i] = half_to_float (src[i]);
+    }
+}
+
+void floats_to_halves (const float *src, npy_half *dst, npy_intp n)
+{
+  npy_intp i = 0;
+#if defined(HALF_F16C)
+  if (has_f16c ())
+    {
+      i = floats_to_halves_f16c (src, dst, n);
+    }
+#elif defined(HALF_NEON)
+  for (; i + 4 <= n; i += 4)
+    {
+      vst1_u16 (dst + i, vreinterpret_u16_f16 (vcvt_f16_f32 (vld1q_f32 (src + i))));
+    }
+#endif
+  for (; i < n; ++i)
+    {
+      dst[i] = float_to_half (src[i]);
+    }
+}
+
+/*
+ * Class:     org_jetbrains_numkt_HalfFloats
+ * Method:    widen
+ * Signature: (Ljava/nio/ByteBuffer;I[FI)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_HalfFloats_widen
+    (JNIEnv *env, jclass jcl, jobject src, jint offset, jfloatArray dst, jint n)
+{
+  char *address = (*env)->GetDirectBufferAddress (env, src);
+  float *floats;
+
+  if (address == NULL)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "float16 data is not a direct buffer.");
+      return;
+    }
+
+  floats = (*env)->GetPrimitiveArrayCritical (env, dst, NULL);
+  if (floats == NULL)
+    {
+      return;
+    }
+  halves_to_floats ((const npy_half *) (address + offset), floats, n);
+  (*env)->ReleasePrimitiveArrayCritical (env, dst, floats, 0);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_HalfFloats
+ * Method:    narrow
+ * Signature: ([FLjava/nio/ByteBuffer;II)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_HalfFloats_narrow
+    (JNIEnv *env, jclass jcl, jfloatArray src, jobject dst, jint offset, jint n)
+{
+  char *address = (*env)->GetDirectBufferAddress (env, dst);
+  float *floats;
+
+  if (address == NULL)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "float16 data is not a direct buffer.");
+      return;
+    }
+
+  floats = (*env)->GetPrimitiveArrayCritical (env, src, NULL);
+  if (floats == NULL)
+    {
+      return;
+    }
+  floats_to_halves (floats, (npy_half *) (address + offset), n);
+  (*env)->ReleasePrimitiveArrayCritical (env, src, floats, JNI_ABORT);
+}
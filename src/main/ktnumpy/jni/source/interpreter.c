@@ -93,6 +93,39 @@ Java_org_jetbrains_numkt_Interpreter_callFunc_00024kotlin_1numpy___3Ljava_lang_S
   return res;
 }
 
+/*
+ * Class:     org_jetbrains_numkt_Interpreter
+ * Method:    callDouble_00024kotlin_numpy
+ * Signature: ([Ljava/lang/String;[Ljava/lang/Object;Ljava/util/Map;)D
+ */
+JNIEXPORT jdouble JNICALL Java_org_jetbrains_numkt_Interpreter_callDouble_00024kotlin_1numpy
+    (JNIEnv *env, jobject jobj, jobjectArray arr_names_func, jobjectArray args, jobject kwargs)
+{
+  return invoke_call_function_double (env, arr_names_func, args, kwargs);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Interpreter
+ * Method:    callLong_00024kotlin_numpy
+ * Signature: ([Ljava/lang/String;[Ljava/lang/Object;Ljava/util/Map;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_Interpreter_callLong_00024kotlin_1numpy
+    (JNIEnv *env, jobject jobj, jobjectArray arr_names_func, jobjectArray args, jobject kwargs)
+{
+  return invoke_call_function_long (env, arr_names_func, args, kwargs);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Interpreter
+ * Method:    callBoolean_00024kotlin_numpy
+ * Signature: ([Ljava/lang/String;[Ljava/lang/Object;Ljava/util/Map;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_Interpreter_callBoolean_00024kotlin_1numpy
+    (JNIEnv *env, jobject jobj, jobjectArray arr_names_func, jobjectArray args, jobject kwargs)
+{
+  return invoke_call_function_boolean (env, arr_names_func, args, kwargs);
+}
+
 /*
  * Class:     org_jetbrains_numkt_Interpreter
  * Method:    getField_00024kotlin_numpy
@@ -130,6 +163,10 @@ JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Interpreter_getField_00024kot
     {
       res = get_jdtype (env, (PyArrayObject *) pointer);
     }
+  else if (strcmp (name, "layout") == 0)
+    {
+      res = get_layout (env, (PyArrayObject *) pointer);
+    }
   else if (strcmp (name, "hashCode") == 0)
     {
       jint i = PyObject_Hash ((PyObject *) pointer);
@@ -225,6 +262,20 @@ JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Interpreter_iterDealloc_00024kot
   iter_dealloc ((PyObject *) ptr_iter);
 }
 
+void run_with_interpreter (void (*function) (void *), void *arg)
+{
+  if (PyGILState_Check ())
+    {
+      function (arg);
+    }
+  else
+    {
+      acquire_main_thread ();
+      function (arg);
+      PyEval_ReleaseThread (mainThreadState);
+    }
+}
+
 /*
  * Class:     org_jetbrains_numkt_Interpreter
  * Method:    freeArray_00024kotlin_numpy
@@ -233,8 +284,14 @@ JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Interpreter_iterDealloc_00024kot
 JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_Interpreter_freeArray_00024kotlin_1numpy
     (JNIEnv *env, jobject jobj, jlong pointer, jobject buf)
 {
-  PyEval_AcquireThread (mainThreadState);
-  Py_XDECREF ((PyArrayObject *) pointer);
+  PyArrayObject *nparray = (PyArrayObject *) pointer;
+
+  acquire_main_thread ();
+  if (call_events_enabled && nparray != NULL && Py_REFCNT (nparray) == 1 && PyArray_CHKFLAGS (nparray, NPY_ARRAY_OWNDATA))
+    {
+      events_push_array (EVENT_ARRAY_FREE, nparray);
+    }
+  Py_XDECREF (nparray);
   python_exception (env);
   PyEval_ReleaseThread (mainThreadState);
 
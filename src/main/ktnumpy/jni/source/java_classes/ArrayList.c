@@ -16,14 +16,12 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID initID = 0;
-
 jobject java_util_ArrayList_new (JNIEnv *env, jint size)
 {
   jobject result = NULL;
-  if (JNI_METHOD (initID, env, ARRAYLIST_TYPE, "<init>", "(I)V"))
+  if (JNI_METHOD (ARRAYLIST_INIT_ID, env, ARRAYLIST_TYPE, "<init>", "(I)V"))
     {
-      result = (*env)->NewObject (env, ARRAYLIST_TYPE, initID, size);
+      result = (*env)->NewObject (env, ARRAYLIST_TYPE, ARRAYLIST_INIT_ID, size);
     }
   return result;
 }
\ No newline at end of file
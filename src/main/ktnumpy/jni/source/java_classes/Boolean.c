@@ -16,23 +16,20 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newBooleanID = 0;
-static jmethodID booleanValueID = 0;
-
 jobject java_lang_Boolean_new (JNIEnv *env, jboolean z)
 {
-  if (!JNI_METHOD(newBooleanID, env, BOOLEAN_TYPE, "<init>", "(Z)V")) {
+  if (!JNI_METHOD(BOOLEAN_INIT_ID, env, BOOLEAN_TYPE, "<init>", "(Z)V")) {
       return NULL;
     }
-  return (*env)->NewObject(env, BOOLEAN_TYPE, newBooleanID, z);
+  return (*env)->NewObject(env, BOOLEAN_TYPE, BOOLEAN_INIT_ID, z);
 }
 
 jboolean java_lang_Boolean_booleanValue (JNIEnv *env, jobject self)
 {
   jboolean result = JNI_FALSE;
-  if (JNI_METHOD(booleanValueID, env, BOOLEAN_TYPE, "booleanValue", "()Z"))
+  if (JNI_METHOD(BOOLEAN_BOOLEAN_VALUE_ID, env, BOOLEAN_TYPE, "booleanValue", "()Z"))
     {
-      result = (*env)->CallBooleanMethod (env, self, booleanValueID);
+      result = (*env)->CallBooleanMethod (env, self, BOOLEAN_BOOLEAN_VALUE_ID);
     }
   return result;
 }
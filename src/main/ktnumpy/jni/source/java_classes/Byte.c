@@ -16,13 +16,11 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newByteID = 0;
-
 jobject java_lang_Byte_new (JNIEnv *env, jbyte b)
 {
-  if (!JNI_METHOD(newByteID, env, BYTE_TYPE, "<init>", "(B)V"))
+  if (!JNI_METHOD(BYTE_INIT_ID, env, BYTE_TYPE, "<init>", "(B)V"))
     {
       return NULL;
     }
-  return (*env)->NewObject (env, BYTE_TYPE, newByteID, b);
+  return (*env)->NewObject (env, BYTE_TYPE, BYTE_INIT_ID, b);
 }
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+jobject java_nio_ByteBuffer_asReadOnlyBuffer (JNIEnv *env, jobject this)
+{
+  if (!JNI_METHOD (BYTEBUFFER_AS_READ_ONLY_BUFFER_ID, env, BYTEBUFFER_TYPE, "asReadOnlyBuffer", "()Ljava/nio/ByteBuffer;"))
+    {
+      return NULL;
+    }
+  return (*env)->CallObjectMethod (env, this, BYTEBUFFER_AS_READ_ONLY_BUFFER_ID);
+}
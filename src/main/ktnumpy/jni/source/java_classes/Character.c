@@ -16,24 +16,21 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newCharID = 0;
-static jmethodID charValueID = 0;
-
 jobject java_lang_Character_new (JNIEnv *env, jchar c)
 {
-  if (!JNI_METHOD(newCharID, env, CHAR_TYPE, "<init>", "(C)V"))
+  if (!JNI_METHOD(CHAR_INIT_ID, env, CHAR_TYPE, "<init>", "(C)V"))
     {
       return NULL;
     }
-  return (*env)->NewObject (env, CHAR_TYPE, newCharID, c);
+  return (*env)->NewObject (env, CHAR_TYPE, CHAR_INIT_ID, c);
 }
 
 jchar java_lang_Character_charValue (JNIEnv *env, jobject this)
 {
   jchar result = 0;
-  if (JNI_METHOD(charValueID, env, CHAR_TYPE, "charValue", "()C"))
+  if (JNI_METHOD(CHAR_CHAR_VALUE_ID, env, CHAR_TYPE, "charValue", "()C"))
     {
-      result = (*env)->CallCharMethod (env, this, charValueID);
+      result = (*env)->CallCharMethod (env, this, CHAR_CHAR_VALUE_ID);
     }
   return result;
 }
\ No newline at end of file
@@ -16,16 +16,13 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID getComponentType = 0;
-static jmethodID isArray = 0;
-
 jclass java_lang_Class_getComponentType (JNIEnv *env, jclass this)
 {
   jclass result = NULL;
-  if (JNI_METHOD(getComponentType, env, CLASS_TYPE, "getComponentType",
+  if (JNI_METHOD(CLASS_GET_COMPONENT_TYPE_ID, env, CLASS_TYPE, "CLASS_GET_COMPONENT_TYPE_ID",
                  "()Ljava/lang/Class;"))
     {
-      result = (jclass) (*env)->CallObjectMethod (env, this, getComponentType);
+      result = (jclass) (*env)->CallObjectMethod (env, this, CLASS_GET_COMPONENT_TYPE_ID);
     }
   return result;
 }
@@ -33,9 +30,9 @@ jclass java_lang_Class_getComponentType (JNIEnv *env, jclass this)
 jboolean java_lang_Class_IsArray (JNIEnv *env, jclass jcl)
 {
   jboolean result = JNI_FALSE;
-  if (JNI_METHOD (isArray, env, CLASS_TYPE, "isArray", "()Z"))
+  if (JNI_METHOD (CLASS_IS_ARRAY_ID, env, CLASS_TYPE, "CLASS_IS_ARRAY_ID", "()Z"))
     {
-      result = (*env)->CallBooleanMethod (env, jcl, isArray);
+      result = (*env)->CallBooleanMethod (env, jcl, CLASS_IS_ARRAY_ID);
     }
   return result;
 }
@@ -16,14 +16,12 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID sizeID = 0;
-
 jint java_util_Collection_size (JNIEnv *env, jobject this)
 {
   jint result = 0;
-  if (JNI_METHOD(sizeID, env, COLLECTION_TYPE, "size", "()I"))
+  if (JNI_METHOD(COLLECTION_SIZE_ID, env, COLLECTION_TYPE, "size", "()I"))
     {
-      result = (*env)->CallIntMethod (env, this, sizeID);
+      result = (*env)->CallIntMethod (env, this, COLLECTION_SIZE_ID);
     }
   return result;
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+jobject numkt_core_ComplexDouble_new (JNIEnv *env, jdouble re, jdouble im)
+{
+  if (!JNI_METHOD(COMPLEX_DOUBLE_INIT_ID, env, COMPLEX_DOUBLE_TYPE, "<init>", "(DD)V"))
+    {
+      return NULL;
+    }
+  return (*env)->NewObject (env, COMPLEX_DOUBLE_TYPE, COMPLEX_DOUBLE_INIT_ID, re, im);
+}
+
+jdouble numkt_core_ComplexDouble_getRe (JNIEnv *env, jobject self)
+{
+  jdouble result = 0;
+  if (JNI_METHOD(COMPLEX_DOUBLE_GET_RE_ID, env, COMPLEX_DOUBLE_TYPE, "getRe", "()D"))
+    {
+      result = (*env)->CallDoubleMethod (env, self, COMPLEX_DOUBLE_GET_RE_ID);
+    }
+  return result;
+}
+
+jdouble numkt_core_ComplexDouble_getIm (JNIEnv *env, jobject self)
+{
+  jdouble result = 0;
+  if (JNI_METHOD(COMPLEX_DOUBLE_GET_IM_ID, env, COMPLEX_DOUBLE_TYPE, "getIm", "()D"))
+    {
+      result = (*env)->CallDoubleMethod (env, self, COMPLEX_DOUBLE_GET_IM_ID);
+    }
+  return result;
+}
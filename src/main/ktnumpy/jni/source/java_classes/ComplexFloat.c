@@ -0,0 +1,46 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+jobject numkt_core_ComplexFloat_new (JNIEnv *env, jfloat re, jfloat im)
+{
+  if (!JNI_METHOD(COMPLEX_FLOAT_INIT_ID, env, COMPLEX_FLOAT_TYPE, "<init>", "(FF)V"))
+    {
+      return NULL;
+    }
+  return (*env)->NewObject (env, COMPLEX_FLOAT_TYPE, COMPLEX_FLOAT_INIT_ID, re, im);
+}
+
+jfloat numkt_core_ComplexFloat_getRe (JNIEnv *env, jobject self)
+{
+  jfloat result = 0;
+  if (JNI_METHOD(COMPLEX_FLOAT_GET_RE_ID, env, COMPLEX_FLOAT_TYPE, "getRe", "()F"))
+    {
+      result = (*env)->CallFloatMethod (env, self, COMPLEX_FLOAT_GET_RE_ID);
+    }
+  return result;
+}
+
+jfloat numkt_core_ComplexFloat_getIm (JNIEnv *env, jobject self)
+{
+  jfloat result = 0;
+  if (JNI_METHOD(COMPLEX_FLOAT_GET_IM_ID, env, COMPLEX_FLOAT_TYPE, "getIm", "()F"))
+    {
+      result = (*env)->CallFloatMethod (env, self, COMPLEX_FLOAT_GET_IM_ID);
+    }
+  return result;
+}
@@ -16,13 +16,11 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newDoubleID = 0;
-
 jobject java_lang_Double_new (JNIEnv *env, jdouble d)
 {
-  if (!JNI_METHOD(newDoubleID, env, DOUBLE_TYPE, "<init>", "(D)V"))
+  if (!JNI_METHOD(DOUBLE_INIT_ID, env, DOUBLE_TYPE, "<init>", "(D)V"))
     {
       return NULL;
     }
-  return (*env)->NewObject (env, DOUBLE_TYPE, newDoubleID, d);
+  return (*env)->NewObject (env, DOUBLE_TYPE, DOUBLE_INIT_ID, d);
 }
\ No newline at end of file
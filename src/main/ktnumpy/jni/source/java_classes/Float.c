@@ -16,13 +16,11 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newFloatID = 0;
-
 jobject java_lang_Float_new (JNIEnv *env, jfloat f)
 {
-  if (!JNI_METHOD(newFloatID, env, FLOAT_TYPE, "<init>", "(F)V"))
+  if (!JNI_METHOD(FLOAT_INIT_ID, env, FLOAT_TYPE, "<init>", "(F)V"))
     {
       return NULL;
     }
-  return (*env)->NewObject (env, FLOAT_TYPE, newFloatID, f);
+  return (*env)->NewObject (env, FLOAT_TYPE, FLOAT_INIT_ID, f);
 }
\ No newline at end of file
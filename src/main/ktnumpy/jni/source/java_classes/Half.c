@@ -0,0 +1,36 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+jobject numkt_core_Half_new (JNIEnv *env, jshort bits)
+{
+  if (!JNI_METHOD(HALF_INIT_ID, env, HALF_TYPE, "<init>", "(S)V"))
+    {
+      return NULL;
+    }
+  return (*env)->NewObject (env, HALF_TYPE, HALF_INIT_ID, bits);
+}
+
+jshort numkt_core_Half_getBits (JNIEnv *env, jobject self)
+{
+  jshort result = 0;
+  if (JNI_METHOD(HALF_GET_BITS_ID, env, HALF_TYPE, "getBits", "()S"))
+    {
+      result = (*env)->CallShortMethod (env, self, HALF_GET_BITS_ID);
+    }
+  return result;
+}
@@ -16,13 +16,11 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newIntegerID = 0;
-
 jobject java_lang_Integer_new (JNIEnv *env, jint i)
 {
-  if (!JNI_METHOD(newIntegerID, env, INT_TYPE, "<init>", "(I)V"))
+  if (!JNI_METHOD(INT_INIT_ID, env, INT_TYPE, "<init>", "(I)V"))
     {
       return NULL;
     }
-  return (*env)->NewObject (env, INT_TYPE, newIntegerID, i);
+  return (*env)->NewObject (env, INT_TYPE, INT_INIT_ID, i);
 }
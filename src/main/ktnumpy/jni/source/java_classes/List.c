@@ -16,15 +16,12 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID getID = 0;
-static jmethodID addID = 0;
-
 jobject java_util_List_get (JNIEnv *env, jobject this, jint index)
 {
   jobject result = NULL;
-  if (JNI_METHOD(getID, env, LIST_TYPE, "get", "(I)Ljava/lang/Object;"))
+  if (JNI_METHOD(LIST_GET_ID, env, LIST_TYPE, "get", "(I)Ljava/lang/Object;"))
     {
-      result = (*env)->CallObjectMethod (env, this, getID, index);
+      result = (*env)->CallObjectMethod (env, this, LIST_GET_ID, index);
     }
   return result;
 }
@@ -32,9 +29,9 @@ jobject java_util_List_get (JNIEnv *env, jobject this, jint index)
 jboolean java_util_List_add (JNIEnv *env, jobject this, jobject v)
 {
   jboolean result = JNI_FALSE;
-  if (JNI_METHOD (addID, env, LIST_TYPE, "add", "(Ljava/lang/Object;)Z"))
+  if (JNI_METHOD (LIST_ADD_ID, env, LIST_TYPE, "add", "(Ljava/lang/Object;)Z"))
     {
-      result = (*env)->CallBooleanMethod (env, this, addID, v);
+      result = (*env)->CallBooleanMethod (env, this, LIST_ADD_ID, v);
     }
   return result;
 }
\ No newline at end of file
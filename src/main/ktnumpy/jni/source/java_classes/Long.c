@@ -16,13 +16,11 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newLongID = 0;
-
 jobject java_lang_Long_new (JNIEnv *env, jlong j)
 {
-  if (!JNI_METHOD(newLongID, env, LONG_TYPE, "<init>", "(J)V"))
+  if (!JNI_METHOD(LONG_INIT_ID, env, LONG_TYPE, "<init>", "(J)V"))
     {
       return NULL;
     }
-  return (*env)->NewObject (env, LONG_TYPE, newLongID, j);
+  return (*env)->NewObject (env, LONG_TYPE, LONG_INIT_ID, j);
 }
\ No newline at end of file
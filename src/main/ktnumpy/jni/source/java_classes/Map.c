@@ -16,15 +16,12 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID getID = 0;
-static jmethodID containsKeyID = 0;
-
 jboolean java_util_Map_containsKey (JNIEnv *env, jobject this, jobject key)
 {
   jboolean result = JNI_FALSE;
-    if (JNI_METHOD(containsKeyID, env, MAP_TYPE, "containsKey", "(Ljava/lang/Object;)Z"))
+    if (JNI_METHOD(MAP_CONTAINS_KEY_ID, env, MAP_TYPE, "containsKey", "(Ljava/lang/Object;)Z"))
       {
-        result = (*env)->CallBooleanMethod (env, this, containsKeyID, key);
+        result = (*env)->CallBooleanMethod (env, this, MAP_CONTAINS_KEY_ID, key);
       }
   return result;
 }
@@ -32,9 +29,9 @@ jboolean java_util_Map_containsKey (JNIEnv *env, jobject this, jobject key)
 jobject java_util_Map_get (JNIEnv *env, jobject this, jobject key)
 {
   jobject result = NULL;
-    if (JNI_METHOD (getID, env, MAP_TYPE, "get", "(Ljava/lang/Object;)Ljava/lang/Object;"))
+    if (JNI_METHOD (MAP_GET_ID, env, MAP_TYPE, "get", "(Ljava/lang/Object;)Ljava/lang/Object;"))
       {
-        result = (*env)->CallObjectMethod (env, this, getID, key);
+        result = (*env)->CallObjectMethod (env, this, MAP_GET_ID, key);
       }
   return result;
 }
\ No newline at end of file
@@ -16,14 +16,22 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID initNumKtExceptionID = 0;
-
 jobject numkt_NumKtException_init_string (JNIEnv *env, jstring jmessage)
 {
   jobject result = NULL;
-  if (JNI_METHOD (initNumKtExceptionID, env, NUMKTEXCEPTION_TYPE, "<init>", "(Ljava/lang/String;)V"))
+  if (JNI_METHOD (NUMKTEXCEPTION_INIT_STRING_ID, env, NUMKTEXCEPTION_TYPE, "<init>", "(Ljava/lang/String;)V"))
+    {
+      result = (*env)->NewObject (env, NUMKTEXCEPTION_TYPE, NUMKTEXCEPTION_INIT_STRING_ID, jmessage);
+    }
+  return result;
+}
+
+jobject numkt_NumKtException_init_error (JNIEnv *env, jlong error)
+{
+  jobject result = NULL;
+  if (JNI_METHOD (NUMKTEXCEPTION_INIT_ERROR_ID, env, NUMKTEXCEPTION_TYPE, "<init>", "(J)V"))
     {
-      result = (*env)->NewObject (env, NUMKTEXCEPTION_TYPE, initNumKtExceptionID, jmessage);
+      result = (*env)->NewObject (env, NUMKTEXCEPTION_TYPE, NUMKTEXCEPTION_INIT_ERROR_ID, error);
     }
   return result;
-}
\ No newline at end of file
+}
@@ -16,19 +16,12 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID byteValueID = 0;
-static jmethodID shortValueID = 0;
-static jmethodID intValueID = 0;
-static jmethodID longValueID = 0;
-static jmethodID floatValueID = 0;
-static jmethodID doubleValueID = 0;
-
 jbyte java_lang_Number_byteValue (JNIEnv *env, jobject self)
 {
   jbyte result = 0;
-  if (JNI_METHOD(byteValueID, env, NUMBER_TYPE, "byteValue", "()B"))
+  if (JNI_METHOD(NUMBER_BYTE_VALUE_ID, env, NUMBER_TYPE, "byteValue", "()B"))
     {
-      result = (*env)->CallByteMethod (env, self, byteValueID);
+      result = (*env)->CallByteMethod (env, self, NUMBER_BYTE_VALUE_ID);
     }
   return result;
 }
@@ -36,9 +29,9 @@ jbyte java_lang_Number_byteValue (JNIEnv *env, jobject self)
 jshort java_lang_Number_shortValue (JNIEnv *env, jobject self)
 {
   jshort result = 0;
-  if (JNI_METHOD(shortValueID, env, NUMBER_TYPE, "shortValue", "()S"))
+  if (JNI_METHOD(NUMBER_SHORT_VALUE_ID, env, NUMBER_TYPE, "shortValue", "()S"))
     {
-      result = (*env)->CallShortMethod (env, self, shortValueID);
+      result = (*env)->CallShortMethod (env, self, NUMBER_SHORT_VALUE_ID);
     }
   return result;
 }
@@ -46,9 +39,9 @@ jshort java_lang_Number_shortValue (JNIEnv *env, jobject self)
 jint java_lang_Number_intValue (JNIEnv *env, jobject self)
 {
   jint result = 0;
-  if (JNI_METHOD(intValueID, env, NUMBER_TYPE, "intValue", "()I"))
+  if (JNI_METHOD(NUMBER_INT_VALUE_ID, env, NUMBER_TYPE, "intValue", "()I"))
     {
-      result = (*env)->CallIntMethod (env, self, intValueID);
+      result = (*env)->CallIntMethod (env, self, NUMBER_INT_VALUE_ID);
     }
   return result;
 }
@@ -56,9 +49,9 @@ jint java_lang_Number_intValue (JNIEnv *env, jobject self)
 jlong java_lang_Number_longValue (JNIEnv *env, jobject self)
 {
   jlong result = 0;
-  if (JNI_METHOD(longValueID, env, NUMBER_TYPE, "longValue", "()J"))
+  if (JNI_METHOD(NUMBER_LONG_VALUE_ID, env, NUMBER_TYPE, "longValue", "()J"))
     {
-      result = (*env)->CallLongMethod (env, self, longValueID);
+      result = (*env)->CallLongMethod (env, self, NUMBER_LONG_VALUE_ID);
     }
   return result;
 }
@@ -66,9 +59,9 @@ jlong java_lang_Number_longValue (JNIEnv *env, jobject self)
 jfloat java_lang_Number_floatValue (JNIEnv *env, jobject self)
 {
   jfloat result = 0;
-  if (JNI_METHOD(floatValueID, env, NUMBER_TYPE, "floatValue", "()F"))
+  if (JNI_METHOD(NUMBER_FLOAT_VALUE_ID, env, NUMBER_TYPE, "floatValue", "()F"))
     {
-      result = (*env)->CallFloatMethod (env, self, floatValueID);
+      result = (*env)->CallFloatMethod (env, self, NUMBER_FLOAT_VALUE_ID);
     }
   return result;
 }
@@ -76,9 +69,9 @@ jfloat java_lang_Number_floatValue (JNIEnv *env, jobject self)
 jdouble java_lang_Number_doubleValue (JNIEnv *env, jobject self)
 {
   jdouble result = 0;
-  if (JNI_METHOD(doubleValueID, env, NUMBER_TYPE, "doubleValue", "()D"))
+  if (JNI_METHOD(NUMBER_DOUBLE_VALUE_ID, env, NUMBER_TYPE, "doubleValue", "()D"))
     {
-      result = (*env)->CallDoubleMethod (env, self, doubleValueID);
+      result = (*env)->CallDoubleMethod (env, self, NUMBER_DOUBLE_VALUE_ID);
     }
   return result;
 }
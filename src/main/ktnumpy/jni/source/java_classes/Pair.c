@@ -16,33 +16,29 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newPairID = 0;
-static jmethodID getFirstID = 0;
-static jmethodID getSecondID = 0;
-
 jobject kotlin_Pair_new (JNIEnv *env, jobject f, jobject s)
 {
-  if (!JNI_METHOD(newPairID, env, PAIR_TYPE, "<init>", "(Ljava/lang/Object;Ljava/lang/Object;)V"))
+  if (!JNI_METHOD(PAIR_INIT_ID, env, PAIR_TYPE, "<init>", "(Ljava/lang/Object;Ljava/lang/Object;)V"))
     {
       return NULL;
     }
-  return (*env)->NewObject (env, PAIR_TYPE, newPairID, f, s);
+  return (*env)->NewObject (env, PAIR_TYPE, PAIR_INIT_ID, f, s);
 }
 
 jobject kotlin_Pair_getFirst (JNIEnv *env, jobject this)
 {
-  if (!JNI_METHOD (getFirstID, env, PAIR_TYPE, "getFirst", "()Ljava/lang/Object;"))
+  if (!JNI_METHOD (PAIR_GET_FIRST_ID, env, PAIR_TYPE, "getFirst", "()Ljava/lang/Object;"))
     {
       return NULL;
     }
-  return (*env)->CallObjectMethod (env, this, getFirstID);
+  return (*env)->CallObjectMethod (env, this, PAIR_GET_FIRST_ID);
 }
 
 jobject kotlin_Pair_getSecond (JNIEnv *env, jobject this)
 {
-  if (!JNI_METHOD (getSecondID, env, PAIR_TYPE, "getSecond", "()Ljava/lang/Object;"))
+  if (!JNI_METHOD (PAIR_GET_SECOND_ID, env, PAIR_TYPE, "getSecond", "()Ljava/lang/Object;"))
     {
       return NULL;
     }
-  return (*env)->CallObjectMethod (env, this, getSecondID);
+  return (*env)->CallObjectMethod (env, this, PAIR_GET_SECOND_ID);
 }
\ No newline at end of file
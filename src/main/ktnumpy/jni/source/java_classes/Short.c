@@ -16,13 +16,11 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID newShortID = 0;
-
 jobject java_lang_Short_new (JNIEnv *env, jshort s)
 {
-  if (!JNI_METHOD(newShortID, env, SHORT_TYPE, "<init>", "(S)V"))
+  if (!JNI_METHOD(SHORT_INIT_ID, env, SHORT_TYPE, "<init>", "(S)V"))
     {
       return NULL;
     }
-  return (*env)->NewObject (env, SHORT_TYPE, newShortID, s);
+  return (*env)->NewObject (env, SHORT_TYPE, SHORT_INIT_ID, s);
 }
\ No newline at end of file
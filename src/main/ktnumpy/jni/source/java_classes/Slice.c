@@ -16,33 +16,29 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID getStartID = 0;
-static jmethodID getStopID = 0;
-static jmethodID getStepID = 0;
-
 jobject numkt_core_Slice_getStart (JNIEnv *env, jobject jslice)
 {
-  if (!JNI_METHOD(getStartID, env, SLICE_TYPE, "getStart", "()Ljava/lang/Integer;"))
+  if (!JNI_METHOD(SLICE_GET_START_ID, env, SLICE_TYPE, "getStart", "()Ljava/lang/Integer;"))
     {
       return NULL;
     }
-  return (*env)->CallObjectMethod (env, jslice, getStartID);
+  return (*env)->CallObjectMethod (env, jslice, SLICE_GET_START_ID);
 }
 
 jobject numkt_core_Slice_getStop (JNIEnv *env, jobject jslice)
 {
-  if (!JNI_METHOD (getStopID, env, SLICE_TYPE, "getStop", "()Ljava/lang/Integer;"))
+  if (!JNI_METHOD (SLICE_GET_STOP_ID, env, SLICE_TYPE, "getStop", "()Ljava/lang/Integer;"))
     {
       return NULL;
     }
-  return (*env)->CallObjectMethod (env, jslice, getStopID);
+  return (*env)->CallObjectMethod (env, jslice, SLICE_GET_STOP_ID);
 }
 
 jobject numkt_core_Slice_getStep (JNIEnv *env, jobject jslice)
 {
-  if (!JNI_METHOD (getStepID, env, SLICE_TYPE, "getStep", "()Ljava/lang/Integer;"))
+  if (!JNI_METHOD (SLICE_GET_STEP_ID, env, SLICE_TYPE, "getStep", "()Ljava/lang/Integer;"))
     {
       return NULL;
     }
-  return (*env)->CallObjectMethod (env, jslice, getStepID);
+  return (*env)->CallObjectMethod (env, jslice, SLICE_GET_STEP_ID);
 }
\ No newline at end of file
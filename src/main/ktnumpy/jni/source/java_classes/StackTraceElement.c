@@ -16,15 +16,13 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID initStackTraceElementID = 0;
-
 jobject
 java_lang_StackTraceElement_init (JNIEnv *env, jstring file_no_ext, jstring func_name, jstring file_no_dir, jint line_num)
 {
   jobject result = NULL;
-  if (JNI_METHOD (initStackTraceElementID, env, STACK_TRACE_ELEMENT_TYPE, "<init>", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;I)V"))
+  if (JNI_METHOD (STACK_TRACE_ELEMENT_INIT_ID, env, STACK_TRACE_ELEMENT_TYPE, "<init>", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;I)V"))
     {
-      result = (*env)->NewObject (env, STACK_TRACE_ELEMENT_TYPE, initStackTraceElementID, file_no_ext, func_name, file_no_dir, line_num);
+      result = (*env)->NewObject (env, STACK_TRACE_ELEMENT_TYPE, STACK_TRACE_ELEMENT_INIT_ID, file_no_ext, func_name, file_no_dir, line_num);
     }
   return result;
 }
\ No newline at end of file
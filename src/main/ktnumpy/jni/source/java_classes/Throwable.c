@@ -16,25 +16,22 @@
 
 #include "ktnumpy_includes.h"
 
-static jmethodID getStackTraceID = 0;
-static jmethodID setStackTraceID = 0;
-
 jarray java_lang_Throwable_getStackTrace (JNIEnv *env, jobject this)
 {
   jarray result = 0;
-    if (JNI_METHOD(getStackTraceID, env, THROWABLE_TYPE, "getStackTrace",
+    if (JNI_METHOD(THROWABLE_GET_STACK_TRACE_ID, env, THROWABLE_TYPE, "getStackTrace",
                    "()[Ljava/lang/StackTraceElement;"))
       {
-        result = (jarray) (*env)->CallObjectMethod (env, this, getStackTraceID);
+        result = (jarray) (*env)->CallObjectMethod (env, this, THROWABLE_GET_STACK_TRACE_ID);
       }
   return result;
 }
 
 void java_lang_Throwable_setStackTrace (JNIEnv *env, jobject this, jarray stackTrace)
 {
-    if (JNI_METHOD(setStackTraceID, env, THROWABLE_TYPE, "setStackTrace",
+    if (JNI_METHOD(THROWABLE_SET_STACK_TRACE_ID, env, THROWABLE_TYPE, "setStackTrace",
                    "([Ljava/lang/StackTraceElement;)V"))
       {
-        (*env)->CallVoidMethod (env, this, setStackTraceID, stackTrace);
+        (*env)->CallVoidMethod (env, this, THROWABLE_SET_STACK_TRACE_ID, stackTrace);
       }
 }
\ No newline at end of file
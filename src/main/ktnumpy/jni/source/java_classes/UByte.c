@@ -0,0 +1,37 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/* UByte is an inline class, its box is built from and read as the signed jbyte. */
+jobject kotlin_UByte_new (JNIEnv *env, jbyte value)
+{
+  if (!JNI_METHOD(UBYTE_INIT_ID, env, UBYTE_TYPE, "<init>", "(B)V"))
+    {
+      return NULL;
+    }
+  return (*env)->NewObject (env, UBYTE_TYPE, UBYTE_INIT_ID, value);
+}
+
+jbyte kotlin_UByte_unbox (JNIEnv *env, jobject self)
+{
+  jbyte result = 0;
+  if (JNI_METHOD(UBYTE_UNBOX_ID, env, UBYTE_TYPE, "unbox-impl", "()B"))
+    {
+      result = (*env)->CallByteMethod (env, self, UBYTE_UNBOX_ID);
+    }
+  return result;
+}
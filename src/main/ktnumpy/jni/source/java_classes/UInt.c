@@ -0,0 +1,37 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/* UInt is an inline class, its box is built from and read as the signed jint. */
+jobject kotlin_UInt_new (JNIEnv *env, jint value)
+{
+  if (!JNI_METHOD(UINT_INIT_ID, env, UINT_TYPE, "<init>", "(I)V"))
+    {
+      return NULL;
+    }
+  return (*env)->NewObject (env, UINT_TYPE, UINT_INIT_ID, value);
+}
+
+jint kotlin_UInt_unbox (JNIEnv *env, jobject self)
+{
+  jint result = 0;
+  if (JNI_METHOD(UINT_UNBOX_ID, env, UINT_TYPE, "unbox-impl", "()I"))
+    {
+      result = (*env)->CallIntMethod (env, self, UINT_UNBOX_ID);
+    }
+  return result;
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/* ULong is an inline class, its box is built from and read as the signed jlong. */
+jobject kotlin_ULong_new (JNIEnv *env, jlong value)
+{
+  if (!JNI_METHOD(ULONG_INIT_ID, env, ULONG_TYPE, "<init>", "(J)V"))
+    {
+      return NULL;
+    }
+  return (*env)->NewObject (env, ULONG_TYPE, ULONG_INIT_ID, value);
+}
+
+jlong kotlin_ULong_unbox (JNIEnv *env, jobject self)
+{
+  jlong result = 0;
+  if (JNI_METHOD(ULONG_UNBOX_ID, env, ULONG_TYPE, "unbox-impl", "()J"))
+    {
+      result = (*env)->CallLongMethod (env, self, ULONG_UNBOX_ID);
+    }
+  return result;
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/* UShort is an inline class, its box is built from and read as the signed jshort. */
+jobject kotlin_UShort_new (JNIEnv *env, jshort value)
+{
+  if (!JNI_METHOD(USHORT_INIT_ID, env, USHORT_TYPE, "<init>", "(S)V"))
+    {
+      return NULL;
+    }
+  return (*env)->NewObject (env, USHORT_TYPE, USHORT_INIT_ID, value);
+}
+
+jshort kotlin_UShort_unbox (JNIEnv *env, jobject self)
+{
+  jshort result = 0;
+  if (JNI_METHOD(USHORT_UNBOX_ID, env, USHORT_TYPE, "unbox-impl", "()S"))
+    {
+      result = (*env)->CallShortMethod (env, self, USHORT_UNBOX_ID);
+    }
+  return result;
+}
@@ -53,77 +53,70 @@ PyObject *objArray_to_PyArray (JNIEnv *env, jobjectArray obj_arr, PyObject *dtyp
 
   if (dtype == NP_INT8)
     {
-      jmethodID jmidByteValue = (*env)->GetMethodID (env, BYTE_TYPE, "byteValue", "()B");
       for (int i = 0; i < arr_length; ++i)
         {
           jobject data = (*env)->GetObjectArrayElement (env, obj_arr, i);
-          int8_t val = (*env)->CallByteMethod (env, data, jmidByteValue);
+          int8_t val = (*env)->CallByteMethod (env, data, NUMBER_BYTE_VALUE_ID);
           PyList_SetItem (py_array, i, PyLong_FromLong (val));
           (*env)->DeleteLocalRef (env, data);
         }
     }
   else if (dtype == NP_INT16)
     {
-      jmethodID jmidShortValue = (*env)->GetMethodID (env, SHORT_TYPE, "shortValue", "()S");
       for (int i = 0; i < arr_length; ++i)
         {
           jobject data = (*env)->GetObjectArrayElement (env, obj_arr, i);
-          int16_t val = (*env)->CallShortMethod (env, data, jmidShortValue);
+          int16_t val = (*env)->CallShortMethod (env, data, NUMBER_SHORT_VALUE_ID);
           PyList_SetItem (py_array, i, PyLong_FromLong (val));
           (*env)->DeleteLocalRef (env, data);
         }
     }
   else if (dtype == NP_INT32)
     {
-      jmethodID jmidIntValue = (*env)->GetMethodID (env, INT_TYPE, "intValue", "()I");
       for (int i = 0; i < arr_length; i++)
         {
           jobject data = (*env)->GetObjectArrayElement (env, obj_arr, i);
-          int32_t val = (*env)->CallIntMethod (env, data, jmidIntValue);
+          int32_t val = (*env)->CallIntMethod (env, data, NUMBER_INT_VALUE_ID);
           PyList_SetItem (py_array, i, PyLong_FromLong (val));
           (*env)->DeleteLocalRef (env, data);
         }
     }
   else if (dtype == NP_INT64)
     {
-      jmethodID jmidLongValue = (*env)->GetMethodID (env, LONG_TYPE, "longValue", "()J");
       for (int i = 0; i < arr_length; ++i)
         {
           jobject data = (*env)->GetObjectArrayElement (env, obj_arr, i);
-          int64_t val = (*env)->CallLongMethod (env, data, jmidLongValue);
+          int64_t val = (*env)->CallLongMethod (env, data, NUMBER_LONG_VALUE_ID);
           (*env)->DeleteLocalRef (env, data);
           PyList_SetItem (py_array, i, PyLong_FromLong (val));
         }
     }
   else if (dtype == NP_FLOAT32)
     {
-      jmethodID jmidFloatValue = (*env)->GetMethodID (env, FLOAT_TYPE, "floatValue", "()F");
       for (int i = 0; i < arr_length; ++i)
         {
           jobject data = (*env)->GetObjectArrayElement (env, obj_arr, i);
-          float val = (*env)->CallFloatMethod (env, data, jmidFloatValue);
+          float val = (*env)->CallFloatMethod (env, data, NUMBER_FLOAT_VALUE_ID);
           PyList_SetItem (py_array, i, PyFloat_FromDouble (val));
           (*env)->DeleteLocalRef (env, data);
         }
     }
   else if (dtype == NP_FLOAT64)
     {
-      jmethodID jmidDoubleValue = (*env)->GetMethodID (env, DOUBLE_TYPE, "doubleValue", "()D");
       for (int i = 0; i < arr_length; ++i)
         {
           jobject data = (*env)->GetObjectArrayElement (env, obj_arr, i);
-          double val = (*env)->CallDoubleMethod (env, data, jmidDoubleValue);
+          double val = (*env)->CallDoubleMethod (env, data, NUMBER_DOUBLE_VALUE_ID);
           PyList_SetItem (py_array, i, PyFloat_FromDouble (val));
           (*env)->DeleteLocalRef (env, data);
         }
     }
   else if (dtype == NP_BOOL)
     {
-      jmethodID jmidBoolValue = (*env)->GetMethodID (env, BOOLEAN_TYPE, "booleanValue", "()Z");
       for (int i = 0; i < arr_length; ++i)
         {
           jobject data = (*env)->GetObjectArrayElement (env, obj_arr, i);
-          int val = (*env)->CallBooleanMethod (env, data, jmidBoolValue);
+          int val = (*env)->CallBooleanMethod (env, data, BOOLEAN_BOOLEAN_VALUE_ID);
           PyList_SetItem (py_array, i, PyBool_FromLong (val));
           (*env)->DeleteLocalRef (env, data);
         }
@@ -132,51 +125,202 @@ PyObject *objArray_to_PyArray (JNIEnv *env, jobjectArray obj_arr, PyObject *dtyp
   return py_array;
 }
 
-PyObject *jobject_to_pyobject (JNIEnv *env, jobject jobj)
+static PyObject *jnone_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
 {
-  PyObject *result = NULL;
-  jclass class = NULL;
-  if (jobj == NULL)
+  Py_RETURN_NONE;
+}
+
+static PyObject *jclass_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
+{
+  return get_dtype (env, (jclass) jobj);
+}
+
+static PyObject *jstring_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
+{
+  return jstring_AsPyString (env, (jstring) jobj);
+}
+
+static PyObject *jcharacter_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
+{
+  return jchar_AsPyObject (env, jobj);
+}
+
+#define DEFINE_JNUMBER_CONVERTER(name, jtype, method, id, py_from) \
+static PyObject *name (JNIEnv *env, jobject jobj, jclass jcl)      \
+{                                                                  \
+  jtype value = (*env)->method (env, jobj, id);                    \
+  if ((*env)->ExceptionCheck (env))                                \
+    {                                                              \
+      return NULL;                                                 \
+    }                                                              \
+  return py_from (value);                                          \
+}
+
+DEFINE_JNUMBER_CONVERTER(jbyte_AsPyObject, jbyte, CallByteMethod, NUMBER_BYTE_VALUE_ID, PyLong_FromLong)
+DEFINE_JNUMBER_CONVERTER(jshort_AsPyObject, jshort, CallShortMethod, NUMBER_SHORT_VALUE_ID, PyLong_FromLong)
+DEFINE_JNUMBER_CONVERTER(jint_AsPyObject, jint, CallIntMethod, NUMBER_INT_VALUE_ID, PyLong_FromLong)
+DEFINE_JNUMBER_CONVERTER(jlong_AsPyObject, jlong, CallLongMethod, NUMBER_LONG_VALUE_ID, PyLong_FromLongLong)
+DEFINE_JNUMBER_CONVERTER(jfloat_AsPyObject, jfloat, CallFloatMethod, NUMBER_FLOAT_VALUE_ID, PyFloat_FromDouble)
+DEFINE_JNUMBER_CONVERTER(jdouble_AsPyObject, jdouble, CallDoubleMethod, NUMBER_DOUBLE_VALUE_ID, PyFloat_FromDouble)
+DEFINE_JNUMBER_CONVERTER(jbool_AsPyObject, jboolean, CallBooleanMethod, BOOLEAN_BOOLEAN_VALUE_ID, PyBool_FromLong)
+
+// the boxes of kotlin's unsigned types hold the signed value of the same width
+#define DEFINE_JUNSIGNED_CONVERTER(name, jtype, utype, method, id, py_from) \
+static PyObject *name (JNIEnv *env, jobject jobj, jclass jcl)                \
+{                                                                            \
+  jtype value = (*env)->method (env, jobj, id);                              \
+  if ((*env)->ExceptionCheck (env))                                          \
+    {                                                                        \
+      return NULL;                                                           \
+    }                                                                        \
+  return py_from ((utype) value);                                            \
+}
+
+DEFINE_JUNSIGNED_CONVERTER(jubyte_AsPyObject, jbyte, npy_uint8, CallByteMethod, UBYTE_UNBOX_ID, PyLong_FromUnsignedLong)
+DEFINE_JUNSIGNED_CONVERTER(jushort_AsPyObject, jshort, npy_uint16, CallShortMethod, USHORT_UNBOX_ID, PyLong_FromUnsignedLong)
+DEFINE_JUNSIGNED_CONVERTER(juint_AsPyObject, jint, npy_uint32, CallIntMethod, UINT_UNBOX_ID, PyLong_FromUnsignedLong)
+DEFINE_JUNSIGNED_CONVERTER(julong_AsPyObject, jlong, npy_uint64, CallLongMethod, ULONG_UNBOX_ID, PyLong_FromUnsignedLongLong)
+
+static PyObject *jhalf_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
+{
+  jshort bits = numkt_core_Half_getBits (env, jobj);
+  if ((*env)->ExceptionCheck (env))
     {
       return NULL;
     }
-  class = (*env)->GetObjectClass (env, jobj);
-  if ((*env)->IsSameObject (env, class, NONE_TYPE))
+  return PyFloat_FromDouble (half_to_float ((npy_half) bits));
+}
+
+static PyObject *jcomplexfloat_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
+{
+  jfloat re = numkt_core_ComplexFloat_getRe (env, jobj);
+  jfloat im = numkt_core_ComplexFloat_getIm (env, jobj);
+  if ((*env)->ExceptionCheck (env))
+    {
+      return NULL;
+    }
+  return PyComplex_FromDoubles (re, im);
+}
+
+static PyObject *jcomplexdouble_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
+{
+  jdouble re = numkt_core_ComplexDouble_getRe (env, jobj);
+  jdouble im = numkt_core_ComplexDouble_getIm (env, jobj);
+  if ((*env)->ExceptionCheck (env))
+    {
+      return NULL;
+    }
+  return PyComplex_FromDoubles (re, im);
+}
+
+static PyObject *jktarray_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
+{
+  return ktarray_AsPyObject (env, jobj);
+}
+
+static PyObject *jslice_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
+{
+  return jslice_AsPySlice (env, jobj);
+}
+
+static PyObject *jobjarray_AsPyObject (JNIEnv *env, jobject jobj, jclass jcl)
+{
+  return jarray_AsPyTuple (env, (jobjectArray) jobj, jcl);
+}
+
+/*
+ * Classifies a java class once, the boxed types get their own converter so the element loop doesn't go through
+ * jnumber_AsPyObject again. Returns NULL for classes without a python counterpart.
+ */
+static jobject_converter converter_for_class (JNIEnv *env, jclass class)
+{
+  if ((*env)->IsSameObject (env, class, DOUBLE_TYPE))
+    {
+      return jdouble_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, LONG_TYPE))
+    {
+      return jlong_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, INT_TYPE))
+    {
+      return jint_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, FLOAT_TYPE))
+    {
+      return jfloat_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, SHORT_TYPE))
+    {
+      return jshort_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, BYTE_TYPE))
+    {
+      return jbyte_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, BOOLEAN_TYPE))
+    {
+      return jbool_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, NONE_TYPE))
+    {
+      return jnone_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, UBYTE_TYPE))
+    {
+      return jubyte_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, USHORT_TYPE))
+    {
+      return jushort_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, UINT_TYPE))
+    {
+      return juint_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, ULONG_TYPE))
+    {
+      return julong_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, HALF_TYPE))
+    {
+      return jhalf_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, COMPLEX_FLOAT_TYPE))
+    {
+      return jcomplexfloat_AsPyObject;
+    }
+  else if ((*env)->IsSameObject (env, class, COMPLEX_DOUBLE_TYPE))
     {
-      Py_INCREF(Py_None);
-      result = Py_None;
+      return jcomplexdouble_AsPyObject;
     }
   else if ((*env)->IsSameObject (env, class, CLASS_TYPE))
     {
-      result = get_dtype (env, (jclass) jobj);
+      return jclass_AsPyObject;
     }
   else if ((*env)->IsSameObject (env, class, STRING_TYPE))
     {
-      result = jstring_AsPyString (env, (jstring) jobj);
+      return jstring_AsPyObject;
     }
   else if ((*env)->IsSameObject (env, class, CHAR_TYPE))
     {
-      result = jchar_AsPyObject (env, jobj);
+      return jcharacter_AsPyObject;
     }
   else if ((*env)->IsAssignableFrom (env, class, NUMBER_TYPE))
     {
-      result = jnumber_AsPyObject (env, jobj, class);
-    }
-  else if ((*env)->IsSameObject (env, class, BOOLEAN_TYPE))
-    {
-      result = jboolean_AsPyObject (env, jobj);
+      return jnumber_AsPyObject;
     }
   else if ((*env)->IsAssignableFrom (env, class, LIST_TYPE))
     {
-      result = jlist_AsPyList (env, jobj, class);
+      return jlist_AsPyList;
     }
   else if ((*env)->IsAssignableFrom (env, class, KTNDARRAY_TYPE))
     {
-      result = ktarray_AsPyObject (env, jobj);
+      return jktarray_AsPyObject;
     }
   else if ((*env)->IsSameObject (env, class, SLICE_TYPE))
     {
-      result = jslice_AsPySlice (env, jobj);
+      return jslice_AsPyObject;
     }
   else
     {
@@ -186,16 +330,88 @@ PyObject *jobject_to_pyobject (JNIEnv *env, jobject jobj)
           printf ("java_lang_Class_IsArray\n");
           exit (-1);
         }
-      else if (is_array)
+      return is_array ? jobjarray_AsPyObject : NULL;
+    }
+}
+
+PyObject *jobject_to_pyobject (JNIEnv *env, jobject jobj)
+{
+  PyObject *result = NULL;
+  jclass class = NULL;
+  jobject_converter convert = NULL;
+  if (jobj == NULL)
+    {
+      return NULL;
+    }
+  class = (*env)->GetObjectClass (env, jobj);
+  convert = converter_for_class (env, class);
+  if (convert)
+    {
+      result = convert (env, jobj, class);
+    }
+
+  (*env)->DeleteLocalRef (env, class);
+  return result;
+}
+
+/*
+ * Same as jobject_to_pyobject, but remembers the converters of the last few classes seen by one list or array
+ * conversion. A boxed collection is mostly of one class, so it is classified once instead of once per element.
+ * The classes are local references compared with IsSameObject, their pointers aren't stable enough to be keys.
+ */
+static PyObject *cached_jobject_to_pyobject (JNIEnv *env, converter_cache *cache, jobject jobj)
+{
+  PyObject *result = NULL;
+  jclass class = NULL;
+  jobject_converter convert = NULL;
+  int i = 0;
+  if (jobj == NULL)
+    {
+      return NULL;
+    }
+  class = (*env)->GetObjectClass (env, jobj);
+  for (i = 0; i < cache->size; ++i)
+    {
+      if ((*env)->IsSameObject (env, class, cache->entries[i].class))
         {
-          result = jarray_AsPyTuple (env, (jobjectArray) jobj, class);
+          break;
         }
     }
 
-  (*env)->DeleteLocalRef (env, class);
+  if (i < cache->size)
+    {
+      converter_entry hit = cache->entries[i];
+      memmove (cache->entries + 1, cache->entries, i * sizeof (converter_entry));
+      cache->entries[0] = hit;
+      (*env)->DeleteLocalRef (env, class);
+      return hit.convert ? hit.convert (env, jobj, hit.class) : NULL;
+    }
+
+  convert = converter_for_class (env, class);
+  if (convert)
+    {
+      result = convert (env, jobj, class);
+    }
+  if (cache->size == CONVERTER_CACHE_SIZE)
+    {
+      (*env)->DeleteLocalRef (env, cache->entries[--cache->size].class);
+    }
+  memmove (cache->entries + 1, cache->entries, cache->size * sizeof (converter_entry));
+  cache->entries[0].class = class;
+  cache->entries[0].convert = convert;
+  cache->size++;
   return result;
 }
 
+static void release_converter_cache (JNIEnv *env, converter_cache *cache)
+{
+  for (int i = 0; i < cache->size; ++i)
+    {
+      (*env)->DeleteLocalRef (env, cache->entries[i].class);
+    }
+  cache->size = 0;
+}
+
 PyObject *jstring_AsPyString (JNIEnv *env, jstring jstr)
 {
   PyObject *result = NULL;
@@ -296,6 +512,7 @@ PyObject *jlist_AsPyList (JNIEnv *env, jobject jlist, jclass jcl)
   PyObject *py_list = NULL;
   jobject val = NULL;
   PyObject *py_val = NULL;
+  converter_cache cache = {0};
 
   if (jlist == NULL)
     {
@@ -310,12 +527,13 @@ PyObject *jlist_AsPyList (JNIEnv *env, jobject jlist, jclass jcl)
     {
       val = java_util_List_get (env, jlist, (jint) i);
 
-      py_val = jobject_to_pyobject (env, val);
+      py_val = cached_jobject_to_pyobject (env, &cache, val);
       PyList_SetItem (py_list, i, py_val);
 
       (*env)->DeleteLocalRef (env, val);
     }
 
+  release_converter_cache (env, &cache);
   return py_list;
 }
 
@@ -440,10 +658,11 @@ PyObject *jarray_AsPyTuple (JNIEnv *env, jobjectArray jobj, jclass jcl)
     }
   else
     {
+      converter_cache cache = {0};
       for (int i = 0; i < arr_length; ++i)
         {
           jobject value = (*env)->GetObjectArrayElement (env, jobj, i);
-          PyObject *py_val = jobject_to_pyobject (env, value);
+          PyObject *py_val = cached_jobject_to_pyobject (env, &cache, value);
           if (NpyArray_Check (py_val))
             {
               Py_IncRef (py_val);
@@ -451,6 +670,7 @@ PyObject *jarray_AsPyTuple (JNIEnv *env, jobjectArray jobj, jclass jcl)
           PyTuple_SetItem (py_tuple, i, py_val);
           (*env)->DeleteLocalRef (env, value);
         }
+      release_converter_cache (env, &cache);
     }
   return py_tuple;
 }
@@ -34,12 +34,21 @@ int ktnumpy_init (JNIEnv *env)
       exit (-1);
     }
 
+  if (cache_java_methods (env))
+    {
+      fprintf (stderr, "Error get java and kotlin methods.\n");
+      exit (-1);
+    }
+
   if (cache_primitive_jarrays (env))
     {
       fprintf (stderr, "Error get java arrays.\n");
       exit (-1);
     }
 
+  register_ktndarray_natives (env);
+  register_ktnditer_natives (env);
+
   sysModule = PyImport_ImportModule ("sys");
   if (sysModule == NULL)
     {
@@ -80,7 +89,8 @@ int NpyScalar_Check (PyObject *py_object)
 
 int NpyView_Check (PyArrayObject *py_object)
 {
-  if (PyArray_BASE (py_object) != NULL)
+  // the base of a memory-mapped array is the mapping itself, not another ndarray
+  if (PyArray_BASE (py_object) != NULL && PyArray_Check (PyArray_BASE (py_object)))
     {
       return 1;
     }
@@ -233,6 +243,110 @@ jobject npy_scalar_as_jobject (JNIEnv *env, PyObject *py_object, jclass clazz)
           result = java_lang_Byte_new (env, (jbyte) z);
         }
     }
+  else if (PyArray_IsScalar (py_object, UInt8))
+    {
+      npy_uint8 b;
+      PyArray_ScalarAsCtype (py_object, &b);
+      if ((*env)->IsAssignableFrom (env, UBYTE_TYPE, clazz))
+        {
+          result = kotlin_UByte_new (env, (jbyte) b);
+        }
+      else if ((*env)->IsAssignableFrom (env, SHORT_TYPE, clazz))
+        {
+          result = java_lang_Short_new (env, (jshort) b);
+        }
+      else if ((*env)->IsAssignableFrom (env, INT_TYPE, clazz))
+        {
+          result = java_lang_Integer_new (env, (jint) b);
+        }
+      else if ((*env)->IsAssignableFrom (env, LONG_TYPE, clazz))
+        {
+          result = java_lang_Long_new (env, (jlong) b);
+        }
+    }
+  else if (PyArray_IsScalar (py_object, UInt16))
+    {
+      npy_uint16 s;
+      PyArray_ScalarAsCtype (py_object, &s);
+      if ((*env)->IsAssignableFrom (env, USHORT_TYPE, clazz))
+        {
+          result = kotlin_UShort_new (env, (jshort) s);
+        }
+      else if ((*env)->IsAssignableFrom (env, INT_TYPE, clazz))
+        {
+          result = java_lang_Integer_new (env, (jint) s);
+        }
+      else if ((*env)->IsAssignableFrom (env, LONG_TYPE, clazz))
+        {
+          result = java_lang_Long_new (env, (jlong) s);
+        }
+    }
+  else if (PyArray_IsScalar (py_object, UInt32))
+    {
+      npy_uint32 i;
+      PyArray_ScalarAsCtype (py_object, &i);
+      if ((*env)->IsAssignableFrom (env, UINT_TYPE, clazz))
+        {
+          result = kotlin_UInt_new (env, (jint) i);
+        }
+      else if ((*env)->IsAssignableFrom (env, LONG_TYPE, clazz))
+        {
+          result = java_lang_Long_new (env, (jlong) i);
+        }
+    }
+  else if (PyArray_IsScalar (py_object, UInt64))
+    {
+      npy_uint64 j;
+      if ((*env)->IsAssignableFrom (env, ULONG_TYPE, clazz))
+        {
+          PyArray_ScalarAsCtype (py_object, &j);
+          result = kotlin_ULong_new (env, (jlong) j);
+        }
+    }
+  else if (PyArray_IsScalar (py_object, Half))
+    {
+      npy_half h;
+      PyArray_ScalarAsCtype (py_object, &h);
+      if ((*env)->IsAssignableFrom (env, HALF_TYPE, clazz))
+        {
+          result = numkt_core_Half_new (env, (jshort) h);
+        }
+      else if ((*env)->IsAssignableFrom (env, FLOAT_TYPE, clazz))
+        {
+          result = java_lang_Float_new (env, half_to_float (h));
+        }
+      else if ((*env)->IsAssignableFrom (env, DOUBLE_TYPE, clazz))
+        {
+          result = java_lang_Double_new (env, half_to_float (h));
+        }
+    }
+  else if (PyArray_IsScalar (py_object, CFloat))
+    {
+      // real and imaginary parts, the layout of npy_cfloat in every numpy version
+      npy_float c[2];
+      PyArray_ScalarAsCtype (py_object, c);
+      if ((*env)->IsAssignableFrom (env, COMPLEX_FLOAT_TYPE, clazz))
+        {
+          result = numkt_core_ComplexFloat_new (env, c[0], c[1]);
+        }
+      else if ((*env)->IsAssignableFrom (env, COMPLEX_DOUBLE_TYPE, clazz))
+        {
+          result = numkt_core_ComplexDouble_new (env, c[0], c[1]);
+        }
+    }
+  else if (PyArray_IsScalar (py_object, CDouble))
+    {
+      npy_double c[2];
+      PyArray_ScalarAsCtype (py_object, c);
+      if ((*env)->IsAssignableFrom (env, COMPLEX_DOUBLE_TYPE, clazz))
+        {
+          result = numkt_core_ComplexDouble_new (env, c[0], c[1]);
+        }
+      else if ((*env)->IsAssignableFrom (env, COMPLEX_FLOAT_TYPE, clazz))
+        {
+          result = numkt_core_ComplexFloat_new (env, (jfloat) c[0], (jfloat) c[1]);
+        }
+    }
 
   python_exception (env);
 
@@ -279,6 +393,48 @@ jobject npy_scalar_to_jobject (JNIEnv *env, PyObject *py_object)
       PyArray_ScalarAsCtype (py_object, &d);
       result = java_lang_Double_new (env, (jdouble) d);
     }
+  else if (PyArray_IsScalar(py_object, UInt8))
+    {
+      npy_uint8 b;
+      PyArray_ScalarAsCtype (py_object, &b);
+      result = kotlin_UByte_new (env, (jbyte) b);
+    }
+  else if (PyArray_IsScalar(py_object, UInt16))
+    {
+      npy_uint16 s;
+      PyArray_ScalarAsCtype (py_object, &s);
+      result = kotlin_UShort_new (env, (jshort) s);
+    }
+  else if (PyArray_IsScalar(py_object, UInt32))
+    {
+      npy_uint32 i;
+      PyArray_ScalarAsCtype (py_object, &i);
+      result = kotlin_UInt_new (env, (jint) i);
+    }
+  else if (PyArray_IsScalar(py_object, UInt64))
+    {
+      npy_uint64 j;
+      PyArray_ScalarAsCtype (py_object, &j);
+      result = kotlin_ULong_new (env, (jlong) j);
+    }
+  else if (PyArray_IsScalar(py_object, Half))
+    {
+      npy_half h;
+      PyArray_ScalarAsCtype (py_object, &h);
+      result = numkt_core_Half_new (env, (jshort) h);
+    }
+  else if (PyArray_IsScalar(py_object, CFloat))
+    {
+      npy_float c[2];
+      PyArray_ScalarAsCtype (py_object, c);
+      result = numkt_core_ComplexFloat_new (env, c[0], c[1]);
+    }
+  else if (PyArray_IsScalar(py_object, CDouble))
+    {
+      npy_double c[2];
+      PyArray_ScalarAsCtype (py_object, c);
+      result = numkt_core_ComplexDouble_new (env, c[0], c[1]);
+    }
   return result;
 }
 
@@ -291,7 +447,20 @@ jobject get_bytebuffer (JNIEnv *env, PyArrayObject *nparray)
   address = PyArray_BYTES (nparray);
   size_n_bytes = PyArray_NBYTES(nparray);
 
+  // capacity of java.nio.ByteBuffer is int, such arrays have no buffer and are accessed by index
+  if (size_n_bytes > INT32_MAX)
+    {
+      return NULL;
+    }
+
   jobject directBuffer = (*env)->NewDirectByteBuffer (env, (void *) address, size_n_bytes);
+
+  // e.g. read-only memory mapping, writing to it from java would crash the process
+  if (directBuffer != NULL && !PyArray_ISWRITEABLE (nparray))
+    {
+      directBuffer = java_nio_ByteBuffer_asReadOnlyBuffer (env, directBuffer);
+    }
+
   bufferRef = (*env)->NewWeakGlobalRef (env, directBuffer);
 
   return bufferRef;
@@ -413,6 +582,20 @@ jobject get_jdtype (JNIEnv *env, PyArrayObject *ndarray)
       break;
       case NPY_UNICODE: res = CHAR_TYPE;
       break;
+      case NPY_FLOAT16: res = HALF_TYPE;
+      break;
+      case NPY_UINT8: res = UBYTE_TYPE;
+      break;
+      case NPY_UINT16: res = USHORT_TYPE;
+      break;
+      case NPY_UINT32: res = UINT_TYPE;
+      break;
+      case NPY_UINT64: res = ULONG_TYPE;
+      break;
+      case NPY_COMPLEX64: res = COMPLEX_FLOAT_TYPE;
+      break;
+      case NPY_COMPLEX128: res = COMPLEX_DOUBLE_TYPE;
+      break;
       default: printf ("Error: dtype to java_class\n");
     }
   return res;
@@ -467,6 +650,20 @@ jobject get_value (JNIEnv *env, PyArrayObject *ndarray, jlongArray jlong_array)
           break;
           case NPY_UNICODE: res = java_lang_Character_new (env, *(jchar *) tmp);
           break;
+          case NPY_FLOAT16: res = numkt_core_Half_new (env, *(jshort *) tmp);
+          break;
+          case NPY_UINT8: res = kotlin_UByte_new (env, *(jbyte *) tmp);
+          break;
+          case NPY_UINT16: res = kotlin_UShort_new (env, *(jshort *) tmp);
+          break;
+          case NPY_UINT32: res = kotlin_UInt_new (env, *(jint *) tmp);
+          break;
+          case NPY_UINT64: res = kotlin_ULong_new (env, *(jlong *) tmp);
+          break;
+          case NPY_COMPLEX64: res = numkt_core_ComplexFloat_new (env, ((jfloat *) tmp)[0], ((jfloat *) tmp)[1]);
+          break;
+          case NPY_COMPLEX128: res = numkt_core_ComplexDouble_new (env, ((jdouble *) tmp)[0], ((jdouble *) tmp)[1]);
+          break;
           default: printf ("Get value: Unknown type!\n");
         }
 
@@ -636,23 +833,34 @@ invoke_call_function
   jobject name = NULL;
   jobject result = NULL;
 
+  CallTiming timing;
+  call_metrics_begin (&timing);
 
   // import modules and functions
   size_t length = (*env)->GetArrayLength (env, arr_names_func);
   if (length > 1)
     {
-      for (size_t i = 0; i < length - 1; --i)
+      for (size_t i = 0; i < length - 1 && tmpModule != NULL; ++i)
         {
+          PyObject *module = tmpModule;
           name = (*env)->GetObjectArrayElement (env, arr_names_func, i);
           name_mod = jstring_AsPyString (env, name);
-          tmpModule = PyObject_GetAttr (tmpModule, name_mod);
+          tmpModule = PyObject_GetAttr (module, name_mod);
+          if (module != npModule)
+            {
+              Py_DECREF (module);
+            }
           (*env)->DeleteLocalRef (env, name);
           Py_XDECREF (name_mod);
         }
     }
   name = (*env)->GetObjectArrayElement (env, arr_names_func, length - 1);
   name_func = jstring_AsPyString (env, name);
-  py_Func = PyObject_GetAttr (tmpModule, name_func);
+  py_Func = tmpModule != NULL ? PyObject_GetAttr (tmpModule, name_func) : NULL;
+  if (tmpModule != npModule)
+    {
+      Py_XDECREF (tmpModule);
+    }
   if (python_exception (env) || py_Func == NULL)
     {
       goto OUT;
@@ -727,7 +935,9 @@ invoke_call_function
     }
 
   //call func
+  call_metrics_converted (env, &timing, arr_names_func, py_Func, py_args);
   nparray = PyObject_Call (py_Func, py_args, py_kwargs);
+  call_metrics_executed (&timing, nparray);
   if (python_exception (env) || nparray == NULL)
     {
       goto OUT;
@@ -744,6 +954,7 @@ invoke_call_function
 
   // goto for exit
   OUT:
+  call_metrics_end (&timing, nparray != NULL);
   Py_XDECREF (py_Func);
   Py_XDECREF (py_args);
   Py_XDECREF (py_kwargs);
@@ -751,9 +962,13 @@ invoke_call_function
   return result;
 }
 
-jobject
-invoke_call_function_with_class
-    (JNIEnv *env, jobjectArray arr_names_func, jobjectArray args, jobject kwargs, jclass clazz)
+/*
+ * Calls the numpy function, returns a new reference to the result or NULL with the Java exception set.
+ * The caller begins and ends the timing of the call.
+ */
+static PyObject *
+call_numpy_function
+    (JNIEnv *env, CallTiming *timing, jobjectArray arr_names_func, jobjectArray args, jobject kwargs)
 {
   py_Func = NULL;
   PyObject *py_res = NULL;
@@ -764,25 +979,33 @@ invoke_call_function_with_class
   PyObject *py_args = NULL;
 
   jobject name = NULL;
-  jobject result = NULL;
 
 
   // import modules and functions
   size_t length = (*env)->GetArrayLength (env, arr_names_func);
   if (length > 1)
     {
-      for (size_t i = 0; i < length - 1; --i)
+      for (size_t i = 0; i < length - 1 && tmpModule != NULL; ++i)
         {
+          PyObject *module = tmpModule;
           name = (*env)->GetObjectArrayElement (env, arr_names_func, i);
           name_mod = jstring_AsPyString (env, name);
-          tmpModule = PyObject_GetAttr (tmpModule, name_mod);
+          tmpModule = PyObject_GetAttr (module, name_mod);
+          if (module != npModule)
+            {
+              Py_DECREF (module);
+            }
           (*env)->DeleteLocalRef (env, name);
           Py_XDECREF (name_mod);
         }
     }
   name = (*env)->GetObjectArrayElement (env, arr_names_func, length - 1);
   name_func = jstring_AsPyString (env, name);
-  py_Func = PyObject_GetAttr (tmpModule, name_func);
+  py_Func = tmpModule != NULL ? PyObject_GetAttr (tmpModule, name_func) : NULL;
+  if (tmpModule != npModule)
+    {
+      Py_XDECREF (tmpModule);
+    }
   if (python_exception (env) || py_Func == NULL)
     {
       goto OUT;
@@ -857,19 +1080,168 @@ invoke_call_function_with_class
     }
 
   //call func
+  call_metrics_converted (env, timing, arr_names_func, py_Func, py_args);
   py_res = PyObject_Call (py_Func, py_args, py_kwargs);
+  call_metrics_executed (timing, py_res);
   if (python_exception (env))
     {
-      goto OUT;
+      Py_CLEAR (py_res);
     }
 
-  result = pyobject_to_jobject (env, py_res, clazz);
-
   // goto for exit
   OUT:
   Py_XDECREF (py_Func);
   Py_XDECREF (py_kwargs);
   Py_XDECREF (py_args);
 
+  return py_res;
+}
+
+jobject
+invoke_call_function_with_class
+    (JNIEnv *env, jobjectArray arr_names_func, jobjectArray args, jobject kwargs, jclass clazz)
+{
+  CallTiming timing;
+  PyObject *py_res = NULL;
+  jobject result = NULL;
+
+  call_metrics_begin (&timing);
+  py_res = call_numpy_function (env, &timing, arr_names_func, args, kwargs);
+  if (py_res != NULL)
+    {
+      result = pyobject_to_jobject (env, py_res, clazz);
+    }
+  call_metrics_end (&timing, py_res != NULL);
+
+  return result;
+}
+
+/*
+ * Numbers read straight from a numpy scalar, without boxing them into a Java object.
+ * Other objects are converted by Python, so a 0-d array or a Python number works as well.
+ * On failure the Python error is set.
+ */
+
+double pyobject_as_double (PyObject *py_object)
+{
+  double result = 0;
+
+  if (PyArray_IsScalar (py_object, Float64))
+    {
+      PyArray_ScalarAsCtype (py_object, &result);
+    }
+  else if (PyArray_IsScalar (py_object, Float32))
+    {
+      npy_float32 f;
+      PyArray_ScalarAsCtype (py_object, &f);
+      result = f;
+    }
+  else
+    {
+      result = PyFloat_AsDouble (py_object);
+    }
   return result;
 }
+
+long long pyobject_as_long (PyObject *py_object)
+{
+  long long result = 0;
+
+  if (PyArray_IsScalar (py_object, Int64))
+    {
+      npy_int64 j;
+      PyArray_ScalarAsCtype (py_object, &j);
+      result = j;
+    }
+  else if (PyArray_IsScalar (py_object, Int32))
+    {
+      npy_int32 i;
+      PyArray_ScalarAsCtype (py_object, &i);
+      result = i;
+    }
+  else
+    {
+      // integers of numpy and 0-d arrays of them have __index__
+      result = PyLong_AsLongLong (py_object);
+    }
+  return result;
+}
+
+int pyobject_as_boolean (PyObject *py_object)
+{
+  if (PyArray_IsScalar (py_object, Bool))
+    {
+      npy_bool b;
+      PyArray_ScalarAsCtype (py_object, &b);
+      return b != 0;
+    }
+  return PyObject_IsTrue (py_object);
+}
+
+/* Calls returning a single number, see pyobject_as_double. */
+
+jdouble
+invoke_call_function_double
+    (JNIEnv *env, jobjectArray arr_names_func, jobjectArray args, jobject kwargs)
+{
+  CallTiming timing;
+  PyObject *py_res = NULL;
+  double result = 0;
+
+  call_metrics_begin (&timing);
+  py_res = call_numpy_function (env, &timing, arr_names_func, args, kwargs);
+  if (py_res == NULL)
+    {
+      call_metrics_end (&timing, 0);
+      return 0;
+    }
+  result = pyobject_as_double (py_res);
+  Py_DECREF (py_res);
+  call_metrics_end (&timing, 1);
+  python_exception (env);
+  return result;
+}
+
+jlong
+invoke_call_function_long
+    (JNIEnv *env, jobjectArray arr_names_func, jobjectArray args, jobject kwargs)
+{
+  CallTiming timing;
+  PyObject *py_res = NULL;
+  jlong result = 0;
+
+  call_metrics_begin (&timing);
+  py_res = call_numpy_function (env, &timing, arr_names_func, args, kwargs);
+  if (py_res == NULL)
+    {
+      call_metrics_end (&timing, 0);
+      return 0;
+    }
+  result = pyobject_as_long (py_res);
+  Py_DECREF (py_res);
+  call_metrics_end (&timing, 1);
+  python_exception (env);
+  return result;
+}
+
+jboolean
+invoke_call_function_boolean
+    (JNIEnv *env, jobjectArray arr_names_func, jobjectArray args, jobject kwargs)
+{
+  CallTiming timing;
+  PyObject *py_res = NULL;
+  int result = 0;
+
+  call_metrics_begin (&timing);
+  py_res = call_numpy_function (env, &timing, arr_names_func, args, kwargs);
+  if (py_res == NULL)
+    {
+      call_metrics_end (&timing, 0);
+      return JNI_FALSE;
+    }
+  result = pyobject_as_boolean (py_res);
+  Py_DECREF (py_res);
+  call_metrics_end (&timing, 1);
+  python_exception (env);
+  return result > 0 ? JNI_TRUE : JNI_FALSE;
+}
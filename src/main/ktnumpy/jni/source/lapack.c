@@ -0,0 +1,704 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/*
+ * Linear algebra on workspaces kept between calls. The LAPACK of the BLAS numpy is linked with is
+ * called directly: the factors, pivots and work arrays of a workspace are allocated once for matrices
+ * of one order, and the results go to arrays kept by the workspace or given by the caller, so repeated
+ * solves of systems of one shape allocate nothing. Stacks of systems are solved in parallel over the stack.
+ *
+ * LAPACK takes matrices in column-major order, a C-contiguous matrix is its transpose for LAPACK:
+ * systems are solved with the transposed LU factors, and triangles of symmetric matrices are swapped.
+ */
+
+/* LAPACK integer of the width of the library, set and read by lapack_int_set and lapack_int_get. */
+typedef union
+{
+  int32_t i32;
+  int64_t i64;
+} LapackInt;
+
+/* Lengths of the character arguments are passed as gfortran does, the C routines ignore them. */
+typedef void (*lapack_getrf) (LapackInt *, LapackInt *, double *, LapackInt *, void *, LapackInt *);
+typedef void (*lapack_getrs) (const char *, LapackInt *, LapackInt *, double *, LapackInt *, void *, double *,
+                              LapackInt *, LapackInt *, size_t);
+typedef void (*lapack_getri) (LapackInt *, double *, LapackInt *, void *, double *, LapackInt *, LapackInt *);
+typedef void (*lapack_potrf) (const char *, LapackInt *, double *, LapackInt *, LapackInt *, size_t);
+typedef void (*lapack_syevd) (const char *, const char *, LapackInt *, double *, LapackInt *, double *, double *,
+                              LapackInt *, void *, LapackInt *, LapackInt *, size_t, size_t);
+
+static struct
+{
+  int loaded;
+  int ilp64;
+  lapack_getrf getrf;
+  lapack_getrs getrs;
+  lapack_getri getri;
+  lapack_potrf potrf;
+  lapack_syevd syevd;
+} lapack;
+
+/* Results kept by a workspace. */
+typedef enum
+{
+  LINALG_SOLVE,
+  LINALG_INV,
+  LINALG_CHOLESKY,
+  LINALG_EIGENVALUES,
+  LINALG_EIGENVECTORS,
+  LINALG_OUTPUTS
+} LinalgOutput;
+
+typedef struct
+{
+  npy_intp n;
+  /* n * n, the matrix being factored */
+  double *factor;
+  /* n LAPACK integers */
+  void *pivots;
+  /* right-hand sides in column-major order, grown on demand */
+  double *rhs;
+  npy_intp rhs_size;
+  /* work arrays of getri and syevd, the one of getri is grown for syevd on demand */
+  double *work;
+  npy_intp lwork;
+  void *iwork;
+  npy_intp liwork;
+  PyArrayObject *outputs[LINALG_OUTPUTS];
+} LinalgWorkspace;
+
+static int lapack_load (void)
+{
+  if (!lapack.loaded)
+    {
+      int ilp64 = 0;
+      lapack.getrf = (lapack_getrf) blas_lapack_function ("dgetrf", &ilp64);
+      lapack.getrs = (lapack_getrs) blas_lapack_function ("dgetrs", &ilp64);
+      lapack.getri = (lapack_getri) blas_lapack_function ("dgetri", &ilp64);
+      lapack.potrf = (lapack_potrf) blas_lapack_function ("dpotrf", &ilp64);
+      lapack.syevd = (lapack_syevd) blas_lapack_function ("dsyevd", &ilp64);
+      lapack.ilp64 = ilp64;
+      lapack.loaded = 1;
+    }
+  return lapack.getrf != NULL && lapack.getrs != NULL && lapack.getri != NULL && lapack.potrf != NULL
+         && lapack.syevd != NULL;
+}
+
+static inline void lapack_int_set (LapackInt *x, npy_intp value)
+{
+  if (lapack.ilp64)
+    {
+      x->i64 = (int64_t) value;
+    }
+  else
+    {
+      x->i32 = (int32_t) value;
+    }
+}
+
+static inline npy_intp lapack_int_get (const LapackInt *x)
+{
+  return lapack.ilp64 ? (npy_intp) x->i64 : (npy_intp) x->i32;
+}
+
+static inline npy_intp lapack_pivot (const void *pivots, npy_intp i)
+{
+  return lapack.ilp64 ? (npy_intp) ((const int64_t *) pivots)[i] : (npy_intp) ((const int32_t *) pivots)[i];
+}
+
+static void *lapack_ints (npy_intp n)
+{
+  return malloc ((n > 0 ? n : 1) * (lapack.ilp64 ? sizeof (int64_t) : sizeof (int32_t)));
+}
+
+/* LU factors of the transpose of the C-contiguous matrix a in factor, returns the info of getrf. */
+static npy_intp linalg_lu (npy_intp n, const double *a, double *factor, void *pivots)
+{
+  LapackInt ln, info;
+
+  memcpy (factor, a, n * n * sizeof (double));
+  lapack_int_set (&ln, n);
+  lapack.getrf (&ln, &ln, factor, &ln, pivots, &info);
+  return lapack_int_get (&info);
+}
+
+/*
+ * Solves a x = b for the C-contiguous a of n * n and b of n * m, rhs is the scratch of n * m.
+ * x may be b. Returns 0, or 1 if a is singular.
+ */
+static int linalg_solve (npy_intp n, npy_intp m, const double *a, const double *b, double *x, double *factor,
+                         void *pivots, double *rhs)
+{
+  LapackInt ln, lm, info;
+
+  if (linalg_lu (n, a, factor, pivots) != 0)
+    {
+      return 1;
+    }
+  for (npy_intp i = 0; i < n; ++i)
+    {
+      for (npy_intp j = 0; j < m; ++j)
+        {
+          rhs[j * n + i] = b[i * m + j];
+        }
+    }
+  lapack_int_set (&ln, n);
+  lapack_int_set (&lm, m);
+  // the factors are of the transpose of a
+  lapack.getrs ("T", &ln, &lm, factor, &ln, pivots, rhs, &ln, &info, 1);
+  for (npy_intp i = 0; i < n; ++i)
+    {
+      for (npy_intp j = 0; j < m; ++j)
+        {
+          x[i * m + j] = rhs[j * n + i];
+        }
+    }
+  return 0;
+}
+
+/* Inverts the C-contiguous a of n * n into x, which may be a. Returns 0, or 1 if a is singular. */
+static int linalg_inv (npy_intp n, const double *a, double *x, void *pivots, double *work, npy_intp lwork)
+{
+  LapackInt ln, llwork, info;
+
+  memmove (x, a, n * n * sizeof (double));
+  lapack_int_set (&ln, n);
+  lapack.getrf (&ln, &ln, x, &ln, pivots, &info);
+  if (lapack_int_get (&info) != 0)
+    {
+      return 1;
+    }
+  // the inverse of the transpose is the transpose of the inverse
+  lapack_int_set (&llwork, lwork);
+  lapack.getri (&ln, x, &ln, pivots, work, &llwork, &info);
+  return lapack_int_get (&info) != 0;
+}
+
+/* Size of the work array of getri for matrices of the order n. */
+static npy_intp linalg_inv_lwork (npy_intp n)
+{
+  LapackInt ln, llwork, info;
+  double size = 0;
+
+  lapack_int_set (&ln, n);
+  lapack_int_set (&llwork, -1);
+  lapack.getri (&ln, NULL, &ln, NULL, &size, &llwork, &info);
+  return size > n ? (npy_intp) size : n;
+}
+
+static void linalg_workspace_free (LinalgWorkspace *ws)
+{
+  if (ws != NULL)
+    {
+      for (int i = 0; i < LINALG_OUTPUTS; ++i)
+        {
+          Py_XDECREF (ws->outputs[i]);
+        }
+      free (ws->factor);
+      free (ws->pivots);
+      free (ws->rhs);
+      free (ws->work);
+      free (ws->iwork);
+      free (ws);
+    }
+}
+
+static double *linalg_scratch (double **buffer, npy_intp *size, npy_intp need)
+{
+  if (*size < need)
+    {
+      double *grown = (double *) realloc (*buffer, need * sizeof (double));
+      if (grown == NULL)
+        {
+          PyErr_NoMemory ();
+          return NULL;
+        }
+      *buffer = grown;
+      *size = need;
+    }
+  return *buffer;
+}
+
+/* Input as a C-contiguous array of doubles of ndim dimensions, the last two of the order of the workspace. */
+static PyArrayObject *linalg_matrices (LinalgWorkspace *ws, JNIEnv *env, jobject ja, int ndim)
+{
+  PyArrayObject *a = numkt_core_KtNDArray_getPointer (env, ja);
+
+  if (PyArray_NDIM (a) != ndim || PyArray_DIM (a, ndim - 1) != ws->n || PyArray_DIM (a, ndim - 2) != ws->n)
+    {
+      PyErr_Format (PyExc_ValueError, "Expected %s of the shape (..., %zd, %zd) for the workspace.",
+                    ndim == 2 ? "a matrix" : "a stack of matrices", (Py_ssize_t) ws->n, (Py_ssize_t) ws->n);
+      return NULL;
+    }
+  return (PyArrayObject *) PyArray_FROMANY ((PyObject *) a, NPY_FLOAT64, 0, 0, NPY_ARRAY_CARRAY_RO);
+}
+
+/*
+ * Array for the result of the shape dims: out of the caller when given, otherwise the array the workspace
+ * keeps for the kind of the result, replaced when the shape changes. Returns a new reference.
+ */
+static PyArrayObject *linalg_output (LinalgWorkspace *ws, JNIEnv *env, jobject jout, LinalgOutput kind, int ndim,
+                                     npy_intp *dims)
+{
+  PyArrayObject *out;
+
+  if (jout != NULL)
+    {
+      out = numkt_core_KtNDArray_getPointer (env, jout);
+      if (PyArray_TYPE (out) != NPY_FLOAT64 || !PyArray_IS_C_CONTIGUOUS (out) || !PyArray_ISWRITEABLE (out)
+          || PyArray_NDIM (out) != ndim || !PyArray_CompareLists (PyArray_DIMS (out), dims, ndim))
+        {
+          PyErr_SetString (PyExc_ValueError, "Expected out to be a writeable C-contiguous array of doubles "
+                                             "of the shape of the result.");
+          return NULL;
+        }
+      Py_INCREF (out);
+      return out;
+    }
+
+  out = ws->outputs[kind];
+  if (out == NULL || PyArray_NDIM (out) != ndim || !PyArray_CompareLists (PyArray_DIMS (out), dims, ndim))
+    {
+      Py_XDECREF (out);
+      ws->outputs[kind] = out = (PyArrayObject *) PyArray_SimpleNew (ndim, dims, NPY_FLOAT64);
+      if (out == NULL)
+        {
+          return NULL;
+        }
+    }
+  Py_INCREF (out);
+  return out;
+}
+
+typedef struct
+{
+  npy_intp n;
+  npy_intp m;
+  const double *a;
+  const double *b;
+  double *x;
+  npy_intp lwork;
+  /* set by the tasks when a matrix is singular or memory runs out */
+  volatile int singular;
+  volatile int failed;
+} LinalgStack;
+
+static void linalg_solve_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  LinalgStack *stack = (LinalgStack *) ctx;
+  npy_intp n = stack->n, m = stack->m;
+  double *factor = (double *) malloc (n * (n + m) * sizeof (double));
+  void *pivots = lapack_ints (n);
+
+  if (factor == NULL || pivots == NULL)
+    {
+      stack->failed = 1;
+    }
+  for (Py_ssize_t k = begin; k < end && !stack->failed; ++k)
+    {
+      if (linalg_solve (n, m, stack->a + k * n * n, stack->b + k * n * m, stack->x + k * n * m, factor, pivots,
+                        factor + n * n))
+        {
+          stack->singular = 1;
+        }
+    }
+  free (factor);
+  free (pivots);
+}
+
+static void linalg_inv_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  LinalgStack *stack = (LinalgStack *) ctx;
+  npy_intp n = stack->n;
+  double *work = (double *) malloc (stack->lwork * sizeof (double));
+  void *pivots = lapack_ints (n);
+
+  if (work == NULL || pivots == NULL)
+    {
+      stack->failed = 1;
+    }
+  for (Py_ssize_t k = begin; k < end && !stack->failed; ++k)
+    {
+      if (linalg_inv (n, stack->a + k * n * n, stack->x + k * n * n, pivots, work, stack->lwork))
+        {
+          stack->singular = 1;
+        }
+    }
+  free (work);
+  free (pivots);
+}
+
+/* Runs the task over the stack of count matrices on the thread pool, a few chunks per thread. */
+static void linalg_stack_for (LinalgStack *stack, npy_intp count, thread_pool_task task)
+{
+  npy_intp grain = count / (4 * (npy_intp) thread_pool_get_threads ());
+
+  Py_BEGIN_ALLOW_THREADS
+  thread_pool_parallel_for (count, grain > 0 ? grain : 1, task, stack);
+  KTNUMPY_END_ALLOW_THREADS
+}
+
+static int linalg_stack_error (LinalgStack *stack)
+{
+  if (stack->failed)
+    {
+      PyErr_NoMemory ();
+    }
+  else if (stack->singular)
+    {
+      PyErr_SetString (PyExc_ValueError, "Singular matrix");
+    }
+  return stack->failed || stack->singular;
+}
+
+static jobject linalg_result (JNIEnv *env, PyArrayObject *out, int failed)
+{
+  if (failed || out == NULL)
+    {
+      Py_XDECREF (out);
+      python_exception (env);
+      return NULL;
+    }
+  return new_ktndarray (env, out, NULL);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    lapackLoaded
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_lapackLoaded
+    (JNIEnv *env, jclass jcl)
+{
+  return (jboolean) lapack_load ();
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceNew
+ * Signature: (I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceNew
+    (JNIEnv *env, jclass jcl, jint n)
+{
+  LinalgWorkspace *ws;
+
+  if (n < 1)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Expected the order of matrices > 0.");
+      return 0;
+    }
+  if (!lapack_load ())
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "No LAPACK is loaded by numpy.");
+      return 0;
+    }
+
+  ws = (LinalgWorkspace *) calloc (1, sizeof (LinalgWorkspace));
+  if (ws != NULL)
+    {
+      ws->n = n;
+      ws->factor = (double *) malloc ((npy_intp) n * n * sizeof (double));
+      ws->pivots = lapack_ints (n);
+      ws->lwork = linalg_inv_lwork (n);
+      ws->work = (double *) malloc (ws->lwork * sizeof (double));
+    }
+  if (ws == NULL || ws->factor == NULL || ws->pivots == NULL || ws->work == NULL)
+    {
+      linalg_workspace_free (ws);
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Not enough memory for the workspace.");
+      return 0;
+    }
+  return (jlong) ws;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceSolve
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceSolve
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject ja, jobject jb, jobject jout)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  LinalgWorkspace *ws = (LinalgWorkspace *) ptr;
+  PyArrayObject *b = numkt_core_KtNDArray_getPointer (env, jb);
+  PyArrayObject *a = NULL, *values = NULL, *out = NULL;
+  int stacked = PyArray_NDIM (numkt_core_KtNDArray_getPointer (env, ja)) == 3;
+  int failed = 1;
+  npy_intp n = ws->n, m, count = stacked ? PyArray_DIM (numkt_core_KtNDArray_getPointer (env, ja), 0) : 1;
+
+  // b is a vector or a matrix of right-hand sides, for every matrix of a stack
+  if (PyArray_NDIM (b) < 1 + stacked || PyArray_NDIM (b) > 2 + stacked || (stacked && PyArray_DIM (b, 0) != count)
+      || PyArray_DIM (b, stacked) != n)
+    {
+      PyErr_Format (PyExc_ValueError, "Expected b of the shape (%s%zd,) or (%s%zd, k).", stacked ? "batch, " : "",
+                    (Py_ssize_t) n, stacked ? "batch, " : "", (Py_ssize_t) n);
+      goto OUT;
+    }
+  m = PyArray_NDIM (b) == 2 + stacked ? PyArray_DIM (b, 1 + stacked) : 1;
+
+  a = linalg_matrices (ws, env, ja, 2 + stacked);
+  values = a == NULL ? NULL : (PyArrayObject *) PyArray_FROMANY ((PyObject *) b, NPY_FLOAT64, 0, 0,
+                                                                  NPY_ARRAY_CARRAY_RO);
+  out = values == NULL ? NULL : linalg_output (ws, env, jout, LINALG_SOLVE, PyArray_NDIM (b), PyArray_DIMS (b));
+  if (out == NULL)
+    {
+      goto OUT;
+    }
+
+  if (stacked)
+    {
+      LinalgStack stack = {n, m, PyArray_DATA (a), PyArray_DATA (values), PyArray_DATA (out), 0, 0, 0};
+      linalg_stack_for (&stack, count, linalg_solve_task);
+      failed = linalg_stack_error (&stack);
+    }
+  else if (linalg_scratch (&ws->rhs, &ws->rhs_size, n * m) != NULL)
+    {
+      int singular;
+      Py_BEGIN_ALLOW_THREADS
+      singular = linalg_solve (n, m, PyArray_DATA (a), PyArray_DATA (values), PyArray_DATA (out), ws->factor,
+                               ws->pivots, ws->rhs);
+      KTNUMPY_END_ALLOW_THREADS
+      if (singular)
+        {
+          PyErr_SetString (PyExc_ValueError, "Singular matrix");
+        }
+      failed = singular;
+    }
+
+  OUT:
+  Py_XDECREF (a);
+  Py_XDECREF (values);
+  return linalg_result (env, out, failed);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceInv
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceInv
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject ja, jobject jout)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  LinalgWorkspace *ws = (LinalgWorkspace *) ptr;
+  int stacked = PyArray_NDIM (numkt_core_KtNDArray_getPointer (env, ja)) == 3;
+  PyArrayObject *a = linalg_matrices (ws, env, ja, 2 + stacked);
+  PyArrayObject *out = NULL;
+  int failed = 1;
+  npy_intp n = ws->n;
+
+  out = a == NULL ? NULL : linalg_output (ws, env, jout, LINALG_INV, PyArray_NDIM (a), PyArray_DIMS (a));
+  if (out != NULL && stacked)
+    {
+      LinalgStack stack = {n, n, PyArray_DATA (a), NULL, PyArray_DATA (out), linalg_inv_lwork (n), 0, 0};
+      linalg_stack_for (&stack, PyArray_DIM (a, 0), linalg_inv_task);
+      failed = linalg_stack_error (&stack);
+    }
+  else if (out != NULL)
+    {
+      int singular;
+      Py_BEGIN_ALLOW_THREADS
+      singular = linalg_inv (n, PyArray_DATA (a), PyArray_DATA (out), ws->pivots, ws->work, ws->lwork);
+      KTNUMPY_END_ALLOW_THREADS
+      if (singular)
+        {
+          PyErr_SetString (PyExc_ValueError, "Singular matrix");
+        }
+      failed = singular;
+    }
+
+  Py_XDECREF (a);
+  return linalg_result (env, out, failed);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceDet
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)D
+ */
+JNIEXPORT jdouble JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceDet
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject ja)
+{
+  NPY_IMPORT_ONCE (0)
+
+  LinalgWorkspace *ws = (LinalgWorkspace *) ptr;
+  PyArrayObject *a = linalg_matrices (ws, env, ja, 2);
+  double det = 1;
+
+  if (a == NULL)
+    {
+      python_exception (env);
+      return 0;
+    }
+
+  Py_BEGIN_ALLOW_THREADS
+  // a zero pivot of a singular matrix makes the product zero
+  linalg_lu (ws->n, PyArray_DATA (a), ws->factor, ws->pivots);
+  for (npy_intp i = 0; i < ws->n; ++i)
+    {
+      det *= lapack_pivot (ws->pivots, i) != i + 1 ? -ws->factor[i * ws->n + i] : ws->factor[i * ws->n + i];
+    }
+  KTNUMPY_END_ALLOW_THREADS
+
+  Py_DECREF (a);
+  return det;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceCholesky
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceCholesky
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject ja, jobject jout)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  LinalgWorkspace *ws = (LinalgWorkspace *) ptr;
+  PyArrayObject *a = linalg_matrices (ws, env, ja, 2);
+  PyArrayObject *out = a == NULL ? NULL : linalg_output (ws, env, jout, LINALG_CHOLESKY, 2, PyArray_DIMS (a));
+  npy_intp n = ws->n, info = 0;
+
+  if (out != NULL)
+    {
+      double *l = (double *) PyArray_DATA (out);
+      LapackInt ln, linfo;
+
+      Py_BEGIN_ALLOW_THREADS
+      memmove (l, PyArray_DATA (a), n * n * sizeof (double));
+      lapack_int_set (&ln, n);
+      // the upper triangle of the transpose is the lower one of a
+      lapack.potrf ("U", &ln, l, &ln, &linfo, 1);
+      info = lapack_int_get (&linfo);
+      for (npy_intp i = 0; i < n; ++i)
+        {
+          memset (l + i * n + i + 1, 0, (n - i - 1) * sizeof (double));
+        }
+      KTNUMPY_END_ALLOW_THREADS
+
+      if (info != 0)
+        {
+          PyErr_SetString (PyExc_ValueError, "Matrix is not positive definite");
+        }
+    }
+
+  Py_XDECREF (a);
+  return linalg_result (env, out, info != 0);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceEigh
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;)Lkotlin/Pair;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceEigh
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject ja)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  LinalgWorkspace *ws = (LinalgWorkspace *) ptr;
+  PyArrayObject *a = linalg_matrices (ws, env, ja, 2);
+  PyArrayObject *w = NULL, *v = NULL;
+  LapackInt ln, llwork, lliwork, info;
+  npy_intp n = ws->n, status = 1;
+  double *vectors;
+
+  w = a == NULL ? NULL : linalg_output (ws, env, NULL, LINALG_EIGENVALUES, 1, PyArray_DIMS (a));
+  v = w == NULL ? NULL : linalg_output (ws, env, NULL, LINALG_EIGENVECTORS, 2, PyArray_DIMS (a));
+  if (v == NULL)
+    {
+      goto OUT;
+    }
+
+  lapack_int_set (&ln, n);
+  if (ws->liwork == 0)
+    {
+      double lwork = 0;
+      LapackInt liwork;
+
+      lapack_int_set (&llwork, -1);
+      lapack_int_set (&lliwork, -1);
+      lapack.syevd ("V", "U", &ln, NULL, &ln, NULL, &lwork, &llwork, &liwork, &lliwork, &info, 1, 1);
+      if (linalg_scratch (&ws->work, &ws->lwork, (npy_intp) lwork) == NULL)
+        {
+          goto OUT;
+        }
+      ws->iwork = lapack_ints (lapack_int_get (&liwork));
+      if (ws->iwork == NULL)
+        {
+          PyErr_NoMemory ();
+          goto OUT;
+        }
+      ws->liwork = lapack_int_get (&liwork);
+    }
+
+  vectors = (double *) PyArray_DATA (v);
+  Py_BEGIN_ALLOW_THREADS
+  memcpy (ws->factor, PyArray_DATA (a), n * n * sizeof (double));
+  lapack_int_set (&llwork, ws->lwork);
+  lapack_int_set (&lliwork, ws->liwork);
+  // the upper triangle of the transpose is the lower one of a, as eigh takes by default
+  lapack.syevd ("V", "U", &ln, ws->factor, &ln, PyArray_DATA (w), ws->work, &llwork, ws->iwork, &lliwork, &info, 1,
+                1);
+  status = lapack_int_get (&info);
+  for (npy_intp i = 0; i < n; ++i)
+    {
+      for (npy_intp j = 0; j < n; ++j)
+        {
+          vectors[i * n + j] = ws->factor[j * n + i];
+        }
+    }
+  KTNUMPY_END_ALLOW_THREADS
+
+  if (status != 0)
+    {
+      PyErr_SetString (PyExc_ValueError, "Eigenvalues did not converge");
+    }
+
+  OUT:
+  Py_XDECREF (a);
+  if (status != 0)
+    {
+      Py_XDECREF (w);
+      Py_XDECREF (v);
+      python_exception (env);
+      return NULL;
+    }
+  return kotlin_Pair_new (env, new_ktndarray (env, w, NULL), new_ktndarray (env, v, NULL));
+}
+
+static void linalg_workspace_release (void *ws)
+{
+  linalg_workspace_free ((LinalgWorkspace *) ws);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_linalg_LinalgWorkspace
+ * Method:    workspaceDealloc
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_linalg_LinalgWorkspace_workspaceDealloc
+    (JNIEnv *env, jobject jobj, jlong ptr)
+{
+  // called by close on the thread of the interpreter or by the finalizer
+  run_with_interpreter (linalg_workspace_release, (void *) ptr);
+}
@@ -0,0 +1,586 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#include <time.h>
+#ifdef KTNUMPY_POSIX
+#include <pthread.h>
+#endif
+
+/*
+ * Functions are registered once with a reference to them, so that their addresses stay unique, and get
+ * an index into the counters. Each thread counts into a shard of its own, the shards are summed when
+ * the metrics are read. The registry and the list of shards are guarded by a lock, which the calls take
+ * only to register a function or to grow their shard; the table which finds the index of a function is
+ * read without it, as its slots and the table itself are published atomically. The counters are added
+ * to atomically, so that they can be read and cleared by other threads. A thread which exits adds its
+ * counters to the retired ones and frees its shard.
+ * Latencies are kept in histograms with 8 buckets to a power of two, an error of at most 1/16
+ * of the percentiles, up to 2^36 ns.
+ */
+
+#define CALL_METRICS_SUB_BUCKETS 8
+#define CALL_METRICS_BUCKETS (CALL_METRICS_SUB_BUCKETS * 35)
+
+#ifdef KTNUMPY_POSIX
+#define CALL_METRICS_THREAD_LOCAL __thread
+#define CALL_METRICS_LOCK() pthread_mutex_lock (&metrics_lock)
+#define CALL_METRICS_UNLOCK() pthread_mutex_unlock (&metrics_lock)
+#else
+#define CALL_METRICS_THREAD_LOCAL
+#define CALL_METRICS_LOCK()
+#define CALL_METRICS_UNLOCK()
+#endif
+
+typedef struct
+{
+  uint64_t calls;
+  uint64_t errors;
+  uint64_t total;
+  uint64_t convert;
+  uint64_t execute;
+  uint64_t wrap;
+  uint64_t bytes;
+  uint64_t histogram[CALL_METRICS_BUCKETS];
+} CallCounters;
+
+typedef struct CallShard
+{
+  CallCounters *counters;
+  int capacity;
+  struct CallShard *next;
+} CallShard;
+
+typedef struct
+{
+  PyObject *function;
+  char *name;
+} CallFunction;
+
+// a slot is published by its function, which is stored after the index
+typedef struct
+{
+  PyObject *function;
+  int index;
+} FunctionSlot;
+
+// open addressing by the address of the function, a grown table replaces the previous one, which is kept
+typedef struct FunctionTable
+{
+  size_t capacity;
+  int used;
+  struct FunctionTable *previous;
+  FunctionSlot slots[];
+} FunctionTable;
+
+int call_metrics_enabled = 0;
+
+static CallFunction *functions = NULL;
+static int n_functions = 0;
+static int functions_capacity = 0;
+
+static FunctionTable *function_table = NULL;
+
+static CallShard *shards = NULL;
+static CALL_METRICS_THREAD_LOCAL CallShard *thread_shard = NULL;
+// the counters of the threads which exited
+static CallShard retired = {NULL, 0, NULL};
+
+#ifdef KTNUMPY_POSIX
+static pthread_mutex_t metrics_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t shard_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t shard_key;
+#endif
+
+uint64_t call_metrics_now (void)
+{
+  struct timespec ts;
+#ifdef KTNUMPY_POSIX
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+#else
+  timespec_get (&ts, TIME_UTC);
+#endif
+  // 0 marks the calls which are not timed
+  return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec + 1;
+}
+
+static size_t function_hash (PyObject *function)
+{
+  uintptr_t h = (uintptr_t) function >> 4;
+  return (size_t) (h ^ (h >> 16)) * 0x9E3779B1u;
+}
+
+static int find_function (PyObject *function)
+{
+  FunctionTable *table = __atomic_load_n (&function_table, __ATOMIC_ACQUIRE);
+  size_t mask;
+
+  if (table == NULL)
+    {
+      return -1;
+    }
+  mask = table->capacity - 1;
+  for (size_t i = function_hash (function) & mask;; i = (i + 1) & mask)
+    {
+      PyObject *f = __atomic_load_n (&table->slots[i].function, __ATOMIC_ACQUIRE);
+      if (f == function)
+        {
+          return table->slots[i].index;
+        }
+      if (f == NULL)
+        {
+          return -1;
+        }
+    }
+}
+
+static void insert_slot (FunctionTable *table, PyObject *function, int index)
+{
+  size_t mask = table->capacity - 1;
+  size_t i = function_hash (function) & mask;
+
+  while (table->slots[i].function != NULL)
+    {
+      i = (i + 1) & mask;
+    }
+  table->slots[i].index = index;
+  __atomic_store_n (&table->slots[i].function, function, __ATOMIC_RELEASE);
+  table->used++;
+}
+
+/* Publishes a table of twice the capacity, the previous one may still be read and is not freed. */
+static int grow_table (void)
+{
+  FunctionTable *old = function_table;
+  size_t capacity = old == NULL ? 64 : 2 * old->capacity;
+  FunctionTable *table = calloc (1, sizeof (FunctionTable) + capacity * sizeof (FunctionSlot));
+
+  if (table == NULL)
+    {
+      return -1;
+    }
+  table->capacity = capacity;
+  table->previous = old;
+  for (size_t i = 0; old != NULL && i < old->capacity; ++i)
+    {
+      if (old->slots[i].function != NULL)
+        {
+          insert_slot (table, old->slots[i].function, old->slots[i].index);
+        }
+    }
+  __atomic_store_n (&function_table, table, __ATOMIC_RELEASE);
+  return 0;
+}
+
+static int register_function (PyObject *function, const char *name)
+{
+  int index = find_function (function);
+
+  if (index >= 0 || function == NULL)
+    {
+      return index;
+    }
+  if (n_functions == functions_capacity)
+    {
+      int capacity = functions_capacity == 0 ? 32 : 2 * functions_capacity;
+      CallFunction *grown = realloc (functions, capacity * sizeof (CallFunction));
+      if (grown == NULL)
+        {
+          return -1;
+        }
+      functions = grown;
+      functions_capacity = capacity;
+    }
+  if ((function_table == NULL || 2 * (size_t) (function_table->used + 1) > function_table->capacity)
+      && grow_table () < 0)
+    {
+      return -1;
+    }
+
+  index = n_functions++;
+  Py_INCREF (function);
+  functions[index].function = function;
+  functions[index].name = strdup (name);
+  insert_slot (function_table, function, index);
+  return index;
+}
+
+/* Returns the index of the function, registering it under name, or -1 without memory. */
+int call_metrics_register (PyObject *function, const char *name)
+{
+  int index;
+
+  CALL_METRICS_LOCK ();
+  index = register_function (function, name);
+  CALL_METRICS_UNLOCK ();
+  return index;
+}
+
+/* The dotted path of the function, "linalg.norm" for numpy.linalg.norm. */
+static char *function_name (JNIEnv *env, jobjectArray names)
+{
+  jsize length = (*env)->GetArrayLength (env, names);
+  size_t size = 1;
+  char *name = NULL;
+
+  for (jsize i = 0; i < length; ++i)
+    {
+      jstring part = (*env)->GetObjectArrayElement (env, names, i);
+      size += (*env)->GetStringUTFLength (env, part) + 1;
+      (*env)->DeleteLocalRef (env, part);
+    }
+  name = calloc (size, 1);
+  for (jsize i = 0; name != NULL && i < length; ++i)
+    {
+      jstring part = (*env)->GetObjectArrayElement (env, names, i);
+      const char *chars = jstring_to_char (env, part);
+      if (i > 0)
+        {
+          strcat (name, ".");
+        }
+      strcat (name, chars);
+      release_utf_char (env, part, chars);
+      (*env)->DeleteLocalRef (env, part);
+    }
+  return name;
+}
+
+static void add_counters (CallCounters *sum, const CallCounters *c)
+{
+  sum->calls += __atomic_load_n (&c->calls, __ATOMIC_RELAXED);
+  sum->errors += __atomic_load_n (&c->errors, __ATOMIC_RELAXED);
+  sum->total += __atomic_load_n (&c->total, __ATOMIC_RELAXED);
+  sum->convert += __atomic_load_n (&c->convert, __ATOMIC_RELAXED);
+  sum->execute += __atomic_load_n (&c->execute, __ATOMIC_RELAXED);
+  sum->wrap += __atomic_load_n (&c->wrap, __ATOMIC_RELAXED);
+  sum->bytes += __atomic_load_n (&c->bytes, __ATOMIC_RELAXED);
+  for (int b = 0; b < CALL_METRICS_BUCKETS; ++b)
+    {
+      sum->histogram[b] += __atomic_load_n (&c->histogram[b], __ATOMIC_RELAXED);
+    }
+}
+
+/* Grows the shard to the registered functions, under the lock. */
+static int grow_shard (CallShard *shard)
+{
+  int capacity = functions_capacity;
+  CallCounters *grown;
+
+  if (capacity <= shard->capacity)
+    {
+      return 0;
+    }
+  grown = realloc (shard->counters, capacity * sizeof (CallCounters));
+  if (grown == NULL)
+    {
+      return -1;
+    }
+  memset (grown + shard->capacity, 0, (capacity - shard->capacity) * sizeof (CallCounters));
+  shard->counters = grown;
+  shard->capacity = capacity;
+  return 0;
+}
+
+#ifdef KTNUMPY_POSIX
+/* Called on the exit of a thread which counted calls. */
+static void retire_shard (void *ptr)
+{
+  CallShard *shard = (CallShard *) ptr;
+
+  CALL_METRICS_LOCK ();
+  for (CallShard **link = &shards; *link != NULL; link = &(*link)->next)
+    {
+      if (*link == shard)
+        {
+          *link = shard->next;
+          break;
+        }
+    }
+  if (grow_shard (&retired) == 0)
+    {
+      for (int f = 0; f < shard->capacity; ++f)
+        {
+          add_counters (&retired.counters[f], &shard->counters[f]);
+        }
+    }
+  CALL_METRICS_UNLOCK ();
+  free (shard->counters);
+  free (shard);
+}
+
+static void create_shard_key (void)
+{
+  pthread_key_create (&shard_key, retire_shard);
+}
+#endif
+
+/* Counters of the function in the shard of the calling thread. */
+static CallCounters *thread_counters (int function)
+{
+  CallShard *shard = thread_shard;
+  int failed = 0;
+
+  if (shard != NULL && function < shard->capacity)
+    {
+      return &shard->counters[function];
+    }
+  if (shard == NULL)
+    {
+      shard = calloc (1, sizeof (CallShard));
+      if (shard == NULL)
+        {
+          return NULL;
+        }
+#ifdef KTNUMPY_POSIX
+      pthread_once (&shard_key_once, create_shard_key);
+      pthread_setspecific (shard_key, shard);
+#endif
+      CALL_METRICS_LOCK ();
+      shard->next = shards;
+      shards = shard;
+      CALL_METRICS_UNLOCK ();
+      thread_shard = shard;
+    }
+  // the counters may be read by another thread while they are moved
+  CALL_METRICS_LOCK ();
+  failed = grow_shard (shard);
+  CALL_METRICS_UNLOCK ();
+  return failed || function >= shard->capacity ? NULL : &shard->counters[function];
+}
+
+static int latency_bucket (uint64_t ns)
+{
+  int exponent, bucket;
+
+  if (ns < CALL_METRICS_SUB_BUCKETS)
+    {
+      return (int) ns;
+    }
+  exponent = 63 - __builtin_clzll (ns);
+  bucket = CALL_METRICS_SUB_BUCKETS * (exponent - 2) + (int) ((ns >> (exponent - 3)) & 7);
+  return bucket < CALL_METRICS_BUCKETS ? bucket : CALL_METRICS_BUCKETS - 1;
+}
+
+/* The middle of the bucket. */
+static uint64_t bucket_latency (int bucket)
+{
+  int exponent = bucket / CALL_METRICS_SUB_BUCKETS + 2;
+
+  if (bucket < CALL_METRICS_SUB_BUCKETS)
+    {
+      return (uint64_t) bucket;
+    }
+  return ((uint64_t) (CALL_METRICS_SUB_BUCKETS + bucket % CALL_METRICS_SUB_BUCKETS) << (exponent - 3))
+         + ((uint64_t) 1 << (exponent - 3)) / 2;
+}
+
+void call_metrics_record_converted (JNIEnv *env, CallTiming *timing, jobjectArray names,
+                                    PyObject *function, PyObject *args)
+{
+  timing->function = find_function (function);
+  if (timing->function < 0 && function != NULL && names != NULL)
+    {
+      char *name = function_name (env, names);
+      if (name != NULL)
+        {
+          timing->function = call_metrics_register (function, name);
+          free (name);
+        }
+    }
+  // arrays made from Java objects are held by the arguments only
+  for (Py_ssize_t i = 0; args != NULL && i < PyTuple_GET_SIZE (args); ++i)
+    {
+      PyObject *arg = PyTuple_GET_ITEM (args, i);
+      if (PyArray_Check (arg) && Py_REFCNT (arg) == 1 && PyArray_CHKFLAGS ((PyArrayObject *) arg, NPY_ARRAY_OWNDATA))
+        {
+          timing->bytes += PyArray_NBYTES ((PyArrayObject *) arg);
+        }
+    }
+  timing->converted = call_metrics_now ();
+}
+
+void call_metrics_record (CallTiming *timing, int ok)
+{
+  uint64_t end = call_metrics_now ();
+  CallCounters *counters = NULL;
+
+  // a call which failed before the execution has its time in the conversion
+  if (timing->converted == 0)
+    {
+      timing->converted = timing->executed != 0 ? timing->executed : end;
+    }
+  if (timing->executed == 0)
+    {
+      timing->executed = timing->converted;
+    }
+  if (call_events_enabled)
+    {
+      events_push_call (timing->converted - timing->start, timing->executed - timing->converted,
+                        end - timing->executed, timing->bytes);
+    }
+  if (!call_metrics_enabled || timing->function < 0 || (counters = thread_counters (timing->function)) == NULL)
+    {
+      return;
+    }
+  __atomic_fetch_add (&counters->calls, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&counters->errors, !ok, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&counters->total, end - timing->start, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&counters->convert, timing->converted - timing->start, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&counters->execute, timing->executed - timing->converted, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&counters->wrap, end - timing->executed, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&counters->bytes, timing->bytes, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&counters->histogram[latency_bucket (end - timing->start)], 1, __ATOMIC_RELAXED);
+}
+
+static uint64_t percentile (const uint64_t *histogram, uint64_t calls, double q)
+{
+  uint64_t rank = (uint64_t) (q * (double) calls + 0.999999), seen = 0;
+
+  for (int b = 0; b < CALL_METRICS_BUCKETS; ++b)
+    {
+      seen += histogram[b];
+      if (seen >= rank && seen > 0)
+        {
+          return bucket_latency (b);
+        }
+    }
+  return 0;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    isEnabled
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_CallMetrics_isEnabled
+    (JNIEnv *env, jclass jcl)
+{
+  return call_metrics_enabled ? JNI_TRUE : JNI_FALSE;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    setEnabled
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_CallMetrics_setEnabled
+    (JNIEnv *env, jclass jcl, jboolean enabled)
+{
+  call_metrics_enabled = enabled == JNI_TRUE;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    functions
+ * Signature: ()[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jetbrains_numkt_CallMetrics_functions
+    (JNIEnv *env, jclass jcl)
+{
+  jobjectArray names;
+
+  CALL_METRICS_LOCK ();
+  names = (*env)->NewObjectArray (env, n_functions, STRING_TYPE, NULL);
+  for (int f = 0; names != NULL && f < n_functions; ++f)
+    {
+      jstring name = (*env)->NewStringUTF (env, functions[f].name != NULL ? functions[f].name : "");
+      (*env)->SetObjectArrayElement (env, names, f, name);
+      (*env)->DeleteLocalRef (env, name);
+    }
+  CALL_METRICS_UNLOCK ();
+  return names;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    counters
+ * Signature: ()[J
+ */
+JNIEXPORT jlongArray JNICALL Java_org_jetbrains_numkt_CallMetrics_counters
+    (JNIEnv *env, jclass jcl)
+{
+  jlongArray result;
+  jlong *values = NULL;
+  CallCounters *sum = calloc (1, sizeof (CallCounters));
+
+  CALL_METRICS_LOCK ();
+  result = (*env)->NewLongArray (env, n_functions * CALL_METRICS_FIELDS);
+  if (result == NULL || sum == NULL)
+    {
+      CALL_METRICS_UNLOCK ();
+      free (sum);
+      return result;
+    }
+  values = (*env)->GetLongArrayElements (env, result, NULL);
+  for (int f = 0; f < n_functions; ++f)
+    {
+      jlong *v = values + f * CALL_METRICS_FIELDS;
+      memset (sum, 0, sizeof (CallCounters));
+      if (f < retired.capacity)
+        {
+          add_counters (sum, &retired.counters[f]);
+        }
+      for (CallShard *shard = shards; shard != NULL; shard = shard->next)
+        {
+          if (f < shard->capacity)
+            {
+              add_counters (sum, &shard->counters[f]);
+            }
+        }
+      v[CALL_METRICS_CALLS] = (jlong) sum->calls;
+      v[CALL_METRICS_ERRORS] = (jlong) sum->errors;
+      v[CALL_METRICS_TOTAL] = (jlong) sum->total;
+      v[CALL_METRICS_P50] = (jlong) percentile (sum->histogram, sum->calls, 0.5);
+      v[CALL_METRICS_P99] = (jlong) percentile (sum->histogram, sum->calls, 0.99);
+      v[CALL_METRICS_CONVERT] = (jlong) sum->convert;
+      v[CALL_METRICS_EXECUTE] = (jlong) sum->execute;
+      v[CALL_METRICS_WRAP] = (jlong) sum->wrap;
+      v[CALL_METRICS_BYTES] = (jlong) sum->bytes;
+    }
+  CALL_METRICS_UNLOCK ();
+  (*env)->ReleaseLongArrayElements (env, result, values, 0);
+  free (sum);
+  return result;
+}
+
+static void clear_shard (CallShard *shard)
+{
+  uint64_t *values = (uint64_t *) shard->counters;
+  size_t n = (size_t) shard->capacity * (sizeof (CallCounters) / sizeof (uint64_t));
+
+  for (size_t i = 0; i < n; ++i)
+    {
+      __atomic_store_n (&values[i], 0, __ATOMIC_RELAXED);
+    }
+}
+
+/*
+ * Class:     org_jetbrains_numkt_CallMetrics
+ * Method:    clear
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_CallMetrics_clear
+    (JNIEnv *env, jclass jcl)
+{
+  CALL_METRICS_LOCK ();
+  for (CallShard *shard = shards; shard != NULL; shard = shard->next)
+    {
+      clear_shard (shard);
+    }
+  clear_shard (&retired);
+  CALL_METRICS_UNLOCK ();
+}
@@ -0,0 +1,508 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/*
+ * Distances are computed tile by tile: for L2 and cosine the products of a tile come from one BLAS call
+ * of numpy (||x||^2 + ||y||^2 - 2xy for L2, normalized rows for cosine), L1 is computed directly.
+ * Rows of a tile are then finished and, for k nearest neighbours, merged into per-query heaps
+ * on the thread pool without the GIL. The memory of knn is bounded by one tile whatever the sizes are.
+ */
+
+/* Queries and points in a tile of knn, 2 MiB of doubles. */
+#define NEIGHBORS_TILE_ROWS 128
+#define NEIGHBORS_TILE_COLS 2048
+
+/* Rows of a tile processed by one task of the thread pool. */
+#define NEIGHBORS_ROWS_PER_TASK 8
+
+typedef enum
+{
+  METRIC_EUCLIDEAN, METRIC_SQEUCLIDEAN, METRIC_MANHATTAN, METRIC_COSINE
+} NeighborsMetric;
+
+typedef struct
+{
+  NeighborsMetric metric;
+  npy_intp d;
+  /* rows of the result, C-contiguous (n, d) */
+  PyArrayObject *x;
+  npy_intp n;
+  /* columns of the result, C-contiguous (m, d) */
+  PyArrayObject *y;
+  npy_intp m;
+  /* squared norms of the rows for L2 */
+  double *xx;
+  double *yy;
+} NeighborsData;
+
+typedef struct
+{
+  const NeighborsData *data;
+  /* first row and column of the tile */
+  npy_intp row;
+  npy_intp col;
+  npy_intp cols;
+  /* products of the tile for L2 and cosine, overwritten with the distances */
+  double *tile;
+  npy_intp stride;
+  /* knn heaps, NULL for pairwise distances */
+  double *dist;
+  npy_int64 *index;
+  npy_intp k;
+  npy_intp heap_size;
+} NeighborsTask;
+
+static int metric_from_name (const char *name, NeighborsMetric *metric)
+{
+  if (strcmp (name, "euclidean") == 0) *metric = METRIC_EUCLIDEAN;
+  else if (strcmp (name, "sqeuclidean") == 0) *metric = METRIC_SQEUCLIDEAN;
+  else if (strcmp (name, "manhattan") == 0) *metric = METRIC_MANHATTAN;
+  else if (strcmp (name, "cosine") == 0) *metric = METRIC_COSINE;
+  else
+    {
+      PyErr_Format (PyExc_ValueError, "Unknown metric: %s", name);
+      return -1;
+    }
+  return 0;
+}
+
+/* C-contiguous float64 matrix, rows scaled to unit length for cosine. New reference. */
+static PyArrayObject *neighbors_matrix (PyArrayObject *array, NeighborsMetric metric)
+{
+  PyArrayObject *result = NULL;
+
+  if (PyArray_NDIM (array) != 2)
+    {
+      PyErr_SetString (PyExc_ValueError, "Expected a 2-d array of shape (samples, features).");
+      return NULL;
+    }
+  if (metric != METRIC_COSINE)
+    {
+      return (PyArrayObject *) PyArray_FROMANY ((PyObject *) array, NPY_FLOAT64, 2, 2, NPY_ARRAY_CARRAY_RO);
+    }
+
+  result = (PyArrayObject *) PyArray_FROMANY ((PyObject *) array, NPY_FLOAT64, 2, 2,
+                                              NPY_ARRAY_CARRAY | NPY_ARRAY_ENSURECOPY);
+  if (result != NULL)
+    {
+      npy_intp n = PyArray_DIM (result, 0), d = PyArray_DIM (result, 1);
+      double *row = (double *) PyArray_DATA (result);
+
+      for (npy_intp i = 0; i < n; ++i, row += d)
+        {
+          double norm = 0;
+          for (npy_intp t = 0; t < d; ++t) norm += row[t] * row[t];
+          // zero rows stay zero and are at distance 1 from everything
+          if (norm > 0)
+            {
+              norm = 1 / sqrt (norm);
+              for (npy_intp t = 0; t < d; ++t) row[t] *= norm;
+            }
+        }
+    }
+  return result;
+}
+
+static double *squared_norms (PyArrayObject *array)
+{
+  npy_intp n = PyArray_DIM (array, 0), d = PyArray_DIM (array, 1);
+  const double *row = (const double *) PyArray_DATA (array);
+  double *norms = (double *) malloc ((n > 0 ? n : 1) * sizeof (double));
+
+  if (norms == NULL)
+    {
+      PyErr_NoMemory ();
+      return NULL;
+    }
+  for (npy_intp i = 0; i < n; ++i, row += d)
+    {
+      double norm = 0;
+      for (npy_intp t = 0; t < d; ++t) norm += row[t] * row[t];
+      norms[i] = norm;
+    }
+  return norms;
+}
+
+static void neighbors_data_free (NeighborsData *data)
+{
+  Py_XDECREF (data->x);
+  Py_XDECREF (data->y);
+  free (data->xx);
+  free (data->yy);
+}
+
+static int neighbors_data_init (NeighborsData *data, PyArrayObject *x, PyArrayObject *y, const char *metric)
+{
+  memset (data, 0, sizeof (NeighborsData));
+  if (metric_from_name (metric, &data->metric) < 0)
+    {
+      return -1;
+    }
+  data->x = neighbors_matrix (x, data->metric);
+  if (data->x == NULL)
+    {
+      return -1;
+    }
+  data->y = neighbors_matrix (y, data->metric);
+  if (data->y == NULL)
+    {
+      return -1;
+    }
+  data->n = PyArray_DIM (data->x, 0);
+  data->m = PyArray_DIM (data->y, 0);
+  data->d = PyArray_DIM (data->x, 1);
+  if (PyArray_DIM (data->y, 1) != data->d)
+    {
+      PyErr_Format (PyExc_ValueError, "Number of features differs: %zd and %zd.", (Py_ssize_t) data->d,
+                    (Py_ssize_t) PyArray_DIM (data->y, 1));
+      return -1;
+    }
+  if (data->metric == METRIC_EUCLIDEAN || data->metric == METRIC_SQEUCLIDEAN)
+    {
+      data->xx = squared_norms (data->x);
+      data->yy = squared_norms (data->y);
+      if (data->xx == NULL || data->yy == NULL)
+        {
+          return -1;
+        }
+    }
+  return 0;
+}
+
+/* tile = x[row:row + rows] @ y[col:col + cols].T through BLAS, needs the GIL. */
+static int neighbors_products (const NeighborsData *data, npy_intp row, npy_intp rows, npy_intp col, npy_intp cols,
+                               double *tile)
+{
+  npy_intp x_dims[2] = {rows, data->d};
+  npy_intp y_dims[2] = {cols, data->d};
+  npy_intp tile_dims[2] = {rows, cols};
+  PyObject *xs = NULL, *ys = NULL, *yt = NULL, *out = NULL, *res = NULL;
+
+  xs = PyArray_SimpleNewFromData (2, x_dims, NPY_FLOAT64, (double *) PyArray_DATA (data->x) + row * data->d);
+  ys = PyArray_SimpleNewFromData (2, y_dims, NPY_FLOAT64, (double *) PyArray_DATA (data->y) + col * data->d);
+  out = PyArray_SimpleNewFromData (2, tile_dims, NPY_FLOAT64, tile);
+  if (xs != NULL && ys != NULL && out != NULL)
+    {
+      yt = PyArray_Transpose ((PyArrayObject *) ys, NULL);
+    }
+  if (yt != NULL)
+    {
+      res = PyArray_MatrixProduct2 (xs, yt, (PyArrayObject *) out);
+    }
+
+  Py_XDECREF (res);
+  Py_XDECREF (yt);
+  Py_XDECREF (out);
+  Py_XDECREF (ys);
+  Py_XDECREF (xs);
+  return res != NULL ? 0 : -1;
+}
+
+/* Max-heap of the k nearest candidates, ordered by distance and then by index. */
+static inline int heap_greater (double d1, npy_int64 i1, double d2, npy_int64 i2)
+{
+  return d1 > d2 || (d1 == d2 && i1 > i2);
+}
+
+static void heap_sift_down (double *dist, npy_int64 *index, npy_intp size, npy_intp pos)
+{
+  double d = dist[pos];
+  npy_int64 i = index[pos];
+
+  for (;;)
+    {
+      npy_intp child = 2 * pos + 1;
+      if (child >= size)
+        {
+          break;
+        }
+      if (child + 1 < size && heap_greater (dist[child + 1], index[child + 1], dist[child], index[child]))
+        {
+          ++child;
+        }
+      if (!heap_greater (dist[child], index[child], d, i))
+        {
+          break;
+        }
+      dist[pos] = dist[child];
+      index[pos] = index[child];
+      pos = child;
+    }
+  dist[pos] = d;
+  index[pos] = i;
+}
+
+static void heap_push (double *dist, npy_int64 *index, npy_intp size, double d, npy_int64 i)
+{
+  npy_intp pos = size;
+
+  while (pos > 0)
+    {
+      npy_intp parent = (pos - 1) / 2;
+      if (!heap_greater (d, i, dist[parent], index[parent]))
+        {
+          break;
+        }
+      dist[pos] = dist[parent];
+      index[pos] = index[parent];
+      pos = parent;
+    }
+  dist[pos] = d;
+  index[pos] = i;
+}
+
+npy_intp neighbors_heap_offer (double *dist, npy_int64 *index, npy_intp size, npy_intp k, double d, npy_int64 i)
+{
+  if (size < k)
+    {
+      heap_push (dist, index, size, d, i);
+      return size + 1;
+    }
+  if (heap_greater (dist[0], index[0], d, i))
+    {
+      dist[0] = d;
+      index[0] = i;
+      heap_sift_down (dist, index, size, 0);
+    }
+  return size;
+}
+
+void neighbors_heap_make (double *dist, npy_int64 *index, npy_intp size)
+{
+  for (npy_intp pos = size / 2 - 1; pos >= 0; --pos)
+    {
+      heap_sift_down (dist, index, size, pos);
+    }
+}
+
+void neighbors_heap_sort (double *dist, npy_int64 *index, npy_intp size)
+{
+  for (npy_intp end = size - 1; end > 0; --end)
+    {
+      double d = dist[0];
+      npy_int64 i = index[0];
+      dist[0] = dist[end];
+      index[0] = index[end];
+      dist[end] = d;
+      index[end] = i;
+      heap_sift_down (dist, index, end, 0);
+    }
+}
+
+static void neighbors_rows_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  const NeighborsTask *task = (const NeighborsTask *) ctx;
+  const NeighborsData *data = task->data;
+  const npy_intp d = data->d;
+
+  for (Py_ssize_t r = begin; r < end; ++r)
+    {
+      npy_intp i = task->row + r;
+      double *out = task->tile + r * task->stride;
+
+      switch (data->metric)
+        {
+          case METRIC_EUCLIDEAN:
+          case METRIC_SQEUCLIDEAN:
+            {
+              const double xx = data->xx[i];
+              const double *yy = data->yy + task->col;
+              for (npy_intp j = 0; j < task->cols; ++j)
+                {
+                  // rounding may make the distance of close points slightly negative
+                  double v = xx + yy[j] - 2 * out[j];
+                  out[j] = v > 0 ? v : 0;
+                }
+              if (data->metric == METRIC_EUCLIDEAN)
+                {
+                  for (npy_intp j = 0; j < task->cols; ++j) out[j] = sqrt (out[j]);
+                }
+            }
+          break;
+          case METRIC_MANHATTAN:
+            {
+              const double *x = (const double *) PyArray_DATA (data->x) + i * d;
+              const double *y = (const double *) PyArray_DATA (data->y) + task->col * d;
+              for (npy_intp j = 0; j < task->cols; ++j, y += d)
+                {
+                  double s = 0;
+                  for (npy_intp t = 0; t < d; ++t) s += fabs (x[t] - y[t]);
+                  out[j] = s;
+                }
+            }
+          break;
+          case METRIC_COSINE:
+            for (npy_intp j = 0; j < task->cols; ++j) out[j] = 1 - out[j];
+          break;
+        }
+
+      if (task->dist != NULL)
+        {
+          double *dist = task->dist + i * task->k;
+          npy_int64 *index = task->index + i * task->k;
+          npy_intp size = task->heap_size;
+
+          for (npy_intp j = 0; j < task->cols; ++j)
+            {
+              size = neighbors_heap_offer (dist, index, size, task->k, out[j], (npy_int64) (task->col + j));
+            }
+          if (task->col + task->cols == data->m)
+            {
+              neighbors_heap_sort (dist, index, size);
+            }
+        }
+    }
+}
+
+/* Computes the distances of a tile and merges them into the heaps, needs the GIL, releases it while computing. */
+static int neighbors_tile (NeighborsTask *task, npy_intp rows)
+{
+  if (task->data->metric != METRIC_MANHATTAN
+      && neighbors_products (task->data, task->row, rows, task->col, task->cols, task->tile) < 0)
+    {
+      return -1;
+    }
+  Py_BEGIN_ALLOW_THREADS
+  thread_pool_parallel_for (rows, NEIGHBORS_ROWS_PER_TASK, neighbors_rows_task, task);
+  KTNUMPY_END_ALLOW_THREADS
+  return 0;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    pairwiseDistances
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Ljava/lang/String;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_pairwiseDistances
+    (JNIEnv *env, jclass jcl, jobject jx, jobject jy, jstring jmetric)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  const char *metric = jstring_to_char (env, jmetric);
+  NeighborsData data;
+  NeighborsTask task;
+  PyArrayObject *out = NULL;
+  jobject result = NULL;
+
+  if (neighbors_data_init (&data, numkt_core_KtNDArray_getPointer (env, jx),
+                           numkt_core_KtNDArray_getPointer (env, jy), metric) == 0)
+    {
+      npy_intp dims[2] = {data.n, data.m};
+      out = (PyArrayObject *) PyArray_SimpleNew (2, dims, NPY_FLOAT64);
+    }
+  if (out != NULL)
+    {
+      memset (&task, 0, sizeof (NeighborsTask));
+      task.data = &data;
+      task.cols = data.m;
+      task.tile = (double *) PyArray_DATA (out);
+      task.stride = data.m;
+      // the output is the only full-size buffer, BLAS blocks the product itself
+      if (neighbors_tile (&task, data.n) < 0)
+        {
+          Py_CLEAR (out);
+        }
+    }
+
+  neighbors_data_free (&data);
+  release_utf_char (env, jmetric, metric);
+  if (out != NULL)
+    {
+      result = new_ktndarray (env, out, NULL);
+    }
+  python_exception (env);
+
+  return result;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    knn
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Ljava/lang/String;Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_knn
+    (JNIEnv *env, jclass jcl, jobject jpoints, jobject jqueries, jstring jmetric, jobject jindices,
+     jobject jdistances)
+{
+  NPY_IMPORT_ONCE ()
+
+  const char *metric = jstring_to_char (env, jmetric);
+  PyArrayObject *indices = numkt_core_KtNDArray_getPointer (env, jindices);
+  PyArrayObject *distances = numkt_core_KtNDArray_getPointer (env, jdistances);
+  NeighborsData data;
+  NeighborsTask task;
+  double *tile = NULL;
+
+  // queries are the rows of the distance matrix, points are the columns
+  if (neighbors_data_init (&data, numkt_core_KtNDArray_getPointer (env, jqueries),
+                           numkt_core_KtNDArray_getPointer (env, jpoints), metric) < 0)
+    {
+      goto OUT;
+    }
+
+  memset (&task, 0, sizeof (NeighborsTask));
+  task.data = &data;
+  task.k = PyArray_NDIM (indices) == 2 ? PyArray_DIM (indices, 1) : -1;
+  if (PyArray_TYPE (indices) != NPY_INT64 || PyArray_TYPE (distances) != NPY_FLOAT64
+      || !PyArray_IS_C_CONTIGUOUS (indices) || !PyArray_IS_C_CONTIGUOUS (distances)
+      || PyArray_NDIM (indices) != 2 || PyArray_NDIM (distances) != 2
+      || PyArray_DIM (indices, 0) != data.n || PyArray_DIM (distances, 0) != data.n
+      || PyArray_DIM (distances, 1) != task.k)
+    {
+      PyErr_SetString (PyExc_ValueError, "Outputs must be C-contiguous int64 and float64 arrays of shape (queries, k).");
+      goto OUT;
+    }
+  if (task.k < 1 || task.k > data.m)
+    {
+      PyErr_Format (PyExc_ValueError, "k must be in [1, %zd].", (Py_ssize_t) data.m);
+      goto OUT;
+    }
+
+  tile = (double *) malloc (NEIGHBORS_TILE_ROWS * NEIGHBORS_TILE_COLS * sizeof (double));
+  if (tile == NULL)
+    {
+      PyErr_NoMemory ();
+      goto OUT;
+    }
+  task.tile = tile;
+  task.dist = (double *) PyArray_DATA (distances);
+  task.index = (npy_int64 *) PyArray_DATA (indices);
+
+  for (npy_intp row = 0; row < data.n; row += NEIGHBORS_TILE_ROWS)
+    {
+      npy_intp rows = data.n - row < NEIGHBORS_TILE_ROWS ? data.n - row : NEIGHBORS_TILE_ROWS;
+
+      task.row = row;
+      for (task.col = 0; task.col < data.m; task.col += task.cols)
+        {
+          task.cols = data.m - task.col < NEIGHBORS_TILE_COLS ? data.m - task.col : NEIGHBORS_TILE_COLS;
+          task.stride = task.cols;
+          task.heap_size = task.col < task.k ? task.col : task.k;
+          if (neighbors_tile (&task, rows) < 0)
+            {
+              goto OUT;
+            }
+        }
+    }
+
+  OUT:
+  free (tile);
+  neighbors_data_free (&data);
+  release_utf_char (env, jmetric, metric);
+  python_exception (env);
+}
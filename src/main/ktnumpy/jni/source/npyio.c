@@ -0,0 +1,1132 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#ifdef KTNUMPY_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define NPY_MAGIC "\x93NUMPY"
+#define NPY_MAGIC_LEN 6
+#define NPY_DESCR_LEN 64
+#define NPY_MAPPING_CAPSULE "ktnumpy.mapping"
+
+#define ZIP_LOCAL_HEADER_SIG  0x04034b50
+#define ZIP_CENTRAL_DIR_SIG   0x02014b50
+#define ZIP_END_SIG           0x06054b50
+#define ZIP64_END_SIG         0x06064b50
+#define ZIP64_LOCATOR_SIG     0x07064b50
+#define ZIP64_EXTRA_ID        0x0001
+#define ZIP_STORED            0
+
+/* Parsed header of .npy format. */
+typedef struct
+{
+  char descr[NPY_DESCR_LEN];
+  int fortran_order;
+  int ndim;
+  npy_intp shape[NPY_MAXDIMS];
+  /* magic string, version, header length and header dictionary */
+  size_t header_size;
+} NpyHeader;
+
+/* Memory mapping owned by the arrays created over it. */
+typedef struct
+{
+  void *addr;
+  size_t length;
+} NpyMapping;
+
+typedef struct
+{
+  int prot;
+  int flags;
+  int open_flags;
+  int writeable;
+} NpyMapMode;
+
+/* Entry of zip central directory. */
+typedef struct
+{
+  const char *name;
+  size_t name_len;
+  int method;
+  npy_uint64 size;
+  npy_uint64 local_offset;
+} ZipEntry;
+
+static npy_uint16 read_le16 (const unsigned char *p)
+{
+  return (npy_uint16) (p[0] | (p[1] << 8));
+}
+
+static npy_uint32 read_le32 (const unsigned char *p)
+{
+  return (npy_uint32) p[0] | ((npy_uint32) p[1] << 8) | ((npy_uint32) p[2] << 16) | ((npy_uint32) p[3] << 24);
+}
+
+static npy_uint64 read_le64 (const unsigned char *p)
+{
+  return (npy_uint64) read_le32 (p) | ((npy_uint64) read_le32 (p + 4) << 32);
+}
+
+static const char *skip_spaces (const char *p)
+{
+  while (*p == ' ' || *p == '\t' || *p == '\n')
+    {
+      ++p;
+    }
+  return p;
+}
+
+/* Returns position of value for key in header dictionary. */
+static const char *npy_dict_value (const char *dict, const char *key)
+{
+  const char *p = strstr (dict, key);
+  if (p == NULL)
+    {
+      PyErr_Format (PyExc_ValueError, "Header of .npy file does not contain %s.", key);
+      return NULL;
+    }
+  p = skip_spaces (p + strlen (key));
+  if (*p != ':')
+    {
+      PyErr_SetString (PyExc_ValueError, "Header of .npy file is malformed.");
+      return NULL;
+    }
+  return skip_spaces (p + 1);
+}
+
+/*
+ * Parse dictionary like
+ * {'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }
+ */
+static int npy_parse_dict (const char *dict, NpyHeader *header)
+{
+  const char *p = NULL;
+  char quote;
+  size_t len = 0;
+
+  p = npy_dict_value (dict, "'descr'");
+  if (p == NULL)
+    {
+      return -1;
+    }
+  quote = *p;
+  if (quote != '\'' && quote != '"')
+    {
+      PyErr_SetString (PyExc_ValueError, "Structured dtypes cannot be memory-mapped.");
+      return -1;
+    }
+  ++p;
+  while (p[len] != '\0' && p[len] != quote)
+    {
+      ++len;
+    }
+  if (p[len] != quote || len >= NPY_DESCR_LEN)
+    {
+      PyErr_SetString (PyExc_ValueError, "Header of .npy file has invalid descr.");
+      return -1;
+    }
+  memcpy (header->descr, p, len);
+  header->descr[len] = '\0';
+
+  p = npy_dict_value (dict, "'fortran_order'");
+  if (p == NULL)
+    {
+      return -1;
+    }
+  if (strncmp (p, "True", 4) == 0)
+    {
+      header->fortran_order = 1;
+    }
+  else if (strncmp (p, "False", 5) == 0)
+    {
+      header->fortran_order = 0;
+    }
+  else
+    {
+      PyErr_SetString (PyExc_ValueError, "Header of .npy file has invalid fortran_order.");
+      return -1;
+    }
+
+  p = npy_dict_value (dict, "'shape'");
+  if (p == NULL)
+    {
+      return -1;
+    }
+  if (*p != '(')
+    {
+      PyErr_SetString (PyExc_ValueError, "Header of .npy file has invalid shape.");
+      return -1;
+    }
+  p = skip_spaces (p + 1);
+  header->ndim = 0;
+  while (*p != ')')
+    {
+      char *end = NULL;
+      long long dim = strtoll (p, &end, 10);
+      if (end == p || dim < 0 || header->ndim == NPY_MAXDIMS)
+        {
+          PyErr_SetString (PyExc_ValueError, "Header of .npy file has invalid shape.");
+          return -1;
+        }
+      header->shape[header->ndim++] = (npy_intp) dim;
+      // python 2 long literal
+      p = end;
+      if (*p == 'L')
+        {
+          ++p;
+        }
+      p = skip_spaces (p);
+      if (*p == ',')
+        {
+          p = skip_spaces (p + 1);
+        }
+      else if (*p != ')')
+        {
+          PyErr_SetString (PyExc_ValueError, "Header of .npy file has invalid shape.");
+          return -1;
+        }
+    }
+
+  return 0;
+}
+
+static int npy_read_header (const unsigned char *buf, size_t len, NpyHeader *header)
+{
+  size_t dict_start = 0;
+  size_t dict_len = 0;
+  char *dict = NULL;
+  int ret = 0;
+
+  if (len < 10 || memcmp (buf, NPY_MAGIC, NPY_MAGIC_LEN) != 0)
+    {
+      PyErr_SetString (PyExc_ValueError, "File is not in .npy format.");
+      return -1;
+    }
+
+  switch (buf[6])
+    {
+      case 1:
+        dict_len = read_le16 (buf + 8);
+      dict_start = 10;
+      break;
+      case 2:
+      case 3:
+        if (len < 12)
+          {
+            PyErr_SetString (PyExc_ValueError, "Header of .npy file is truncated.");
+            return -1;
+          }
+      dict_len = read_le32 (buf + 8);
+      dict_start = 12;
+      break;
+      default:
+        PyErr_Format (PyExc_ValueError, "Unsupported .npy format version %d.%d.", buf[6], buf[7]);
+      return -1;
+    }
+
+  if (dict_start + dict_len > len)
+    {
+      PyErr_SetString (PyExc_ValueError, "Header of .npy file is truncated.");
+      return -1;
+    }
+
+  dict = malloc (dict_len + 1);
+  if (dict == NULL)
+    {
+      PyErr_NoMemory ();
+      return -1;
+    }
+  memcpy (dict, buf + dict_start, dict_len);
+  dict[dict_len] = '\0';
+
+  ret = npy_parse_dict (dict, header);
+  header->header_size = dict_start + dict_len;
+
+  free (dict);
+  return ret;
+}
+
+#ifdef KTNUMPY_POSIX
+
+static int npy_map_mode (const char *mode, NpyMapMode *map_mode)
+{
+  if (strcmp (mode, "r") == 0)
+    {
+      map_mode->prot = PROT_READ;
+      map_mode->flags = MAP_SHARED;
+      map_mode->open_flags = O_RDONLY;
+      map_mode->writeable = 0;
+    }
+  else if (strcmp (mode, "r+") == 0)
+    {
+      map_mode->prot = PROT_READ | PROT_WRITE;
+      map_mode->flags = MAP_SHARED;
+      map_mode->open_flags = O_RDWR;
+      map_mode->writeable = 1;
+    }
+  else if (strcmp (mode, "c") == 0)
+    {
+      map_mode->prot = PROT_READ | PROT_WRITE;
+      map_mode->flags = MAP_PRIVATE;
+      map_mode->open_flags = O_RDONLY;
+      map_mode->writeable = 1;
+    }
+  else
+    {
+      PyErr_Format (PyExc_ValueError, "Unknown mmap mode: %s.", mode);
+      return -1;
+    }
+  return 0;
+}
+
+static void npy_mapping_destructor (PyObject *capsule)
+{
+  NpyMapping *mapping = PyCapsule_GetPointer (capsule, NPY_MAPPING_CAPSULE);
+  if (mapping != NULL)
+    {
+      munmap (mapping->addr, mapping->length);
+      free (mapping);
+    }
+}
+
+/* Maps [offset, offset + length) of the file, the capsule unmaps it when the last array is deallocated. */
+static PyObject *npy_mapping_new (int fd, off_t offset, size_t length, const NpyMapMode *map_mode, char **data)
+{
+  long page_size = sysconf (_SC_PAGESIZE);
+  off_t start = offset - offset % page_size;
+  size_t shift = (size_t) (offset - start);
+  NpyMapping *mapping = NULL;
+  PyObject *capsule = NULL;
+  void *addr = NULL;
+
+  addr = mmap (NULL, length + shift, map_mode->prot, map_mode->flags, fd, start);
+  if (addr == MAP_FAILED)
+    {
+      PyErr_SetFromErrno (PyExc_OSError);
+      return NULL;
+    }
+
+  mapping = malloc (sizeof (NpyMapping));
+  if (mapping == NULL)
+    {
+      munmap (addr, length + shift);
+      PyErr_NoMemory ();
+      return NULL;
+    }
+  mapping->addr = addr;
+  mapping->length = length + shift;
+
+  capsule = PyCapsule_New (mapping, NPY_MAPPING_CAPSULE, npy_mapping_destructor);
+  if (capsule == NULL)
+    {
+      munmap (addr, length + shift);
+      free (mapping);
+      return NULL;
+    }
+
+  *data = (char *) addr + shift;
+  return capsule;
+}
+
+/* Creates ndarray over .npy content placed at data, which belongs to the mapping. */
+static PyArrayObject *npy_array_from_mapping (PyObject *capsule, char *data, size_t length, int writeable)
+{
+  NpyHeader header;
+  PyArray_Descr *descr = NULL;
+  PyObject *descr_str = NULL;
+  PyArrayObject *array = NULL;
+  npy_intp nbytes = 0;
+  int flags = 0;
+
+  if (npy_read_header ((const unsigned char *) data, length, &header) < 0)
+    {
+      return NULL;
+    }
+
+  descr_str = PyUnicode_FromString (header.descr);
+  if (descr_str == NULL)
+    {
+      return NULL;
+    }
+  if (!PyArray_DescrConverter (descr_str, &descr))
+    {
+      Py_DECREF (descr_str);
+      return NULL;
+    }
+  Py_DECREF (descr_str);
+
+  if (PyDataType_FLAGCHK (descr, NPY_ITEM_HASOBJECT))
+    {
+      PyErr_SetString (PyExc_ValueError, "Arrays with objects cannot be memory-mapped.");
+      Py_DECREF (descr);
+      return NULL;
+    }
+  if (descr->byteorder == NPY_OPPBYTE)
+    {
+      PyErr_SetString (PyExc_ValueError, "Arrays with non-native byte order cannot be memory-mapped.");
+      Py_DECREF (descr);
+      return NULL;
+    }
+
+  // the shape of a corrupted header can overflow the size
+  nbytes = PyDataType_ELSIZE (descr);
+  for (int i = 0; i < header.ndim && nbytes >= 0; ++i)
+    {
+      if (__builtin_mul_overflow (nbytes, header.shape[i], &nbytes))
+        {
+          nbytes = -1;
+        }
+    }
+  if (nbytes < 0 || header.header_size > length || (size_t) nbytes > length - header.header_size)
+    {
+      PyErr_SetString (PyExc_ValueError, "Data of .npy file is truncated.");
+      Py_DECREF (descr);
+      return NULL;
+    }
+
+  flags = header.fortran_order ? NPY_ARRAY_F_CONTIGUOUS : NPY_ARRAY_C_CONTIGUOUS;
+  if (writeable)
+    {
+      flags |= NPY_ARRAY_WRITEABLE;
+    }
+
+  // steals descr
+  array = (PyArrayObject *) PyArray_NewFromDescr (&PyArray_Type, descr, header.ndim, header.shape, NULL,
+                                                  data + header.header_size, flags, NULL);
+  if (array == NULL)
+    {
+      return NULL;
+    }
+
+  Py_INCREF (capsule);
+  if (PyArray_SetBaseObject (array, capsule) < 0)
+    {
+      Py_DECREF (array);
+      return NULL;
+    }
+
+  return array;
+}
+
+/* Maps the whole .npy content of the descriptor, which can be closed afterwards. */
+static PyArrayObject *npy_array_from_fd (int fd, const NpyMapMode *map_mode)
+{
+  PyObject *capsule = NULL;
+  PyArrayObject *array = NULL;
+  struct stat st;
+  char *data = NULL;
+
+  if (fstat (fd, &st) < 0)
+    {
+      PyErr_SetFromErrno (PyExc_OSError);
+      return NULL;
+    }
+  if (st.st_size == 0)
+    {
+      PyErr_SetString (PyExc_ValueError, "Cannot memory-map an empty file.");
+      return NULL;
+    }
+
+  capsule = npy_mapping_new (fd, 0, (size_t) st.st_size, map_mode, &data);
+  if (capsule != NULL)
+    {
+      array = npy_array_from_mapping (capsule, data, (size_t) st.st_size, map_mode->writeable);
+      Py_DECREF (capsule);
+    }
+
+  return array;
+}
+
+/* Writes .npy header of version 1.0 for C-ordered data, returns its size or -1 if buf is too small. */
+static Py_ssize_t npy_write_header (char *buf, size_t size, const char *descr, int ndim, const npy_intp *shape)
+{
+  char dict[NPY_DESCR_LEN + NPY_MAXDIMS * 24 + 64];
+  size_t len = 0;
+  size_t header_size = 0;
+
+  len += snprintf (dict + len, sizeof (dict) - len, "{'descr': '%s', 'fortran_order': False, 'shape': (", descr);
+  for (int i = 0; i < ndim; ++i)
+    {
+      len += snprintf (dict + len, sizeof (dict) - len, i == 0 ? "%" NPY_INTP_FMT : ", %" NPY_INTP_FMT, shape[i]);
+    }
+  len += snprintf (dict + len, sizeof (dict) - len, ndim == 1 ? ",), }" : "), }");
+
+  // the data is aligned to 64 bytes, the dictionary is padded with spaces and ends with a newline
+  header_size = (NPY_MAGIC_LEN + 4 + len + 1 + 63) / 64 * 64;
+  if (header_size > size || header_size - NPY_MAGIC_LEN - 4 > 0xffff)
+    {
+      return -1;
+    }
+
+  memcpy (buf, NPY_MAGIC, NPY_MAGIC_LEN);
+  buf[NPY_MAGIC_LEN] = 1;
+  buf[NPY_MAGIC_LEN + 1] = 0;
+  buf[NPY_MAGIC_LEN + 2] = (char) ((header_size - NPY_MAGIC_LEN - 4) & 0xff);
+  buf[NPY_MAGIC_LEN + 3] = (char) ((header_size - NPY_MAGIC_LEN - 4) >> 8);
+  memcpy (buf + NPY_MAGIC_LEN + 4, dict, len);
+  memset (buf + NPY_MAGIC_LEN + 4 + len, ' ', header_size - NPY_MAGIC_LEN - 4 - len - 1);
+  buf[header_size - 1] = '\n';
+
+  return (Py_ssize_t) header_size;
+}
+
+/* Reads central directory of zip archive, returns number of entries or -1. */
+static Py_ssize_t zip_read_entries (const unsigned char *zip, size_t size, ZipEntry **entries)
+{
+  const unsigned char *eocd = NULL;
+  const unsigned char *p = NULL;
+  const unsigned char *end = zip + size;
+  npy_uint64 count = 0;
+  npy_uint64 cd_size = 0;
+  npy_uint64 cd_offset = 0;
+  size_t min_pos = 0;
+
+  if (size < 22)
+    {
+      PyErr_SetString (PyExc_ValueError, "File is not a zip archive.");
+      return -1;
+    }
+
+  // end of central directory record, followed by comment up to 64 KiB
+  min_pos = size > 22 + 0xFFFF ? size - 22 - 0xFFFF : 0;
+  for (size_t pos = size - 22;; --pos)
+    {
+      if (read_le32 (zip + pos) == ZIP_END_SIG)
+        {
+          eocd = zip + pos;
+          break;
+        }
+      if (pos == min_pos)
+        {
+          break;
+        }
+    }
+  if (eocd == NULL)
+    {
+      PyErr_SetString (PyExc_ValueError, "File is not a zip archive.");
+      return -1;
+    }
+
+  count = read_le16 (eocd + 10);
+  cd_size = read_le32 (eocd + 12);
+  cd_offset = read_le32 (eocd + 16);
+
+  if (count == 0xFFFF || cd_size == 0xFFFFFFFF || cd_offset == 0xFFFFFFFF)
+    {
+      const unsigned char *locator = eocd - 20;
+      const unsigned char *record = NULL;
+
+      if (locator < zip || read_le32 (locator) != ZIP64_LOCATOR_SIG)
+        {
+          PyErr_SetString (PyExc_ValueError, "Zip64 end of central directory locator is missing.");
+          return -1;
+        }
+      if (read_le64 (locator + 8) + 56 > size)
+        {
+          PyErr_SetString (PyExc_ValueError, "Zip64 end of central directory is corrupted.");
+          return -1;
+        }
+      record = zip + read_le64 (locator + 8);
+      if (read_le32 (record) != ZIP64_END_SIG)
+        {
+          PyErr_SetString (PyExc_ValueError, "Zip64 end of central directory is corrupted.");
+          return -1;
+        }
+      count = read_le64 (record + 32);
+      cd_size = read_le64 (record + 40);
+      cd_offset = read_le64 (record + 48);
+    }
+
+  if (cd_offset + cd_size > size || count > cd_size / 46)
+    {
+      PyErr_SetString (PyExc_ValueError, "Zip central directory is corrupted.");
+      return -1;
+    }
+
+  *entries = malloc ((count ? count : 1) * sizeof (ZipEntry));
+  if (*entries == NULL)
+    {
+      PyErr_NoMemory ();
+      return -1;
+    }
+
+  p = zip + cd_offset;
+  for (npy_uint64 i = 0; i < count; ++i)
+    {
+      ZipEntry *entry = *entries + i;
+      const unsigned char *extra = NULL;
+      npy_uint64 uncompressed_size = 0;
+      size_t name_len, extra_len, comment_len;
+
+      if (p + 46 > end || read_le32 (p) != ZIP_CENTRAL_DIR_SIG)
+        {
+          free (*entries);
+          PyErr_SetString (PyExc_ValueError, "Zip central directory is corrupted.");
+          return -1;
+        }
+
+      name_len = read_le16 (p + 28);
+      extra_len = read_le16 (p + 30);
+      comment_len = read_le16 (p + 32);
+      if (p + 46 + name_len + extra_len + comment_len > end)
+        {
+          free (*entries);
+          PyErr_SetString (PyExc_ValueError, "Zip central directory is corrupted.");
+          return -1;
+        }
+
+      entry->method = read_le16 (p + 10);
+      entry->size = read_le32 (p + 20);
+      uncompressed_size = read_le32 (p + 24);
+      entry->local_offset = read_le32 (p + 42);
+      entry->name = (const char *) p + 46;
+      entry->name_len = name_len;
+
+      // sizes and offset which do not fit into 32 bits are stored in zip64 extra field
+      extra = p + 46 + name_len;
+      while (extra + 4 <= p + 46 + name_len + extra_len)
+        {
+          npy_uint16 id = read_le16 (extra);
+          npy_uint16 len = read_le16 (extra + 2);
+          const unsigned char *q = extra + 4;
+
+          if (id == ZIP64_EXTRA_ID)
+            {
+              if (uncompressed_size == 0xFFFFFFFF && q + 8 <= extra + 4 + len)
+                {
+                  uncompressed_size = read_le64 (q);
+                  q += 8;
+                }
+              if (entry->size == 0xFFFFFFFF && q + 8 <= extra + 4 + len)
+                {
+                  entry->size = read_le64 (q);
+                  q += 8;
+                }
+              if (entry->local_offset == 0xFFFFFFFF && q + 8 <= extra + 4 + len)
+                {
+                  entry->local_offset = read_le64 (q);
+                }
+              break;
+            }
+          extra += 4 + len;
+        }
+
+      p += 46 + name_len + extra_len + comment_len;
+    }
+
+  return (Py_ssize_t) count;
+}
+
+/* Offset of member data, that is after its local file header. */
+static npy_int64 zip_data_offset (const unsigned char *zip, size_t size, const ZipEntry *entry)
+{
+  const unsigned char *local = zip + entry->local_offset;
+  npy_uint64 offset = 0;
+
+  if (entry->local_offset + 30 > size || read_le32 (local) != ZIP_LOCAL_HEADER_SIG)
+    {
+      PyErr_SetString (PyExc_ValueError, "Zip local file header is corrupted.");
+      return -1;
+    }
+  offset = entry->local_offset + 30 + read_le16 (local + 26) + read_le16 (local + 28);
+  if (offset + entry->size > size)
+    {
+      PyErr_SetString (PyExc_ValueError, "Zip member is truncated.");
+      return -1;
+    }
+  return (npy_int64) offset;
+}
+
+#endif // KTNUMPY_POSIX
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    mmapNpy
+ * Signature: (Ljava/lang/String;Ljava/lang/String;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_NpyIO_mmapNpy
+    (JNIEnv *env, jclass jcl, jstring jpath, jstring jmode)
+{
+#ifdef KTNUMPY_POSIX
+  NPY_IMPORT_ONCE (NULL)
+
+  const char *path = jstring_to_char (env, jpath);
+  const char *mode = jstring_to_char (env, jmode);
+  NpyMapMode map_mode;
+  PyArrayObject *array = NULL;
+  jobject result = NULL;
+  int fd = -1;
+
+  if (npy_map_mode (mode, &map_mode) < 0)
+    {
+      goto OUT;
+    }
+
+  fd = open (path, map_mode.open_flags);
+  if (fd < 0)
+    {
+      PyErr_SetFromErrnoWithFilename (PyExc_OSError, path);
+      goto OUT;
+    }
+
+  // the mapping stays valid after the descriptor is closed
+  array = npy_array_from_fd (fd, &map_mode);
+  if (array != NULL)
+    {
+      result = new_ktndarray (env, array, NULL);
+    }
+
+  OUT:
+  if (fd >= 0)
+    {
+      close (fd);
+    }
+  python_exception (env);
+  release_utf_char (env, jpath, path);
+  release_utf_char (env, jmode, mode);
+
+  return result;
+#else
+  (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Memory-mapped arrays are not supported on this platform.");
+  return NULL;
+#endif
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    mmapNpz
+ * Signature: (Ljava/lang/String;Ljava/lang/String;)[Ljava/lang/Object;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jetbrains_numkt_NpyIO_mmapNpz
+    (JNIEnv *env, jclass jcl, jstring jpath, jstring jmode)
+{
+#ifdef KTNUMPY_POSIX
+  NPY_IMPORT_ONCE (NULL)
+
+  const char *path = jstring_to_char (env, jpath);
+  // without mode members are mapped for reading and copied into memory
+  const char *mode = jmode != NULL ? jstring_to_char (env, jmode) : "r";
+  int copy = jmode == NULL;
+  NpyMapMode map_mode;
+  ZipEntry *entries = NULL;
+  PyObject *npz = NULL;
+  unsigned char *zip = MAP_FAILED;
+  jobjectArray result = NULL;
+  Py_ssize_t count = 0;
+  struct stat st;
+  int fd = -1;
+
+  if (npy_map_mode (mode, &map_mode) < 0)
+    {
+      goto OUT;
+    }
+  if (map_mode.prot & PROT_WRITE && map_mode.flags == MAP_SHARED)
+    {
+      // in-place writes would invalidate CRC of the member
+      PyErr_SetString (PyExc_ValueError, "Members of .npz file can be mapped only in 'r' or 'c' mode.");
+      goto OUT;
+    }
+
+  fd = open (path, O_RDONLY);
+  if (fd < 0 || fstat (fd, &st) < 0)
+    {
+      PyErr_SetFromErrnoWithFilename (PyExc_OSError, path);
+      goto OUT;
+    }
+
+  zip = st.st_size > 0 ? mmap (NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  if (zip == MAP_FAILED)
+    {
+      PyErr_SetString (PyExc_ValueError, "File is not a zip archive.");
+      goto OUT;
+    }
+
+  count = zip_read_entries (zip, (size_t) st.st_size, &entries);
+  if (count < 0)
+    {
+      goto OUT;
+    }
+
+  result = (*env)->NewObjectArray (env, (jsize) (2 * count), OBJECT_TYPE, NULL);
+  if (result == NULL)
+    {
+      goto OUT;
+    }
+
+  for (Py_ssize_t i = 0; i < count; ++i)
+    {
+      ZipEntry *entry = entries + i;
+      PyArrayObject *array = NULL;
+      size_t key_len = entry->name_len;
+      char *key = NULL;
+
+      if (key_len > 4 && memcmp (entry->name + key_len - 4, ".npy", 4) == 0)
+        {
+          key_len -= 4;
+        }
+      key = malloc (key_len + 1);
+      if (key == NULL)
+        {
+          PyErr_NoMemory ();
+          break;
+        }
+      memcpy (key, entry->name, key_len);
+      key[key_len] = '\0';
+
+      if (entry->method == ZIP_STORED)
+        {
+          char *data = NULL;
+          PyObject *capsule = NULL;
+          npy_int64 offset = zip_data_offset (zip, (size_t) st.st_size, entry);
+
+          if (offset >= 0)
+            {
+              capsule = npy_mapping_new (fd, (off_t) offset, entry->size, &map_mode, &data);
+            }
+          if (capsule != NULL)
+            {
+              array = npy_array_from_mapping (capsule, data, entry->size, map_mode.writeable);
+              Py_DECREF (capsule);
+            }
+          if (array != NULL && copy)
+            {
+              PyArrayObject *copy = (PyArrayObject *) PyArray_NewCopy (array, NPY_KEEPORDER);
+              Py_DECREF (array);
+              array = copy;
+            }
+        }
+      else
+        {
+          // compressed members cannot be mapped, numpy inflates them
+          if (npz == NULL)
+            {
+              npz = PyObject_CallMethod (npModule, "load", "s", path);
+            }
+          if (npz != NULL)
+            {
+              PyObject *py_key = PyUnicode_FromString (key);
+              array = (PyArrayObject *) PyObject_GetItem (npz, py_key);
+              Py_XDECREF (py_key);
+            }
+        }
+
+      if (array != NULL)
+        {
+          jstring jkey = (*env)->NewStringUTF (env, key);
+          jobject jarray = new_ktndarray (env, array, NULL);
+          (*env)->SetObjectArrayElement (env, result, (jsize) (2 * i), jkey);
+          (*env)->SetObjectArrayElement (env, result, (jsize) (2 * i + 1), jarray);
+          (*env)->DeleteLocalRef (env, jkey);
+          (*env)->DeleteLocalRef (env, jarray);
+        }
+
+      free (key);
+      if (array == NULL)
+        {
+          result = NULL;
+          break;
+        }
+    }
+
+  OUT:
+  if (npz != NULL)
+    {
+      PyObject *closed = PyObject_CallMethod (npz, "close", NULL);
+      Py_XDECREF (closed);
+      Py_DECREF (npz);
+    }
+  if (zip != MAP_FAILED)
+    {
+      munmap (zip, (size_t) st.st_size);
+    }
+  if (fd >= 0)
+    {
+      close (fd);
+    }
+  free (entries);
+  python_exception (env);
+  release_utf_char (env, jpath, path);
+  release_utf_char (env, jmode, mode);
+
+  return result;
+#else
+  (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Memory-mapped arrays are not supported on this platform.");
+  return NULL;
+#endif
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    savez
+ * Signature: (Ljava/lang/String;[Ljava/lang/String;[Lorg/jetbrains/numkt/core/KtNDArray;Z)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_NpyIO_savez
+    (JNIEnv *env, jclass jcl, jstring jpath, jobjectArray names, jobjectArray arrays, jboolean compressed)
+{
+  PyObject *func = NULL;
+  PyObject *py_args = NULL;
+  PyObject *py_kwargs = NULL;
+  PyObject *py_res = NULL;
+  jsize length = (*env)->GetArrayLength (env, names);
+
+  func = PyObject_GetAttrString (npModule, compressed ? "savez_compressed" : "savez");
+  if (func == NULL)
+    {
+      goto OUT;
+    }
+
+  py_args = PyTuple_New (1);
+  PyTuple_SetItem (py_args, 0, jstring_AsPyString (env, jpath));
+
+  // arrays are saved under names given as keyword arguments
+  py_kwargs = PyDict_New ();
+  for (jsize i = 0; i < length; ++i)
+    {
+      jstring jname = (*env)->GetObjectArrayElement (env, names, i);
+      jobject jarray = (*env)->GetObjectArrayElement (env, arrays, i);
+      const char *name = jstring_to_char (env, jname);
+      PyObject *array = jobject_to_pyobject (env, jarray);
+
+      PyDict_SetItemString (py_kwargs, name, array);
+
+      Py_XDECREF (array);
+      release_utf_char (env, jname, name);
+      (*env)->DeleteLocalRef (env, jarray);
+    }
+
+  py_res = PyObject_Call (func, py_args, py_kwargs);
+
+  OUT:
+  python_exception (env);
+  Py_XDECREF (py_res);
+  Py_XDECREF (func);
+  Py_XDECREF (py_args);
+  Py_XDECREF (py_kwargs);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    shmCreate
+ * Signature: (Ljava/lang/String;[ILjava/lang/Class;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_NpyIO_shmCreate
+    (JNIEnv *env, jclass jcl, jstring jname, jintArray jshape, jclass dtype)
+{
+#ifdef KTNUMPY_POSIX
+  NPY_IMPORT_ONCE (NULL)
+
+  const char *name = jstring_to_char (env, jname);
+  jsize ndim = (*env)->GetArrayLength (env, jshape);
+  npy_intp shape[NPY_MAXDIMS];
+  char header[4096];
+  Py_ssize_t header_size = 0;
+  NpyMapMode map_mode;
+  PyObject *type = NULL;
+  PyObject *descr_str = NULL;
+  PyArray_Descr *descr = NULL;
+  PyObject *capsule = NULL;
+  PyArrayObject *array = NULL;
+  jobject result = NULL;
+  npy_intp nbytes = 0;
+  char *data = NULL;
+  int fd = -1;
+
+  type = jclass_to_dtype (env, dtype);
+  if (type == NULL)
+    {
+      goto OUT;
+    }
+  if (ndim > NPY_MAXDIMS)
+    {
+      PyErr_SetString (PyExc_ValueError, "Too many dimensions of shared array.");
+      goto OUT;
+    }
+  if (!PyArray_DescrConverter (type, &descr))
+    {
+      goto OUT;
+    }
+
+  nbytes = PyDataType_ELSIZE (descr);
+  {
+    const char *error = NULL;
+    jint *dims = (*env)->GetIntArrayElements (env, jshape, NULL);
+    for (jsize i = 0; i < ndim && error == NULL; ++i)
+      {
+        shape[i] = dims[i];
+        if (dims[i] < 0)
+          {
+            error = "Negative dimensions are not allowed.";
+          }
+        else if (__builtin_mul_overflow (nbytes, (npy_intp) dims[i], &nbytes))
+          {
+            error = "Shared array is too large.";
+          }
+      }
+    (*env)->ReleaseIntArrayElements (env, jshape, dims, JNI_ABORT);
+    if (error != NULL)
+      {
+        PyErr_SetString (PyExc_ValueError, error);
+        goto OUT;
+      }
+  }
+
+  // the segment holds .npy content, so that it can be attached knowing only the name
+  descr_str = PyObject_GetAttrString ((PyObject *) descr, "str");
+  if (descr_str == NULL)
+    {
+      goto OUT;
+    }
+  header_size = npy_write_header (header, sizeof (header), PyUnicode_AsUTF8 (descr_str), ndim, shape);
+  if (header_size < 0)
+    {
+      PyErr_SetString (PyExc_ValueError, "Header of shared array is too long.");
+      goto OUT;
+    }
+  if (nbytes > NPY_MAX_INTP - header_size)
+    {
+      PyErr_SetString (PyExc_ValueError, "Shared array is too large.");
+      goto OUT;
+    }
+
+  fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0)
+    {
+      PyErr_SetFromErrnoWithFilename (PyExc_OSError, name);
+      goto OUT;
+    }
+  // new pages are filled with zeros
+  if (ftruncate (fd, (off_t) (header_size + nbytes)) < 0)
+    {
+      PyErr_SetFromErrnoWithFilename (PyExc_OSError, name);
+      goto OUT;
+    }
+
+  npy_map_mode ("r+", &map_mode);
+  capsule = npy_mapping_new (fd, 0, (size_t) (header_size + nbytes), &map_mode, &data);
+  if (capsule == NULL)
+    {
+      goto OUT;
+    }
+  memcpy (data, header, (size_t) header_size);
+
+  array = npy_array_from_mapping (capsule, data, (size_t) (header_size + nbytes), map_mode.writeable);
+  if (array != NULL)
+    {
+      result = new_ktndarray (env, array, NULL);
+    }
+
+  OUT:
+  if (fd >= 0)
+    {
+      close (fd);
+      if (result == NULL)
+        {
+          shm_unlink (name);
+        }
+    }
+  Py_XDECREF (capsule);
+  Py_XDECREF (descr_str);
+  Py_XDECREF (descr);
+  python_exception (env);
+  release_utf_char (env, jname, name);
+
+  return result;
+#else
+  (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Shared memory arrays are not supported on this platform.");
+  return NULL;
+#endif
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    shmAttach
+ * Signature: (Ljava/lang/String;Ljava/lang/String;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_NpyIO_shmAttach
+    (JNIEnv *env, jclass jcl, jstring jname, jstring jmode)
+{
+#ifdef KTNUMPY_POSIX
+  NPY_IMPORT_ONCE (NULL)
+
+  const char *name = jstring_to_char (env, jname);
+  const char *mode = jstring_to_char (env, jmode);
+  NpyMapMode map_mode;
+  PyArrayObject *array = NULL;
+  jobject result = NULL;
+  int fd = -1;
+
+  if (npy_map_mode (mode, &map_mode) < 0)
+    {
+      goto OUT;
+    }
+
+  fd = shm_open (name, map_mode.open_flags, 0);
+  if (fd < 0)
+    {
+      PyErr_SetFromErrnoWithFilename (PyExc_OSError, name);
+      goto OUT;
+    }
+
+  array = npy_array_from_fd (fd, &map_mode);
+  if (array != NULL)
+    {
+      result = new_ktndarray (env, array, NULL);
+    }
+
+  OUT:
+  if (fd >= 0)
+    {
+      close (fd);
+    }
+  python_exception (env);
+  release_utf_char (env, jname, name);
+  release_utf_char (env, jmode, mode);
+
+  return result;
+#else
+  (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Shared memory arrays are not supported on this platform.");
+  return NULL;
+#endif
+}
+
+/*
+ * Class:     org_jetbrains_numkt_NpyIO
+ * Method:    shmUnlink
+ * Signature: (Ljava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_NpyIO_shmUnlink
+    (JNIEnv *env, jclass jcl, jstring jname)
+{
+#ifdef KTNUMPY_POSIX
+  const char *name = jstring_to_char (env, jname);
+
+  // attached arrays keep their mappings, only the name is removed
+  if (shm_unlink (name) < 0)
+    {
+      PyErr_SetFromErrnoWithFilename (PyExc_OSError, name);
+    }
+  python_exception (env);
+  release_utf_char (env, jname, name);
+#else
+  (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Shared memory arrays are not supported on this platform.");
+#endif
+}
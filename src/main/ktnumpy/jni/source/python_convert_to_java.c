@@ -314,6 +314,25 @@ static jobject pyfloat_as_jobject (JNIEnv *env, PyObject *py_object, jclass claz
   return result;
 }
 
+static jobject pycomplex_as_jobject (JNIEnv *env, PyObject *py_object, jclass clazz)
+{
+  jobject result = NULL;
+  Py_complex c = PyComplex_AsCComplex (py_object);
+  if (c.real == -1.0 && PyErr_Occurred ())
+    {
+      return NULL;
+    }
+  if ((*env)->IsAssignableFrom (env, COMPLEX_DOUBLE_TYPE, clazz))
+    {
+      result = numkt_core_ComplexDouble_new (env, c.real, c.imag);
+    }
+  else if ((*env)->IsAssignableFrom (env, COMPLEX_FLOAT_TYPE, clazz))
+    {
+      result = numkt_core_ComplexFloat_new (env, (jfloat) c.real, (jfloat) c.imag);
+    }
+  return result;
+}
+
 #define pyfastsequence_as_primitive_array(jtype, Type)                  \
     jtype *buf = malloc(size*sizeof(jtype));                            \
     jtype##Array jarray = (*env)->New##Type##Array(env, (jsize) size);  \
@@ -491,6 +510,10 @@ jobject pyobject_to_jobject (JNIEnv *env, PyObject *py_object, jclass jcl)
     {
       return pyfloat_as_jobject (env, py_object, jcl);
     }
+  else if (PyComplex_Check (py_object))
+    {
+      return pycomplex_as_jobject (env, py_object, jcl);
+    }
   else if (NpyArray_Check (py_object))
     {
       return new_ktndarray (env, (PyArrayObject *) py_object, NULL);
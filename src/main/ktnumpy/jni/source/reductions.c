@@ -0,0 +1,1186 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * An array is reduced as lines of its innermost dimension: long lines are split into blocks of
+ * REDUCE_BLOCK elements, short lines are grouped up to it, and the blocks are reduced on the thread pool
+ * without the GIL. Floating sums are pairwise within a block, as in numpy, and the partial results are
+ * combined pairwise in a fixed order, so the results do not depend on the number of threads.
+ * Reductions along an outer axis accumulate whole rows of the remaining dimensions instead,
+ * which keeps the inner loop contiguous.
+ */
+
+/* Elements reduced by one task, 128 KiB of doubles. */
+#define REDUCE_BLOCK (1 << 14)
+
+/* Unrolled block of the pairwise summation, as in numpy. */
+#define REDUCE_PAIRWISE 128
+
+/* Columns accumulated at once along an outer axis. */
+#define REDUCE_COLUMNS 1024
+
+/* Bounds of the splits of an outer axis and of the partial results they need. */
+#define REDUCE_MAX_SPLITS 64
+#define REDUCE_MAX_PARTIALS (1 << 20)
+
+/* Operations in the order of org.jetbrains.numkt.Reductions. */
+typedef enum
+{
+  REDUCE_SUM, REDUCE_MEAN, REDUCE_MAX, REDUCE_MIN, REDUCE_ARGMAX, REDUCE_ARGMIN, REDUCE_COUNT, REDUCE_VAR
+} ReduceOp;
+
+/* What a pass over the array computes for every output. */
+typedef enum
+{
+  /* sum in the type of the array: doubles for floating types, wrapping int64 for integers */
+  PASS_SUM,
+  /* sum as doubles */
+  PASS_FSUM,
+  /* sum of squared deviations from the centers */
+  PASS_SQDEV,
+  /* extremes, with the positions of their first occurrences for the ARG passes */
+  PASS_MAX,
+  PASS_MIN,
+  PASS_ARGMAX,
+  PASS_ARGMIN,
+  PASS_COUNT
+} ReducePass;
+
+#define REDUCE_MAXIMUM(pass) ((pass) == PASS_MAX || (pass) == PASS_ARGMAX)
+
+/* Results of a pass for every output or block: floating values, integer values and positions of extremes. */
+typedef struct
+{
+  double *d;
+  npy_int64 *i;
+  npy_int64 *index;
+} ReduceSlots;
+
+typedef void (*reduce_line_kernel) (ReducePass, const char *, npy_intp, npy_intp, double, double *, npy_int64 *,
+                                    npy_int64 *);
+typedef void (*reduce_rows_kernel) (ReducePass, const char *, npy_intp, npy_intp, npy_intp, npy_intp,
+                                    const double *, double *, npy_int64 *, npy_int64 *);
+
+typedef struct
+{
+  char kind;
+  int itemsize;
+  int floating;
+  /* reduces a strided line into one slot */
+  reduce_line_kernel line;
+  /* reduces rows of strided columns into one slot per column */
+  reduce_rows_kernel rows;
+} ReduceKernels;
+
+#define REDUCE_VALUE(x, c) (x)
+#define REDUCE_SQDEV(x, c) (((x) - (c)) * ((x) - (c)))
+
+#define REDUCE_LOAD(T, p, k, STRIDE) ((double) *(const T *) ((p) + (k) * (STRIDE)))
+
+/* Pairwise sum of VALUE over a line, with the stride given by STRIDE to let contiguous lines vectorize. */
+#define DEFINE_PAIRWISE(FN, T, VALUE, STRIDE)                                  \
+static double FN (const char *p, npy_intp n, npy_intp s, double c)             \
+{                                                                              \
+  double r[8];                                                                 \
+  double res;                                                                  \
+  npy_intp k;                                                                  \
+                                                                               \
+  if (n < 8)                                                                   \
+    {                                                                          \
+      res = 0;                                                                 \
+      for (k = 0; k < n; ++k)                                                  \
+        {                                                                      \
+          res += VALUE (REDUCE_LOAD (T, p, k, STRIDE), c);                     \
+        }                                                                      \
+      return res;                                                              \
+    }                                                                          \
+  if (n > REDUCE_PAIRWISE)                                                     \
+    {                                                                          \
+      npy_intp half = n / 2;                                                   \
+      half -= half % 8;                                                        \
+      return FN (p, half, s, c) + FN (p + half * (STRIDE), n - half, s, c);    \
+    }                                                                          \
+                                                                               \
+  for (int u = 0; u < 8; ++u)                                                  \
+    {                                                                          \
+      r[u] = VALUE (REDUCE_LOAD (T, p, u, STRIDE), c);                         \
+    }                                                                          \
+  for (k = 8; k < n - n % 8; k += 8)                                           \
+    {                                                                          \
+      for (int u = 0; u < 8; ++u)                                              \
+        {                                                                      \
+          r[u] += VALUE (REDUCE_LOAD (T, p, k + u, STRIDE), c);                \
+        }                                                                      \
+    }                                                                          \
+  res = ((r[0] + r[1]) + (r[2] + r[3])) + ((r[4] + r[5]) + (r[6] + r[7]));     \
+  for (; k < n; ++k)                                                           \
+    {                                                                          \
+      res += VALUE (REDUCE_LOAD (T, p, k, STRIDE), c);                         \
+    }                                                                          \
+  return res;                                                                  \
+}
+
+/* Extreme of a line in eight independent lanes; NaN values are only flagged. */
+#define DEFINE_EXTREME(FN, T, CMP, STRIDE)                                     \
+static T FN (const char *p, npy_intp n, npy_intp s, int *nan)                  \
+{                                                                              \
+  T m[8];                                                                      \
+  int bad = 0;                                                                 \
+  npy_intp k;                                                                  \
+                                                                               \
+  for (int u = 0; u < 8; ++u)                                                  \
+    {                                                                          \
+      m[u] = *(const T *) p;                                                   \
+    }                                                                          \
+  for (k = 0; k + 8 <= n; k += 8)                                              \
+    {                                                                          \
+      for (int u = 0; u < 8; ++u)                                              \
+        {                                                                      \
+          T x = *(const T *) (p + (k + u) * (STRIDE));                         \
+          bad |= x != x;                                                       \
+          m[u] = x CMP m[u] ? x : m[u];                                        \
+        }                                                                      \
+    }                                                                          \
+  for (; k < n; ++k)                                                           \
+    {                                                                          \
+      T x = *(const T *) (p + k * (STRIDE));                                   \
+      bad |= x != x;                                                           \
+      m[0] = x CMP m[0] ? x : m[0];                                            \
+    }                                                                          \
+  for (int u = 1; u < 8; ++u)                                                  \
+    {                                                                          \
+      m[0] = m[u] CMP m[0] ? m[u] : m[0];                                      \
+    }                                                                          \
+  *nan = bad;                                                                  \
+  return m[0];                                                                 \
+}
+
+/*
+ * Extreme of a contiguous floating line in SSE2 registers. The compiler does not vectorize
+ * the comparisons of DEFINE_EXTREME without -ffast-math, since they must keep NaN values.
+ */
+#define DEFINE_EXTREME_SSE2(FN, T, CMP, V, LANES, LOAD, EXTREME, UNORDERED, OR, MASK, STORE) \
+static T FN (const char *p, npy_intp n, npy_intp s, int *nan)                  \
+{                                                                              \
+  const T *x = (const T *) p;                                                  \
+  T best = x[0];                                                               \
+  T lanes[LANES];                                                              \
+  int bad = 0;                                                                 \
+  npy_intp k = 0;                                                              \
+                                                                               \
+  if (n >= 4 * LANES)                                                          \
+    {                                                                          \
+      V m0 = LOAD (x), m1 = LOAD (x + LANES), m2 = LOAD (x + 2 * LANES), m3 = LOAD (x + 3 * LANES); \
+      V u = UNORDERED (m0, m0);                                                \
+      for (; k + 4 * LANES <= n; k += 4 * LANES)                               \
+        {                                                                      \
+          V a = LOAD (x + k), b = LOAD (x + k + LANES);                        \
+          V c = LOAD (x + k + 2 * LANES), d = LOAD (x + k + 3 * LANES);        \
+          u = OR (u, OR (OR (UNORDERED (a, a), UNORDERED (b, b)), OR (UNORDERED (c, c), UNORDERED (d, d)))); \
+          m0 = EXTREME (a, m0);                                                \
+          m1 = EXTREME (b, m1);                                                \
+          m2 = EXTREME (c, m2);                                                \
+          m3 = EXTREME (d, m3);                                                \
+        }                                                                      \
+      STORE (lanes, EXTREME (EXTREME (m0, m1), EXTREME (m2, m3)));             \
+      bad = MASK (u) != 0;                                                     \
+      for (int l = 0; l < LANES; ++l)                                          \
+        {                                                                      \
+          best = lanes[l] CMP best ? lanes[l] : best;                          \
+        }                                                                      \
+    }                                                                          \
+  for (; k < n; ++k)                                                           \
+    {                                                                          \
+      bad |= x[k] != x[k];                                                     \
+      best = x[k] CMP best ? x[k] : best;                                      \
+    }                                                                          \
+  *nan = bad;                                                                  \
+  return best;                                                                 \
+}
+
+/* Position of the first value equal to x, or of the first NaN, in a contiguous floating line. */
+#define DEFINE_FIND_SSE2(FN, T, V, LANES, LOAD, SET, EQUAL, UNORDERED, OR, MASK) \
+static npy_intp FN (const char *p, npy_intp n, npy_intp s, T x, int nan)       \
+{                                                                              \
+  const T *y = (const T *) p;                                                  \
+  V v = SET (x);                                                               \
+  npy_intp k = 0;                                                              \
+                                                                               \
+  for (; k + 4 * LANES <= n; k += 4 * LANES)                                   \
+    {                                                                          \
+      V a = LOAD (y + k), b = LOAD (y + k + LANES);                            \
+      V c = LOAD (y + k + 2 * LANES), d = LOAD (y + k + 3 * LANES);            \
+      V hit = nan ? OR (OR (UNORDERED (a, a), UNORDERED (b, b)), OR (UNORDERED (c, c), UNORDERED (d, d))) \
+                  : OR (OR (EQUAL (a, v), EQUAL (b, v)), OR (EQUAL (c, v), EQUAL (d, v))); \
+      if (MASK (hit))                                                          \
+        {                                                                      \
+          break;                                                               \
+        }                                                                      \
+    }                                                                          \
+  for (; k < n; ++k)                                                           \
+    {                                                                          \
+      if (nan ? y[k] != y[k] : y[k] == x)                                      \
+        {                                                                      \
+          return k;                                                            \
+        }                                                                      \
+    }                                                                          \
+  return 0;                                                                    \
+}
+
+/* Position of the first value equal to x, or of the first NaN; eight at a time until a hit. */
+#define DEFINE_FIND(FN, T, STRIDE)                                             \
+static npy_intp FN (const char *p, npy_intp n, npy_intp s, T x, int nan)       \
+{                                                                              \
+  npy_intp k = 0;                                                              \
+                                                                               \
+  for (; k + 8 <= n; k += 8)                                                   \
+    {                                                                          \
+      int hit = 0;                                                             \
+      for (int u = 0; u < 8; ++u)                                              \
+        {                                                                      \
+          T y = *(const T *) (p + (k + u) * (STRIDE));                         \
+          hit |= nan ? y != y : y == x;                                        \
+        }                                                                      \
+      if (hit)                                                                 \
+        {                                                                      \
+          break;                                                               \
+        }                                                                      \
+    }                                                                          \
+  for (; k < n; ++k)                                                           \
+    {                                                                          \
+      T y = *(const T *) (p + k * (STRIDE));                                   \
+      if (nan ? y != y : y == x)                                               \
+        {                                                                      \
+          return k;                                                            \
+        }                                                                      \
+    }                                                                          \
+  return 0;                                                                    \
+}
+
+/* Accumulates rows of columns into d, i and index, which hold the first row. */
+#define DEFINE_ROWS(FN, T, FLOATING, STRIDE)                                   \
+static void FN (ReducePass pass, const char *p, npy_intp nk, npy_intp sk, npy_intp nj, npy_intp s, \
+                const double *c, double *d, npy_int64 *i, npy_int64 *index)    \
+{                                                                              \
+  for (npy_intp k = 1; k < nk; ++k)                                            \
+    {                                                                          \
+      const char *row = p + k * sk;                                            \
+      switch (pass)                                                            \
+        {                                                                      \
+          case PASS_SUM:                                                       \
+            if (FLOATING)                                                      \
+              {                                                                \
+                for (npy_intp j = 0; j < nj; ++j)                              \
+                  {                                                            \
+                    d[j] += REDUCE_LOAD (T, row, j, STRIDE);                   \
+                  }                                                            \
+                break;                                                         \
+              }                                                                \
+            for (npy_intp j = 0; j < nj; ++j)                                  \
+              {                                                                \
+                i[j] = (npy_int64) ((npy_uint64) i[j] + (npy_uint64) *(const T *) (row + j * (STRIDE))); \
+              }                                                                \
+            break;                                                             \
+          case PASS_FSUM:                                                      \
+            for (npy_intp j = 0; j < nj; ++j)                                  \
+              {                                                                \
+                d[j] += REDUCE_LOAD (T, row, j, STRIDE);                       \
+              }                                                                \
+            break;                                                             \
+          case PASS_SQDEV:                                                     \
+            for (npy_intp j = 0; j < nj; ++j)                                  \
+              {                                                                \
+                d[j] += REDUCE_SQDEV (REDUCE_LOAD (T, row, j, STRIDE), c[j]);  \
+              }                                                                \
+            break;                                                             \
+          case PASS_MAX:                                                       \
+          case PASS_ARGMAX:                                                    \
+            for (npy_intp j = 0; j < nj; ++j)                                  \
+              {                                                                \
+                T x = *(const T *) (row + j * (STRIDE));                       \
+                if (FLOATING ? (x > d[j] || (x != x && d[j] == d[j])) : x > i[j]) \
+                  {                                                            \
+                    d[j] = (double) x;                                         \
+                    i[j] = FLOATING ? 0 : (npy_int64) x;                       \
+                    index[j] = k;                                              \
+                  }                                                            \
+              }                                                                \
+            break;                                                             \
+          case PASS_MIN:                                                       \
+          case PASS_ARGMIN:                                                    \
+            for (npy_intp j = 0; j < nj; ++j)                                  \
+              {                                                                \
+                T x = *(const T *) (row + j * (STRIDE));                       \
+                if (FLOATING ? (x < d[j] || (x != x && d[j] == d[j])) : x < i[j]) \
+                  {                                                            \
+                    d[j] = (double) x;                                         \
+                    i[j] = FLOATING ? 0 : (npy_int64) x;                       \
+                    index[j] = k;                                              \
+                  }                                                            \
+              }                                                                \
+            break;                                                             \
+          case PASS_COUNT:                                                     \
+            for (npy_intp j = 0; j < nj; ++j)                                  \
+              {                                                                \
+                i[j] += *(const T *) (row + j * (STRIDE)) != 0;                \
+              }                                                                \
+            break;                                                             \
+        }                                                                      \
+    }                                                                          \
+}
+
+/* Kernels of contiguous lines, in SSE2 registers for the floating types when they are available. */
+#define REDUCE_MAX_SCALAR(FN, T) DEFINE_EXTREME (FN, T, >, (npy_intp) sizeof (T))
+#define REDUCE_MIN_SCALAR(FN, T) DEFINE_EXTREME (FN, T, <, (npy_intp) sizeof (T))
+#define REDUCE_FIND_SCALAR(FN, T) DEFINE_FIND (FN, T, (npy_intp) sizeof (T))
+
+#ifdef __SSE2__
+#define REDUCE_MAX_PD(FN, T)                                                   \
+  DEFINE_EXTREME_SSE2 (FN, T, >, __m128d, 2, _mm_loadu_pd, _mm_max_pd, _mm_cmpunord_pd, _mm_or_pd, \
+                       _mm_movemask_pd, _mm_storeu_pd)
+#define REDUCE_MIN_PD(FN, T)                                                   \
+  DEFINE_EXTREME_SSE2 (FN, T, <, __m128d, 2, _mm_loadu_pd, _mm_min_pd, _mm_cmpunord_pd, _mm_or_pd, \
+                       _mm_movemask_pd, _mm_storeu_pd)
+#define REDUCE_FIND_PD(FN, T)                                                  \
+  DEFINE_FIND_SSE2 (FN, T, __m128d, 2, _mm_loadu_pd, _mm_set1_pd, _mm_cmpeq_pd, _mm_cmpunord_pd, \
+                    _mm_or_pd, _mm_movemask_pd)
+#define REDUCE_MAX_PS(FN, T)                                                   \
+  DEFINE_EXTREME_SSE2 (FN, T, >, __m128, 4, _mm_loadu_ps, _mm_max_ps, _mm_cmpunord_ps, _mm_or_ps, \
+                       _mm_movemask_ps, _mm_storeu_ps)
+#define REDUCE_MIN_PS(FN, T)                                                   \
+  DEFINE_EXTREME_SSE2 (FN, T, <, __m128, 4, _mm_loadu_ps, _mm_min_ps, _mm_cmpunord_ps, _mm_or_ps, \
+                       _mm_movemask_ps, _mm_storeu_ps)
+#define REDUCE_FIND_PS(FN, T)                                                  \
+  DEFINE_FIND_SSE2 (FN, T, __m128, 4, _mm_loadu_ps, _mm_set1_ps, _mm_cmpeq_ps, _mm_cmpunord_ps, \
+                    _mm_or_ps, _mm_movemask_ps)
+#else
+#define REDUCE_MAX_PD REDUCE_MAX_SCALAR
+#define REDUCE_MIN_PD REDUCE_MIN_SCALAR
+#define REDUCE_FIND_PD REDUCE_FIND_SCALAR
+#define REDUCE_MAX_PS REDUCE_MAX_SCALAR
+#define REDUCE_MIN_PS REDUCE_MIN_SCALAR
+#define REDUCE_FIND_PS REDUCE_FIND_SCALAR
+#endif
+
+#define DEFINE_KERNELS(NAME, T, FLOATING, SIMD)                                \
+DEFINE_PAIRWISE (NAME##_sum, T, REDUCE_VALUE, s)                               \
+DEFINE_PAIRWISE (NAME##_sum_contiguous, T, REDUCE_VALUE, (npy_intp) sizeof (T)) \
+DEFINE_PAIRWISE (NAME##_sqdev, T, REDUCE_SQDEV, s)                             \
+DEFINE_PAIRWISE (NAME##_sqdev_contiguous, T, REDUCE_SQDEV, (npy_intp) sizeof (T)) \
+DEFINE_EXTREME (NAME##_max, T, >, s)                                           \
+DEFINE_EXTREME (NAME##_min, T, <, s)                                           \
+DEFINE_FIND (NAME##_find, T, s)                                                \
+REDUCE_MAX_##SIMD (NAME##_max_contiguous, T)                                   \
+REDUCE_MIN_##SIMD (NAME##_min_contiguous, T)                                   \
+REDUCE_FIND_##SIMD (NAME##_find_contiguous, T)                                 \
+DEFINE_ROWS (NAME##_rows_strided, T, FLOATING, s)                              \
+DEFINE_ROWS (NAME##_rows_contiguous, T, FLOATING, (npy_intp) sizeof (T))       \
+                                                                               \
+static void NAME##_line (ReducePass pass, const char *p, npy_intp n, npy_intp s, double c, \
+                         double *d, npy_int64 *i, npy_int64 *index)            \
+{                                                                              \
+  int contiguous = s == (npy_intp) sizeof (T);                                 \
+  T best;                                                                      \
+  npy_int64 at = 0;                                                            \
+  npy_uint64 sum = 0;                                                          \
+  npy_int64 count = 0;                                                         \
+  int nan = 0;                                                                 \
+                                                                               \
+  switch (pass)                                                                \
+    {                                                                          \
+      case PASS_SUM:                                                           \
+        /* floating sums fall through to FSUM */                               \
+        if (!FLOATING)                                                         \
+          {                                                                    \
+            for (npy_intp k = 0; k < n; ++k)                                   \
+              {                                                                \
+                sum += (npy_uint64) *(const T *) (p + k * s);                  \
+              }                                                                \
+            *i = (npy_int64) sum;                                              \
+            break;                                                             \
+          }                                                                    \
+      case PASS_FSUM:                                                          \
+        *d = contiguous ? NAME##_sum_contiguous (p, n, s, 0) : NAME##_sum (p, n, s, 0); \
+        break;                                                                 \
+      case PASS_SQDEV:                                                         \
+        *d = contiguous ? NAME##_sqdev_contiguous (p, n, s, c) : NAME##_sqdev (p, n, s, c); \
+        break;                                                                 \
+      case PASS_MAX:                                                           \
+      case PASS_MIN:                                                           \
+      case PASS_ARGMAX:                                                        \
+      case PASS_ARGMIN:                                                        \
+        if (REDUCE_MAXIMUM (pass))                                             \
+          {                                                                    \
+            best = contiguous ? NAME##_max_contiguous (p, n, s, &nan) : NAME##_max (p, n, s, &nan); \
+          }                                                                    \
+        else                                                                   \
+          {                                                                    \
+            best = contiguous ? NAME##_min_contiguous (p, n, s, &nan) : NAME##_min (p, n, s, &nan); \
+          }                                                                    \
+        /* a second pass finds the position, and the NaN for the plain extremes */ \
+        if (nan || pass == PASS_ARGMAX || pass == PASS_ARGMIN)                 \
+          {                                                                    \
+            at = contiguous ? NAME##_find_contiguous (p, n, s, best, nan) : NAME##_find (p, n, s, best, nan); \
+            best = *(const T *) (p + at * s);                                  \
+          }                                                                    \
+        *d = (double) best;                                                    \
+        *i = FLOATING ? 0 : (npy_int64) best;                                  \
+        *index = at;                                                           \
+        break;                                                                 \
+      case PASS_COUNT:                                                         \
+        for (npy_intp k = 0; k < n; ++k)                                       \
+          {                                                                    \
+            count += *(const T *) (p + k * s) != 0;                            \
+          }                                                                    \
+        *i = count;                                                            \
+        break;                                                                 \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static void NAME##_rows (ReducePass pass, const char *p, npy_intp nk, npy_intp sk, npy_intp nj, npy_intp s, \
+                         const double *c, double *d, npy_int64 *i, npy_int64 *index) \
+{                                                                              \
+  for (npy_intp j = 0; j < nj; ++j)                                            \
+    {                                                                          \
+      T x = *(const T *) (p + j * s);                                          \
+      d[j] = pass == PASS_SQDEV ? REDUCE_SQDEV ((double) x, c[j]) : (double) x; \
+      i[j] = pass == PASS_COUNT ? x != 0 : FLOATING ? 0 : (npy_int64) x;      \
+      index[j] = 0;                                                            \
+    }                                                                          \
+  if (s == (npy_intp) sizeof (T))                                              \
+    {                                                                          \
+      NAME##_rows_contiguous (pass, p, nk, sk, nj, s, c, d, i, index);         \
+    }                                                                          \
+  else                                                                         \
+    {                                                                          \
+      NAME##_rows_strided (pass, p, nk, sk, nj, s, c, d, i, index);            \
+    }                                                                          \
+}
+
+DEFINE_KERNELS (float64, npy_float64, 1, PD)
+DEFINE_KERNELS (float32, npy_float32, 1, PS)
+DEFINE_KERNELS (int64, npy_int64, 0, SCALAR)
+DEFINE_KERNELS (int32, npy_int32, 0, SCALAR)
+DEFINE_KERNELS (int16, npy_int16, 0, SCALAR)
+DEFINE_KERNELS (int8, npy_int8, 0, SCALAR)
+DEFINE_KERNELS (bool, npy_bool, 0, SCALAR)
+
+static const ReduceKernels reduce_kernels[] = {
+    {'f', 8, 1, float64_line, float64_rows},
+    {'f', 4, 1, float32_line, float32_rows},
+    {'i', 8, 0, int64_line, int64_rows},
+    {'i', 4, 0, int32_line, int32_rows},
+    {'i', 2, 0, int16_line, int16_rows},
+    {'i', 1, 0, int8_line, int8_rows},
+    {'b', 1, 0, bool_line, bool_rows},
+};
+
+/* Lines of a strided array, which are reduced to a slot each or combined by groups. */
+typedef struct
+{
+  const ReduceKernels *kernels;
+  ReducePass pass;
+  const char *data;
+  /* dimensions of the lines, C order */
+  int ndim;
+  npy_intp dims[NPY_MAXDIMS];
+  npy_intp strides[NPY_MAXDIMS];
+  npy_intp rows;
+  npy_intp length;
+  npy_intp stride;
+  /* centers of the lines for squared deviations */
+  const double *centers;
+  /* blocks of a long line, or lines of a group when they are short */
+  npy_intp splits;
+  npy_intp group;
+  npy_intp tasks;
+  /* combine the lines of a group into one slot, the positions are flat indices */
+  int combine;
+  ReduceSlots slots;
+} ReduceLines;
+
+/* Rows along an outer axis accumulated column by column. */
+typedef struct
+{
+  const ReduceKernels *kernels;
+  ReducePass pass;
+  const char *data;
+  /* dimensions before the columns, C order */
+  int ndim;
+  npy_intp dims[NPY_MAXDIMS];
+  npy_intp strides[NPY_MAXDIMS];
+  npy_intp prefix;
+  npy_intp length;
+  npy_intp stride;
+  npy_intp columns;
+  npy_intp column_stride;
+  npy_intp column_blocks;
+  /* parts of the axis reduced separately and then combined in order */
+  npy_intp splits;
+  npy_intp split_length;
+  const double *centers;
+  /* prefix * columns slots for every split, the first ones are the results */
+  ReduceSlots slots;
+} ReduceRows;
+
+static npy_intp reduce_abs (npy_intp x)
+{
+  return x < 0 ? -x : x;
+}
+
+static npy_intp reduce_offset (int ndim, const npy_intp *dims, const npy_intp *strides, npy_intp r)
+{
+  npy_intp offset = 0;
+
+  for (int d = ndim - 1; d >= 0; --d)
+    {
+      offset += (r % dims[d]) * strides[d];
+      r /= dims[d];
+    }
+  return offset;
+}
+
+/* Fold the slot b into the slot a, b follows a. */
+static void reduce_merge (ReducePass pass, int floating, ReduceSlots *slots, npy_intp a, npy_intp b)
+{
+  double *d = slots->d;
+  npy_int64 *i = slots->i;
+  int take;
+
+  switch (pass)
+    {
+      case PASS_SUM:
+        // floating sums fall through to FSUM
+        if (!floating)
+          {
+            i[a] = (npy_int64) ((npy_uint64) i[a] + (npy_uint64) i[b]);
+            break;
+          }
+      case PASS_FSUM:
+      case PASS_SQDEV:
+        d[a] += d[b];
+        break;
+      case PASS_COUNT:
+        i[a] += i[b];
+        break;
+      case PASS_MAX:
+      case PASS_MIN:
+      case PASS_ARGMAX:
+      case PASS_ARGMIN:
+        // the first NaN wins, otherwise the first extreme
+        if (floating)
+          {
+            take = d[a] == d[a] && (d[b] != d[b] || (REDUCE_MAXIMUM (pass) ? d[b] > d[a] : d[b] < d[a]));
+          }
+        else
+          {
+            take = REDUCE_MAXIMUM (pass) ? i[b] > i[a] : i[b] < i[a];
+          }
+        if (take)
+          {
+            d[a] = d[b];
+            i[a] = i[b];
+            slots->index[a] = slots->index[b];
+          }
+        break;
+    }
+}
+
+/* Combine n slots from first into the first one, pairwise. */
+static void reduce_combine (ReducePass pass, int floating, ReduceSlots *slots, npy_intp first, npy_intp n)
+{
+  npy_intp half = n / 2;
+
+  if (n < 2)
+    {
+      return;
+    }
+  reduce_combine (pass, floating, slots, first, half);
+  reduce_combine (pass, floating, slots, first + half, n - half);
+  reduce_merge (pass, floating, slots, first, first + half);
+}
+
+/* Combined lines share the center of the only output. */
+static double reduce_center (const ReduceLines *lines, npy_intp r)
+{
+  return lines->centers == NULL ? 0 : lines->centers[lines->combine ? 0 : r];
+}
+
+static void reduce_lines_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  ReduceLines *lines = (ReduceLines *) ctx;
+  ReduceSlots *s = &lines->slots;
+
+  for (Py_ssize_t t = begin; t < end; ++t)
+    {
+      if (lines->splits > 1)
+        {
+          npy_intp r = t / lines->splits;
+          npy_intp first = (t % lines->splits) * REDUCE_BLOCK;
+          npy_intp n = lines->length - first < REDUCE_BLOCK ? lines->length - first : REDUCE_BLOCK;
+          const char *p = lines->data + reduce_offset (lines->ndim, lines->dims, lines->strides, r)
+                          + first * lines->stride;
+          lines->kernels->line (lines->pass, p, n, lines->stride, reduce_center (lines, r),
+                                s->d + t, s->i + t, s->index + t);
+          s->index[t] += first + (lines->combine ? r * lines->length : 0);
+          continue;
+        }
+
+      npy_intp r0 = t * lines->group;
+      npy_intp r1 = r0 + lines->group < lines->rows ? r0 + lines->group : lines->rows;
+      for (npy_intp r = r0; r < r1; ++r)
+        {
+          // a combined group reduces its next lines into a scratch slot of its own
+          npy_intp slot = lines->combine ? (r == r0 ? t : lines->tasks + t) : r;
+          const char *p = lines->data + reduce_offset (lines->ndim, lines->dims, lines->strides, r);
+          lines->kernels->line (lines->pass, p, lines->length, lines->stride, reduce_center (lines, r),
+                                s->d + slot, s->i + slot, s->index + slot);
+          if (lines->combine)
+            {
+              s->index[slot] += r * lines->length;
+              if (r > r0)
+                {
+                  reduce_merge (lines->pass, lines->kernels->floating, s, t, slot);
+                }
+            }
+        }
+    }
+}
+
+static void reduce_rows_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  ReduceRows *rows = (ReduceRows *) ctx;
+  ReduceSlots *s = &rows->slots;
+
+  for (Py_ssize_t t = begin; t < end; ++t)
+    {
+      npy_intp split = t % rows->splits;
+      npy_intp block = (t / rows->splits) % rows->column_blocks;
+      npy_intp p = t / rows->splits / rows->column_blocks;
+      npy_intp j0 = block * REDUCE_COLUMNS;
+      npy_intp nj = rows->columns - j0 < REDUCE_COLUMNS ? rows->columns - j0 : REDUCE_COLUMNS;
+      npy_intp k0 = split * rows->split_length;
+      npy_intp nk = rows->length - k0 < rows->split_length ? rows->length - k0 : rows->split_length;
+      npy_intp slot = (split * rows->prefix + p) * rows->columns + j0;
+      const char *data = rows->data + reduce_offset (rows->ndim, rows->dims, rows->strides, p)
+                         + k0 * rows->stride + j0 * rows->column_stride;
+
+      rows->kernels->rows (rows->pass, data, nk, rows->stride, nj, rows->column_stride,
+                           rows->centers ? rows->centers + p * rows->columns + j0 : NULL,
+                           s->d + slot, s->i + slot, s->index + slot);
+      for (npy_intp j = 0; j < nj; ++j)
+        {
+          s->index[slot + j] += k0;
+        }
+    }
+}
+
+static void reduce_slots_free (ReduceSlots *slots)
+{
+  free (slots->d);
+  free (slots->i);
+  free (slots->index);
+}
+
+static int reduce_slots_alloc (ReduceSlots *slots, npy_intp n)
+{
+  slots->d = (double *) malloc (n * sizeof (double));
+  slots->i = (npy_int64 *) malloc (n * sizeof (npy_int64));
+  slots->index = (npy_int64 *) malloc (n * sizeof (npy_int64));
+  if (slots->d == NULL || slots->i == NULL || slots->index == NULL)
+    {
+      reduce_slots_free (slots);
+      PyErr_NoMemory ();
+      return -1;
+    }
+  return 0;
+}
+
+/* Shape of a reduction: the reduced axis and the dimensions of the outputs, C order. */
+typedef struct
+{
+  const ReduceKernels *kernels;
+  const char *data;
+  /* all elements when there is no axis */
+  npy_intp length;
+  npy_intp stride;
+  int ndim;
+  npy_intp dims[NPY_MAXDIMS];
+  npy_intp strides[NPY_MAXDIMS];
+  npy_intp outputs;
+  /* reduce the whole array into one output */
+  int all;
+} ReduceShape;
+
+/*
+ * Reduce every output of the shape into out, which has a slot per output.
+ * centers are required by squared deviations.
+ */
+static int reduce_pass (const ReduceShape *shape, ReducePass pass, const double *centers, ReduceSlots *out)
+{
+  int floating = shape->kernels->floating;
+  npy_intp last = shape->ndim > 0 ? shape->dims[shape->ndim - 1] : 1;
+  npy_intp last_stride = shape->ndim > 0 ? shape->strides[shape->ndim - 1] : 0;
+
+  if (!shape->all && last > 1 && reduce_abs (last_stride) < reduce_abs (shape->stride))
+    {
+      // accumulate rows of the innermost output dimension along the axis
+      ReduceRows rows;
+      npy_intp width = last < REDUCE_COLUMNS ? last : REDUCE_COLUMNS;
+      npy_intp min_split = REDUCE_BLOCK / width;
+      npy_intp splits = (shape->length + min_split - 1) / min_split;
+      npy_intp bound = REDUCE_MAX_PARTIALS / shape->outputs;
+
+      splits = splits < REDUCE_MAX_SPLITS ? splits : REDUCE_MAX_SPLITS;
+      splits = splits < bound ? splits : bound;
+      splits = splits > 1 ? splits : 1;
+
+      memset (&rows, 0, sizeof (ReduceRows));
+      rows.kernels = shape->kernels;
+      rows.pass = pass;
+      rows.data = shape->data;
+      rows.ndim = shape->ndim - 1;
+      memcpy (rows.dims, shape->dims, rows.ndim * sizeof (npy_intp));
+      memcpy (rows.strides, shape->strides, rows.ndim * sizeof (npy_intp));
+      rows.prefix = shape->outputs / last;
+      rows.length = shape->length;
+      rows.stride = shape->stride;
+      rows.columns = last;
+      rows.column_stride = last_stride;
+      rows.column_blocks = (last + REDUCE_COLUMNS - 1) / REDUCE_COLUMNS;
+      rows.split_length = (shape->length + splits - 1) / splits;
+      rows.splits = (shape->length + rows.split_length - 1) / rows.split_length;
+      rows.centers = centers;
+
+      if (rows.splits == 1)
+        {
+          rows.slots = *out;
+        }
+      else if (reduce_slots_alloc (&rows.slots, rows.splits * shape->outputs) < 0)
+        {
+          return -1;
+        }
+
+      Py_BEGIN_ALLOW_THREADS
+      thread_pool_parallel_for (rows.prefix * rows.column_blocks * rows.splits, 1, reduce_rows_task, &rows);
+      for (npy_intp split = 1; split < rows.splits; ++split)
+        {
+          for (npy_intp k = 0; k < shape->outputs; ++k)
+            {
+              reduce_merge (pass, floating, &rows.slots, k, split * shape->outputs + k);
+            }
+        }
+      KTNUMPY_END_ALLOW_THREADS
+
+      if (rows.splits > 1)
+        {
+          memcpy (out->d, rows.slots.d, shape->outputs * sizeof (double));
+          memcpy (out->i, rows.slots.i, shape->outputs * sizeof (npy_int64));
+          memcpy (out->index, rows.slots.index, shape->outputs * sizeof (npy_int64));
+          reduce_slots_free (&rows.slots);
+        }
+      return 0;
+    }
+
+  ReduceLines lines;
+  npy_intp tasks;
+  npy_intp n_slots;
+
+  memset (&lines, 0, sizeof (ReduceLines));
+  lines.kernels = shape->kernels;
+  lines.pass = pass;
+  lines.data = shape->data;
+  lines.centers = centers;
+  lines.combine = shape->all;
+  if (shape->all)
+    {
+      // the array is rows of its innermost dimension
+      lines.ndim = shape->ndim - 1;
+      lines.length = last;
+      lines.stride = last_stride;
+      lines.rows = 1;
+      for (int d = 0; d < lines.ndim; ++d)
+        {
+          lines.rows *= shape->dims[d];
+        }
+    }
+  else
+    {
+      lines.ndim = shape->ndim;
+      lines.length = shape->length;
+      lines.stride = shape->stride;
+      lines.rows = shape->outputs;
+    }
+  memcpy (lines.dims, shape->dims, lines.ndim * sizeof (npy_intp));
+  memcpy (lines.strides, shape->strides, lines.ndim * sizeof (npy_intp));
+
+  if (lines.length > REDUCE_BLOCK)
+    {
+      lines.splits = (lines.length + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+      tasks = lines.rows * lines.splits;
+      n_slots = tasks;
+    }
+  else
+    {
+      lines.splits = 1;
+      lines.group = REDUCE_BLOCK / lines.length;
+      tasks = (lines.rows + lines.group - 1) / lines.group;
+      n_slots = shape->all ? 2 * tasks : lines.rows;
+    }
+  lines.tasks = tasks;
+
+  if (lines.splits == 1 && !shape->all)
+    {
+      lines.slots = *out;
+    }
+  else if (reduce_slots_alloc (&lines.slots, n_slots) < 0)
+    {
+      return -1;
+    }
+
+  Py_BEGIN_ALLOW_THREADS
+  thread_pool_parallel_for (tasks, 1, reduce_lines_task, &lines);
+  if (shape->all)
+    {
+      reduce_combine (pass, floating, &lines.slots, 0, tasks);
+    }
+  else if (lines.splits > 1)
+    {
+      for (npy_intp r = 0; r < lines.rows; ++r)
+        {
+          reduce_combine (pass, floating, &lines.slots, r * lines.splits, lines.splits);
+          out->d[r] = lines.slots.d[r * lines.splits];
+          out->i[r] = lines.slots.i[r * lines.splits];
+          out->index[r] = lines.slots.index[r * lines.splits];
+        }
+    }
+  KTNUMPY_END_ALLOW_THREADS
+
+  if (shape->all)
+    {
+      out->d[0] = lines.slots.d[0];
+      out->i[0] = lines.slots.i[0];
+      out->index[0] = lines.slots.index[0];
+    }
+  if (lines.slots.d != out->d)
+    {
+      reduce_slots_free (&lines.slots);
+    }
+  return 0;
+}
+
+static const ReduceKernels *reduce_kernels_for (PyArrayObject *a, int op)
+{
+  PyArray_Descr *descr = PyArray_DESCR (a);
+
+  // subclasses such as masked arrays reduce differently, numpy keeps them
+  if (!PyArray_CheckExact (a) || op < REDUCE_SUM || op > REDUCE_VAR || PyArray_NDIM (a) == 0 || PyArray_SIZE (a) == 0
+      || !PyArray_ISNBO (descr->byteorder) || !PyArray_ISALIGNED (a))
+    {
+      return NULL;
+    }
+  for (size_t k = 0; k < sizeof (reduce_kernels) / sizeof (ReduceKernels); ++k)
+    {
+      const ReduceKernels *kernels = reduce_kernels + k;
+      if (kernels->kind == descr->kind && kernels->itemsize == PyArray_ITEMSIZE (a))
+        {
+          // booleans are only counted, numpy sums them as integers
+          return kernels->kind == 'b' && op != REDUCE_COUNT ? NULL : kernels;
+        }
+    }
+  return NULL;
+}
+
+/* All elements as rows of the innermost dimension, merged with the outer ones where they are contiguous. */
+static void reduce_shape_all (ReduceShape *shape, PyArrayObject *a, int keep_order)
+{
+  int n = 0;
+
+  shape->all = 1;
+  shape->outputs = 1;
+  for (int d = 0; d < PyArray_NDIM (a); ++d)
+    {
+      if (PyArray_DIM (a, d) != 1)
+        {
+          shape->dims[n] = PyArray_DIM (a, d);
+          shape->strides[n] = PyArray_STRIDE (a, d);
+          n++;
+        }
+    }
+  // the order is free unless positions are returned, the smallest strides go inside
+  for (int d = 1; !keep_order && d < n; ++d)
+    {
+      for (int e = d; e > 0 && reduce_abs (shape->strides[e]) > reduce_abs (shape->strides[e - 1]); --e)
+        {
+          npy_intp dim = shape->dims[e];
+          npy_intp stride = shape->strides[e];
+          shape->dims[e] = shape->dims[e - 1];
+          shape->strides[e] = shape->strides[e - 1];
+          shape->dims[e - 1] = dim;
+          shape->strides[e - 1] = stride;
+        }
+    }
+  shape->ndim = n > 0 ? 1 : 0;
+  for (int d = 1; d < n; ++d)
+    {
+      npy_intp *outer = shape->dims + shape->ndim - 1;
+      if (shape->strides[shape->ndim - 1] == shape->strides[d] * shape->dims[d])
+        {
+          *outer *= shape->dims[d];
+          shape->strides[shape->ndim - 1] = shape->strides[d];
+        }
+      else
+        {
+          shape->dims[shape->ndim] = shape->dims[d];
+          shape->strides[shape->ndim] = shape->strides[d];
+          shape->ndim++;
+        }
+    }
+}
+
+/* The reduced axis and the other dimensions, which are the shape of the outputs. */
+static void reduce_shape_axis (ReduceShape *shape, PyArrayObject *a, int axis)
+{
+  shape->all = 0;
+  shape->outputs = 1;
+  shape->length = PyArray_DIM (a, axis);
+  shape->stride = PyArray_STRIDE (a, axis);
+  shape->ndim = 0;
+  for (int d = 0; d < PyArray_NDIM (a); ++d)
+    {
+      if (d != axis)
+        {
+          shape->dims[shape->ndim] = PyArray_DIM (a, d);
+          shape->strides[shape->ndim] = PyArray_STRIDE (a, d);
+          shape->outputs *= PyArray_DIM (a, d);
+          shape->ndim++;
+        }
+    }
+}
+
+static void reduce_store (PyArrayObject *out, npy_intp k, double d, npy_int64 i)
+{
+  char *p = PyArray_BYTES (out) + k * PyArray_ITEMSIZE (out);
+
+  if (PyArray_ISFLOAT (out))
+    {
+      if (PyArray_ITEMSIZE (out) == 8)
+        {
+          *(npy_float64 *) p = d;
+        }
+      else
+        {
+          *(npy_float32 *) p = (npy_float32) d;
+        }
+      return;
+    }
+  switch (PyArray_ITEMSIZE (out))
+    {
+      case 8:
+        *(npy_int64 *) p = i;
+        break;
+      case 4:
+        *(npy_int32 *) p = (npy_int32) i;
+        break;
+      case 2:
+        *(npy_int16 *) p = (npy_int16) i;
+        break;
+      default:
+        *(npy_int8 *) p = (npy_int8) i;
+        break;
+    }
+}
+
+/* Reduce over the axis, or over all elements when it is negative. */
+static PyArrayObject *reduce (PyArrayObject *a, const ReduceKernels *kernels, ReduceOp op, int axis, int ddof)
+{
+  ReduceShape shape;
+  ReduceSlots slots;
+  ReducePass pass;
+  PyArrayObject *out = NULL;
+  double *centers = NULL;
+  npy_intp count;
+  int type;
+  int status;
+
+  if (axis < 0)
+    {
+      reduce_shape_all (&shape, a, op == REDUCE_ARGMAX || op == REDUCE_ARGMIN);
+    }
+  else
+    {
+      reduce_shape_axis (&shape, a, axis);
+    }
+  shape.kernels = kernels;
+  shape.data = PyArray_BYTES (a);
+  count = shape.all ? PyArray_SIZE (a) : shape.length;
+
+  switch (op)
+    {
+      case REDUCE_SUM:
+        pass = PASS_SUM;
+        type = PyArray_TYPE (a);
+        break;
+      case REDUCE_MAX:
+      case REDUCE_ARGMAX:
+        pass = op == REDUCE_MAX ? PASS_MAX : PASS_ARGMAX;
+        type = op == REDUCE_MAX ? PyArray_TYPE (a) : NPY_INT64;
+        break;
+      case REDUCE_MIN:
+      case REDUCE_ARGMIN:
+        pass = op == REDUCE_MIN ? PASS_MIN : PASS_ARGMIN;
+        type = op == REDUCE_MIN ? PyArray_TYPE (a) : NPY_INT64;
+        break;
+      case REDUCE_COUNT:
+        pass = PASS_COUNT;
+        type = NPY_INT64;
+        break;
+      default:
+        // numpy keeps float32 in the mean and the variance, integers give float64
+        pass = PASS_FSUM;
+        type = PyArray_ISFLOAT (a) ? PyArray_TYPE (a) : NPY_FLOAT64;
+        break;
+    }
+
+  if (shape.outputs == 0)
+    {
+      return (PyArrayObject *) PyArray_SimpleNew (shape.ndim, shape.dims, type);
+    }
+  if (reduce_slots_alloc (&slots, shape.outputs) < 0)
+    {
+      return NULL;
+    }
+
+  status = reduce_pass (&shape, pass, NULL, &slots);
+  if (status == 0 && op == REDUCE_VAR)
+    {
+      // the second pass sums squared deviations from the means, as numpy does
+      centers = (double *) malloc (shape.outputs * sizeof (double));
+      if (centers == NULL)
+        {
+          PyErr_NoMemory ();
+          status = -1;
+        }
+      for (npy_intp k = 0; centers != NULL && k < shape.outputs; ++k)
+        {
+          centers[k] = slots.d[k] / count;
+        }
+      if (centers != NULL)
+        {
+          status = reduce_pass (&shape, PASS_SQDEV, centers, &slots);
+        }
+    }
+  if (status == 0)
+    {
+      out = (PyArrayObject *) PyArray_SimpleNew (shape.all ? 0 : shape.ndim, shape.dims, type);
+    }
+  for (npy_intp k = 0; out != NULL && k < shape.outputs; ++k)
+    {
+      switch (op)
+        {
+          case REDUCE_SUM:
+          case REDUCE_MAX:
+          case REDUCE_MIN:
+          case REDUCE_COUNT:
+            reduce_store (out, k, slots.d[k], slots.i[k]);
+            break;
+          case REDUCE_ARGMAX:
+          case REDUCE_ARGMIN:
+            reduce_store (out, k, 0, slots.index[k]);
+            break;
+          case REDUCE_MEAN:
+            reduce_store (out, k, slots.d[k] / count, 0);
+            break;
+          case REDUCE_VAR:
+            reduce_store (out, k, slots.d[k] / (count > ddof ? count - ddof : 0), 0);
+            break;
+        }
+    }
+
+  free (centers);
+  reduce_slots_free (&slots);
+  return out;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Reductions
+ * Method:    reduceAll
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;IILjava/lang/Class;)Ljava/lang/Object;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Reductions_reduceAll
+    (JNIEnv *env, jclass jcl, jobject ja, jint op, jint ddof, jclass clazz)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  PyArrayObject *a = numkt_core_KtNDArray_getPointer (env, ja);
+  const ReduceKernels *kernels = reduce_kernels_for (a, op);
+  PyArrayObject *out = NULL;
+  PyObject *scalar;
+  jobject result = NULL;
+
+  // null for the arrays which numpy reduces itself
+  if (kernels != NULL)
+    {
+      out = reduce (a, kernels, op, -1, ddof);
+    }
+  if (out != NULL)
+    {
+      scalar = PyArray_Return (out);
+      result = pyobject_to_jobject (env, scalar, clazz);
+      Py_XDECREF (scalar);
+    }
+  python_exception (env);
+
+  return result;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Reductions
+ * Method:    reduceAxis
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;III)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Reductions_reduceAxis
+    (JNIEnv *env, jclass jcl, jobject ja, jint op, jint axis, jint ddof)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  PyArrayObject *a = numkt_core_KtNDArray_getPointer (env, ja);
+  const ReduceKernels *kernels = reduce_kernels_for (a, op);
+  PyArrayObject *out = NULL;
+  jobject result = NULL;
+
+  if (axis < 0)
+    {
+      axis += PyArray_NDIM (a);
+    }
+  if (kernels != NULL && axis >= 0 && axis < PyArray_NDIM (a))
+    {
+      out = reduce (a, kernels, op, axis, ddof);
+    }
+  if (out != NULL)
+    {
+      result = new_ktndarray (env, out, NULL);
+    }
+  python_exception (env);
+
+  return result;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/*
+ * Support of the small-array tier, whose kernels run on the JVM over the direct buffers of the arrays:
+ * the layout of an array, read once by the JVM, and the allocation of the results without numpy's dispatch.
+ */
+
+static SmallKind small_kind (PyArrayObject *ndarray)
+{
+  PyArray_Descr *descr = PyArray_DESCR (ndarray);
+
+  // subclasses such as masked arrays keep state besides the data, numpy computes on them
+  if (!PyArray_CheckExact (ndarray) || !PyArray_IS_C_CONTIGUOUS (ndarray) || !PyArray_ISALIGNED (ndarray)
+      || !PyArray_ISNBO (descr->byteorder) || PyArray_SIZE (ndarray) > INT32_MAX)
+    {
+      return SMALL_NONE;
+    }
+
+  switch (descr->kind)
+    {
+      case 'f':
+        return PyArray_ITEMSIZE (ndarray) == 8 ? SMALL_DOUBLE : PyArray_ITEMSIZE (ndarray) == 4 ? SMALL_FLOAT : SMALL_NONE;
+      case 'i':
+        return PyArray_ITEMSIZE (ndarray) == 8 ? SMALL_LONG : PyArray_ITEMSIZE (ndarray) == 4 ? SMALL_INT : SMALL_NONE;
+      default:
+        return SMALL_NONE;
+    }
+}
+
+/*
+ * Returns the kind of the elements followed by the shape, the kind is SMALL_NONE
+ * when the elements can not be read in order from the buffer of the array.
+ */
+jintArray get_layout (JNIEnv *env, PyArrayObject *ndarray)
+{
+  int ndim = PyArray_NDIM (ndarray);
+  npy_intp *shape = PyArray_SHAPE (ndarray);
+  jint buf[NPY_MAXDIMS + 1];
+  jintArray jArray = (*env)->NewIntArray (env, ndim + 1);
+
+  if (jArray == NULL)
+    {
+      return NULL;
+    }
+
+  buf[0] = small_kind (ndarray);
+  for (int i = 0; i < ndim; ++i)
+    {
+      buf[i + 1] = (jint) shape[i];
+    }
+
+  (*env)->SetIntArrayRegion (env, jArray, 0, ndim + 1, buf);
+  return jArray;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_SmallArrays
+ * Method:    newLike
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_SmallArrays_newLike
+    (JNIEnv *env, jclass jcl, jobject jarray)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  PyArrayObject *prototype = numkt_core_KtNDArray_getPointer (env, jarray);
+  PyArrayObject *result;
+
+  // small blocks of data are taken from numpy's cache of freed allocations
+  result = (PyArrayObject *) PyArray_NewLikeArray (prototype, NPY_CORDER, NULL, 0);
+  if (result == NULL)
+    {
+      python_exception (env);
+      return NULL;
+    }
+
+  return new_ktndarray (env, result, NULL);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_SmallArrays
+ * Method:    newShaped
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;[I)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_SmallArrays_newShaped
+    (JNIEnv *env, jclass jcl, jobject jarray, jintArray jshape)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  PyArrayObject *prototype = numkt_core_KtNDArray_getPointer (env, jarray);
+  PyArrayObject *result;
+  jsize ndim = (*env)->GetArrayLength (env, jshape);
+  jint shape[NPY_MAXDIMS];
+  npy_intp dims[NPY_MAXDIMS];
+
+  if (ndim > NPY_MAXDIMS)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Too many dimensions.");
+      return NULL;
+    }
+  (*env)->GetIntArrayRegion (env, jshape, 0, ndim, shape);
+  for (jsize i = 0; i < ndim; ++i)
+    {
+      dims[i] = shape[i];
+    }
+
+  // the type of the prototype with another shape
+  Py_INCREF (PyArray_DESCR (prototype));
+  result = (PyArrayObject *) PyArray_NewFromDescr (&PyArray_Type, PyArray_DESCR (prototype), ndim, dims, NULL, NULL,
+                                                   0, NULL);
+  if (result == NULL)
+    {
+      python_exception (env);
+      return NULL;
+    }
+
+  return new_ktndarray (env, result, NULL);
+}
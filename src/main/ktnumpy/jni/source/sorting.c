@@ -0,0 +1,841 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+/*
+ * Arrays are sorted along the last axis of a view with the sorted axis moved last. When there are
+ * enough rows, every row is sorted by one thread. A long row is cut into chunks which are sorted in
+ * parallel and then merged in rounds, and every merge is split evenly between the threads by a binary
+ * search of the split points. Values are sorted by the sort of numpy for the type, which is
+ * vectorized where the processor allows, and only merged here. Indices are sorted by an introsort of
+ * pairs of a value and its position ordered by value and then by position, so argSort is stable and
+ * topK does not depend on the number of threads. NaN values go last, as in numpy.
+ */
+
+/* Ranges up to this length are insertion sorted. */
+#define SORT_SMALL 16
+
+/* Elements of a chunk sorted or of a piece merged by one task. */
+#define SORT_GRAIN (1 << 16)
+
+typedef enum
+{
+  SORT_VALUES, SORT_INDICES, SORT_SMALLEST, SORT_LARGEST
+} SortMode;
+
+#define SORT_LESS_FLOAT(a, b) ((a) < (b) || ((b) != (b) && (a) == (a)))
+#define SORT_LESS_INT(a, b) ((a) < (b))
+
+/* Introsort of n elements in the order of BEFORE; a heap has the element that goes last at its root. */
+#define DEFINE_INTROSORT(FN, E, BEFORE)                                        \
+static void FN##_swap (E *a, E *b)                                             \
+{                                                                              \
+  E t = *a;                                                                    \
+  *a = *b;                                                                     \
+  *b = t;                                                                      \
+}                                                                              \
+                                                                               \
+static void FN##_heapify (E *v, npy_intp i, npy_intp n)                        \
+{                                                                              \
+  E x = v[i];                                                                  \
+                                                                               \
+  for (npy_intp c = 2 * i + 1; c < n; c = 2 * i + 1)                           \
+    {                                                                          \
+      if (c + 1 < n && BEFORE (&v[c], &v[c + 1]))                              \
+        {                                                                      \
+          ++c;                                                                 \
+        }                                                                      \
+      if (!BEFORE (&x, &v[c]))                                                 \
+        {                                                                      \
+          break;                                                               \
+        }                                                                      \
+      v[i] = v[c];                                                             \
+      i = c;                                                                   \
+    }                                                                          \
+  v[i] = x;                                                                    \
+}                                                                              \
+                                                                               \
+static void FN##_heapsort (E *v, npy_intp n)                                   \
+{                                                                              \
+  for (npy_intp i = n / 2; i-- > 0;)                                           \
+    {                                                                          \
+      FN##_heapify (v, i, n);                                                  \
+    }                                                                          \
+  for (npy_intp m = n - 1; m > 0; --m)                                         \
+    {                                                                          \
+      FN##_swap (v, v + m);                                                    \
+      FN##_heapify (v, 0, m);                                                  \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static void FN##_quick (E *l, E *r, int depth)                                 \
+{                                                                              \
+  while (r - l > SORT_SMALL)                                                   \
+    {                                                                          \
+      E *m = l + ((r - l) >> 1), *i = l, *j = r - 1;                           \
+      E pivot;                                                                 \
+                                                                               \
+      if (depth-- <= 0)                                                        \
+        {                                                                      \
+          FN##_heapsort (l, r - l + 1);                                        \
+          return;                                                              \
+        }                                                                      \
+      /* median of three, the ends are sentinels of the partition */           \
+      if (BEFORE (m, l))                                                       \
+        {                                                                      \
+          FN##_swap (m, l);                                                    \
+        }                                                                      \
+      if (BEFORE (r, m))                                                       \
+        {                                                                      \
+          FN##_swap (r, m);                                                    \
+        }                                                                      \
+      if (BEFORE (m, l))                                                       \
+        {                                                                      \
+          FN##_swap (m, l);                                                    \
+        }                                                                      \
+      pivot = *m;                                                              \
+      FN##_swap (m, j);                                                        \
+      for (;;)                                                                 \
+        {                                                                      \
+          do                                                                   \
+            {                                                                  \
+              ++i;                                                             \
+            }                                                                  \
+          while (BEFORE (i, &pivot));                                          \
+          do                                                                   \
+            {                                                                  \
+              --j;                                                             \
+            }                                                                  \
+          while (BEFORE (&pivot, j));                                          \
+          if (i >= j)                                                          \
+            {                                                                  \
+              break;                                                           \
+            }                                                                  \
+          FN##_swap (i, j);                                                    \
+        }                                                                      \
+      FN##_swap (i, r - 1);                                                    \
+      /* recursion on the shorter part keeps the stack logarithmic */          \
+      if (i - l < r - i)                                                       \
+        {                                                                      \
+          FN##_quick (l, i - 1, depth);                                        \
+          l = i + 1;                                                           \
+        }                                                                      \
+      else                                                                     \
+        {                                                                      \
+          FN##_quick (i + 1, r, depth);                                        \
+          r = i - 1;                                                           \
+        }                                                                      \
+    }                                                                          \
+  for (E *i = l + 1; i <= r; ++i)                                              \
+    {                                                                          \
+      E x = *i;                                                                \
+      E *j = i;                                                                \
+      for (; j > l && BEFORE (&x, j - 1); --j)                                 \
+        {                                                                      \
+          *j = j[-1];                                                          \
+        }                                                                      \
+      *j = x;                                                                  \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static int FN (void *v, npy_intp n, void *NPY_UNUSED (arr))                    \
+{                                                                              \
+  int depth = 0;                                                               \
+                                                                               \
+  for (npy_intp m = n; m > 1; m >>= 1)                                         \
+    {                                                                          \
+      depth += 2;                                                              \
+    }                                                                          \
+  if (n > 1)                                                                   \
+    {                                                                          \
+      FN##_quick ((E *) v, (E *) v + n - 1, depth);                            \
+    }                                                                          \
+  return 0;                                                                    \
+}
+
+/*
+ * Merge of sorted a and b, the elements of a go first among equal ones, and the number of elements
+ * of a among the first k of the merge.
+ */
+#define DEFINE_MERGE(FN, CORANK, E, BEFORE)                                    \
+static void FN (const void *va, npy_intp na, const void *vb, npy_intp nb, void *vout) \
+{                                                                              \
+  const E *a = (const E *) va, *b = (const E *) vb;                            \
+  E *out = (E *) vout;                                                         \
+  npy_intp i = 0, j = 0;                                                       \
+                                                                               \
+  while (i < na && j < nb)                                                     \
+    {                                                                          \
+      *out++ = BEFORE (&b[j], &a[i]) ? b[j++] : a[i++];                        \
+    }                                                                          \
+  memcpy (out, a + i, (na - i) * sizeof (E));                                  \
+  memcpy (out + (na - i), b + j, (nb - j) * sizeof (E));                       \
+}                                                                              \
+                                                                               \
+static npy_intp CORANK (npy_intp k, const void *va, npy_intp na, const void *vb, npy_intp nb) \
+{                                                                              \
+  const E *a = (const E *) va, *b = (const E *) vb;                            \
+  npy_intp lo = k > nb ? k - nb : 0, hi = k < na ? k : na;                     \
+                                                                               \
+  while (lo < hi)                                                              \
+    {                                                                          \
+      npy_intp mid = lo + (hi - lo) / 2;                                       \
+      if (!BEFORE (&b[k - mid - 1], &a[mid]))                                  \
+        {                                                                      \
+          lo = mid + 1;                                                        \
+        }                                                                      \
+      else                                                                     \
+        {                                                                      \
+          hi = mid;                                                            \
+        }                                                                      \
+    }                                                                          \
+  return lo;                                                                   \
+}
+
+/* The first k elements of a strided line in the order of BEFORE, sorted, with positions from first. */
+#define DEFINE_SELECT(FN, T, E, BEFORE, SORT)                                  \
+static npy_intp FN (const char *p, npy_intp n, npy_intp s, npy_int64 first, npy_intp k, void *vout) \
+{                                                                              \
+  E *heap = (E *) vout;                                                        \
+  npy_intp m = k < n ? k : n;                                                  \
+                                                                               \
+  for (npy_intp i = 0; i < m; ++i)                                             \
+    {                                                                          \
+      heap[i].value = *(const T *) (p + i * s);                                \
+      heap[i].index = first + i;                                               \
+    }                                                                          \
+  for (npy_intp i = m / 2; i-- > 0;)                                           \
+    {                                                                          \
+      SORT##_heapify (heap, i, m);                                             \
+    }                                                                          \
+  for (npy_intp i = m; i < n && m > 0; ++i)                                    \
+    {                                                                          \
+      E x;                                                                     \
+      x.value = *(const T *) (p + i * s);                                      \
+      x.index = first + i;                                                     \
+      if (BEFORE (&x, heap))                                                   \
+        {                                                                      \
+          heap[0] = x;                                                         \
+          SORT##_heapify (heap, 0, m);                                         \
+        }                                                                      \
+    }                                                                          \
+  SORT##_heapsort (heap, m);                                                   \
+  return m;                                                                    \
+}
+
+#define DEFINE_SORT_KERNELS(NAME, T, LESS)                                     \
+typedef struct                                                                 \
+{                                                                              \
+  T value;                                                                     \
+  npy_int64 index;                                                             \
+} NAME##_pair;                                                                 \
+                                                                               \
+static int NAME##_less (const T *a, const T *b)                                \
+{                                                                              \
+  return LESS (*a, *b);                                                        \
+}                                                                              \
+                                                                               \
+static int NAME##_pair_less (const NAME##_pair *a, const NAME##_pair *b)       \
+{                                                                              \
+  return LESS (a->value, b->value) || (!LESS (b->value, a->value) && a->index < b->index); \
+}                                                                              \
+                                                                               \
+static int NAME##_pair_greater (const NAME##_pair *a, const NAME##_pair *b)    \
+{                                                                              \
+  return LESS (b->value, a->value) || (!LESS (a->value, b->value) && a->index < b->index); \
+}                                                                              \
+                                                                               \
+DEFINE_MERGE (NAME##_merge, NAME##_corank, T, NAME##_less)                     \
+DEFINE_INTROSORT (NAME##_pair_sort, NAME##_pair, NAME##_pair_less)             \
+DEFINE_MERGE (NAME##_pair_merge, NAME##_pair_corank, NAME##_pair, NAME##_pair_less) \
+DEFINE_INTROSORT (NAME##_pair_sort_greater, NAME##_pair, NAME##_pair_greater)  \
+DEFINE_SELECT (NAME##_smallest, T, NAME##_pair, NAME##_pair_less, NAME##_pair_sort) \
+DEFINE_SELECT (NAME##_largest, T, NAME##_pair, NAME##_pair_greater, NAME##_pair_sort_greater) \
+                                                                               \
+static void NAME##_fill (const char *p, npy_intp n, npy_intp s, npy_int64 first, void *vpairs) \
+{                                                                              \
+  NAME##_pair *pairs = (NAME##_pair *) vpairs;                                 \
+                                                                               \
+  for (npy_intp i = 0; i < n; ++i)                                             \
+    {                                                                          \
+      pairs[i].value = *(const T *) (p + i * s);                               \
+      pairs[i].index = first + i;                                              \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static void NAME##_split (const void *vpairs, npy_intp n, void *values, npy_int64 *indices) \
+{                                                                              \
+  const NAME##_pair *pairs = (const NAME##_pair *) vpairs;                     \
+                                                                               \
+  for (npy_intp i = 0; i < n; ++i)                                             \
+    {                                                                          \
+      if (values != NULL)                                                      \
+        {                                                                      \
+          ((T *) values)[i] = pairs[i].value;                                  \
+        }                                                                      \
+      indices[i] = pairs[i].index;                                             \
+    }                                                                          \
+}
+
+DEFINE_SORT_KERNELS (float64, npy_float64, SORT_LESS_FLOAT)
+DEFINE_SORT_KERNELS (float32, npy_float32, SORT_LESS_FLOAT)
+DEFINE_SORT_KERNELS (int64, npy_int64, SORT_LESS_INT)
+DEFINE_SORT_KERNELS (int32, npy_int32, SORT_LESS_INT)
+DEFINE_SORT_KERNELS (int16, npy_int16, SORT_LESS_INT)
+DEFINE_SORT_KERNELS (int8, npy_int8, SORT_LESS_INT)
+DEFINE_SORT_KERNELS (bool, npy_bool, SORT_LESS_INT)
+
+typedef int (*sort_kernel) (void *, npy_intp, void *);
+typedef void (*merge_kernel) (const void *, npy_intp, const void *, npy_intp, void *);
+typedef npy_intp (*corank_kernel) (npy_intp, const void *, npy_intp, const void *, npy_intp);
+typedef npy_intp (*select_kernel) (const char *, npy_intp, npy_intp, npy_int64, npy_intp, void *);
+typedef void (*fill_kernel) (const char *, npy_intp, npy_intp, npy_int64, void *);
+typedef void (*split_kernel) (const void *, npy_intp, void *, npy_int64 *);
+
+typedef struct
+{
+  char kind;
+  int itemsize;
+  size_t pair_size;
+  /* values, sorted by numpy */
+  merge_kernel merge;
+  corank_kernel corank;
+  /* pairs of a value and its position */
+  sort_kernel pair_sort;
+  sort_kernel pair_sort_greater;
+  merge_kernel pair_merge;
+  corank_kernel pair_corank;
+  select_kernel smallest;
+  select_kernel largest;
+  fill_kernel fill;
+  split_kernel split;
+} SortKernels;
+
+#define SORT_KERNELS(KIND, NAME, T)                                            \
+    {KIND, sizeof (T), sizeof (NAME##_pair), NAME##_merge, NAME##_corank,      \
+     NAME##_pair_sort, NAME##_pair_sort_greater, NAME##_pair_merge, NAME##_pair_corank, \
+     NAME##_smallest, NAME##_largest, NAME##_fill, NAME##_split}
+
+static const SortKernels sort_kernels[] = {
+    SORT_KERNELS ('f', float64, npy_float64),
+    SORT_KERNELS ('f', float32, npy_float32),
+    SORT_KERNELS ('i', int64, npy_int64),
+    SORT_KERNELS ('i', int32, npy_int32),
+    SORT_KERNELS ('i', int16, npy_int16),
+    SORT_KERNELS ('i', int8, npy_int8),
+    SORT_KERNELS ('b', bool, npy_bool),
+};
+
+/* Chunks of a long row sorted in parallel and merged in rounds between two buffers. */
+typedef struct
+{
+  sort_kernel sort;
+  void *arr;
+  merge_kernel merge;
+  corank_kernel corank;
+  size_t size;
+  npy_intp n;
+  /* sorted runs of this length in src are merged by pairs into dst */
+  npy_intp run;
+  npy_intp pieces;
+  char *src;
+  char *dst;
+} SortMerge;
+
+static void sort_chunks_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  SortMerge *m = (SortMerge *) ctx;
+
+  for (Py_ssize_t c = begin; c < end; ++c)
+    {
+      npy_intp first = c * m->run;
+      m->sort (m->src + first * m->size, m->n - first < m->run ? m->n - first : m->run, m->arr);
+    }
+}
+
+static void sort_merge_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  SortMerge *m = (SortMerge *) ctx;
+
+  for (Py_ssize_t t = begin; t < end; ++t)
+    {
+      npy_intp lo = (t / m->pieces) * 2 * m->run;
+      npy_intp mid = lo + m->run < m->n ? lo + m->run : m->n;
+      npy_intp hi = mid + m->run < m->n ? mid + m->run : m->n;
+      npy_intp na = mid - lo, nb = hi - mid, piece = t % m->pieces;
+      const char *a = m->src + lo * m->size, *b = m->src + mid * m->size;
+
+      // the piece of the merge from k0 to k1 takes i0..i1 of a and the rest from b
+      npy_intp k0 = (na + nb) * piece / m->pieces, k1 = (na + nb) * (piece + 1) / m->pieces;
+      npy_intp i0 = m->corank (k0, a, na, b, nb), i1 = m->corank (k1, a, na, b, nb);
+      m->merge (a + i0 * m->size, i1 - i0, b + (k0 - i0) * m->size, (k1 - i1) - (k0 - i0),
+                m->dst + (lo + k0) * m->size);
+    }
+}
+
+/* Sorts n elements of v with the scratch w of the same size, returns the one that holds the result. */
+static char *sort_parallel (sort_kernel sort, void *arr, merge_kernel merge, corank_kernel corank,
+                            size_t size, char *v, char *w, npy_intp n)
+{
+  SortMerge m;
+  npy_intp chunks = (n + SORT_GRAIN - 1) / SORT_GRAIN;
+  npy_intp threads = thread_pool_get_threads ();
+
+  chunks = chunks < threads ? chunks : threads;
+  m.sort = sort;
+  m.arr = arr;
+  m.merge = merge;
+  m.corank = corank;
+  m.size = size;
+  m.n = n;
+  m.run = (n + chunks - 1) / chunks;
+  m.src = v;
+  m.dst = w;
+
+  Py_BEGIN_ALLOW_THREADS
+  thread_pool_parallel_for (chunks, 1, sort_chunks_task, &m);
+  for (; m.run < n; m.run *= 2)
+    {
+      char *t = m.src;
+      npy_intp merges = (n + 2 * m.run - 1) / (2 * m.run);
+      npy_intp length = 2 * m.run < n ? 2 * m.run : n;
+      m.pieces = (length + SORT_GRAIN - 1) / SORT_GRAIN;
+      thread_pool_parallel_for (merges * m.pieces, 1, sort_merge_task, &m);
+      m.src = m.dst;
+      m.dst = t;
+    }
+  KTNUMPY_END_ALLOW_THREADS
+
+  return m.src;
+}
+
+/* Rows of the moved view of an array and where their results go. */
+typedef struct
+{
+  const SortKernels *kernels;
+  SortMode mode;
+  /* sort of numpy for the values and its array */
+  sort_kernel sort;
+  void *arr;
+  const char *data;
+  int ndim;
+  npy_intp dims[NPY_MAXDIMS];
+  npy_intp strides[NPY_MAXDIMS];
+  npy_intp rows;
+  npy_intp length;
+  npy_intp stride;
+  npy_intp k;
+  /* contiguous rows of length, or of k for the selections */
+  char *values;
+  npy_int64 *indices;
+  /* candidates of the chunks of a long row */
+  npy_intp chunks;
+  npy_intp chunk_length;
+  npy_intp *found;
+  char *pairs;
+  int failed;
+} SortRows;
+
+static const char *sort_row (const SortRows *rows, npy_intp r)
+{
+  const char *p = rows->data;
+
+  for (int d = rows->ndim - 1; d >= 0; --d)
+    {
+      p += (r % rows->dims[d]) * rows->strides[d];
+      r /= rows->dims[d];
+    }
+  return p;
+}
+
+static void sort_rows_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  SortRows *rows = (SortRows *) ctx;
+  const SortKernels *kernels = rows->kernels;
+  npy_intp width = rows->mode == SORT_VALUES || rows->mode == SORT_INDICES ? rows->length : rows->k;
+  char *pairs = NULL;
+
+  if (rows->mode != SORT_VALUES)
+    {
+      pairs = malloc ((width > 0 ? width : 1) * kernels->pair_size);
+      if (pairs == NULL)
+        {
+          rows->failed = 1;
+          return;
+        }
+    }
+  for (Py_ssize_t r = begin; r < end; ++r)
+    {
+      const char *p = sort_row (rows, r);
+      npy_intp m;
+      switch (rows->mode)
+        {
+          case SORT_VALUES:
+            rows->sort (rows->values + r * width * kernels->itemsize, width, rows->arr);
+            break;
+          case SORT_INDICES:
+            kernels->fill (p, width, rows->stride, 0, pairs);
+            kernels->pair_sort (pairs, width, NULL);
+            kernels->split (pairs, width, NULL, rows->indices + r * width);
+            break;
+          case SORT_SMALLEST:
+          case SORT_LARGEST:
+            m = (rows->mode == SORT_SMALLEST ? kernels->smallest : kernels->largest)
+                (p, rows->length, rows->stride, 0, width, pairs);
+            kernels->split (pairs, m, rows->values + r * width * kernels->itemsize, rows->indices + r * width);
+            break;
+        }
+    }
+  free (pairs);
+}
+
+static void sort_fill_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  SortRows *rows = (SortRows *) ctx;
+  const SortKernels *kernels = rows->kernels;
+  const char *p = rows->data;
+
+  for (Py_ssize_t c = begin; c < end; ++c)
+    {
+      npy_intp first = c * rows->chunk_length;
+      npy_intp n = rows->length - first < rows->chunk_length ? rows->length - first : rows->chunk_length;
+      kernels->fill (p + first * rows->stride, n, rows->stride, first, rows->pairs + first * kernels->pair_size);
+    }
+}
+
+static void sort_select_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  SortRows *rows = (SortRows *) ctx;
+  const SortKernels *kernels = rows->kernels;
+  select_kernel select = rows->mode == SORT_SMALLEST ? kernels->smallest : kernels->largest;
+  const char *p = rows->data;
+
+  for (Py_ssize_t c = begin; c < end; ++c)
+    {
+      npy_intp first = c * rows->chunk_length;
+      npy_intp n = rows->length - first < rows->chunk_length ? rows->length - first : rows->chunk_length;
+      rows->found[c] = select (p + first * rows->stride, n, rows->stride, first, rows->k,
+                               rows->pairs + c * rows->k * kernels->pair_size);
+    }
+}
+
+/* Sorts or selects the row r on all threads. */
+static int sort_long_row (SortRows *rows, npy_intp r)
+{
+  const SortKernels *kernels = rows->kernels;
+  npy_intp n = rows->length;
+  npy_intp threads = thread_pool_get_threads ();
+  size_t pair_size = kernels->pair_size;
+  char *scratch = NULL, *sorted;
+  SortRows row = *rows;
+
+  row.data = sort_row (rows, r);
+  row.ndim = 0;
+  row.chunks = (n + SORT_GRAIN - 1) / SORT_GRAIN;
+  row.chunks = row.chunks < threads ? row.chunks : threads;
+  row.chunk_length = (n + row.chunks - 1) / row.chunks;
+
+  switch (rows->mode)
+    {
+      case SORT_VALUES:
+        scratch = malloc (n * kernels->itemsize);
+        if (scratch == NULL)
+          {
+            return -1;
+          }
+        row.values = rows->values + r * n * kernels->itemsize;
+        sorted = sort_parallel (rows->sort, rows->arr, kernels->merge, kernels->corank, kernels->itemsize,
+                                row.values, scratch, n);
+        if (sorted != row.values)
+          {
+            memcpy (row.values, sorted, n * kernels->itemsize);
+          }
+        break;
+      case SORT_INDICES:
+        scratch = malloc (2 * n * pair_size);
+        if (scratch == NULL)
+          {
+            return -1;
+          }
+        row.pairs = scratch;
+        Py_BEGIN_ALLOW_THREADS
+        thread_pool_parallel_for (row.chunks, 1, sort_fill_task, &row);
+        KTNUMPY_END_ALLOW_THREADS
+        sorted = sort_parallel (kernels->pair_sort, NULL, kernels->pair_merge, kernels->pair_corank,
+                                pair_size, scratch, scratch + n * pair_size, n);
+        kernels->split (sorted, n, NULL, rows->indices + r * n);
+        break;
+      case SORT_SMALLEST:
+      case SORT_LARGEST:
+        scratch = malloc (row.chunks * (rows->k > 0 ? rows->k : 1) * pair_size);
+        row.found = malloc (row.chunks * sizeof (npy_intp));
+        if (scratch == NULL || row.found == NULL)
+          {
+            free (scratch);
+            free (row.found);
+            return -1;
+          }
+        row.pairs = scratch;
+        Py_BEGIN_ALLOW_THREADS
+        thread_pool_parallel_for (row.chunks, 1, sort_select_task, &row);
+        KTNUMPY_END_ALLOW_THREADS
+
+        // the candidates of the chunks are packed and the first k of them taken
+        npy_intp m = 0;
+        for (npy_intp c = 0; c < row.chunks; ++c)
+          {
+            memmove (scratch + m * pair_size, scratch + c * rows->k * pair_size, row.found[c] * pair_size);
+            m += row.found[c];
+          }
+        (rows->mode == SORT_SMALLEST ? kernels->pair_sort : kernels->pair_sort_greater) (scratch, m, NULL);
+        m = m < rows->k ? m : rows->k;
+        kernels->split (scratch, m, rows->values + r * rows->k * kernels->itemsize, rows->indices + r * rows->k);
+        free (row.found);
+        break;
+    }
+  free (scratch);
+  return 0;
+}
+
+static int sort_rows (SortRows *rows)
+{
+  npy_intp threads = thread_pool_get_threads ();
+
+  if (rows->rows >= threads || rows->length < 2 * SORT_GRAIN)
+    {
+      Py_BEGIN_ALLOW_THREADS
+      thread_pool_parallel_for (rows->rows, 1, sort_rows_task, rows);
+      KTNUMPY_END_ALLOW_THREADS
+      return rows->failed ? -1 : 0;
+    }
+  for (npy_intp r = 0; r < rows->rows; ++r)
+    {
+      if (sort_long_row (rows, r) < 0)
+        {
+          return -1;
+        }
+    }
+  return 0;
+}
+
+static const SortKernels *sort_kernels_for (PyArrayObject *a)
+{
+  PyArray_Descr *descr = PyArray_DESCR (a);
+
+  // subclasses such as masked arrays sort differently, numpy keeps them
+  if (!PyArray_CheckExact (a) || !PyArray_ISNBO (descr->byteorder) || !PyArray_ISALIGNED (a))
+    {
+      return NULL;
+    }
+  for (size_t k = 0; k < sizeof (sort_kernels) / sizeof (SortKernels); ++k)
+    {
+      if (sort_kernels[k].kind == descr->kind && sort_kernels[k].itemsize == PyArray_ITEMSIZE (a))
+        {
+          return sort_kernels + k;
+        }
+    }
+  return NULL;
+}
+
+/*
+ * Sorts or selects along axis. The results are C-contiguous with the axis moved last, they are
+ * returned as views with the axis in its place; values is NULL for argsort.
+ */
+static int sort_axis (PyArrayObject *a, const SortKernels *kernels, SortMode mode, int axis, npy_intp k,
+                      PyArrayObject **values, PyArrayObject **indices)
+{
+  int last = PyArray_NDIM (a) - 1;
+  PyArrayObject *moved = (PyArrayObject *) PyArray_SwapAxes (a, axis, last);
+  PyArrayObject *out_values = NULL, *out_indices = NULL;
+  npy_intp dims[NPY_MAXDIMS];
+  SortRows rows;
+  int res = -1;
+
+  if (moved == NULL)
+    {
+      return -1;
+    }
+  memset (&rows, 0, sizeof (SortRows));
+  rows.kernels = kernels;
+  rows.mode = mode;
+  rows.data = PyArray_BYTES (moved);
+  rows.ndim = last;
+  memcpy (rows.dims, PyArray_DIMS (moved), last * sizeof (npy_intp));
+  memcpy (rows.strides, PyArray_STRIDES (moved), last * sizeof (npy_intp));
+  rows.rows = PyArray_MultiplyList (PyArray_DIMS (moved), last);
+  rows.length = PyArray_DIM (moved, last);
+  rows.stride = PyArray_STRIDE (moved, last);
+  rows.k = k;
+
+  memcpy (dims, PyArray_DIMS (moved), PyArray_NDIM (moved) * sizeof (npy_intp));
+  if (mode == SORT_SMALLEST || mode == SORT_LARGEST)
+    {
+      dims[last] = k;
+    }
+  if (mode == SORT_VALUES)
+    {
+      out_values = (PyArrayObject *) PyArray_NewCopy (moved, NPY_CORDER);
+      rows.sort = PyDataType_GetArrFuncs (PyArray_DESCR (a))->sort[NPY_QUICKSORT];
+      rows.arr = out_values;
+    }
+  else if (mode != SORT_INDICES)
+    {
+      Py_INCREF (PyArray_DESCR (a));
+      out_values = (PyArrayObject *) PyArray_SimpleNewFromDescr (last + 1, dims, PyArray_DESCR (a));
+    }
+  if (mode != SORT_VALUES)
+    {
+      out_indices = (PyArrayObject *) PyArray_SimpleNew (last + 1, dims, NPY_INT64);
+    }
+  if ((mode != SORT_INDICES && out_values == NULL) || (mode != SORT_VALUES && out_indices == NULL))
+    {
+      goto finally;
+    }
+  rows.values = out_values != NULL ? PyArray_BYTES (out_values) : NULL;
+  rows.indices = out_indices != NULL ? (npy_int64 *) PyArray_DATA (out_indices) : NULL;
+
+  if (rows.rows > 0 && sort_rows (&rows) < 0)
+    {
+      PyErr_NoMemory ();
+      goto finally;
+    }
+  if (out_values != NULL)
+    {
+      *values = (PyArrayObject *) PyArray_SwapAxes (out_values, axis, last);
+      if (*values == NULL)
+        {
+          goto finally;
+        }
+    }
+  if (out_indices != NULL)
+    {
+      *indices = (PyArrayObject *) PyArray_SwapAxes (out_indices, axis, last);
+      if (*indices == NULL)
+        {
+          Py_XDECREF (*values);
+          *values = NULL;
+          goto finally;
+        }
+    }
+  res = 0;
+
+  finally:
+  Py_DECREF (moved);
+  Py_XDECREF (out_values);
+  Py_XDECREF (out_indices);
+  return res;
+}
+
+/* Kernels for a sort of a along axis, NULL when the array is left to numpy; axis is normalized. */
+static const SortKernels *sort_prepare (PyArrayObject *a, int *axis)
+{
+  if (PyArray_NDIM (a) == 0)
+    {
+      return NULL;
+    }
+  if (*axis < 0)
+    {
+      *axis += PyArray_NDIM (a);
+    }
+  if (*axis < 0 || *axis >= PyArray_NDIM (a))
+    {
+      return NULL;
+    }
+  return sort_kernels_for (a);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Sorting
+ * Method:    sortAxis
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;I)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Sorting_sortAxis
+    (JNIEnv *env, jclass jcl, jobject ja, jint axis)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  PyArrayObject *a = numkt_core_KtNDArray_getPointer (env, ja);
+  const SortKernels *kernels = sort_prepare (a, &axis);
+  PyArrayObject *values = NULL;
+  jobject result = NULL;
+
+  // null for the arrays which numpy sorts itself
+  if (kernels != NULL && sort_axis (a, kernels, SORT_VALUES, axis, 0, &values, NULL) == 0)
+    {
+      result = new_ktndarray (env, values, NULL);
+    }
+  python_exception (env);
+
+  return result;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Sorting
+ * Method:    argSortAxis
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;I)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Sorting_argSortAxis
+    (JNIEnv *env, jclass jcl, jobject ja, jint axis)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  PyArrayObject *a = numkt_core_KtNDArray_getPointer (env, ja);
+  const SortKernels *kernels = sort_prepare (a, &axis);
+  PyArrayObject *indices = NULL;
+  jobject result = NULL;
+
+  if (kernels != NULL && sort_axis (a, kernels, SORT_INDICES, axis, 0, NULL, &indices) == 0)
+    {
+      result = new_ktndarray (env, indices, NULL);
+    }
+  python_exception (env);
+
+  return result;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Sorting
+ * Method:    selectTopK
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;IIZ)Lkotlin/Pair;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Sorting_selectTopK
+    (JNIEnv *env, jclass jcl, jobject ja, jint k, jint axis, jboolean largest)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  PyArrayObject *a = numkt_core_KtNDArray_getPointer (env, ja);
+  const SortKernels *kernels = sort_prepare (a, &axis);
+  PyArrayObject *values = NULL, *indices = NULL;
+  jobject result = NULL;
+
+  if (kernels == NULL)
+    {
+      PyErr_Format (PyExc_TypeError, "topK is not supported for arrays of %S along axis %d",
+                    (PyObject *) PyArray_DESCR (a), (int) axis);
+    }
+  else if (k < 0 || k > PyArray_DIM (a, axis))
+    {
+      PyErr_Format (PyExc_ValueError, "k = %d is out of the range [0, %zd]", (int) k, PyArray_DIM (a, axis));
+    }
+  else if (sort_axis (a, kernels, largest ? SORT_LARGEST : SORT_SMALLEST, axis, k, &values, &indices) == 0)
+    {
+      result = kotlin_Pair_new (env, new_ktndarray (env, values, NULL), new_ktndarray (env, indices, NULL));
+    }
+  python_exception (env);
+
+  return result;
+}
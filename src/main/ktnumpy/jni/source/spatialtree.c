@@ -0,0 +1,1027 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#ifdef KTNUMPY_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * KD-tree and ball tree over the rows of a C-contiguous float64 array, which is used in place.
+ *
+ * The tree is a complete binary tree stored in arrays: node i has the children 2i + 1 and 2i + 2,
+ * and covers index[start:end] of a permutation of the points, split at the middle along the dimension
+ * of the largest spread. The arrays are saved as they are, so a saved tree can be opened over a memory-mapped file.
+ *
+ * Distances are Euclidean, squared while searching.
+ */
+
+#define TREE_KD 0
+#define TREE_BALL 1
+
+/* Queries processed by one task of the thread pool. */
+#define TREE_QUERIES_PER_TASK 16
+
+enum
+{
+  NODE_START, NODE_END, NODE_IS_LEAF, NODE_FIELDS
+};
+
+typedef struct
+{
+  int kind;
+  npy_intp n;
+  npy_intp d;
+  npy_intp n_nodes;
+  /* (n, d) points */
+  PyArrayObject *data;
+  /* (n) permutation of the points */
+  PyArrayObject *index;
+  /* (n_nodes, NODE_FIELDS) */
+  PyArrayObject *nodes;
+  /* (n_nodes, 2d) lower and upper corners for KD, (n_nodes, d + 1) centroid and radius for ball */
+  PyArrayObject *bounds;
+  const double *points;
+  npy_int64 *idx;
+  npy_int64 *node;
+  double *bound;
+  npy_intp bound_stride;
+} SpatialTree;
+
+typedef struct
+{
+  const SpatialTree *tree;
+  const double *queries;
+  npy_intp k;
+  double *dist;
+  npy_int64 *index;
+  /* radius queries, counting if index is NULL */
+  double r2;
+  npy_int64 *offsets;
+} TreeTask;
+
+static inline double squared_distance (const double *a, const double *b, npy_intp d)
+{
+  double s = 0;
+  for (npy_intp t = 0; t < d; ++t)
+    {
+      double v = a[t] - b[t];
+      s += v * v;
+    }
+  return s;
+}
+
+static inline const double *tree_point (const SpatialTree *tree, npy_intp i)
+{
+  return tree->points + tree->idx[i] * tree->d;
+}
+
+static void tree_node_bounds (SpatialTree *tree, npy_intp node)
+{
+  const npy_intp d = tree->d;
+  npy_int64 start = tree->node[node * NODE_FIELDS + NODE_START];
+  npy_int64 end = tree->node[node * NODE_FIELDS + NODE_END];
+  double *bound = tree->bound + node * tree->bound_stride;
+
+  if (tree->kind == TREE_KD)
+    {
+      for (npy_intp t = 0; t < d; ++t)
+        {
+          bound[t] = HUGE_VAL;
+          bound[d + t] = -HUGE_VAL;
+        }
+      for (npy_int64 i = start; i < end; ++i)
+        {
+          const double *p = tree_point (tree, i);
+          for (npy_intp t = 0; t < d; ++t)
+            {
+              if (p[t] < bound[t]) bound[t] = p[t];
+              if (p[t] > bound[d + t]) bound[d + t] = p[t];
+            }
+        }
+    }
+  else
+    {
+      double radius = 0;
+      for (npy_intp t = 0; t < d; ++t) bound[t] = 0;
+      for (npy_int64 i = start; i < end; ++i)
+        {
+          const double *p = tree_point (tree, i);
+          for (npy_intp t = 0; t < d; ++t) bound[t] += p[t];
+        }
+      for (npy_intp t = 0; t < d; ++t) bound[t] /= (double) (end - start);
+      for (npy_int64 i = start; i < end; ++i)
+        {
+          double r = squared_distance (bound, tree_point (tree, i), d);
+          if (r > radius) radius = r;
+        }
+      bound[d] = sqrt (radius);
+    }
+}
+
+static npy_intp tree_split_dim (const SpatialTree *tree, npy_intp node)
+{
+  const npy_intp d = tree->d;
+  npy_int64 start = tree->node[node * NODE_FIELDS + NODE_START];
+  npy_int64 end = tree->node[node * NODE_FIELDS + NODE_END];
+  const double *bound = tree->bound + node * tree->bound_stride;
+  npy_intp dim = 0;
+  double spread = -1;
+
+  for (npy_intp t = 0; t < d; ++t)
+    {
+      double lo = HUGE_VAL, hi = -HUGE_VAL;
+      if (tree->kind == TREE_KD)
+        {
+          lo = bound[t];
+          hi = bound[d + t];
+        }
+      else
+        {
+          for (npy_int64 i = start; i < end; ++i)
+            {
+              double v = tree_point (tree, i)[t];
+              if (v < lo) lo = v;
+              if (v > hi) hi = v;
+            }
+        }
+      if (hi - lo > spread)
+        {
+          spread = hi - lo;
+          dim = t;
+        }
+    }
+  return dim;
+}
+
+/* Reorders index[start:end] so that index[kth] is the point which would be there if sorted along dim. */
+static void tree_select (SpatialTree *tree, npy_intp start, npy_intp end, npy_intp kth, npy_intp dim)
+{
+  npy_int64 *idx = tree->idx;
+  const double *points = tree->points;
+  const npy_intp d = tree->d;
+
+#define KEY(i) points[idx[i] * d + dim]
+#define SWAP(i, j) { npy_int64 tmp = idx[i]; idx[i] = idx[j]; idx[j] = tmp; }
+
+  npy_intp lo = start, hi = end - 1;
+  while (hi > lo)
+    {
+      npy_intp mid = lo + (hi - lo) / 2;
+      npy_intp i, j;
+      double pivot;
+
+      // median of three as the pivot at lo
+      if (KEY (mid) < KEY (lo)) SWAP (mid, lo);
+      if (KEY (hi) < KEY (lo)) SWAP (hi, lo);
+      if (KEY (hi) < KEY (mid)) SWAP (hi, mid);
+      SWAP (lo, mid);
+      pivot = KEY (lo);
+
+      i = lo;
+      j = hi + 1;
+      for (;;)
+        {
+          do ++i; while (i <= hi && KEY (i) < pivot);
+          do --j; while (KEY (j) > pivot);
+          if (i >= j) break;
+          SWAP (i, j);
+        }
+      SWAP (lo, j);
+
+      if (j == kth) break;
+      if (j < kth) lo = j + 1;
+      else hi = j - 1;
+    }
+
+#undef KEY
+#undef SWAP
+}
+
+/* Computes the bounds of a node and the ranges of its children. */
+static void tree_process_node (SpatialTree *tree, npy_intp node)
+{
+  npy_int64 *fields = tree->node + node * NODE_FIELDS;
+  npy_intp left = 2 * node + 1;
+
+  tree_node_bounds (tree, node);
+  fields[NODE_IS_LEAF] = left >= tree->n_nodes;
+  if (!fields[NODE_IS_LEAF])
+    {
+      npy_int64 mid = fields[NODE_START] + (fields[NODE_END] - fields[NODE_START]) / 2;
+
+      tree_select (tree, fields[NODE_START], fields[NODE_END], mid, tree_split_dim (tree, node));
+      tree->node[left * NODE_FIELDS + NODE_START] = fields[NODE_START];
+      tree->node[left * NODE_FIELDS + NODE_END] = mid;
+      tree->node[(left + 1) * NODE_FIELDS + NODE_START] = mid;
+      tree->node[(left + 1) * NODE_FIELDS + NODE_END] = fields[NODE_END];
+    }
+}
+
+static void tree_build_subtree (SpatialTree *tree, npy_intp node)
+{
+  tree_process_node (tree, node);
+  if (!tree->node[node * NODE_FIELDS + NODE_IS_LEAF])
+    {
+      tree_build_subtree (tree, 2 * node + 1);
+      tree_build_subtree (tree, 2 * node + 2);
+    }
+}
+
+typedef struct
+{
+  SpatialTree *tree;
+  /* first node of the level of the subtrees built in parallel */
+  npy_intp first;
+} TreeBuildTask;
+
+static void tree_build_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  TreeBuildTask *task = (TreeBuildTask *) ctx;
+
+  for (Py_ssize_t node = task->first + begin; node < task->first + end; ++node)
+    {
+      tree_build_subtree (task->tree, node);
+    }
+}
+
+static void tree_build (SpatialTree *tree)
+{
+  TreeBuildTask task = {tree, 0};
+  npy_intp subtrees = 4 * thread_pool_get_threads ();
+
+  tree->node[NODE_START] = 0;
+  tree->node[NODE_END] = tree->n;
+
+  // the top levels serially until there are enough subtrees for the threads
+  while (2 * task.first + 1 < tree->n_nodes && task.first + 1 < subtrees)
+    {
+      for (npy_intp node = task.first; node < 2 * task.first + 1; ++node)
+        {
+          tree_process_node (tree, node);
+        }
+      task.first = 2 * task.first + 1;
+    }
+  thread_pool_parallel_for (task.first + 1, 1, tree_build_task, &task);
+}
+
+static void tree_free (SpatialTree *tree)
+{
+  Py_XDECREF (tree->data);
+  Py_XDECREF (tree->index);
+  Py_XDECREF (tree->nodes);
+  Py_XDECREF (tree->bounds);
+  free (tree);
+}
+
+static void tree_attach (SpatialTree *tree)
+{
+  tree->n = PyArray_DIM (tree->data, 0);
+  tree->d = PyArray_DIM (tree->data, 1);
+  tree->n_nodes = PyArray_DIM (tree->nodes, 0);
+  tree->points = (const double *) PyArray_DATA (tree->data);
+  tree->idx = (npy_int64 *) PyArray_DATA (tree->index);
+  tree->node = (npy_int64 *) PyArray_DATA (tree->nodes);
+  tree->bound = (double *) PyArray_DATA (tree->bounds);
+  tree->bound_stride = tree->kind == TREE_KD ? 2 * tree->d : tree->d + 1;
+}
+
+/* Lower bound of the squared distance from q to the points of a node. */
+static double tree_min_rdist (const SpatialTree *tree, npy_intp node, const double *q)
+{
+  const npy_intp d = tree->d;
+  const double *bound = tree->bound + node * tree->bound_stride;
+
+  if (tree->kind == TREE_KD)
+    {
+      double s = 0;
+      for (npy_intp t = 0; t < d; ++t)
+        {
+          double v = bound[t] - q[t];
+          if (v < 0) v = q[t] - bound[d + t];
+          if (v > 0) s += v * v;
+        }
+      return s;
+    }
+  else
+    {
+      double v = sqrt (squared_distance (q, bound, d)) - bound[d];
+      return v > 0 ? v * v : 0;
+    }
+}
+
+static npy_intp tree_knn_node (const SpatialTree *tree, npy_intp node, double lower, const double *q,
+                               double *dist, npy_int64 *index, npy_intp size, npy_intp k)
+{
+  const npy_int64 *fields = tree->node + node * NODE_FIELDS;
+
+  if (size == k && lower > dist[0])
+    {
+      return size;
+    }
+  if (fields[NODE_IS_LEAF])
+    {
+      for (npy_int64 i = fields[NODE_START]; i < fields[NODE_END]; ++i)
+        {
+          size = neighbors_heap_offer (dist, index, size, k, squared_distance (q, tree_point (tree, i), tree->d),
+                                       tree->idx[i]);
+        }
+    }
+  else
+    {
+      npy_intp left = 2 * node + 1, right = left + 1;
+      double lower_left = tree_min_rdist (tree, left, q);
+      double lower_right = tree_min_rdist (tree, right, q);
+
+      if (lower_left <= lower_right)
+        {
+          size = tree_knn_node (tree, left, lower_left, q, dist, index, size, k);
+          size = tree_knn_node (tree, right, lower_right, q, dist, index, size, k);
+        }
+      else
+        {
+          size = tree_knn_node (tree, right, lower_right, q, dist, index, size, k);
+          size = tree_knn_node (tree, left, lower_left, q, dist, index, size, k);
+        }
+    }
+  return size;
+}
+
+static void tree_knn_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  const TreeTask *task = (const TreeTask *) ctx;
+  const SpatialTree *tree = task->tree;
+
+  for (Py_ssize_t i = begin; i < end; ++i)
+    {
+      const double *q = task->queries + i * tree->d;
+      double *dist = task->dist + i * task->k;
+      npy_int64 *index = task->index + i * task->k;
+      npy_intp size = tree_knn_node (tree, 0, tree_min_rdist (tree, 0, q), q, dist, index, 0, task->k);
+
+      neighbors_heap_sort (dist, index, size);
+      for (npy_intp j = 0; j < size; ++j) dist[j] = sqrt (dist[j]);
+    }
+}
+
+/* Counts the points within the radius, or stores them if index is not NULL. */
+static npy_intp tree_radius_node (const SpatialTree *tree, npy_intp node, const double *q, double r2,
+                                  double *dist, npy_int64 *index, npy_intp count)
+{
+  const npy_int64 *fields = tree->node + node * NODE_FIELDS;
+
+  if (tree_min_rdist (tree, node, q) > r2)
+    {
+      return count;
+    }
+  if (fields[NODE_IS_LEAF])
+    {
+      for (npy_int64 i = fields[NODE_START]; i < fields[NODE_END]; ++i)
+        {
+          double rd = squared_distance (q, tree_point (tree, i), tree->d);
+          if (rd <= r2)
+            {
+              if (index != NULL)
+                {
+                  dist[count] = rd;
+                  index[count] = tree->idx[i];
+                }
+              ++count;
+            }
+        }
+      return count;
+    }
+  count = tree_radius_node (tree, 2 * node + 1, q, r2, dist, index, count);
+  return tree_radius_node (tree, 2 * node + 2, q, r2, dist, index, count);
+}
+
+static void tree_radius_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  const TreeTask *task = (const TreeTask *) ctx;
+  const SpatialTree *tree = task->tree;
+
+  for (Py_ssize_t i = begin; i < end; ++i)
+    {
+      const double *q = task->queries + i * tree->d;
+
+      if (task->index == NULL)
+        {
+          task->offsets[i + 1] = tree_radius_node (tree, 0, q, task->r2, NULL, NULL, 0);
+        }
+      else
+        {
+          double *dist = task->dist + task->offsets[i];
+          npy_int64 *index = task->index + task->offsets[i];
+          npy_intp size = tree_radius_node (tree, 0, q, task->r2, dist, index, 0);
+
+          neighbors_heap_make (dist, index, size);
+          neighbors_heap_sort (dist, index, size);
+          for (npy_intp j = 0; j < size; ++j) dist[j] = sqrt (dist[j]);
+        }
+    }
+}
+
+/* Queries as a C-contiguous float64 array with the dimension of the tree. New reference. */
+static PyArrayObject *tree_queries (const SpatialTree *tree, PyArrayObject *array)
+{
+  PyArrayObject *queries = (PyArrayObject *) PyArray_FROMANY ((PyObject *) array, NPY_FLOAT64, 2, 2,
+                                                              NPY_ARRAY_CARRAY_RO);
+  if (queries != NULL && PyArray_DIM (queries, 1) != tree->d)
+    {
+      PyErr_Format (PyExc_ValueError, "Queries must have %zd features.", (Py_ssize_t) tree->d);
+      Py_CLEAR (queries);
+    }
+  return queries;
+}
+
+#define TREE_MAGIC "KTNTREE"
+#define TREE_VERSION 1
+#define TREE_ALIGN 64
+#define TREE_SECTIONS 4
+#define TREE_MAPPING_CAPSULE "ktnumpy.tree"
+
+/*
+ * File of a tree: this header, then the points, the index, the nodes and the bounds as they are in memory,
+ * each section aligned to 64 bytes. The byte order is the native one, checked with byte_order.
+ */
+typedef struct
+{
+  char magic[8];
+  npy_uint32 version;
+  npy_uint32 byte_order;
+  npy_int64 kind;
+  npy_int64 n;
+  npy_int64 d;
+  npy_int64 n_nodes;
+  npy_int64 size;
+  char reserved[8];
+} TreeFileHeader;
+
+/* Bytes of a section, -1 if they overflow, as they can with the counts of a corrupted file. */
+static npy_int64 tree_section_size (const SpatialTree *tree, int section)
+{
+  npy_int64 count, size;
+
+  switch (section)
+    {
+      case 0: count = tree->d; break;
+      case 1: count = 1; break;
+      case 2: count = NODE_FIELDS; break;
+      default: count = tree->bound_stride; break;
+    }
+  if (__builtin_mul_overflow ((npy_int64) (section < 2 ? tree->n : tree->n_nodes), count, &count)
+      || __builtin_mul_overflow (count, (npy_int64) sizeof (double), &size))
+    {
+      return -1;
+    }
+  return size;
+}
+
+/* Offsets of the sections and the header of the file, returns -1 if the size overflows. */
+static int tree_file_layout (const SpatialTree *tree, TreeFileHeader *header, npy_int64 *offsets)
+{
+  npy_int64 offset = sizeof (TreeFileHeader);
+
+  memset (header, 0, sizeof (TreeFileHeader));
+  memcpy (header->magic, TREE_MAGIC, sizeof (TREE_MAGIC));
+  header->version = TREE_VERSION;
+  header->byte_order = 0x01020304;
+  header->kind = tree->kind;
+  header->n = tree->n;
+  header->d = tree->d;
+  header->n_nodes = tree->n_nodes;
+  for (int i = 0; i < TREE_SECTIONS; ++i)
+    {
+      npy_int64 size = tree_section_size (tree, i);
+      offset = (offset + TREE_ALIGN - 1) / TREE_ALIGN * TREE_ALIGN;
+      offsets[i] = offset;
+      if (size < 0 || __builtin_add_overflow (offset, size, &offset))
+        {
+          return -1;
+        }
+    }
+  header->size = offset;
+  return 0;
+}
+
+/* Checks that queries cannot read out of bounds, whatever the file contains. */
+static int tree_validate (const SpatialTree *tree)
+{
+  for (npy_intp i = 0; i < tree->n; ++i)
+    {
+      if (tree->idx[i] < 0 || tree->idx[i] >= tree->n)
+        {
+          return -1;
+        }
+    }
+  for (npy_intp i = 0; i < tree->n_nodes; ++i)
+    {
+      const npy_int64 *fields = tree->node + i * NODE_FIELDS;
+      if (fields[NODE_START] < 0 || fields[NODE_START] > fields[NODE_END] || fields[NODE_END] > tree->n
+          || (!fields[NODE_IS_LEAF] && 2 * i + 2 >= tree->n_nodes))
+        {
+          return -1;
+        }
+    }
+  return 0;
+}
+
+#ifdef KTNUMPY_POSIX
+typedef struct
+{
+  void *addr;
+  size_t length;
+} TreeMapping;
+
+static void tree_mapping_destructor (PyObject *capsule)
+{
+  TreeMapping *mapping = PyCapsule_GetPointer (capsule, TREE_MAPPING_CAPSULE);
+  if (mapping != NULL)
+    {
+      munmap (mapping->addr, mapping->length);
+      free (mapping);
+    }
+}
+
+/* Maps the whole file read-only, the capsule unmaps it when the last array over it is deallocated. */
+static PyObject *tree_map_file (const char *path, char **data, size_t *length)
+{
+  TreeMapping *mapping = NULL;
+  PyObject *capsule = NULL;
+  struct stat st;
+  void *addr = MAP_FAILED;
+  int fd = open (path, O_RDONLY);
+
+  if (fd >= 0 && fstat (fd, &st) == 0 && st.st_size > 0)
+    {
+      addr = mmap (NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+  if (fd >= 0)
+    {
+      close (fd);
+    }
+  if (addr == MAP_FAILED)
+    {
+      PyErr_SetFromErrnoWithFilename (PyExc_OSError, path);
+      return NULL;
+    }
+
+  mapping = malloc (sizeof (TreeMapping));
+  if (mapping != NULL)
+    {
+      mapping->addr = addr;
+      mapping->length = (size_t) st.st_size;
+      capsule = PyCapsule_New (mapping, TREE_MAPPING_CAPSULE, tree_mapping_destructor);
+    }
+  if (capsule == NULL)
+    {
+      munmap (addr, (size_t) st.st_size);
+      free (mapping);
+      return PyErr_Occurred () ? NULL : PyErr_NoMemory ();
+    }
+  *data = (char *) addr;
+  *length = (size_t) st.st_size;
+  return capsule;
+}
+#endif
+
+/* Reads the whole file into a bytes array. */
+static PyObject *tree_read_file (const char *path, char **data, size_t *length)
+{
+  PyObject *buffer = NULL;
+  FILE *file = fopen (path, "rb");
+  long size = -1;
+
+  if (file != NULL && fseek (file, 0, SEEK_END) == 0)
+    {
+      size = ftell (file);
+    }
+  if (size > 0 && fseek (file, 0, SEEK_SET) == 0)
+    {
+      npy_intp dims[1] = {size};
+      buffer = PyArray_SimpleNew (1, dims, NPY_UINT8);
+      if (buffer != NULL && fread (PyArray_DATA ((PyArrayObject *) buffer), 1, (size_t) size, file) != (size_t) size)
+        {
+          Py_CLEAR (buffer);
+        }
+    }
+  if (buffer == NULL && !PyErr_Occurred ())
+    {
+      PyErr_SetFromErrnoWithFilename (PyExc_OSError, path);
+    }
+  if (file != NULL)
+    {
+      fclose (file);
+    }
+  if (buffer != NULL)
+    {
+      *data = PyArray_DATA ((PyArrayObject *) buffer);
+      *length = (size_t) size;
+    }
+  return buffer;
+}
+
+/* Array over a section of the file, which keeps the owner alive. */
+static PyArrayObject *tree_section_array (PyObject *owner, char *data, int ndim, npy_intp *dims, int type)
+{
+  PyArrayObject *array = (PyArrayObject *) PyArray_New (&PyArray_Type, ndim, dims, type, NULL, data, 0,
+                                                        NPY_ARRAY_CARRAY_RO, NULL);
+  if (array != NULL)
+    {
+      Py_INCREF (owner);
+      if (PyArray_SetBaseObject (array, owner) < 0)
+        {
+          Py_DECREF (array);
+          return NULL;
+        }
+    }
+  return array;
+}
+
+static SpatialTree *tree_open (const char *path, int mmap_file)
+{
+  TreeFileHeader header;
+  npy_int64 offsets[TREE_SECTIONS];
+  SpatialTree *tree = NULL;
+  PyObject *owner = NULL;
+  char *data = NULL;
+  size_t length = 0;
+  npy_intp dims[2];
+
+#ifdef KTNUMPY_POSIX
+  owner = mmap_file ? tree_map_file (path, &data, &length) : tree_read_file (path, &data, &length);
+#else
+  owner = tree_read_file (path, &data, &length);
+#endif
+  if (owner == NULL)
+    {
+      return NULL;
+    }
+
+  tree = (SpatialTree *) calloc (1, sizeof (SpatialTree));
+  if (tree == NULL)
+    {
+      PyErr_NoMemory ();
+      goto ERROR;
+    }
+  if (length < sizeof (TreeFileHeader))
+    {
+      goto INVALID;
+    }
+  memcpy (&header, data, sizeof (TreeFileHeader));
+  if (memcmp (header.magic, TREE_MAGIC, sizeof (TREE_MAGIC)) != 0 || header.version != TREE_VERSION
+      || header.byte_order != 0x01020304 || (header.kind != TREE_KD && header.kind != TREE_BALL)
+      || header.n < 1 || header.d < 0 || header.n_nodes < 1)
+    {
+      goto INVALID;
+    }
+  // each point has an index and each node its fields, so the file bounds the counts
+  if ((size_t) header.n > length / sizeof (npy_int64) || (size_t) header.d > length / sizeof (double)
+      || (size_t) header.n_nodes > length / (NODE_FIELDS * sizeof (npy_int64)))
+    {
+      goto INVALID;
+    }
+
+  tree->kind = (int) header.kind;
+  tree->n = header.n;
+  tree->d = header.d;
+  tree->n_nodes = header.n_nodes;
+  tree->bound_stride = tree->kind == TREE_KD ? 2 * tree->d : tree->d + 1;
+  if (tree_file_layout (tree, &header, offsets) < 0 || (size_t) header.size > length)
+    {
+      goto INVALID;
+    }
+
+  dims[0] = tree->n;
+  dims[1] = tree->d;
+  tree->data = tree_section_array (owner, data + offsets[0], 2, dims, NPY_FLOAT64);
+  tree->index = tree_section_array (owner, data + offsets[1], 1, dims, NPY_INT64);
+  dims[0] = tree->n_nodes;
+  dims[1] = NODE_FIELDS;
+  tree->nodes = tree_section_array (owner, data + offsets[2], 2, dims, NPY_INT64);
+  dims[1] = tree->bound_stride;
+  tree->bounds = tree_section_array (owner, data + offsets[3], 2, dims, NPY_FLOAT64);
+  if (tree->data == NULL || tree->index == NULL || tree->nodes == NULL || tree->bounds == NULL)
+    {
+      goto ERROR;
+    }
+  tree_attach (tree);
+  if (tree_validate (tree) < 0)
+    {
+      goto INVALID;
+    }
+
+  Py_DECREF (owner);
+  return tree;
+
+  INVALID:
+  PyErr_Format (PyExc_ValueError, "%s is not a spatial tree file.", path);
+  ERROR:
+  if (tree != NULL)
+    {
+      tree_free (tree);
+    }
+  Py_DECREF (owner);
+  return NULL;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeBuild
+ * Signature: (Lorg/jetbrains/numkt/core/KtNDArray;II)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeBuild
+    (JNIEnv *env, jclass jcl, jobject jpoints, jint kind, jint leaf_size)
+{
+  NPY_IMPORT_ONCE (0)
+
+  PyArrayObject *points = numkt_core_KtNDArray_getPointer (env, jpoints);
+  SpatialTree *tree = NULL;
+  npy_intp n, d, n_nodes = 1, leaves;
+  npy_intp dims[2];
+
+  if (leaf_size < 1)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "leafSize must be positive.");
+      return 0;
+    }
+  tree = (SpatialTree *) calloc (1, sizeof (SpatialTree));
+  if (tree == NULL)
+    {
+      PyErr_NoMemory ();
+      goto ERROR;
+    }
+  tree->kind = kind;
+
+  // no copy if the points are already a C-contiguous float64 array
+  tree->data = (PyArrayObject *) PyArray_FROMANY ((PyObject *) points, NPY_FLOAT64, 2, 2, NPY_ARRAY_CARRAY_RO);
+  if (tree->data == NULL)
+    {
+      goto ERROR;
+    }
+  n = PyArray_DIM (tree->data, 0);
+  d = PyArray_DIM (tree->data, 1);
+  if (n < 1)
+    {
+      PyErr_SetString (PyExc_ValueError, "Cannot build a tree without points.");
+      goto ERROR;
+    }
+
+  // 2^levels - 1 nodes, so that leaves have between leaf_size and 2 * leaf_size points
+  for (leaves = (n - 1) / leaf_size; leaves > 1; leaves /= 2)
+    {
+      n_nodes = 2 * n_nodes + 1;
+    }
+
+  tree->index = (PyArrayObject *) PyArray_Arange (0, (double) n, 1, NPY_INT64);
+  dims[0] = n_nodes;
+  dims[1] = NODE_FIELDS;
+  tree->nodes = (PyArrayObject *) PyArray_ZEROS (2, dims, NPY_INT64, 0);
+  dims[1] = kind == TREE_KD ? 2 * d : d + 1;
+  tree->bounds = (PyArrayObject *) PyArray_ZEROS (2, dims, NPY_FLOAT64, 0);
+  if (tree->index == NULL || tree->nodes == NULL || tree->bounds == NULL)
+    {
+      goto ERROR;
+    }
+
+  tree_attach (tree);
+  Py_BEGIN_ALLOW_THREADS
+  tree_build (tree);
+  KTNUMPY_END_ALLOW_THREADS
+
+  return (jlong) tree;
+
+  ERROR:
+  if (tree != NULL)
+    {
+      tree_free (tree);
+    }
+  python_exception (env);
+  return 0;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeSave
+ * Signature: (JLjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeSave
+    (JNIEnv *env, jclass jcl, jlong ptr, jstring jpath)
+{
+  const SpatialTree *tree = (const SpatialTree *) ptr;
+  const char *path = jstring_to_char (env, jpath);
+  TreeFileHeader header;
+  npy_int64 offsets[TREE_SECTIONS];
+  const void *sections[TREE_SECTIONS];
+  static const char zeros[TREE_ALIGN] = {0};
+  FILE *file = NULL;
+  int failed = 0;
+
+  tree_file_layout (tree, &header, offsets);
+  sections[0] = tree->points;
+  sections[1] = tree->idx;
+  sections[2] = tree->node;
+  sections[3] = tree->bound;
+
+  file = fopen (path, "wb");
+  failed = file == NULL || fwrite (&header, sizeof (header), 1, file) != 1;
+  for (int i = 0; i < TREE_SECTIONS && !failed; ++i)
+    {
+      size_t padding = (size_t) (offsets[i] - ftell (file));
+      size_t size = (size_t) tree_section_size (tree, i);
+
+      failed = fwrite (zeros, 1, padding, file) != padding || fwrite (sections[i], 1, size, file) != size;
+    }
+  if (file != NULL && fclose (file) != 0)
+    {
+      failed = 1;
+    }
+  if (failed)
+    {
+      char message[512];
+      snprintf (message, sizeof (message), "Cannot write %s: %s", path, strerror (errno));
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, message);
+    }
+  release_utf_char (env, jpath, path);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeOpen
+ * Signature: (Ljava/lang/String;Z)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeOpen
+    (JNIEnv *env, jclass jcl, jstring jpath, jboolean mmap_file)
+{
+  NPY_IMPORT_ONCE (0)
+
+  const char *path = jstring_to_char (env, jpath);
+  SpatialTree *tree = tree_open (path, mmap_file);
+
+  release_utf_char (env, jpath, path);
+  python_exception (env);
+  return (jlong) tree;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeKind
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeKind
+    (JNIEnv *env, jclass jcl, jlong ptr)
+{
+  return ((SpatialTree *) ptr)->kind;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeQuery
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeQuery
+    (JNIEnv *env, jclass jcl, jlong ptr, jobject jqueries, jobject jindices, jobject jdistances)
+{
+  NPY_IMPORT_ONCE ()
+
+  SpatialTree *tree = (SpatialTree *) ptr;
+  PyArrayObject *indices = numkt_core_KtNDArray_getPointer (env, jindices);
+  PyArrayObject *distances = numkt_core_KtNDArray_getPointer (env, jdistances);
+  PyArrayObject *queries = tree_queries (tree, numkt_core_KtNDArray_getPointer (env, jqueries));
+  TreeTask task;
+
+  if (queries == NULL)
+    {
+      python_exception (env);
+      return;
+    }
+
+  memset (&task, 0, sizeof (TreeTask));
+  task.tree = tree;
+  task.queries = (const double *) PyArray_DATA (queries);
+  task.k = PyArray_DIM (indices, 1);
+  task.index = (npy_int64 *) PyArray_DATA (indices);
+  task.dist = (double *) PyArray_DATA (distances);
+  if (task.k < 1 || task.k > tree->n)
+    {
+      PyErr_Format (PyExc_ValueError, "k must be in [1, %zd].", (Py_ssize_t) tree->n);
+    }
+  else
+    {
+      Py_BEGIN_ALLOW_THREADS
+      thread_pool_parallel_for (PyArray_DIM (queries, 0), TREE_QUERIES_PER_TASK, tree_knn_task, &task);
+      KTNUMPY_END_ALLOW_THREADS
+    }
+
+  Py_DECREF (queries);
+  python_exception (env);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeQueryRadius
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;D)[Ljava/lang/Object;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeQueryRadius
+    (JNIEnv *env, jclass jcl, jlong ptr, jobject jqueries, jdouble r)
+{
+  NPY_IMPORT_ONCE (NULL)
+
+  SpatialTree *tree = (SpatialTree *) ptr;
+  PyArrayObject *queries = tree_queries (tree, numkt_core_KtNDArray_getPointer (env, jqueries));
+  PyArrayObject *outputs[3] = {NULL, NULL, NULL};
+  jobjectArray result = NULL;
+  TreeTask task;
+  npy_intp nq, total;
+
+  if (queries == NULL)
+    {
+      goto OUT;
+    }
+  nq = PyArray_DIM (queries, 0);
+
+  memset (&task, 0, sizeof (TreeTask));
+  task.tree = tree;
+  task.queries = (const double *) PyArray_DATA (queries);
+  task.r2 = r * r;
+  outputs[0] = (PyArrayObject *) PyArray_ZEROS (1, (npy_intp[]) {nq + 1}, NPY_INT64, 0);
+  if (outputs[0] == NULL)
+    {
+      goto OUT;
+    }
+  task.offsets = (npy_int64 *) PyArray_DATA (outputs[0]);
+
+  // the first pass counts the neighbours, the second stores them
+  Py_BEGIN_ALLOW_THREADS
+  thread_pool_parallel_for (nq, TREE_QUERIES_PER_TASK, tree_radius_task, &task);
+  KTNUMPY_END_ALLOW_THREADS
+  for (npy_intp i = 0; i < nq; ++i)
+    {
+      task.offsets[i + 1] += task.offsets[i];
+    }
+  total = task.offsets[nq];
+
+  outputs[1] = (PyArrayObject *) PyArray_SimpleNew (1, &total, NPY_INT64);
+  outputs[2] = (PyArrayObject *) PyArray_SimpleNew (1, &total, NPY_FLOAT64);
+  if (outputs[1] == NULL || outputs[2] == NULL)
+    {
+      goto OUT;
+    }
+  task.index = (npy_int64 *) PyArray_DATA (outputs[1]);
+  task.dist = (double *) PyArray_DATA (outputs[2]);
+  Py_BEGIN_ALLOW_THREADS
+  thread_pool_parallel_for (nq, TREE_QUERIES_PER_TASK, tree_radius_task, &task);
+  KTNUMPY_END_ALLOW_THREADS
+
+  result = (*env)->NewObjectArray (env, 3, OBJECT_TYPE, NULL);
+  for (int i = 0; i < 3 && result != NULL; ++i)
+    {
+      jobject array = new_ktndarray (env, outputs[i], NULL);
+      outputs[i] = NULL;
+      (*env)->SetObjectArrayElement (env, result, i, array);
+      (*env)->DeleteLocalRef (env, array);
+    }
+
+  OUT:
+  Py_XDECREF (outputs[0]);
+  Py_XDECREF (outputs[1]);
+  Py_XDECREF (outputs[2]);
+  Py_XDECREF (queries);
+  python_exception (env);
+
+  return result;
+}
+
+static void tree_release (void *tree)
+{
+  tree_free ((SpatialTree *) tree);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_neighbors_Neighbors
+ * Method:    treeDealloc
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_neighbors_Neighbors_treeDealloc
+    (JNIEnv *env, jclass jcl, jlong ptr)
+{
+  // called by close on the thread of the interpreter or by the finalizer
+  run_with_interpreter (tree_release, (void *) ptr);
+}
@@ -0,0 +1,785 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#define READER_BUFFER_SIZE (4 * 1024 * 1024)
+#define READER_LINES_PER_TASK 1024
+#define READER_MAX_NUMBER 128
+
+typedef struct
+{
+  FILE *file;
+  char *buf;
+  size_t capacity;
+  size_t begin;
+  size_t end;
+  int eof;
+  /* 0 means any whitespace */
+  char delimiter;
+  /* 0 means no comments */
+  char comment;
+  /* output column of each field or -1 */
+  int *col_map;
+  int n_fields;
+  int columns;
+  /* without usecols each line must have exactly columns fields */
+  int strict;
+  npy_int64 line;
+  /* lines of the current chunk */
+  struct TextLine *lines;
+  npy_intp lines_capacity;
+} TextReader;
+
+typedef struct TextLine
+{
+  const char *start;
+  const char *end;
+  npy_int64 line;
+} TextLine;
+
+typedef struct
+{
+  const TextReader *reader;
+  const TextLine *lines;
+  char *out;
+  npy_intp row_stride;
+  npy_intp itemsize;
+  int type_num;
+  npy_intp error_index;
+} ParseTask;
+
+static const double exact_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static int is_digit (char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+static int is_space (char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+static int parse_double_slow (const char *p, const char *end, double *out)
+{
+  char buf[READER_MAX_NUMBER];
+  char *tail = NULL;
+  size_t len = end - p;
+
+  if (len >= READER_MAX_NUMBER)
+    {
+      return -1;
+    }
+  memcpy (buf, p, len);
+  buf[len] = '\0';
+  *out = strtod (buf, &tail);
+  return tail == buf + len ? 0 : -1;
+}
+
+/*
+ * Decimal numbers with up to 19 significant digits and small exponent are converted exactly
+ * with a single multiplication or division, others fall back to strtod.
+ */
+static int parse_double (const char *p, const char *end, double *out)
+{
+  const char *s = p;
+  npy_uint64 mantissa = 0;
+  int digits = 0;
+  int exp10 = 0;
+  int any = 0;
+  int inexact = 0;
+  int negative = 0;
+
+  if (s < end && (*s == '+' || *s == '-'))
+    {
+      negative = *s == '-';
+      ++s;
+    }
+  for (; s < end && is_digit (*s); ++s, any = 1)
+    {
+      if (digits < 19)
+        {
+          mantissa = mantissa * 10 + (*s - '0');
+          digits += mantissa != 0;
+        }
+      else
+        {
+          ++exp10;
+          inexact |= *s != '0';
+        }
+    }
+  if (s < end && *s == '.')
+    {
+      for (++s; s < end && is_digit (*s); ++s, any = 1)
+        {
+          if (digits < 19)
+            {
+              mantissa = mantissa * 10 + (*s - '0');
+              digits += mantissa != 0;
+              --exp10;
+            }
+          else
+            {
+              inexact |= *s != '0';
+            }
+        }
+    }
+  if (!any)
+    {
+      // nan, inf
+      return parse_double_slow (p, end, out);
+    }
+  if (s < end && (*s == 'e' || *s == 'E'))
+    {
+      int exp_negative = 0;
+      int exp = 0;
+
+      ++s;
+      if (s < end && (*s == '+' || *s == '-'))
+        {
+          exp_negative = *s == '-';
+          ++s;
+        }
+      if (s == end || !is_digit (*s))
+        {
+          return -1;
+        }
+      for (; s < end && is_digit (*s); ++s)
+        {
+          if (exp < 100000)
+            {
+              exp = exp * 10 + (*s - '0');
+            }
+        }
+      exp10 += exp_negative ? -exp : exp;
+    }
+  if (s != end)
+    {
+      return -1;
+    }
+
+  if (!inexact && mantissa <= ((npy_uint64) 1 << 53) && exp10 >= -22 && exp10 <= 22)
+    {
+      double value = (double) mantissa;
+      value = exp10 < 0 ? value / exact_pow10[-exp10] : value * exact_pow10[exp10];
+      *out = negative ? -value : value;
+      return 0;
+    }
+  if (mantissa == 0 && !inexact)
+    {
+      *out = negative ? -0.0 : 0.0;
+      return 0;
+    }
+  return parse_double_slow (p, end, out);
+}
+
+static int parse_int64 (const char *p, const char *end, npy_int64 *out)
+{
+  const char *s = p;
+  npy_uint64 value = 0;
+  npy_uint64 limit = (npy_uint64) NPY_MAX_INT64;
+  int negative = 0;
+
+  if (s < end && (*s == '+' || *s == '-'))
+    {
+      negative = *s == '-';
+      limit += negative;
+      ++s;
+    }
+  if (s == end)
+    {
+      return -1;
+    }
+  for (; s < end; ++s)
+    {
+      if (!is_digit (*s) || value > (limit - (*s - '0')) / 10)
+        {
+          return -1;
+        }
+      value = value * 10 + (*s - '0');
+    }
+  *out = negative ? (npy_int64) (0 - value) : (npy_int64) value;
+  return 0;
+}
+
+static int parse_value (const char *p, const char *end, int type_num, char *dst)
+{
+  double d;
+  npy_int64 j;
+
+  switch (type_num)
+    {
+      case NPY_FLOAT64:
+        if (parse_double (p, end, &d) < 0)
+          {
+            return -1;
+          }
+      *(npy_float64 *) dst = d;
+      return 0;
+      case NPY_FLOAT32:
+        if (parse_double (p, end, &d) < 0)
+          {
+            return -1;
+          }
+      *(npy_float32 *) dst = (npy_float32) d;
+      return 0;
+      default:
+        break;
+    }
+
+  if (parse_int64 (p, end, &j) < 0)
+    {
+      return -1;
+    }
+  switch (type_num)
+    {
+      case NPY_INT64: *(npy_int64 *) dst = j;
+      return 0;
+      case NPY_INT32:
+        if (j < NPY_MIN_INT32 || j > NPY_MAX_INT32)
+          {
+            return -1;
+          }
+      *(npy_int32 *) dst = (npy_int32) j;
+      return 0;
+      case NPY_INT16:
+        if (j < NPY_MIN_INT16 || j > NPY_MAX_INT16)
+          {
+            return -1;
+          }
+      *(npy_int16 *) dst = (npy_int16) j;
+      return 0;
+      case NPY_INT8:
+        if (j < NPY_MIN_INT8 || j > NPY_MAX_INT8)
+          {
+            return -1;
+          }
+      *(npy_int8 *) dst = (npy_int8) j;
+      return 0;
+      default: return -1;
+    }
+}
+
+/* Finds end of the field which begins at p. */
+static const char *field_end (const TextReader *reader, const char *p, const char *end)
+{
+  while (p < end && *p != reader->comment
+         && (reader->delimiter ? *p != reader->delimiter : !is_space (*p)))
+    {
+      ++p;
+    }
+  return p;
+}
+
+/*
+ * Parses line into row, on failure returns -1 and writes message to error if it is not null.
+ */
+static int parse_line (const TextReader *reader, const TextLine *line, char *row, npy_intp itemsize,
+                       int type_num, char *error, size_t error_len)
+{
+  const char *p = line->start;
+  const char *end = line->end;
+  int field = 0;
+  int filled = 0;
+
+  for (;;)
+    {
+      const char *start = NULL;
+      const char *stop = NULL;
+
+      while (p < end && is_space (*p) && *p != reader->delimiter)
+        {
+          ++p;
+        }
+      if (p == end || *p == reader->comment)
+        {
+          if (reader->delimiter && field > 0)
+            {
+              if (error)
+                {
+                  snprintf (error, error_len, "Empty field %d at line %lld.", field, (long long) line->line);
+                }
+              return -1;
+            }
+          break;
+        }
+
+      start = p;
+      p = field_end (reader, p, end);
+      stop = p;
+      while (stop > start && is_space (stop[-1]))
+        {
+          --stop;
+        }
+
+      if (field < reader->n_fields && reader->col_map[field] >= 0)
+        {
+          if (parse_value (start, stop, type_num, row + reader->col_map[field] * itemsize) < 0)
+            {
+              if (error)
+                {
+                  snprintf (error, error_len, "Could not convert '%.*s' at line %lld.",
+                            (int) (stop - start < 64 ? stop - start : 64), start, (long long) line->line);
+                }
+              return -1;
+            }
+          ++filled;
+        }
+      ++field;
+
+      if (reader->delimiter)
+        {
+          if (p < end && *p == reader->delimiter)
+            {
+              ++p;
+              continue;
+            }
+          break;
+        }
+    }
+
+  if (filled != reader->columns || (reader->strict && field != reader->columns))
+    {
+      if (error)
+        {
+          snprintf (error, error_len, "Wrong number of columns at line %lld: expected %d, found %d.",
+                    (long long) line->line, reader->columns, field);
+        }
+      return -1;
+    }
+  return 0;
+}
+
+static void parse_lines_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  ParseTask *task = ctx;
+
+  for (Py_ssize_t i = begin; i < end; ++i)
+    {
+      if (parse_line (task->reader, task->lines + i, task->out + i * task->row_stride, task->itemsize,
+                      task->type_num, NULL, 0) < 0)
+        {
+          // keep the first failed line
+          npy_intp expected = __atomic_load_n (&task->error_index, __ATOMIC_RELAXED);
+          while ((expected < 0 || expected > i)
+                 && !__atomic_compare_exchange_n (&task->error_index, &expected, i, 0,
+                                                  __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+            }
+          return;
+        }
+    }
+}
+
+/* Reads more data into buffer, returns -1 on error. */
+static int reader_fill (TextReader *reader)
+{
+  size_t n = 0;
+
+  if (reader->begin > 0)
+    {
+      memmove (reader->buf, reader->buf + reader->begin, reader->end - reader->begin);
+      reader->end -= reader->begin;
+      reader->begin = 0;
+    }
+  if (reader->end == reader->capacity)
+    {
+      // line is longer than the buffer
+      char *buf = realloc (reader->buf, reader->capacity * 2);
+      if (buf == NULL)
+        {
+          return -1;
+        }
+      reader->buf = buf;
+      reader->capacity *= 2;
+    }
+
+  n = fread (reader->buf + reader->end, 1, reader->capacity - reader->end, reader->file);
+  reader->end += n;
+  if (n == 0)
+    {
+      if (ferror (reader->file))
+        {
+          return -1;
+        }
+      reader->eof = 1;
+    }
+  return 0;
+}
+
+/* Returns end of the complete lines in the buffer. */
+static size_t reader_complete (const TextReader *reader)
+{
+  size_t limit = reader->end;
+
+  if (reader->eof)
+    {
+      return limit;
+    }
+  while (limit > reader->begin && reader->buf[limit - 1] != '\n')
+    {
+      --limit;
+    }
+  return limit;
+}
+
+static int is_data_line (const TextReader *reader, const char *p, const char *end)
+{
+  while (p < end && is_space (*p))
+    {
+      ++p;
+    }
+  return p < end && *p != reader->comment;
+}
+
+/*
+ * Collects up to max_lines data lines from complete lines of the buffer.
+ * Returns number of lines and moves begin after the last consumed line.
+ */
+static npy_intp reader_scan (TextReader *reader, TextLine *lines, npy_intp max_lines)
+{
+  size_t limit = reader_complete (reader);
+  const char *p = reader->buf + reader->begin;
+  const char *stop = reader->buf + limit;
+  npy_intp n = 0;
+
+  while (p < stop && n < max_lines)
+    {
+      const char *eol = memchr (p, '\n', stop - p);
+      const char *next = eol != NULL ? eol + 1 : stop;
+      const char *end = eol != NULL ? eol : stop;
+
+      ++reader->line;
+      if (is_data_line (reader, p, end))
+        {
+          lines[n].start = p;
+          lines[n].end = end;
+          lines[n].line = reader->line;
+          ++n;
+        }
+      p = next;
+    }
+
+  reader->begin = p - reader->buf;
+  return n;
+}
+
+static int count_fields (const TextReader *reader, const char *p, const char *end)
+{
+  int fields = 0;
+
+  for (;;)
+    {
+      while (p < end && is_space (*p) && *p != reader->delimiter)
+        {
+          ++p;
+        }
+      if (p == end || *p == reader->comment)
+        {
+          break;
+        }
+      p = field_end (reader, p, end);
+      ++fields;
+      if (reader->delimiter)
+        {
+          if (p < end && *p == reader->delimiter)
+            {
+              ++p;
+              continue;
+            }
+          break;
+        }
+    }
+  return fields;
+}
+
+static void reader_free (TextReader *reader)
+{
+  if (reader->file != NULL)
+    {
+      fclose (reader->file);
+    }
+  free (reader->buf);
+  free (reader->col_map);
+  free (reader->lines);
+  free (reader);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_TextReader
+ * Method:    readerOpen
+ * Signature: (Ljava/lang/String;CCI[I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jetbrains_numkt_TextReader_readerOpen
+    (JNIEnv *env, jobject jobj, jstring jpath, jchar delimiter, jchar comment, jint skiprows, jintArray usecols)
+{
+  const char *path = jstring_to_char (env, jpath);
+  TextReader *reader = calloc (1, sizeof (TextReader));
+  TextLine first;
+  npy_intp found = 0;
+  int fields = 0;
+
+  if (reader == NULL)
+    {
+      release_utf_char (env, jpath, path);
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Not enough memory for text reader.");
+      return 0;
+    }
+  if (delimiter > 127 || comment > 127)
+    {
+      release_utf_char (env, jpath, path);
+      free (reader);
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Delimiter and comment must be ASCII characters.");
+      return 0;
+    }
+
+  reader->delimiter = (char) delimiter;
+  reader->comment = (char) comment;
+  reader->file = fopen (path, "rb");
+  reader->capacity = READER_BUFFER_SIZE;
+  reader->buf = malloc (reader->capacity);
+  release_utf_char (env, jpath, path);
+
+  if (reader->file == NULL || reader->buf == NULL)
+    {
+      reader_free (reader);
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Cannot open file for reading.");
+      return 0;
+    }
+
+  // skip rows, then find the first data line to count its fields
+  for (;;)
+    {
+      size_t limit = reader_complete (reader);
+      while (skiprows > 0 && reader->begin < limit)
+        {
+          const char *p = reader->buf + reader->begin;
+          const char *eol = memchr (p, '\n', limit - reader->begin);
+          reader->begin = eol != NULL ? (size_t) (eol + 1 - reader->buf) : limit;
+          ++reader->line;
+          --skiprows;
+        }
+      if (skiprows == 0)
+        {
+          npy_int64 line = reader->line;
+          size_t begin = reader->begin;
+
+          found = reader_scan (reader, &first, 1);
+          if (found)
+            {
+              fields = count_fields (reader, first.start, first.end);
+              // the line is parsed again by the first read
+              reader->line = line;
+              reader->begin = begin;
+              break;
+            }
+        }
+      if (reader->eof)
+        {
+          break;
+        }
+      if (reader_fill (reader) < 0)
+        {
+          reader_free (reader);
+          (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Error reading file.");
+          return 0;
+        }
+    }
+
+  if (usecols != NULL)
+    {
+      jsize n = (*env)->GetArrayLength (env, usecols);
+      jint *cols = (*env)->GetIntArrayElements (env, usecols, NULL);
+      int max_field = 0;
+
+      for (jsize i = 0; i < n; ++i)
+        {
+          int col = cols[i] < 0 ? cols[i] + fields : cols[i];
+          if (col < 0)
+            {
+              (*env)->ReleaseIntArrayElements (env, usecols, cols, JNI_ABORT);
+              reader_free (reader);
+              (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Column index in usecols is out of range.");
+              return 0;
+            }
+          max_field = col + 1 > max_field ? col + 1 : max_field;
+        }
+
+      reader->n_fields = max_field;
+      reader->columns = n;
+      reader->col_map = malloc ((max_field ? max_field : 1) * sizeof (int));
+      for (int i = 0; i < max_field; ++i)
+        {
+          reader->col_map[i] = -1;
+        }
+      for (jsize i = 0; i < n; ++i)
+        {
+          int col = cols[i] < 0 ? cols[i] + fields : cols[i];
+          // a field goes to one column, also when a negative index names it again
+          if (reader->col_map[col] >= 0)
+            {
+              (*env)->ReleaseIntArrayElements (env, usecols, cols, JNI_ABORT);
+              reader_free (reader);
+              (*env)->ThrowNew (env, ILLEGAL_ARGUMENT_TYPE, "Duplicate column index in usecols.");
+              return 0;
+            }
+          reader->col_map[col] = i;
+        }
+      (*env)->ReleaseIntArrayElements (env, usecols, cols, JNI_ABORT);
+    }
+  else
+    {
+      reader->strict = 1;
+      reader->n_fields = fields;
+      reader->columns = fields;
+      reader->col_map = malloc ((fields ? fields : 1) * sizeof (int));
+      for (int i = 0; i < fields; ++i)
+        {
+          reader->col_map[i] = i;
+        }
+    }
+
+  return (jlong) reader;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_TextReader
+ * Method:    readerColumns
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_TextReader_readerColumns
+    (JNIEnv *env, jobject jobj, jlong ptr)
+{
+  return ((TextReader *) ptr)->columns;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_TextReader
+ * Method:    readerRead
+ * Signature: (JLorg/jetbrains/numkt/core/KtNDArray;I)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_TextReader_readerRead
+    (JNIEnv *env, jobject jobj, jlong ptr, jobject jout, jint threads)
+{
+  TextReader *reader = (TextReader *) ptr;
+  PyArrayObject *out = numkt_core_KtNDArray_getPointer (env, jout);
+  ParseTask task;
+  npy_intp max_rows = 0;
+  npy_intp rows = 0;
+  char error[256];
+  int failed = 0;
+  int type_num = 0;
+
+  if (out == NULL || !PyArray_ISCARRAY (out))
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Output array must be C-contiguous and writeable.");
+      return 0;
+    }
+  type_num = PyArray_TYPE (out);
+  if (type_num != NPY_FLOAT64 && type_num != NPY_FLOAT32 && type_num != NPY_INT64
+      && type_num != NPY_INT32 && type_num != NPY_INT16 && type_num != NPY_INT8)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Unsupported type of output array.");
+      return 0;
+    }
+  if (!((PyArray_NDIM (out) == 2 && PyArray_DIM (out, 1) == reader->columns)
+        || (PyArray_NDIM (out) == 1 && reader->columns == 1)))
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Shape of output array does not match number of columns.");
+      return 0;
+    }
+
+  max_rows = PyArray_DIM (out, 0);
+  if (reader->lines_capacity < max_rows)
+    {
+      free (reader->lines);
+      reader->lines = malloc (max_rows * sizeof (TextLine));
+      reader->lines_capacity = reader->lines != NULL ? max_rows : 0;
+      if (reader->lines == NULL)
+        {
+          (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Not enough memory for text reader.");
+          return 0;
+        }
+    }
+
+  task.reader = reader;
+  task.lines = reader->lines;
+  task.itemsize = PyArray_ITEMSIZE (out);
+  task.row_stride = task.itemsize * reader->columns;
+  task.type_num = type_num;
+
+  Py_BEGIN_ALLOW_THREADS
+  while (rows < max_rows)
+    {
+      npy_intp n = reader_scan (reader, reader->lines, max_rows - rows);
+
+      if (n > 0)
+        {
+          task.out = PyArray_BYTES (out) + rows * task.row_stride;
+          task.error_index = -1;
+          if (threads == 1)
+            {
+              parse_lines_task (&task, 0, n);
+            }
+          else
+            {
+              thread_pool_parallel_for (n, READER_LINES_PER_TASK, parse_lines_task, &task);
+            }
+          if (task.error_index >= 0)
+            {
+              parse_line (reader, reader->lines + task.error_index, task.out, task.itemsize, type_num,
+                          error, sizeof (error));
+              failed = 1;
+              break;
+            }
+          rows += n;
+        }
+      else if (reader->eof)
+        {
+          break;
+        }
+      else if (reader_fill (reader) < 0)
+        {
+          snprintf (error, sizeof (error), "Error reading file.");
+          failed = 1;
+          break;
+        }
+    }
+  KTNUMPY_END_ALLOW_THREADS
+
+  if (failed)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, error);
+      return 0;
+    }
+
+  return (jint) rows;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_TextReader
+ * Method:    readerClose
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_TextReader_readerClose
+    (JNIEnv *env, jobject jobj, jlong ptr)
+{
+  reader_free ((TextReader *) ptr);
+}
@@ -0,0 +1,318 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#ifdef KTNUMPY_POSIX
+#include <pthread.h>
+#endif
+
+#ifdef KTNUMPY_POSIX
+
+/*
+ * Persistent pool of worker threads. A job splits range into chunks of grain size,
+ * workers and the calling thread take chunks until the range is exhausted.
+ * Only one job runs at a time, concurrent and nested calls run in the calling thread.
+ */
+
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+
+static pthread_t *workers = NULL;
+static int n_workers = -1;
+static int pin_workers = 0;
+static int shutdown_workers = 0;
+static unsigned long generation = 0;
+static int active_workers = 0;
+
+static __thread int in_worker = 0;
+
+static struct
+{
+  thread_pool_task task;
+  void *ctx;
+  Py_ssize_t n;
+  Py_ssize_t grain;
+  Py_ssize_t next;
+} job;
+
+static void run_chunks (void)
+{
+  for (;;)
+    {
+      Py_ssize_t begin = __atomic_fetch_add (&job.next, job.grain, __ATOMIC_RELAXED);
+      if (begin >= job.n)
+        {
+          break;
+        }
+      job.task (job.ctx, begin, begin + job.grain < job.n ? begin + job.grain : job.n);
+    }
+}
+
+static void *worker_main (void *arg)
+{
+  // generation at the moment of start, the next job may begin before the worker is scheduled
+  unsigned long seen = (unsigned long) (uintptr_t) arg;
+
+  in_worker = 1;
+
+  pthread_mutex_lock (&pool_mutex);
+  for (;;)
+    {
+      while (generation == seen && !shutdown_workers)
+        {
+          pthread_cond_wait (&work_cond, &pool_mutex);
+        }
+      if (shutdown_workers)
+        {
+          break;
+        }
+      seen = generation;
+      pthread_mutex_unlock (&pool_mutex);
+
+      run_chunks ();
+
+      pthread_mutex_lock (&pool_mutex);
+      if (--active_workers == 0)
+        {
+          pthread_cond_signal (&done_cond);
+        }
+    }
+  pthread_mutex_unlock (&pool_mutex);
+
+  return NULL;
+}
+
+static int default_threads (void)
+{
+  const char *env = getenv ("KTNUMPY_NUM_THREADS");
+  long n = env != NULL ? strtol (env, NULL, 10) : sysconf (_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int) n : 1;
+}
+
+static void stop_workers (void)
+{
+  pthread_mutex_lock (&pool_mutex);
+  shutdown_workers = 1;
+  pthread_cond_broadcast (&work_cond);
+  pthread_mutex_unlock (&pool_mutex);
+
+  for (int i = 0; i < n_workers; ++i)
+    {
+      pthread_join (workers[i], NULL);
+    }
+  free (workers);
+  workers = NULL;
+  n_workers = 0;
+  shutdown_workers = 0;
+}
+
+/* Binds the worker i to a processor of its own, the calling thread is left to the system. */
+static void pin_worker (int i)
+{
+#ifdef __linux__
+  long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+  cpu_set_t set;
+
+  CPU_ZERO (&set);
+  CPU_SET ((i + 1) % (cpus > 0 ? cpus : 1), &set);
+  pthread_setaffinity_np (workers[i], sizeof (cpu_set_t), &set);
+#endif
+}
+
+static void start_workers (int threads)
+{
+  workers = threads > 1 ? malloc ((threads - 1) * sizeof (pthread_t)) : NULL;
+  n_workers = 0;
+  for (int i = 0; workers != NULL && i < threads - 1; ++i)
+    {
+      if (pthread_create (&workers[n_workers], NULL, worker_main, (void *) (uintptr_t) generation) != 0)
+        {
+          break;
+        }
+      if (pin_workers)
+        {
+          pin_worker (n_workers);
+        }
+      ++n_workers;
+    }
+}
+
+/* Number of threads used by jobs, including the calling one. */
+int thread_pool_get_threads (void)
+{
+  int threads;
+
+  pthread_mutex_lock (&job_lock);
+  if (n_workers < 0)
+    {
+      start_workers (default_threads ());
+    }
+  threads = n_workers + 1;
+  pthread_mutex_unlock (&job_lock);
+
+  return threads;
+}
+
+void thread_pool_set_threads (int threads)
+{
+  pthread_mutex_lock (&job_lock);
+  if (n_workers >= 0)
+    {
+      stop_workers ();
+    }
+  start_workers (threads > 0 ? threads : default_threads ());
+  pthread_mutex_unlock (&job_lock);
+}
+
+/* Binds the workers to processors or lets them move, the workers are restarted. */
+void thread_pool_set_affinity (int pin)
+{
+  pthread_mutex_lock (&job_lock);
+  pin_workers = pin;
+  if (n_workers >= 0)
+    {
+      int threads = n_workers + 1;
+      stop_workers ();
+      start_workers (threads);
+    }
+  pthread_mutex_unlock (&job_lock);
+}
+
+int thread_pool_get_affinity (void)
+{
+  return pin_workers;
+}
+
+/* Calls task for chunks of [0, n), returns when all of them are processed. */
+void thread_pool_parallel_for (Py_ssize_t n, Py_ssize_t grain, thread_pool_task task, void *ctx)
+{
+  if (grain < 1)
+    {
+      grain = 1;
+    }
+  if (n <= grain || in_worker || pthread_mutex_trylock (&job_lock) != 0)
+    {
+      task (ctx, 0, n);
+      return;
+    }
+  if (n_workers < 0)
+    {
+      start_workers (default_threads ());
+    }
+  if (n_workers == 0)
+    {
+      pthread_mutex_unlock (&job_lock);
+      task (ctx, 0, n);
+      return;
+    }
+
+  job.task = task;
+  job.ctx = ctx;
+  job.n = n;
+  job.grain = grain;
+  job.next = 0;
+
+  pthread_mutex_lock (&pool_mutex);
+  active_workers = n_workers;
+  ++generation;
+  pthread_cond_broadcast (&work_cond);
+  pthread_mutex_unlock (&pool_mutex);
+
+  run_chunks ();
+
+  pthread_mutex_lock (&pool_mutex);
+  while (active_workers > 0)
+    {
+      pthread_cond_wait (&done_cond, &pool_mutex);
+    }
+  pthread_mutex_unlock (&pool_mutex);
+
+  pthread_mutex_unlock (&job_lock);
+}
+
+#else
+
+int thread_pool_get_threads (void)
+{
+  return 1;
+}
+
+void thread_pool_set_threads (int threads)
+{
+}
+
+void thread_pool_set_affinity (int pin)
+{
+}
+
+int thread_pool_get_affinity (void)
+{
+  return 0;
+}
+
+void thread_pool_parallel_for (Py_ssize_t n, Py_ssize_t grain, thread_pool_task task, void *ctx)
+{
+  task (ctx, 0, n);
+}
+
+#endif // KTNUMPY_POSIX
+
+/*
+ * Class:     org_jetbrains_numkt_Parallel
+ * Method:    getThreads
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_Parallel_getThreads
+    (JNIEnv *env, jclass jcl)
+{
+  return thread_pool_get_threads ();
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Parallel
+ * Method:    setThreads
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Parallel_setThreads
+    (JNIEnv *env, jclass jcl, jint threads)
+{
+  thread_pool_set_threads (threads);
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Parallel
+ * Method:    getAffinity
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jetbrains_numkt_Parallel_getAffinity
+    (JNIEnv *env, jclass jcl)
+{
+  return (jboolean) thread_pool_get_affinity ();
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Parallel
+ * Method:    setAffinity
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_Parallel_setAffinity
+    (JNIEnv *env, jclass jcl, jboolean pin)
+{
+  thread_pool_set_affinity (pin);
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+#include <numpy/ufuncobject.h>
+
+/*
+ * Elementwise ufuncs of large arrays on the thread pool. The arrays are cut into chunks and numpy's
+ * own inner loop for the type, vectorized where the processor allows, runs on every chunk with the GIL
+ * released. Arrays of one or two floating inputs of the same type, shape and contiguous layout are
+ * handled, anything else is left to numpy. Floating point warnings of numpy are not raised here.
+ */
+
+/* Elements of a chunk processed by one task. */
+#define UFUNC_GRAIN (1 << 14)
+
+/* Inputs and the output. */
+#define UFUNC_MAXARGS 3
+
+typedef struct
+{
+  PyUFuncGenericFunction function;
+  void *data;
+  int nargs;
+  char *args[UFUNC_MAXARGS];
+  npy_intp steps[UFUNC_MAXARGS];
+} UfuncChunks;
+
+static void ufunc_task (void *ctx, Py_ssize_t begin, Py_ssize_t end)
+{
+  UfuncChunks *chunks = (UfuncChunks *) ctx;
+  char *args[UFUNC_MAXARGS];
+  npy_intp n = end - begin;
+
+  for (int i = 0; i < chunks->nargs; ++i)
+    {
+      args[i] = chunks->args[i] + begin * chunks->steps[i];
+    }
+  chunks->function (args, &n, chunks->steps, chunks->data);
+}
+
+/* Index of the loop for the inputs of type num and the output of the same type, -1 if there is none. */
+static int ufunc_loop (PyUFuncObject *ufunc, int num)
+{
+  int nargs = ufunc->nin + ufunc->nout;
+
+  for (int i = 0; i < ufunc->ntypes; ++i)
+    {
+      int matches = ufunc->functions[i] != NULL;
+      for (int j = 0; j < nargs && matches; ++j)
+        {
+          matches = ufunc->types[i * nargs + j] == num;
+        }
+      if (matches)
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
+static int ufunc_same_layout (PyArrayObject *a, PyArrayObject *b)
+{
+  return PyArray_SAMESHAPE (a, b) && ((PyArray_IS_C_CONTIGUOUS (a) && PyArray_IS_C_CONTIGUOUS (b))
+                                      || (PyArray_IS_F_CONTIGUOUS (a) && PyArray_IS_F_CONTIGUOUS (b)));
+}
+
+static int ufunc_accepts (PyArrayObject *a, int num)
+{
+  // subclasses such as masked arrays wrap their results, numpy keeps them
+  return PyArray_CheckExact (a) && PyArray_TYPE (a) == num && PyArray_ISNBO (PyArray_DESCR (a)->byteorder)
+         && PyArray_ISALIGNED (a) && (PyArray_IS_C_CONTIGUOUS (a) || PyArray_IS_F_CONTIGUOUS (a));
+}
+
+/* An output overlapping an input is accepted only when it is the same memory, element by element. */
+static int ufunc_overlaps (PyArrayObject *out, PyArrayObject *in)
+{
+  char *o = PyArray_BYTES (out), *i = PyArray_BYTES (in);
+  npy_intp size = PyArray_NBYTES (out);
+
+  return o != i && o < i + size && i < o + size;
+}
+
+/*
+ * Runs the ufunc name on the inputs into out, a new array when out is NULL. Returns the output,
+ * NULL without an exception when the arrays are left to numpy.
+ */
+static PyArrayObject *ufunc_call (const char *name, PyArrayObject **in, int nin, PyArrayObject *out, int float64)
+{
+  PyObject *f = PyObject_GetAttrString (npModule, name);
+  PyUFuncObject *ufunc = (PyUFuncObject *) f;
+  UfuncChunks chunks;
+  npy_intp size = PyArray_SIZE (in[0]);
+  int num = PyArray_TYPE (in[0]);
+  int loop;
+
+  if (f == NULL)
+    {
+      return NULL;
+    }
+  if (!PyObject_TypeCheck (f, &PyUFunc_Type) || ufunc->nin != nin || ufunc->nout != 1 || size == 0
+      || (num != NPY_FLOAT64 && (num != NPY_FLOAT32 || float64)))
+    {
+      goto fallback;
+    }
+  for (int i = 0; i < nin; ++i)
+    {
+      if (!ufunc_accepts (in[i], num) || !ufunc_same_layout (in[0], in[i]))
+        {
+          goto fallback;
+        }
+    }
+  loop = ufunc_loop (ufunc, num);
+  if (loop < 0)
+    {
+      goto fallback;
+    }
+  if (out != NULL)
+    {
+      if (!ufunc_accepts (out, num) || !ufunc_same_layout (in[0], out) || !PyArray_ISWRITEABLE (out))
+        {
+          goto fallback;
+        }
+      for (int i = 0; i < nin; ++i)
+        {
+          if (ufunc_overlaps (out, in[i]))
+            {
+              goto fallback;
+            }
+        }
+      Py_INCREF (out);
+    }
+  else
+    {
+      Py_INCREF (PyArray_DESCR (in[0]));
+      out = (PyArrayObject *) PyArray_NewLikeArray (in[0], NPY_KEEPORDER, PyArray_DESCR (in[0]), 0);
+      if (out == NULL)
+        {
+          Py_DECREF (f);
+          return NULL;
+        }
+    }
+
+  chunks.function = ufunc->functions[loop];
+  chunks.data = ufunc->data != NULL ? ufunc->data[loop] : NULL;
+  chunks.nargs = nin + 1;
+  for (int i = 0; i < nin; ++i)
+    {
+      chunks.args[i] = PyArray_BYTES (in[i]);
+      chunks.steps[i] = PyArray_ITEMSIZE (in[i]);
+    }
+  chunks.args[nin] = PyArray_BYTES (out);
+  chunks.steps[nin] = PyArray_ITEMSIZE (out);
+
+  Py_BEGIN_ALLOW_THREADS
+  thread_pool_parallel_for (size, UFUNC_GRAIN, ufunc_task, &chunks);
+  KTNUMPY_END_ALLOW_THREADS
+
+  Py_DECREF (f);
+  return out;
+
+  fallback:
+  Py_DECREF (f);
+  return NULL;
+}
+
+/*
+ * Class:     org_jetbrains_numkt_Ufuncs
+ * Method:    callUfunc
+ * Signature: (Ljava/lang/String;[Lorg/jetbrains/numkt/core/KtNDArray;Lorg/jetbrains/numkt/core/KtNDArray;Z)Lorg/jetbrains/numkt/core/KtNDArray;
+ */
+JNIEXPORT jobject JNICALL Java_org_jetbrains_numkt_Ufuncs_callUfunc
+    (JNIEnv *env, jclass jcl, jstring jname, jobjectArray jargs, jobject jout, jboolean float64)
+{
+  NPY_IMPORT_ONCE (NULL)
+  if (PyUFunc_API == NULL)
+    {
+      import_umath1 (NULL);
+    }
+
+  PyArrayObject *in[UFUNC_MAXARGS - 1];
+  PyArrayObject *out = jout != NULL ? numkt_core_KtNDArray_getPointer (env, jout) : NULL;
+  PyArrayObject *res;
+  int nin = (*env)->GetArrayLength (env, jargs);
+  const char *name;
+  jobject result = NULL;
+
+  if (nin < 1 || nin > UFUNC_MAXARGS - 1)
+    {
+      return NULL;
+    }
+  for (int i = 0; i < nin; ++i)
+    {
+      jobject element = (*env)->GetObjectArrayElement (env, jargs, i);
+      in[i] = numkt_core_KtNDArray_getPointer (env, element);
+      (*env)->DeleteLocalRef (env, element);
+    }
+
+  name = jstring_to_char (env, jname);
+  res = ufunc_call (name, in, nin, out, float64);
+  release_utf_char (env, jname, name);
+
+  if (res != NULL)
+    {
+      // the output array given is returned as it is
+      if (res == out)
+        {
+          Py_DECREF (res);
+          result = jout;
+        }
+      else
+        {
+          result = new_ktndarray (env, res, NULL);
+        }
+    }
+  python_exception (env);
+
+  return result;
+}
@@ -19,6 +19,9 @@
 #define DEFINE_JAVA_CLASS_VAR(var, name) jclass var = NULL;
 JAVA_CLASS_TABLE(DEFINE_JAVA_CLASS_VAR)
 
+#define DEFINE_JAVA_METHOD_VAR(var, type, name, sig) jmethodID var = NULL;
+JAVA_METHOD_TABLE(DEFINE_JAVA_METHOD_VAR)
+
 #define DEFINE_PYTHON_DTYPE_VAR(var, name) PyObject *var = NULL;
 PYTHON_DTYPE (DEFINE_PYTHON_DTYPE_VAR)
 
@@ -92,6 +95,34 @@ PyObject *jclass_to_dtype (JNIEnv *env, jclass jcl)
     {
       return NP_UNICODE;
     }
+  else if ((*env)->IsAssignableFrom (env, HALF_TYPE, jcl))
+    {
+      return NP_FLOAT16;
+    }
+  else if ((*env)->IsAssignableFrom (env, UBYTE_TYPE, jcl))
+    {
+      return NP_UINT8;
+    }
+  else if ((*env)->IsAssignableFrom (env, USHORT_TYPE, jcl))
+    {
+      return NP_UINT16;
+    }
+  else if ((*env)->IsAssignableFrom (env, UINT_TYPE, jcl))
+    {
+      return NP_UINT32;
+    }
+  else if ((*env)->IsAssignableFrom (env, ULONG_TYPE, jcl))
+    {
+      return NP_UINT64;
+    }
+  else if ((*env)->IsAssignableFrom (env, COMPLEX_FLOAT_TYPE, jcl))
+    {
+      return NP_COMPLEX64;
+    }
+  else if ((*env)->IsAssignableFrom (env, COMPLEX_DOUBLE_TYPE, jcl))
+    {
+      return NP_COMPLEX128;
+    }
   else
     {
       (*env)->ThrowNew(env, NUMKTEXCEPTION_TYPE, "Error: Unknown type!");
@@ -146,6 +177,21 @@ int cache_java_class (JNIEnv *env)
   return 0;
 }
 
+#define CACHE_METHOD(var, type, name, sig)                \
+    if ((var) == NULL)                                    \
+      {                                                   \
+        (var) = (*env)->GetMethodID (env, type, name, sig); \
+        if ((*env)->ExceptionCheck (env))                 \
+          return -1;                                      \
+      }                                                   \
+
+int cache_java_methods (JNIEnv *env)
+{
+  JAVA_METHOD_TABLE (CACHE_METHOD)
+
+  return 0;
+}
+
 int cache_primitive_jarrays (JNIEnv *env)
 {
   jclass clazz = NULL;
@@ -167,4 +213,16 @@ int cache_python_dtype (PyObject *npModule)
   PYTHON_DTYPE (CACHE_DTYPE)
 
   return 0;
-}
\ No newline at end of file
+}
+
+/* Binds the natives of a class at startup, on failure they are left to the lookup by symbol name */
+int register_natives (JNIEnv *env, jclass clazz, const JNINativeMethod *methods, jint n)
+{
+  if ((*env)->RegisterNatives (env, clazz, methods, n) != JNI_OK)
+    {
+      (*env)->ExceptionClear (env);
+      fprintf (stderr, "Warning: natives are not registered.\n");
+      return -1;
+    }
+  return 0;
+}
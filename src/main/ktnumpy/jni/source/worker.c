@@ -0,0 +1,244 @@
+/*
+ * Copyright 2020 JetBrains s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ktnumpy_includes.h"
+
+#ifdef KTNUMPY_POSIX
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Framing of the worker protocol: 4-byte big-endian length and payload.
+ * The calls do not touch the interpreter, so any Java thread can talk to its worker.
+ */
+
+#ifdef KTNUMPY_POSIX
+
+#ifdef MSG_NOSIGNAL
+#define WORKER_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define WORKER_SEND_FLAGS 0
+#endif
+
+static void worker_throw_errno (JNIEnv *env, const char *what)
+{
+  char message[256];
+  snprintf (message, sizeof (message), "%s: %s.", what, strerror (errno));
+  (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, message);
+}
+
+static int worker_write (int fd, const char *buf, size_t len)
+{
+  while (len > 0)
+    {
+      ssize_t n = send (fd, buf, len, WORKER_SEND_FLAGS);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          return -1;
+        }
+      buf += n;
+      len -= (size_t) n;
+    }
+  return 0;
+}
+
+/* Returns 0 on success, 1 on end of stream and -1 on error. */
+static int worker_read (int fd, char *buf, size_t len)
+{
+  while (len > 0)
+    {
+      ssize_t n = recv (fd, buf, len, 0);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          return -1;
+        }
+      if (n == 0)
+        {
+          return 1;
+        }
+      buf += n;
+      len -= (size_t) n;
+    }
+  return 0;
+}
+
+#endif // KTNUMPY_POSIX
+
+/*
+ * Class:     org_jetbrains_numkt_WorkerSocket
+ * Method:    connect
+ * Signature: (Ljava/lang/String;)I
+ */
+JNIEXPORT jint JNICALL Java_org_jetbrains_numkt_WorkerSocket_connect
+    (JNIEnv *env, jclass jcl, jstring jpath)
+{
+#ifdef KTNUMPY_POSIX
+  const char *path = (*env)->GetStringUTFChars (env, jpath, NULL);
+  struct sockaddr_un addr;
+  int fd = -1;
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen (path) >= sizeof (addr.sun_path))
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Path of worker socket is too long.");
+      goto OUT;
+    }
+  strcpy (addr.sun_path, path);
+
+  fd = socket (AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    {
+      worker_throw_errno (env, "Cannot create worker socket");
+      goto OUT;
+    }
+#ifdef SO_NOSIGPIPE
+  {
+    int on = 1;
+    setsockopt (fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof (on));
+  }
+#endif
+  if (connect (fd, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+    {
+      worker_throw_errno (env, "Cannot connect to worker");
+      close (fd);
+      fd = -1;
+    }
+
+  OUT:
+  (*env)->ReleaseStringUTFChars (env, jpath, path);
+  return fd;
+#else
+  (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Worker processes are not supported on this platform.");
+  return -1;
+#endif
+}
+
+/*
+ * Class:     org_jetbrains_numkt_WorkerSocket
+ * Method:    send
+ * Signature: (I[B)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_WorkerSocket_send
+    (JNIEnv *env, jclass jcl, jint fd, jbyteArray message)
+{
+#ifdef KTNUMPY_POSIX
+  jsize length = (*env)->GetArrayLength (env, message);
+  char *frame = (char *) malloc ((size_t) length + 4);
+
+  if (frame == NULL)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Not enough memory for worker message.");
+      return;
+    }
+  frame[0] = (char) ((length >> 24) & 0xff);
+  frame[1] = (char) ((length >> 16) & 0xff);
+  frame[2] = (char) ((length >> 8) & 0xff);
+  frame[3] = (char) (length & 0xff);
+  (*env)->GetByteArrayRegion (env, message, 0, length, (jbyte *) (frame + 4));
+
+  if (worker_write (fd, frame, (size_t) length + 4) < 0)
+    {
+      worker_throw_errno (env, "Cannot send message to worker");
+    }
+  free (frame);
+#else
+  (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Worker processes are not supported on this platform.");
+#endif
+}
+
+/*
+ * Class:     org_jetbrains_numkt_WorkerSocket
+ * Method:    receive
+ * Signature: (I)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_org_jetbrains_numkt_WorkerSocket_receive
+    (JNIEnv *env, jclass jcl, jint fd)
+{
+#ifdef KTNUMPY_POSIX
+  unsigned char header[4];
+  jbyteArray result = NULL;
+  char *payload = NULL;
+  size_t length;
+  int res;
+
+  res = worker_read (fd, (char *) header, 4);
+  if (res == 0)
+    {
+      length = ((size_t) header[0] << 24) | ((size_t) header[1] << 16) | ((size_t) header[2] << 8) | header[3];
+      // a Java array holds at most INT32_MAX bytes
+      if (length > INT32_MAX)
+        {
+          (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Worker message is too long.");
+          return NULL;
+        }
+      payload = (char *) malloc (length > 0 ? length : 1);
+      if (payload == NULL)
+        {
+          (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Not enough memory for worker message.");
+          return NULL;
+        }
+      res = worker_read (fd, payload, length);
+    }
+
+  if (res < 0)
+    {
+      worker_throw_errno (env, "Cannot receive message from worker");
+    }
+  else if (res > 0)
+    {
+      (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Worker closed the connection.");
+    }
+  else
+    {
+      result = (*env)->NewByteArray (env, (jsize) length);
+      if (result != NULL)
+        {
+          (*env)->SetByteArrayRegion (env, result, 0, (jsize) length, (const jbyte *) payload);
+        }
+    }
+  free (payload);
+
+  return result;
+#else
+  (*env)->ThrowNew (env, NUMKTEXCEPTION_TYPE, "Worker processes are not supported on this platform.");
+  return NULL;
+#endif
+}
+
+/*
+ * Class:     org_jetbrains_numkt_WorkerSocket
+ * Method:    close
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_org_jetbrains_numkt_WorkerSocket_close
+    (JNIEnv *env, jclass jcl, jint fd)
+{
+#ifdef KTNUMPY_POSIX
+  close (fd);
+#endif
+}
@@ -0,0 +1,99 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.logic.allClose
+import org.jetbrains.numkt.random.Random
+import org.jetbrains.numkt.statistics.*
+import kotlin.math.abs
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class TestAccumulators {
+
+    @Test
+    fun testMomentsMergeMatchesWhole() {
+        val x = Random.randomSample(100000, 3)
+        val first = StreamingMoments(3, ddof = 1)
+        val second = StreamingMoments(3, ddof = 1)
+        first.update(x[0 until 30000])
+        second.update(x[30000 until 70000])
+        second.update(x[70000 until 100000])
+        first.merge(second)
+
+        val moments = first.result()
+        assertEquals(array(arrayOf(100000L, 100000L, 100000L)), moments.count)
+        assertTrue(allClose(mean(x, 0), moments.mean))
+        assertTrue(allClose(`var`(x, 0, ddof = 1), moments.variance))
+        assertTrue(allClose(amin(x, 0), moments.min))
+        assertTrue(allClose(amax(x, 0), moments.max))
+        first.close()
+        second.close()
+    }
+
+    @Test
+    fun testMomentsSkipNaN() {
+        StreamingMoments().use {
+            it.update(array(arrayOf(1.0, Double.NaN, 3.0)))
+            val moments = it.result()
+            assertEquals(2L, moments.count[0].scalar)
+            assertEquals(2.0, moments.mean[0].scalar)
+            assertEquals(1.0, moments.variance[0].scalar)
+        }
+    }
+
+    @Test
+    fun testCovariance() {
+        val x = Random.randomSample(20000, 4)
+        StreamingCovariance(4).use {
+            it.update(x[0 until 5000])
+            it.update(x[5000 until 20000])
+            assertEquals(20000L, it.count)
+            assertTrue(allClose(cov(x, rowvar = false), it.result()))
+            assertTrue(allClose(mean(x, 0), it.mean()))
+        }
+    }
+
+    @Test
+    fun testHistogram() {
+        StreamingHistogram(2, 0.0, 2.0).use {
+            it.update(array(arrayOf(0.0, 0.5, 1.0, 1.5)))
+            it.update(array(arrayOf(2.0, 3.0, -1.0, Double.NaN)))
+            val (counts, edges) = it.result()
+            assertEquals(array(arrayOf(2L, 3L)), counts)
+            assertEquals(array(arrayOf(0.0, 1.0, 2.0)), edges)
+            assertEquals(1L, it.underflow)
+            assertEquals(1L, it.overflow)
+        }
+        assertFailsWith<NumKtException> { StreamingHistogram(2, 1.0, 1.0) }
+    }
+
+    @Test
+    fun testQuantiles() {
+        val x = Random.randomSample(200000)
+        val first = StreamingQuantiles(doubleArrayOf(0.01, 0.5, 0.99))
+        val second = StreamingQuantiles(doubleArrayOf(0.01, 0.5, 0.99))
+        first.update(x[0 until 50000])
+        second.update(x[50000 until 200000])
+        first.merge(second)
+
+        assertEquals(200000L, first.count)
+        val result = first.result()
+        for ((i, q) in first.probabilities.withIndex()) {
+            assertTrue(abs(quantile(x, q) - result[i]) < 0.005)
+        }
+        assertEquals(amin(x), first.quantile(0.0))
+        assertEquals(amax(x), first.quantile(1.0))
+        first.close()
+        second.close()
+    }
+
+    @Test
+    fun testMergeDifferentParameters() {
+        val first = StreamingMoments(2)
+        val second = StreamingMoments(3)
+        assertFailsWith<NumKtException> { first.merge(second) }
+        assertFailsWith<IllegalArgumentException> { first.merge(first) }
+        first.close()
+        second.close()
+    }
+}
@@ -257,4 +257,15 @@ class TestArrayCreation {
         assertEquals(check, bmat(data))
         assertEquals(check1, bmat(data1))
     }
+
+    @Test
+    fun testCreateFromMixedBoxedList() {
+        val values = listOf<Any>(1.toByte(), 2.toShort(), 3, 4L, 5f, 6.0, 7, 8.0, 9.toByte(), 10L)
+        val a = array<Double>(values)
+        assertEquals(array(Array(10) { it + 1.0 }), a)
+
+        val b = array<Double>(listOf(values, values.reversed()))
+        assertTrue(intArrayOf(2, 10).contentEquals(b.shape))
+        assertEquals(a, b[0])
+    }
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+import org.apache.arrow.memory.RootAllocator
+import org.apache.arrow.vector.Float8Vector
+import org.apache.arrow.vector.IntVector
+import org.apache.arrow.vector.complex.FixedSizeListVector
+import org.apache.arrow.vector.types.pojo.ArrowType
+import org.apache.arrow.vector.types.pojo.FieldType
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.core.reshape
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class TestArrow {
+
+    @Test
+    fun testFromArrowVector() {
+        RootAllocator().use { allocator ->
+            val a = Float8Vector("a", allocator).use { vector ->
+                vector.allocateNew(4)
+                for (i in 0 until 4) vector[i] = i * 1.5
+                vector.valueCount = 4
+                KtNDArray.fromArrowVector<Double>(vector, allocator)
+            }
+            assertEquals(array(arrayOf(0.0, 1.5, 3.0, 4.5)), a)
+            assertTrue(a.data!!.isDirect)
+        }
+    }
+
+    @Test
+    fun testFixedSizeList() {
+        RootAllocator().use { allocator ->
+            val fieldType = FieldType.nullable(ArrowType.FixedSizeList(3))
+            val a = FixedSizeListVector("m", allocator, fieldType, null).use { vector ->
+                vector.addOrGetVector<IntVector>(FieldType.nullable(ArrowType.Int(32, true)))
+                val values = vector.dataVector as IntVector
+                vector.allocateNew()
+                for (i in 0 until 6) values.setSafe(i, i)
+                values.valueCount = 6
+                vector.setNotNull(0)
+                vector.setNotNull(1)
+                vector.valueCount = 2
+                KtNDArray.fromArrowVector<Int>(vector, allocator)
+            }
+            assertEquals(arange(6).reshape(2, 3), a)
+        }
+    }
+
+    @Test
+    fun testToArrowArray() {
+        RootAllocator().use { allocator ->
+            val a = arange(12L).reshape(4, 3)
+            a.toArrowArray(allocator).use { vector ->
+                vector as FixedSizeListVector
+                assertEquals(4, vector.valueCount)
+                assertEquals(listOf(3L, 4L, 5L), vector.getObject(1))
+            }
+
+            arange(5.0).toArrowArray(allocator).use { vector ->
+                vector as Float8Vector
+                assertFalse(vector.isNull(2))
+                assertEquals(4.0, vector[4])
+                assertEquals(arange(5.0), KtNDArray.fromArrowVector(vector, allocator))
+            }
+        }
+    }
+
+    @Test
+    fun testNulls() {
+        RootAllocator().use { allocator ->
+            IntVector("n", allocator).use { vector ->
+                vector.allocateNew(3)
+                vector[0] = 1
+                vector.setNull(1)
+                vector[2] = 3
+                vector.valueCount = 3
+
+                val a = KtNDArray.fromArrowVector<Int>(vector, allocator)
+                assertEquals(
+                    array(arrayOf(false, true, false)),
+                    callFunc(nameMethod = arrayOf("ma", "getmaskarray"), args = arrayOf(a))
+                )
+
+                a.toArrowArray(allocator).use { back ->
+                    assertTrue(back.isNull(1))
+                    assertEquals(3, (back as IntVector)[2])
+                }
+            }
+        }
+    }
+}
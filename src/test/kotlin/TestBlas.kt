@@ -0,0 +1,41 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.asType
+import org.jetbrains.numkt.linalg.Blas
+import org.jetbrains.numkt.linalg.matmul
+import org.jetbrains.numkt.logic.allClose
+import org.jetbrains.numkt.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class TestBlas : ThresholdFixture(Parallel::matmulBatchThreshold, threads = 4) {
+
+    @Test
+    fun testThreads() {
+        // numpy may be built without a BLAS which can be controlled
+        if (Blas.api == null) return
+        assertTrue(Blas.library!!.isNotEmpty())
+        val threads = Blas.threads
+        Blas.withThreads(1) {
+            assertEquals(1, Blas.threads)
+        }
+        assertEquals(threads, Blas.threads)
+    }
+
+    @Test
+    fun testBatchedMatmul() {
+        val a = Random.randomSample(1000, 8, 8)
+        val b = Random.randomSample(1000, 8, 5)
+        assertTrue(allClose(numpy { matmul(a, b) }, native { matmul(a, b) }))
+        val w = Random.randomSample(8, 3)
+        assertTrue(allClose(numpy { matmul(a, w) }, native { matmul(a, w) }))
+        val at = swapAxes(a, 1, 2)
+        assertTrue(allClose(numpy { matmul(at, a) }, native { matmul(at, a) }))
+        val c = Random.randomSample(3, 1, 4, 6)
+        val d = Random.randomSample(5, 6, 2)
+        assertEquals(numpy { matmul(c, d) }.shape.toList(), native { matmul(c, d) }.shape.toList())
+        assertTrue(allClose(numpy { matmul(c, d) }, native { matmul(c, d) }))
+        val f = a.asType<Double, Float>()
+        assertTrue(allClose(numpy { matmul(f, f) }, native { matmul(f, f) }, atol = 1e-5))
+    }
+}
@@ -0,0 +1,60 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.random.Random
+import java.lang.management.ManagementFactory
+import javax.management.ObjectName
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class TestCallMetrics {
+
+    private fun <R> measured(block: () -> R): R {
+        CallMetrics.enabled = true
+        CallMetrics.reset()
+        try {
+            return block()
+        } finally {
+            CallMetrics.enabled = false
+        }
+    }
+
+    @Test
+    fun testCounts() {
+        val x = Random.randomSample(1000)
+        val stats = measured {
+            repeat(10) { callFunc<Double>(arrayOf("cumsum"), args = arrayOf(x)) }
+            repeat(5) { callDouble(arrayOf("mean"), arrayOf(x)) }
+            assertFailsWith<NumKtException> { callDouble(arrayOf("mean"), arrayOf("a")) }
+            CallMetrics.calls.associateBy { it.function }
+        }
+
+        val cumsum = stats.getValue("cumsum")
+        assertEquals(10L, cumsum.calls)
+        assertEquals(0L, cumsum.errors)
+        assertTrue(cumsum.bytesAllocated >= 10L * 1000 * 8)
+        assertTrue(cumsum.p50Nanos in 1..cumsum.p99Nanos)
+        assertTrue(cumsum.convertNanos + cumsum.executeNanos + cumsum.wrapNanos <= cumsum.totalNanos)
+
+        val mean = stats.getValue("mean")
+        assertEquals(6L, mean.calls)
+        assertEquals(1L, mean.errors)
+    }
+
+    @Test
+    fun testDisabled() {
+        measured { }
+        callFunc<Double>(arrayOf("cumsum"), args = arrayOf(Random.randomSample(10)))
+        assertTrue(CallMetrics.calls.isEmpty())
+    }
+
+    @Test
+    fun testMBean() {
+        measured { callFunc<Double>(arrayOf("linalg", "norm"), args = arrayOf(Random.randomSample(10)), kClass = Double::class) }
+        val server = ManagementFactory.getPlatformMBeanServer()
+        val name = ObjectName("org.jetbrains.numkt:type=CallMetrics")
+        assertEquals(false, server.getAttribute(name, "Enabled"))
+        assertEquals(1, (server.getAttribute(name, "Calls") as Array<*>).size)
+        assertEquals(listOf("linalg.norm"), Interpreter.metrics().map { it.function })
+    }
+}
@@ -0,0 +1,67 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.*
+import org.jetbrains.numkt.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class TestDtypes {
+
+    @Test
+    fun testHalf() {
+        val values = floatArrayOf(0f, -0f, 1f, -2.5f, 65504f, 70000f, 6e-8f, 1e-9f, 0.1f)
+        val a = halfArray(values)
+        assertEquals(Half::class.java, a.dtype)
+        assertEquals(array(values.toTypedArray()).asType<Float, Half>(), a)
+
+        val widened = a.toFloatArray()
+        for (i in values.indices) {
+            val half = values[i].toHalf()
+            assertEquals(half.toFloat(), widened[i])
+            assertEquals(half, a.toList()[i])
+        }
+        assertEquals(Half.POSITIVE_INFINITY, 70000f.toHalf())
+        assertTrue(halfArray(floatArrayOf(Float.NaN)).toFloatArray()[0].isNaN())
+    }
+
+    @Test
+    fun testHalfBulk() {
+        val x = Random.randomSample(37, 19).asType<Double, Float>()
+        val h = x.asType<Float, Half>()
+        val expected = h.asType<Half, Float>()
+        assertTrue(expected.toList().toFloatArray().contentEquals(h.toFloatArray()))
+        assertTrue(expected.t.toList().toFloatArray().contentEquals(h.t.toFloatArray()))
+    }
+
+    @Test
+    fun testUnsigned() {
+        val bytes = ubyteArrayOf(0u, 1u, 127u, 128u, 255u)
+        val a = array(bytes)
+        assertEquals(UByte::class.javaObjectType, a.dtype)
+        assertTrue(bytes.contentEquals(a.toUByteArray()))
+        assertEquals(bytes.toList(), a.toList())
+        assertEquals(255.toUByte(), a[4].scalar)
+
+        val longs = ulongArrayOf(0u, ULong.MAX_VALUE, 1uL shl 63)
+        val b = array(longs)
+        assertTrue(longs.contentEquals(b.toULongArray()))
+        assertEquals(ULong.MAX_VALUE, b[1].scalar)
+
+        val c = array(uintArrayOf(1u, UInt.MAX_VALUE)).asType<UInt, Long>()
+        assertEquals(listOf(1L, 4294967295L), c.toList())
+        assertEquals(listOf<UShort>(3u, 65535u), array<UShort>(listOf(3.toUShort(), 65535.toUShort())).toList())
+    }
+
+    @Test
+    fun testComplex() {
+        val a = complexArray(floatArrayOf(1f, 2f, 3f, -4f, 0f, 0.5f))
+        assertEquals(ComplexFloat::class.java, a.dtype)
+        assertEquals(listOf(ComplexFloat(1f, 2f), ComplexFloat(3f, -4f), ComplexFloat(0f, 0.5f)), a.toList())
+        assertEquals(ComplexFloat(3f, -4f), a[1].scalar)
+        assertTrue(floatArrayOf(0f, 0.5f, 3f, -4f, 1f, 2f).contentEquals(a[None..None..-1].toFloatArray()))
+
+        val b = a.asType<ComplexFloat, ComplexDouble>()
+        assertTrue(doubleArrayOf(1.0, 2.0, 3.0, -4.0, 0.0, 0.5).contentEquals(b.toDoubleArray()))
+        assertEquals(b, array(arrayOf(ComplexDouble(1.0, 2.0), ComplexDouble(3.0, -4.0), ComplexDouble(0.0, 0.5))))
+    }
+}
@@ -0,0 +1,35 @@
+import org.jetbrains.numkt.*
+import kotlin.test.*
+
+class TestExceptions {
+
+    private fun argMaxOfEmpty(): NumKtException =
+        assertFailsWith { callLong(arrayOf("argmax"), arrayOf(empty<Double>(0))) }
+
+    @Test
+    fun testMessage() {
+        val e = argMaxOfEmpty()
+        assertEquals("<class 'ValueError'>: attempt to get argmax of an empty sequence", e.message)
+        assertEquals(e.message, e.message)
+        assertTrue(e.toString().endsWith(e.message!!))
+    }
+
+    @Test
+    fun testStackTrace() {
+        val e = argMaxOfEmpty()
+        val stack = e.stackTrace
+        // python frames first, then the java frames of the call
+        assertTrue(stack.first().fileName!!.endsWith(".py"))
+        assertTrue(stack.any { it.className == javaClass.name })
+        assertEquals(stack.size, e.stackTrace.size)
+    }
+
+    @Test
+    fun testUnrendered() {
+        // exceptions used for control flow are released without rendering
+        repeat(10_000) { argMaxOfEmpty() }
+        System.gc()
+        repeat(10) { argMaxOfEmpty() }
+        assertEquals("message", NumKtException("message").message)
+    }
+}
@@ -0,0 +1,97 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.ComplexDouble
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.fft.FFT
+import org.jetbrains.numkt.fft.Norm
+import org.jetbrains.numkt.math.minus
+import org.jetbrains.numkt.random.Random
+import kotlin.math.abs
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+class TestFFT {
+
+    private fun numpy(name: String, a: KtNDArray<*>, n: Int, axis: Int, norm: Norm): KtNDArray<Any> =
+        callFunc(nameMethod = arrayOf("fft", name), args = arrayOf(a, n, axis, norm.str))
+
+    private fun assertClose(expected: DoubleArray, actual: DoubleArray) {
+        assertEquals(expected.size, actual.size)
+        for (i in expected.indices) {
+            assertTrue(abs(expected[i] - actual[i]) < 1e-9, "$i: ${expected[i]} != ${actual[i]}")
+        }
+    }
+
+    @Suppress("UNCHECKED_CAST")
+    private fun assertComplexClose(expected: KtNDArray<*>, actual: KtNDArray<ComplexDouble>) {
+        assertEquals(expected.shape.toList(), actual.shape.toList())
+        assertClose((expected as KtNDArray<ComplexDouble>).toDoubleArray(), actual.toDoubleArray())
+    }
+
+    @Test
+    fun testAgainstNumpy() {
+        for (n in listOf(2, 8, 64, 1024)) {
+            for (norm in Norm.values()) {
+                val x = Random.randomSample(3, n) - 0.5
+                val z = FFT.fft(x)
+                assertComplexClose(numpy("fft", x, n, -1, norm), FFT.fft(x, norm = norm))
+                assertComplexClose(numpy("ifft", z, n, -1, norm), FFT.ifft(z, norm = norm))
+                assertComplexClose(numpy("rfft", x, n, -1, norm), FFT.rfft(x, norm = norm))
+                assertComplexClose(numpy("fft", x, 2 * n, -1, norm), FFT.fft(x, 2 * n, norm = norm))
+                assertComplexClose(numpy("rfft", x, n / 2, -1, norm), FFT.rfft(x, n / 2, norm = norm))
+            }
+        }
+    }
+
+    @Test
+    fun testRealRoundTrip() {
+        val x = Random.randomSample(5, 256)
+        val y = FFT.irfft(FFT.rfft(x))
+        assertEquals(x.shape.toList(), y.shape.toList())
+        assertClose(x.toList().toDoubleArray(), y.toList().toDoubleArray())
+        val ortho = FFT.irfft(FFT.rfft(x, norm = Norm.ORTHO), norm = Norm.ORTHO)
+        assertClose(x.toList().toDoubleArray(), ortho.toList().toDoubleArray())
+    }
+
+    @Test
+    fun testAxisAndOut() {
+        val x = Random.randomSample(32, 4)
+        val out = empty<ComplexDouble>(17, 4)
+        assertSame(out, FFT.rfft(x, axis = 0, out = out))
+        assertComplexClose(numpy("rfft", x, 32, 0, Norm.BACKWARD), out)
+
+        val transposed = empty<ComplexDouble>(4, 32).t
+        FFT.fft(x, axis = 0, out = transposed)
+        assertComplexClose(numpy("fft", x, 32, 0, Norm.BACKWARD), transposed)
+
+        val back = empty<Double>(32, 4)
+        FFT.irfft(out, axis = 0, out = back)
+        assertClose(x.toList().toDoubleArray(), back.toList().toDoubleArray())
+    }
+
+    @Test
+    fun testOtherLengthsAreLeftToNumpy() {
+        val x = Random.randomSample(4, 12)
+        assertComplexClose(numpy("rfft", x, 12, -1, Norm.BACKWARD), FFT.rfft(x))
+        val out = empty<ComplexDouble>(4, 12)
+        FFT.fft(x, out = out)
+        assertComplexClose(numpy("fft", x, 12, -1, Norm.BACKWARD), out)
+        assertEquals(listOf(4, 12), FFT.fft2(x).shape.toList())
+        assertEquals(listOf(4, 7), FFT.rfftn(x).shape.toList())
+    }
+
+    @Test
+    fun testPlanCache() {
+        FFT.clearPlans()
+        assertEquals(0, FFT.cachedPlans)
+        val x = Random.randomSample(8, 128)
+        repeat(3) { FFT.rfft(x) }
+        assertEquals(1, FFT.cachedPlans)
+        FFT.fft(x)
+        FFT.irfft(FFT.rfft(x))
+        assertEquals(3, FFT.cachedPlans)
+        repeat(40) { FFT.fft(Random.randomSample(2 shl it % 18)) }
+        assertTrue(FFT.cachedPlans <= 16)
+    }
+}
@@ -0,0 +1,81 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.core.None
+import org.jetbrains.numkt.math.*
+import org.jetbrains.numkt.random.Random
+import kotlin.test.*
+
+class TestForeignBridge {
+
+    // the backend needs Java 22, the tests pass without checks on older runtimes
+    private fun <R> ffm(block: (ForeignBridge) -> R): R? {
+        Interpreter.interpreter
+        return ForeignBridge.create()?.let(block)
+    }
+
+    @Test
+    fun testScalarResults() {
+        val x = Random.randomSample(100)
+        ffm { bridge ->
+            assertTrue(bridge.prepare(arrayOf("sum"), arrayOf(x)))
+            assertEquals(callDouble(arrayOf("sum"), arrayOf(x)), bridge.callDouble())
+            assertTrue(bridge.prepare(arrayOf("argmax"), arrayOf(x)))
+            assertEquals(callLong(arrayOf("argmax"), arrayOf(x)), bridge.callLong())
+            assertTrue(bridge.prepare(arrayOf("array_equal"), arrayOf(x, x)))
+            assertTrue(bridge.callBoolean())
+        }
+    }
+
+    @Test
+    fun testArrayResults() {
+        val x = Random.randomSample(5, 7)
+        ffm { bridge ->
+            assertTrue(bridge.prepare(arrayOf("add"), arrayOf(x, 2.0)))
+            val y = bridge.callArray<Double>()
+            assertEquals(x + 2.0, y)
+            assertEquals(x.shape.toList(), y.shape.toList())
+
+            assertTrue(bridge.prepare(arrayOf("linalg", "norm"), arrayOf(x)))
+            assertEquals(callDouble(arrayOf("linalg", "norm"), arrayOf(x)), bridge.callDouble())
+
+            assertTrue(bridge.prepare(arrayOf("transpose"), arrayOf(x)))
+            val t = bridge.callArray<Double>()
+            assertEquals(x.t, t)
+            assertEquals(x[1, 2], t[2, 1])
+        }
+    }
+
+    @Test
+    fun testArguments() {
+        ffm { bridge ->
+            assertTrue(bridge.prepare(arrayOf("arange"), arrayOf(1L, 10L, 3)))
+            assertEquals(arange<Long>(1L, 10L, 3L), bridge.callArray<Long>())
+            assertTrue(bridge.prepare(arrayOf("squeeze"), arrayOf(zeros<Double>(1, 3), None.none)))
+            assertEquals(listOf(3), bridge.callArray<Double>().shape.toList())
+            // strings and kwargs stay on JNI
+            assertFalse(bridge.prepare(arrayOf("sum"), arrayOf("x")))
+        }
+    }
+
+    @Test
+    fun testErrors() {
+        ffm { bridge ->
+            assertFailsWith<NumKtException> { bridge.prepare(arrayOf("no_such_function"), null) }
+            assertTrue(bridge.prepare(arrayOf("reshape"), arrayOf(zeros<Double>(6), 4L)))
+            assertFailsWith<NumKtException> { bridge.callArray<Double>() }
+        }
+    }
+
+    @Test
+    fun testNonArrayResult() {
+        val x = array(arrayOf(1.0, 2.0))
+        ffm { bridge ->
+            assertTrue(bridge.prepare(arrayOf("add"), arrayOf(1.0, 2.0)))
+            val r: KtNDArray<Double> = bridge.callArray()
+            assertTrue(r.isScalar())
+            assertEquals(3.0, r.scalar)
+            assertTrue(bridge.prepare(arrayOf("dot"), arrayOf(x, x)))
+            assertEquals(5.0, bridge.callArray<Double>().scalar)
+        }
+    }
+}
@@ -0,0 +1,44 @@
+import jdk.jfr.Recording
+import jdk.jfr.consumer.RecordingFile
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.fft.FFT
+import org.jetbrains.numkt.random.Random
+import java.nio.file.Files
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class TestJfr {
+
+    @Test
+    fun testEvents() {
+        val path = Files.createTempFile("numkt", ".jfr")
+        Recording().use { recording ->
+            for (name in listOf("NumpyCall", "GilWait", "NativeArrayAlloc", "NativeArrayFree", "NumpyException")) {
+                recording.enable("org.jetbrains.numkt.$name")
+            }
+            recording.start()
+            val x = Random.randomSample(20, 30)
+            callFunc<Double>(arrayOf("cumsum"), args = arrayOf(x))
+            assertFailsWith<NumKtException> { callDouble(arrayOf("mean"), arrayOf("a")) }
+            // a large batch releases the interpreter lock, the wait is reported with the next call
+            FFT.rfft(Random.randomSample(256, 1024))
+            callDouble(arrayOf("mean"), arrayOf(x))
+            recording.stop()
+            recording.dump(path)
+        }
+
+        val events = RecordingFile.readAllEvents(path).groupBy { it.eventType.name }
+        Files.delete(path)
+        val cumsum = events.getValue("org.jetbrains.numkt.NumpyCall").single { it.getString("function") == "cumsum" }
+        assertEquals("Double[20, 30]", cumsum.getString("arguments"))
+        assertEquals(20L * 30 * 8, cumsum.getLong("allocated"))
+        assertTrue(cumsum.getLong("execution") > 0)
+        assertTrue(events.getValue("org.jetbrains.numkt.NativeArrayAlloc").any { it.getString("shape") == "[600]" })
+        val exception = events.getValue("org.jetbrains.numkt.NumpyException").single()
+        assertEquals("mean", exception.getString("function"))
+        assertTrue(exception.getString("type").endsWith("Error"))
+        assertTrue(events.containsKey("org.jetbrains.numkt.GilWait"))
+    }
+}
@@ -0,0 +1,105 @@
+import org.jetbrains.numkt.NumKtException
+import org.jetbrains.numkt.empty
+import org.jetbrains.numkt.random.BitGenerator
+import org.jetbrains.numkt.random.Distribution
+import org.jetbrains.numkt.random.KtGenerator
+import org.jetbrains.numkt.random.Random
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import org.jetbrains.numkt.statistics.amax
+import org.jetbrains.numkt.statistics.amin
+import kotlin.concurrent.thread
+import kotlin.test.*
+
+class TestKtGenerator {
+
+    @Test
+    fun testSeedReproducibility() {
+        KtGenerator(42).use { a ->
+            KtGenerator(42).use { b ->
+                assertEquals(a.random<Double>(3, 4), b.random<Double>(3, 4))
+                assertEquals(a.standardNormal<Double>(10), b.standardNormal<Double>(10))
+            }
+        }
+        KtGenerator(42, BitGenerator.PHILOX).use { a ->
+            KtGenerator(43, BitGenerator.PHILOX).use { b ->
+                assertNotEquals(a.random<Double>(10), b.random<Double>(10))
+            }
+        }
+    }
+
+    @Test
+    fun testFillPreallocated() {
+        KtGenerator(7).use { g ->
+            val out = empty<Float>(1000)
+            g.random(out)
+            assertTrue(amin(out) >= 0f)
+            assertTrue(amax(out) < 1f)
+
+            val ints = empty<Int>(1000)
+            g.integers(ints, -3, 10)
+            assertEquals(-3, amin(ints))
+            assertEquals(9, amax(ints))
+
+            assertFailsWith<NumKtException> { g.integers(empty<Byte>(3), 0, 1000) }
+            assertFailsWith<NumKtException> { g.standardNormal(empty<Int>(3)) }
+        }
+    }
+
+    @Test
+    fun testSpawnAndJumped() {
+        KtGenerator(1).use { g ->
+            val (a, b) = g.spawn(2)
+            assertNotEquals(a.random<Double>(10), b.random<Double>(10))
+            assertNotEquals(g.jumped().random<Double>(10), g.random<Double>(10))
+        }
+    }
+
+    @Test
+    fun testThreadLocal() {
+        val generators = arrayOfNulls<KtGenerator>(2)
+        val threads = List(2) { i -> thread { generators[i] = KtGenerator.threadLocal() } }
+        threads.forEach { it.join() }
+        assertNotSame(generators[0], generators[1])
+        assertSame(KtGenerator.threadLocal(), KtGenerator.threadLocal())
+    }
+
+    @Test
+    fun testFillPrimitiveArrays() {
+        val a = DoubleArray(1_000_000)
+        val b = DoubleArray(1_000_000)
+        KtGenerator(5).use { it.fill(a, Distribution.normal(10.0, 2.0)) }
+        KtGenerator(5).use { it.fill(b, Distribution.normal(10.0, 2.0)) }
+        assertTrue(a.contentEquals(b))
+        assertTrue(kotlin.math.abs(a.average() - 10.0) < 0.01)
+
+        KtGenerator(5).use { g ->
+            val serial = DoubleArray(10)
+            g.fill(serial, Distribution.normal(10.0, 2.0), parallel = false)
+            assertTrue(serial.contentEquals(a.copyOf(10)))
+        }
+
+        val longs = LongArray(1000)
+        Random.fill(longs, -5, 5)
+        assertTrue(longs.all { it in -5 until 5 })
+
+        val floats = FloatArray(1000)
+        Random.fill(floats, Distribution.uniform(2.0, 3.0))
+        assertTrue(floats.all { it >= 2f && it <= 3f })
+        assertFailsWith<NumKtException> { Random.fill(longs, 5, 5) }
+    }
+
+    @Test
+    fun testFillDirectBuffer() {
+        val buffer = ByteBuffer.allocateDirect(8 * 100)
+        buffer.position(80)
+        Random.fill(buffer, Distribution.exponential(), KtGenerator(3))
+        assertEquals(buffer.limit(), buffer.position())
+
+        val doubles = buffer.duplicate().order(ByteOrder.nativeOrder()).apply { position(80) }.asDoubleBuffer()
+        val expected = DoubleArray(90).also { KtGenerator(3).fill(it, Distribution.exponential()) }
+        assertTrue(DoubleArray(90) { doubles[it] }.contentEquals(expected))
+
+        assertFailsWith<IllegalArgumentException> { Random.fill(ByteBuffer.allocate(16)) }
+    }
+}
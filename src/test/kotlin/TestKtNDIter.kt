@@ -0,0 +1,51 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.KtNDIter
+import org.jetbrains.numkt.core.reshape
+import kotlin.test.*
+
+class TestKtNDIter {
+
+    @Test
+    fun testMetadata() {
+        val a = arange(24L).reshape(2, 3, 4)
+        assertEquals(3, a.ndim)
+        assertEquals(24, a.size)
+        assertEquals(8, a.itemsize)
+        val f = zeros<Float>(5)
+        assertEquals(1, f.ndim)
+        assertEquals(5, f.size)
+        assertEquals(4, f.itemsize)
+    }
+
+    @Test
+    fun testStepping() {
+        val a = arange(6L).reshape(2, 3)
+        KtNDIter(a).use { iter ->
+            assertEquals(6, iter.iterSize)
+            assertEquals(2, iter.ndim)
+            var n = 0
+            do {
+                assertEquals(n, iter.iterIndex)
+                assertEquals(n, iter.index)
+                assertEquals(n.toLong(), iter.value)
+                n++
+            } while (iter.iterNext())
+            assertEquals(6, n)
+            assertTrue(iter.finished)
+            assertFailsWith<NumKtException> { iter.iterIndex }
+            assertFailsWith<NumKtException> { iter.index }
+            assertTrue(iter.reset())
+            assertFalse(iter.finished)
+            assertEquals(0, iter.iterIndex)
+        }
+    }
+
+    @Test
+    fun testClosed() {
+        val iter = KtNDIter(arange(3L))
+        iter.close()
+        assertFalse(iter.iterNext())
+        assertFailsWith<NumKtException> { iter.ndim }
+        assertFailsWith<NumKtException> { iter.iterSize }
+    }
+}
@@ -0,0 +1,80 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.linalg.Linalg
+import org.jetbrains.numkt.linalg.LinalgWorkspace
+import org.jetbrains.numkt.linalg.matmul
+import org.jetbrains.numkt.logic.allClose
+import org.jetbrains.numkt.math.*
+import org.jetbrains.numkt.random.Random
+import kotlin.math.abs
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+class TestLinalgWorkspace {
+
+    @Test
+    fun testSolve() {
+        LinalgWorkspace(50).use { ws ->
+            repeat(3) {
+                val a = Random.randomSample(50, 50)
+                val b = Random.randomSample(50)
+                val c = Random.randomSample(50, 3)
+                val x = ws.solve(a, b)
+                assertTrue(allClose(Linalg.solve(a, b), x))
+                // the result of the same shape is written to the same array
+                assertSame(x, ws.solve(a, b))
+                assertTrue(allClose(Linalg.solve(a, c), ws.solve(a, c)))
+                assertTrue(allClose(Linalg.solve(a.t, b), ws.solve(a.t, b)))
+                val out = empty<Double>(50)
+                assertSame(out, ws.solve(a, b, out))
+                assertTrue(allClose(Linalg.solve(a, b), out))
+            }
+        }
+    }
+
+    @Test
+    fun testDecompositions() {
+        val a = Random.randomSample(30, 30)
+        val s = matmul(a, a.t) + eye<Double>(30) * 30.0
+        LinalgWorkspace(30).use { ws ->
+            assertTrue(allClose(Linalg.inv(a), ws.inv(a)))
+            assertTrue(abs(Linalg.det(a) - ws.det(a)) <= 1e-8 * abs(Linalg.det(a)))
+            assertTrue(allClose(Linalg.cholesky(s), ws.cholesky(s)))
+            val (w, v) = ws.eigh(s)
+            assertTrue(allClose(Linalg.eigvalsh(s), w))
+            assertTrue(allClose(matmul(s, v), v * w))
+            assertEquals(0.0, ws.det(zeros<Double>(30, 30)))
+        }
+    }
+
+    @Test
+    fun testStacks() {
+        val a = Random.randomSample(200, 8, 8)
+        val b = Random.randomSample(200, 8, 2)
+        val threads = Parallel.threads
+        try {
+            LinalgWorkspace(8).use { ws ->
+                for (t in listOf(1, 4)) {
+                    Parallel.threads = t
+                    assertTrue(allClose(Linalg.solve(a, b), ws.solve(a, b)))
+                    assertTrue(allClose(Linalg.inv(a), ws.inv(a)))
+                }
+            }
+        } finally {
+            Parallel.threads = threads
+        }
+    }
+
+    @Test
+    fun testErrors() {
+        LinalgWorkspace(3).use { ws ->
+            assertFailsWith<NumKtException> { ws.solve(zeros<Double>(3, 3), ones<Double>(3)) }
+            assertFailsWith<NumKtException> { ws.cholesky(eye<Double>(3) * -1.0) }
+            assertFailsWith<NumKtException> { ws.solve(eye<Double>(4), ones<Double>(4)) }
+            assertFailsWith<NumKtException> { ws.solve(eye<Double>(3), ones<Double>(3), empty(4)) }
+        }
+        assertFailsWith<IllegalArgumentException> { LinalgWorkspace(0) }
+    }
+}
@@ -0,0 +1,56 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.logic.allClose
+import org.jetbrains.numkt.neighbors.Metric
+import org.jetbrains.numkt.neighbors.knn
+import org.jetbrains.numkt.neighbors.pairwiseDistances
+import org.jetbrains.numkt.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class TestNeighbors {
+
+    @Test
+    fun testPairwiseDistances() {
+        val x = array<Double>(listOf(listOf(0.0, 0.0), listOf(3.0, 4.0)))
+        val y = array<Double>(listOf(listOf(0.0, 0.0), listOf(1.0, 1.0), listOf(0.0, 2.0)))
+
+        assertTrue(allClose(array<Double>(listOf(listOf(0.0, 5.0), listOf(5.0, 0.0))), pairwiseDistances(x)))
+        assertTrue(
+            allClose(
+                array<Double>(listOf(listOf(0.0, 2.0, 2.0), listOf(7.0, 5.0, 5.0))),
+                pairwiseDistances(x, y, Metric.MANHATTAN)
+            )
+        )
+        assertTrue(
+            allClose(
+                array<Double>(listOf(listOf(0.0, 2.0, 4.0), listOf(25.0, 13.0, 13.0))),
+                pairwiseDistances(x, y, Metric.SQEUCLIDEAN)
+            )
+        )
+        assertFailsWith<NumKtException> { pairwiseDistances(x, ones<Double>(2, 3)) }
+    }
+
+    @Test
+    fun testKnnMatchesBruteForce() {
+        val points = Random.randomSample(5000, 3)
+        val queries = Random.randomSample(300, 3)
+        val (indices, distances) = knn(points, queries, 4)
+
+        assertTrue(indices.shape.contentEquals(intArrayOf(300, 4)))
+        val all = pairwiseDistances(queries, points)
+        for (q in 0 until 300 step 37) {
+            assertEquals(argSort(all[q])[0 until 4], indices[q])
+            assertTrue(allClose(sort(all[q])[0 until 4], distances[q]))
+        }
+        assertFailsWith<NumKtException> { knn(points, queries, 5001) }
+    }
+
+    @Test
+    fun testKnnCosine() {
+        val points = array<Double>(listOf(listOf(1.0, 0.0), listOf(0.0, 1.0), listOf(2.0, 2.1)))
+        val (indices, _) = knn(points, array<Double>(listOf(listOf(10.0, 9.0))), 2, Metric.COSINE)
+        assertEquals(array(arrayOf(2L, 0L)), indices[0])
+    }
+}
@@ -0,0 +1,88 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.reshape
+import java.io.File
+import java.io.RandomAccessFile
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+class TestNpyIO {
+
+    @Test
+    fun testMmapNpy() {
+        val file = File.createTempFile("numkt", ".npy")
+        val a = arange(12.0).reshape(3, 4)
+        save(file.absolutePath, a)
+
+        val b = load<Double>(file.absolutePath, MmapMode.READ)
+        assertEquals(a, b)
+        assertTrue(b.data!!.isReadOnly)
+        assertEquals(11.0, b.data!!.getDouble(11 * 8))
+
+        file.delete()
+    }
+
+    @Test
+    fun testMmapLarge() {
+        val file = File.createTempFile("numkt", ".npy")
+        // sparse int16 file of 2^31 + 64 bytes, more than a ByteBuffer holds
+        val n = (1L shl 30) + 32
+        val header = "{'descr': '<i2', 'fortran_order': False, 'shape': ($n,), }".padEnd(117) + "\n"
+        RandomAccessFile(file, "rw").use {
+            it.write(byteArrayOf(0x93.toByte()) + "NUMPY".toByteArray() + byteArrayOf(1, 0, header.length.toByte(), 0))
+            it.write(header.toByteArray())
+            it.setLength(10 + header.length + 2 * n)
+            it.seek(10 + header.length + 2 * (n - 1))
+            it.write(byteArrayOf(5, 0))
+        }
+
+        val a = load<Short>(file.absolutePath, MmapMode.READ)
+        assertNull(a.data)
+        assertEquals(n.toInt(), a.shape[0])
+        assertEquals(5.toShort(), a[n - 1].scalar)
+        assertEquals(0.toShort(), a[0L].scalar)
+
+        file.delete()
+    }
+
+    @Test
+    fun testMmapReadWrite() {
+        val file = File.createTempFile("numkt", ".npy")
+        save(file.absolutePath, zeros<Int>(5))
+
+        val a = load<Int>(file.absolutePath, MmapMode.READ_WRITE)
+        a[2] = 7
+        assertEquals(array(arrayOf(0, 0, 7, 0, 0)), load<Int>(file.absolutePath))
+
+        val c = load<Int>(file.absolutePath, MmapMode.COPY_ON_WRITE)
+        c[0] = 1
+        assertEquals(array(arrayOf(0, 0, 7, 0, 0)), load<Int>(file.absolutePath))
+
+        file.delete()
+    }
+
+    @Test
+    fun testNpz() {
+        val file = File.createTempFile("numkt", ".npz")
+        val x = arange(10L)
+        val y = ones<Float>(2, 3)
+        savez(file.absolutePath, mapOf("x" to x, "y" to y))
+
+        val mapped = loadNpz(file.absolutePath, MmapMode.READ)
+        assertEquals(setOf("x", "y"), mapped.keys)
+        assertEquals(x, mapped["x"])
+        assertEquals(y, mapped["y"])
+
+        val loaded = loadNpz(file.absolutePath)
+        assertEquals(x, loaded["x"])
+
+        savezCompressed(file.absolutePath, mapOf("x" to x))
+        assertEquals(x, loadNpz(file.absolutePath, MmapMode.READ)["x"])
+
+        assertFailsWith<NumKtException> { loadNpz(file.absolutePath, MmapMode.READ_WRITE) }
+
+        file.delete()
+    }
+}
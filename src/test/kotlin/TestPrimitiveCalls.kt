@@ -0,0 +1,44 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.asType
+import org.jetbrains.numkt.core.ge
+import org.jetbrains.numkt.core.lt
+import org.jetbrains.numkt.math.nansum
+import org.jetbrains.numkt.math.prod
+import org.jetbrains.numkt.random.Random
+import org.jetbrains.numkt.statistics.amax
+import org.jetbrains.numkt.statistics.median
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class TestPrimitiveCalls {
+
+    @Test
+    fun testCalls() {
+        val x = Random.randomSample(100)
+        val i = Random.randomIntegers(0, 100, 100).asType<Long, Int>()
+        val mean = callFunc(arrayOf("mean"), args = arrayOf(x), kClass = Double::class)
+        assertEquals(mean, callDouble(arrayOf("mean"), arrayOf(x)))
+        val argMax = callFunc(arrayOf("argmax"), args = arrayOf(x), kClass = Long::class)
+        assertEquals(argMax, callLong(arrayOf("argmax"), arrayOf(x)))
+        val sum = callFunc(arrayOf("sum"), args = arrayOf(i), kClass = Long::class)
+        assertEquals(sum, callLong(arrayOf("sum"), arrayOf(i)))
+        assertTrue(callBoolean(arrayOf("all"), arrayOf(x.ge(0.0))))
+        assertFalse(callBoolean(arrayOf("any"), arrayOf(x.lt(0.0))))
+        assertFailsWith<NumKtException> { callDouble(arrayOf("mean"), arrayOf("a")) }
+    }
+
+    @Test
+    fun testWrappers() {
+        val f = array(arrayOf(1f, 2f, 4f))
+        assertEquals(8f, prod(f))
+        assertEquals(4f, amax(f))
+        assertEquals(2.0, median(f))
+        val d = array(arrayOf(1.0, Double.NaN, 2.0))
+        assertEquals(3.0, nansum(d))
+        val i = array(arrayOf(3, 5, 7))
+        assertEquals(105, prod(i))
+    }
+}
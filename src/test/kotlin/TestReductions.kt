@@ -0,0 +1,91 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.asType
+import org.jetbrains.numkt.logic.allClose
+import org.jetbrains.numkt.math.sum
+import org.jetbrains.numkt.random.Random
+import org.jetbrains.numkt.statistics.*
+import kotlin.math.abs
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class TestReductions : ThresholdFixture(Parallel::reductionThreshold) {
+
+    @Test
+    fun testFullReductions() {
+        val x = Random.randomSample(300, 200)
+        for (a in layouts(x)) {
+            assertTrue(abs(numpy { sum(a) } - native { sum(a) }) < 1e-9)
+            assertTrue(abs(numpy { mean(a) } - native { mean(a) }) < 1e-12)
+            assertTrue(abs(numpy { `var`(a, ddof = 1) } - native { `var`(a, ddof = 1) }) < 1e-12)
+            assertEquals(numpy { amax(a) }, native { amax(a) })
+            assertEquals(numpy { amin(a) }, native { amin(a) })
+            assertEquals(numpy { argMax(a) }, native { argMax(a) })
+            assertEquals(numpy { argMin(a) }, native { argMin(a) })
+            assertEquals(numpy { countNonZero(a) }, native { countNonZero(a) })
+        }
+    }
+
+    @Test
+    fun testAxisReductions() {
+        val x = Random.randomSample(40, 500, 7)
+        for (axis in 0..2) {
+            assertTrue(allClose(numpy { sum(x, axis) }, native { sum(x, axis) }))
+            assertTrue(allClose(numpy { mean(x, axis) }, native { mean(x, axis) }))
+            assertTrue(allClose(numpy { `var`(x, axis, ddof = 1) }, native { `var`(x, axis, ddof = 1) }))
+            assertEquals(numpy { amax(x, axis) }, native { amax(x, axis) })
+            assertEquals(numpy { amin(x, axis) }, native { amin(x, axis) })
+            assertEquals(numpy { argMax(x, axis) }, native { argMax(x, axis) })
+            assertEquals(numpy { argMin(x, axis) }, native { argMin(x, axis) })
+            assertEquals(numpy { countNonZero(x, axis) }, native { countNonZero(x, axis) })
+        }
+    }
+
+    @Test
+    fun testIntegers() {
+        val x = Random.randomIntegers(-100, 100, 1000, 30)
+        val y = x.asType<Long, Int>()
+        assertEquals(numpy { sum(x) }, native { sum(x) })
+        assertEquals(numpy { sum(y) }, native { sum(y) })
+        assertEquals(numpy { sum(y, 0) }, native { sum(y, 0) })
+        assertEquals(numpy { amax(y, 1) }, native { amax(y, 1) })
+        assertEquals(numpy { argMin(x) }, native { argMin(x) })
+        assertEquals(numpy { countNonZero(y, 0) }, native { countNonZero(y, 0) })
+        assertEquals(numpy { mean(y) }, native { mean(y) })
+    }
+
+    @Test
+    fun testFloat32() {
+        val x = Random.randomSample(300, 200).asType<Double, Float>()
+        val mean = native { mean(x) }
+        assertEquals(mean, mean.toFloat().toDouble())
+        assertTrue(abs(numpy { mean(x) } - mean) < 1e-6)
+        assertTrue(abs(numpy { `var`(x) } - native { `var`(x) }) < 1e-6)
+        assertEquals(numpy { mean(x, 0) }.dtype, native { mean(x, 0) }.dtype)
+        assertEquals(numpy { `var`(x, 1) }.dtype, native { `var`(x, 1) }.dtype)
+    }
+
+    @Test
+    fun testNaN() {
+        val x = array(arrayOf(1.0, 5.0, Double.NaN, 7.0, Double.NaN))
+        assertTrue(native { amax(x) }.isNaN())
+        assertEquals(2L, native { argMax(x) })
+        assertEquals(2L, native { argMin(x) })
+        assertTrue(native { sum(x) }.isNaN())
+    }
+
+    @Test
+    fun testThreadsDoNotChangeResult() {
+        val x = Random.randomSample(1000, 1000)
+        val threads = Parallel.threads
+        try {
+            Parallel.threads = 1
+            val one = native { Pair(sum(x), sum(x, 0)) }
+            Parallel.threads = 4
+            val four = native { Pair(sum(x), sum(x, 0)) }
+            assertEquals(one, four)
+        } finally {
+            Parallel.threads = threads
+        }
+    }
+}
@@ -0,0 +1,35 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.math.sum
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class TestSharedArray {
+
+    @Test
+    fun testSharedArray() {
+        val name = "numkt_test_${System.nanoTime()}"
+        val a = sharedArray<Double>(name, 3, 4)
+        try {
+            assertEquals(zeros<Double>(3, 4), a)
+            a[1] = 7.0
+
+            val b = attachSharedArray<Double>(name)
+            assertTrue(b.data!!.isReadOnly)
+            assertEquals(28.0, sum(b))
+
+            val c = attachSharedArray<Double>(name, MmapMode.READ_WRITE)
+            c[0, 0] = 1.0
+            assertEquals(1.0, a[0, 0].scalar)
+            assertEquals(a, b)
+
+            assertFailsWith<NumKtException> { sharedArray<Double>(name, 2) }
+        } finally {
+            unlinkSharedArray(name)
+        }
+        assertFailsWith<NumKtException> { attachSharedArray<Double>(name) }
+        // attached arrays stay valid after unlink
+        assertEquals(1.0, a[0, 0].scalar)
+    }
+}
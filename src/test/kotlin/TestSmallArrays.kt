@@ -0,0 +1,112 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.None
+import org.jetbrains.numkt.core.asType
+import org.jetbrains.numkt.core.rangeTo
+import org.jetbrains.numkt.linalg.dot
+import org.jetbrains.numkt.linalg.vdot
+import org.jetbrains.numkt.logic.allClose
+import org.jetbrains.numkt.math.*
+import org.jetbrains.numkt.random.Random
+import org.jetbrains.numkt.statistics.*
+import kotlin.math.abs
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class TestSmallArrays : ThresholdFixture(Parallel::smallArrayThreshold, nativeValue = 1 shl 10, numpyValue = 0) {
+
+    private fun <R> jvm(block: () -> R): R = native(block)
+
+    @Test
+    fun testReductionsAreExact() {
+        for (n in listOf(1, 7, 8, 9, 100, 128, 129, 300, 1000)) {
+            val x = Random.randomSample(n) * 1000.0 - 500.0
+            val f = x.asType<Double, Float>()
+            assertEquals(numpy { sum(x) }, jvm { sum(x) })
+            assertEquals(numpy { mean(x) }, jvm { mean(x) })
+            assertEquals(numpy { `var`(x) }, jvm { `var`(x) })
+            assertEquals(numpy { sum(f) }, jvm { sum(f) })
+            assertEquals(numpy { mean(f) }, jvm { mean(f) })
+            assertEquals(numpy { `var`(f) }, jvm { `var`(f) })
+            assertEquals(numpy { amax(x) }, jvm { amax(x) })
+            assertEquals(numpy { amin(f) }, jvm { amin(f) })
+            assertEquals(numpy { argMax(x) }, jvm { argMax(x) })
+            assertEquals(numpy { argMin(f) }, jvm { argMin(f) })
+        }
+    }
+
+    @Test
+    fun testIntegers() {
+        val x = Random.randomIntegers(-100, 100, 10, 30)
+        val y = x.asType<Long, Int>()
+        assertEquals(numpy { sum(x) }, jvm { sum(x) })
+        assertEquals(numpy { sum(y) }, jvm { sum(y) })
+        assertEquals(numpy { mean(y) }, jvm { mean(y) })
+        assertEquals(numpy { `var`(x, ddof = 1) }, jvm { `var`(x, ddof = 1) })
+        assertEquals(numpy { amax(y) }, jvm { amax(y) })
+        assertEquals(numpy { argMin(x) }, jvm { argMin(x) })
+        assertEquals(numpy { countNonZero(y) }, jvm { countNonZero(y) })
+        assertEquals(numpy { x * x - x }, jvm { x * x - x })
+        assertEquals(numpy { y + y }, jvm { y + y })
+        assertEquals(numpy { vdot(y, y) }, jvm { vdot(y, y) })
+    }
+
+    @Test
+    fun testViews() {
+        val x = Random.randomSample(20, 30)
+        for (a in listOf(x[3], x[2..7], x.t, x[None..None..-1, 0..29..2])) {
+            assertEquals(numpy { sum(a) }, jvm { sum(a) })
+            assertEquals(numpy { a * a + 1.0 }, jvm { a * a + 1.0 })
+        }
+    }
+
+    @Test
+    fun testElementwise() {
+        val x = Random.randomSample(4, 25)
+        val y = Random.randomSample(4, 25) + 0.5
+        assertEquals(numpy { x + y }, jvm { x + y })
+        assertEquals(numpy { x - y }, jvm { x - y })
+        assertEquals(numpy { x * y }, jvm { x * y })
+        assertEquals(numpy { x / y }, jvm { x / y })
+        assertEquals(numpy { 2.0 - x }, jvm { 2.0 - x })
+        assertEquals(numpy { x / 3 }, jvm { x / 3 })
+        assertEquals(x.shape.toList(), jvm { x + y }.shape.toList())
+        assertTrue(abs(numpy { vdot(x, y) } - jvm { vdot(x, y) }) < 1e-12)
+    }
+
+    @Test
+    fun testExpAndDot() {
+        val x = Random.randomSample(6, 5)
+        val y = Random.randomSample(5, 4)
+        val v = Random.randomSample(5)
+        val i = Random.randomIntegers(-100, 100, 6, 5)
+        val j = Random.randomIntegers(-100, 100, 5, 4)
+        assertTrue(allClose(numpy { exp(x) }, jvm { exp(x) }, rtol = 1e-15, atol = 0.0))
+        assertTrue(allClose(numpy { dot(x, y) }, jvm { dot(x, y) }))
+        assertTrue(allClose(numpy { dot(x, v) }, jvm { dot(x, v) }))
+        assertTrue(allClose(numpy { dot(v, y) }, jvm { dot(v, y) }))
+        assertEquals(numpy { dot(i, j) }, jvm { dot(i, j) })
+        assertEquals(numpy { dot(i.asType<Long, Int>(), j.asType<Long, Int>()) },
+            jvm { dot(i.asType<Long, Int>(), j.asType<Long, Int>()) })
+        assertEquals(listOf(6, 4), jvm { dot(x, y) }.shape.toList())
+        assertEquals(listOf(6), jvm { dot(x, v) }.shape.toList())
+        assertEquals(listOf(4), jvm { dot(v, y) }.shape.toList())
+    }
+
+    @Test
+    fun testNaN() {
+        val x = array(arrayOf(1.0, 5.0, Double.NaN, 7.0, Double.NaN))
+        assertTrue(jvm { amax(x) }.isNaN())
+        assertTrue(jvm { amin(x) }.isNaN())
+        assertEquals(2L, jvm { argMax(x) })
+        assertEquals(2L, jvm { argMin(x) })
+        assertEquals(5L, jvm { countNonZero(x) })
+    }
+
+    @Test
+    fun testBroadcastingIsLeftToNumpy() {
+        val x = Random.randomSample(1, 6)
+        val y = Random.randomSample(6, 1)
+        assertEquals(listOf(6, 6), jvm { x + y }.shape.toList())
+    }
+}
@@ -0,0 +1,66 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.asType
+import org.jetbrains.numkt.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class TestSorting : ThresholdFixture(Parallel::sortThreshold) {
+
+    @Test
+    fun testSort() {
+        val x = Random.randomSample(300, 200)
+        for (a in layouts(x)) {
+            for (axis in -1..1) {
+                assertEquals(numpy { sort(a, axis) }, native { sort(a, axis) })
+                assertEquals(numpy { argSort(a, axis, KindSort.STABLE) }, native { argSort(a, axis) })
+            }
+        }
+    }
+
+    @Test
+    fun testIntegers() {
+        val x = Random.randomIntegers(-10, 10, 500, 40)
+        val y = x.asType<Long, Int>()
+        assertEquals(numpy { sort(x, 0) }, native { sort(x, 0) })
+        assertEquals(numpy { sort(y) }, native { sort(y) })
+        assertEquals(numpy { argSort(y, 0, KindSort.STABLE) }, native { argSort(y, 0) })
+    }
+
+    @Test
+    fun testNaNGoLast() {
+        val x = array(arrayOf(3.0, Double.NaN, 1.0, 2.0, Double.NaN))
+        assertEquals(array(arrayOf(2L, 3L, 0L, 1L, 4L)), native { argSort(x) })
+        val (values, indices) = topK(x, 2)
+        assertTrue(values[0].scalar!!.isNaN() && values[1].scalar!!.isNaN())
+        assertEquals(array(arrayOf(1L, 4L)), indices)
+    }
+
+    @Test
+    fun testTopK() {
+        val x = array<Int>(listOf(listOf(5, 1, 5, 3), listOf(2, 8, 0, 8)))
+        val (largest, largestIndices) = topK(x, 2)
+        assertEquals(array<Int>(listOf(listOf(5, 5), listOf(8, 8))), largest)
+        assertEquals(array<Long>(listOf(listOf(0, 2), listOf(1, 3))), largestIndices)
+        val (smallest, smallestIndices) = topK(x, 1, axis = 0, largest = false)
+        assertEquals(array<Int>(listOf(listOf(2, 1, 0, 3))), smallest)
+        assertEquals(array<Long>(listOf(listOf(1, 0, 1, 0))), smallestIndices)
+        assertFailsWith<IllegalArgumentException> { topK(x, 5) }
+    }
+
+    @Test
+    fun testThreadsDoNotChangeResult() {
+        val x = Random.randomIntegers(0, 1000, 1 shl 20)
+        val threads = Parallel.threads
+        try {
+            Parallel.threads = 1
+            val one = native { Triple(sort(x), argSort(x), topK(x, 100)) }
+            Parallel.threads = 4
+            val four = native { Triple(sort(x), argSort(x), topK(x, 100)) }
+            assertEquals(one, four)
+        } finally {
+            Parallel.threads = threads
+        }
+    }
+}
@@ -0,0 +1,64 @@
+import org.jetbrains.numkt.NumKtException
+import org.jetbrains.numkt.argSort
+import org.jetbrains.numkt.logic.allClose
+import org.jetbrains.numkt.neighbors.BallTree
+import org.jetbrains.numkt.neighbors.KDTree
+import org.jetbrains.numkt.neighbors.SpatialTree
+import org.jetbrains.numkt.neighbors.pairwiseDistances
+import org.jetbrains.numkt.random.Random
+import org.jetbrains.numkt.sort
+import java.io.File
+import kotlin.test.*
+
+class TestSpatialTree {
+
+    private val points = Random.randomSample(10000, 3)
+    private val queries = Random.randomSample(200, 3)
+    private val all = pairwiseDistances(queries, points)
+
+    private fun checkQuery(tree: SpatialTree) {
+        val (indices, distances) = tree.query(queries, 5)
+        for (q in 0 until 200 step 23) {
+            assertEquals(argSort(all[q])[0 until 5], indices[q])
+            assertTrue(allClose(sort(all[q])[0 until 5], distances[q]))
+        }
+    }
+
+    @Test
+    fun testQuery() {
+        KDTree(points).use { checkQuery(it) }
+        BallTree(points, leafSize = 10).use { checkQuery(it) }
+    }
+
+    @Test
+    fun testQueryRadius() {
+        BallTree(points).use { tree ->
+            val result = tree.queryRadius(queries, 0.1)
+            assertEquals(200, result.size)
+            for (q in 0 until 200 step 23) {
+                val (indices, distances) = result[q]
+                val expected = sort(all[q])
+                assertEquals(indices.size, (0 until 10000).count { expected[it].scalar!! <= 0.1 })
+                assertTrue(allClose(expected[0 until indices.size], distances))
+            }
+        }
+    }
+
+    @Test
+    fun testSaveAndOpen() {
+        val file = File.createTempFile("numkt", ".tree")
+        try {
+            KDTree(points).use { it.save(file.path) }
+            SpatialTree.open(file.path).use {
+                assertTrue(it is KDTree)
+                checkQuery(it)
+            }
+            SpatialTree.open(file.path, mmap = false).use { checkQuery(it) }
+
+            file.writeText("not a tree")
+            assertFailsWith<NumKtException> { SpatialTree.open(file.path) }
+        } finally {
+            file.delete()
+        }
+    }
+}
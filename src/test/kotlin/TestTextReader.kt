@@ -0,0 +1,64 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.reshape
+import java.io.File
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+
+class TestTextReader {
+
+    private fun tempFile(text: String): File =
+        File.createTempFile("numkt", ".csv").apply { writeText(text) }
+
+    @Test
+    fun testLoadText() {
+        val file = tempFile("# header\n1,2,3\n4,5,6\n\n7,8,9 # tail\n")
+
+        assertEquals(arange(1.0, 10.0).reshape(3, 3), loadText(file.absolutePath, delimiter = ','))
+        assertEquals(
+            array(arrayOf(2L, 5L, 8L)),
+            loadText<Long>(file.absolutePath, delimiter = ',', usecols = intArrayOf(1))
+        )
+        assertEquals(
+            array(arrayOf(3, 6, 9)),
+            loadText<Int>(file.absolutePath, delimiter = ',', usecols = intArrayOf(-1))
+        )
+
+        file.delete()
+    }
+
+    @Test
+    fun testChunks() {
+        val file = tempFile((0 until 10).joinToString("\n") { "$it ${it * 0.5}" })
+
+        val chunks = readTextChunks<Float>(file.absolutePath, chunkRows = 4).toList()
+        assertEquals(listOf(4, 4, 2), chunks.map { it.shape[0] })
+        assertEquals(arange(10f), concatenate(*chunks.toTypedArray())[":", 0])
+
+        TextReader(file.absolutePath, Double::class.javaObjectType, skiprows = 8).use { reader ->
+            val out = empty<Double>(4, reader.columns)
+            assertEquals(2, reader.read(out))
+            assertEquals(0, reader.read(out))
+        }
+
+        file.delete()
+    }
+
+    @Test
+    fun testErrors() {
+        val file = tempFile("1,2\n3,x\n")
+
+        assertFailsWith<NumKtException> { loadText<Double>(file.absolutePath, delimiter = ',') }
+        assertFailsWith<NumKtException> { loadText<Double>(file.absolutePath, delimiter = ',', usecols = intArrayOf(2)) }
+        file.writeText("1,2\n3\n")
+        assertFailsWith<NumKtException> { loadText<Double>(file.absolutePath, delimiter = ',') }
+        file.writeText("1000\n")
+        assertFailsWith<NumKtException> { loadText<Byte>(file.absolutePath) }
+        file.writeText("1,2,3\n")
+        assertFailsWith<IllegalArgumentException> {
+            loadText<Double>(file.absolutePath, delimiter = ',', usecols = intArrayOf(0, 2, -3))
+        }
+
+        file.delete()
+    }
+}
@@ -0,0 +1,70 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.asType
+import org.jetbrains.numkt.math.*
+import org.jetbrains.numkt.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+class TestUfuncs : ThresholdFixture(Parallel::ufuncThreshold) {
+
+    @Test
+    fun testUnary() {
+        val x = Random.randomSample(300, 200)
+        for (a in layouts(x)) {
+            assertEquals(numpy { exp(a) }, native { exp(a) })
+            assertEquals(numpy { log1p(a) }, native { log1p(a) })
+            assertEquals(numpy { sin(a) }, native { sin(a) })
+            assertEquals(numpy { arctan(a) }, native { arctan(a) })
+            assertEquals(numpy { tanh(a) }, native { tanh(a) })
+        }
+    }
+
+    @Test
+    fun testBinary() {
+        val x = Random.randomSample(500, 40)
+        val y = Random.randomSample(500, 40)
+        assertEquals(numpy { hypot(x, y) }, native { hypot(x, y) })
+        assertEquals(numpy { arctan2(x, y) }, native { arctan2(x, y) })
+        assertEquals(numpy { logaddexp(x, y) }, native { logaddexp(x, y) })
+        assertEquals(numpy { logaddexp(x, y[0]) }, native { logaddexp(x, y[0]) })
+    }
+
+    @Test
+    fun testOut() {
+        val x = Random.randomSample(1000)
+        val out = empty<Double>(1000)
+        assertSame(out, native { exp(x, out) })
+        assertEquals(numpy { exp(x) }, out)
+        native { tanh(out, out) }
+        assertEquals(numpy { tanh(exp(x)) }, out)
+    }
+
+    @Test
+    fun testOtherTypes() {
+        val x = Random.randomIntegers(1, 100, 1000)
+        assertEquals(numpy { log(x) }, native { log(x) })
+        val y = Random.randomSample(1000).asType<Double, Float>()
+        assertEquals(numpy { cosh(y) }, native { cosh(y) })
+        assertEquals(numpy { exp(y) }, native { exp(y) })
+    }
+
+    @Test
+    fun testThreadsDoNotChangeResult() {
+        val x = Random.randomSample(1 shl 20)
+        val threads = Parallel.threads
+        try {
+            Parallel.threads = 1
+            val one = native { exp(x) }
+            Parallel.threads = 4
+            Parallel.affinity = true
+            val four = native { exp(x) }
+            assertEquals(one, four)
+            assertTrue(Parallel.affinity)
+        } finally {
+            Parallel.affinity = false
+            Parallel.threads = threads
+        }
+    }
+}
@@ -0,0 +1,55 @@
+import org.jetbrains.numkt.*
+import org.jetbrains.numkt.core.reshape
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class TestWorkerPool {
+
+    @Test
+    fun testCall() {
+        WorkerPool(2).use { pool ->
+            val a = pool.callArray(arrayOf("arange"), arrayOf(6), mapOf("dtype" to Double::class.javaObjectType))
+            assertEquals(listOf(6), a.shape.toList())
+            assertEquals(15.0, pool.call(arrayOf("sum"), arrayOf(a)))
+
+            val m = pool.callArray(arrayOf("reshape"), arrayOf(a, intArrayOf(2, 3)))
+            val gram = pool.callArray(arrayOf("dot"), arrayOf(m, pool.callArray(arrayOf("transpose"), arrayOf(m))))
+            val inv = pool.callArray(arrayOf("linalg", "inv"), arrayOf(gram))
+            assertEquals(listOf(2, 2), inv.shape.toList())
+
+            assertEquals(arange(6.0), a.fetch())
+            a.close()
+            listOf(m, gram, inv).forEach { it.close() }
+
+            assertFailsWith<NumKtException> { pool.call(arrayOf("linalg", "inv"), arrayOf(zeros<Double>(2, 3))) }
+        }
+    }
+
+    @Test
+    fun testPut() {
+        WorkerPool(2).use { pool ->
+            val x = arange(12.0).reshape(3, 4)
+            pool.put(x).use { handle ->
+                val doubled = pool.callArray(arrayOf("multiply"), arrayOf(handle, 2))
+                assertEquals(x * 2.0, doubled.fetch())
+                doubled.close()
+            }
+            // arrays are copied into temporary shared memory
+            assertEquals(66.0, pool.call(arrayOf("sum"), arrayOf(x)))
+            val eig = pool.call(arrayOf("linalg", "eigh"), arrayOf(eye<Double>(2))) as List<*>
+            assertTrue(eig.all { it is SharedHandle })
+        }
+    }
+
+    @Test
+    fun testParallelCalls() {
+        WorkerPool(3).use { pool ->
+            val results = (0 until 12).toList().parallelStream().map {
+                pool.call(arrayOf("sum"), arrayOf(LongArray(100) { i -> i.toLong() + it }))
+            }.toArray()
+            assertEquals((0 until 12).map { 4950L + 100L * it }, results.toList())
+        }
+    }
+}
@@ -0,0 +1,40 @@
+import org.jetbrains.numkt.Parallel
+import org.jetbrains.numkt.core.KtNDArray
+import org.jetbrains.numkt.core.None
+import org.jetbrains.numkt.core.rangeTo
+import kotlin.reflect.KMutableProperty0
+
+/**
+ * Base of the tests which compare a native path with numpy: [native] runs a block with [threshold] set to
+ * [nativeValue] and [numpy] with it set to [numpyValue], [threads] sets the threads of the pool for both.
+ */
+open class ThresholdFixture(
+    private val threshold: KMutableProperty0<Int>,
+    private val nativeValue: Int = 0,
+    private val numpyValue: Int = Int.MAX_VALUE,
+    private val threads: Int? = null
+) {
+
+    protected fun <R> native(block: () -> R): R = withThreshold(nativeValue, block)
+
+    protected fun <R> numpy(block: () -> R): R = withThreshold(numpyValue, block)
+
+    private fun <R> withThreshold(value: Int, block: () -> R): R {
+        val old = threshold.get()
+        val oldThreads = Parallel.threads
+        threshold.set(value)
+        threads?.let { Parallel.threads = it }
+        try {
+            return block()
+        } finally {
+            threshold.set(old)
+            if (threads != null) Parallel.threads = oldThreads
+        }
+    }
+
+    /**
+     * [x] contiguous, transposed and as a reversed view with a step, so that every layout is compared.
+     */
+    protected fun <T : Any> layouts(x: KtNDArray<T>): List<KtNDArray<T>> =
+        listOf(x, x.t, x[None..None..-1, 0..(x.shape[1] - 1)..3])
+}